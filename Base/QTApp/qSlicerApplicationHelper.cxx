@@ -28,6 +28,7 @@
 # include <QLoggingCategory>
 #endif
 #include <QSettings>
+#include <QStandardPaths>
 #include <QSysInfo>
 #include <QThread>
 #include <QTimer>
@@ -193,6 +194,9 @@ void qSlicerApplicationHelper::setupModuleFactoryManager(qSlicerModuleFactoryMan
 
     qSlicerCLIExecutableModuleFactory* cliExecutableFactory = new qSlicerCLIExecutableModuleFactory();
     cliExecutableFactory->setTempDirectory(tempDirectory);
+    // Avoid running each CLI executable with "--xml" argument at every startup
+    cliExecutableFactory->setXmlDescriptionCacheDirectory(
+      QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/CLIModuleDescriptions");
     moduleFactoryManager->registerFactory(cliExecutableFactory, preferExecutableCLIs ? 1 : 0);
 
     if (!options->disableBuiltInModules() &&
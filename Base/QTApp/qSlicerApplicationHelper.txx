@@ -45,6 +45,7 @@
 #include "qSlicerCommandOptions.h"
 #include "qSlicerModuleFactoryManager.h"
 #include "qSlicerModuleManager.h"
+#include "qSlicerStartupProfiler.h"
 
 namespace
 {
@@ -229,6 +230,11 @@ int qSlicerApplicationHelper::postInitializeApplication(
     moduleFactoryManager->addModuleToIgnore(moduleToIgnore);
   }
 
+  // Record time spent loading each module if requested
+  QString startupProfileFile = app.commandOptions()->startupProfileFile();
+  moduleFactoryManager->startupProfiler()->setEnabled(!startupProfileFile.isEmpty());
+  moduleFactoryManager->setLazyLoading(app.commandOptions()->lazyModuleLoading());
+
   // Register and instantiate modules
   splashMessage(splashScreen, qSlicerApplication::tr("Registering modules..."));
   moduleFactoryManager->registerModules();
@@ -305,6 +311,21 @@ int qSlicerApplicationHelper::postInitializeApplication(
   if (app.commandOptions()->verboseModuleDiscovery())
   {
     qDebug() << "Number of loaded modules:" << moduleManager->modulesNames().count();
+    if (moduleFactoryManager->lazyLoading())
+    {
+      qDebug() << "Number of modules with deferred loading:"
+               << moduleFactoryManager->deferredModuleNames().count();
+    }
+  }
+
+  if (!startupProfileFile.isEmpty())
+  {
+    qSlicerStartupProfiler* profiler = moduleFactoryManager->startupProfiler();
+    qDebug().noquote() << "Module startup times [ms]:\n" << profiler->summary();
+    if (profiler->writeChromeTrace(startupProfileFile))
+    {
+      qDebug() << "Startup profile written to" << startupProfileFile;
+    }
   }
 
   splashMessage(splashScreen, QString());
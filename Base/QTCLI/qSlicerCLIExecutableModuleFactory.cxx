@@ -19,8 +19,16 @@
 ==============================================================================*/
 
 // Qt includes
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QHash>
 #include <QProcess>
+#include <QDebug>
+#include <QSaveFile>
+#include <QSet>
+#include <QSharedPointer>
 #include <QStandardPaths>
+#include <QThread>
 
 // Slicer includes
 #include "qSlicerCLIExecutableModuleFactory.h"
@@ -47,12 +55,230 @@ QString findPython()
 
 }
 
+//-----------------------------------------------------------------------------
+// qSlicerCLIExecutableModuleFactoryPrivate
+
+//-----------------------------------------------------------------------------
+class qSlicerCLIExecutableModuleFactoryPrivate
+{
+  Q_DECLARE_PUBLIC(qSlicerCLIExecutableModuleFactory);
+protected:
+  qSlicerCLIExecutableModuleFactory* const q_ptr;
+public:
+  typedef qSlicerCLIExecutableModuleFactoryPrivate Self;
+  qSlicerCLIExecutableModuleFactoryPrivate(qSlicerCLIExecutableModuleFactory& object);
+  ~qSlicerCLIExecutableModuleFactoryPrivate();
+
+  /// Run the executable with "--xml" argument, without waiting for it to finish.
+  static QSharedPointer<QProcess> startXmlProbe(const QString& executablePath);
+
+  /// Queue XML probes for all items that have neither an XML file nor a cached description
+  /// and start running them.
+  void queueXmlProbes();
+
+  /// Start queued XML probes until MaximumNumberOfRunningXmlProbes are running.
+  void startQueuedXmlProbes();
+
+  /// Return the process that retrieves XML description of the executable.
+  /// The process is started now if it was queued. Returns null if no probe was requested for the executable.
+  QSharedPointer<QProcess> takeXmlProbe(const QString& executablePath);
+
+  /// Return path of the cached XML description file of the executable.
+  /// Returns empty string if caching is disabled.
+  QString xmlDescriptionCacheFilePath(const QString& executablePath)const;
+  QString cachedXmlDescription(const QString& executablePath)const;
+  void cacheXmlDescription(const QString& executablePath, const QString& xmlDescription);
+
+  QString XmlDescriptionCacheDirectory;
+
+  /// Items created by the factory
+  QList<qSlicerCLIExecutableModuleFactoryItem*> Items;
+  /// Executables that have already been considered for XML probing
+  QSet<QString> CheckedExecutables;
+  /// Executables waiting to be run with "--xml" argument
+  QStringList QueuedXmlProbes;
+  /// Running (or finished but not yet collected) "--xml" processes, indexed by executable path
+  QHash<QString, QSharedPointer<QProcess> > RunningXmlProbes;
+  int MaximumNumberOfRunningXmlProbes;
+
+private:
+  QString TempDirectory;
+};
+
+//-----------------------------------------------------------------------------
+qSlicerCLIExecutableModuleFactoryPrivate::qSlicerCLIExecutableModuleFactoryPrivate(qSlicerCLIExecutableModuleFactory& object)
+:q_ptr(&object)
+{
+  this->TempDirectory = QDir::tempPath();
+  this->MaximumNumberOfRunningXmlProbes = qMax(1, QThread::idealThreadCount());
+}
+
+//-----------------------------------------------------------------------------
+qSlicerCLIExecutableModuleFactoryPrivate::~qSlicerCLIExecutableModuleFactoryPrivate()
+{
+  // Items are deleted by the superclass of the factory, after this object
+  foreach (qSlicerCLIExecutableModuleFactoryItem* item, this->Items)
+  {
+    item->FactoryPrivate = nullptr;
+  }
+
+  // Stop probes of modules that have never been instantiated
+  foreach (const QSharedPointer<QProcess>& cli, this->RunningXmlProbes)
+  {
+    if (cli->state() != QProcess::NotRunning)
+    {
+      cli->kill();
+      cli->waitForFinished(1000);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+QSharedPointer<QProcess> qSlicerCLIExecutableModuleFactoryPrivate::startXmlProbe(const QString& executablePath)
+{
+  QSharedPointer<QProcess> cli(new QProcess);
+  QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+  env.insert("ITK_AUTOLOAD_PATH", "");
+  cli->setProcessEnvironment(env);
+  // Set the working directory of the process instead of changing the current
+  // directory, because multiple executables may be started at the same time.
+  cli->setWorkingDirectory(QFileInfo(executablePath).path());
+  cli->start(executablePath, QStringList(QString("--xml")));
+  return cli;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleFactoryPrivate::queueXmlProbes()
+{
+  foreach (qSlicerCLIExecutableModuleFactoryItem* item, this->Items)
+  {
+    QString executablePath = item->path();
+    if (executablePath.isEmpty() || this->CheckedExecutables.contains(executablePath))
+    {
+      continue;
+    }
+    this->CheckedExecutables.insert(executablePath);
+    if (QFile::exists(item->xmlModuleDescriptionFilePath()))
+    {
+      continue;
+    }
+    QString cacheFilePath = this->xmlDescriptionCacheFilePath(executablePath);
+    if (!cacheFilePath.isEmpty() && QFile::exists(cacheFilePath))
+    {
+      continue;
+    }
+    this->QueuedXmlProbes << executablePath;
+  }
+  this->startQueuedXmlProbes();
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleFactoryPrivate::startQueuedXmlProbes()
+{
+  while (this->RunningXmlProbes.size() < this->MaximumNumberOfRunningXmlProbes
+    && !this->QueuedXmlProbes.isEmpty())
+  {
+    QString executablePath = this->QueuedXmlProbes.takeFirst();
+    this->RunningXmlProbes[executablePath] = Self::startXmlProbe(executablePath);
+  }
+}
+
+//-----------------------------------------------------------------------------
+QSharedPointer<QProcess> qSlicerCLIExecutableModuleFactoryPrivate::takeXmlProbe(const QString& executablePath)
+{
+  QSharedPointer<QProcess> cli = this->RunningXmlProbes.take(executablePath);
+  if (cli.isNull() && this->QueuedXmlProbes.removeOne(executablePath))
+  {
+    cli = Self::startXmlProbe(executablePath);
+  }
+  // Keep other probes running while the caller waits for this one
+  this->startQueuedXmlProbes();
+  return cli;
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLIExecutableModuleFactoryPrivate::xmlDescriptionCacheFilePath(const QString& executablePath)const
+{
+  if (this->XmlDescriptionCacheDirectory.isEmpty())
+  {
+    return QString();
+  }
+  QFileInfo executable(executablePath);
+  if (!executable.exists())
+  {
+    return QString();
+  }
+  QString cacheKey = QString("%1|%2|%3")
+    .arg(executable.absoluteFilePath())
+    .arg(executable.size())
+    .arg(executable.lastModified().toMSecsSinceEpoch());
+  QString cacheFileName = QCryptographicHash::hash(cacheKey.toUtf8(), QCryptographicHash::Sha1).toHex() + ".xml";
+  return QDir(this->XmlDescriptionCacheDirectory).filePath(cacheFileName);
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLIExecutableModuleFactoryPrivate::cachedXmlDescription(const QString& executablePath)const
+{
+  QString cacheFilePath = this->xmlDescriptionCacheFilePath(executablePath);
+  if (cacheFilePath.isEmpty())
+  {
+    return QString();
+  }
+  QFile cacheFile(cacheFilePath);
+  if (!cacheFile.open(QIODevice::ReadOnly))
+  {
+    return QString();
+  }
+  return QTextStream(&cacheFile).readAll();
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleFactoryPrivate::cacheXmlDescription(const QString& executablePath, const QString& xmlDescription)
+{
+  QString cacheFilePath = this->xmlDescriptionCacheFilePath(executablePath);
+  if (cacheFilePath.isEmpty() || xmlDescription.isEmpty())
+  {
+    return;
+  }
+  if (!QDir().mkpath(this->XmlDescriptionCacheDirectory))
+  {
+    qWarning() << Q_FUNC_INFO << "failed to create CLI description cache directory" << this->XmlDescriptionCacheDirectory;
+    return;
+  }
+  // Write to a temporary file first so that other application instances never read a partially written file
+  QSaveFile cacheFile(cacheFilePath);
+  if (!cacheFile.open(QIODevice::WriteOnly))
+  {
+    qWarning() << Q_FUNC_INFO << "failed to write CLI description cache file" << cacheFilePath;
+    return;
+  }
+  cacheFile.write(xmlDescription.toUtf8());
+  cacheFile.commit();
+}
+
+//-----------------------------------------------------------------------------
+// qSlicerCLIExecutableModuleFactoryItem
+
 //-----------------------------------------------------------------------------
 qSlicerCLIExecutableModuleFactoryItem::qSlicerCLIExecutableModuleFactoryItem(
-  const QString& newTempDirectory)
+  const QString& newTempDirectory, qSlicerCLIExecutableModuleFactoryPrivate* factoryPrivate)
   : TempDirectory(newTempDirectory)
   , CLIModule(nullptr)
+  , FactoryPrivate(factoryPrivate)
+{
+  if (this->FactoryPrivate)
+  {
+    this->FactoryPrivate->Items << this;
+  }
+}
+
+//-----------------------------------------------------------------------------
+qSlicerCLIExecutableModuleFactoryItem::~qSlicerCLIExecutableModuleFactoryItem()
 {
+  if (this->FactoryPrivate)
+  {
+    this->FactoryPrivate->Items.removeAll(this);
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -98,7 +324,8 @@ qSlicerAbstractCoreModule* qSlicerCLIExecutableModuleFactoryItem::instanciator()
 
   //
   // If the xml file exists, read it and associate it with the module
-  // description. If not, run the CLI executable with "--xml".
+  // description. If not, use the cached description or run the CLI
+  // executable with "--xml".
   //
   QString xmlDescription;
   if (QFile::exists(xmlFilePath))
@@ -114,6 +341,15 @@ qSlicerAbstractCoreModule* qSlicerCLIExecutableModuleFactoryItem::instanciator()
       this->appendInstantiateErrorString(qSlicerCLIModule::tr("Failed to read XML Description"));
     }
   }
+  else if (this->FactoryPrivate)
+  {
+    xmlDescription = this->FactoryPrivate->cachedXmlDescription(this->path());
+    if (xmlDescription.isEmpty())
+    {
+      xmlDescription = this->runCLIWithXmlArgument();
+      this->FactoryPrivate->cacheXmlDescription(this->path(), xmlDescription);
+    }
+  }
   else
   {
     xmlDescription = this->runCLIWithXmlArgument();
@@ -137,20 +373,35 @@ qSlicerAbstractCoreModule* qSlicerCLIExecutableModuleFactoryItem::instanciator()
 //-----------------------------------------------------------------------------
 QString qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument()
 {
-  ctkScopedCurrentDir scopedCurrentDir(QFileInfo(this->path()).path());
-
   int cliProcessTimeoutInMs = 5000;
-  QProcess cli;
-  QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
-  env.insert("ITK_AUTOLOAD_PATH", "");
-  cli.setProcessEnvironment(env);
-  cli.start(this->path(), QStringList(QString("--xml")));
-  bool res = cli.waitForFinished(cliProcessTimeoutInMs);
+  // The executable may have been started already by the factory
+  QSharedPointer<QProcess> cli;
+  if (this->FactoryPrivate)
+  {
+    // Modules are usually registered one by one (not through registerItems), therefore
+    // probes of all the other registered executables are started when the first one is needed.
+    this->FactoryPrivate->queueXmlProbes();
+    cli = this->FactoryPrivate->takeXmlProbe(this->path());
+  }
+  if (cli.isNull())
+  {
+    cli = qSlicerCLIExecutableModuleFactoryPrivate::startXmlProbe(this->path());
+  }
+  bool res = false;
+  if (cli->state() == QProcess::NotRunning)
+  {
+    // already finished (or failed to start)
+    res = (cli->error() == QProcess::UnknownError && cli->exitStatus() == QProcess::NormalExit);
+  }
+  else
+  {
+    res = cli->waitForFinished(cliProcessTimeoutInMs);
+  }
   if (!res)
   {
     this->appendInstantiateErrorString(qSlicerCLIModule::tr("CLI executable: %1").arg(this->path()));
     QString errorString;
-    switch(cli.error())
+    switch(cli->error())
     {
       case QProcess::FailedToStart:
         errorString = qSlicerCLIModule::tr(
@@ -183,7 +434,7 @@ QString qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument()
     this->appendInstantiateErrorString(errorString);
     return nullptr;
   }
-  QString errors = cli.readAllStandardError();
+  QString errors = cli->readAllStandardError();
   if (!errors.isEmpty())
   {
     this->appendInstantiateErrorString(qSlicerCLIModule::tr("CLI executable: %1").arg(this->path()));
@@ -195,7 +446,7 @@ QString qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument()
     // machine so there is a chance it succeeds to parse the XML description
     // on other machines.
   }
-  QString xmlDescription = cli.readAllStandardOutput();
+  QString xmlDescription = cli->readAllStandardOutput();
   if (xmlDescription.isEmpty())
   {
     this->appendInstantiateErrorString(qSlicerCLIModule::tr("CLI executable: %1").arg(this->path()));
@@ -220,30 +471,6 @@ void qSlicerCLIExecutableModuleFactoryItem::uninstantiate()
   this->ctkAbstractFactoryFileBasedItem<qSlicerAbstractCoreModule>::uninstantiate();
 }
 
-//-----------------------------------------------------------------------------
-// qSlicerCLIExecutableModuleFactoryPrivate
-
-//-----------------------------------------------------------------------------
-class qSlicerCLIExecutableModuleFactoryPrivate
-{
-  Q_DECLARE_PUBLIC(qSlicerCLIExecutableModuleFactory);
-protected:
-  qSlicerCLIExecutableModuleFactory* const q_ptr;
-public:
-  typedef qSlicerCLIExecutableModuleFactoryPrivate Self;
-  qSlicerCLIExecutableModuleFactoryPrivate(qSlicerCLIExecutableModuleFactory& object);
-
-private:
-  QString TempDirectory;
-};
-
-//-----------------------------------------------------------------------------
-qSlicerCLIExecutableModuleFactoryPrivate::qSlicerCLIExecutableModuleFactoryPrivate(qSlicerCLIExecutableModuleFactory& object)
-:q_ptr(&object)
-{
-  this->TempDirectory = QDir::tempPath();
-}
-
 //-----------------------------------------------------------------------------
 // qSlicerCLIExecutableModuleFactory
 
@@ -259,8 +486,14 @@ qSlicerCLIExecutableModuleFactory::~qSlicerCLIExecutableModuleFactory() = defaul
 //-----------------------------------------------------------------------------
 void qSlicerCLIExecutableModuleFactory::registerItems()
 {
+  Q_D(qSlicerCLIExecutableModuleFactory);
   QStringList modulePaths = qSlicerCLIModuleFactoryHelper::modulePaths();
   this->registerAllFileItems(modulePaths);
+
+  // Start retrieving XML descriptions of executables that have neither an XML file
+  // nor a cached description. Several executables are run concurrently in the background,
+  // their output is collected when the corresponding module is instantiated.
+  d->queueXmlProbes();
 }
 
 //-----------------------------------------------------------------------------
@@ -285,7 +518,7 @@ ctkAbstractFactoryItem<qSlicerAbstractCoreModule>* qSlicerCLIExecutableModuleFac
 ::createFactoryFileBasedItem()
 {
   Q_D(qSlicerCLIExecutableModuleFactory);
-  return new qSlicerCLIExecutableModuleFactoryItem(d->TempDirectory);
+  return new qSlicerCLIExecutableModuleFactoryItem(d->TempDirectory, d);
 }
 
 //-----------------------------------------------------------------------------
@@ -300,3 +533,17 @@ void qSlicerCLIExecutableModuleFactory::setTempDirectory(const QString& newTempD
   Q_D(qSlicerCLIExecutableModuleFactory);
   d->TempDirectory = newTempDirectory;
 }
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleFactory::setXmlDescriptionCacheDirectory(const QString& cacheDirectory)
+{
+  Q_D(qSlicerCLIExecutableModuleFactory);
+  d->XmlDescriptionCacheDirectory = cacheDirectory;
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLIExecutableModuleFactory::xmlDescriptionCacheDirectory()const
+{
+  Q_D(const qSlicerCLIExecutableModuleFactory);
+  return d->XmlDescriptionCacheDirectory;
+}
@@ -25,6 +25,7 @@
 #include "qSlicerAbstractCoreModule.h"
 #include "qSlicerBaseQTCLIExport.h"
 class qSlicerCLIModule;
+class qSlicerCLIExecutableModuleFactoryPrivate;
 
 // CTK includes
 #include <ctkPimpl.h>
@@ -35,22 +36,25 @@ class qSlicerCLIExecutableModuleFactoryItem
   : public ctkAbstractFactoryFileBasedItem<qSlicerAbstractCoreModule>
 {
 public:
-  qSlicerCLIExecutableModuleFactoryItem(const QString& newTempDirectory);
+  qSlicerCLIExecutableModuleFactoryItem(const QString& newTempDirectory,
+    qSlicerCLIExecutableModuleFactoryPrivate* factoryPrivate = nullptr);
+  ~qSlicerCLIExecutableModuleFactoryItem() override;
   bool load() override;
   void uninstantiate() override;
-protected:
+
   /// Return path of the expected XML file.
   QString xmlModuleDescriptionFilePath();
 
+protected:
   qSlicerAbstractCoreModule* instanciator() override;
   QString runCLIWithXmlArgument();
 private:
+  friend class qSlicerCLIExecutableModuleFactoryPrivate;
   QString TempDirectory;
   qSlicerCLIModule* CLIModule;
+  qSlicerCLIExecutableModuleFactoryPrivate* FactoryPrivate;
 };
 
-class qSlicerCLIExecutableModuleFactoryPrivate;
-
 //-----------------------------------------------------------------------------
 class Q_SLICER_BASE_QTCLI_EXPORT qSlicerCLIExecutableModuleFactory :
   public ctkAbstractFileBasedFactory<qSlicerAbstractCoreModule>
@@ -71,6 +75,13 @@ public:
 
   void setTempDirectory(const QString& newTempDirectory);
 
+  /// Directory where XML descriptions retrieved by running CLI executables
+  /// with "--xml" argument are stored. Descriptions are reused as long as
+  /// the path, size, and modification time of the executable do not change.
+  /// If empty (default) then descriptions are not cached.
+  void setXmlDescriptionCacheDirectory(const QString& cacheDirectory);
+  QString xmlDescriptionCacheDirectory()const;
+
 protected:
   bool isValidFile(const QFileInfo& file)const override;
 
@@ -152,5 +152,43 @@ int qSlicerAbstractCoreModuleTest1(int, char * [] )
     }
   }
 
+  //
+  // Test deferred loading
+  //
+
+  {
+    AModule deferredModule;
+    deferredModule.setName("Deferred");
+    deferredModule.setLoadDeferred(true);
+    int loadRequestCount = 0;
+    QString requestedModuleName;
+    QObject::connect(&deferredModule, &qSlicerAbstractCoreModule::deferredLoadRequested,
+      [&](const QString& moduleName)
+      {
+        ++loadRequestCount;
+        requestedModuleName = moduleName;
+      });
+    deferredModule.logic();
+    deferredModule.logic();
+    if (loadRequestCount != 1 || requestedModuleName != "Deferred" || deferredModule.isLoadDeferred())
+    {
+      std::cerr << "Line " << __LINE__
+                << " - Problem with deferred loading:"
+                << " load request count:" << loadRequestCount << "\n"
+                << " requested module name:" << qPrintable(requestedModuleName) << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    deferredModule.setLoadDeferred(true);
+    QScopedPointer<qSlicerAbstractModuleRepresentation> repr(deferredModule.createNewWidgetRepresentation());
+    if (loadRequestCount != 2 || deferredModule.isLoadDeferred())
+    {
+      std::cerr << "Line " << __LINE__
+                << " - Problem with deferred loading:"
+                << " widget creation is expected to request loading." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
   return EXIT_SUCCESS;
 }
@@ -18,21 +18,175 @@
 
 ==============================================================================*/
 // Qt includes
+#include <QAtomicInt>
 #include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
 #include <QStringList>
+#include <QTextStream>
 
 // Qt Core includes
 #include "qSlicerCoreApplication.h"
 #include "qSlicerCoreIOManager.h"
+#include "qSlicerFileReader.h"
 
 // MRML includes
 #include <vtkMRMLMessageCollection.h>
 #include "vtkMRMLTextNode.h"
+#include "vtkMRMLTextStorageNode.h"
 #include "vtkMRMLScene.h"
 #include "vtkMRMLStorageNode.h"
 
+// VTK includes
+#include <vtkCollection.h>
+
 #include "vtkMRMLCoreTestingMacros.h"
 
+namespace
+{
+
+//-----------------------------------------------------------------------------
+/// Text file reader that supports reading files in worker threads
+class qSlicerPreloadTextReader : public qSlicerFileReader
+{
+public:
+  qSlicerPreloadTextReader(QObject* parent = nullptr) : qSlicerFileReader(parent) {}
+
+  QString description()const override { return "Preload text"; }
+  IOFileType fileType()const override { return QString("PreloadTextFile"); }
+  QStringList extensions()const override { return QStringList() << "Preload text (*.txt)"; }
+
+  bool load(const IOProperties& properties) override
+  {
+    ++this->NumberOfLoads;
+    vtkSmartPointer<vtkObject> data = this->preload(properties, this->userMessages());
+    return data && this->addNodes(data);
+  }
+
+  bool canPreload(const IOProperties& vtkNotUsed(properties))const override { return true; }
+
+  vtkSmartPointer<vtkObject> preload(const IOProperties& properties,
+    vtkMRMLMessageCollection* vtkNotUsed(userMessages))const override
+  {
+    this->NumberOfPreloads.ref();
+    vtkNew<vtkMRMLTextStorageNode> storageNode;
+    storageNode->SetFileName(properties["fileName"].toString().toUtf8());
+    vtkNew<vtkMRMLTextNode> textNode;
+    if (!storageNode->ReadData(textNode))
+    {
+      return nullptr;
+    }
+    vtkSmartPointer<vtkCollection> nodes = vtkSmartPointer<vtkCollection>::New();
+    nodes->AddItem(textNode);
+    nodes->AddItem(storageNode);
+    return nodes;
+  }
+
+  bool loadPreloaded(const IOProperties& vtkNotUsed(properties), vtkObject* preloadedData) override
+  {
+    ++this->NumberOfPreloadedLoads;
+    return this->addNodes(preloadedData);
+  }
+
+  bool addNodes(vtkObject* data)
+  {
+    vtkCollection* nodes = vtkCollection::SafeDownCast(data);
+    vtkMRMLTextNode* textNode = vtkMRMLTextNode::SafeDownCast(nodes->GetItemAsObject(0));
+    vtkMRMLStorageNode* storageNode = vtkMRMLStorageNode::SafeDownCast(nodes->GetItemAsObject(1));
+    this->mrmlScene()->AddNode(storageNode);
+    this->mrmlScene()->AddNode(textNode);
+    textNode->SetAndObserveStorageNodeID(storageNode->GetID());
+    this->setLoadedNodes(QStringList(QString(textNode->GetID())));
+    return true;
+  }
+
+  mutable QAtomicInt NumberOfPreloads;
+  int NumberOfPreloadedLoads{0};
+  int NumberOfLoads{0};
+};
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int TestLoadNodesWithPreload(qSlicerCoreApplication& app, const char* temporaryDirectory)
+{
+  qSlicerCoreIOManager manager;
+  qSlicerPreloadTextReader* reader = new qSlicerPreloadTextReader;
+  manager.registerIO(reader);
+  manager.setMaximumNumberOfLoadingThreads(4);
+
+  const int numberOfFiles = 8;
+  QList<qSlicerIO::IOProperties> files;
+  for (int fileIndex = 0; fileIndex < numberOfFiles; ++fileIndex)
+  {
+    QString fileName = QDir(temporaryDirectory).filePath(QString("PreloadText%1.txt").arg(fileIndex));
+    QFile file(fileName);
+    CHECK_BOOL(file.open(QIODevice::WriteOnly | QIODevice::Text), true);
+    QTextStream(&file) << "Text " << fileIndex;
+    file.close();
+    qSlicerIO::IOProperties properties;
+    properties["fileName"] = fileName;
+    properties["fileType"] = QString("PreloadTextFile");
+    files << properties;
+  }
+
+  // Load all files through the preload path
+  int numberOfTextNodesBefore = app.mrmlScene()->GetNumberOfNodesByClass("vtkMRMLTextNode");
+  QSignalSpy progressSpy(&manager, SIGNAL(loadProgress(int,int)));
+  vtkNew<vtkCollection> loadedNodes;
+  CHECK_BOOL(manager.loadNodes(files, loadedNodes), true);
+  CHECK_INT(loadedNodes->GetNumberOfItems(), numberOfFiles);
+  CHECK_INT(app.mrmlScene()->GetNumberOfNodesByClass("vtkMRMLTextNode"), numberOfTextNodesBefore + numberOfFiles);
+  CHECK_INT(reader->NumberOfPreloads.loadAcquire(), numberOfFiles);
+  CHECK_INT(reader->NumberOfPreloadedLoads, numberOfFiles);
+  CHECK_INT(reader->NumberOfLoads, 0);
+  // Nodes are added in the order of the files
+  for (int fileIndex = 0; fileIndex < numberOfFiles; ++fileIndex)
+  {
+    vtkMRMLTextNode* textNode = vtkMRMLTextNode::SafeDownCast(loadedNodes->GetItemAsObject(fileIndex));
+    CHECK_NOT_NULL(textNode);
+    CHECK_STRING(textNode->GetText(), QString("Text %1").arg(fileIndex).toUtf8().constData());
+  }
+  // Progress is reported after each file
+  CHECK_INT(progressSpy.count(), numberOfFiles);
+  for (int fileIndex = 0; fileIndex < numberOfFiles; ++fileIndex)
+  {
+    CHECK_INT(progressSpy[fileIndex][0].toInt(), fileIndex + 1);
+    CHECK_INT(progressSpy[fileIndex][1].toInt(), numberOfFiles);
+  }
+  CHECK_BOOL(manager.isLoadingCanceled(), false);
+
+  // Cancel loading after a few files
+  const int numberOfFilesBeforeCancel = 3;
+  progressSpy.clear();
+  QObject::connect(&manager, &qSlicerCoreIOManager::loadProgress, [&manager](int numberOfProcessedFiles, int)
+  {
+    if (numberOfProcessedFiles == numberOfFilesBeforeCancel)
+    {
+      manager.cancelLoading();
+    }
+  });
+  loadedNodes->RemoveAllItems();
+  CHECK_BOOL(manager.loadNodes(files, loadedNodes), false);
+  CHECK_BOOL(manager.isLoadingCanceled(), true);
+  CHECK_INT(loadedNodes->GetNumberOfItems(), numberOfFilesBeforeCancel);
+  CHECK_INT(progressSpy.count(), numberOfFilesBeforeCancel);
+  CHECK_INT(app.mrmlScene()->GetNumberOfNodesByClass("vtkMRMLTextNode"),
+    numberOfTextNodesBefore + numberOfFiles + numberOfFilesBeforeCancel);
+
+  // Loading without worker threads uses load()
+  manager.setMaximumNumberOfLoadingThreads(0);
+  QObject::disconnect(&manager, &qSlicerCoreIOManager::loadProgress, nullptr, nullptr);
+  loadedNodes->RemoveAllItems();
+  CHECK_BOOL(manager.loadNodes(files, loadedNodes), true);
+  CHECK_BOOL(manager.isLoadingCanceled(), false);
+  CHECK_INT(loadedNodes->GetNumberOfItems(), numberOfFiles);
+  CHECK_INT(reader->NumberOfLoads, numberOfFiles);
+
+  return EXIT_SUCCESS;
+}
+
 int TestLongNodeNameSaving(const char* temporaryDirectory)
 {
   vtkNew<vtkMRMLScene> scene;
@@ -168,6 +322,7 @@ int qSlicerCoreIOManagerTest1(int argc, char * argv [])
     temporaryDirectory = app.mrmlScene()->GetRootDirectory();
   }
   CHECK_EXIT_SUCCESS(TestLongNodeNameSaving(temporaryDirectory));
+  CHECK_EXIT_SUCCESS(TestLoadNodesWithPreload(app, temporaryDirectory));
 
   return EXIT_SUCCESS;
 }
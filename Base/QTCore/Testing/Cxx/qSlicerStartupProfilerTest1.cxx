@@ -0,0 +1,88 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+// CTK includes
+#include <ctkCoreTestingMacros.h>
+
+// Slicer includes
+#include "qSlicerStartupProfiler.h"
+
+// STD includes
+#include <cstdlib>
+#include <iostream>
+
+//-----------------------------------------------------------------------------
+int qSlicerStartupProfilerTest1(int, char * [] )
+{
+  qSlicerStartupProfiler profiler;
+
+  // Events are ignored while recording is disabled
+  CHECK_BOOL(profiler.isEnabled(), false);
+  {
+    qSlicerStartupProfiler::ScopedEvent event(&profiler, "Ignored", "Setup");
+  }
+  profiler.addEvent("Ignored", "Setup", 0, 10);
+  CHECK_INT(profiler.events().count(), 0);
+
+  // A null profiler is accepted by scoped events
+  {
+    qSlicerStartupProfiler::ScopedEvent event(nullptr, "Ignored", "Setup");
+  }
+
+  profiler.setEnabled(true);
+  profiler.addEvent("Data", "Instantiation", 100, 2000);
+  profiler.addEvent("Data", "Setup", 2100, 5000);
+  profiler.addEvent("Volumes", "Setup", 7100, 1000);
+  {
+    qSlicerStartupProfiler::ScopedEvent event(&profiler, "Markups", "Logic creation");
+  }
+  CHECK_INT(profiler.events().count(), 4);
+  CHECK_BOOL(profiler.events()[3].Name == "Markups", true);
+  CHECK_BOOL(profiler.events()[3].StartTime >= 0 && profiler.events()[3].Duration >= 0, true);
+
+  CHECK_INT(static_cast<int>(profiler.totalDuration("Data")), 7000);
+  CHECK_INT(static_cast<int>(profiler.totalDuration("Data", "Setup")), 5000);
+  CHECK_INT(static_cast<int>(profiler.totalDuration("Unknown")), 0);
+
+  // Slowest module is listed first
+  QString summary = profiler.summary();
+  CHECK_BOOL(summary.indexOf("Data") >= 0, true);
+  CHECK_BOOL(summary.indexOf("Data") < summary.indexOf("Volumes"), true);
+
+  // Chrome trace
+  QJsonDocument trace = QJsonDocument::fromJson(profiler.chromeTrace());
+  CHECK_BOOL(trace.isObject(), true);
+  QJsonArray traceEvents = trace.object()["traceEvents"].toArray();
+  CHECK_INT(traceEvents.count(), 4);
+  QJsonObject traceEvent = traceEvents[1].toObject();
+  CHECK_BOOL(traceEvent["ph"].toString() == "X", true);
+  CHECK_BOOL(traceEvent["cat"].toString() == "Setup", true);
+  CHECK_INT(traceEvent["ts"].toInt(), 2100);
+  CHECK_INT(traceEvent["dur"].toInt(), 5000);
+  CHECK_BOOL(traceEvent["args"].toObject()["name"].toString() == "Data", true);
+
+  // Enabling recording again clears events
+  profiler.setEnabled(true);
+  CHECK_INT(profiler.events().count(), 0);
+
+  return EXIT_SUCCESS;
+}
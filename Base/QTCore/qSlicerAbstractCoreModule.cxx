@@ -49,6 +49,7 @@ public:
   bool                                       Installed;
   bool                                       BuiltIn;
   bool                                       WidgetRepresentationCreationEnabled;
+  bool                                       LoadDeferred;
   qSlicerAbstractModuleRepresentation*       WidgetRepresentation;
   QList<qSlicerAbstractModuleRepresentation*> WidgetRepresentations;
   vtkSmartPointer<vtkMRMLScene>              MRMLScene;
@@ -66,6 +67,7 @@ qSlicerAbstractCoreModulePrivate::qSlicerAbstractCoreModulePrivate()
   this->Installed = false;
   this->BuiltIn = true;
   this->WidgetRepresentationCreationEnabled = true;
+  this->LoadDeferred = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -253,6 +255,12 @@ qSlicerAbstractModuleRepresentation* qSlicerAbstractCoreModule::createNewWidgetR
     return nullptr;
   }
 
+  if (d->LoadDeferred)
+  {
+    // Complete loading of the module (logic creation and setup)
+    this->logic();
+  }
+
   // Since 'logic()' should have been called in 'initialize(), let's make
   // sure the 'logic()' method call is consistent and won't create a
   // different logic object
@@ -286,6 +294,13 @@ vtkMRMLAbstractLogic* qSlicerAbstractCoreModule::logic()
 {
   Q_D(qSlicerAbstractCoreModule);
 
+  if (d->LoadDeferred)
+  {
+    // The module manager completes loading of the module, which creates the logic
+    d->LoadDeferred = false;
+    emit this->deferredLoadRequested(this->name());
+  }
+
   // Return a logic object is one already exists
   if (d->Logic)
   {
@@ -348,3 +363,17 @@ QString qSlicerAbstractCoreModule::defaultDocumentationLink()const
     + QString("</p>");
   return linkText;
 }
+
+//-----------------------------------------------------------------------------
+bool qSlicerAbstractCoreModule::isLoadDeferred()const
+{
+  Q_D(const qSlicerAbstractCoreModule);
+  return d->LoadDeferred;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerAbstractCoreModule::setLoadDeferred(bool deferred)
+{
+  Q_D(qSlicerAbstractCoreModule);
+  d->LoadDeferred = deferred;
+}
@@ -307,6 +307,21 @@ public:
   /// Return node types associated with this module (e.g., node types this module can edit)
   virtual QStringList associatedNodeTypes()const;
 
+  /// Set/Get if creation of the logic and setup of the module is postponed
+  /// until first use.
+  /// When set, the first call to logic(), widgetRepresentation() or
+  /// createNewWidgetRepresentation() clears the flag and emits
+  /// deferredLoadRequested() so that the module manager can complete loading
+  /// of the module before it is used.
+  /// \sa qSlicerModuleFactoryManager::setLazyLoading()
+  bool isLoadDeferred()const;
+  void setLoadDeferred(bool deferred);
+
+signals:
+  /// Emitted when a module with deferred loading is used for the first time.
+  /// \sa isLoadDeferred()
+  void deferredLoadRequested(const QString& moduleName);
+
 public slots:
 
   /// Set the current MRML scene to the module, it is propagated to the logic
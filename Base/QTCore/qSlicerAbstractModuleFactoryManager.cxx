@@ -25,6 +25,7 @@
 #include "qSlicerCoreApplication.h"
 #include "qSlicerAbstractModuleFactoryManager.h"
 #include "qSlicerAbstractCoreModule.h"
+#include "qSlicerStartupProfiler.h"
 
 // STD includes
 #include <csignal>
@@ -59,6 +60,7 @@ public:
   QMap<qSlicerModuleFactory*, int> Factories;
   QMap<QString, qSlicerModuleFactory*> RegisteredModules;
   QMap<QString, QStringList> ModuleDependees;
+  QScopedPointer<qSlicerStartupProfiler> StartupProfiler;
 
   bool Verbose;
 };
@@ -67,6 +69,7 @@ public:
 // qSlicerAbstractModuleFactoryManagerPrivate methods
 qSlicerAbstractModuleFactoryManagerPrivate::qSlicerAbstractModuleFactoryManagerPrivate(qSlicerAbstractModuleFactoryManager& object)
   : q_ptr(&object)
+  , StartupProfiler(new qSlicerStartupProfiler)
 {
   this->Verbose = false;
 }
@@ -254,7 +257,11 @@ void qSlicerAbstractModuleFactoryManager::registerModules()
   // \todo: don't support factories other than filebased factories
   foreach(qSlicerModuleFactory* factory, d->notFileBasedFactories())
   {
-    factory->registerItems();
+    {
+      qSlicerStartupProfiler::ScopedEvent profilerEvent(
+        d->StartupProfiler.data(), typeid(*factory).name(), "Registration");
+      factory->registerItems();
+    }
     foreach(const QString& moduleName, factory->itemKeys())
     {
       if (d->Verbose)
@@ -348,6 +355,7 @@ void qSlicerAbstractModuleFactoryManager::registerModule(const QFileInfo& file)
     emit moduleIgnored(moduleName);
     return;
   }
+  qSlicerStartupProfiler::ScopedEvent profilerEvent(d->StartupProfiler.data(), moduleName, "Registration");
   QString registeredModuleName = moduleFactory->registerFileItem(file);
   if (registeredModuleName != moduleName)
   {
@@ -401,6 +409,7 @@ qSlicerAbstractCoreModule* qSlicerAbstractModuleFactoryManager
     qCritical() << "Fail to instantiate module " << moduleName << " (not registered)";
     return nullptr;
   }
+  qSlicerStartupProfiler::ScopedEvent profilerEvent(d->StartupProfiler.data(), moduleName, "Instantiation");
   qSlicerAbstractCoreModule* module = factory->instantiate(moduleName);
   if (!module)
   {
@@ -425,6 +434,13 @@ qSlicerAbstractCoreModule* qSlicerAbstractModuleFactoryManager
   return module;
 }
 
+//-----------------------------------------------------------------------------
+qSlicerStartupProfiler* qSlicerAbstractModuleFactoryManager::startupProfiler()const
+{
+  Q_D(const qSlicerAbstractModuleFactoryManager);
+  return d->StartupProfiler.data();
+}
+
 //-----------------------------------------------------------------------------
 QStringList qSlicerAbstractModuleFactoryManager::registeredModuleNames() const
 {
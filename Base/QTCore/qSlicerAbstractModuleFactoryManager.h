@@ -31,6 +31,7 @@
 #include "qSlicerBaseQTCoreExport.h"
 
 class qSlicerAbstractCoreModule;
+class qSlicerStartupProfiler;
 
 class qSlicerAbstractModuleFactoryManagerPrivate;
 
@@ -196,6 +197,11 @@ public:
   /// \sa dependentModules(), qSlicerAbstractCoreModule::dependencies()
   QStringList moduleDependees(const QString& module)const;
 
+  /// Return the profiler recording the time spent registering, instantiating
+  /// and loading each module. Recording is disabled by default.
+  /// \sa qSlicerStartupProfiler::setEnabled()
+  qSlicerStartupProfiler* startupProfiler()const;
+
 signals:
   /// \brief This signal is emitted when all the modules associated with the
   /// registered factories have been loaded
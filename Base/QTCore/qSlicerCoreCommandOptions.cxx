@@ -334,6 +334,20 @@ bool qSlicerCoreCommandOptions::verboseModuleDiscovery() const
   return d->ParsedArgs.value("verbose-module-discovery").toBool();
 }
 
+//-----------------------------------------------------------------------------
+QString qSlicerCoreCommandOptions::startupProfileFile() const
+{
+  Q_D(const qSlicerCoreCommandOptions);
+  return d->ParsedArgs.value("startup-profile-file").toString();
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerCoreCommandOptions::lazyModuleLoading() const
+{
+  Q_D(const qSlicerCoreCommandOptions);
+  return d->ParsedArgs.value("lazy-module-loading").toBool();
+}
+
 //-----------------------------------------------------------------------------
 bool qSlicerCoreCommandOptions::verbose()const
 {
@@ -483,6 +497,14 @@ void qSlicerCoreCommandOptions::addArguments()
   this->addArgument("verbose-module-discovery", "", QVariant::Bool,
                     /*no tr*/"Enable verbose output during module discovery process.");
 
+  this->addArgument("startup-profile-file", "", QVariant::String,
+                    /*no tr*/"Record time spent loading each module and write it to the specified file"
+                    " in Chrome trace event format (can be viewed in chrome://tracing).");
+
+  this->addArgument("lazy-module-loading", "", QVariant::Bool,
+                    /*no tr*/"Postpone creation of module logic and setup until the module is first used."
+                    " Modules that other modules depend on are loaded at startup.");
+
   this->addArgument("disable-settings", "", QVariant::Bool,
                     /*no tr*/"Start application ignoring user settings and using new temporary settings.");
 
@@ -54,6 +54,8 @@ class Q_SLICER_BASE_QTCORE_EXPORT qSlicerCoreCommandOptions : public ctkCommandL
   Q_PROPERTY(bool displayTemporaryPathAndExit READ displayTemporaryPathAndExit CONSTANT)
   Q_PROPERTY(bool displayMessageAndExit READ displayMessageAndExit STORED false CONSTANT)
   Q_PROPERTY(bool verboseModuleDiscovery READ verboseModuleDiscovery CONSTANT)
+  Q_PROPERTY(QString startupProfileFile READ startupProfileFile CONSTANT)
+  Q_PROPERTY(bool lazyModuleLoading READ lazyModuleLoading CONSTANT)
   Q_PROPERTY(bool disableMessageHandlers READ disableMessageHandlers CONSTANT)
   Q_PROPERTY(bool testingEnabled READ isTestingEnabled CONSTANT)
 #ifdef Slicer_USE_PYTHONQT
@@ -164,6 +166,16 @@ public:
   /// Return True if slicer should display details regarding the module discovery process
   bool verboseModuleDiscovery()const;
 
+  /// Return the file where time spent registering, instantiating and loading
+  /// each module is written in Chrome trace event format.
+  /// Empty if startup profiling is disabled.
+  QString startupProfileFile()const;
+
+  /// Return True if creation of module logic and setup should be postponed
+  /// until the module is first used.
+  /// \sa qSlicerModuleFactoryManager::setLazyLoading()
+  bool lazyModuleLoading()const;
+
   /// Return True if slicer should display information at startup
   bool verbose()const;
 
@@ -23,6 +23,10 @@
 #include <QDir>
 #include <QElapsedTimer>
 #include <QFileInfo>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QSharedPointer>
+#include <QThreadPool>
 
 // CTK includes
 #include <ctkUtils.h>
@@ -52,6 +56,25 @@
 #include <vtkStringArray.h>
 #include <vtkGeneralTransform.h>
 
+//-----------------------------------------------------------------------------
+/// Read a file in a worker thread using qSlicerFileReader::preload()
+class qSlicerFilePreloadTask : public QRunnable
+{
+public:
+  qSlicerFilePreloadTask(qSlicerFileReader* reader, const qSlicerIO::IOProperties& properties);
+
+  void run() override;
+
+  /// Wait until run() is completed.
+  void wait();
+
+  qSlicerFileReader* Reader;
+  qSlicerIO::IOProperties Properties;
+  vtkSmartPointer<vtkObject> PreloadedData;
+  vtkNew<vtkMRMLMessageCollection> UserMessages;
+  QSemaphore Completed;
+};
+
 //-----------------------------------------------------------------------------
 class qSlicerCoreIOManagerPrivate
 {
@@ -60,6 +83,14 @@ public:
   ~qSlicerCoreIOManagerPrivate();
   vtkMRMLScene* currentScene()const;
 
+  /// Start reading files in worker threads, for files whose reader supports it.
+  /// The returned list contains a task (or nullptr) for each file.
+  QList<QSharedPointer<qSlicerFilePreloadTask> > startPreloading(
+    const QList<qSlicerIO::IOProperties>& files);
+
+  /// Cancel tasks that have not started yet and wait for completion of the others.
+  void stopPreloading(const QList<QSharedPointer<qSlicerFilePreloadTask> >& tasks);
+
   qSlicerFileReader* reader(const QString& fileName)const;
   QList<qSlicerFileReader*> readers(const QString& fileName)const;
 
@@ -75,8 +106,42 @@ public:
   QMap<qSlicerIO::IOFileType, QStringList> FileTypes;
 
   QString DefaultSceneFileType;
+
+  QThreadPool PreloadThreadPool;
+  /// Preloaded data of the file that loadNodes() is about to load
+  QSharedPointer<qSlicerFilePreloadTask> CurrentPreloadTask;
+  bool LoadingCanceled{false};
 };
 
+//-----------------------------------------------------------------------------
+// qSlicerFilePreloadTask methods
+
+//-----------------------------------------------------------------------------
+qSlicerFilePreloadTask::qSlicerFilePreloadTask(qSlicerFileReader* reader, const qSlicerIO::IOProperties& properties)
+  : Reader(reader)
+  , Properties(properties)
+{
+  // Lifetime is managed by the shared pointer in loadNodes()
+  this->setAutoDelete(false);
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerFilePreloadTask::run()
+{
+  this->PreloadedData = this->Reader->preload(this->Properties, this->UserMessages);
+  this->Completed.release();
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerFilePreloadTask::wait()
+{
+  this->Completed.acquire();
+  this->Completed.release();
+}
+
+//-----------------------------------------------------------------------------
+// qSlicerCoreIOManagerPrivate methods
+
 //-----------------------------------------------------------------------------
 qSlicerCoreIOManagerPrivate::qSlicerCoreIOManagerPrivate() = default;
 
@@ -89,6 +154,53 @@ vtkMRMLScene* qSlicerCoreIOManagerPrivate::currentScene()const
   return qSlicerCoreApplication::application()->mrmlScene();
 }
 
+//-----------------------------------------------------------------------------
+QList<QSharedPointer<qSlicerFilePreloadTask> > qSlicerCoreIOManagerPrivate::startPreloading(
+  const QList<qSlicerIO::IOProperties>& files)
+{
+  QList<QSharedPointer<qSlicerFilePreloadTask> > tasks;
+  foreach(const qSlicerIO::IOProperties& fileProperties, files)
+  {
+    QSharedPointer<qSlicerFilePreloadTask> task;
+    QString fileName = fileProperties.value("fileName").toString();
+    if (this->PreloadThreadPool.maxThreadCount() > 0
+      && fileProperties.value("fileName").type() == QVariant::String
+      && !fileName.isEmpty())
+    {
+      // Same reader as the one that loadNodes() tries first
+      qSlicerIO::IOFileType fileType = fileProperties.value("fileType").toString();
+      foreach(qSlicerFileReader* reader, this->Readers)
+      {
+        if (reader->fileType() != fileType || reader->canLoadFileConfidence(fileName) <= 0.0)
+        {
+          continue;
+        }
+        if (reader->canPreload(fileProperties))
+        {
+          task = QSharedPointer<qSlicerFilePreloadTask>(new qSlicerFilePreloadTask(reader, fileProperties));
+          this->PreloadThreadPool.start(task.data());
+        }
+        break;
+      }
+    }
+    tasks << task;
+  }
+  return tasks;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCoreIOManagerPrivate::stopPreloading(const QList<QSharedPointer<qSlicerFilePreloadTask> >& tasks)
+{
+  foreach(const QSharedPointer<qSlicerFilePreloadTask>& task, tasks)
+  {
+    if (task && !this->PreloadThreadPool.tryTake(task.data()))
+    {
+      // already started (or completed)
+      task->wait();
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 qSlicerFileReader* qSlicerCoreIOManagerPrivate::reader(const QString& fileName)const
 {
@@ -642,6 +754,15 @@ bool qSlicerCoreIOManager::loadNodes(const qSlicerIO::IOFileType& fileType,
   //: %1 is the filename
   QString userMessagePrefix = tr("Loading %1").arg(parameters["fileName"].toString()) + " - ";
 
+  // Use data read in a worker thread if available for this file
+  QSharedPointer<qSlicerFilePreloadTask> preloadTask;
+  if (d->CurrentPreloadTask
+    && d->CurrentPreloadTask->Properties.value("fileName") == parameters["fileName"])
+  {
+    preloadTask = d->CurrentPreloadTask;
+    d->CurrentPreloadTask.clear();
+  }
+
   QStringList nodes;
   foreach (qSlicerFileReader* reader, readers)
   {
@@ -654,7 +775,29 @@ bool qSlicerCoreIOManager::loadNodes(const qSlicerIO::IOFileType& fileType,
     {
       continue;
     }
-    bool currentFileSuccess = reader->load(parameters);
+    bool currentFileSuccess = false;
+    if (preloadTask && preloadTask->Reader == reader)
+    {
+      if (!d->PreloadThreadPool.tryTake(preloadTask.data()))
+      {
+        preloadTask->wait();
+      }
+      else
+      {
+        // not started yet, read it now
+        preloadTask->run();
+      }
+      if (preloadTask->PreloadedData)
+      {
+        currentFileSuccess = reader->loadPreloaded(parameters, preloadTask->PreloadedData);
+      }
+      reader->userMessages()->AddMessages(preloadTask->UserMessages);
+      preloadTask.clear();
+    }
+    else
+    {
+      currentFileSuccess = reader->load(parameters);
+    }
     if (userMessages)
     {
       userMessages->AddMessages(reader->userMessages(), userMessagePrefix.toStdString());
@@ -704,23 +847,69 @@ bool qSlicerCoreIOManager::loadNodes(const qSlicerIO::IOFileType& fileType,
 bool qSlicerCoreIOManager::loadNodes(const QList<qSlicerIO::IOProperties>& files,
           vtkCollection* loadedNodes, vtkMRMLMessageCollection* userMessages/*=nullptr*/)
 {
+  Q_D(qSlicerCoreIOManager);
+  d->LoadingCanceled = false;
+
+  // Files are read and decoded in worker threads while nodes of previous files
+  // are added to the scene in this thread.
+  QList<QSharedPointer<qSlicerFilePreloadTask> > preloadTasks = d->startPreloading(files);
+
   bool success = true;
-  foreach(qSlicerIO::IOProperties fileProperties, files)
+  for (int fileIndex = 0; fileIndex < files.count(); ++fileIndex)
   {
+    if (d->LoadingCanceled)
+    {
+      success = false;
+      break;
+    }
+    const qSlicerIO::IOProperties& fileProperties = files[fileIndex];
     int numberOfUserMessagesBefore = userMessages ? userMessages->GetNumberOfMessages() : 0;
+    d->CurrentPreloadTask = preloadTasks[fileIndex];
     success = this->loadNodes(
       static_cast<qSlicerIO::IOFileType>(fileProperties["fileType"].toString()),
       fileProperties, loadedNodes, userMessages)
       && success;
+    d->CurrentPreloadTask.clear();
     // Add a separator between nodes
     if (userMessages && userMessages->GetNumberOfMessages() > numberOfUserMessagesBefore)
     {
       userMessages->AddSeparator();
     }
+    emit loadProgress(fileIndex + 1, files.count());
   }
+
+  d->stopPreloading(preloadTasks);
   return success;
 }
 
+//-----------------------------------------------------------------------------
+void qSlicerCoreIOManager::cancelLoading()
+{
+  Q_D(qSlicerCoreIOManager);
+  d->LoadingCanceled = true;
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerCoreIOManager::isLoadingCanceled()const
+{
+  Q_D(const qSlicerCoreIOManager);
+  return d->LoadingCanceled;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCoreIOManager::setMaximumNumberOfLoadingThreads(int count)
+{
+  Q_D(qSlicerCoreIOManager);
+  d->PreloadThreadPool.setMaxThreadCount(count);
+}
+
+//-----------------------------------------------------------------------------
+int qSlicerCoreIOManager::maximumNumberOfLoadingThreads()const
+{
+  Q_D(const qSlicerCoreIOManager);
+  return d->PreloadThreadPool.maxThreadCount();
+}
+
 //-----------------------------------------------------------------------------
 vtkMRMLNode* qSlicerCoreIOManager::loadNodesAndGetFirst(qSlicerIO::IOFileType fileType,
   const qSlicerIO::IOProperties& parameters, vtkMRMLMessageCollection* userMessages/*=nullptr*/)
@@ -148,11 +148,26 @@ public:
 
   /// Utility function that loads a bunch of files. The "fileType" attribute should
   /// in the parameter map for each node to load.
+  /// Files whose reader supports it (see qSlicerFileReader::canPreload()) are read
+  /// in worker threads while previous files are added to the scene.
+  /// loadProgress() is emitted after each file and remaining files are skipped
+  /// if cancelLoading() is called.
   /// If a valid pointer is passed to userMessages additional error or warning information may be returned in it.
   virtual bool loadNodes(const QList<qSlicerIO::IOProperties>& files,
                          vtkCollection* loadedNodes = nullptr,
                          vtkMRMLMessageCollection* userMessages = nullptr);
 
+  /// Stop loadNodes() after the file that is currently being loaded.
+  /// Typically called from a slot connected to loadProgress().
+  Q_INVOKABLE void cancelLoading();
+  bool isLoadingCanceled()const;
+
+  /// Set/Get the maximum number of worker threads that loadNodes() uses for
+  /// reading files. Files are read in the main thread if set to 0.
+  /// Default is the number of CPU cores.
+  void setMaximumNumberOfLoadingThreads(int count);
+  int maximumNumberOfLoadingThreads()const;
+
   /// Load a list of node corresponding to \a fileType and return the first loaded node.
   /// This function is provided for convenience and is equivalent to call loadNodes
   /// with a vtkCollection parameter and retrieve the first element.
@@ -292,6 +307,11 @@ signals:
   /// \sa loadNodes(const qSlicerIO::IOFileType&, const qSlicerIO::IOProperties&, vtkCollection*)
   void newFileLoaded(const qSlicerIO::IOProperties& loadedFileParameters);
 
+  /// This signal is emitted by loadNodes() each time a file of the
+  /// list has been processed (successfully or not).
+  /// \sa cancelLoading()
+  void loadProgress(int numberOfProcessedFiles, int numberOfFiles);
+
   /// This signal is emitted each time a file is saved using saveNodes()
   /// The \a savedFileParameters QVariant map contains the parameters
   /// passed to the writer.
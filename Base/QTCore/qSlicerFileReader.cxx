@@ -27,6 +27,9 @@
 /// QtCore includes
 #include "qSlicerFileReader.h"
 
+// VTK includes
+#include <vtkObject.h>
+
 //-----------------------------------------------------------------------------
 class qSlicerFileReaderPrivate
 {
@@ -120,6 +123,29 @@ bool qSlicerFileReader::load(const IOProperties& properties)
   return false;
 }
 
+//----------------------------------------------------------------------------
+bool qSlicerFileReader::canPreload(const IOProperties& properties)const
+{
+  Q_UNUSED(properties);
+  return false;
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkObject> qSlicerFileReader::preload(const IOProperties& properties,
+  vtkMRMLMessageCollection* userMessages)const
+{
+  Q_UNUSED(properties);
+  Q_UNUSED(userMessages);
+  return nullptr;
+}
+
+//----------------------------------------------------------------------------
+bool qSlicerFileReader::loadPreloaded(const IOProperties& properties, vtkObject* preloadedData)
+{
+  Q_UNUSED(preloadedData);
+  return this->load(properties);
+}
+
 //----------------------------------------------------------------------------
 void qSlicerFileReader::setLoadedNodes(const QStringList& nodes)
 {
@@ -28,7 +28,11 @@
 #include "qSlicerIO.h"
 #include "qSlicerBaseQTCoreExport.h"
 
+// VTK includes
+#include <vtkSmartPointer.h>
+
 class qSlicerFileReaderOptions;
+class vtkObject;
 class qSlicerFileReaderPrivate;
 
 class Q_SLICER_BASE_QTCORE_EXPORT qSlicerFileReader
@@ -75,6 +79,28 @@ public:
   /// Properties available: fileMode, multipleFiles, fileType.
   Q_INVOKABLE virtual bool load(const IOProperties& properties);
 
+  /// Returns true if the file described by \a properties can be read using
+  /// preload() then added to the scene using loadPreloaded().
+  /// Default implementation returns false.
+  /// \sa preload(), loadPreloaded()
+  virtual bool canPreload(const IOProperties& properties)const;
+
+  /// Read and decode the file described by \a properties into data objects
+  /// that are not in the scene.
+  /// The method is called from a worker thread, therefore it must not access
+  /// the scene, the GUI or modify the reader.
+  /// Returns nullptr on failure, in which case details may be added to \a userMessages.
+  /// Default implementation returns nullptr.
+  /// \sa canPreload(), loadPreloaded(), qSlicerCoreIOManager::loadNodes()
+  virtual vtkSmartPointer<vtkObject> preload(const IOProperties& properties,
+    vtkMRMLMessageCollection* userMessages)const;
+
+  /// Add data previously read by preload() to the scene.
+  /// It is called on the main thread instead of load() and it must set
+  /// loaded nodes the same way as load().
+  /// Default implementation ignores \a preloadedData and calls load().
+  virtual bool loadPreloaded(const IOProperties& properties, vtkObject* preloadedData);
+
   /// Return the list of generated nodes from loading the file(s) in load().
   /// Empty list if load() failed
   /// \sa setLoadedNodes(), load()
@@ -21,6 +21,7 @@
 // Slicer includes
 #include "qSlicerModuleFactoryManager.h"
 #include "qSlicerAbstractCoreModule.h"
+#include "qSlicerStartupProfiler.h"
 
 #include "vtkSlicerConfigure.h" // XXX For modulePaths() function.
 
@@ -38,7 +39,17 @@ protected:
 public:
   qSlicerModuleFactoryManagerPrivate(qSlicerModuleFactoryManager& object);
 
+  /// Return true if creation of the logic and setup of the module can be
+  /// postponed until first use.
+  bool canDeferLoading(const QString& name, const QString& dependee,
+    qSlicerAbstractCoreModule* instance)const;
+
+  /// Create the logic, setup the module and set the scene.
+  bool initializeModule(const QString& name, qSlicerAbstractCoreModule* instance);
+
   QStringList LoadedModules;
+  QStringList DeferredModules;
+  bool LazyLoading;
   vtkSlicerApplicationLogic* AppLogic;
   vtkMRMLScene* MRMLScene;
 };
@@ -49,10 +60,75 @@ qSlicerModuleFactoryManagerPrivate
 ::qSlicerModuleFactoryManagerPrivate(qSlicerModuleFactoryManager& object)
   : q_ptr(&object)
 {
+  this->LazyLoading = false;
   this->AppLogic = nullptr;
   this->MRMLScene = nullptr;
 }
 
+//-----------------------------------------------------------------------------
+bool qSlicerModuleFactoryManagerPrivate::canDeferLoading(const QString& name,
+  const QString& dependee, qSlicerAbstractCoreModule* instance)const
+{
+  Q_Q(const qSlicerModuleFactoryManager);
+  if (!this->LazyLoading)
+  {
+    return false;
+  }
+  // Modules that other modules depend on must be set up before their dependees
+  if (!dependee.isEmpty() || !q->moduleDependees(name).isEmpty())
+  {
+    return false;
+  }
+  // Logic of modules associated with node types typically registers these
+  // node classes in the scene, which must be done before a scene is loaded.
+  if (!instance->associatedNodeTypes().isEmpty())
+  {
+    return false;
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerModuleFactoryManagerPrivate::initializeModule(const QString& name,
+  qSlicerAbstractCoreModule* instance)
+{
+  Q_Q(qSlicerModuleFactoryManager);
+  qSlicerStartupProfiler* profiler = q->startupProfiler();
+
+  // Sets the logic for the module in the application logic
+  {
+    qSlicerStartupProfiler::ScopedEvent profilerEvent(profiler, name, "Logic creation");
+    instance->logic();
+  }
+  this->AppLogic->SetModuleLogic(name.toStdString().c_str(), instance->logic());
+
+  // Initialize module
+  {
+    qSlicerStartupProfiler::ScopedEvent profilerEvent(profiler, name, "Setup");
+    instance->initialize(this->AppLogic);
+  }
+
+  // Check the module has a title (required)
+  if (instance->title().isEmpty())
+  {
+    this->AppLogic->SetModuleLogic(name.toStdString().c_str(), nullptr);
+    qWarning() << "Failed to retrieve module title corresponding to module name: " << name;
+    Q_ASSERT(!instance->title().isEmpty());
+    return false;
+  }
+
+  // Set the MRML scene
+  {
+    qSlicerStartupProfiler::ScopedEvent profilerEvent(profiler, name, "MRML node registration");
+    instance->setMRMLScene(this->MRMLScene);
+  }
+
+  // Module should also be aware if current MRML scene has changed
+  QObject::connect(q, SIGNAL(mrmlSceneChanged(vtkMRMLScene*)),
+                   instance, SLOT(setMRMLScene(vtkMRMLScene*)));
+  return true;
+}
+
 //-----------------------------------------------------------------------------
 // qSlicerModuleFactoryManager methods
 
@@ -176,28 +252,26 @@ bool qSlicerModuleFactoryManager::loadModule(const QString& name, const QString&
   // Update internal Map
   d->LoadedModules << name;
 
-  // Sets the logic for the module in the application logic
-  d->AppLogic->SetModuleLogic(name.toStdString().c_str(), instance->logic());
-
-  // Initialize module
-  instance->initialize(d->AppLogic);
-
-  // Check the module has a title (required)
-  if (instance->title().isEmpty())
+  if (d->canDeferLoading(name, dependee, instance))
+  {
+    // Check the module has a title (required)
+    if (instance->title().isEmpty())
+    {
+      qWarning() << "Failed to retrieve module title corresponding to module name: " << name;
+      Q_ASSERT(!instance->title().isEmpty());
+      return false;
+    }
+    // Logic creation and setup happen when the module is first used
+    d->DeferredModules << name;
+    instance->setLoadDeferred(true);
+    this->connect(instance, SIGNAL(deferredLoadRequested(QString)),
+                  this, SLOT(onDeferredLoadRequested(QString)));
+  }
+  else if (!d->initializeModule(name, instance))
   {
-    d->AppLogic->SetModuleLogic(name.toStdString().c_str(), nullptr);
-    qWarning() << "Failed to retrieve module title corresponding to module name: " << name;
-    Q_ASSERT(!instance->title().isEmpty());
     return false;
   }
 
-  // Set the MRML scene
-  instance->setMRMLScene(d->MRMLScene);
-
-  // Module should also be aware if current MRML scene has changed
-  this->connect(this,SIGNAL(mrmlSceneChanged(vtkMRMLScene*)),
-                instance, SLOT(setMRMLScene(vtkMRMLScene*)));
-
   // Handle post-load initialization
   emit this->moduleLoaded(name);
 
@@ -256,6 +330,7 @@ void qSlicerModuleFactoryManager::unloadModule(const QString& name)
   }
   emit this->moduleAboutToBeUnloaded(name);
   d->LoadedModules.removeOne(name);
+  d->DeferredModules.removeOne(name);
   this->uninstantiateModule(name);
 
   // Remove the registration of module logic in application logic.
@@ -304,6 +379,46 @@ qSlicerAbstractCoreModule* qSlicerModuleFactoryManager::loadedModule(const QStri
   return this->moduleInstance(name);
 }
 
+//-----------------------------------------------------------------------------
+void qSlicerModuleFactoryManager::setLazyLoading(bool lazy)
+{
+  Q_D(qSlicerModuleFactoryManager);
+  d->LazyLoading = lazy;
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerModuleFactoryManager::lazyLoading()const
+{
+  Q_D(const qSlicerModuleFactoryManager);
+  return d->LazyLoading;
+}
+
+//-----------------------------------------------------------------------------
+QStringList qSlicerModuleFactoryManager::deferredModuleNames()const
+{
+  Q_D(const qSlicerModuleFactoryManager);
+  return d->DeferredModules;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerModuleFactoryManager::onDeferredLoadRequested(const QString& name)
+{
+  Q_D(qSlicerModuleFactoryManager);
+  if (!d->DeferredModules.removeOne(name))
+  {
+    return;
+  }
+  if (this->Superclass::isVerbose())
+  {
+    qDebug() << "Completing deferred loading of module" << name;
+  }
+  qSlicerAbstractCoreModule* instance = this->moduleInstance(name);
+  if (!instance || !d->initializeModule(name, instance))
+  {
+    qWarning() << Q_FUNC_INFO << "failed: module" << name << "could not be initialized";
+  }
+}
+
 //-----------------------------------------------------------------------------
 void qSlicerModuleFactoryManager::setAppLogic(vtkSlicerApplicationLogic* logic)
 {
@@ -91,6 +91,20 @@ public:
   /// Return all module paths that are direct child of \a basePath.
   QStringList modulePaths(const QString& basePath);
 
+  /// Enable/disable lazy loading of modules.
+  /// If enabled, creation of the logic and setup of a module loaded by
+  /// loadModule() are postponed until the module is first used
+  /// (see qSlicerAbstractCoreModule::isLoadDeferred()), unless other modules
+  /// depend on it or it has associated node types.
+  /// Disabled by default.
+  void setLazyLoading(bool lazy);
+  bool lazyLoading()const;
+
+  /// Return the list of loaded modules whose logic creation and setup
+  /// have been postponed until first use.
+  /// \sa setLazyLoading()
+  Q_INVOKABLE QStringList deferredModuleNames()const;
+
 public slots:
   /// Set the MRML scene to pass to modules at "load" time.
   void setMRMLScene(vtkMRMLScene* mrmlScene);
@@ -120,6 +134,10 @@ protected:
 
   /// Reimplemented to ensure order
   virtual void uninstantiateModules();
+
+protected slots:
+  void onDeferredLoadRequested(const QString& moduleName);
+
 private:
   Q_DECLARE_PRIVATE(qSlicerModuleFactoryManager);
   Q_DISABLE_COPY(qSlicerModuleFactoryManager);
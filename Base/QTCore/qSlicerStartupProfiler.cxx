@@ -0,0 +1,235 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+#include <QTextStream>
+
+// Slicer includes
+#include "qSlicerStartupProfiler.h"
+
+// STD includes
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+class qSlicerStartupProfilerPrivate
+{
+public:
+  bool Enabled{false};
+  QElapsedTimer Timer;
+  QList<qSlicerStartupProfiler::Event> Events;
+};
+
+//-----------------------------------------------------------------------------
+// qSlicerStartupProfiler methods
+
+//-----------------------------------------------------------------------------
+qSlicerStartupProfiler::qSlicerStartupProfiler()
+  : d_ptr(new qSlicerStartupProfilerPrivate)
+{
+}
+
+//-----------------------------------------------------------------------------
+qSlicerStartupProfiler::~qSlicerStartupProfiler() = default;
+
+//-----------------------------------------------------------------------------
+void qSlicerStartupProfiler::setEnabled(bool enabled)
+{
+  Q_D(qSlicerStartupProfiler);
+  d->Enabled = enabled;
+  if (enabled)
+  {
+    d->Events.clear();
+    d->Timer.start();
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerStartupProfiler::isEnabled()const
+{
+  Q_D(const qSlicerStartupProfiler);
+  return d->Enabled;
+}
+
+//-----------------------------------------------------------------------------
+qint64 qSlicerStartupProfiler::elapsedTime()const
+{
+  Q_D(const qSlicerStartupProfiler);
+  if (!d->Enabled)
+  {
+    return 0;
+  }
+  return d->Timer.nsecsElapsed() / 1000;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerStartupProfiler::addEvent(const QString& name, const QString& category, qint64 startTime, qint64 duration)
+{
+  Q_D(qSlicerStartupProfiler);
+  if (!d->Enabled)
+  {
+    return;
+  }
+  Event event;
+  event.Name = name;
+  event.Category = category;
+  event.StartTime = startTime;
+  event.Duration = duration;
+  d->Events << event;
+}
+
+//-----------------------------------------------------------------------------
+QList<qSlicerStartupProfiler::Event> qSlicerStartupProfiler::events()const
+{
+  Q_D(const qSlicerStartupProfiler);
+  return d->Events;
+}
+
+//-----------------------------------------------------------------------------
+qint64 qSlicerStartupProfiler::totalDuration(const QString& name, const QString& category)const
+{
+  Q_D(const qSlicerStartupProfiler);
+  qint64 duration = 0;
+  foreach(const Event& event, d->Events)
+  {
+    if (event.Name == name && (category.isEmpty() || event.Category == category))
+    {
+      duration += event.Duration;
+    }
+  }
+  return duration;
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerStartupProfiler::summary(int maximumNumberOfNames)const
+{
+  Q_D(const qSlicerStartupProfiler);
+
+  // Sum durations per name and category
+  QStringList categories;
+  QStringList names;
+  QHash<QString, QHash<QString, qint64> > durations;
+  QHash<QString, qint64> totalDurations;
+  foreach(const Event& event, d->Events)
+  {
+    if (!categories.contains(event.Category))
+    {
+      categories << event.Category;
+    }
+    if (!totalDurations.contains(event.Name))
+    {
+      names << event.Name;
+    }
+    durations[event.Name][event.Category] += event.Duration;
+    totalDurations[event.Name] += event.Duration;
+  }
+  std::stable_sort(names.begin(), names.end(), [&totalDurations](const QString& a, const QString& b)
+    {
+    return totalDurations[a] > totalDurations[b];
+    });
+
+  QString text;
+  QTextStream stream(&text);
+  stream << QString("%1").arg("Name", -40);
+  foreach(const QString& category, categories)
+  {
+    stream << QString("%1").arg(category, 24);
+  }
+  stream << QString("%1").arg("Total [ms]", 12) << "\n";
+  for (int nameIndex = 0; nameIndex < names.size() && nameIndex < maximumNumberOfNames; ++nameIndex)
+  {
+    const QString& name = names[nameIndex];
+    stream << QString("%1").arg(name, -40);
+    foreach(const QString& category, categories)
+    {
+      stream << QString("%1").arg(durations[name].value(category) / 1000.0, 24, 'f', 1);
+    }
+    stream << QString("%1").arg(totalDurations[name] / 1000.0, 12, 'f', 1) << "\n";
+  }
+  return text;
+}
+
+//-----------------------------------------------------------------------------
+QByteArray qSlicerStartupProfiler::chromeTrace()const
+{
+  Q_D(const qSlicerStartupProfiler);
+  QJsonArray traceEvents;
+  foreach(const Event& event, d->Events)
+  {
+    QJsonObject traceEvent;
+    traceEvent["name"] = QString("%1 (%2)").arg(event.Name).arg(event.Category);
+    traceEvent["cat"] = event.Category;
+    // complete event: start time and duration
+    traceEvent["ph"] = "X";
+    traceEvent["ts"] = static_cast<double>(event.StartTime);
+    traceEvent["dur"] = static_cast<double>(event.Duration);
+    traceEvent["pid"] = 1;
+    traceEvent["tid"] = 1;
+    QJsonObject args;
+    args["name"] = event.Name;
+    traceEvent["args"] = args;
+    traceEvents.append(traceEvent);
+  }
+  QJsonObject trace;
+  trace["traceEvents"] = traceEvents;
+  trace["displayTimeUnit"] = "ms";
+  return QJsonDocument(trace).toJson(QJsonDocument::Compact);
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerStartupProfiler::writeChromeTrace(const QString& fileName)const
+{
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    qWarning() << Q_FUNC_INFO << "failed: cannot open file for writing:" << fileName;
+    return false;
+  }
+  file.write(this->chromeTrace());
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+// qSlicerStartupProfiler::ScopedEvent methods
+
+//-----------------------------------------------------------------------------
+qSlicerStartupProfiler::ScopedEvent::ScopedEvent(qSlicerStartupProfiler* profiler,
+  const QString& name, const QString& category)
+  : Profiler(profiler && profiler->isEnabled() ? profiler : nullptr)
+  , Name(name)
+  , Category(category)
+  , StartTime(this->Profiler ? this->Profiler->elapsedTime() : 0)
+{
+}
+
+//-----------------------------------------------------------------------------
+qSlicerStartupProfiler::ScopedEvent::~ScopedEvent()
+{
+  if (!this->Profiler)
+  {
+    return;
+  }
+  this->Profiler->addEvent(this->Name, this->Category, this->StartTime,
+    this->Profiler->elapsedTime() - this->StartTime);
+}
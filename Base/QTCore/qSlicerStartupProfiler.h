@@ -0,0 +1,105 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __qSlicerStartupProfiler_h
+#define __qSlicerStartupProfiler_h
+
+// Qt includes
+#include <QList>
+#include <QScopedPointer>
+#include <QString>
+
+#include "qSlicerBaseQTCoreExport.h"
+
+class qSlicerStartupProfilerPrivate;
+
+/// \brief Record time spent in each step of loading modules.
+///
+/// Events are time intervals associated with a name (typically a module name)
+/// and a category (e.g., "Instantiation", "Setup"). Recording is disabled by default,
+/// and then adding events has no effect.
+///
+/// Recorded events can be exported in Chrome trace event format, which can be
+/// displayed in chrome://tracing or https://ui.perfetto.dev.
+///
+/// \sa qSlicerAbstractModuleFactoryManager::startupProfiler()
+class Q_SLICER_BASE_QTCORE_EXPORT qSlicerStartupProfiler
+{
+public:
+  qSlicerStartupProfiler();
+  virtual ~qSlicerStartupProfiler();
+
+  struct Event
+  {
+    QString Name;
+    QString Category;
+    /// Start time in microseconds, relative to the time when recording was enabled
+    qint64 StartTime;
+    /// Duration in microseconds
+    qint64 Duration;
+  };
+
+  /// Enable/disable recording of events.
+  /// Enabling recording clears previously recorded events and restarts the clock.
+  void setEnabled(bool enabled);
+  bool isEnabled()const;
+
+  /// Time elapsed since recording was enabled, in microseconds.
+  /// Returns 0 if recording is disabled.
+  qint64 elapsedTime()const;
+
+  /// Add an event. No-op if recording is disabled.
+  void addEvent(const QString& name, const QString& category, qint64 startTime, qint64 duration);
+
+  /// Return all recorded events, in the order they were added.
+  QList<Event> events()const;
+
+  /// Return sum of duration of all events of the given name and category, in microseconds.
+  /// If \a category is empty then all events of the given name are summed.
+  qint64 totalDuration(const QString& name, const QString& category = QString())const;
+
+  /// Return a human-readable table of the names that took the most time to process.
+  QString summary(int maximumNumberOfNames = 20)const;
+
+  /// Return recorded events in Chrome trace event (JSON) format.
+  QByteArray chromeTrace()const;
+
+  /// Write recorded events in Chrome trace event (JSON) format.
+  bool writeChromeTrace(const QString& fileName)const;
+
+  /// Record an event from construction until destruction of the object.
+  class Q_SLICER_BASE_QTCORE_EXPORT ScopedEvent
+  {
+  public:
+    ScopedEvent(qSlicerStartupProfiler* profiler, const QString& name, const QString& category);
+    ~ScopedEvent();
+  private:
+    qSlicerStartupProfiler* Profiler;
+    QString Name;
+    QString Category;
+    qint64 StartTime;
+  };
+
+protected:
+  QScopedPointer<qSlicerStartupProfilerPrivate> d_ptr;
+
+private:
+  Q_DECLARE_PRIVATE(qSlicerStartupProfiler);
+  Q_DISABLE_COPY(qSlicerStartupProfiler);
+};
+
+#endif
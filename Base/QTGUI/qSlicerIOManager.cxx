@@ -471,25 +471,16 @@ bool qSlicerIOManager::loadNodes(const QList<qSlicerIO::IOProperties>& files,
   // (it can make a big difference if hundreds of nodes are loaded)
   SlicerRenderBlocker renderBlocker;
   bool needStop = d->startProgressDialog(files.count());
-  bool success = true;
-  foreach(qSlicerIO::IOProperties fileProperties, files)
-  {
-    int numberOfUserMessagesBefore = userMessages ? userMessages->GetNumberOfMessages() : 0;
-    success = this->loadNodes(
-      static_cast<qSlicerIO::IOFileType>(fileProperties["fileType"].toString()),
-      fileProperties,
-      loadedNodes, userMessages) && success;
-    if (userMessages && userMessages->GetNumberOfMessages() > numberOfUserMessagesBefore)
-    {
-      userMessages->AddSeparator();
-    }
-
-    this->updateProgressDialog();
-    if (d->ProgressDialog->wasCanceled())
-    {
-      success = false;
-      break;
-    }
+  // Files are read in worker threads by the core IO manager, progress is
+  // reported after each file.
+  QObject::connect(this, SIGNAL(loadProgress(int,int)),
+                   this, SLOT(onLoadProgress(int,int)));
+  bool success = this->qSlicerCoreIOManager::loadNodes(files, loadedNodes, userMessages);
+  QObject::disconnect(this, SIGNAL(loadProgress(int,int)),
+                      this, SLOT(onLoadProgress(int,int)));
+  if (this->isLoadingCanceled())
+  {
+    success = false;
   }
 
   if (needStop)
@@ -514,6 +505,19 @@ void qSlicerIOManager::updateProgressDialog()
   //qApp->processEvents();
 }
 
+//-----------------------------------------------------------------------------
+void qSlicerIOManager::onLoadProgress(int numberOfProcessedFiles, int numberOfFiles)
+{
+  Q_D(qSlicerIOManager);
+  Q_UNUSED(numberOfProcessedFiles);
+  Q_UNUSED(numberOfFiles);
+  this->updateProgressDialog();
+  if (d->ProgressDialog && d->ProgressDialog->wasCanceled())
+  {
+    this->cancelLoading();
+  }
+}
+
 //-----------------------------------------------------------------------------
 void qSlicerIOManager::openScreenshotDialog()
 {
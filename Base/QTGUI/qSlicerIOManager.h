@@ -117,6 +117,7 @@ public slots:
 
 protected slots:
   void updateProgressDialog();
+  void onLoadProgress(int numberOfProcessedFiles, int numberOfFiles);
   void execDelayedFileDialog();
 
 protected:
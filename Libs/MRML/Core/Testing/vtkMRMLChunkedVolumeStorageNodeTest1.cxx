@@ -0,0 +1,256 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLChunkedVolumeStorageNode.h"
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLLabelMapVolumeNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLVolumeChunkCache.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+// VTKSYS includes
+#include <vtksys/SystemTools.hxx>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+double GetExpectedValue(int i, int j, int k)
+{
+  return i + 3 * j + 7 * k;
+}
+
+//---------------------------------------------------------------------------
+void CreateImage(vtkImageData* imageData)
+{
+  imageData->SetDimensions(70, 50, 9);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  for (int k = 0; k < 9; ++k)
+  {
+    for (int j = 0; j < 50; ++j)
+    {
+      for (int i = 0; i < 70; ++i)
+      {
+        imageData->SetScalarComponentFromDouble(i, j, k, 0, GetExpectedValue(i, j, k));
+      }
+    }
+  }
+}
+
+//---------------------------------------------------------------------------
+int CheckRegion(vtkMRMLChunkedVolumeStorageNode* storageNode, const int extent[6])
+{
+  vtkNew<vtkImageData> region;
+  CHECK_BOOL(storageNode->ReadRegion(0, extent, region), true);
+  int* regionExtent = region->GetExtent();
+  for (int i = 0; i < 6; ++i)
+  {
+    CHECK_INT(regionExtent[i], extent[i]);
+  }
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      for (int i = extent[0]; i <= extent[1]; ++i)
+      {
+        CHECK_DOUBLE(region->GetScalarComponentAsDouble(i, j, k, 0), GetExpectedValue(i, j, k));
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkMRMLChunkedVolumeStorageNodeTest1(int argc, char* argv[])
+{
+  vtkNew<vtkMRMLChunkedVolumeStorageNode> node1;
+  EXERCISE_ALL_BASIC_MRML_METHODS(node1.GetPointer());
+
+  if (argc != 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::string tempDir = std::string(argv[1]) + "/vtkMRMLChunkedVolumeStorageNodeTest1";
+  vtksys::SystemTools::RemoveADirectory(tempDir);
+  CHECK_BOOL(vtksys::SystemTools::MakeDirectory(tempDir).IsSuccess(), true);
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkImageData> imageData;
+  CreateImage(imageData);
+  vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLScalarVolumeNode", "Volume"));
+  volumeNode->SetAndObserveImageData(imageData);
+  volumeNode->SetOrigin(10.0, 20.0, 30.0);
+  volumeNode->SetSpacing(1.0, 2.0, 3.0);
+
+  // Write resolution pyramid
+  std::string fileName = tempDir + "/Volume.zarr";
+  vtkMRMLChunkedVolumeStorageNode* storageNode = vtkMRMLChunkedVolumeStorageNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLChunkedVolumeStorageNode"));
+  storageNode->SetChunkSize(16, 16, 4);
+  storageNode->SetFileName(fileName.c_str());
+  CHECK_INT(storageNode->WriteData(volumeNode), 1);
+  CHECK_BOOL(vtksys::SystemTools::FileExists(fileName + "/.zattrs"), true);
+  CHECK_BOOL(vtksys::SystemTools::FileExists(fileName + "/0/.zarray"), true);
+  // levels are added until a level fits into a single chunk: 70x50x9, 35x25x5, 18x13x3, 9x7x2
+  CHECK_INT(storageNode->GetNumberOfResolutionLevels(), 4);
+  int dimensions[3] = { 0, 0, 0 };
+  CHECK_BOOL(storageNode->GetResolutionLevelDimensions(3, dimensions), true);
+  CHECK_INT(dimensions[0], 9);
+  CHECK_INT(dimensions[1], 7);
+  CHECK_INT(dimensions[2], 2);
+  // written image data is the full-resolution level
+  CHECK_INT(storageNode->GetPreviewResolutionLevel(), 0);
+  CHECK_BOOL(storageNode->IsPreviewImageData(imageData), true);
+
+  // Read low-resolution preview
+  vtkMRMLScalarVolumeNode* readVolumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLScalarVolumeNode", "ReadVolume"));
+  vtkMRMLChunkedVolumeStorageNode* readStorageNode = vtkMRMLChunkedVolumeStorageNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLChunkedVolumeStorageNode"));
+  readStorageNode->SetFileName(fileName.c_str());
+  readStorageNode->SetMaximumNumberOfPreviewVoxels(1000);
+  CHECK_INT(readStorageNode->ReadData(readVolumeNode), 1);
+  CHECK_INT(readStorageNode->GetNumberOfResolutionLevels(), 4);
+  CHECK_INT(readStorageNode->GetPreviewResolutionLevel(), 2);
+  vtkImageData* previewImageData = readVolumeNode->GetImageData();
+  CHECK_NOT_NULL(previewImageData);
+  CHECK_INT(previewImageData->GetDimensions()[0], 18);
+  CHECK_INT(previewImageData->GetDimensions()[1], 13);
+  CHECK_INT(previewImageData->GetDimensions()[2], 3);
+  CHECK_BOOL(readStorageNode->IsPreviewImageData(previewImageData), true);
+  // each preview voxel is the mean of 4x4x4 voxels, its center is 1.5 voxels from the first voxel
+  double* previewSpacing = readVolumeNode->GetSpacing();
+  CHECK_DOUBLE_TOLERANCE(previewSpacing[0], 4.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(previewSpacing[1], 8.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(previewSpacing[2], 12.0, 1e-6);
+  double* previewOrigin = readVolumeNode->GetOrigin();
+  CHECK_DOUBLE_TOLERANCE(previewOrigin[0], 11.5, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(previewOrigin[1], 23.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(previewOrigin[2], 34.5, 1e-6);
+  vtkNew<vtkMatrix4x4> previewIJKToLevelIJK;
+  CHECK_BOOL(readStorageNode->GetPreviewIJKToLevelIJKMatrix(0, previewIJKToLevelIJK), true);
+  CHECK_DOUBLE_TOLERANCE(previewIJKToLevelIJK->GetElement(0, 0), 4.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(previewIJKToLevelIJK->GetElement(0, 3), 1.5, 1e-6);
+
+  // Read full-resolution regions through the chunk cache
+  vtkMRMLVolumeChunkCache* cache = readStorageNode->GetChunkCache();
+  CHECK_NOT_NULL(cache);
+  const int extent[6] = { 10, 40, 5, 30, 2, 7 };
+  CHECK_EXIT_SUCCESS(CheckRegion(readStorageNode, extent));
+  CHECK_INT(static_cast<int>(cache->GetNumberOfHits()), 0);
+  int numberOfMisses = static_cast<int>(cache->GetNumberOfMisses());
+  CHECK_INT(numberOfMisses, 3 * 2 * 2);
+  CHECK_EXIT_SUCCESS(CheckRegion(readStorageNode, extent));
+  CHECK_INT(static_cast<int>(cache->GetNumberOfHits()), numberOfMisses);
+  CHECK_INT(static_cast<int>(cache->GetNumberOfMisses()), numberOfMisses);
+  const int wholeExtent[6] = { 0, 69, 0, 49, 0, 8 };
+  CHECK_EXIT_SUCCESS(CheckRegion(readStorageNode, wholeExtent));
+
+  // Cache size is bounded
+  const vtkTypeInt64 chunkSize = 16 * 16 * 4 * sizeof(short);
+  cache->SetMaximumSize(2 * chunkSize);
+  CHECK_INT(static_cast<int>(cache->GetNumberOfChunks()), 2);
+  CHECK_EXIT_SUCCESS(CheckRegion(readStorageNode, wholeExtent));
+  CHECK_BOOL(cache->GetSize() <= 2 * chunkSize, true);
+
+  // Lower resolution levels are averaged
+  vtkNew<vtkImageData> level1Region;
+  const int level1Extent[6] = { 0, 1, 0, 1, 0, 1 };
+  CHECK_BOOL(readStorageNode->ReadRegion(1, level1Extent, level1Region), true);
+  CHECK_DOUBLE(level1Region->GetScalarComponentAsDouble(0, 0, 0, 0), 6.0); // mean is 5.5
+  CHECK_DOUBLE(level1Region->GetScalarComponentAsDouble(1, 1, 1, 0), 28.0); // mean is 27.5
+
+  // Modified preview is not a preview anymore
+  previewImageData->SetScalarComponentFromDouble(0, 0, 0, 0, 100.0);
+  previewImageData->GetPointData()->GetScalars()->Modified();
+  CHECK_BOOL(readStorageNode->IsPreviewImageData(previewImageData), false);
+
+  // Modified preview cannot overwrite the full-resolution volume
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  CHECK_INT(readStorageNode->WriteData(readVolumeNode), 0);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+  vtkNew<vtkMRMLChunkedVolumeStorageNode> checkStorageNode;
+  checkStorageNode->SetFileName(fileName.c_str());
+  CHECK_INT(checkStorageNode->ReadData(readVolumeNode), 1);
+  CHECK_INT(checkStorageNode->GetNumberOfResolutionLevels(), 4);
+  CHECK_BOOL(checkStorageNode->GetResolutionLevelDimensions(0, dimensions), true);
+  CHECK_INT(dimensions[0], 70);
+  CHECK_INT(dimensions[1], 50);
+  CHECK_INT(dimensions[2], 9);
+  CHECK_EXIT_SUCCESS(CheckRegion(checkStorageNode, wholeExtent));
+
+  // Modified preview is saved to a new location with its own spacing
+  CHECK_INT(readStorageNode->ReadData(readVolumeNode), 1);
+  previewImageData = readVolumeNode->GetImageData();
+  previewImageData->SetScalarComponentFromDouble(0, 0, 0, 0, 100.0);
+  previewImageData->GetPointData()->GetScalars()->Modified();
+  std::string editedFileName = tempDir + "/Edited.zarr";
+  readStorageNode->SetFileName(editedFileName.c_str());
+  CHECK_INT(readStorageNode->WriteData(readVolumeNode), 1);
+  CHECK_INT(readStorageNode->ReadData(readVolumeNode), 1);
+  CHECK_BOOL(readStorageNode->GetResolutionLevelDimensions(0, dimensions), true);
+  CHECK_INT(dimensions[0], 18);
+  CHECK_INT(dimensions[1], 13);
+  CHECK_INT(dimensions[2], 3);
+  CHECK_DOUBLE_TOLERANCE(readVolumeNode->GetSpacing()[0], 4.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(readVolumeNode->GetSpacing()[2], 12.0, 1e-6);
+  CHECK_DOUBLE(readVolumeNode->GetImageData()->GetScalarComponentAsDouble(0, 0, 0, 0), 100.0);
+
+  // Labelmap voxels are not averaged
+  vtkMRMLLabelMapVolumeNode* labelNode = vtkMRMLLabelMapVolumeNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLLabelMapVolumeNode", "Label"));
+  labelNode->SetAndObserveImageData(imageData);
+  std::string labelFileName = tempDir + "/Label.zarr";
+  vtkMRMLChunkedVolumeStorageNode* labelStorageNode = vtkMRMLChunkedVolumeStorageNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLChunkedVolumeStorageNode"));
+  labelStorageNode->SetChunkSize(16, 16, 4);
+  labelStorageNode->SetNumberOfLevelsToWrite(2);
+  labelStorageNode->UseCompressionOff();
+  labelStorageNode->SetFileName(labelFileName.c_str());
+  CHECK_INT(labelStorageNode->WriteData(labelNode), 1);
+  CHECK_INT(labelStorageNode->GetNumberOfResolutionLevels(), 2);
+  vtkNew<vtkImageData> labelRegion;
+  CHECK_BOOL(labelStorageNode->ReadRegion(1, level1Extent, labelRegion), true);
+  CHECK_DOUBLE(labelRegion->GetScalarComponentAsDouble(0, 0, 0, 0), GetExpectedValue(0, 0, 0));
+  CHECK_DOUBLE(labelRegion->GetScalarComponentAsDouble(1, 1, 1, 0), GetExpectedValue(2, 2, 2));
+
+  // Unmodified preview is saved by copying the full-resolution data
+  vtkMRMLScalarVolumeNode* copiedVolumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLScalarVolumeNode", "CopiedVolume"));
+  vtkMRMLChunkedVolumeStorageNode* copiedStorageNode = vtkMRMLChunkedVolumeStorageNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLChunkedVolumeStorageNode"));
+  copiedStorageNode->SetFileName(fileName.c_str());
+  copiedStorageNode->SetMaximumNumberOfPreviewVoxels(1000);
+  CHECK_INT(copiedStorageNode->ReadData(copiedVolumeNode), 1);
+  std::string copiedFileName = tempDir + "/Copied.zarr";
+  copiedStorageNode->SetFileName(copiedFileName.c_str());
+  CHECK_INT(copiedStorageNode->WriteData(copiedVolumeNode), 1);
+  CHECK_INT(copiedStorageNode->ReadData(copiedVolumeNode), 1);
+  CHECK_INT(copiedStorageNode->GetNumberOfResolutionLevels(), 4);
+  CHECK_EXIT_SUCCESS(CheckRegion(copiedStorageNode, wholeExtent));
+
+  vtksys::SystemTools::RemoveADirectory(tempDir);
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,134 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLNRRDStorageNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+
+// VTKSYS includes
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <iostream>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+double GetVoxelValue(int i, int j, int k)
+{
+  return i * 11 + j * 13 + k * 17 - 100;
+}
+
+//---------------------------------------------------------------------------
+int TestOverwriteMappedFile(const std::string& tempDir, const std::string& fileExtension)
+{
+  std::cout << "TestOverwriteMappedFile: " << fileExtension << std::endl;
+  std::string fileName = tempDir + "/vtkMRMLNRRDStorageNodeMemoryMappingTest." + fileExtension;
+  vtksys::SystemTools::RemoveFile(fileName);
+
+  const int dimensions[3] = { 40, 30, 20 };
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(dimensions[0], dimensions[1], dimensions[2]);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  for (int k = 0; k < dimensions[2]; ++k)
+  {
+    for (int j = 0; j < dimensions[1]; ++j)
+    {
+      for (int i = 0; i < dimensions[0]; ++i)
+      {
+        imageData->SetScalarComponentFromDouble(i, j, k, 0, GetVoxelValue(i, j, k));
+      }
+    }
+  }
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLScalarVolumeNode"));
+  volumeNode->SetAndObserveImageData(imageData);
+  vtkMRMLNRRDStorageNode* storageNode = vtkMRMLNRRDStorageNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLNRRDStorageNode"));
+  storageNode->SetUseCompression(0);
+  storageNode->SetFileName(fileName.c_str());
+  CHECK_BOOL(storageNode->WriteData(volumeNode), true);
+
+  // Read with memory mapping, modify a voxel, and save to the same file
+  vtkMRMLScalarVolumeNode* mappedVolumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLScalarVolumeNode"));
+  storageNode->MemoryMappingOn();
+  CHECK_BOOL(storageNode->ReadData(mappedVolumeNode), true);
+  vtkImageData* mappedImageData = mappedVolumeNode->GetImageData();
+  CHECK_NOT_NULL(mappedImageData);
+  mappedImageData->SetScalarComponentFromDouble(1, 2, 3, 0, 1234);
+  mappedImageData->Modified();
+  CHECK_BOOL(storageNode->WriteData(mappedVolumeNode), true);
+
+  // Voxels of the node are unchanged after the file is overwritten
+  CHECK_DOUBLE_TOLERANCE(mappedImageData->GetScalarComponentAsDouble(1, 2, 3, 0), 1234, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(mappedImageData->GetScalarComponentAsDouble(5, 6, 7, 0), GetVoxelValue(5, 6, 7), 1e-6);
+
+  // Saved file contains all voxels, including the modified one
+  vtkNew<vtkMRMLNRRDStorageNode> readStorageNode;
+  readStorageNode->SetFileName(fileName.c_str());
+  vtkMRMLScalarVolumeNode* readVolumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLScalarVolumeNode"));
+  CHECK_BOOL(readStorageNode->ReadData(readVolumeNode), true);
+  vtkImageData* readImageData = readVolumeNode->GetImageData();
+  CHECK_NOT_NULL(readImageData);
+  for (int k = 0; k < dimensions[2]; ++k)
+  {
+    for (int j = 0; j < dimensions[1]; ++j)
+    {
+      for (int i = 0; i < dimensions[0]; ++i)
+      {
+        double expectedValue = (i == 1 && j == 2 && k == 3) ? 1234 : GetVoxelValue(i, j, k);
+        if (readImageData->GetScalarComponentAsDouble(i, j, k, 0) != expectedValue)
+        {
+          std::cerr << "Voxel value mismatch at (" << i << ", " << j << ", " << k << "): "
+            << readImageData->GetScalarComponentAsDouble(i, j, k, 0) << " != " << expectedValue << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  // Release the mapping so that temporary files can be removed
+  scene->Clear(1);
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//---------------------------------------------------------------------------
+int vtkMRMLNRRDStorageNodeMemoryMappingTest(int argc, char* argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::string tempDir = argv[1];
+  // Detached header: voxels are mapped from the data file next to the header
+  CHECK_EXIT_SUCCESS(TestOverwriteMappedFile(tempDir, "nhdr"));
+  // Attached header: voxels are mapped from the header file if the data offset is aligned
+  CHECK_EXIT_SUCCESS(TestOverwriteMappedFile(tempDir, "nrrd"));
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,172 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLModelDisplayNode.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLSceneEventRecorder.h"
+#include "vtkMRMLScriptedModuleNode.h"
+#include "vtkMRMLSelectionNode.h"
+
+// VTK includes
+#include <vtkCollection.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+int TestAddNodes()
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLModelNode> existingModelNode;
+  scene->AddNode(existingModelNode);
+
+  vtkNew<vtkMRMLSceneEventRecorder> callback;
+  scene->AddObserver(vtkCommand::AnyEvent, callback.GetPointer());
+
+  // Model node refers to a display node that is added after it
+  vtkNew<vtkMRMLModelNode> modelNode1;
+  vtkNew<vtkMRMLModelNode> modelNode2;
+  modelNode2->SetName("Model_1");
+  vtkNew<vtkMRMLModelDisplayNode> displayNode;
+  displayNode->SetID("vtkMRMLModelDisplayNodeAddNodesTest");
+  modelNode1->SetAndObserveDisplayNodeID(displayNode->GetID());
+  vtkNew<vtkMRMLSelectionNode> selectionNode1;
+  vtkNew<vtkMRMLSelectionNode> selectionNode2;
+
+  vtkNew<vtkCollection> nodesToAdd;
+  nodesToAdd->AddItem(modelNode2);
+  nodesToAdd->AddItem(modelNode1);
+  nodesToAdd->AddItem(displayNode);
+  nodesToAdd->AddItem(selectionNode1);
+  nodesToAdd->AddItem(selectionNode2);
+  vtkNew<vtkCollection> addedNodes;
+  scene->AddNodes(nodesToAdd, addedNodes);
+
+  // Second selection node is merged into the first one
+  CHECK_INT(addedNodes->GetNumberOfItems(), 4);
+  CHECK_INT(scene->GetNumberOfNodes(), 5);
+  CHECK_POINTER(scene->GetNodeByID("vtkMRMLModelDisplayNodeAddNodesTest"), displayNode.GetPointer());
+  CHECK_POINTER(modelNode1->GetDisplayNode(), displayNode.GetPointer());
+  CHECK_STRING(selectionNode1->GetID(), "vtkMRMLSelectionNodeSingleton");
+  CHECK_NULL(selectionNode2->GetScene());
+
+  // Names and IDs are unique
+  CHECK_STRING(existingModelNode->GetName(), "Model");
+  CHECK_STRING(modelNode1->GetName(), "Model_2");
+  CHECK_STRING(modelNode2->GetName(), "Model_1");
+  CHECK_STRING(existingModelNode->GetID(), "vtkMRMLModelNode1");
+  CHECK_STRING(modelNode2->GetID(), "vtkMRMLModelNode2");
+  CHECK_STRING(modelNode1->GetID(), "vtkMRMLModelNode3");
+
+  // Aggregated events are invoked once, per-node events are invoked for each added node
+  CHECK_INT(callback->CalledEvents[vtkMRMLScene::NodesAboutToBeAddedEvent], 1);
+  CHECK_INT(callback->CalledEvents[vtkMRMLScene::NodesAddedEvent], 1);
+  CHECK_INT(callback->CalledEvents[vtkMRMLScene::NodeAboutToBeAddedEvent], 4);
+  CHECK_INT(callback->CalledEvents[vtkMRMLScene::NodeAddedEvent], 4);
+  CHECK_INT(callback->CalledEvents[vtkMRMLScene::StartBatchProcessEvent], 1);
+  CHECK_INT(callback->CalledEvents[vtkMRMLScene::EndBatchProcessEvent], 1);
+  CHECK_INT(callback->CalledEvents[vtkCommand::ModifiedEvent], 1);
+  CHECK_BOOL(callback->LastEventMTime[vtkMRMLScene::NodesAddedEvent]
+    <= callback->LastEventMTime[vtkMRMLScene::EndBatchProcessEvent], true);
+
+  // Nodes that are already in the scene are not added again
+  callback->CalledEvents.clear();
+  vtkNew<vtkMRMLModelNode> modelNode3;
+  std::vector<vtkMRMLNode*> nodesToAddVector = { modelNode1, modelNode3, nullptr };
+  std::vector<vtkMRMLNode*> addedNodesVector;
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  scene->AddNodes(nodesToAddVector, &addedNodesVector);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+  CHECK_INT(static_cast<int>(addedNodesVector.size()), 1);
+  CHECK_POINTER(addedNodesVector[0], modelNode3.GetPointer());
+  CHECK_INT(scene->GetNumberOfNodes(), 6);
+  CHECK_INT(callback->CalledEvents[vtkMRMLScene::NodeAddedEvent], 1);
+
+  // Empty input does not invoke events
+  callback->CalledEvents.clear();
+  scene->AddNodes(std::vector<vtkMRMLNode*>());
+  CHECK_INT(static_cast<int>(callback->CalledEvents.size()), 0);
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int BenchmarkAddNodes()
+{
+  // Adding nodes one by one is quadratic in the number of nodes (each unique name is
+  // searched for in the whole scene), therefore fewer nodes are added that way.
+  const int numberOfNodes = 100000;
+  const int numberOfNodesAddedOneByOne = 10000;
+
+  std::vector<vtkSmartPointer<vtkMRMLNode>> nodes;
+  std::vector<vtkMRMLNode*> nodesToAdd;
+  for (int nodeIndex = 0; nodeIndex < numberOfNodes; ++nodeIndex)
+  {
+    vtkNew<vtkMRMLScriptedModuleNode> node;
+    nodes.push_back(node.GetPointer());
+    nodesToAdd.push_back(node);
+  }
+
+  vtkNew<vtkTimerLog> timer;
+  vtkNew<vtkMRMLScene> scene;
+  timer->StartTimer();
+  scene->AddNodes(nodesToAdd);
+  timer->StopTimer();
+  double addNodesTime = timer->GetElapsedTime();
+  CHECK_INT(scene->GetNumberOfNodes(), numberOfNodes);
+  CHECK_STRING(nodes[numberOfNodes - 1]->GetName(), "ScriptedModule_99999");
+  CHECK_STRING(nodes[numberOfNodes - 1]->GetID(), "vtkMRMLScriptedModuleNode100000");
+  CHECK_POINTER(scene->GetNodeByID("vtkMRMLScriptedModuleNode50000"), nodes[49999].GetPointer());
+
+  vtkNew<vtkMRMLScene> referenceScene;
+  timer->StartTimer();
+  for (int nodeIndex = 0; nodeIndex < numberOfNodesAddedOneByOne; ++nodeIndex)
+  {
+    vtkNew<vtkMRMLScriptedModuleNode> node;
+    referenceScene->AddNode(node);
+  }
+  timer->StopTimer();
+  double addNodeTime = timer->GetElapsedTime();
+  CHECK_INT(referenceScene->GetNumberOfNodes(), numberOfNodesAddedOneByOne);
+
+  std::cout << "AddNodes: " << numberOfNodes << " nodes in " << addNodesTime * 1000.0 << "ms ("
+    << addNodesTime * 1.0e6 / numberOfNodes << "us/node)" << std::endl;
+  std::cout << "AddNode: " << numberOfNodesAddedOneByOne << " nodes in " << addNodeTime * 1000.0 << "ms ("
+    << addNodeTime * 1.0e6 / numberOfNodesAddedOneByOne << "us/node)" << std::endl;
+
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//---------------------------------------------------------------------------
+int vtkMRMLSceneAddNodesTest(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  CHECK_EXIT_SUCCESS(TestAddNodes());
+  CHECK_EXIT_SUCCESS(BenchmarkAddNodes());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,206 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLScriptedModuleNode.h"
+
+// VTK includes
+#include <vtkCollection.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+// Create a hub node and a chain of nodes. Each node of the chain refers to the
+// hub ("hub" role for even, "other" role for odd nodes) and to the previous node
+// of the chain ("previous" role).
+void CreateReferencingNodes(vtkMRMLScene* scene, int numberOfNodes,
+  vtkMRMLNode*& hubNode, std::vector<vtkMRMLNode*>& chainNodes)
+{
+  vtkNew<vtkMRMLScriptedModuleNode> newHubNode;
+  newHubNode->SetName("Hub");
+  scene->AddNode(newHubNode);
+  hubNode = newHubNode;
+
+  std::vector<vtkSmartPointer<vtkMRMLNode>> nodes;
+  for (int nodeIndex = 0; nodeIndex < numberOfNodes; ++nodeIndex)
+  {
+    nodes.push_back(vtkSmartPointer<vtkMRMLScriptedModuleNode>::New());
+  }
+  chainNodes = std::vector<vtkMRMLNode*>(nodes.begin(), nodes.end());
+  scene->AddNodes(chainNodes);
+  for (int nodeIndex = 0; nodeIndex < numberOfNodes; ++nodeIndex)
+  {
+    chainNodes[nodeIndex]->SetNodeReferenceID(nodeIndex % 2 ? "other" : "hub", hubNode->GetID());
+    if (nodeIndex > 0)
+    {
+      chainNodes[nodeIndex]->SetNodeReferenceID("previous", chainNodes[nodeIndex - 1]->GetID());
+    }
+  }
+}
+
+//---------------------------------------------------------------------------
+int TestReferenceLookup()
+{
+  const int numberOfNodes = 20000;
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLNode* hubNode = nullptr;
+  std::vector<vtkMRMLNode*> chainNodes;
+  CreateReferencingNodes(scene, numberOfNodes, hubNode, chainNodes);
+  CHECK_INT(scene->GetNumberOfNodeReferences(), 2 * numberOfNodes - 1);
+
+  // Referencing nodes
+  std::vector<vtkMRMLNode*> referencingNodes;
+  scene->GetReferencingNodes(hubNode, referencingNodes);
+  CHECK_INT(static_cast<int>(referencingNodes.size()), numberOfNodes);
+  scene->GetReferencingNodes(hubNode, "hub", referencingNodes);
+  CHECK_INT(static_cast<int>(referencingNodes.size()), numberOfNodes / 2);
+  scene->GetReferencingNodes(hubNode, "other", referencingNodes);
+  CHECK_INT(static_cast<int>(referencingNodes.size()), numberOfNodes / 2);
+  scene->GetReferencingNodes(chainNodes[5], "previous", referencingNodes);
+  CHECK_INT(static_cast<int>(referencingNodes.size()), 1);
+  CHECK_POINTER(referencingNodes[0], chainNodes[6]);
+  scene->GetReferencingNodes(chainNodes[5], "hub", referencingNodes);
+  CHECK_INT(static_cast<int>(referencingNodes.size()), 0);
+
+  // Referenced nodes
+  vtkSmartPointer<vtkCollection> referencedNodes = vtkSmartPointer<vtkCollection>::Take(
+    scene->GetReferencedNodes(chainNodes[10], false));
+  CHECK_INT(referencedNodes->GetNumberOfItems(), 3);
+  CHECK_BOOL(referencedNodes->IsItemPresent(hubNode) != 0, true);
+  CHECK_BOOL(referencedNodes->IsItemPresent(chainNodes[9]) != 0, true);
+
+  // Removing a referenced node updates the referencing node
+  scene->RemoveNode(chainNodes[100]);
+  CHECK_NULL(chainNodes[101]->GetNodeReference("previous"));
+  CHECK_POINTER(chainNodes[101]->GetNodeReference("other"), hubNode);
+  CHECK_INT(scene->GetNumberOfNodeReferences(), 2 * numberOfNodes - 1 - 3);
+
+  // Removing many nodes only visits the references of the removed nodes
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+  for (int nodeIndex = numberOfNodes - 1; nodeIndex >= 0; --nodeIndex)
+  {
+    if (nodeIndex != 100)
+    {
+      scene->RemoveNode(chainNodes[nodeIndex]);
+    }
+  }
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+  timer->StopTimer();
+  std::cout << "Removing " << numberOfNodes - 1 << " referencing nodes: "
+    << timer->GetElapsedTime() * 1000.0 << "ms" << std::endl;
+  CHECK_INT(scene->GetNumberOfNodeReferences(), 0);
+  scene->GetReferencingNodes(hubNode, referencingNodes);
+  CHECK_INT(static_cast<int>(referencingNodes.size()), 0);
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestImportWithChangedIDs()
+{
+  const int numberOfNodes = 5000;
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLNode* hubNode = nullptr;
+  std::vector<vtkMRMLNode*> chainNodes;
+  CreateReferencingNodes(scene, numberOfNodes, hubNode, chainNodes);
+  scene->SetSaveToXMLString(1);
+  scene->Commit();
+  std::string sceneXMLString = scene->GetSceneXMLString();
+
+  // Importing the same scene twice changes all node IDs in the second import,
+  // which requires updating all the node references of the imported nodes.
+  vtkNew<vtkMRMLScene> importedScene;
+  importedScene->SetLoadFromXMLString(1);
+  importedScene->SetSceneXMLString(sceneXMLString);
+  importedScene->Import();
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  importedScene->SetSceneXMLString(sceneXMLString);
+  importedScene->Import();
+  timer->StopTimer();
+  std::cout << "Importing " << numberOfNodes << " referencing nodes with changed IDs: "
+    << timer->GetElapsedTime() * 1000.0 << "ms" << std::endl;
+
+  vtkSmartPointer<vtkCollection> hubNodes = vtkSmartPointer<vtkCollection>::Take(importedScene->GetNodesByName("Hub"));
+  CHECK_INT(hubNodes->GetNumberOfItems(), 2);
+  for (int hubIndex = 0; hubIndex < hubNodes->GetNumberOfItems(); ++hubIndex)
+  {
+    vtkMRMLNode* importedHubNode = vtkMRMLNode::SafeDownCast(hubNodes->GetItemAsObject(hubIndex));
+    std::vector<vtkMRMLNode*> referencingNodes;
+    importedScene->GetReferencingNodes(importedHubNode, "hub", referencingNodes);
+    CHECK_INT(static_cast<int>(referencingNodes.size()), numberOfNodes / 2);
+    for (vtkMRMLNode* referencingNode : referencingNodes)
+    {
+      CHECK_POINTER(referencingNode->GetNodeReference("hub"), importedHubNode);
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestNthReference()
+{
+  vtkNew<vtkMRMLScene> scene;
+  std::vector<vtkSmartPointer<vtkMRMLNode>> nodes;
+  for (int nodeIndex = 0; nodeIndex < 3; ++nodeIndex)
+  {
+    nodes.push_back(vtkSmartPointer<vtkMRMLScriptedModuleNode>::New());
+    scene->AddNode(nodes.back());
+  }
+  CHECK_STRING(nodes[0]->GetID(), "vtkMRMLScriptedModuleNode1");
+  CHECK_STRING(nodes[2]->GetID(), "vtkMRMLScriptedModuleNode3");
+  nodes[0]->SetNodeReferenceID("ref", nodes[2]->GetID());
+  nodes[2]->SetNodeReferenceID("ref", nodes[0]->GetID());
+  nodes[1]->SetNodeReferenceID("ref", nodes[0]->GetID());
+
+  // Pairs are ordered by referenced ID, then by referencing node ID
+  CHECK_INT(scene->GetNumberOfNodeReferences(), 3);
+  CHECK_STRING(scene->GetNthReferencedID(0), "vtkMRMLScriptedModuleNode1");
+  CHECK_POINTER(scene->GetNthReferencingNode(0), nodes[1].GetPointer());
+  CHECK_STRING(scene->GetNthReferencedID(1), "vtkMRMLScriptedModuleNode1");
+  CHECK_POINTER(scene->GetNthReferencingNode(1), nodes[2].GetPointer());
+  CHECK_STRING(scene->GetNthReferencedID(2), "vtkMRMLScriptedModuleNode3");
+  CHECK_POINTER(scene->GetNthReferencingNode(2), nodes[0].GetPointer());
+  CHECK_NULL(scene->GetNthReferencedID(3));
+  CHECK_NULL(scene->GetNthReferencingNode(3));
+
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//---------------------------------------------------------------------------
+int vtkMRMLSceneNodeReferencesTest(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  CHECK_EXIT_SUCCESS(TestReferenceLookup());
+  CHECK_EXIT_SUCCESS(TestImportWithChangedIDs());
+  CHECK_EXIT_SUCCESS(TestNthReference());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,244 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkArchive.h"
+#include "vtkCacheManager.h"
+#include "vtkDataIOManager.h"
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLMessageCollection.h"
+#include "vtkMRMLModelDisplayNode.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkSphereSource.h>
+
+// VTKSYS includes
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+std::string ReadFileContent(const std::string& fileName)
+{
+  std::ifstream file(fileName.c_str(), std::ios::binary);
+  std::stringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+//---------------------------------------------------------------------------
+void PopulateScene(vtkMRMLScene* scene)
+{
+  // Models with the same name, written concurrently, must get unique file names
+  for (int modelIndex = 0; modelIndex < 3; ++modelIndex)
+  {
+    vtkNew<vtkSphereSource> sphere;
+    sphere->SetThetaResolution(8 + modelIndex * 16);
+    sphere->SetPhiResolution(8 + modelIndex * 16);
+    sphere->Update();
+    vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLModelNode", "Model"));
+    modelNode->SetAndObservePolyData(sphere->GetOutput());
+    // Last model is hidden
+    modelNode->CreateDefaultDisplayNodes();
+    modelNode->GetDisplayNode()->SetVisibility(modelIndex < 2);
+  }
+
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(20, 30, 10);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(imageData->GetScalarPointer());
+  for (vtkIdType voxelIndex = 0; voxelIndex < imageData->GetNumberOfPoints(); ++voxelIndex)
+  {
+    voxels[voxelIndex] = static_cast<short>(voxelIndex % 313);
+  }
+  vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLScalarVolumeNode", "Volume"));
+  volumeNode->SetAndObserveImageData(imageData);
+}
+
+//---------------------------------------------------------------------------
+int GetNumberOfModelPoints(vtkMRMLScene* scene, const char* modelName)
+{
+  vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(scene->GetFirstNodeByName(modelName));
+  if (!modelNode || !modelNode->GetPolyData())
+  {
+    return 0;
+  }
+  return static_cast<int>(modelNode->GetPolyData()->GetNumberOfPoints());
+}
+
+} // namespace
+
+//---------------------------------------------------------------------------
+int vtkMRMLSceneWriteToMRBTest(int argc, char* argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::string tempDir = argv[1];
+
+  vtkNew<vtkMRMLScene> scene;
+  PopulateScene(scene);
+
+  // Write the same scene serially and using multiple threads
+  std::string serialDir = tempDir + "/vtkMRMLSceneWriteToMRBTestSerial";
+  std::string concurrentDir = tempDir + "/vtkMRMLSceneWriteToMRBTestConcurrent";
+  CHECK_BOOL(vtksys::SystemTools::MakeDirectory(serialDir).IsSuccess(), true);
+  CHECK_BOOL(vtksys::SystemTools::MakeDirectory(concurrentDir).IsSuccess(), true);
+  std::string serialFileName = serialDir + "/Scene.mrb";
+  std::string concurrentFileName = concurrentDir + "/Scene.mrb";
+  vtkNew<vtkMRMLMessageCollection> userMessages;
+
+  scene->SetMaximumNumberOfBundleWriteThreads(1);
+  CHECK_BOOL(scene->WriteToMRB(serialFileName.c_str(), nullptr, userMessages), true);
+  CHECK_INT(userMessages->GetNumberOfMessagesOfType(vtkCommand::ErrorEvent), 0);
+
+  scene->SetMaximumNumberOfBundleWriteThreads(4);
+  CHECK_BOOL(scene->WriteToMRB(concurrentFileName.c_str(), nullptr, userMessages), true);
+  CHECK_INT(userMessages->GetNumberOfMessagesOfType(vtkCommand::ErrorEvent), 0);
+
+  // Archives must be identical, byte by byte
+  std::string serialContent = ReadFileContent(serialFileName);
+  std::string concurrentContent = ReadFileContent(concurrentFileName);
+  CHECK_BOOL(serialContent.empty(), false);
+  CHECK_BOOL(serialContent == concurrentContent, true);
+
+  // Data files are added in node order, followed by the scene file
+  std::vector<std::string> files;
+  CHECK_BOOL(vtkArchive::ListArchive(concurrentFileName.c_str(), files), true);
+  CHECK_INT(static_cast<int>(files.size()), 6);
+  CHECK_BOOL(files[0].compare(0, 5, "Scene") == 0, true); // bundle directory
+  CHECK_STD_STRING(files[1], "Scene/Data/Model.vtk");
+  CHECK_STD_STRING(files[2], "Scene/Data/Model_1.vtk");
+  CHECK_STD_STRING(files[3], "Scene/Data/Model_2.vtk");
+  CHECK_STD_STRING(files[4], "Scene/Data/Volume.nrrd");
+  CHECK_STD_STRING(files[5], "Scene/Scene.mrml");
+
+  // Entries can be accessed directly, without extracting the bundle
+  vtkNew<vtkArchive> archive;
+  CHECK_BOOL(archive->OpenZipIndex(concurrentFileName.c_str()), true);
+  CHECK_INT(archive->GetNumberOfZipEntries(), 6);
+  CHECK_STD_STRING(archive->GetNthZipEntryName(4), "Scene/Data/Volume.nrrd");
+  CHECK_INT(archive->FindZipEntry("Scene/Data/Volume.nrrd"), 4);
+  CHECK_INT(archive->FindZipEntry("Scene/Data/Missing.nrrd"), -1);
+  std::string extractedFileName = concurrentDir + "/Extracted/Scene.mrml";
+  CHECK_BOOL(archive->ExtractNthZipEntry(5, extractedFileName.c_str()), true);
+  std::string extractedContent = ReadFileContent(extractedFileName);
+  CHECK_INT(static_cast<int>(extractedContent.size()), static_cast<int>(archive->GetNthZipEntrySize(5)));
+  CHECK_BOOL(extractedContent.find("<MRML") != std::string::npos, true);
+  vtkTypeInt64 mappedSize = 0;
+  const char* mappedContent = archive->MapNthZipEntry(5, mappedSize);
+  if (archive->IsNthZipEntryCompressed(5))
+  {
+    CHECK_NULL(mappedContent);
+  }
+  else
+  {
+    CHECK_NOT_NULL(mappedContent);
+    CHECK_BOOL(std::string(mappedContent, mappedSize) == extractedContent, true);
+  }
+  archive->CloseZipIndex();
+
+  // Read the bundle, data files are extracted one by one
+  vtkNew<vtkCacheManager> cacheManager;
+  cacheManager->SetRemoteCacheDirectory(concurrentDir.c_str());
+  vtkNew<vtkDataIOManager> dataIOManager;
+  dataIOManager->SetCacheManager(cacheManager);
+
+  vtkNew<vtkMRMLScene> readScene;
+  readScene->SetDataIOManager(dataIOManager);
+  CHECK_BOOL(readScene->ReadFromMRB(concurrentFileName.c_str(), true, userMessages), true);
+  CHECK_INT(GetNumberOfModelPoints(readScene, "Model"), GetNumberOfModelPoints(scene, "Model"));
+  CHECK_INT(GetNumberOfModelPoints(readScene, "Model_2"), GetNumberOfModelPoints(scene, "Model_2"));
+  CHECK_BOOL(readScene->HasDeferredBundleData(), false);
+  CHECK_NULL(readScene->GetBundleArchive());
+
+  // Read the bundle with lazy loading, the hidden model is only read when it is shown
+  vtkNew<vtkMRMLScene> lazyScene;
+  lazyScene->SetDataIOManager(dataIOManager);
+  lazyScene->LazyBundleDataLoadingOn();
+  CHECK_BOOL(lazyScene->ReadFromMRB(concurrentFileName.c_str(), true, userMessages), true);
+  CHECK_INT(GetNumberOfModelPoints(lazyScene, "Model_1"), GetNumberOfModelPoints(scene, "Model_1"));
+  CHECK_INT(GetNumberOfModelPoints(lazyScene, "Model_2"), 0);
+  vtkMRMLModelNode* hiddenModelNode = vtkMRMLModelNode::SafeDownCast(lazyScene->GetFirstNodeByName("Model_2"));
+  CHECK_BOOL(lazyScene->HasDeferredBundleData(hiddenModelNode), true);
+  CHECK_NOT_NULL(lazyScene->GetBundleArchive());
+  hiddenModelNode->GetDisplayNode()->SetVisibility(true);
+  CHECK_INT(GetNumberOfModelPoints(lazyScene, "Model_2"), GetNumberOfModelPoints(scene, "Model_2"));
+  CHECK_BOOL(lazyScene->HasDeferredBundleData(), false);
+  CHECK_NULL(lazyScene->GetBundleArchive());
+  CHECK_INT(userMessages->GetNumberOfMessagesOfType(vtkCommand::ErrorEvent), 0);
+
+  // Bundle with entries stored without compression, data files are read from memory mapped entries
+  std::string unzippedDir = concurrentDir + "/Unzipped";
+  CHECK_BOOL(vtksys::SystemTools::MakeDirectory(unzippedDir).IsSuccess(), true);
+  CHECK_BOOL(vtkArchive::UnZip(concurrentFileName.c_str(), unzippedDir.c_str()), true);
+  std::string storedDir = tempDir + "/vtkMRMLSceneWriteToMRBTestStored";
+  CHECK_BOOL(vtksys::SystemTools::MakeDirectory(storedDir).IsSuccess(), true);
+  std::string storedFileName = storedDir + "/Scene.mrb";
+  vtkNew<vtkArchive> storedArchive;
+  storedArchive->ZipCompressionOff();
+  CHECK_BOOL(storedArchive->BeginZip(storedFileName.c_str()), true);
+  CHECK_BOOL(storedArchive->AddDirectoryToZip(files[0].c_str()), true);
+  CHECK_BOOL(storedArchive->AddDirectoryContentToZip((unzippedDir + "/Scene").c_str(), unzippedDir.c_str()), true);
+  CHECK_BOOL(storedArchive->EndZip(), true);
+
+  CHECK_BOOL(archive->OpenZipIndex(storedFileName.c_str()), true);
+  int storedVolumeIndex = archive->FindZipEntry("Scene/Data/Volume.nrrd");
+  CHECK_BOOL(storedVolumeIndex >= 0, true);
+  CHECK_BOOL(archive->IsNthZipEntryCompressed(storedVolumeIndex), false);
+  std::string volumeContent = ReadFileContent(unzippedDir + "/Scene/Data/Volume.nrrd");
+  CHECK_BOOL(volumeContent.empty(), false);
+  const char* mappedVolumeContent = archive->MapNthZipEntry(storedVolumeIndex, mappedSize);
+  CHECK_NOT_NULL(mappedVolumeContent);
+  CHECK_INT(static_cast<int>(mappedSize), static_cast<int>(volumeContent.size()));
+  CHECK_BOOL(std::string(mappedVolumeContent, mappedSize) == volumeContent, true);
+  // extraction of a stored entry writes the mapped content
+  std::string extractedVolumeFileName = storedDir + "/Extracted/Volume.nrrd";
+  CHECK_BOOL(archive->ExtractNthZipEntry(storedVolumeIndex, extractedVolumeFileName.c_str()), true);
+  CHECK_BOOL(ReadFileContent(extractedVolumeFileName) == volumeContent, true);
+  int storedModelIndex = archive->FindZipEntry("Scene/Data/Model_1.vtk");
+  CHECK_BOOL(storedModelIndex >= 0, true);
+  std::string extractedModelFileName = storedDir + "/Extracted/Model_1.vtk";
+  CHECK_BOOL(archive->ExtractNthZipEntry(storedModelIndex, extractedModelFileName.c_str()), true);
+  CHECK_BOOL(ReadFileContent(extractedModelFileName) == ReadFileContent(unzippedDir + "/Scene/Data/Model_1.vtk"), true);
+  archive->CloseZipIndex();
+
+  vtkNew<vtkMRMLScene> storedScene;
+  storedScene->SetDataIOManager(dataIOManager);
+  CHECK_BOOL(storedScene->ReadFromMRB(storedFileName.c_str(), true, userMessages), true);
+  CHECK_INT(GetNumberOfModelPoints(storedScene, "Model"), GetNumberOfModelPoints(scene, "Model"));
+  CHECK_INT(GetNumberOfModelPoints(storedScene, "Model_2"), GetNumberOfModelPoints(scene, "Model_2"));
+  vtkMRMLScalarVolumeNode* storedVolumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(storedScene->GetFirstNodeByName("Volume"));
+  CHECK_NOT_NULL(storedVolumeNode);
+  CHECK_NOT_NULL(storedVolumeNode->GetImageData());
+  CHECK_INT(userMessages->GetNumberOfMessagesOfType(vtkCommand::ErrorEvent), 0);
+
+  vtksys::SystemTools::RemoveADirectory(storedDir);
+  vtksys::SystemTools::RemoveADirectory(serialDir);
+  vtksys::SystemTools::RemoveADirectory(concurrentDir);
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
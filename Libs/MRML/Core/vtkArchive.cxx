@@ -10,6 +10,8 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 
 #include "vtkArchive.h"
 #include "vtkLoggingMacros.h"
+#include "vtksys/Encoding.hxx"
+#include "vtksys/FStream.hxx"
 #include "vtksys/Glob.hxx"
 #include "vtksys/SystemTools.hxx"
 
@@ -18,10 +20,26 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include <archive_entry.h>
 
 // STD includes
+#include <algorithm>
 #include <cstring>
 #include <iostream>
+#include <map>
+#include <set>
+
+// Memory mapping
+#if defined(_WIN32) && !defined(__CYGWIN__)
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <unistd.h>
+#endif
 
 // VTK include
+#include <vtkNew.h>
 #include <vtkObjectFactory.h>
 
 vtkStandardNewMacro(vtkArchive);
@@ -219,13 +237,165 @@ long copy_data(struct archive *ar, struct archive *aw)
   return r;
 }
 
+// --------------------------------------------------------------------------
+// Read an unsigned little-endian integer (as stored in zip file headers)
+vtkTypeUInt64 ReadLittleEndian(const unsigned char* data, int numberOfBytes)
+{
+  vtkTypeUInt64 value = 0;
+  for (int byteIndex = numberOfBytes - 1; byteIndex >= 0; --byteIndex)
+  {
+    value = (value << 8) | data[byteIndex];
+  }
+  return value;
+}
+
+// --------------------------------------------------------------------------
+// Read numberOfBytes from the file starting at offset
+bool ReadFileBlock(vtksys::ifstream& file, vtkTypeInt64 offset, vtkTypeInt64 numberOfBytes, std::vector<unsigned char>& buffer)
+{
+  buffer.resize(static_cast<size_t>(numberOfBytes));
+  file.clear();
+  file.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+  if (!file.good())
+  {
+    return false;
+  }
+  if (numberOfBytes == 0)
+  {
+    return true;
+  }
+  file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(numberOfBytes));
+  return file.gcount() == static_cast<std::streamsize>(numberOfBytes);
+}
+
+// --------------------------------------------------------------------------
+// Provides data of a zip file, starting at the local header of an entry, to libarchive
+struct ZipEntryStream
+{
+  vtksys::ifstream File;
+  char Buffer[65536];
+};
+
+// --------------------------------------------------------------------------
+la_ssize_t ReadZipEntryStream(struct archive* vtkNotUsed(a), void* clientData, const void** buffer)
+{
+  ZipEntryStream* stream = reinterpret_cast<ZipEntryStream*>(clientData);
+  stream->File.read(stream->Buffer, sizeof(stream->Buffer));
+  *buffer = stream->Buffer;
+  return static_cast<la_ssize_t>(stream->File.gcount());
+}
+
 } // end of anonymous namespace
 
 //----------------------------------------------------------------------------
-vtkArchive::vtkArchive() = default;
+class vtkArchive::vtkInternal
+{
+public:
+  struct ZipIndexEntry
+  {
+    std::string Name;
+    unsigned int CompressionMethod{ 0 };
+    vtkTypeInt64 CompressedSize{ 0 };
+    vtkTypeInt64 UncompressedSize{ 0 };
+    vtkTypeInt64 LocalHeaderOffset{ 0 };
+  };
+
+  struct MappedRegion
+  {
+    void* Address{ nullptr };
+    size_t Length{ 0 };
+    const char* EntryData{ nullptr };
+  };
+
+  /// Get position of the content of an entry in the zip file
+  vtkTypeInt64 GetEntryDataOffset(const ZipIndexEntry& entry)
+  {
+    vtksys::ifstream file(this->IndexFileName.c_str(), std::ios::in | std::ios::binary);
+    std::vector<unsigned char> localHeader;
+    if (!file.is_open() || !ReadFileBlock(file, entry.LocalHeaderOffset, 30, localHeader)
+      || ReadLittleEndian(&localHeader[0], 4) != 0x04034b50)
+    {
+      return -1;
+    }
+    return entry.LocalHeaderOffset + 30 + ReadLittleEndian(&localHeader[26], 2) + ReadLittleEndian(&localHeader[28], 2);
+  }
+
+  static void UnmapRegion(MappedRegion& region)
+  {
+    if (!region.Address)
+    {
+      return;
+    }
+#if defined(_WIN32) && !defined(__CYGWIN__)
+    UnmapViewOfFile(region.Address);
+#else
+    munmap(region.Address, region.Length);
+#endif
+    region.Address = nullptr;
+  }
+
+  void UnmapRegion(int entryIndex)
+  {
+    std::map<int, MappedRegion>::iterator mappedIt = this->MappedRegions.find(entryIndex);
+    if (mappedIt == this->MappedRegions.end())
+    {
+      return;
+    }
+    UnmapRegion(mappedIt->second);
+    this->MappedRegions.erase(mappedIt);
+  }
+
+  void UnmapRegions()
+  {
+    for (auto& region : this->MappedRegions)
+    {
+      UnmapRegion(region.second);
+    }
+    this->MappedRegions.clear();
+  }
+
+  /// Set time stamp and owner of the entry to constant values
+  /// so that the archive content only depends on the added files.
+  void SetFixedEntryProperties(struct archive_entry* entry)
+  {
+    archive_entry_set_mtime(entry, 11, 110);
+    archive_entry_set_uid(entry, 0);
+    archive_entry_set_gid(entry, 0);
+  }
+
+  /// Archive that is being written (between BeginZip and EndZip)
+  struct archive* ZipArchive{ nullptr };
+  /// Names of entries that have been added to ZipArchive
+  std::set<std::string> ZipEntries;
+  /// Set to false if writing of any entry failed
+  bool ZipSuccess{ true };
+
+  /// Zip file opened by OpenZipIndex
+  std::string IndexFileName;
+  /// Entries of the zip file opened by OpenZipIndex, in the order of the central directory
+  std::vector<ZipIndexEntry> IndexEntries;
+  /// Map from entry name to index in IndexEntries
+  std::map<std::string, int> IndexEntryNames;
+  /// Entries mapped into memory, indexed by entry index
+  std::map<int, MappedRegion> MappedRegions;
+};
+
+//----------------------------------------------------------------------------
+vtkArchive::vtkArchive()
+{
+  this->Internal = new vtkInternal;
+}
 
 //----------------------------------------------------------------------------
-vtkArchive::~vtkArchive() = default;
+vtkArchive::~vtkArchive()
+{
+  if (this->Internal->ZipArchive)
+  {
+    this->EndZip();
+  }
+  this->CloseZipIndex();
+  delete this->Internal;
+}
 
 //----------------------------------------------------------------------------
 void vtkArchive::PrintSelf(ostream& os, vtkIndent indent)
@@ -367,19 +537,13 @@ bool vtkArchive::Zip(const char* zipFileName, const char* directoryToZip)
 
   //
   // to make a zip file:
-  // - check that libarchive supports zip writing
   // - check arguments
-  // - get a list of files using vtksys Glob
   // - create the archive
-  // -- go file-by-file and add chunks of data to the archive
+  // - add the top-level directory entry
+  // -- go file-by-file (in alphabetical order) and add chunks of data to the archive
   // - close up and return success
   //
 
-// only support the libarchive version 3.0 +
-#if !defined(ARCHIVE_VERSION_NUMBER) || ARCHIVE_VERSION_NUMBER < 3000000
-  return false;
-#endif
-
   if (!zipFileName || !directoryToZip)
   {
     vtkArchiveTools::Error("Zip:", "Invalid zipfile or directory");
@@ -390,23 +554,45 @@ bool vtkArchive::Zip(const char* zipFileName, const char* directoryToZip)
   directoryParts = vtksys::SystemTools::SplitString(directoryToZip, '/', true);
   std::string directoryName = directoryParts.back();
 
-  vtksys::Glob glob;
-  glob.RecurseOn();
-  glob.RecurseThroughSymlinksOff();
-  std::string globPattern(directoryToZip);
-  if (!glob.FindFiles(globPattern + "/*"))
+  vtkNew<vtkArchive> zipArchive;
+  if (!zipArchive->BeginZip(zipFileName))
   {
-    vtkArchiveTools::Error("Zip:", "Could not find files in directory");
     return false;
   }
-  std::vector<std::string> files = glob.GetFiles();
+  // add the data directory
+  bool success = zipArchive->AddDirectoryToZip(directoryName.c_str());
+  // add the files, use a relative path for the entry file name, including the top
+  // directory so it unzips into a directory of it's own
+  success = success && zipArchive->AddDirectoryContentToZip(directoryToZip,
+    vtksys::SystemTools::GetParentDirectory(directoryToZip).c_str());
+  // always close the archive, even if adding some files failed
+  success = zipArchive->EndZip() && success;
+  return success;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkArchive::BeginZip(const char* zipFileName)
+{
+// only support the libarchive version 3.0 +
+#if !defined(ARCHIVE_VERSION_NUMBER) || ARCHIVE_VERSION_NUMBER < 3000000
+  return false;
+#endif
+
+  if (this->Internal->ZipArchive)
+  {
+    this->EndZip();
+  }
+  if (!zipFileName)
+  {
+    vtkArchiveTools::Error("Zip:", "Invalid zipfile");
+    return false;
+  }
 
-  // now zip it up using LibArchive
   struct archive* zipArchive = archive_write_new();
 
   // create a zip archive
 #ifdef HAVE_ZLIB_H
-  std::string compression_type = "deflate";
+  std::string compression_type = (this->ZipCompression ? "deflate" : "store");
 #else
   std::string compression_type = "store";
 #endif
@@ -427,91 +613,576 @@ bool vtkArchive::Zip(const char* zipFileName, const char* directoryToZip)
     return false;
   }
 
-  // add the data directory
+  this->Internal->ZipArchive = zipArchive;
+  this->Internal->ZipEntries.clear();
+  this->Internal->ZipSuccess = true;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkArchive::AddDirectoryToZip(const char* entryName)
+{
+  if (!this->Internal->ZipArchive || !entryName)
+  {
+    vtkArchiveTools::Error("Zip:", "Archive is not open or invalid directory name");
+    return false;
+  }
   struct archive_entry* dirEntry = archive_entry_new();
-  archive_entry_set_mtime(dirEntry, 11, 110);
-  archive_entry_copy_pathname(dirEntry, directoryName.c_str());
+  this->Internal->SetFixedEntryProperties(dirEntry);
+  archive_entry_copy_pathname(dirEntry, entryName);
   archive_entry_set_mode(dirEntry, S_IFDIR | 0755);
   archive_entry_set_size(dirEntry, 512);
-  if (archive_write_header(zipArchive, dirEntry) != ARCHIVE_OK)
+  bool success = (archive_write_header(this->Internal->ZipArchive, dirEntry) == ARCHIVE_OK);
+  if (!success)
   {
-    vtkArchiveTools::Error("Zip: write file header:", archive_error_string(zipArchive));
-    archive_write_free(zipArchive);
-    return false;
+    vtkArchiveTools::Error("Zip: write file header:", archive_error_string(this->Internal->ZipArchive));
+    this->Internal->ZipSuccess = false;
   }
   archive_entry_free(dirEntry);
+  this->Internal->ZipEntries.insert(entryName);
+  return success;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkArchive::AddFileToZip(const char* fileName, const char* entryName)
+{
+  if (!this->Internal->ZipArchive || !fileName || !entryName)
+  {
+    vtkArchiveTools::Error("Zip:", "Archive is not open or invalid file name");
+    return false;
+  }
+  vtkArchiveTools::Message("Zip: adding:", fileName);
+
+  //
+  // add an entry for this file
+  //
+  struct archive_entry* entry = archive_entry_new();
+  archive_entry_set_pathname(entry, entryName);
+  // size is required, for now use the vtksys call though it uses struct stat
+  // and may not be portable
+  unsigned long fileLength = vtksys::SystemTools::FileLength(fileName);
+  archive_entry_set_size(entry, fileLength);
+  archive_entry_set_filetype(entry, AE_IFREG);
+  archive_entry_set_perm(entry, 0644);
+  this->Internal->SetFixedEntryProperties(entry);
+  if (archive_write_header(this->Internal->ZipArchive, entry) != ARCHIVE_OK)
+  {
+    vtkArchiveTools::Error("Zip: write file header:", archive_error_string(this->Internal->ZipArchive));
+    archive_entry_free(entry);
+    this->Internal->ZipSuccess = false;
+    return false;
+  }
+  this->Internal->ZipEntries.insert(entryName);
 
-  // add the files
+  //
+  // add the data for this entry
+  //
   bool success = true;
   char buff[BUFSIZ];
-  std::vector<std::string>::const_iterator sit;
-  sit = files.begin();
-  while (sit != files.end() && success)
-  {
-    vtkArchiveTools::Message("Zip: adding:", sit->c_str());
-    const char *fileName = sit->c_str();
-    ++sit;
-
-    //
-    // add an entry for this file
-    //
-    struct archive_entry* entry = archive_entry_new();
-    // use a relative path for the entry file name, including the top
-    // directory so it unzips into a directory of it's own
-    std::string relFileName = vtksys::SystemTools::RelativePath(
-              vtksys::SystemTools::GetParentDirectory(directoryToZip).c_str(),
-              fileName);
-    vtkArchiveTools::Message("Zip: adding rel:", relFileName.c_str());
-    archive_entry_set_pathname(entry, relFileName.c_str());
-    // size is required, for now use the vtksys call though it uses struct stat
-    // and may not be portable
-    unsigned long fileLength = vtksys::SystemTools::FileLength(fileName);
-    archive_entry_set_size(entry, fileLength);
-    archive_entry_set_filetype(entry, AE_IFREG);
-    archive_entry_set_perm(entry, 0644);
-    if (archive_write_header(zipArchive, entry) != ARCHIVE_OK)
-    {
-      vtkArchiveTools::Error("Zip: write file header:", archive_error_string(zipArchive));
-      return false;
+  FILE *fd = fopen(fileName, "rb");
+  if (!fd)
+  {
+    vtkArchiveTools::Error("Zip: cannot open input file:", fileName);
+    success = false;
+  }
+  else
+  {
+    size_t len = fread(buff, sizeof(char), sizeof(buff), fd);
+    while ( len > 0 )
+    {
+      if (archive_write_data(this->Internal->ZipArchive, buff, len) < 0)
+      {
+        vtkArchiveTools::Error("Zip: cannot write data:", archive_error_string(this->Internal->ZipArchive));
+        success = false;
+        break;
+      }
+      len = fread(buff, sizeof(char), sizeof(buff), fd);
     }
+    fclose(fd);
+  }
+  archive_entry_free(entry);
+  if (!success)
+  {
+    this->Internal->ZipSuccess = false;
+  }
+  return success;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkArchive::AddDirectoryContentToZip(const char* directory, const char* baseDirectory)
+{
+  if (!directory || !baseDirectory)
+  {
+    vtkArchiveTools::Error("Zip:", "Invalid directory");
+    return false;
+  }
+  vtksys::Glob glob;
+  glob.RecurseOn();
+  glob.RecurseThroughSymlinksOff();
+  std::string globPattern(directory);
+  if (!glob.FindFiles(globPattern + "/*"))
+  {
+    vtkArchiveTools::Error("Zip:", "Could not find files in directory");
+    return false;
+  }
+  // Order of files returned by glob depends on the file system, sort them
+  // to make the archive content independent from the order the files were written.
+  std::vector<std::string> files = glob.GetFiles();
+  std::sort(files.begin(), files.end());
 
-    //
-    // add the data for this entry
-    //
-    FILE *fd = fopen(fileName, "rb");
-    if (!fd)
+  bool success = true;
+  for (const std::string& fileName : files)
+  {
+    std::string relFileName = vtksys::SystemTools::RelativePath(baseDirectory, fileName);
+    if (this->HasZipEntry(relFileName.c_str()))
+    {
+      continue;
+    }
+    if (!this->AddFileToZip(fileName.c_str(), relFileName.c_str()))
     {
-      vtkArchiveTools::Error("Zip: cannot open input file:", sit->c_str());
       success = false;
+      break;
     }
-    else
+  }
+  return success;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkArchive::HasZipEntry(const char* entryName)
+{
+  return entryName && this->Internal->ZipEntries.find(entryName) != this->Internal->ZipEntries.end();
+}
+
+//-----------------------------------------------------------------------------
+bool vtkArchive::EndZip()
+{
+  if (!this->Internal->ZipArchive)
+  {
+    return false;
+  }
+  bool success = this->Internal->ZipSuccess;
+  if (archive_write_close(this->Internal->ZipArchive) != ARCHIVE_OK)
+  {
+    vtkArchiveTools::Error("Zip: close archive", archive_error_string(this->Internal->ZipArchive));
+    success = false;
+  }
+  if (archive_write_free(this->Internal->ZipArchive) != ARCHIVE_OK)
+  {
+    vtkArchiveTools::Error("Zip: cleanup", archive_error_string(this->Internal->ZipArchive));
+    success = false;
+  }
+  this->Internal->ZipArchive = nullptr;
+  this->Internal->ZipEntries.clear();
+  return success;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkArchive::OpenZipIndex(const char* zipFileName)
+{
+  //
+  // Zip file layout: local file headers and entry data, followed by the
+  // central directory (list of all entries with their sizes and offsets)
+  // and the end of central directory record (location of the central directory).
+  // Zip64 extensions are used if sizes or offsets do not fit into 32 bits.
+  //
+  this->CloseZipIndex();
+  if (!zipFileName)
+  {
+    vtkArchiveTools::Error("OpenZipIndex:", "Invalid zip file name");
+    return false;
+  }
+  vtksys::ifstream file(zipFileName, std::ios::in | std::ios::binary);
+  if (!file.is_open())
+  {
+    vtkArchiveTools::Error("OpenZipIndex: cannot open file", zipFileName);
+    return false;
+  }
+  file.seekg(0, std::ios::end);
+  vtkTypeInt64 fileSize = static_cast<vtkTypeInt64>(file.tellg());
+
+  // End of central directory record (22 bytes) is followed by a comment of at most 65535 bytes.
+  // Zip64 end of central directory locator (20 bytes) is right before it.
+  const vtkTypeInt64 endRecordSize = 22;
+  const vtkTypeInt64 zip64LocatorSize = 20;
+  vtkTypeInt64 tailSize = endRecordSize + 65535 + zip64LocatorSize;
+  if (tailSize > fileSize)
+  {
+    tailSize = fileSize;
+  }
+  std::vector<unsigned char> tail;
+  if (fileSize < endRecordSize || !ReadFileBlock(file, fileSize - tailSize, tailSize, tail))
+  {
+    vtkArchiveTools::Error("OpenZipIndex: not a zip file", zipFileName);
+    return false;
+  }
+  vtkTypeInt64 endRecordPosition = -1;
+  for (vtkTypeInt64 position = tailSize - endRecordSize; position >= 0; --position)
+  {
+    if (ReadLittleEndian(&tail[position], 4) == 0x06054b50)
+    {
+      endRecordPosition = position;
+      break;
+    }
+  }
+  if (endRecordPosition < 0)
+  {
+    vtkArchiveTools::Error("OpenZipIndex: end of central directory not found in", zipFileName);
+    return false;
+  }
+  vtkTypeInt64 numberOfEntries = ReadLittleEndian(&tail[endRecordPosition + 10], 2);
+  vtkTypeInt64 centralDirectorySize = ReadLittleEndian(&tail[endRecordPosition + 12], 4);
+  vtkTypeInt64 centralDirectoryOffset = ReadLittleEndian(&tail[endRecordPosition + 16], 4);
+  if (endRecordPosition >= zip64LocatorSize
+    && ReadLittleEndian(&tail[endRecordPosition - zip64LocatorSize], 4) == 0x07064b50)
+  {
+    vtkTypeInt64 zip64EndRecordOffset = ReadLittleEndian(&tail[endRecordPosition - zip64LocatorSize + 8], 8);
+    std::vector<unsigned char> zip64EndRecord;
+    if (!ReadFileBlock(file, zip64EndRecordOffset, 56, zip64EndRecord)
+      || ReadLittleEndian(&zip64EndRecord[0], 4) != 0x06064b50)
+    {
+      vtkArchiveTools::Error("OpenZipIndex: invalid zip64 end of central directory in", zipFileName);
+      return false;
+    }
+    numberOfEntries = ReadLittleEndian(&zip64EndRecord[32], 8);
+    centralDirectorySize = ReadLittleEndian(&zip64EndRecord[40], 8);
+    centralDirectoryOffset = ReadLittleEndian(&zip64EndRecord[48], 8);
+  }
+  std::vector<unsigned char> centralDirectory;
+  if (centralDirectoryOffset + centralDirectorySize > fileSize
+    || !ReadFileBlock(file, centralDirectoryOffset, centralDirectorySize, centralDirectory))
+  {
+    vtkArchiveTools::Error("OpenZipIndex: cannot read central directory of", zipFileName);
+    return false;
+  }
+
+  const size_t headerSize = 46;
+  size_t position = 0;
+  for (vtkTypeInt64 entryIndex = 0; entryIndex < numberOfEntries; ++entryIndex)
+  {
+    if (position + headerSize > centralDirectory.size()
+      || ReadLittleEndian(&centralDirectory[position], 4) != 0x02014b50)
+    {
+      vtkArchiveTools::Error("OpenZipIndex: invalid central directory in", zipFileName);
+      this->CloseZipIndex();
+      return false;
+    }
+    const unsigned char* header = &centralDirectory[position];
+    size_t nameLength = ReadLittleEndian(header + 28, 2);
+    size_t extraLength = ReadLittleEndian(header + 30, 2);
+    size_t commentLength = ReadLittleEndian(header + 32, 2);
+    if (position + headerSize + nameLength + extraLength + commentLength > centralDirectory.size())
     {
-      size_t len = fread(buff, sizeof(char), sizeof(buff), fd);
-      while ( len > 0 )
+      vtkArchiveTools::Error("OpenZipIndex: invalid central directory in", zipFileName);
+      this->CloseZipIndex();
+      return false;
+    }
+    vtkInternal::ZipIndexEntry entry;
+    entry.CompressionMethod = static_cast<unsigned int>(ReadLittleEndian(header + 10, 2));
+    entry.CompressedSize = ReadLittleEndian(header + 20, 4);
+    entry.UncompressedSize = ReadLittleEndian(header + 24, 4);
+    entry.LocalHeaderOffset = ReadLittleEndian(header + 42, 4);
+    entry.Name.assign(reinterpret_cast<const char*>(header + headerSize), nameLength);
+
+    // Zip64 extended information contains the 64-bit values of the fields that are set to 0xFFFFFFFF
+    const unsigned char* extra = header + headerSize + nameLength;
+    size_t extraPosition = 0;
+    while (extraPosition + 4 <= extraLength)
+    {
+      size_t fieldId = ReadLittleEndian(extra + extraPosition, 2);
+      size_t fieldSize = ReadLittleEndian(extra + extraPosition + 2, 2);
+      if (extraPosition + 4 + fieldSize > extraLength)
       {
-        if (archive_write_data(zipArchive, buff, len) < 0)
+        break;
+      }
+      if (fieldId == 0x0001)
+      {
+        const unsigned char* field = extra + extraPosition + 4;
+        size_t fieldPosition = 0;
+        vtkTypeInt64* values[3] = { &entry.UncompressedSize, &entry.CompressedSize, &entry.LocalHeaderOffset };
+        for (vtkTypeInt64* value : values)
         {
-          vtkArchiveTools::Error("Zip: cannot write data:", archive_error_string(zipArchive));
-          success = false;
+          if (*value == 0xFFFFFFFF && fieldPosition + 8 <= fieldSize)
+          {
+            *value = ReadLittleEndian(field + fieldPosition, 8);
+            fieldPosition += 8;
+          }
         }
-        len = fread(buff, sizeof(char), sizeof(buff), fd);
       }
-      fclose(fd);
+      extraPosition += 4 + fieldSize;
     }
-    archive_entry_free(entry);
+
+    this->Internal->IndexEntryNames[entry.Name] = static_cast<int>(this->Internal->IndexEntries.size());
+    this->Internal->IndexEntries.push_back(entry);
+    position += headerSize + nameLength + extraLength + commentLength;
+  }
+
+  this->Internal->IndexFileName = zipFileName;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void vtkArchive::CloseZipIndex()
+{
+  this->Internal->UnmapRegions();
+  this->Internal->IndexEntries.clear();
+  this->Internal->IndexEntryNames.clear();
+  this->Internal->IndexFileName.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool vtkArchive::IsZipIndexOpen()
+{
+  return !this->Internal->IndexFileName.empty();
+}
+
+//-----------------------------------------------------------------------------
+int vtkArchive::GetNumberOfZipEntries()
+{
+  return static_cast<int>(this->Internal->IndexEntries.size());
+}
+
+//-----------------------------------------------------------------------------
+std::string vtkArchive::GetNthZipEntryName(int entryIndex)
+{
+  if (entryIndex < 0 || entryIndex >= this->GetNumberOfZipEntries())
+  {
+    return "";
   }
+  return this->Internal->IndexEntries[entryIndex].Name;
+}
 
-  if (archive_write_close(zipArchive) != ARCHIVE_OK)
+//-----------------------------------------------------------------------------
+int vtkArchive::FindZipEntry(const char* entryName)
+{
+  if (!entryName)
   {
-    vtkArchiveTools::Error("Zip: close archive", archive_error_string(zipArchive));
-    success = false;
+    return -1;
   }
-  if (archive_write_free(zipArchive) != ARCHIVE_OK)
+  std::map<std::string, int>::iterator entryIt = this->Internal->IndexEntryNames.find(entryName);
+  if (entryIt == this->Internal->IndexEntryNames.end())
   {
-    vtkArchiveTools::Error("Zip: cleanup", archive_error_string(zipArchive));
-    success = false;
+    return -1;
   }
-  return success;
+  return entryIt->second;
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkArchive::GetNthZipEntrySize(int entryIndex)
+{
+  if (entryIndex < 0 || entryIndex >= this->GetNumberOfZipEntries())
+  {
+    return 0;
+  }
+  return this->Internal->IndexEntries[entryIndex].UncompressedSize;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkArchive::IsNthZipEntryCompressed(int entryIndex)
+{
+  if (entryIndex < 0 || entryIndex >= this->GetNumberOfZipEntries())
+  {
+    return false;
+  }
+  return this->Internal->IndexEntries[entryIndex].CompressionMethod != 0;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkArchive::ExtractNthZipEntry(int entryIndex, const char* destinationFileName)
+{
+  if (entryIndex < 0 || entryIndex >= this->GetNumberOfZipEntries() || !destinationFileName)
+  {
+    vtkArchiveTools::Error("ExtractNthZipEntry:", "Invalid entry or destination file name");
+    return false;
+  }
+  const vtkInternal::ZipIndexEntry& entry = this->Internal->IndexEntries[entryIndex];
+  if (!entry.Name.empty() && entry.Name.back() == '/')
+  {
+    // directory entry
+    return vtksys::SystemTools::MakeDirectory(destinationFileName).IsSuccess();
+  }
+  std::string destinationDirectory = vtksys::SystemTools::GetFilenamePath(destinationFileName);
+  if (!destinationDirectory.empty() && !vtksys::SystemTools::MakeDirectory(destinationDirectory).IsSuccess())
+  {
+    vtkArchiveTools::Error("ExtractNthZipEntry: cannot create directory", destinationDirectory.c_str());
+    return false;
+  }
+  vtksys::ofstream output(destinationFileName, std::ios::out | std::ios::binary);
+  if (!output.is_open())
+  {
+    vtkArchiveTools::Error("ExtractNthZipEntry: cannot create file", destinationFileName);
+    return false;
+  }
+
+  vtkTypeInt64 writtenSize = 0;
+  vtkTypeInt64 mappedSize = 0;
+  bool alreadyMapped = (this->Internal->MappedRegions.find(entryIndex) != this->Internal->MappedRegions.end());
+  const char* mappedContent = (entry.CompressionMethod == 0 ? this->MapNthZipEntry(entryIndex, mappedSize) : nullptr);
+  if (mappedContent)
+  {
+    // stored without compression, write the content directly from the mapped file
+    output.write(mappedContent, static_cast<std::streamsize>(mappedSize));
+    writtenSize = mappedSize;
+    if (!alreadyMapped)
+    {
+      this->Internal->UnmapRegion(entryIndex);
+    }
+  }
+  else if (entry.CompressionMethod == 0)
+  {
+    // stored without compression but mapping failed, copy the content
+    vtkTypeInt64 dataOffset = this->Internal->GetEntryDataOffset(entry);
+    vtksys::ifstream input(this->Internal->IndexFileName.c_str(), std::ios::in | std::ios::binary);
+    if (dataOffset < 0 || !input.is_open())
+    {
+      vtkArchiveTools::Error("ExtractNthZipEntry: cannot read entry", entry.Name.c_str());
+      return false;
+    }
+    input.seekg(static_cast<std::streamoff>(dataOffset), std::ios::beg);
+    char buff[BUFSIZ];
+    while (writtenSize < entry.UncompressedSize)
+    {
+      vtkTypeInt64 remainingSize = entry.UncompressedSize - writtenSize;
+      std::streamsize blockSize = static_cast<std::streamsize>(remainingSize < BUFSIZ ? remainingSize : BUFSIZ);
+      input.read(buff, blockSize);
+      if (input.gcount() != blockSize)
+      {
+        break;
+      }
+      output.write(buff, blockSize);
+      writtenSize += blockSize;
+    }
+  }
+  else
+  {
+    // compressed, let libarchive decompress the entry starting from its local header
+    ZipEntryStream stream;
+    stream.File.open(this->Internal->IndexFileName.c_str(), std::ios::in | std::ios::binary);
+    if (!stream.File.is_open())
+    {
+      vtkArchiveTools::Error("ExtractNthZipEntry: cannot open", this->Internal->IndexFileName.c_str());
+      return false;
+    }
+    stream.File.seekg(static_cast<std::streamoff>(entry.LocalHeaderOffset), std::ios::beg);
+    struct archive* zipArchive = archive_read_new();
+    archive_read_support_format_zip_streamable(zipArchive);
+    struct archive_entry* archiveEntry = nullptr;
+    if (archive_read_open(zipArchive, &stream, nullptr, ReadZipEntryStream, nullptr) != ARCHIVE_OK
+      || archive_read_next_header(zipArchive, &archiveEntry) != ARCHIVE_OK)
+    {
+      vtkArchiveTools::Error("ExtractNthZipEntry: cannot read entry header", archive_error_string(zipArchive));
+      archive_read_free(zipArchive);
+      return false;
+    }
+    char buff[BUFSIZ];
+    for (;;)
+    {
+      la_ssize_t size = archive_read_data(zipArchive, buff, sizeof(buff));
+      if (size < 0)
+      {
+        vtkArchiveTools::Error("ExtractNthZipEntry: cannot decompress entry", archive_error_string(zipArchive));
+        break;
+      }
+      if (size == 0)
+      {
+        break;
+      }
+      output.write(buff, size);
+      writtenSize += size;
+    }
+    archive_read_free(zipArchive);
+  }
+
+  output.close();
+  if (writtenSize != entry.UncompressedSize || output.fail())
+  {
+    vtkArchiveTools::Error("ExtractNthZipEntry: failed to extract", entry.Name.c_str());
+    vtksys::SystemTools::RemoveFile(destinationFileName);
+    return false;
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+const char* vtkArchive::MapNthZipEntry(int entryIndex, vtkTypeInt64& size)
+{
+  size = 0;
+  if (entryIndex < 0 || entryIndex >= this->GetNumberOfZipEntries()
+    || this->IsNthZipEntryCompressed(entryIndex))
+  {
+    return nullptr;
+  }
+  std::map<int, vtkInternal::MappedRegion>::iterator mappedIt = this->Internal->MappedRegions.find(entryIndex);
+  const vtkInternal::ZipIndexEntry& entry = this->Internal->IndexEntries[entryIndex];
+  if (mappedIt != this->Internal->MappedRegions.end())
+  {
+    size = entry.UncompressedSize;
+    return mappedIt->second.EntryData;
+  }
+  vtkTypeInt64 dataOffset = this->Internal->GetEntryDataOffset(entry);
+  if (dataOffset < 0)
+  {
+    return nullptr;
+  }
+  vtkInternal::MappedRegion region;
+  if (entry.UncompressedSize == 0)
+  {
+    // nothing to map
+    region.EntryData = "";
+    this->Internal->MappedRegions[entryIndex] = region;
+    return region.EntryData;
+  }
+
+  // mapping must start at a multiple of the allocation granularity
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  vtkTypeInt64 granularity = systemInfo.dwAllocationGranularity;
+#else
+  vtkTypeInt64 granularity = sysconf(_SC_PAGESIZE);
+#endif
+  vtkTypeInt64 mappingOffset = dataOffset - dataOffset % granularity;
+  region.Length = static_cast<size_t>(dataOffset - mappingOffset + entry.UncompressedSize);
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  HANDLE fileHandle = CreateFileW(vtksys::Encoding::ToWide(this->Internal->IndexFileName).c_str(), GENERIC_READ,
+    FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (fileHandle == INVALID_HANDLE_VALUE)
+  {
+    return nullptr;
+  }
+  HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mappingHandle)
+  {
+    region.Address = MapViewOfFile(mappingHandle, FILE_MAP_READ,
+      static_cast<DWORD>(mappingOffset >> 32), static_cast<DWORD>(mappingOffset & 0xFFFFFFFF), region.Length);
+    // the view keeps the file mapped
+    CloseHandle(mappingHandle);
+  }
+  CloseHandle(fileHandle);
+  if (!region.Address)
+  {
+    return nullptr;
+  }
+#else
+  int fileDescriptor = open(this->Internal->IndexFileName.c_str(), O_RDONLY);
+  if (fileDescriptor < 0)
+  {
+    return nullptr;
+  }
+  void* address = mmap(nullptr, region.Length, PROT_READ, MAP_PRIVATE, fileDescriptor, static_cast<off_t>(mappingOffset));
+  // the mapping keeps the file open
+  close(fileDescriptor);
+  if (address == MAP_FAILED)
+  {
+    return nullptr;
+  }
+  region.Address = address;
+#endif
+
+  region.EntryData = static_cast<const char*>(region.Address) + (dataOffset - mappingOffset);
+  this->Internal->MappedRegions[entryIndex] = region;
+  size = entry.UncompressedSize;
+  return region.EntryData;
 }
 
 //-----------------------------------------------------------------------------
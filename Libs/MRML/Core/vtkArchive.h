@@ -15,6 +15,7 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 
 // VTK includes
 #include <vtkObject.h>
+#include <vtkType.h>
 
 // STD includes
 #include <string>
@@ -22,6 +23,15 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 
 /// \brief Simple class for manipulating archive files
 ///
+/// Static methods process complete archives. An instance can be used for writing
+/// a zip file incrementally (BeginZip, AddFileToZip, ..., EndZip), which allows adding
+/// files to the archive while other files are still being produced.
+/// Entries are written with fixed time stamp and permissions, therefore the same
+/// content added in the same order always results in the same archive file.
+///
+/// An instance can also read a zip file randomly (OpenZipIndex): only the central directory
+/// is read when the file is opened and then individual entries can be extracted
+/// (with streamed decompression) or, if they are stored without compression, mapped into memory.
 class VTK_MRML_EXPORT vtkArchive : public vtkObject
 {
 public:
@@ -43,11 +53,81 @@ public:
   // (internally this supports many formats of archive, not just zip)
   static bool UnZip(const char* zipFileName, const char *destinationDirectory);
 
+  /// Compress entries of zip files that are written by BeginZip.
+  /// If disabled then entries are stored without compression, which allows
+  /// reading them by memory mapping (see MapNthZipEntry).
+  /// Enabled by default.
+  vtkSetMacro(ZipCompression, bool);
+  vtkGetMacro(ZipCompression, bool);
+  vtkBooleanMacro(ZipCompression, bool);
+
+  /// Start writing a zip file. Any previously started zip file is closed.
+  bool BeginZip(const char* zipFileName);
+
+  /// Add a directory entry to the zip file that was started by BeginZip.
+  bool AddDirectoryToZip(const char* entryName);
+
+  /// Add the content of file to the zip file that was started by BeginZip.
+  /// entryName is the relative path of the file in the archive.
+  bool AddFileToZip(const char* fileName, const char* entryName);
+
+  /// Add all files found in directory (recursively) that have not been added yet.
+  /// Files are added in alphabetical order of their path.
+  /// Entry names are the paths relative to baseDirectory.
+  bool AddDirectoryContentToZip(const char* directory, const char* baseDirectory);
+
+  /// Returns true if an entry with the specified name has been added since BeginZip.
+  bool HasZipEntry(const char* entryName);
+
+  /// Finish writing the zip file. Returns false if the archive could not be completed.
+  bool EndZip();
+
+  /// Open a zip file for random access reading by reading its central directory.
+  /// Entry content is not read. Any previously opened zip file is closed.
+  bool OpenZipIndex(const char* zipFileName);
+
+  /// Close the zip file that was opened by OpenZipIndex.
+  /// Memory regions returned by MapNthZipEntry become invalid.
+  void CloseZipIndex();
+
+  /// Returns true if a zip file is opened by OpenZipIndex.
+  bool IsZipIndexOpen();
+
+  /// Number of entries in the zip file opened by OpenZipIndex.
+  int GetNumberOfZipEntries();
+
+  /// Path of the entry in the archive. Directory entries end with "/".
+  std::string GetNthZipEntryName(int entryIndex);
+
+  /// Returns index of the entry with the specified path, -1 if not found.
+  int FindZipEntry(const char* entryName);
+
+  /// Size of the entry content after decompression, in bytes.
+  vtkTypeInt64 GetNthZipEntrySize(int entryIndex);
+
+  /// Returns true if the entry content is compressed. Uncompressed entries can be mapped into memory.
+  bool IsNthZipEntryCompressed(int entryIndex);
+
+  /// Write content of an entry into a file. Parent directories are created as needed.
+  /// Compressed entries are decompressed while they are written, without reading the
+  /// rest of the archive. Uncompressed entries are written from memory mapped content.
+  bool ExtractNthZipEntry(int entryIndex, const char* destinationFileName);
+
+  /// Map content of an uncompressed entry into memory (read-only).
+  /// Returns nullptr if the entry is compressed or mapping failed.
+  /// The returned pointer is valid until CloseZipIndex is called.
+  const char* MapNthZipEntry(int entryIndex, vtkTypeInt64& size);
+
 protected:
   vtkArchive();
   ~vtkArchive() override;
   vtkArchive(const vtkArchive&);
   void operator=(const vtkArchive&);
+
+  bool ZipCompression{ true };
+
+  class vtkInternal;
+  vtkInternal* Internal;
 };
 
 #endif
@@ -20,13 +20,16 @@
 
 // MRML includes
 #include <vtkEventBroker.h>
+#include <vtkMRMLMarkupsCurveNode.h>
 #include <vtkMRMLMarkupsNode.h>
 #include <vtkMRMLMeasurement.h>
+#include <vtkMRMLTransformNode.h>
 
 // VTK includes
 #include <vtkCallbackCommand.h>
 #include <vtkCellArray.h>
 #include <vtkCellData.h>
+#include <vtkCurveGenerator.h>
 #include <vtkDoubleArray.h>
 #include <vtkFieldData.h>
 #include <vtkInformation.h>
@@ -36,6 +39,9 @@
 #include <vtkPolyData.h>
 #include <vtkTriangleFilter.h>
 
+// STL includes
+#include <algorithm>
+
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkCurveMeasurementsCalculator);
 
@@ -153,6 +159,7 @@ int vtkCurveMeasurementsCalculator::RequestData(
   else
   {
     outputPolyData->GetPointData()->RemoveArray(this->GetCurvatureArrayName());
+    this->CurvatureCache = CurvatureCacheType();
   }
 
   if (this->CalculateTorsion)
@@ -203,116 +210,159 @@ bool vtkCurveMeasurementsCalculator::CalculatePolyDataCurvature(vtkPolyData* pol
     return false;
   }
 
-  // Initialize curvature array
-  vtkSmartPointer<vtkDoubleArray> curvatureValues = vtkDoubleArray::SafeDownCast(
-    polyData->GetPointData()->GetArray(this->GetCurvatureArrayName()));
-  if (curvatureValues == nullptr)
+  // Only recompute curvature around the points that moved since the last calculation
+  // (for example, when a single control point of a long curve is moved).
+  vtkIdType firstModifiedPointIndex = 0;
+  vtkIdType lastModifiedPointIndex = numberOfPoints - 1;
+  if (this->GetModifiedCurvePointRangeFromControlPoints(polyData, linePoints, numberOfPoints,
+    firstModifiedPointIndex, lastModifiedPointIndex))
   {
-    curvatureValues = vtkSmartPointer<vtkDoubleArray>::New();
+    // Splice positions of the modified curve points into the cache
+    for (vtkIdType idx = firstModifiedPointIndex; idx <= lastModifiedPointIndex; ++idx)
+    {
+      points->GetPoint(linePoints->GetId(idx), this->CurvatureCache.Points.data() + 3 * idx);
+    }
   }
-  curvatureValues->Initialize();
-  curvatureValues->SetName(this->GetCurvatureArrayName());
-  curvatureValues->SetNumberOfComponents(1);
-  curvatureValues->SetNumberOfTuples(numberOfPoints);
-  curvatureValues->Reset();
-  curvatureValues->FillComponent(0,0.0);
-
-  // Initialize curvature variables
-  double minKappa = 0.0;
-  double maxKappa = 0.0;
-  double meanKappa = 0.0; // Mean is weighted by the length of each segment
-
-  // Get values for first point
-  double prevPoint[3] = {points->GetPoint(linePoints->GetId(0))[0], points->GetPoint(linePoints->GetId(0))[1], points->GetPoint(linePoints->GetId(0))[2]}; // pp
-  double* currPoint = points->GetPoint(linePoints->GetId(1)); // p
-  double diffVector[3] = {currPoint[0]-prevPoint[0], currPoint[1]-prevPoint[1], currPoint[2]-prevPoint[2]};
-  double diffNorm = sqrt(diffVector[0]*diffVector[0] + diffVector[1]*diffVector[1] + diffVector[2]*diffVector[2]); // ds
-  double normDiffVector[3] = {0.0, 0.0, 0.0}; // T
-  double prevNormDiffVector[3] = {diffVector[0]/diffNorm, diffVector[1]/diffNorm, diffVector[2]/diffNorm}; // pT
-  double meanPoint[3] = {0.0, 0.0, 0.0}; // m
-  double prevMeanPoint[3] = {currPoint[0], currPoint[1], currPoint[2]}; // pm (Skip first point)
-  double kappa = 0.0;
-  double currentLength = 0.0;
-  double length = 0.0;
-
-  // The curvature for the first cell is 0.0 for open curves
-  curvatureValues->InsertValue(linePoints->GetId(0), 0.0);
-
-  prevPoint[0] = currPoint[0]; prevPoint[1] = currPoint[1]; prevPoint[2] = currPoint[2];
-  for (vtkIdType idx=1; idx<numberOfPoints-1; ++idx)
+  else
   {
-    currPoint = points->GetPoint(linePoints->GetId(idx+1));
-
-    diffVector[0] = currPoint[0]-prevPoint[0];
-    diffVector[1] = currPoint[1]-prevPoint[1];
-    diffVector[2] = currPoint[2]-prevPoint[2];
-    diffNorm = sqrt(diffVector[0]*diffVector[0] + diffVector[1]*diffVector[1] + diffVector[2]*diffVector[2]);
-
-    normDiffVector[0] = diffVector[0] / diffNorm;
-    normDiffVector[1] = diffVector[1] / diffNorm;
-    normDiffVector[2] = diffVector[2] / diffNorm;
+    this->UpdateCurvatureCachePoints(points, linePoints, numberOfPoints, firstModifiedPointIndex, lastModifiedPointIndex);
+  }
+  bool fullUpdate = (firstModifiedPointIndex <= 0 && lastModifiedPointIndex >= numberOfPoints - 1)
+    || !this->CurvatureCache.CurvatureValues
+    || this->CurvatureCache.CurvatureValues->GetNumberOfTuples() != polyData->GetNumberOfPoints();
+
+  // Local curvature and segment length at a point depend on the point and its two neighbors
+  vtkIdType firstUpdatedPointIndex = std::max<vtkIdType>(1, firstModifiedPointIndex - 1);
+  vtkIdType lastUpdatedPointIndex = std::min<vtkIdType>(numberOfPoints - 2, lastModifiedPointIndex + 1);
+  const double* curvePoints = this->CurvatureCache.Points.data();
+  bool maxCurvatureRemoved = false;
+  for (vtkIdType idx = firstUpdatedPointIndex; idx <= lastUpdatedPointIndex; ++idx)
+  {
+    const double* prevPoint = curvePoints + 3 * (idx - 1); // pp
+    const double* currPoint = curvePoints + 3 * idx; // p
+    const double* nextPoint = curvePoints + 3 * (idx + 1);
+
+    double prevDiffVector[3] = {currPoint[0]-prevPoint[0], currPoint[1]-prevPoint[1], currPoint[2]-prevPoint[2]};
+    double prevDiffNorm = sqrt(prevDiffVector[0]*prevDiffVector[0] + prevDiffVector[1]*prevDiffVector[1] + prevDiffVector[2]*prevDiffVector[2]);
+    double prevNormDiffVector[3] = {prevDiffVector[0]/prevDiffNorm, prevDiffVector[1]/prevDiffNorm, prevDiffVector[2]/prevDiffNorm}; // pT
+
+    double diffVector[3] = {nextPoint[0]-currPoint[0], nextPoint[1]-currPoint[1], nextPoint[2]-currPoint[2]};
+    double diffNorm = sqrt(diffVector[0]*diffVector[0] + diffVector[1]*diffVector[1] + diffVector[2]*diffVector[2]); // ds
+    double normDiffVector[3] = {diffVector[0]/diffNorm, diffVector[1]/diffNorm, diffVector[2]/diffNorm}; // T
+
+    // Remove previous values of the point from the running statistics
+    double& kappa = this->CurvatureCache.Curvatures[idx];
+    double& currentLength = this->CurvatureCache.Lengths[idx];
+    this->CurvatureCache.WeightedCurvatureSum -= kappa * currentLength;
+    this->CurvatureCache.Length -= currentLength;
+    if (kappa > 0.0 && kappa >= this->CurvatureCache.MaxCurvature)
+    {
+      maxCurvatureRemoved = true;
+    }
 
     // Local curvature
     kappa = sqrt( (normDiffVector[0]-prevNormDiffVector[0])*(normDiffVector[0]-prevNormDiffVector[0])
                 + (normDiffVector[1]-prevNormDiffVector[1])*(normDiffVector[1]-prevNormDiffVector[1])
                 + (normDiffVector[2]-prevNormDiffVector[2])*(normDiffVector[2]-prevNormDiffVector[2]) )
             / diffNorm;
-    curvatureValues->InsertValue(linePoints->GetId(idx), kappa);
-
-    // Statistics
-    meanPoint[0] = (currPoint[0]+prevPoint[0]) / 2.0;
-    meanPoint[1] = (currPoint[1]+prevPoint[1]) / 2.0;
-    meanPoint[2] = (currPoint[2]+prevPoint[2]) / 2.0;
 
+    // Length of the curve between the mean points of the adjacent segments (first point is skipped)
+    double meanPoint[3] = {(nextPoint[0]+currPoint[0]) / 2.0, (nextPoint[1]+currPoint[1]) / 2.0, (nextPoint[2]+currPoint[2]) / 2.0}; // m
+    double prevMeanPoint[3] = {currPoint[0], currPoint[1], currPoint[2]}; // pm
+    if (idx > 1)
+    {
+      prevMeanPoint[0] = (currPoint[0]+prevPoint[0]) / 2.0;
+      prevMeanPoint[1] = (currPoint[1]+prevPoint[1]) / 2.0;
+      prevMeanPoint[2] = (currPoint[2]+prevPoint[2]) / 2.0;
+    }
     currentLength = sqrt( (meanPoint[0]-prevMeanPoint[0])*(meanPoint[0]-prevMeanPoint[0])
                         + (meanPoint[1]-prevMeanPoint[1])*(meanPoint[1]-prevMeanPoint[1])
                         + (meanPoint[2]-prevMeanPoint[2])*(meanPoint[2]-prevMeanPoint[2]) );
-    if (kappa < minKappa)
+
+    // Add new values of the point to the running statistics
+    this->CurvatureCache.WeightedCurvatureSum += kappa * currentLength;
+    this->CurvatureCache.Length += currentLength;
+    if (kappa > this->CurvatureCache.MaxCurvature)
     {
-      minKappa = kappa;
+      this->CurvatureCache.MaxCurvature = kappa;
+      maxCurvatureRemoved = false;
     }
-    else if (kappa > maxKappa)
+  }
+
+  if (fullUpdate)
+  {
+    // Recompute statistics from scratch to avoid accumulation of rounding errors
+    this->CurvatureCache.WeightedCurvatureSum = 0.0;
+    this->CurvatureCache.Length = 0.0;
+    this->CurvatureCache.MaxCurvature = 0.0;
+    for (vtkIdType idx=1; idx<numberOfPoints-1; ++idx)
     {
-      maxKappa = kappa;
+      double kappa = this->CurvatureCache.Curvatures[idx];
+      this->CurvatureCache.WeightedCurvatureSum += kappa * this->CurvatureCache.Lengths[idx]; // weighted mean
+      this->CurvatureCache.Length += this->CurvatureCache.Lengths[idx];
+      this->CurvatureCache.MaxCurvature = std::max(this->CurvatureCache.MaxCurvature, kappa);
     }
-    meanKappa += kappa * currentLength; // weighted mean
-    length += currentLength;
-
-    // Propagate current values to previous
-    for (int i=0; i<3; ++i)
+  }
+  else if (maxCurvatureRemoved)
+  {
+    // The point that had the maximum curvature changed, find the new maximum
+    this->CurvatureCache.MaxCurvature = 0.0;
+    for (vtkIdType idx=1; idx<numberOfPoints-1; ++idx)
     {
-      prevPoint[i] = currPoint[i];
-      prevMeanPoint[i] = meanPoint[i];
-      prevNormDiffVector[i] = normDiffVector[i];
+      this->CurvatureCache.MaxCurvature = std::max(this->CurvatureCache.MaxCurvature, this->CurvatureCache.Curvatures[idx]);
     }
-  } // For each line point
+  }
 
-  if (!this->CurveIsClosed)
+  // Update curvature array
+  vtkIdType firstUpdatedValueIndex = firstUpdatedPointIndex;
+  vtkIdType lastUpdatedValueIndex = lastUpdatedPointIndex;
+  if (fullUpdate)
   {
-    // The curvature for the last cell by definition is 0.0 for open curves
-    curvatureValues->InsertValue(linePoints->GetId(numberOfPoints-1), 0.0);
+    this->CurvatureCache.CurvatureValues = vtkSmartPointer<vtkDoubleArray>::New();
+    this->CurvatureCache.CurvatureValues->SetName(this->GetCurvatureArrayName());
+    this->CurvatureCache.CurvatureValues->SetNumberOfComponents(1);
+    this->CurvatureCache.CurvatureValues->SetNumberOfTuples(polyData->GetNumberOfPoints());
+    this->CurvatureCache.CurvatureValues->FillComponent(0, 0.0);
+    firstUpdatedValueIndex = 1;
+    lastUpdatedValueIndex = numberOfPoints - 2;
   }
-  else
+  vtkDoubleArray* curvatureValues = this->CurvatureCache.CurvatureValues;
+  for (vtkIdType idx = firstUpdatedValueIndex; idx <= lastUpdatedValueIndex; ++idx)
   {
-    // Use the adjacent values for closed curve instead of the singular values
-    curvatureValues->SetComponent(linePoints->GetId(0), 0,
-      curvatureValues->GetValue(linePoints->GetId(1)));
-    curvatureValues->InsertValue(linePoints->GetId(numberOfPoints-1),
-      curvatureValues->GetValue(linePoints->GetId(numberOfPoints-2)));
+    curvatureValues->SetValue(linePoints->GetId(idx), this->CurvatureCache.Curvatures[idx]);
   }
-
-  currentLength = sqrt( (prevPoint[0]-prevMeanPoint[0])*(prevPoint[0]-prevMeanPoint[0])
-                      + (prevPoint[1]-prevMeanPoint[1])*(prevPoint[1]-prevMeanPoint[1])
-                      + (prevPoint[2]-prevMeanPoint[2])*(prevPoint[2]-prevMeanPoint[2]) );
-  length += currentLength;
-  if (length > 0.0)
+  if (!this->CurveIsClosed)
   {
-    meanKappa = meanKappa / length;
+    // The curvature for the first and last cell by definition is 0.0 for open curves
+    curvatureValues->SetValue(linePoints->GetId(0), 0.0);
+    curvatureValues->SetValue(linePoints->GetId(numberOfPoints-1), 0.0);
   }
   else
   {
-    meanKappa = 0.0;
+    // Use the adjacent values for closed curve instead of the singular values
+    curvatureValues->SetValue(linePoints->GetId(0), this->CurvatureCache.Curvatures[1]);
+    curvatureValues->SetValue(linePoints->GetId(numberOfPoints-1), this->CurvatureCache.Curvatures[numberOfPoints-2]);
+  }
+  curvatureValues->Modified();
+
+  // Last point and mean point of the last segment
+  const double* prevPoint = curvePoints + 3 * (numberOfPoints - 1);
+  double prevMeanPoint[3] =
+  {
+    (prevPoint[0] + curvePoints[3 * (numberOfPoints - 2)]) / 2.0,
+    (prevPoint[1] + curvePoints[3 * (numberOfPoints - 2) + 1]) / 2.0,
+    (prevPoint[2] + curvePoints[3 * (numberOfPoints - 2) + 2]) / 2.0
+  };
+  double lastLength = sqrt( (prevPoint[0]-prevMeanPoint[0])*(prevPoint[0]-prevMeanPoint[0])
+                          + (prevPoint[1]-prevMeanPoint[1])*(prevPoint[1]-prevMeanPoint[1])
+                          + (prevPoint[2]-prevMeanPoint[2])*(prevPoint[2]-prevMeanPoint[2]) );
+  double length = this->CurvatureCache.Length + lastLength;
+  double meanKappa = 0.0; // Mean is weighted by the length of each segment
+  if (length > 0.0)
+  {
+    meanKappa = this->CurvatureCache.WeightedCurvatureSum / length;
   }
+  double maxKappa = this->CurvatureCache.MaxCurvature;
 
   // Set mean and max curvature to measurements
   // Calculate and set interpolated control point measurements in poly data
@@ -341,6 +391,155 @@ bool vtkCurveMeasurementsCalculator::CalculatePolyDataCurvature(vtkPolyData* pol
   return true;
 }
 
+//------------------------------------------------------------------------------
+void vtkCurveMeasurementsCalculator::UpdateCurvatureCachePoints(vtkPoints* points, vtkIdList* linePoints, vtkIdType numberOfPoints,
+  vtkIdType& firstModifiedPointIndex, vtkIdType& lastModifiedPointIndex)
+{
+  std::vector<double> curvePoints(3 * numberOfPoints);
+  for (vtkIdType idx = 0; idx < numberOfPoints; ++idx)
+  {
+    points->GetPoint(linePoints->GetId(idx), curvePoints.data() + 3 * idx);
+  }
+
+  firstModifiedPointIndex = 0;
+  lastModifiedPointIndex = numberOfPoints - 1;
+  if (this->CurvatureCache.CurveIsClosed == this->CurveIsClosed
+    && this->CurvatureCache.Points.size() == curvePoints.size())
+  {
+    firstModifiedPointIndex = numberOfPoints;
+    lastModifiedPointIndex = -1;
+    for (vtkIdType idx = 0; idx < numberOfPoints; ++idx)
+    {
+      if (curvePoints[3 * idx] != this->CurvatureCache.Points[3 * idx]
+        || curvePoints[3 * idx + 1] != this->CurvatureCache.Points[3 * idx + 1]
+        || curvePoints[3 * idx + 2] != this->CurvatureCache.Points[3 * idx + 2])
+      {
+        firstModifiedPointIndex = std::min(firstModifiedPointIndex, idx);
+        lastModifiedPointIndex = idx;
+      }
+    }
+  }
+  else
+  {
+    // Number of points changed, recompute all values
+    this->CurvatureCache.CurveIsClosed = this->CurveIsClosed;
+    this->CurvatureCache.Curvatures.assign(numberOfPoints, 0.0);
+    this->CurvatureCache.Lengths.assign(numberOfPoints, 0.0);
+  }
+  this->CurvatureCache.Points.swap(curvePoints);
+}
+
+//------------------------------------------------------------------------------
+bool vtkCurveMeasurementsCalculator::GetModifiedCurvePointRangeFromControlPoints(vtkPolyData* polyData,
+  vtkIdList* linePoints, vtkIdType numberOfPoints, vtkIdType& firstModifiedPointIndex, vtkIdType& lastModifiedPointIndex)
+{
+  vtkMRMLMarkupsCurveNode* curveNode = vtkMRMLMarkupsCurveNode::SafeDownCast(this->InputMarkupsMRMLNode);
+  if (!curveNode)
+  {
+    return false;
+  }
+
+  // Number of control points on each side of a moved control point whose curve segments may change
+  int controlPointSupportRadius = -1;
+  int curveType = curveNode->GetCurveType();
+  if (curveType == vtkCurveGenerator::CURVE_TYPE_LINEAR_SPLINE)
+  {
+    controlPointSupportRadius = 1;
+  }
+  else if (curveType == vtkCurveGenerator::CURVE_TYPE_KOCHANEK_SPLINE)
+  {
+    controlPointSupportRadius = 2;
+  }
+  // Curve points are projected to the surface or transformed individually
+  vtkMRMLTransformNode* transformNode = curveNode->GetParentTransformNode();
+  if (curveNode->GetSurfaceConstraintNode() || (transformNode && !transformNode->IsTransformToWorldLinear()))
+  {
+    controlPointSupportRadius = -1;
+  }
+
+  int numberOfControlPoints = curveNode->GetNumberOfControlPoints();
+  std::vector<double> controlPoints(3 * numberOfControlPoints);
+  for (int controlPointIndex = 0; controlPointIndex < numberOfControlPoints; ++controlPointIndex)
+  {
+    curveNode->GetNthControlPointPositionWorld(controlPointIndex, controlPoints.data() + 3 * controlPointIndex);
+  }
+  bool cacheValid = this->CurvatureCache.CurveIsClosed == this->CurveIsClosed
+    && this->CurvatureCache.CurveType == curveType
+    && this->CurvatureCache.ControlPoints.size() == controlPoints.size()
+    && this->CurvatureCache.Points.size() == static_cast<size_t>(3 * numberOfPoints);
+  this->CurvatureCache.ControlPoints.swap(controlPoints);
+  this->CurvatureCache.CurveType = curveType;
+  vtkDoubleArray* pedigreeIdsArray = vtkDoubleArray::SafeDownCast(polyData->GetPointData()->GetAbstractArray("PedigreeIDs"));
+  if (!cacheValid || controlPointSupportRadius < 0 || !pedigreeIdsArray
+    || pedigreeIdsArray->GetNumberOfTuples() != polyData->GetNumberOfPoints())
+  {
+    return false;
+  }
+
+  // Find moved control points
+  int firstModifiedControlPointIndex = numberOfControlPoints;
+  int lastModifiedControlPointIndex = -1;
+  for (int controlPointIndex = 0; controlPointIndex < numberOfControlPoints; ++controlPointIndex)
+  {
+    const double* newPosition = this->CurvatureCache.ControlPoints.data() + 3 * controlPointIndex;
+    const double* oldPosition = controlPoints.data() + 3 * controlPointIndex;
+    if (newPosition[0] != oldPosition[0] || newPosition[1] != oldPosition[1] || newPosition[2] != oldPosition[2])
+    {
+      firstModifiedControlPointIndex = std::min(firstModifiedControlPointIndex, controlPointIndex);
+      lastModifiedControlPointIndex = controlPointIndex;
+    }
+  }
+  if (lastModifiedControlPointIndex < 0)
+  {
+    // Control points did not move, curve points are unchanged
+    firstModifiedPointIndex = numberOfPoints;
+    lastModifiedPointIndex = -1;
+    return true;
+  }
+
+  // Range of pedigree IDs (control point index and fraction of the segment) of curve points that may have moved
+  double firstPedigreeId = firstModifiedControlPointIndex - controlPointSupportRadius;
+  double lastPedigreeId = lastModifiedControlPointIndex + controlPointSupportRadius;
+  if (this->CurveIsClosed && (firstPedigreeId < 0 || lastPedigreeId > numberOfControlPoints))
+  {
+    // Modified region wraps around the start of the closed curve
+    return false;
+  }
+
+  // Pedigree IDs are increasing along the curve, find the range by binary search
+  auto pedigreeIdAt = [pedigreeIdsArray, linePoints](vtkIdType idx) { return pedigreeIdsArray->GetValue(linePoints->GetId(idx)); };
+  vtkIdType low = 0;
+  vtkIdType high = numberOfPoints;
+  while (low < high)
+  {
+    vtkIdType middle = low + (high - low) / 2;
+    if (pedigreeIdAt(middle) < firstPedigreeId)
+    {
+      low = middle + 1;
+    }
+    else
+    {
+      high = middle;
+    }
+  }
+  firstModifiedPointIndex = low;
+  high = numberOfPoints;
+  while (low < high)
+  {
+    vtkIdType middle = low + (high - low) / 2;
+    if (pedigreeIdAt(middle) <= lastPedigreeId)
+    {
+      low = middle + 1;
+    }
+    else
+    {
+      high = middle;
+    }
+  }
+  lastModifiedPointIndex = low - 1;
+  return true;
+}
+
 //------------------------------------------------------------------------------
 bool vtkCurveMeasurementsCalculator::CalculatePolyDataTorsion(vtkPolyData* polyData)
 {
@@ -20,11 +20,16 @@
 
 // VTK includes
 #include <vtkCollection.h>
+#include <vtkDoubleArray.h>
 #include <vtkPolyData.h>
 #include <vtkPolyDataAlgorithm.h>
 #include <vtkSetGet.h>
+#include <vtkSmartPointer.h>
 #include <vtkWeakPointer.h>
 
+// STL includes
+#include <vector>
+
 // Markups MRML includes
 #include <vtkMRMLMarkupsNode.h>
 
@@ -32,6 +37,7 @@
 #include "vtkMRMLExport.h"
 
 class vtkCallbackCommand;
+class vtkIdList;
 
 /// Filter that calculates per-curve-point measurements for markups curves.
 /// - Interpolate control point measurements into curve point data
@@ -108,6 +114,20 @@ protected:
   bool CalculatePolyDataTorsion(vtkPolyData* polyData);
   bool InterpolateControlPointMeasurementToPolyData(vtkPolyData* outputPolyData);
 
+  /// Store curve point positions (in line order) in the curvature cache and get the range of points
+  /// that have changed since the last curvature calculation. If the number of points changed
+  /// then the entire range is returned.
+  void UpdateCurvatureCachePoints(vtkPoints* points, vtkIdList* linePoints, vtkIdType numberOfPoints,
+    vtkIdType& firstModifiedPointIndex, vtkIdType& lastModifiedPointIndex);
+
+  /// Get the range of curve points (in line order) that may have changed since the last curvature
+  /// calculation from the control points that moved, without comparing all curve points.
+  /// Only curve types where a control point only influences nearby curve points are supported
+  /// (linear and Kochanek spline, without surface constraint or non-linear parent transform).
+  /// Returns false if the range cannot be determined this way.
+  bool GetModifiedCurvePointRangeFromControlPoints(vtkPolyData* polyData, vtkIdList* linePoints,
+    vtkIdType numberOfPoints, vtkIdType& firstModifiedPointIndex, vtkIdType& lastModifiedPointIndex);
+
   /// Callback function observing data array modified events.
   /// If a data array to interpolate is modified, then the interpolation needs to be re-run.
   static void OnControlPointArrayModified(vtkObject* caller, unsigned long eid, void* clientData, void* callData);
@@ -130,6 +150,27 @@ protected:
   /// List of observed control point arrays (for removal of observations)
   vtkCollection* ObservedControlPointArrays;
 
+  /// Curve points and per-point curvature values from the last calculation.
+  /// Allows recomputing curvature only around the points that moved.
+  struct CurvatureCacheType
+  {
+    bool CurveIsClosed{false};
+    std::vector<double> Points;
+    std::vector<double> Curvatures;
+    /// Length of the curve section that belongs to each point (weight of the point's curvature in the mean)
+    std::vector<double> Lengths;
+    /// Control point positions (world) and curve type used for finding the modified curve points
+    std::vector<double> ControlPoints;
+    int CurveType{-1};
+    /// Running statistics of the inner curve points, updated when curvature of a point changes
+    double WeightedCurvatureSum{0.0};
+    double Length{0.0};
+    double MaxCurvature{0.0};
+    /// Curvature values of the last output, only values of modified points are updated
+    vtkSmartPointer<vtkDoubleArray> CurvatureValues;
+  };
+  CurvatureCacheType CurvatureCache;
+
   std::string CurvatureUnits{"mm-1"};
   std::string TorsionUnits{"mm-1"};
 
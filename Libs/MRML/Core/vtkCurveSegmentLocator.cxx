@@ -0,0 +1,534 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkCurveSegmentLocator.h"
+
+// VTK includes
+#include <vtkIdList.h>
+#include <vtkMath.h>
+#include <vtkObjectFactory.h>
+#include <vtkPoints.h>
+
+// STL includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+//----------------------------------------------------------------------------
+double BoundsDistance2(const double bounds[6], const double pos[3])
+{
+  double distance2 = 0.0;
+  for (int i = 0; i < 3; i++)
+  {
+    double delta = 0.0;
+    if (pos[i] < bounds[2 * i])
+    {
+      delta = bounds[2 * i] - pos[i];
+    }
+    else if (pos[i] > bounds[2 * i + 1])
+    {
+      delta = pos[i] - bounds[2 * i + 1];
+    }
+    distance2 += delta * delta;
+  }
+  return distance2;
+}
+
+//----------------------------------------------------------------------------
+double BoundsMaximumDistance2(const double bounds[6], const double pos[3])
+{
+  double distance2 = 0.0;
+  for (int i = 0; i < 3; i++)
+  {
+    double delta = std::max(std::fabs(pos[i] - bounds[2 * i]), std::fabs(pos[i] - bounds[2 * i + 1]));
+    distance2 += delta * delta;
+  }
+  return distance2;
+}
+
+//----------------------------------------------------------------------------
+/// Compute squared distance of pos from the line segment p0-p1
+/// and the parametric coordinate of the closest point (clamped to [0, 1]).
+double SegmentDistance2(const double pos[3], const double p0[3], const double p1[3], double& t, double closestPos[3])
+{
+  double direction[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+  double length2 = vtkMath::Dot(direction, direction);
+  t = 0.0;
+  if (length2 > 0.0)
+  {
+    double relativePos[3] = { pos[0] - p0[0], pos[1] - p0[1], pos[2] - p0[2] };
+    t = vtkMath::Dot(relativePos, direction) / length2;
+    t = std::min(1.0, std::max(0.0, t));
+  }
+  for (int i = 0; i < 3; i++)
+  {
+    closestPos[i] = p0[i] + t * direction[i];
+  }
+  return vtkMath::Distance2BetweenPoints(pos, closestPos);
+}
+} // namespace
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkCurveSegmentLocator);
+
+//----------------------------------------------------------------------------
+vtkCurveSegmentLocator::vtkCurveSegmentLocator() = default;
+
+//----------------------------------------------------------------------------
+vtkCurveSegmentLocator::~vtkCurveSegmentLocator() = default;
+
+//----------------------------------------------------------------------------
+void vtkCurveSegmentLocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "CurveClosed: " << this->CurveClosed << std::endl;
+  os << indent << "NumberOfSegmentsPerLeaf: " << this->NumberOfSegmentsPerLeaf << std::endl;
+  os << indent << "NumberOfTreeNodes: " << this->Nodes.size() << std::endl;
+}
+
+//----------------------------------------------------------------------------
+void vtkCurveSegmentLocator::SetPoints(vtkPoints* points)
+{
+  if (this->Points == points)
+  {
+    return;
+  }
+  this->Points = points;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkPoints* vtkCurveSegmentLocator::GetPoints()
+{
+  return this->Points;
+}
+
+//----------------------------------------------------------------------------
+void vtkCurveSegmentLocator::FreeSearchStructure()
+{
+  this->PointCoordinates.clear();
+  this->CumulativeLengths.clear();
+  this->SegmentIds.clear();
+  this->Nodes.clear();
+  this->BuildTime = vtkTimeStamp();
+}
+
+//----------------------------------------------------------------------------
+void vtkCurveSegmentLocator::BuildLocator()
+{
+  vtkMTimeType buildTime = this->BuildTime.GetMTime();
+  if (buildTime > 0 && buildTime > this->GetMTime()
+    && (!this->Points || buildTime > this->Points->GetMTime()))
+  {
+    // up-to-date
+    return;
+  }
+  this->FreeSearchStructure();
+  this->BuildTime.Modified();
+
+  vtkIdType numberOfPoints = this->Points ? this->Points->GetNumberOfPoints() : 0;
+  if (numberOfPoints < 1)
+  {
+    return;
+  }
+  this->PointCoordinates.resize(3 * numberOfPoints);
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+  {
+    this->Points->GetPoint(pointIndex, &this->PointCoordinates[3 * pointIndex]);
+  }
+
+  vtkIdType numberOfSegments = this->GetNumberOfSegments();
+  this->CumulativeLengths.resize(numberOfSegments + 1);
+  this->CumulativeLengths[0] = 0.0;
+  this->SegmentIds.resize(numberOfSegments);
+  std::vector<double> segmentCenters(3 * numberOfSegments);
+  for (vtkIdType segmentIndex = 0; segmentIndex < numberOfSegments; segmentIndex++)
+  {
+    const double* startPoint = nullptr;
+    const double* endPoint = nullptr;
+    this->GetSegmentEndPoints(segmentIndex, startPoint, endPoint);
+    this->CumulativeLengths[segmentIndex + 1] = this->CumulativeLengths[segmentIndex]
+      + sqrt(vtkMath::Distance2BetweenPoints(startPoint, endPoint));
+    for (int i = 0; i < 3; i++)
+    {
+      segmentCenters[3 * segmentIndex + i] = 0.5 * (startPoint[i] + endPoint[i]);
+    }
+    this->SegmentIds[segmentIndex] = segmentIndex;
+  }
+
+  if (numberOfSegments > 0)
+  {
+    this->Nodes.reserve(2 * (numberOfSegments / this->NumberOfSegmentsPerLeaf + 1));
+    this->BuildNode(0, numberOfSegments, segmentCenters);
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkCurveSegmentLocator::BuildNode(vtkIdType firstSegment, vtkIdType numberOfSegments, const std::vector<double>& segmentCenters)
+{
+  int nodeIndex = static_cast<int>(this->Nodes.size());
+  this->Nodes.emplace_back();
+  TreeNode node;
+  node.FirstSegment = firstSegment;
+  node.NumberOfSegments = numberOfSegments;
+  node.Bounds[0] = node.Bounds[2] = node.Bounds[4] = VTK_DOUBLE_MAX;
+  node.Bounds[1] = node.Bounds[3] = node.Bounds[5] = VTK_DOUBLE_MIN;
+  double centerBounds[6] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+  for (vtkIdType i = firstSegment; i < firstSegment + numberOfSegments; i++)
+  {
+    vtkIdType segmentIndex = this->SegmentIds[i];
+    const double* startPoint = nullptr;
+    const double* endPoint = nullptr;
+    this->GetSegmentEndPoints(segmentIndex, startPoint, endPoint);
+    for (int axis = 0; axis < 3; axis++)
+    {
+      node.Bounds[2 * axis] = std::min(node.Bounds[2 * axis], std::min(startPoint[axis], endPoint[axis]));
+      node.Bounds[2 * axis + 1] = std::max(node.Bounds[2 * axis + 1], std::max(startPoint[axis], endPoint[axis]));
+      centerBounds[2 * axis] = std::min(centerBounds[2 * axis], segmentCenters[3 * segmentIndex + axis]);
+      centerBounds[2 * axis + 1] = std::max(centerBounds[2 * axis + 1], segmentCenters[3 * segmentIndex + axis]);
+    }
+  }
+
+  if (numberOfSegments > this->NumberOfSegmentsPerLeaf)
+  {
+    // Split at the median segment center along the longest axis
+    int splitAxis = 0;
+    for (int axis = 1; axis < 3; axis++)
+    {
+      if (centerBounds[2 * axis + 1] - centerBounds[2 * axis] > centerBounds[2 * splitAxis + 1] - centerBounds[2 * splitAxis])
+      {
+        splitAxis = axis;
+      }
+    }
+    vtkIdType numberOfLeftSegments = numberOfSegments / 2;
+    std::nth_element(this->SegmentIds.begin() + firstSegment,
+      this->SegmentIds.begin() + firstSegment + numberOfLeftSegments,
+      this->SegmentIds.begin() + firstSegment + numberOfSegments,
+      [&segmentCenters, splitAxis](vtkIdType a, vtkIdType b)
+      {
+        double centerA = segmentCenters[3 * a + splitAxis];
+        double centerB = segmentCenters[3 * b + splitAxis];
+        // Compare segment indices for equal centers to make the tree independent from the sorting implementation
+        return centerA < centerB || (centerA == centerB && a < b);
+      });
+    node.Children[0] = this->BuildNode(firstSegment, numberOfLeftSegments, segmentCenters);
+    node.Children[1] = this->BuildNode(firstSegment + numberOfLeftSegments, numberOfSegments - numberOfLeftSegments, segmentCenters);
+  }
+
+  // Nodes vector may have been reallocated by the recursive calls, therefore the node is only stored now
+  this->Nodes[nodeIndex] = node;
+  return nodeIndex;
+}
+
+//----------------------------------------------------------------------------
+void vtkCurveSegmentLocator::GetSegmentEndPoints(vtkIdType segmentIndex, const double*& startPoint, const double*& endPoint) const
+{
+  vtkIdType numberOfPoints = static_cast<vtkIdType>(this->PointCoordinates.size() / 3);
+  startPoint = &this->PointCoordinates[3 * segmentIndex];
+  endPoint = &this->PointCoordinates[3 * ((segmentIndex + 1) % numberOfPoints)];
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCurveSegmentLocator::GetNumberOfSegments()
+{
+  vtkIdType numberOfPoints = this->Points ? this->Points->GetNumberOfPoints() : 0;
+  if (numberOfPoints < 2)
+  {
+    return 0;
+  }
+  return this->CurveClosed ? numberOfPoints : numberOfPoints - 1;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCurveSegmentLocator::FindClosestSegment(const double pos[3], double closestPos[3],
+  double& parametricCoordinate, double& distance2)
+{
+  this->BuildLocator();
+  distance2 = VTK_DOUBLE_MAX;
+  parametricCoordinate = 0.0;
+  if (this->Nodes.empty())
+  {
+    return -1;
+  }
+
+  vtkIdType closestSegmentIndex = -1;
+  std::vector<int> nodeStack;
+  nodeStack.push_back(0);
+  while (!nodeStack.empty())
+  {
+    const TreeNode& node = this->Nodes[nodeStack.back()];
+    nodeStack.pop_back();
+    if (BoundsDistance2(node.Bounds, pos) > distance2)
+    {
+      continue;
+    }
+    if (node.Children[0] < 0)
+    {
+      for (vtkIdType i = node.FirstSegment; i < node.FirstSegment + node.NumberOfSegments; i++)
+      {
+        vtkIdType segmentIndex = this->SegmentIds[i];
+        const double* startPoint = nullptr;
+        const double* endPoint = nullptr;
+        this->GetSegmentEndPoints(segmentIndex, startPoint, endPoint);
+        double t = 0.0;
+        double segmentClosestPos[3] = { 0.0, 0.0, 0.0 };
+        double segmentDistance2 = SegmentDistance2(pos, startPoint, endPoint, t, segmentClosestPos);
+        if (segmentDistance2 < distance2 || (segmentDistance2 == distance2 && segmentIndex < closestSegmentIndex))
+        {
+          distance2 = segmentDistance2;
+          parametricCoordinate = t;
+          closestSegmentIndex = segmentIndex;
+          closestPos[0] = segmentClosestPos[0];
+          closestPos[1] = segmentClosestPos[1];
+          closestPos[2] = segmentClosestPos[2];
+        }
+      }
+      continue;
+    }
+    // Push the farther child first so that the nearer one is visited first
+    double childDistance2[2] =
+    {
+      BoundsDistance2(this->Nodes[node.Children[0]].Bounds, pos),
+      BoundsDistance2(this->Nodes[node.Children[1]].Bounds, pos)
+    };
+    int nearChild = (childDistance2[0] <= childDistance2[1]) ? 0 : 1;
+    nodeStack.push_back(node.Children[1 - nearChild]);
+    nodeStack.push_back(node.Children[nearChild]);
+  }
+  return closestSegmentIndex;
+}
+
+//----------------------------------------------------------------------------
+double vtkCurveSegmentLocator::GetCurveLengthAtSegmentPosition(vtkIdType segmentIndex, double parametricCoordinate)
+{
+  this->BuildLocator();
+  if (segmentIndex < 0 || segmentIndex + 1 >= static_cast<vtkIdType>(this->CumulativeLengths.size()))
+  {
+    return -1.0;
+  }
+  double segmentStartLength = this->CumulativeLengths[segmentIndex];
+  double segmentLength = this->CumulativeLengths[segmentIndex + 1] - segmentStartLength;
+  return segmentStartLength + std::min(1.0, std::max(0.0, parametricCoordinate)) * segmentLength;
+}
+
+//----------------------------------------------------------------------------
+double vtkCurveSegmentLocator::GetCurveLengthAtClosestPosition(const double pos[3], double closestPos[3]/*=nullptr*/)
+{
+  double foundClosestPos[3] = { 0.0, 0.0, 0.0 };
+  double parametricCoordinate = 0.0;
+  double distance2 = 0.0;
+  vtkIdType segmentIndex = this->FindClosestSegment(pos, foundClosestPos, parametricCoordinate, distance2);
+  if (segmentIndex < 0)
+  {
+    return -1.0;
+  }
+  if (closestPos)
+  {
+    closestPos[0] = foundClosestPos[0];
+    closestPos[1] = foundClosestPos[1];
+    closestPos[2] = foundClosestPos[2];
+  }
+  return this->GetCurveLengthAtSegmentPosition(segmentIndex, parametricCoordinate);
+}
+
+//----------------------------------------------------------------------------
+double vtkCurveSegmentLocator::GetCurveLength()
+{
+  this->BuildLocator();
+  if (this->CumulativeLengths.empty())
+  {
+    return 0.0;
+  }
+  return this->CumulativeLengths.back();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCurveSegmentLocator::FindFarthestPoint(const double pos[3])
+{
+  this->BuildLocator();
+  vtkIdType numberOfPoints = static_cast<vtkIdType>(this->PointCoordinates.size() / 3);
+  if (numberOfPoints < 1)
+  {
+    return -1;
+  }
+  vtkIdType farthestPointIndex = 0;
+  double farthestDistance2 = vtkMath::Distance2BetweenPoints(pos, &this->PointCoordinates[0]);
+  if (this->Nodes.empty())
+  {
+    return farthestPointIndex;
+  }
+
+  std::vector<int> nodeStack;
+  nodeStack.push_back(0);
+  while (!nodeStack.empty())
+  {
+    const TreeNode& node = this->Nodes[nodeStack.back()];
+    nodeStack.pop_back();
+    // Points may be at the same distance as the current farthest point and have lower index,
+    // therefore nodes are only skipped if they are strictly closer.
+    if (BoundsMaximumDistance2(node.Bounds, pos) < farthestDistance2)
+    {
+      continue;
+    }
+    if (node.Children[0] < 0)
+    {
+      for (vtkIdType i = node.FirstSegment; i < node.FirstSegment + node.NumberOfSegments; i++)
+      {
+        // The farthest point of a segment is one of its end points
+        vtkIdType segmentIndex = this->SegmentIds[i];
+        vtkIdType endPointIndices[2] = { segmentIndex, (segmentIndex + 1) % numberOfPoints };
+        for (vtkIdType pointIndex : endPointIndices)
+        {
+          double distance2 = vtkMath::Distance2BetweenPoints(pos, &this->PointCoordinates[3 * pointIndex]);
+          if (distance2 > farthestDistance2 || (distance2 == farthestDistance2 && pointIndex < farthestPointIndex))
+          {
+            farthestDistance2 = distance2;
+            farthestPointIndex = pointIndex;
+          }
+        }
+      }
+      continue;
+    }
+    double childDistance2[2] =
+    {
+      BoundsMaximumDistance2(this->Nodes[node.Children[0]].Bounds, pos),
+      BoundsMaximumDistance2(this->Nodes[node.Children[1]].Bounds, pos)
+    };
+    int farChild = (childDistance2[0] >= childDistance2[1]) ? 0 : 1;
+    nodeStack.push_back(node.Children[1 - farChild]);
+    nodeStack.push_back(node.Children[farChild]);
+  }
+  return farthestPointIndex;
+}
+
+//----------------------------------------------------------------------------
+void vtkCurveSegmentLocator::IntersectWithPlane(const double origin[3], const double normal[3],
+  vtkPoints* intersectionPoints, vtkIdList* segmentIds/*=nullptr*/)
+{
+  if (!intersectionPoints)
+  {
+    vtkErrorMacro("IntersectWithPlane failed: invalid intersectionPoints");
+    return;
+  }
+  intersectionPoints->Reset();
+  if (segmentIds)
+  {
+    segmentIds->Reset();
+  }
+  this->BuildLocator();
+  if (this->Nodes.empty())
+  {
+    return;
+  }
+
+  // Collect intersected segments
+  std::vector<vtkIdType> intersectedSegmentIds;
+  std::vector<int> nodeStack;
+  nodeStack.push_back(0);
+  while (!nodeStack.empty())
+  {
+    const TreeNode& node = this->Nodes[nodeStack.back()];
+    nodeStack.pop_back();
+    // Skip the node if its bounding box is entirely on one side of the plane
+    double centerDistance = 0.0;
+    double radius = 0.0;
+    for (int axis = 0; axis < 3; axis++)
+    {
+      double center = 0.5 * (node.Bounds[2 * axis] + node.Bounds[2 * axis + 1]);
+      double halfSize = 0.5 * (node.Bounds[2 * axis + 1] - node.Bounds[2 * axis]);
+      centerDistance += normal[axis] * (center - origin[axis]);
+      radius += std::fabs(normal[axis]) * halfSize;
+    }
+    if (centerDistance - radius > 0.0 || centerDistance + radius < 0.0)
+    {
+      continue;
+    }
+    if (node.Children[0] < 0)
+    {
+      intersectedSegmentIds.insert(intersectedSegmentIds.end(),
+        this->SegmentIds.begin() + node.FirstSegment, this->SegmentIds.begin() + node.FirstSegment + node.NumberOfSegments);
+      continue;
+    }
+    nodeStack.push_back(node.Children[0]);
+    nodeStack.push_back(node.Children[1]);
+  }
+
+  // Compute intersection points in the order of segments along the curve
+  std::sort(intersectedSegmentIds.begin(), intersectedSegmentIds.end());
+  double previousIntersectionPoint[3] = { 0.0, 0.0, 0.0 };
+  bool previousIntersectionPointValid = false;
+  double firstIntersectionPoint[3] = { 0.0, 0.0, 0.0 };
+  for (vtkIdType segmentIndex : intersectedSegmentIds)
+  {
+    const double* startPoint = nullptr;
+    const double* endPoint = nullptr;
+    this->GetSegmentEndPoints(segmentIndex, startPoint, endPoint);
+    double startDistance = vtkMath::Dot(normal, startPoint) - vtkMath::Dot(normal, origin);
+    double endDistance = vtkMath::Dot(normal, endPoint) - vtkMath::Dot(normal, origin);
+    if ((startDistance > 0.0 && endDistance > 0.0) || (startDistance < 0.0 && endDistance < 0.0))
+    {
+      continue;
+    }
+    double intersectionPoint[3] = { 0.0, 0.0, 0.0 };
+    if (startDistance == 0.0)
+    {
+      // segment starts on the plane (or lies entirely in the plane)
+      std::copy(startPoint, startPoint + 3, intersectionPoint);
+    }
+    else if (endDistance == 0.0)
+    {
+      std::copy(endPoint, endPoint + 3, intersectionPoint);
+    }
+    else
+    {
+      double t = startDistance / (startDistance - endDistance);
+      for (int i = 0; i < 3; i++)
+      {
+        intersectionPoint[i] = startPoint[i] + t * (endPoint[i] - startPoint[i]);
+      }
+    }
+    // Curve points on the plane are shared by two segments, only add them once
+    if (previousIntersectionPointValid
+      && intersectionPoint[0] == previousIntersectionPoint[0]
+      && intersectionPoint[1] == previousIntersectionPoint[1]
+      && intersectionPoint[2] == previousIntersectionPoint[2])
+    {
+      continue;
+    }
+    if (this->CurveClosed && segmentIndex == this->GetNumberOfSegments() - 1 && intersectionPoints->GetNumberOfPoints() > 0
+      && intersectionPoint[0] == firstIntersectionPoint[0]
+      && intersectionPoint[1] == firstIntersectionPoint[1]
+      && intersectionPoint[2] == firstIntersectionPoint[2])
+    {
+      // the first point of a closed curve is shared by the first and last segments
+      continue;
+    }
+    if (intersectionPoints->GetNumberOfPoints() == 0)
+    {
+      std::copy(intersectionPoint, intersectionPoint + 3, firstIntersectionPoint);
+    }
+    intersectionPoints->InsertNextPoint(intersectionPoint);
+    if (segmentIds)
+    {
+      segmentIds->InsertNextId(segmentIndex);
+    }
+    std::copy(intersectionPoint, intersectionPoint + 3, previousIntersectionPoint);
+    previousIntersectionPointValid = true;
+  }
+}
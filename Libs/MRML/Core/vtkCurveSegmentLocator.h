@@ -0,0 +1,148 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkCurveSegmentLocator_h
+#define __vtkCurveSegmentLocator_h
+
+// VTK includes
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimeStamp.h>
+
+// STL includes
+#include <vector>
+
+// Export
+#include "vtkMRMLExport.h"
+
+class vtkIdList;
+class vtkPoints;
+
+/// \brief Spatial index over the line segments of a curve polyline.
+///
+/// The locator builds a bounding volume hierarchy (axis-aligned bounding box tree)
+/// over the segments connecting consecutive curve points and caches cumulative
+/// curve length at each point. Closest segment, curve length at a position,
+/// farthest point, and plane crossing queries then only visit the tree nodes that
+/// may contain the result instead of iterating through all the curve points.
+///
+/// The search structure is rebuilt automatically on the next query when the points
+/// are modified or the curve closed state changes.
+class VTK_MRML_EXPORT vtkCurveSegmentLocator : public vtkObject
+{
+public:
+  static vtkCurveSegmentLocator* New();
+  vtkTypeMacro(vtkCurveSegmentLocator, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Set/Get curve points. Consecutive points are connected by line segments.
+  void SetPoints(vtkPoints* points);
+  vtkPoints* GetPoints();
+
+  //@{
+  /// If enabled then the last point is connected to the first point by an additional segment.
+  vtkSetMacro(CurveClosed, bool);
+  vtkGetMacro(CurveClosed, bool);
+  vtkBooleanMacro(CurveClosed, bool);
+  //@}
+
+  //@{
+  /// Maximum number of segments stored in a leaf node of the tree.
+  vtkSetClampMacro(NumberOfSegmentsPerLeaf, int, 1, 1024);
+  vtkGetMacro(NumberOfSegmentsPerLeaf, int);
+  //@}
+
+  /// Build the search structure if the points or settings changed since the last build.
+  /// Queries call this method automatically.
+  void BuildLocator();
+
+  /// Release the search structure.
+  void FreeSearchStructure();
+
+  /// Get number of line segments. Segment i connects point i with point i+1
+  /// (the last segment of a closed curve connects the last point with the first point).
+  vtkIdType GetNumberOfSegments();
+
+  /// Find the closest position on the curve.
+  /// \param pos input position
+  /// \param closestPos output closest position on the curve
+  /// \param parametricCoordinate output position within the found segment (0.0 = segment start point, 1.0 = segment end point)
+  /// \param distance2 output squared distance between pos and closestPos
+  /// \return index of the found segment, -1 if the curve has no segments.
+  vtkIdType FindClosestSegment(const double pos[3], double closestPos[3], double& parametricCoordinate, double& distance2);
+
+  /// Get curve length from the first curve point to the specified position within a segment.
+  /// \return -1 in case of an error
+  double GetCurveLengthAtSegmentPosition(vtkIdType segmentIndex, double parametricCoordinate);
+
+  /// Get curve length from the first curve point to the closest position on the curve.
+  /// \param closestPos optional output, closest position on the curve
+  /// \return -1 in case of an error
+  double GetCurveLengthAtClosestPosition(const double pos[3], double closestPos[3]=nullptr);
+
+  /// Get total length of the curve (including the closing segment of closed curves).
+  double GetCurveLength();
+
+  /// Get index of the farthest curve point from the specified position.
+  /// If multiple points are at the same distance then the lowest point index is returned.
+  /// \return -1 if there are no points
+  vtkIdType FindFarthestPoint(const double pos[3]);
+
+  /// Get intersection points of the curve with the plane, ordered along the curve.
+  /// \param origin plane origin
+  /// \param normal plane normal
+  /// \param intersectionPoints output points, the previous content is removed
+  /// \param segmentIds optional output, index of the intersected segment for each intersection point
+  void IntersectWithPlane(const double origin[3], const double normal[3], vtkPoints* intersectionPoints, vtkIdList* segmentIds=nullptr);
+
+protected:
+  vtkCurveSegmentLocator();
+  ~vtkCurveSegmentLocator() override;
+  vtkCurveSegmentLocator(const vtkCurveSegmentLocator&) = delete;
+  void operator=(const vtkCurveSegmentLocator&) = delete;
+
+  struct TreeNode
+  {
+    double Bounds[6];
+    /// Range of segments in SegmentIds (for leaf nodes)
+    vtkIdType FirstSegment{0};
+    vtkIdType NumberOfSegments{0};
+    /// Child node indices, -1 for leaf nodes
+    int Children[2]{-1, -1};
+  };
+
+  int BuildNode(vtkIdType firstSegment, vtkIdType numberOfSegments, const std::vector<double>& segmentCenters);
+  void GetSegmentEndPoints(vtkIdType segmentIndex, const double*& startPoint, const double*& endPoint) const;
+
+protected:
+  vtkSmartPointer<vtkPoints> Points;
+  bool CurveClosed{false};
+  int NumberOfSegmentsPerLeaf{8};
+
+  /// Copy of the point coordinates (x0, y0, z0, x1, y1, z1, ...)
+  std::vector<double> PointCoordinates;
+  /// Curve length from the first point at each point. For closed curves the last
+  /// value is the length of the entire curve, including the closing segment.
+  std::vector<double> CumulativeLengths;
+  /// Segment indices, grouped by leaf nodes
+  std::vector<vtkIdType> SegmentIds;
+  std::vector<TreeNode> Nodes;
+
+  vtkTimeStamp BuildTime;
+};
+
+#endif
@@ -0,0 +1,1394 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLChunkedVolumeStorageNode.h"
+#include "vtkMRMLI18N.h"
+#include "vtkMRMLMessageCollection.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLVolumeChunkCache.h"
+
+// rapidjson includes
+#include <rapidjson/document.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+// VTK includes
+#include <vtkAlgorithm.h>
+#include <vtkAlgorithmOutput.h>
+#include <vtkByteSwap.h>
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+#include <vtkStringArray.h>
+#include <vtkWeakPointer.h>
+#include <vtk_zlib.h>
+
+// VTKsys includes
+#include <vtksys/FStream.hxx>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+//----------------------------------------------------------------------------
+vtkMRMLNodeNewMacro(vtkMRMLChunkedVolumeStorageNode);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Zarr data type string of a VTK scalar type, in host byte order.
+// Returns empty string if the type is not supported.
+std::string GetZarrDataType(int scalarType)
+{
+#ifdef VTK_WORDS_BIGENDIAN
+  const std::string byteOrder = ">";
+#else
+  const std::string byteOrder = "<";
+#endif
+  switch (scalarType)
+  {
+    case VTK_UNSIGNED_CHAR: return "|u1";
+    case VTK_CHAR:
+    case VTK_SIGNED_CHAR: return "|i1";
+    case VTK_UNSIGNED_SHORT: return byteOrder + "u2";
+    case VTK_SHORT: return byteOrder + "i2";
+    case VTK_UNSIGNED_INT: return byteOrder + "u4";
+    case VTK_INT: return byteOrder + "i4";
+    case VTK_UNSIGNED_LONG: return byteOrder + (sizeof(unsigned long) == 8 ? "u8" : "u4");
+    case VTK_LONG: return byteOrder + (sizeof(long) == 8 ? "i8" : "i4");
+    case VTK_UNSIGNED_LONG_LONG: return byteOrder + "u8";
+    case VTK_LONG_LONG: return byteOrder + "i8";
+    case VTK_FLOAT: return byteOrder + "f4";
+    case VTK_DOUBLE: return byteOrder + "f8";
+    default: return "";
+  }
+}
+
+//----------------------------------------------------------------------------
+bool ParseZarrDataType(const std::string& dataType, int& scalarType, bool& swapBytes)
+{
+  if (dataType.size() != 3)
+  {
+    return false;
+  }
+  const std::string type = dataType.substr(1);
+  if (type == "u1") { scalarType = VTK_UNSIGNED_CHAR; }
+  else if (type == "i1") { scalarType = VTK_SIGNED_CHAR; }
+  else if (type == "u2") { scalarType = VTK_UNSIGNED_SHORT; }
+  else if (type == "i2") { scalarType = VTK_SHORT; }
+  else if (type == "u4") { scalarType = VTK_UNSIGNED_INT; }
+  else if (type == "i4") { scalarType = VTK_INT; }
+  else if (type == "u8") { scalarType = VTK_UNSIGNED_LONG_LONG; }
+  else if (type == "i8") { scalarType = VTK_LONG_LONG; }
+  else if (type == "f4") { scalarType = VTK_FLOAT; }
+  else if (type == "f8") { scalarType = VTK_DOUBLE; }
+  else
+  {
+    return false;
+  }
+#ifdef VTK_WORDS_BIGENDIAN
+  swapBytes = (dataType[0] == '<');
+#else
+  swapBytes = (dataType[0] == '>');
+#endif
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool ReadFileContent(const std::string& fileName, std::vector<char>& content)
+{
+  vtksys::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  if (!file.is_open())
+  {
+    return false;
+  }
+  file.seekg(0, std::ios::end);
+  std::streamoff size = file.tellg();
+  file.seekg(0, std::ios::beg);
+  content.resize(static_cast<size_t>(size));
+  if (size > 0)
+  {
+    file.read(content.data(), size);
+  }
+  return !file.fail();
+}
+
+//----------------------------------------------------------------------------
+bool WriteFileContent(const std::string& fileName, const char* content, size_t size)
+{
+  vtksys::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file.is_open())
+  {
+    return false;
+  }
+  file.write(content, size);
+  file.close();
+  return !file.fail();
+}
+
+//----------------------------------------------------------------------------
+bool ReadJsonFile(const std::string& fileName, rapidjson::Document& document)
+{
+  std::vector<char> content;
+  if (!ReadFileContent(fileName, content))
+  {
+    return false;
+  }
+  content.push_back('\0');
+  document.Parse(content.data());
+  return !document.HasParseError() && document.IsObject();
+}
+
+//----------------------------------------------------------------------------
+// Decompress a zlib (or gzip) stream into a buffer of known size.
+bool Inflate(const std::vector<char>& compressed, char* output, size_t outputSize, bool gzip)
+{
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  if (inflateInit2(&stream, gzip ? 16 + MAX_WBITS : MAX_WBITS) != Z_OK)
+  {
+    return false;
+  }
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+  stream.avail_in = static_cast<uInt>(compressed.size());
+  stream.next_out = reinterpret_cast<Bytef*>(output);
+  stream.avail_out = static_cast<uInt>(outputSize);
+  int result = inflate(&stream, Z_FINISH);
+  size_t decompressedSize = static_cast<size_t>(stream.total_out);
+  inflateEnd(&stream);
+  return result == Z_STREAM_END && decompressedSize == outputSize;
+}
+
+//----------------------------------------------------------------------------
+// Compute lower resolution voxels by averaging (or picking) voxels of the parent region.
+// The parent region starts at the parent voxel that corresponds to the first output voxel.
+template <class T>
+void DownsampleRegion(vtkImageData* parentRegion, const int factors[3], bool pickFirst,
+  const int outputSize[3], const int chunkSize[3], T* output)
+{
+  int* parentExtent = parentRegion->GetExtent();
+  for (int k = 0; k < outputSize[2]; ++k)
+  {
+    for (int j = 0; j < outputSize[1]; ++j)
+    {
+      T* outputRow = output + (static_cast<vtkIdType>(k) * chunkSize[1] + j) * chunkSize[0];
+      for (int i = 0; i < outputSize[0]; ++i)
+      {
+        int parentStart[3] = { parentExtent[0] + i * factors[0], parentExtent[2] + j * factors[1], parentExtent[4] + k * factors[2] };
+        if (pickFirst)
+        {
+          outputRow[i] = *static_cast<T*>(parentRegion->GetScalarPointer(parentStart));
+          continue;
+        }
+        double sum = 0.0;
+        int count = 0;
+        for (int pk = parentStart[2]; pk < parentStart[2] + factors[2] && pk <= parentExtent[5]; ++pk)
+        {
+          for (int pj = parentStart[1]; pj < parentStart[1] + factors[1] && pj <= parentExtent[3]; ++pj)
+          {
+            for (int pi = parentStart[0]; pi < parentStart[0] + factors[0] && pi <= parentExtent[1]; ++pi)
+            {
+              sum += static_cast<double>(*static_cast<T*>(parentRegion->GetScalarPointer(pi, pj, pk)));
+              ++count;
+            }
+          }
+        }
+        double mean = sum / count;
+        if (std::numeric_limits<T>::is_integer)
+        {
+          mean = std::floor(mean + 0.5);
+        }
+        outputRow[i] = static_cast<T>(mean);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+bool IsAllZero(const char* buffer, size_t size)
+{
+  for (size_t i = 0; i < size; ++i)
+  {
+    if (buffer[i] != 0)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+class vtkMRMLChunkedVolumeStorageNode::vtkInternal
+{
+public:
+  /// Resolution level of a chunked volume. Vectors are in I, J, K order.
+  struct ResolutionLevel
+  {
+    std::string Path;
+    int Dimensions[3]{ 0, 0, 0 };
+    int ChunkSize[3]{ 0, 0, 0 };
+    /// Number of dimensions before K (for example, time and channel) - all of them must have size 1
+    int NumberOfLeadingDimensions{ 0 };
+    int ScalarType{ VTK_VOID };
+    bool SwapBytes{ false };
+    std::string Compressor;
+    double FillValue{ 0.0 };
+    std::string DimensionSeparator{ "." };
+    /// Size of a voxel of this level, in level 0 voxels
+    double Factors[3]{ 1.0, 1.0, 1.0 };
+    /// Position of the first voxel of this level, in level 0 voxel coordinates
+    double Offsets[3]{ 0.0, 0.0, 0.0 };
+  };
+
+  vtkInternal()
+  {
+    this->ChunkCache = vtkSmartPointer<vtkMRMLVolumeChunkCache>::New();
+  }
+
+  std::string GetChunkFileName(const std::string& directory, const ResolutionLevel& level, const int chunkIndex[3]) const;
+  vtkSmartPointer<vtkDataArray> ReadChunk(const std::string& directory, const ResolutionLevel& level,
+    const int chunkIndex[3], std::string& errorMessage) const;
+  bool ReadRegion(const std::string& directory, const ResolutionLevel& level, const int extent[6],
+    vtkImageData* region, vtkMRMLVolumeChunkCache* cache, int levelIndex, std::string& errorMessage) const;
+  bool ReadMetadata(const std::string& directory, std::string& errorMessage);
+  bool WriteLevelMetadata(const std::string& directory, const ResolutionLevel& level) const;
+  bool WriteMultiscalesMetadata(const std::string& directory) const;
+  void GetLevelToLevel0Matrix(int level, vtkMatrix4x4* levelToLevel0) const;
+
+  /// Location of the last read or written volume
+  std::string Directory;
+  std::vector<ResolutionLevel> Levels;
+  /// Level 0 IJK to RAS
+  vtkNew<vtkMatrix4x4> IJKToRAS;
+  /// Downsampling method stored in the metadata (mean, nearest)
+  std::string DownsamplingType{ "mean" };
+
+  int PreviewLevel{ -1 };
+  vtkWeakPointer<vtkImageData> PreviewImageData;
+  vtkWeakPointer<vtkDataArray> PreviewScalars;
+  vtkMTimeType PreviewScalarsMTime{ 0 };
+
+  vtkSmartPointer<vtkMRMLVolumeChunkCache> ChunkCache;
+};
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLChunkedVolumeStorageNode::vtkInternal::GetChunkFileName(
+  const std::string& directory, const ResolutionLevel& level, const int chunkIndex[3]) const
+{
+  std::stringstream fileName;
+  fileName << directory << "/" << level.Path << "/";
+  for (int dimension = 0; dimension < level.NumberOfLeadingDimensions; ++dimension)
+  {
+    fileName << "0" << level.DimensionSeparator;
+  }
+  fileName << chunkIndex[2] << level.DimensionSeparator << chunkIndex[1] << level.DimensionSeparator << chunkIndex[0];
+  return fileName.str();
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkDataArray> vtkMRMLChunkedVolumeStorageNode::vtkInternal::ReadChunk(
+  const std::string& directory, const ResolutionLevel& level, const int chunkIndex[3], std::string& errorMessage) const
+{
+  vtkSmartPointer<vtkDataArray> voxels = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(level.ScalarType));
+  vtkIdType numberOfVoxels = static_cast<vtkIdType>(level.ChunkSize[0]) * level.ChunkSize[1] * level.ChunkSize[2];
+  voxels->SetNumberOfTuples(numberOfVoxels);
+  std::string fileName = this->GetChunkFileName(directory, level, chunkIndex);
+  if (!vtksys::SystemTools::FileExists(fileName, true))
+  {
+    // chunks that only contain the fill value are not stored
+    voxels->Fill(level.FillValue);
+    return voxels;
+  }
+  std::vector<char> content;
+  if (!ReadFileContent(fileName, content))
+  {
+    errorMessage = "Failed to read chunk file: " + fileName;
+    return nullptr;
+  }
+  int scalarSize = voxels->GetDataTypeSize();
+  size_t chunkDataSize = static_cast<size_t>(numberOfVoxels) * scalarSize;
+  char* chunkData = static_cast<char*>(voxels->GetVoidPointer(0));
+  if (level.Compressor.empty())
+  {
+    if (content.size() != chunkDataSize)
+    {
+      errorMessage = "Unexpected chunk file size: " + fileName;
+      return nullptr;
+    }
+    memcpy(chunkData, content.data(), chunkDataSize);
+  }
+  else if (!Inflate(content, chunkData, chunkDataSize, level.Compressor == "gzip"))
+  {
+    errorMessage = "Failed to decompress chunk file: " + fileName;
+    return nullptr;
+  }
+  if (level.SwapBytes)
+  {
+    vtkByteSwap::SwapVoidRange(chunkData, numberOfVoxels, scalarSize);
+  }
+  return voxels;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLChunkedVolumeStorageNode::vtkInternal::ReadRegion(const std::string& directory, const ResolutionLevel& level,
+  const int extent[6], vtkImageData* region, vtkMRMLVolumeChunkCache* cache, int levelIndex, std::string& errorMessage) const
+{
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    if (extent[axis * 2] < 0 || extent[axis * 2 + 1] >= level.Dimensions[axis] || extent[axis * 2] > extent[axis * 2 + 1])
+    {
+      errorMessage = "Requested region is outside the resolution level";
+      return false;
+    }
+  }
+  region->SetOrigin(0.0, 0.0, 0.0);
+  region->SetSpacing(1.0, 1.0, 1.0);
+  region->SetExtent(const_cast<int*>(extent));
+  region->AllocateScalars(level.ScalarType, 1);
+  int scalarSize = region->GetScalarSize();
+
+  int chunkRange[6] = { 0 };
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    chunkRange[axis * 2] = extent[axis * 2] / level.ChunkSize[axis];
+    chunkRange[axis * 2 + 1] = extent[axis * 2 + 1] / level.ChunkSize[axis];
+  }
+  int chunkIndex[3] = { 0 };
+  for (chunkIndex[2] = chunkRange[4]; chunkIndex[2] <= chunkRange[5]; ++chunkIndex[2])
+  {
+    for (chunkIndex[1] = chunkRange[2]; chunkIndex[1] <= chunkRange[3]; ++chunkIndex[1])
+    {
+      for (chunkIndex[0] = chunkRange[0]; chunkIndex[0] <= chunkRange[1]; ++chunkIndex[0])
+      {
+        vtkSmartPointer<vtkDataArray> voxels = (cache ? cache->GetChunk(directory, levelIndex, chunkIndex) : nullptr);
+        if (!voxels)
+        {
+          voxels = this->ReadChunk(directory, level, chunkIndex, errorMessage);
+          if (!voxels)
+          {
+            return false;
+          }
+          if (cache)
+          {
+            cache->AddChunk(directory, levelIndex, chunkIndex, voxels);
+          }
+        }
+        const char* chunkData = static_cast<const char*>(voxels->GetVoidPointer(0));
+        int chunkOrigin[3] = { 0 };
+        int copyExtent[6] = { 0 };
+        for (int axis = 0; axis < 3; ++axis)
+        {
+          chunkOrigin[axis] = chunkIndex[axis] * level.ChunkSize[axis];
+          copyExtent[axis * 2] = std::max(extent[axis * 2], chunkOrigin[axis]);
+          copyExtent[axis * 2 + 1] = std::min(extent[axis * 2 + 1], chunkOrigin[axis] + level.ChunkSize[axis] - 1);
+        }
+        size_t rowSize = static_cast<size_t>(copyExtent[1] - copyExtent[0] + 1) * scalarSize;
+        for (int k = copyExtent[4]; k <= copyExtent[5]; ++k)
+        {
+          for (int j = copyExtent[2]; j <= copyExtent[3]; ++j)
+          {
+            vtkIdType chunkOffset = (static_cast<vtkIdType>(k - chunkOrigin[2]) * level.ChunkSize[1] + (j - chunkOrigin[1]))
+              * level.ChunkSize[0] + (copyExtent[0] - chunkOrigin[0]);
+            memcpy(region->GetScalarPointer(copyExtent[0], j, k), chunkData + chunkOffset * scalarSize, rowSize);
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLChunkedVolumeStorageNode::vtkInternal::ReadMetadata(const std::string& directory, std::string& errorMessage)
+{
+  this->Levels.clear();
+  this->Directory = directory;
+
+  rapidjson::Document attributes;
+  if (!ReadJsonFile(directory + "/.zattrs", attributes))
+  {
+    errorMessage = "Failed to read attributes file: " + directory + "/.zattrs";
+    return false;
+  }
+  if (!attributes.HasMember("multiscales") || !attributes["multiscales"].IsArray()
+    || attributes["multiscales"].Empty() || !attributes["multiscales"][0].HasMember("datasets")
+    || !attributes["multiscales"][0]["datasets"].IsArray())
+  {
+    errorMessage = "Multiscales datasets are not found in attributes file: " + directory + "/.zattrs";
+    return false;
+  }
+  rapidjson::Value& multiscales = attributes["multiscales"][0];
+  this->DownsamplingType = "mean";
+  if (multiscales.HasMember("type") && multiscales["type"].IsString())
+  {
+    this->DownsamplingType = multiscales["type"].GetString();
+  }
+
+  // Scale and translation of each level, in I, J, K order
+  std::vector<std::vector<double>> levelScales;
+  std::vector<std::vector<double>> levelTranslations;
+  for (rapidjson::Value& dataset : multiscales["datasets"].GetArray())
+  {
+    if (!dataset.HasMember("path") || !dataset["path"].IsString())
+    {
+      errorMessage = "Dataset path is missing";
+      return false;
+    }
+    ResolutionLevel level;
+    level.Path = dataset["path"].GetString();
+
+    rapidjson::Document arrayMetadata;
+    std::string arrayMetadataFileName = directory + "/" + level.Path + "/.zarray";
+    if (!ReadJsonFile(arrayMetadataFileName, arrayMetadata))
+    {
+      errorMessage = "Failed to read array metadata file: " + arrayMetadataFileName;
+      return false;
+    }
+    if (!arrayMetadata.HasMember("shape") || !arrayMetadata["shape"].IsArray()
+      || !arrayMetadata.HasMember("chunks") || !arrayMetadata["chunks"].IsArray()
+      || arrayMetadata["shape"].Size() < 3 || arrayMetadata["shape"].Size() != arrayMetadata["chunks"].Size()
+      || !arrayMetadata.HasMember("dtype") || !arrayMetadata["dtype"].IsString())
+    {
+      errorMessage = "Invalid array metadata: " + arrayMetadataFileName;
+      return false;
+    }
+    rapidjson::Value& shape = arrayMetadata["shape"];
+    rapidjson::Value& chunks = arrayMetadata["chunks"];
+    int numberOfDimensions = static_cast<int>(shape.Size());
+    level.NumberOfLeadingDimensions = numberOfDimensions - 3;
+    for (int dimension = 0; dimension < numberOfDimensions; ++dimension)
+    {
+      if (!shape[dimension].IsUint64() || !chunks[dimension].IsUint64() || chunks[dimension].GetUint64() == 0)
+      {
+        errorMessage = "Invalid array shape or chunks: " + arrayMetadataFileName;
+        return false;
+      }
+      if (dimension < level.NumberOfLeadingDimensions)
+      {
+        if (shape[dimension].GetUint64() != 1)
+        {
+          errorMessage = "Only single-component, single-timepoint arrays are supported: " + arrayMetadataFileName;
+          return false;
+        }
+        continue;
+      }
+      // Zarr stores dimensions in z, y, x order
+      int axis = numberOfDimensions - 1 - dimension;
+      if (shape[dimension].GetUint64() > static_cast<uint64_t>(VTK_INT_MAX)
+        || chunks[dimension].GetUint64() > static_cast<uint64_t>(VTK_INT_MAX))
+      {
+        errorMessage = "Array is too large: " + arrayMetadataFileName;
+        return false;
+      }
+      level.Dimensions[axis] = static_cast<int>(shape[dimension].GetUint64());
+      level.ChunkSize[axis] = static_cast<int>(chunks[dimension].GetUint64());
+    }
+    if (!ParseZarrDataType(arrayMetadata["dtype"].GetString(), level.ScalarType, level.SwapBytes))
+    {
+      errorMessage = std::string("Unsupported data type: ") + arrayMetadata["dtype"].GetString();
+      return false;
+    }
+    if (arrayMetadata.HasMember("order") && arrayMetadata["order"].IsString()
+      && std::string(arrayMetadata["order"].GetString()) != "C")
+    {
+      errorMessage = "Only C order arrays are supported: " + arrayMetadataFileName;
+      return false;
+    }
+    if (arrayMetadata.HasMember("filters") && !arrayMetadata["filters"].IsNull())
+    {
+      errorMessage = "Array filters are not supported: " + arrayMetadataFileName;
+      return false;
+    }
+    if (arrayMetadata.HasMember("compressor") && arrayMetadata["compressor"].IsObject())
+    {
+      rapidjson::Value& compressor = arrayMetadata["compressor"];
+      level.Compressor = (compressor.HasMember("id") && compressor["id"].IsString() ? compressor["id"].GetString() : "");
+      if (level.Compressor != "zlib" && level.Compressor != "gzip")
+      {
+        errorMessage = "Unsupported compressor '" + level.Compressor + "': " + arrayMetadataFileName;
+        return false;
+      }
+    }
+    if (arrayMetadata.HasMember("fill_value"))
+    {
+      rapidjson::Value& fillValue = arrayMetadata["fill_value"];
+      if (fillValue.IsNumber())
+      {
+        level.FillValue = fillValue.GetDouble();
+      }
+      else if (fillValue.IsString() && std::string(fillValue.GetString()) == "NaN")
+      {
+        level.FillValue = std::numeric_limits<double>::quiet_NaN();
+      }
+    }
+    if (arrayMetadata.HasMember("dimension_separator") && arrayMetadata["dimension_separator"].IsString())
+    {
+      level.DimensionSeparator = arrayMetadata["dimension_separator"].GetString();
+    }
+
+    std::vector<double> scale(3, 1.0);
+    std::vector<double> translation(3, 0.0);
+    if (dataset.HasMember("coordinateTransformations") && dataset["coordinateTransformations"].IsArray())
+    {
+      for (rapidjson::Value& transform : dataset["coordinateTransformations"].GetArray())
+      {
+        if (!transform.HasMember("type") || !transform["type"].IsString())
+        {
+          continue;
+        }
+        std::string transformType = transform["type"].GetString();
+        if (!transform.HasMember(transformType.c_str()) || !transform[transformType.c_str()].IsArray()
+          || static_cast<int>(transform[transformType.c_str()].Size()) != numberOfDimensions)
+        {
+          continue;
+        }
+        rapidjson::Value& values = transform[transformType.c_str()];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+          double value = values[numberOfDimensions - 1 - axis].GetDouble();
+          if (transformType == "scale")
+          {
+            scale[axis] = value;
+          }
+          else if (transformType == "translation")
+          {
+            translation[axis] = value;
+          }
+        }
+      }
+    }
+    levelScales.push_back(scale);
+    levelTranslations.push_back(translation);
+    this->Levels.push_back(level);
+  }
+  if (this->Levels.empty())
+  {
+    errorMessage = "No resolution levels are found in " + directory;
+    return false;
+  }
+
+  for (size_t levelIndex = 0; levelIndex < this->Levels.size(); ++levelIndex)
+  {
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      double level0Scale = (levelScales[0][axis] != 0.0 ? levelScales[0][axis] : 1.0);
+      this->Levels[levelIndex].Factors[axis] = levelScales[levelIndex][axis] / level0Scale;
+      this->Levels[levelIndex].Offsets[axis] = (levelTranslations[levelIndex][axis] - levelTranslations[0][axis]) / level0Scale;
+    }
+  }
+
+  // Geometry of level 0. OME-Zarr does not store axis directions, the exact geometry is stored
+  // in Slicer-specific attributes. If it is not available then axes are assumed to be LPS.
+  this->IJKToRAS->Identity();
+  if (attributes.HasMember("slicer") && attributes["slicer"].IsObject()
+    && attributes["slicer"].HasMember("ijkToRAS") && attributes["slicer"]["ijkToRAS"].IsArray()
+    && attributes["slicer"]["ijkToRAS"].Size() == 16)
+  {
+    rapidjson::Value& ijkToRAS = attributes["slicer"]["ijkToRAS"];
+    for (int row = 0; row < 4; ++row)
+    {
+      for (int column = 0; column < 4; ++column)
+      {
+        this->IJKToRAS->SetElement(row, column, ijkToRAS[row * 4 + column].GetDouble());
+      }
+    }
+  }
+  else
+  {
+    const double lpsToRAS[3] = { -1.0, -1.0, 1.0 };
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      this->IJKToRAS->SetElement(axis, axis, lpsToRAS[axis] * levelScales[0][axis]);
+      this->IJKToRAS->SetElement(axis, 3, lpsToRAS[axis] * levelTranslations[0][axis]);
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLChunkedVolumeStorageNode::vtkInternal::WriteLevelMetadata(const std::string& directory, const ResolutionLevel& level) const
+{
+  rapidjson::StringBuffer buffer;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+  writer.StartObject();
+  writer.Key("zarr_format");
+  writer.Int(2);
+  writer.Key("shape");
+  writer.StartArray();
+  for (int axis = 2; axis >= 0; --axis)
+  {
+    writer.Int(level.Dimensions[axis]);
+  }
+  writer.EndArray();
+  writer.Key("chunks");
+  writer.StartArray();
+  for (int axis = 2; axis >= 0; --axis)
+  {
+    writer.Int(level.ChunkSize[axis]);
+  }
+  writer.EndArray();
+  writer.Key("dtype");
+  writer.String(GetZarrDataType(level.ScalarType).c_str());
+  writer.Key("compressor");
+  if (level.Compressor.empty())
+  {
+    writer.Null();
+  }
+  else
+  {
+    writer.StartObject();
+    writer.Key("id");
+    writer.String(level.Compressor.c_str());
+    writer.Key("level");
+    writer.Int(1);
+    writer.EndObject();
+  }
+  writer.Key("fill_value");
+  writer.Int(0);
+  writer.Key("order");
+  writer.String("C");
+  writer.Key("filters");
+  writer.Null();
+  writer.Key("dimension_separator");
+  writer.String(level.DimensionSeparator.c_str());
+  writer.EndObject();
+  return WriteFileContent(directory + "/" + level.Path + "/.zarray", buffer.GetString(), buffer.GetSize());
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLChunkedVolumeStorageNode::vtkInternal::WriteMultiscalesMetadata(const std::string& directory) const
+{
+  // OME-Zarr coordinates are scaled voxel coordinates (axis directions are not stored),
+  // origin is stored in LPS coordinate system.
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  const double rasToLPS[3] = { -1.0, -1.0, 1.0 };
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    double column[3] = { this->IJKToRAS->GetElement(0, axis), this->IJKToRAS->GetElement(1, axis), this->IJKToRAS->GetElement(2, axis) };
+    spacing[axis] = std::sqrt(column[0] * column[0] + column[1] * column[1] + column[2] * column[2]);
+    origin[axis] = rasToLPS[axis] * this->IJKToRAS->GetElement(axis, 3);
+  }
+
+  rapidjson::StringBuffer buffer;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+  writer.StartObject();
+  writer.Key("multiscales");
+  writer.StartArray();
+  writer.StartObject();
+  writer.Key("version");
+  writer.String("0.4");
+  writer.Key("axes");
+  writer.StartArray();
+  for (const char* axisName : { "z", "y", "x" })
+  {
+    writer.StartObject();
+    writer.Key("name");
+    writer.String(axisName);
+    writer.Key("type");
+    writer.String("space");
+    writer.Key("unit");
+    writer.String("millimeter");
+    writer.EndObject();
+  }
+  writer.EndArray();
+  writer.Key("datasets");
+  writer.StartArray();
+  for (const ResolutionLevel& level : this->Levels)
+  {
+    writer.StartObject();
+    writer.Key("path");
+    writer.String(level.Path.c_str());
+    writer.Key("coordinateTransformations");
+    writer.StartArray();
+    writer.StartObject();
+    writer.Key("type");
+    writer.String("scale");
+    writer.Key("scale");
+    writer.StartArray();
+    for (int axis = 2; axis >= 0; --axis)
+    {
+      writer.Double(spacing[axis] * level.Factors[axis]);
+    }
+    writer.EndArray();
+    writer.EndObject();
+    writer.StartObject();
+    writer.Key("type");
+    writer.String("translation");
+    writer.Key("translation");
+    writer.StartArray();
+    for (int axis = 2; axis >= 0; --axis)
+    {
+      writer.Double(origin[axis] + spacing[axis] * level.Offsets[axis]);
+    }
+    writer.EndArray();
+    writer.EndObject();
+    writer.EndArray();
+    writer.EndObject();
+  }
+  writer.EndArray();
+  writer.Key("type");
+  writer.String(this->DownsamplingType.c_str());
+  writer.EndObject();
+  writer.EndArray();
+  writer.Key("slicer");
+  writer.StartObject();
+  writer.Key("ijkToRAS");
+  writer.StartArray();
+  for (int row = 0; row < 4; ++row)
+  {
+    for (int column = 0; column < 4; ++column)
+    {
+      writer.Double(this->IJKToRAS->GetElement(row, column));
+    }
+  }
+  writer.EndArray();
+  writer.EndObject();
+  writer.EndObject();
+  if (!WriteFileContent(directory + "/.zattrs", buffer.GetString(), buffer.GetSize()))
+  {
+    return false;
+  }
+  const std::string groupMetadata = "{\n    \"zarr_format\": 2\n}";
+  return WriteFileContent(directory + "/.zgroup", groupMetadata.c_str(), groupMetadata.size());
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLChunkedVolumeStorageNode::vtkInternal::GetLevelToLevel0Matrix(int level, vtkMatrix4x4* levelToLevel0) const
+{
+  levelToLevel0->Identity();
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    levelToLevel0->SetElement(axis, axis, this->Levels[level].Factors[axis]);
+    levelToLevel0->SetElement(axis, 3, this->Levels[level].Offsets[axis]);
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLChunkedVolumeStorageNode::vtkMRMLChunkedVolumeStorageNode()
+{
+  this->ChunkSize[0] = 64;
+  this->ChunkSize[1] = 64;
+  this->ChunkSize[2] = 64;
+  this->NumberOfLevelsToWrite = 0;
+  this->MaximumNumberOfPreviewVoxels = 16 * 1024 * 1024;
+  this->DefaultWriteFileExtension = "zarr";
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLChunkedVolumeStorageNode::~vtkMRMLChunkedVolumeStorageNode()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLChunkedVolumeStorageNode::WriteXML(ostream& of, int nIndent)
+{
+  Superclass::WriteXML(of, nIndent);
+  vtkMRMLWriteXMLBeginMacro(of);
+  vtkMRMLWriteXMLVectorMacro(chunkSize, ChunkSize, int, 3);
+  vtkMRMLWriteXMLIntMacro(numberOfLevelsToWrite, NumberOfLevelsToWrite);
+  vtkMRMLWriteXMLEndMacro();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLChunkedVolumeStorageNode::ReadXMLAttributes(const char** atts)
+{
+  int disabledModify = this->StartModify();
+  Superclass::ReadXMLAttributes(atts);
+  vtkMRMLReadXMLBeginMacro(atts);
+  vtkMRMLReadXMLVectorMacro(chunkSize, ChunkSize, int, 3);
+  vtkMRMLReadXMLIntMacro(numberOfLevelsToWrite, NumberOfLevelsToWrite);
+  vtkMRMLReadXMLEndMacro();
+  this->EndModify(disabledModify);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLChunkedVolumeStorageNode::CopyContent(vtkMRMLNode* anode, bool deepCopy/*=true*/)
+{
+  MRMLNodeModifyBlocker blocker(this);
+  Superclass::CopyContent(anode, deepCopy);
+  vtkMRMLCopyBeginMacro(anode);
+  vtkMRMLCopyVectorMacro(ChunkSize, int, 3);
+  vtkMRMLCopyIntMacro(NumberOfLevelsToWrite);
+  vtkMRMLCopyEndMacro();
+  vtkMRMLChunkedVolumeStorageNode* node = vtkMRMLChunkedVolumeStorageNode::SafeDownCast(anode);
+  if (node)
+  {
+    this->SetMaximumNumberOfPreviewVoxels(node->GetMaximumNumberOfPreviewVoxels());
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLChunkedVolumeStorageNode::PrintSelf(ostream& os, vtkIndent indent)
+{
+  Superclass::PrintSelf(os, indent);
+  vtkMRMLPrintBeginMacro(os, indent);
+  vtkMRMLPrintVectorMacro(ChunkSize, int, 3);
+  vtkMRMLPrintIntMacro(NumberOfLevelsToWrite);
+  vtkMRMLPrintEndMacro();
+  os << indent << "MaximumNumberOfPreviewVoxels: " << this->MaximumNumberOfPreviewVoxels << "\n";
+  os << indent << "NumberOfResolutionLevels: " << this->Internal->Levels.size() << "\n";
+  os << indent << "PreviewResolutionLevel: " << this->Internal->PreviewLevel << "\n";
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLChunkedVolumeStorageNode::CanReadInReferenceNode(vtkMRMLNode* refNode)
+{
+  return refNode->IsA("vtkMRMLScalarVolumeNode");
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLChunkedVolumeStorageNode::CanWriteFromReferenceNode(vtkMRMLNode* refNode)
+{
+  vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(refNode);
+  if (!volumeNode)
+  {
+    return false;
+  }
+  vtkImageData* imageData = volumeNode->GetImageData();
+  return imageData == nullptr || imageData->GetNumberOfScalarComponents() == 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLChunkedVolumeStorageNode::InitializeSupportedReadFileTypes()
+{
+  this->SupportedReadFileTypes->InsertNextValue("OME-Zarr multi-resolution volume (.zarr)");
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLChunkedVolumeStorageNode::InitializeSupportedWriteFileTypes()
+{
+  this->SupportedWriteFileTypes->InsertNextValue("OME-Zarr multi-resolution volume (.zarr)");
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLChunkedVolumeStorageNode::SetChunkCache(vtkMRMLVolumeChunkCache* chunkCache)
+{
+  if (this->Internal->ChunkCache == chunkCache)
+  {
+    return;
+  }
+  this->Internal->ChunkCache = chunkCache;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLVolumeChunkCache* vtkMRMLChunkedVolumeStorageNode::GetChunkCache()
+{
+  return this->Internal->ChunkCache;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLChunkedVolumeStorageNode::GetNumberOfResolutionLevels()
+{
+  return static_cast<int>(this->Internal->Levels.size());
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLChunkedVolumeStorageNode::GetResolutionLevelDimensions(int level, int dimensions[3])
+{
+  if (level < 0 || level >= this->GetNumberOfResolutionLevels())
+  {
+    return false;
+  }
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    dimensions[axis] = this->Internal->Levels[level].Dimensions[axis];
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLChunkedVolumeStorageNode::GetPreviewResolutionLevel()
+{
+  return this->Internal->PreviewLevel;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLChunkedVolumeStorageNode::GetPreviewIJKToLevelIJKMatrix(int level, vtkMatrix4x4* previewIJKToLevelIJK)
+{
+  if (!previewIJKToLevelIJK || level < 0 || level >= this->GetNumberOfResolutionLevels() || this->Internal->PreviewLevel < 0)
+  {
+    return false;
+  }
+  vtkNew<vtkMatrix4x4> previewToLevel0;
+  this->Internal->GetLevelToLevel0Matrix(this->Internal->PreviewLevel, previewToLevel0);
+  vtkNew<vtkMatrix4x4> level0ToLevel;
+  this->Internal->GetLevelToLevel0Matrix(level, level0ToLevel);
+  level0ToLevel->Invert();
+  vtkMatrix4x4::Multiply4x4(level0ToLevel, previewToLevel0, previewIJKToLevelIJK);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLChunkedVolumeStorageNode::IsPreviewImageData(vtkImageData* imageData)
+{
+  if (!imageData || imageData != this->Internal->PreviewImageData.GetPointer() || this->Internal->PreviewLevel < 0)
+  {
+    return false;
+  }
+  vtkDataArray* scalars = imageData->GetPointData()->GetScalars();
+  int* extent = imageData->GetExtent();
+  const vtkMRMLChunkedVolumeStorageNode::vtkInternal::ResolutionLevel& level = this->Internal->Levels[this->Internal->PreviewLevel];
+  return scalars && scalars == this->Internal->PreviewScalars.GetPointer()
+    && scalars->GetMTime() == this->Internal->PreviewScalarsMTime
+    && extent[0] == 0 && extent[1] == level.Dimensions[0] - 1
+    && extent[2] == 0 && extent[3] == level.Dimensions[1] - 1
+    && extent[4] == 0 && extent[5] == level.Dimensions[2] - 1;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLChunkedVolumeStorageNode::ReadRegion(int level, const int extent[6], vtkImageData* region)
+{
+  if (!region || level < 0 || level >= this->GetNumberOfResolutionLevels())
+  {
+    vtkErrorMacro("ReadRegion failed: invalid region or resolution level " << level);
+    return false;
+  }
+  std::string errorMessage;
+  if (!this->Internal->ReadRegion(this->Internal->Directory, this->Internal->Levels[level], extent, region,
+    this->Internal->ChunkCache, level, errorMessage))
+  {
+    vtkErrorMacro("ReadRegion failed: " << errorMessage);
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLChunkedVolumeStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
+{
+  vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(refNode);
+  if (!volumeNode)
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLChunkedVolumeStorageNode::ReadDataInternal",
+      vtkMRMLI18N::Format(vtkMRMLTr("vtkMRMLChunkedVolumeStorageNode", "Cannot read chunked volume into node of class %1."),
+        refNode ? refNode->GetClassName() : "(null)"));
+    return 0;
+  }
+  std::string fullName = this->GetFullNameFromFileName();
+  if (fullName.empty() || !vtksys::SystemTools::FileIsDirectory(fullName))
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLChunkedVolumeStorageNode::ReadDataInternal",
+      vtkMRMLI18N::Format(vtkMRMLTr("vtkMRMLChunkedVolumeStorageNode", "Chunked volume directory not found: '%1'"), fullName.c_str()));
+    return 0;
+  }
+
+  // Content on disk may have changed since the last read
+  this->Internal->ChunkCache->RemoveChunks(this->Internal->Directory);
+  this->Internal->ChunkCache->RemoveChunks(fullName);
+  this->Internal->PreviewLevel = -1;
+  this->Internal->PreviewImageData = nullptr;
+
+  std::string errorMessage;
+  if (!this->Internal->ReadMetadata(fullName, errorMessage))
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLChunkedVolumeStorageNode::ReadDataInternal",
+      vtkMRMLI18N::Format(vtkMRMLTr("vtkMRMLChunkedVolumeStorageNode", "Failed to read chunked volume from '%1': %2"),
+      fullName.c_str(), errorMessage.c_str()));
+    return 0;
+  }
+
+  // Load the finest level that fits into the preview size limit (or the coarsest level)
+  int previewLevel = this->GetNumberOfResolutionLevels() - 1;
+  for (int level = 0; level < this->GetNumberOfResolutionLevels(); ++level)
+  {
+    const int* dimensions = this->Internal->Levels[level].Dimensions;
+    if (static_cast<vtkTypeInt64>(dimensions[0]) * dimensions[1] * dimensions[2] <= this->MaximumNumberOfPreviewVoxels)
+    {
+      previewLevel = level;
+      break;
+    }
+  }
+  const int* previewDimensions = this->Internal->Levels[previewLevel].Dimensions;
+  int previewExtent[6] = { 0, previewDimensions[0] - 1, 0, previewDimensions[1] - 1, 0, previewDimensions[2] - 1 };
+  vtkNew<vtkImageData> previewImageData;
+  // The preview is kept in the volume node, it is not added to the chunk cache
+  if (!this->Internal->ReadRegion(fullName, this->Internal->Levels[previewLevel], previewExtent, previewImageData,
+    nullptr, previewLevel, errorMessage))
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLChunkedVolumeStorageNode::ReadDataInternal",
+      vtkMRMLI18N::Format(vtkMRMLTr("vtkMRMLChunkedVolumeStorageNode", "Failed to read chunked volume from '%1': %2"),
+      fullName.c_str(), errorMessage.c_str()));
+    return 0;
+  }
+
+  vtkNew<vtkMatrix4x4> previewToLevel0;
+  this->Internal->GetLevelToLevel0Matrix(previewLevel, previewToLevel0);
+  vtkNew<vtkMatrix4x4> previewIJKToRAS;
+  vtkMatrix4x4::Multiply4x4(this->Internal->IJKToRAS, previewToLevel0, previewIJKToRAS);
+  volumeNode->SetIJKToRASMatrix(previewIJKToRAS);
+  volumeNode->SetAndObserveImageData(previewImageData);
+
+  this->Internal->PreviewLevel = previewLevel;
+  this->Internal->PreviewImageData = previewImageData.GetPointer();
+  this->Internal->PreviewScalars = previewImageData->GetPointData()->GetScalars();
+  this->Internal->PreviewScalarsMTime = this->Internal->PreviewScalars->GetMTime();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLChunkedVolumeStorageNode::WriteDataInternal(vtkMRMLNode* refNode)
+{
+  vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(refNode);
+  if (!volumeNode || !volumeNode->GetImageData())
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLChunkedVolumeStorageNode::WriteDataInternal",
+      vtkMRMLTr("vtkMRMLChunkedVolumeStorageNode", "Cannot write chunked volume: no image data is available."));
+    return 0;
+  }
+  std::string fullName = this->GetFullNameFromFileName();
+  if (fullName.empty())
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLChunkedVolumeStorageNode::WriteDataInternal",
+      vtkMRMLTr("vtkMRMLChunkedVolumeStorageNode", "Cannot write chunked volume: file name not specified."));
+    return 0;
+  }
+  vtkNew<vtkMatrix4x4> ijkToRAS;
+  volumeNode->GetIJKToRASMatrix(ijkToRAS);
+
+  if (this->IsPreviewImageData(volumeNode->GetImageData()))
+  {
+    // Voxels are unchanged since they were read, only the full-resolution data on disk has
+    // all the details. Copy the existing pyramid (if it is saved to a new location) and update the geometry.
+    if (!vtksys::SystemTools::SameFile(fullName, this->Internal->Directory))
+    {
+      vtksys::SystemTools::RemoveADirectory(fullName);
+      if (!vtksys::SystemTools::CopyADirectory(this->Internal->Directory, fullName).IsSuccess())
+      {
+        vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLChunkedVolumeStorageNode::WriteDataInternal",
+          vtkMRMLI18N::Format(vtkMRMLTr("vtkMRMLChunkedVolumeStorageNode", "Failed to copy chunked volume to '%1'"), fullName.c_str()));
+        return 0;
+      }
+      this->Internal->ChunkCache->RemoveChunks(this->Internal->Directory);
+      this->Internal->Directory = fullName;
+    }
+    vtkNew<vtkMatrix4x4> level0ToPreview;
+    this->Internal->GetLevelToLevel0Matrix(this->Internal->PreviewLevel, level0ToPreview);
+    level0ToPreview->Invert();
+    vtkMatrix4x4::Multiply4x4(ijkToRAS, level0ToPreview, this->Internal->IJKToRAS);
+    if (!this->Internal->WriteMultiscalesMetadata(fullName))
+    {
+      vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLChunkedVolumeStorageNode::WriteDataInternal",
+        vtkMRMLI18N::Format(vtkMRMLTr("vtkMRMLChunkedVolumeStorageNode", "Failed to write chunked volume metadata to '%1'"), fullName.c_str()));
+      return 0;
+    }
+    return 1;
+  }
+
+  vtkImageData* imageData = volumeNode->GetImageData();
+  if (this->Internal->PreviewLevel > 0 && !this->Internal->Directory.empty()
+    && vtksys::SystemTools::SameFile(fullName, this->Internal->Directory))
+  {
+    // Modified voxels of a low-resolution preview would replace the full-resolution levels
+    // that were read from this location, and the original resolution would be lost.
+    int dimensions[3] = { 0, 0, 0 };
+    imageData->GetDimensions(dimensions);
+    const int* level0Dimensions = this->Internal->Levels[0].Dimensions;
+    if (dimensions[0] != level0Dimensions[0] || dimensions[1] != level0Dimensions[1] || dimensions[2] != level0Dimensions[2])
+    {
+      vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLChunkedVolumeStorageNode::WriteDataInternal",
+        vtkMRMLI18N::Format(vtkMRMLTr("vtkMRMLChunkedVolumeStorageNode",
+          "Modified low-resolution preview cannot be saved to '%1' because it would overwrite the full-resolution volume."
+          " Save the volume to a different location."), fullName.c_str()));
+      return 0;
+    }
+  }
+  // The pyramid is written from the image data as is: if it is a modified preview then the
+  // full-resolution level of the new pyramid has the spacing of the preview.
+  if (!this->WritePyramid(volumeNode->GetImageDataConnection(), ijkToRAS, refNode->IsA("vtkMRMLLabelMapVolumeNode")))
+  {
+    return 0;
+  }
+  // The image data of the volume node is now level 0 of the written pyramid
+  this->Internal->PreviewLevel = 0;
+  this->Internal->PreviewImageData = imageData;
+  this->Internal->PreviewScalars = imageData->GetPointData()->GetScalars();
+  this->Internal->PreviewScalarsMTime = (this->Internal->PreviewScalars ? this->Internal->PreviewScalars->GetMTime() : 0);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLChunkedVolumeStorageNode::WritePyramid(vtkAlgorithmOutput* input, vtkMatrix4x4* ijkToRAS, bool labelMap/*=false*/)
+{
+  if (!input || !input->GetProducer() || !ijkToRAS)
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLChunkedVolumeStorageNode::WritePyramid",
+      vtkMRMLTr("vtkMRMLChunkedVolumeStorageNode", "Cannot write chunked volume: invalid input."));
+    return 0;
+  }
+  std::string fullName = this->GetFullNameFromFileName();
+  if (fullName.empty())
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLChunkedVolumeStorageNode::WritePyramid",
+      vtkMRMLTr("vtkMRMLChunkedVolumeStorageNode", "Cannot write chunked volume: file name not specified."));
+    return 0;
+  }
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    if (this->ChunkSize[axis] < 1)
+    {
+      vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLChunkedVolumeStorageNode::WritePyramid",
+        vtkMRMLTr("vtkMRMLChunkedVolumeStorageNode", "Cannot write chunked volume: invalid chunk size."));
+      return 0;
+    }
+  }
+
+  vtkAlgorithm* producer = input->GetProducer();
+  int port = input->GetIndex();
+  producer->UpdateInformation();
+  vtkInformation* outputInfo = producer->GetOutputInformation(port);
+  int wholeExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  outputInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExtent);
+  int scalarType = vtkImageData::GetScalarType(outputInfo);
+  if (wholeExtent[0] > wholeExtent[1] || wholeExtent[2] > wholeExtent[3] || wholeExtent[4] > wholeExtent[5])
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLChunkedVolumeStorageNode::WritePyramid",
+      vtkMRMLTr("vtkMRMLChunkedVolumeStorageNode", "Cannot write chunked volume: input image is empty."));
+    return 0;
+  }
+  if (vtkImageData::GetNumberOfScalarComponents(outputInfo) != 1 || GetZarrDataType(scalarType).empty())
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLChunkedVolumeStorageNode::WritePyramid",
+      vtkMRMLTr("vtkMRMLChunkedVolumeStorageNode", "Cannot write chunked volume: only single-component images of basic scalar types are supported."));
+    return 0;
+  }
+
+  // Replace any previous content. Metadata is written last, so an incomplete pyramid is not readable.
+  this->Internal->ChunkCache->RemoveChunks(this->Internal->Directory);
+  this->Internal->ChunkCache->RemoveChunks(fullName);
+  this->Internal->Levels.clear();
+  this->Internal->PreviewLevel = -1;
+  this->Internal->PreviewImageData = nullptr;
+  this->Internal->Directory = fullName;
+  this->Internal->DownsamplingType = (labelMap ? "nearest" : "mean");
+  if (vtksys::SystemTools::FileExists(fullName)
+    && (!vtksys::SystemTools::FileIsDirectory(fullName) || !vtksys::SystemTools::RemoveADirectory(fullName).IsSuccess()))
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLChunkedVolumeStorageNode::WritePyramid",
+      vtkMRMLI18N::Format(vtkMRMLTr("vtkMRMLChunkedVolumeStorageNode", "Cannot overwrite '%1'"), fullName.c_str()));
+    return 0;
+  }
+
+  // Level 0 geometry: first voxel of the whole extent
+  vtkNew<vtkMatrix4x4> extentToIJK;
+  extentToIJK->SetElement(0, 3, wholeExtent[0]);
+  extentToIJK->SetElement(1, 3, wholeExtent[2]);
+  extentToIJK->SetElement(2, 3, wholeExtent[4]);
+  vtkMatrix4x4::Multiply4x4(ijkToRAS, extentToIJK, this->Internal->IJKToRAS);
+
+  // Set up resolution levels
+  vtkInternal::ResolutionLevel level;
+  level.ScalarType = scalarType;
+  level.Compressor = (this->UseCompression ? "zlib" : "");
+  level.DimensionSeparator = "/";
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    level.Dimensions[axis] = wholeExtent[axis * 2 + 1] - wholeExtent[axis * 2] + 1;
+    level.ChunkSize[axis] = this->ChunkSize[axis];
+  }
+  while (true)
+  {
+    level.Path = std::to_string(this->Internal->Levels.size());
+    this->Internal->Levels.push_back(level);
+    bool fitsInOneChunk = (level.Dimensions[0] <= level.ChunkSize[0]
+      && level.Dimensions[1] <= level.ChunkSize[1] && level.Dimensions[2] <= level.ChunkSize[2]);
+    bool singleVoxel = (level.Dimensions[0] == 1 && level.Dimensions[1] == 1 && level.Dimensions[2] == 1);
+    int numberOfLevels = static_cast<int>(this->Internal->Levels.size());
+    if (singleVoxel
+      || (this->NumberOfLevelsToWrite > 0 && numberOfLevels >= this->NumberOfLevelsToWrite)
+      || (this->NumberOfLevelsToWrite <= 0 && fitsInOneChunk))
+    {
+      break;
+    }
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      // Axes that have a single voxel are not downsampled (for example, single-slice images)
+      int factor = (level.Dimensions[axis] > 1 ? 2 : 1);
+      level.Dimensions[axis] = (level.Dimensions[axis] + factor - 1) / factor;
+      // Voxel center is in the center of the averaged block of voxels, or at the picked voxel
+      level.Offsets[axis] += (labelMap ? 0.0 : level.Factors[axis] * (factor - 1) * 0.5);
+      level.Factors[axis] *= factor;
+    }
+  }
+
+  vtkImageData* inputImageData = nullptr;
+  std::string errorMessage;
+  for (int levelIndex = 0; levelIndex < static_cast<int>(this->Internal->Levels.size()); ++levelIndex)
+  {
+    const vtkInternal::ResolutionLevel& currentLevel = this->Internal->Levels[levelIndex];
+    std::string levelDirectory = fullName + "/" + currentLevel.Path;
+    if (!vtksys::SystemTools::MakeDirectory(levelDirectory).IsSuccess()
+      || !this->Internal->WriteLevelMetadata(fullName, currentLevel))
+    {
+      vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLChunkedVolumeStorageNode::WritePyramid",
+        vtkMRMLI18N::Format(vtkMRMLTr("vtkMRMLChunkedVolumeStorageNode", "Failed to write chunked volume to '%1'"), levelDirectory.c_str()));
+      return 0;
+    }
+    int factors[3] = { 1, 1, 1 };
+    if (levelIndex > 0)
+    {
+      const vtkInternal::ResolutionLevel& parentLevel = this->Internal->Levels[levelIndex - 1];
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        factors[axis] = static_cast<int>(currentLevel.Factors[axis] / parentLevel.Factors[axis] + 0.5);
+      }
+    }
+    int numberOfChunks[3] = { 0 };
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      numberOfChunks[axis] = (currentLevel.Dimensions[axis] + currentLevel.ChunkSize[axis] - 1) / currentLevel.ChunkSize[axis];
+    }
+    vtkSmartPointer<vtkDataArray> chunk = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(scalarType));
+    chunk->SetNumberOfTuples(static_cast<vtkIdType>(currentLevel.ChunkSize[0]) * currentLevel.ChunkSize[1] * currentLevel.ChunkSize[2]);
+    int scalarSize = chunk->GetDataTypeSize();
+    size_t chunkDataSize = static_cast<size_t>(chunk->GetNumberOfTuples()) * scalarSize;
+    char* chunkData = static_cast<char*>(chunk->GetVoidPointer(0));
+    std::vector<char> compressedData;
+
+    int chunkIndex[3] = { 0 };
+    for (chunkIndex[2] = 0; chunkIndex[2] < numberOfChunks[2]; ++chunkIndex[2])
+    {
+      for (chunkIndex[1] = 0; chunkIndex[1] < numberOfChunks[1]; ++chunkIndex[1])
+      {
+        // Level 0 is read from the input one row of chunks at a time
+        int rowExtent[6] = { 0, currentLevel.Dimensions[0] - 1, 0, 0, 0, 0 };
+        for (int axis = 1; axis < 3; ++axis)
+        {
+          rowExtent[axis * 2] = chunkIndex[axis] * currentLevel.ChunkSize[axis];
+          rowExtent[axis * 2 + 1] = std::min(rowExtent[axis * 2] + currentLevel.ChunkSize[axis], currentLevel.Dimensions[axis]) - 1;
+        }
+        if (levelIndex == 0)
+        {
+          int updateExtent[6] = { 0 };
+          for (int axis = 0; axis < 3; ++axis)
+          {
+            updateExtent[axis * 2] = rowExtent[axis * 2] + wholeExtent[axis * 2];
+            updateExtent[axis * 2 + 1] = rowExtent[axis * 2 + 1] + wholeExtent[axis * 2];
+          }
+          producer->UpdateExtent(updateExtent);
+          inputImageData = vtkImageData::SafeDownCast(producer->GetOutputDataObject(port));
+          if (!inputImageData || !inputImageData->GetPointData()->GetScalars()
+            || inputImageData->GetScalarType() != scalarType)
+          {
+            vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLChunkedVolumeStorageNode::WritePyramid",
+              vtkMRMLTr("vtkMRMLChunkedVolumeStorageNode", "Cannot write chunked volume: failed to get input image region."));
+            return 0;
+          }
+        }
+        for (chunkIndex[0] = 0; chunkIndex[0] < numberOfChunks[0]; ++chunkIndex[0])
+        {
+          int chunkExtent[6] = { 0 };
+          int chunkVoxels[3] = { 0 };
+          for (int axis = 0; axis < 3; ++axis)
+          {
+            chunkExtent[axis * 2] = chunkIndex[axis] * currentLevel.ChunkSize[axis];
+            chunkExtent[axis * 2 + 1] = std::min(chunkExtent[axis * 2] + currentLevel.ChunkSize[axis], currentLevel.Dimensions[axis]) - 1;
+            chunkVoxels[axis] = chunkExtent[axis * 2 + 1] - chunkExtent[axis * 2] + 1;
+          }
+          // Voxels outside the volume are set to the fill value
+          memset(chunkData, 0, chunkDataSize);
+          if (levelIndex == 0)
+          {
+            size_t rowSize = static_cast<size_t>(chunkVoxels[0]) * scalarSize;
+            for (int k = chunkExtent[4]; k <= chunkExtent[5]; ++k)
+            {
+              for (int j = chunkExtent[2]; j <= chunkExtent[3]; ++j)
+              {
+                vtkIdType chunkOffset = (static_cast<vtkIdType>(k - chunkExtent[4]) * currentLevel.ChunkSize[1] + (j - chunkExtent[2]))
+                  * currentLevel.ChunkSize[0];
+                memcpy(chunkData + chunkOffset * scalarSize, inputImageData->GetScalarPointer(
+                  chunkExtent[0] + wholeExtent[0], j + wholeExtent[2], k + wholeExtent[4]), rowSize);
+              }
+            }
+          }
+          else
+          {
+            // Each chunk is computed from the corresponding region of the previous level
+            const vtkInternal::ResolutionLevel& parentLevel = this->Internal->Levels[levelIndex - 1];
+            int parentExtent[6] = { 0 };
+            for (int axis = 0; axis < 3; ++axis)
+            {
+              parentExtent[axis * 2] = chunkExtent[axis * 2] * factors[axis];
+              parentExtent[axis * 2 + 1] = std::min((chunkExtent[axis * 2 + 1] + 1) * factors[axis], parentLevel.Dimensions[axis]) - 1;
+            }
+            vtkNew<vtkImageData> parentRegion;
+            if (!this->Internal->ReadRegion(fullName, parentLevel, parentExtent, parentRegion, nullptr, levelIndex - 1, errorMessage))
+            {
+              vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLChunkedVolumeStorageNode::WritePyramid",
+                vtkMRMLI18N::Format(vtkMRMLTr("vtkMRMLChunkedVolumeStorageNode", "Cannot write chunked volume: %1"), errorMessage.c_str()));
+              return 0;
+            }
+            switch (scalarType)
+            {
+              vtkTemplateMacro(DownsampleRegion<VTK_TT>(parentRegion, factors, labelMap, chunkVoxels,
+                currentLevel.ChunkSize, static_cast<VTK_TT*>(static_cast<void*>(chunkData))));
+            }
+          }
+          if (IsAllZero(chunkData, chunkDataSize))
+          {
+            // chunks that only contain the fill value are not stored
+            continue;
+          }
+          std::string chunkFileName = this->Internal->GetChunkFileName(fullName, currentLevel, chunkIndex);
+          vtksys::SystemTools::MakeDirectory(vtksys::SystemTools::GetFilenamePath(chunkFileName));
+          bool chunkWritten = false;
+          if (currentLevel.Compressor.empty())
+          {
+            chunkWritten = WriteFileContent(chunkFileName, chunkData, chunkDataSize);
+          }
+          else
+          {
+            uLongf compressedSize = compressBound(static_cast<uLong>(chunkDataSize));
+            compressedData.resize(compressedSize);
+            if (compress2(reinterpret_cast<Bytef*>(compressedData.data()), &compressedSize,
+              reinterpret_cast<const Bytef*>(chunkData), static_cast<uLong>(chunkDataSize), 1) == Z_OK)
+            {
+              chunkWritten = WriteFileContent(chunkFileName, compressedData.data(), compressedSize);
+            }
+          }
+          if (!chunkWritten)
+          {
+            vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLChunkedVolumeStorageNode::WritePyramid",
+              vtkMRMLI18N::Format(vtkMRMLTr("vtkMRMLChunkedVolumeStorageNode", "Failed to write chunk file '%1'"), chunkFileName.c_str()));
+            return 0;
+          }
+        }
+      }
+    }
+  }
+
+  if (!this->Internal->WriteMultiscalesMetadata(fullName))
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLChunkedVolumeStorageNode::WritePyramid",
+      vtkMRMLI18N::Format(vtkMRMLTr("vtkMRMLChunkedVolumeStorageNode", "Failed to write chunked volume metadata to '%1'"), fullName.c_str()));
+    return 0;
+  }
+  return 1;
+}
@@ -0,0 +1,144 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#ifndef __vtkMRMLChunkedVolumeStorageNode_h
+#define __vtkMRMLChunkedVolumeStorageNode_h
+
+// MRML includes
+#include "vtkMRMLStorageNode.h"
+
+class vtkAlgorithmOutput;
+class vtkImageData;
+class vtkMatrix4x4;
+class vtkMRMLVolumeChunkCache;
+
+/// \brief MRML node for storing a scalar volume in chunked, multi-resolution format.
+///
+/// Voxels are stored in an OME-Zarr (Zarr v2 with OME-NGFF multiscales metadata) directory
+/// on local disk. Each resolution level is half the size of the previous level along each axis
+/// and is split into equally sized chunks, each stored in a separate file.
+///
+/// Reading only loads a low-resolution preview level into the volume node, which makes it possible to
+/// open volumes that do not fit into memory. Slice views (see vtkMRMLSliceLayerLogic) request the
+/// region and resolution level they display by calling ReadRegion, which reads the required chunks
+/// through a bounded chunk cache.
+///
+/// Writing builds the resolution pyramid (WritePyramid). The input is read region by region,
+/// so the full-resolution volume does not need to be in memory if the input supports streaming.
+/// A modified low-resolution preview cannot be saved to the location it was read from (it would
+/// replace the full-resolution levels); it can be saved to a new location as a lower-resolution volume.
+class VTK_MRML_EXPORT vtkMRMLChunkedVolumeStorageNode : public vtkMRMLStorageNode
+{
+public:
+  static vtkMRMLChunkedVolumeStorageNode* New();
+  vtkTypeMacro(vtkMRMLChunkedVolumeStorageNode, vtkMRMLStorageNode);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  vtkMRMLNode* CreateNodeInstance() override;
+
+  /// Read node attributes from XML file
+  void ReadXMLAttributes(const char** atts) override;
+
+  /// Write this node's information to a MRML file in XML format.
+  void WriteXML(ostream& of, int indent) override;
+
+  /// Copy node content (excludes basic data, such as name and node references).
+  /// \sa vtkMRMLNode::CopyContent
+  vtkMRMLCopyContentMacro(vtkMRMLChunkedVolumeStorageNode);
+
+  /// Get node XML tag name (like Storage, Model)
+  const char* GetNodeTagName() override { return "ChunkedVolumeStorage"; }
+
+  /// Return true if the node can be read in.
+  bool CanReadInReferenceNode(vtkMRMLNode* refNode) override;
+
+  /// Return true if the node can be written by using the writer.
+  bool CanWriteFromReferenceNode(vtkMRMLNode* refNode) override;
+
+  /// Size of chunks (along I, J, K axes) used when writing. Default is 64x64x64 voxels.
+  vtkSetVector3Macro(ChunkSize, int);
+  vtkGetVector3Macro(ChunkSize, int);
+
+  /// Number of resolution levels to write. If set to 0 (default) then levels are added
+  /// until a level fits into a single chunk.
+  vtkSetMacro(NumberOfLevelsToWrite, int);
+  vtkGetMacro(NumberOfLevelsToWrite, int);
+
+  /// Maximum number of voxels of the preview image that is loaded into the volume node.
+  /// The finest resolution level that does not exceed this limit is loaded. Default is 16M voxels.
+  vtkSetMacro(MaximumNumberOfPreviewVoxels, vtkTypeInt64);
+  vtkGetMacro(MaximumNumberOfPreviewVoxels, vtkTypeInt64);
+
+  /// Cache used for storing chunks read by ReadRegion.
+  /// By default each storage node has its own cache. A cache can be shared between storage nodes
+  /// to limit the memory usage of all chunked volumes together.
+  void SetChunkCache(vtkMRMLVolumeChunkCache* chunkCache);
+  vtkMRMLVolumeChunkCache* GetChunkCache();
+
+  /// Build the resolution pyramid from the input image and write it to FileName.
+  /// Input voxels are requested chunk by chunk (using the update extent), therefore if the input
+  /// algorithm supports streaming (for example, an image reader) then the whole image is never in memory.
+  /// Voxels of lower resolution levels are computed by averaging 2x2x2 voxels of the previous level.
+  /// If labelMap is true then the first voxel of each 2x2x2 block is used instead, to preserve label values.
+  /// Only single-component images are supported. Returns 1 on success.
+  int WritePyramid(vtkAlgorithmOutput* input, vtkMatrix4x4* ijkToRAS, bool labelMap = false);
+
+  /// Number of resolution levels of the last read volume. Level 0 is the full-resolution level.
+  int GetNumberOfResolutionLevels();
+
+  /// Get number of voxels of a resolution level along I, J, K axes.
+  bool GetResolutionLevelDimensions(int level, int dimensions[3]);
+
+  /// Resolution level that was loaded into the volume node.
+  int GetPreviewResolutionLevel();
+
+  /// Get matrix that maps voxel coordinates of the preview image (image data of the volume node)
+  /// to voxel coordinates of the specified resolution level.
+  bool GetPreviewIJKToLevelIJKMatrix(int level, vtkMatrix4x4* previewIJKToLevelIJK);
+
+  /// Returns true if the image data is the preview image read by this storage node
+  /// and it has not been modified since then. Only in this case voxels of other resolution levels
+  /// can be used in place of the image data.
+  bool IsPreviewImageData(vtkImageData* imageData);
+
+  /// Read a region of a resolution level into an image.
+  /// Extent is specified in voxel coordinates of the resolution level, it must be within the level.
+  /// Chunks are retrieved from the chunk cache; chunks that are not cached yet are read from file
+  /// and added to the cache.
+  bool ReadRegion(int level, const int extent[6], vtkImageData* region);
+
+protected:
+  vtkMRMLChunkedVolumeStorageNode();
+  ~vtkMRMLChunkedVolumeStorageNode() override;
+  vtkMRMLChunkedVolumeStorageNode(const vtkMRMLChunkedVolumeStorageNode&);
+  void operator=(const vtkMRMLChunkedVolumeStorageNode&);
+
+  /// Initialize all the supported read file types
+  void InitializeSupportedReadFileTypes() override;
+
+  /// Initialize all the supported write file types
+  void InitializeSupportedWriteFileTypes() override;
+
+  /// Read data and set it in the referenced node
+  int ReadDataInternal(vtkMRMLNode* refNode) override;
+
+  /// Write data from a referenced node
+  int WriteDataInternal(vtkMRMLNode* refNode) override;
+
+  int ChunkSize[3];
+  int NumberOfLevelsToWrite;
+  vtkTypeInt64 MaximumNumberOfPreviewVoxels;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+};
+
+#endif
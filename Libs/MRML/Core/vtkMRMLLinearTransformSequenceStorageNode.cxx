@@ -9,6 +9,7 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 
 // STD includes
 #include <algorithm>
+#include <fstream>
 #include <sstream>
 
 #include "vtkMRMLI18N.h"
@@ -22,6 +23,8 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include "vtkMRMLScene.h"
 #include "vtkMRMLSequenceNode.h"
 
+#include "vtkByteSwap.h"
+#include "vtkDoubleArray.h"
 #include "vtkObjectFactory.h"
 #include "vtkImageAppendComponents.h"
 #include "vtkImageData.h"
@@ -40,6 +43,10 @@ static std::string SEQMETA_FIELD_IMG_STATUS = "ImageStatus";
 // Constants for creating nodes
 static const char NODE_BASE_NAME_SEPARATOR[] = "-";
 
+// Constants for compact binary transform sequence files
+static const char TRANSFORM_MATRIX_FILE_EXTENSION[] = ".seq.tfmb";
+static const char TRANSFORM_MATRIX_FILE_INDEX_VALUE_SEPARATOR = ';';
+
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLLinearTransformSequenceStorageNode);
 
@@ -101,10 +108,15 @@ int vtkMRMLLinearTransformSequenceStorageNode::ReadSequenceFileTransforms(const
 
   frameNumberToIndexValueMap.clear();
 
-  // This structure contains all the transform nodes that are read from the file.
-  // The nodes are not added immediately to the scene to allow them properly named, using the timestamp index value.
-  // Maps the frame number to a vector of transform nodes that belong to that frame.
-  std::map<int, std::vector<vtkMRMLLinearTransformNode*> > importedTransformNodes;
+  // This structure contains all the transforms that are read from the file.
+  // Transforms are added to the sequences after all the index values are known.
+  // Maps the frame number to a vector of transforms that belong to that frame.
+  struct ImportedTransform
+  {
+    std::string Name;
+    double Matrix[16];
+  };
+  std::map<int, std::vector<ImportedTransform> > importedTransforms;
 
   // It contains the largest frame number. It will be used to iterate through all the frame numbers from 0 to lastFrameNumber
   int lastFrameNumber = -1;
@@ -216,11 +228,10 @@ int vtkMRMLLinearTransformSequenceStorageNode::ReadSequenceFileTransforms(const
       {
         continue;
       }
-      vtkMRMLLinearTransformNode* currentTransform = vtkMRMLLinearTransformNode::New(); // will be deleted when added to the scene
-      currentTransform->SetMatrixTransformToParent(matrix.GetPointer());
-      // Generating a unique name is important because that will be used to generate the filename by default
-      currentTransform->SetName(frameFieldName.c_str());
-      importedTransformNodes[frameNumber].push_back(currentTransform);
+      ImportedTransform currentTransform;
+      currentTransform.Name = frameFieldName;
+      std::copy(matrix->GetData(), matrix->GetData() + 16, currentTransform.Matrix);
+      importedTransforms[frameNumber].push_back(currentTransform);
     }
 
     if (frameFieldName.compare("Timestamp") == 0)
@@ -246,25 +257,26 @@ int vtkMRMLLinearTransformSequenceStorageNode::ReadSequenceFileTransforms(const
   }
   fclose(stream);
 
-  // Now add all the nodes to the scene
+  // Now collect the transforms of each sequence
 
   std::map< std::string, vtkMRMLSequenceNode* > transformSequenceNodes;
+  std::map< std::string, vtkSmartPointer<vtkDoubleArray> > transformSequenceMatrices;
+  std::map< std::string, std::vector<std::string> > transformSequenceIndexValues;
 
   for (int currentFrameNumber = 0; currentFrameNumber <= lastFrameNumber; currentFrameNumber++)
   {
-    std::map<int, std::vector<vtkMRMLLinearTransformNode*> >::iterator transformsForCurrentFrame = importedTransformNodes.find(currentFrameNumber);
-    if (transformsForCurrentFrame == importedTransformNodes.end())
+    std::map<int, std::vector<ImportedTransform> >::iterator transformsForCurrentFrame = importedTransforms.find(currentFrameNumber);
+    if (transformsForCurrentFrame == importedTransforms.end())
     {
       // no transforms for this frame
       continue;
     }
     std::string paramValueString = frameNumberToIndexValueMap[currentFrameNumber];
-    for (std::vector<vtkMRMLLinearTransformNode*>::iterator transformIt = transformsForCurrentFrame->second.begin();
+    for (std::vector<ImportedTransform>::iterator transformIt = transformsForCurrentFrame->second.begin();
       transformIt != transformsForCurrentFrame->second.end(); ++transformIt)
     {
-      vtkMRMLLinearTransformNode* transform = (*transformIt);
-      vtkMRMLSequenceNode* transformsSequenceNode = nullptr;
-      if (transformSequenceNodes.find(transform->GetName()) == transformSequenceNodes.end())
+      const ImportedTransform& transform = (*transformIt);
+      if (transformSequenceNodes.find(transform.Name) == transformSequenceNodes.end())
       {
         // Setup hierarchy structure
         vtkSmartPointer<vtkMRMLSequenceNode> newTransformsSequenceNode;
@@ -281,10 +293,10 @@ int vtkMRMLLinearTransformSequenceStorageNode::ReadSequenceFileTransforms(const
           createdNodes.push_back(newTransformsSequenceNode);
         }
         numberOfCreatedNodes++;
-        transformsSequenceNode = newTransformsSequenceNode;
+        vtkMRMLSequenceNode* transformsSequenceNode = newTransformsSequenceNode;
         transformsSequenceNode->SetIndexName("time");
         transformsSequenceNode->SetIndexUnit("s");
-        std::string transformName = transform->GetName();
+        std::string transformName = transform.Name;
         // Strip "Transform" from the end of the transform name
         std::string transformPostfix = "Transform";
         if (transformName.length() > transformPostfix.length() &&
@@ -299,22 +311,24 @@ int vtkMRMLLinearTransformSequenceStorageNode::ReadSequenceFileTransforms(const
         // find a transform by matching the original the transform name.
         transformsSequenceNode->SetAttribute("Sequences.Source", transformName.c_str());
 
-        transformSequenceNodes[transform->GetName()] = transformsSequenceNode;
+        transformSequenceNodes[transform.Name] = transformsSequenceNode;
+        transformSequenceMatrices[transform.Name] = vtkSmartPointer<vtkDoubleArray>::New();
+        transformSequenceMatrices[transform.Name]->SetNumberOfComponents(16);
       }
-      else
-      {
-        transformsSequenceNode = transformSequenceNodes[transform->GetName()];
-      }
-      transform->SetHideFromEditors(false);
-      // Generating a unique name is important because that will be used to generate the filename by default
-      std::ostringstream nameStr;
-      nameStr << transform->GetName() << "_" << std::setw(4) << std::setfill('0') << currentFrameNumber << std::ends;
-      transform->SetName(nameStr.str().c_str());
-      transformsSequenceNode->SetDataNodeAtValue(transform, paramValueString.c_str());
-      transform->Delete(); // ownership transferred to the sequence node
+      transformSequenceMatrices[transform.Name]->InsertNextTypedTuple(transform.Matrix);
+      transformSequenceIndexValues[transform.Name].push_back(paramValueString);
     }
   }
 
+  // Store the transforms in the compact transform matrix array of the sequences.
+  // Transform nodes are only created for items when they are needed.
+  for (std::map< std::string, vtkMRMLSequenceNode* >::iterator transformSequenceNodeIt = transformSequenceNodes.begin();
+    transformSequenceNodeIt != transformSequenceNodes.end(); ++transformSequenceNodeIt)
+  {
+    transformSequenceNodeIt->second->SetTransformMatrices(transformSequenceMatrices[transformSequenceNodeIt->first],
+      transformSequenceIndexValues[transformSequenceNodeIt->first], transformSequenceNodeIt->first.c_str());
+  }
+
   // Add to scene and set name and storage node
   std::string fileNameName = vtksys::SystemTools::GetFilenameName(fileName);
   std::string shortestBaseNodeName;
@@ -445,11 +459,11 @@ bool vtkMRMLLinearTransformSequenceStorageNode::WriteSequenceMetafileTransforms(
 
       std::string transformValue = "1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1"; // Identity
       std::string transformStatus = "INVALID";
-      vtkMRMLTransformNode* transformNode = vtkMRMLTransformNode::SafeDownCast(currSequenceNode->GetDataNodeAtValue(indexValue.c_str()));
-      if (transformNode != nullptr && transformNode->IsLinear())
+      // Get the matrix without creating a transform node (if the item is stored in the compact transform matrix array)
+      int itemNumber = currSequenceNode->GetItemNumberFromIndexValue(indexValue);
+      vtkNew<vtkMatrix4x4> matrix;
+      if (itemNumber >= 0 && currSequenceNode->GetNthTransformMatrix(itemNumber, matrix))
       {
-        vtkNew<vtkMatrix4x4> matrix;
-        transformNode->GetMatrixTransformToParent(matrix.GetPointer());
         transformValue = vtkAddonMathUtilities::ToString(matrix.GetPointer());
         transformStatus = "OK";
       }
@@ -506,6 +520,11 @@ int vtkMRMLLinearTransformSequenceStorageNode::ReadDataInternal(vtkMRMLNode* ref
     return 0;
   }
 
+  if (this->IsTransformMatrixFile(fullName))
+  {
+    return this->ReadTransformMatrixFile(fullName, seqNode);
+  }
+
   std::deque< vtkSmartPointer<vtkMRMLSequenceNode> > createdTransformNodes;
   createdTransformNodes.push_back(seqNode);
   std::map< int, std::string > frameNumberToIndexValueMap;
@@ -543,6 +562,11 @@ bool vtkMRMLLinearTransformSequenceStorageNode::CanWriteFromReferenceNode(vtkMRM
   int numberOfFrameVolumes = sequenceNode->GetNumberOfDataNodes();
   for (int frameIndex = 0; frameIndex < numberOfFrameVolumes; frameIndex++)
   {
+    if (sequenceNode->IsNthDataNodeTransformMatrix(frameIndex))
+    {
+      // stored in the compact transform matrix array, it is a linear transform
+      continue;
+    }
     vtkMRMLTransformNode* transform = vtkMRMLTransformNode::SafeDownCast(sequenceNode->GetNthDataNode(frameIndex));
     if (transform == NULL || !transform->IsLinear())
     {
@@ -573,6 +597,16 @@ int vtkMRMLLinearTransformSequenceStorageNode::WriteDataInternal(vtkMRMLNode *re
     return 0;
   }
 
+  if (this->IsTransformMatrixFile(fullName))
+  {
+    if (!this->WriteTransformMatrixFile(fullName, sequenceNode))
+    {
+      return 0;
+    }
+    this->StageWriteData(refNode);
+    return 1;
+  }
+
   std::deque< vtkMRMLSequenceNode* > transformSequenceNodes;
   transformSequenceNodes.push_back(sequenceNode);
   std::deque< std::string > transformNames;
@@ -602,6 +636,7 @@ void vtkMRMLLinearTransformSequenceStorageNode::InitializeSupportedReadFileTypes
   //: File format name
   std::string fileType = vtkMRMLTr("vtkMRMLLinearTransformSequenceStorageNode", "Linear transform sequence");
   this->SupportedReadFileTypes->InsertNextValue(fileType + " (.seq.mhd)");
+  this->SupportedReadFileTypes->InsertNextValue(fileType + " (.seq.tfmb)");
   this->SupportedReadFileTypes->InsertNextValue(fileType + " (.seq.mha)");
   this->SupportedReadFileTypes->InsertNextValue(fileType + " (.mha)");
   this->SupportedReadFileTypes->InsertNextValue(fileType + " (.mhd)");
@@ -614,6 +649,7 @@ void vtkMRMLLinearTransformSequenceStorageNode::InitializeSupportedWriteFileType
   std::string fileType = vtkMRMLTr("vtkMRMLLinearTransformSequenceStorageNode", "Linear transform sequence");
   this->SupportedWriteFileTypes->InsertNextValue(fileType + " (.seq.mhd)");
   this->SupportedWriteFileTypes->InsertNextValue(fileType + " (.seq.mha)");
+  this->SupportedWriteFileTypes->InsertNextValue(fileType + " (.seq.tfmb)");
   this->SupportedWriteFileTypes->InsertNextValue(fileType + " (.mhd)");
   this->SupportedWriteFileTypes->InsertNextValue(fileType + " (.mha)");
 }
@@ -623,3 +659,209 @@ const char* vtkMRMLLinearTransformSequenceStorageNode::GetDefaultWriteFileExtens
 {
   return "seq.mha";
 }
+
+//----------------------------------------------------------------------------
+bool vtkMRMLLinearTransformSequenceStorageNode::IsTransformMatrixFile(const std::string& filename)
+{
+  return this->GetSupportedFileExtension(filename.c_str()) == TRANSFORM_MATRIX_FILE_EXTENSION;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLLinearTransformSequenceStorageNode::ReadTransformMatrixFile(const std::string& fileName, vtkMRMLSequenceNode* sequenceNode)
+{
+  std::ifstream file(fileName.c_str(), std::ios_base::binary);
+  if (!file.is_open())
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLLinearTransformSequenceStorageNode::ReadTransformMatrixFile",
+      "Failed to open file for reading: " << fileName);
+    return 0;
+  }
+
+  // Read header. It ends with an empty line.
+  std::string line;
+  std::getline(file, line);
+  if (line.compare(0, 4, "NRRD") != 0)
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLLinearTransformSequenceStorageNode::ReadTransformMatrixFile",
+      "File is not a transform sequence file: " << fileName);
+    return 0;
+  }
+  std::map<std::string, std::string> fields;
+  while (std::getline(file, line))
+  {
+    if (!line.empty() && line.back() == '\r')
+    {
+      line.pop_back();
+    }
+    if (line.empty())
+    {
+      // end of header
+      break;
+    }
+    if (line[0] == '#')
+    {
+      // comment
+      continue;
+    }
+    size_t separatorPos = line.find(":");
+    if (separatorPos == std::string::npos)
+    {
+      continue;
+    }
+    std::string name = line.substr(0, separatorPos);
+    // key/value pairs are separated by ":=", fields by ": "
+    size_t valuePos = separatorPos + 1;
+    if (valuePos < line.size() && line[valuePos] == '=')
+    {
+      valuePos++;
+    }
+    std::string value = line.substr(valuePos);
+    Trim(name);
+    Trim(value);
+    fields[name] = value;
+  }
+
+  std::stringstream sizesStream(fields["sizes"]);
+  vtkIdType numberOfComponents = 0;
+  vtkIdType numberOfItems = -1;
+  sizesStream >> numberOfComponents >> numberOfItems;
+  if (fields["type"] != "double" || fields["dimension"] != "2" || fields["encoding"] != "raw"
+    || numberOfComponents != 16 || numberOfItems < 0)
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLLinearTransformSequenceStorageNode::ReadTransformMatrixFile",
+      "Unsupported transform sequence file format (expected raw-encoded 16xN double array): " << fileName);
+    return 0;
+  }
+
+  std::vector<std::string> indexValues;
+  if (numberOfItems > 0)
+  {
+    std::stringstream indexValuesStream(fields["Sequences.IndexValues"]);
+    std::string indexValue;
+    while (std::getline(indexValuesStream, indexValue, TRANSFORM_MATRIX_FILE_INDEX_VALUE_SEPARATOR))
+    {
+      indexValues.push_back(indexValue);
+    }
+  }
+  if (static_cast<vtkIdType>(indexValues.size()) != numberOfItems)
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLLinearTransformSequenceStorageNode::ReadTransformMatrixFile",
+      "Number of index values (" << indexValues.size() << ") does not match the number of transforms ("
+      << numberOfItems << ") in file: " << fileName);
+    return 0;
+  }
+
+  vtkNew<vtkDoubleArray> matrices;
+  matrices->SetNumberOfComponents(16);
+  matrices->SetNumberOfTuples(numberOfItems);
+  file.read(reinterpret_cast<char*>(matrices->GetPointer(0)), numberOfItems * 16 * sizeof(double));
+  if (file.gcount() != static_cast<std::streamsize>(numberOfItems * 16 * sizeof(double)))
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLLinearTransformSequenceStorageNode::ReadTransformMatrixFile",
+      "Failed to read transforms, file is truncated: " << fileName);
+    return 0;
+  }
+  if (fields["endian"] == "big")
+  {
+    vtkByteSwap::SwapBERange(matrices->GetPointer(0), numberOfItems * 16);
+  }
+  else
+  {
+    vtkByteSwap::SwapLERange(matrices->GetPointer(0), numberOfItems * 16);
+  }
+
+  MRMLNodeModifyBlocker blocker(sequenceNode);
+  if (fields.find("Sequences.IndexName") != fields.end())
+  {
+    sequenceNode->SetIndexName(fields["Sequences.IndexName"]);
+  }
+  if (fields.find("Sequences.IndexUnit") != fields.end())
+  {
+    sequenceNode->SetIndexUnit(fields["Sequences.IndexUnit"]);
+  }
+  if (fields.find("Sequences.IndexType") != fields.end())
+  {
+    sequenceNode->SetIndexTypeFromString(fields["Sequences.IndexType"].c_str());
+  }
+  std::string dataNodeBaseName = fields["Sequences.DataNodeBaseName"];
+  if (!sequenceNode->SetTransformMatrices(matrices, indexValues, dataNodeBaseName.empty() ? nullptr : dataNodeBaseName.c_str()))
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLLinearTransformSequenceStorageNode::ReadTransformMatrixFile",
+      "Failed to set transforms in sequence from file: " << fileName);
+    return 0;
+  }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLLinearTransformSequenceStorageNode::WriteTransformMatrixFile(const std::string& fileName, vtkMRMLSequenceNode* sequenceNode)
+{
+  vtkNew<vtkDoubleArray> matrices;
+  if (!sequenceNode->GetTransformMatrices(matrices))
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLLinearTransformSequenceStorageNode::WriteTransformMatrixFile",
+      "Only linear transform nodes can be written in this format.");
+    return 0;
+  }
+  vtkIdType numberOfItems = matrices->GetNumberOfTuples();
+
+  std::ofstream file(fileName.c_str(), std::ios_base::binary);
+  if (!file.is_open())
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLLinearTransformSequenceStorageNode::WriteTransformMatrixFile",
+      "Failed to open file for writing: " << fileName);
+    return 0;
+  }
+
+  std::string dataNodeBaseName;
+  if (numberOfItems > 0 && !sequenceNode->IsNthDataNodeTransformMatrix(0)
+    && sequenceNode->GetNthDataNode(0) && sequenceNode->GetNthDataNode(0)->GetAttribute("Sequences.BaseName"))
+  {
+    dataNodeBaseName = sequenceNode->GetNthDataNode(0)->GetAttribute("Sequences.BaseName");
+  }
+  else if (sequenceNode->GetAttribute("Sequences.Source"))
+  {
+    dataNodeBaseName = sequenceNode->GetAttribute("Sequences.Source");
+  }
+
+  // NRRD header, matrices are stored in row-major order
+  file << "NRRD0004\n";
+  file << "# Linear transform sequence: transform to parent matrices in row-major order\n";
+  file << "type: double\n";
+  file << "dimension: 2\n";
+  file << "sizes: 16 " << numberOfItems << "\n";
+  file << "kinds: 4D-matrix list\n";
+#ifdef VTK_WORDS_BIGENDIAN
+  file << "endian: big\n";
+#else
+  file << "endian: little\n";
+#endif
+  file << "encoding: raw\n";
+  file << "Sequences.IndexName:=" << sequenceNode->GetIndexName() << "\n";
+  file << "Sequences.IndexUnit:=" << sequenceNode->GetIndexUnit() << "\n";
+  file << "Sequences.IndexType:=" << sequenceNode->GetIndexTypeAsString() << "\n";
+  if (!dataNodeBaseName.empty())
+  {
+    file << "Sequences.DataNodeBaseName:=" << dataNodeBaseName << "\n";
+  }
+  file << "Sequences.IndexValues:=";
+  for (vtkIdType itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+  {
+    if (itemNumber > 0)
+    {
+      file << TRANSFORM_MATRIX_FILE_INDEX_VALUE_SEPARATOR;
+    }
+    file << sequenceNode->GetNthIndexValue(itemNumber);
+  }
+  file << "\n\n";
+
+  file.write(reinterpret_cast<const char*>(matrices->GetPointer(0)), numberOfItems * 16 * sizeof(double));
+  file.close();
+  if (file.fail())
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLLinearTransformSequenceStorageNode::WriteTransformMatrixFile",
+      "Failed to write file: " << fileName);
+    return 0;
+  }
+  return 1;
+}
@@ -9,6 +9,13 @@
 ///  vtkMRMLLinearTransformSequenceStorageNode - MRML node that can read/write
 ///  a Sequence node containing linear transforms in a single nrrd or mha file
 ///
+///  Transforms can be also stored in a compact binary file (.seq.tfmb), which is
+///  much faster to read and write for long sequences. The file is a NRRD file
+///  (with a different file extension to distinguish it from images) that contains
+///  the transform to parent matrices in an Nx16 double array ("4D-matrix list") and the
+///  index values in the header. Transforms are read into the compact transform matrix
+///  array of the sequence node, without creating a transform node for each item.
+///
 
 #ifndef __vtkMRMLLinearTransformSequenceStorageNode_h
 #define __vtkMRMLLinearTransformSequenceStorageNode_h
@@ -80,6 +87,17 @@ protected:
 
   /// Initialize all the supported write file types
   void InitializeSupportedWriteFileTypes() override;
+
+  /// Return true if the file is a compact binary transform sequence file (.seq.tfmb)
+  bool IsTransformMatrixFile(const std::string& filename);
+
+  /// Read all items of the sequence from a compact binary transform sequence file.
+  /// Returns 1 on success.
+  int ReadTransformMatrixFile(const std::string& fileName, vtkMRMLSequenceNode* sequenceNode);
+
+  /// Write all items of the sequence into a compact binary transform sequence file.
+  /// Returns 1 on success.
+  int WriteTransformMatrixFile(const std::string& fileName, vtkMRMLSequenceNode* sequenceNode);
 };
 
 #endif
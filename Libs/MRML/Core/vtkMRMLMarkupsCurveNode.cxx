@@ -21,6 +21,7 @@
 #include "vtkMRMLI18N.h"
 #include "vtkCurveGenerator.h"
 #include "vtkCurveMeasurementsCalculator.h"
+#include "vtkCurveSegmentLocator.h"
 #include "vtkEventBroker.h"
 #include "vtkMRMLMarkupsDisplayNode.h"
 #include "vtkMRMLMeasurementLength.h"
@@ -39,7 +40,6 @@
 #include <vtkCellLocator.h>
 #include <vtkCleanPolyData.h>
 #include <vtkCommand.h>
-#include <vtkCutter.h>
 #include <vtkDoubleArray.h>
 #include <vtkGeneralTransform.h>
 #include <vtkGenericCell.h>
@@ -126,6 +126,7 @@ vtkMRMLMarkupsCurveNode::vtkMRMLMarkupsCurveNode()
   this->WorldOutput = vtkSmartPointer<vtkPassThrough>::New();
   this->WorldOutput->SetInputConnection(this->CurveMeasurementsCalculator->GetOutputPort());
 
+  this->CurveSegmentLocatorWorld = vtkSmartPointer<vtkCurveSegmentLocator>::New();
 
   this->ScalarDisplayAssignAttribute = vtkSmartPointer<vtkAssignAttribute>::New();
 
@@ -295,6 +296,9 @@ vtkPolyData* vtkMRMLMarkupsCurveNode::GetCurveWorld()
   this->WorldOutput->Update();
   auto* curvePolyDataWorld = vtkPolyData::SafeDownCast(this->WorldOutput->GetOutput());
   this->TransformedCurvePolyLocator->SetDataSet(curvePolyDataWorld);
+  // The segment locator is only rebuilt on the next query if the points have changed
+  this->CurveSegmentLocatorWorld->SetPoints(curvePolyDataWorld ? curvePolyDataWorld->GetPoints() : nullptr);
+  this->CurveSegmentLocatorWorld->SetCurveClosed(this->CurveClosed);
   return curvePolyDataWorld;
 }
 
@@ -836,7 +840,12 @@ bool vtkMRMLMarkupsCurveNode::GetCurveDirectionAtPointIndexWorld(vtkIdType curve
 //---------------------------------------------------------------------------
 vtkIdType vtkMRMLMarkupsCurveNode::GetFarthestCurvePointIndexToPositionWorld(const double posWorld[3])
 {
-  return vtkMRMLMarkupsCurveNode::GetFarthestCurvePointIndexToPosition(this->GetCurvePointsWorld(), posWorld);
+  vtkPoints* points = this->GetCurvePointsWorld();
+  if (!points || points->GetNumberOfPoints() < 1)
+  {
+    return -1;
+  }
+  return this->CurveSegmentLocatorWorld->FindFarthestPoint(posWorld);
 }
 
 //---------------------------------------------------------------------------
@@ -844,7 +853,7 @@ vtkIdType vtkMRMLMarkupsCurveNode::GetFarthestCurvePointIndexToPosition(vtkPoint
 {
   if (!points || points->GetNumberOfPoints()<1)
   {
-    return false;
+    return -1;
   }
 
   double farthestPoint[3] = { 0.0 };
@@ -913,23 +922,7 @@ bool vtkMRMLMarkupsCurveNode::GetPointsOnPlaneWorld(vtkPlane* plane, vtkPoints*
   {
     return true;
   }
-
-  vtkNew<vtkCutter> cutEdges;
-  cutEdges->SetInputData(curvePoly);
-  cutEdges->SetCutFunction(plane);
-  cutEdges->GenerateCutScalarsOff();
-  cutEdges->SetValue(0, 0);
-  cutEdges->Update();
-  if (!cutEdges->GetOutput())
-  {
-    return true;
-  }
-  vtkPoints* points = cutEdges->GetOutput()->GetPoints();
-  if (!points)
-  {
-    return true;
-  }
-  intersectionPoints->DeepCopy(points);
+  this->CurveSegmentLocatorWorld->IntersectWithPlane(plane->GetOrigin(), plane->GetNormal(), intersectionPoints);
   return true;
 }
 
@@ -1064,7 +1057,38 @@ void vtkMRMLMarkupsCurveNode::SetNumberOfPointsPerInterpolatingSegment(int point
 //---------------------------------------------------------------------------
 vtkIdType vtkMRMLMarkupsCurveNode::GetClosestPointPositionAlongCurveWorld(const double posWorld[3], double closestPos[3])
 {
-  return vtkMRMLMarkupsCurveNode::GetClosestPointPositionAlongCurve(this->GetCurvePointsWorld(), posWorld, closestPos, this->TransformedCurvePolyLocator);
+  vtkPoints* points = this->GetCurvePointsWorld();
+  if (!points || points->GetNumberOfPoints() < 1)
+  {
+    return -1;
+  }
+  if (points->GetNumberOfPoints() == 1)
+  {
+    points->GetPoint(0, closestPos);
+    return -1;
+  }
+  double parametricCoordinate = 0.0;
+  double distance2 = 0.0;
+  return this->CurveSegmentLocatorWorld->FindClosestSegment(posWorld, closestPos, parametricCoordinate, distance2);
+}
+
+//---------------------------------------------------------------------------
+double vtkMRMLMarkupsCurveNode::GetCurveLengthToClosestPointPositionWorld(const double posWorld[3], double closestPosWorld[3]/*=nullptr*/)
+{
+  vtkPoints* points = this->GetCurvePointsWorld();
+  if (!points || points->GetNumberOfPoints() < 1)
+  {
+    return -1.0;
+  }
+  if (points->GetNumberOfPoints() == 1)
+  {
+    if (closestPosWorld)
+    {
+      points->GetPoint(0, closestPosWorld);
+    }
+    return 0.0;
+  }
+  return this->CurveSegmentLocatorWorld->GetCurveLengthAtClosestPosition(posWorld, closestPosWorld);
 }
 
 //---------------------------------------------------------------------------
@@ -1093,7 +1117,7 @@ vtkIdType vtkMRMLMarkupsCurveNode::GetClosestPointPositionAlongCurve(vtkPoints*
       return -1;
     }
     points->GetPoint(closestCurvePointIndex, closestCurvePoint);
-    closestDistance2 = vtkMath::Distance2BetweenPoints(pos, closestPos);
+    closestDistance2 = vtkMath::Distance2BetweenPoints(pos, closestCurvePoint);
   }
   else
   {
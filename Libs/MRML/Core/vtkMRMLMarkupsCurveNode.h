@@ -38,6 +38,7 @@ class vtkAssignAttribute;
 class vtkCallbackCommand;
 class vtkCleanPolyData;
 class vtkCurveMeasurementsCalculator;
+class vtkCurveSegmentLocator;
 class vtkPassThrough;
 class vtkPlane;
 class vtkProjectMarkupsCurvePointsFilter;
@@ -181,10 +182,17 @@ public:
   /// Get position of the closest point along the curve in world coordinates.
   /// The found position may be between two curve points.
   /// Returns index of the found line segment. -1 if failed.
+  /// The search uses a cached spatial index of the curve segments, which is rebuilt when the curve changes.
   /// \param posWorld: input position
   /// \param closestPosWorld: output found closest position
   vtkIdType GetClosestPointPositionAlongCurveWorld(const double posWorld[3], double closestPosWorld[3]);
 
+  /// Get curve length from the first curve point to the closest point along the curve in world coordinates.
+  /// \param posWorld: input position
+  /// \param closestPosWorld: optional output, found closest position
+  /// \return curve length, -1 if failed.
+  double GetCurveLengthToClosestPointPositionWorld(const double posWorld[3], double closestPosWorld[3]=nullptr);
+
   /// Get position of the closest point along the curve in any coordinate system.
   /// The found position may be between two curve points.
   /// Returns index of the found line segment. -1 if failed.
@@ -196,6 +204,7 @@ public:
 
   /// Get index of the farthest curve point from the specified reference point in world coordinates.
   /// Distance is Euclidean distance, not distance along the curve.
+  /// If multiple points are at the same distance then the lowest point index is returned.
   /// \param posWorld Reference point position in world coordinate system
   /// \return index of the farthest curve point from refPoint, -1 in case of error
   vtkIdType GetFarthestCurvePointIndexToPositionWorld(const double posWorld[3]);
@@ -246,6 +255,9 @@ public:
   /// \return true on success.
   bool GetCurvePointToWorldTransformAtPointIndex(vtkIdType curvePointIndex, vtkMatrix4x4* curvePointToWorld);
 
+  /// Get points where the curve crosses the plane, in world coordinate system.
+  /// Points are ordered along the curve.
+  /// \return true on success.
   bool GetPointsOnPlaneWorld(vtkPlane* plane, vtkPoints* intersectionPoints);
 
   /// Type of curve to generate
@@ -324,6 +336,8 @@ protected:
   vtkSmartPointer<vtkPassThrough> SurfaceScalarPassThroughFilter;
   vtkSmartPointer<vtkCurveMeasurementsCalculator> CurveMeasurementsCalculator;
   vtkSmartPointer<vtkPassThrough> WorldOutput;
+  /// Spatial index of the world curve segments, for fast closest point and plane intersection queries
+  vtkSmartPointer<vtkCurveSegmentLocator> CurveSegmentLocatorWorld;
   const char* ShortestDistanceSurfaceActiveScalar;
 
   /// Filter that changes the active scalar of the input mesh using the ActiveScalarName
@@ -45,6 +45,9 @@ public:
   /// Return true if the reference node can be read in
   bool CanReadInReferenceNode(vtkMRMLNode *refNode) override;
 
+  /// Models can be written concurrently, except in OBJ format (it is written using a renderer)
+  bool CanWriteDataConcurrently(vtkMRMLNode* refNode) override;
+
   /// Get/Set flag that controls if points are to be written in various coordinate systems
   vtkSetClampMacro(CoordinateSystem, int, 0, vtkMRMLStorageNode::CoordinateSystemType_Last-1);
   vtkGetMacro(CoordinateSystem, int);
@@ -100,6 +100,7 @@ void vtkMRMLNRRDStorageNode::Copy(vtkMRMLNode *anode)
   vtkMRMLNRRDStorageNode *node = (vtkMRMLNRRDStorageNode *) anode;
 
   this->SetCenterImage(node->CenterImage);
+  this->SetMemoryMapping(node->MemoryMapping);
 
   this->EndModify(disabledModify);
 
@@ -110,6 +111,7 @@ void vtkMRMLNRRDStorageNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   vtkMRMLStorageNode::PrintSelf(os,indent);
   os << indent << "CenterImage:   " << this->CenterImage << "\n";
+  os << indent << "MemoryMapping:   " << (this->MemoryMapping ? "true" : "false") << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -121,6 +123,19 @@ bool vtkMRMLNRRDStorageNode::CanReadInReferenceNode(vtkMRMLNode *refNode)
          refNode->IsA("vtkMRMLDiffusionTensorVolumeNode");
 }
 
+//----------------------------------------------------------------------------
+bool vtkMRMLNRRDStorageNode::CanWriteDataConcurrently(vtkMRMLNode* refNode)
+{
+  vtkMRMLVolumeNode* volNode = vtkMRMLVolumeNode::SafeDownCast(refNode);
+  if (!volNode || !this->CanWriteFromReferenceNode(refNode))
+  {
+    return false;
+  }
+  // Update the image data in the main thread
+  volNode->GetImageData();
+  return true;
+}
+
 //----------------------------------------------------------------------------
 int vtkMRMLNRRDStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
 {
@@ -157,6 +172,7 @@ int vtkMRMLNRRDStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
   vtkNew<vtkTeemNRRDReader> reader;
 
   // Set Reader member variables
+  reader->SetMemoryMapping(this->MemoryMapping);
   if (this->CenterImage)
   {
     reader->SetUseNativeOriginOff();
@@ -368,6 +384,9 @@ int vtkMRMLNRRDStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
     vtkErrorMacro("WriteData: File name not specified");
     return 0;
   }
+  // Voxels that are memory-mapped from the file that is overwritten must be copied first,
+  // as unmodified voxels are read from the file.
+  vtkTeemNRRDReader::ReleaseMappedData(volNode->GetImageData(), fullName);
   // Use here the NRRD Writer
   vtkNew<vtkTeemNRRDWriter> writer;
   writer->SetFileName(fullName.c_str());
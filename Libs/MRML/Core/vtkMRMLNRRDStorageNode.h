@@ -53,6 +53,17 @@ class VTK_MRML_EXPORT vtkMRMLNRRDStorageNode : public vtkMRMLStorageNode
   vtkGetMacro(CenterImage, int);
   vtkSetMacro(CenterImage, int);
 
+  ///
+  /// Map raw voxel data of uncompressed files into memory instead of reading it into a newly allocated buffer.
+  /// Opening large volumes becomes almost instantaneous, as file content is only loaded when it is accessed.
+  /// Voxels can be modified (copy-on-write), the file is not changed.
+  /// If the data cannot be mapped (for example, compressed file) then it is read as usual.
+  /// This is a reading option, it is not saved in the scene. Disabled by default.
+  /// \sa vtkTeemNRRDReader::SetMemoryMapping
+  vtkSetMacro(MemoryMapping, bool);
+  vtkGetMacro(MemoryMapping, bool);
+  vtkBooleanMacro(MemoryMapping, bool);
+
   ///
   /// Access the nrrd header fields to create a diffusion gradient table
   int ParseDiffusionInformation(vtkTeemNRRDReader *reader,vtkDoubleArray *grad,vtkDoubleArray *bvalues);
@@ -60,6 +71,9 @@ class VTK_MRML_EXPORT vtkMRMLNRRDStorageNode : public vtkMRMLStorageNode
   /// Return true if the node can be read in.
   bool CanReadInReferenceNode(vtkMRMLNode *refNode) override;
 
+  /// Volumes can be written concurrently
+  bool CanWriteDataConcurrently(vtkMRMLNode* refNode) override;
+
   ///
   /// Configure the storage node for data exchange. This is an
   /// opportunity to optimize the storage node's settings, for
@@ -95,6 +109,7 @@ protected:
   int GetGzipCompressionLevelFromCompressionParameter(std::string parameter);
 
   int CenterImage;
+  bool MemoryMapping{ false };
 };
 
 #endif
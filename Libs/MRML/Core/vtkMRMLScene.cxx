@@ -20,6 +20,7 @@ Version:   $Revision: 1.18 $
 #include "vtkDataIOManager.h"
 #include "vtkMRMLBSplineTransformNode.h"
 #include "vtkMRMLCameraNode.h"
+#include "vtkMRMLChunkedVolumeStorageNode.h"
 #include "vtkMRMLClipModelsNode.h"
 #include "vtkMRMLClipNode.h"
 #include "vtkMRMLColorNode.h"
@@ -29,7 +30,9 @@ Version:   $Revision: 1.18 $
 #include "vtkMRMLDiffusionTensorDisplayPropertiesNode.h"
 #include "vtkMRMLDiffusionWeightedVolumeDisplayNode.h"
 #include "vtkMRMLDiffusionWeightedVolumeNode.h"
+#include "vtkMRMLDisplayNode.h"
 #include "vtkMRMLDisplayableHierarchyNode.h"
+#include "vtkMRMLDisplayableNode.h"
 #include "vtkMRMLFolderDisplayNode.h"
 #include "vtkMRMLGridTransformNode.h"
 #include "vtkMRMLHierarchyNode.h"
@@ -93,6 +96,7 @@ Version:   $Revision: 1.18 $
 #include "vtkMRMLVectorVolumeDisplayNode.h"
 #include "vtkMRMLViewNode.h"
 #include "vtkMRMLVolumeArchetypeStorageNode.h"
+#include "vtkMRMLVolumeNode.h"
 #include "vtkMRMLVolumeSequenceStorageNode.h"
 #include "vtkTagTable.h"
 #include "vtkURIHandler.h"
@@ -110,6 +114,7 @@ Version:   $Revision: 1.18 $
 #include <vtkCallbackCommand.h>
 #include <vtkCollection.h>
 #include <vtkDebugLeaks.h>
+#include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPNGWriter.h>
 #include <vtkSmartPointer.h>
@@ -121,7 +126,11 @@ Version:   $Revision: 1.18 $
 
 // STD includes
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <numeric>
+#include <thread>
 
 //#define MRMLSCENE_VERBOSE
 
@@ -180,6 +189,10 @@ vtkMRMLScene::vtkMRMLScene()
   // is caught by other observers.
   this->AddObserver(vtkCommand::DeleteEvent, this->DeleteEventCallback, 1000.);
 
+  this->DeferredBundleDataCallback = vtkCallbackCommand::New();
+  this->DeferredBundleDataCallback->SetClientData( reinterpret_cast<void *>(this) );
+  this->DeferredBundleDataCallback->SetCallback( vtkMRMLScene::SceneCallback );
+
   //
   // Register all the 'built-in' nodes for the library
   // SmartPointer is used to create an instance of the class, and destroy immediately after registration is complete.
@@ -190,6 +203,7 @@ vtkMRMLScene::vtkMRMLScene()
 
   this->RegisterNodeClass(vtkSmartPointer<vtkMRMLBSplineTransformNode>::New());
   this->RegisterNodeClass(vtkSmartPointer<vtkMRMLCameraNode>::New());
+  this->RegisterNodeClass(vtkSmartPointer<vtkMRMLChunkedVolumeStorageNode>::New());
   this->RegisterNodeClass(vtkSmartPointer<vtkMRMLClipModelsNode>::New());
   this->RegisterNodeClass(vtkSmartPointer<vtkMRMLClipNode>::New());
   this->RegisterNodeClass(vtkSmartPointer<vtkMRMLColorNode>::New());
@@ -278,6 +292,7 @@ vtkMRMLScene::~vtkMRMLScene()
 {
   this->ClearUndoStack ( );
   this->ClearRedoStack ( );
+  this->CloseBundle();
 
   if ( this->Nodes != nullptr )
   {
@@ -325,11 +340,16 @@ vtkMRMLScene::~vtkMRMLScene()
     this->DeleteEventCallback->Delete();
     this->DeleteEventCallback = nullptr;
   }
+  if ( this->DeferredBundleDataCallback != nullptr )
+  {
+    this->DeferredBundleDataCallback->Delete();
+    this->DeferredBundleDataCallback = nullptr;
+  }
 }
 
 //------------------------------------------------------------------------------
-void vtkMRMLScene::SceneCallback( vtkObject *vtkNotUsed(caller),
-                                  unsigned long vtkNotUsed(eid),
+void vtkMRMLScene::SceneCallback( vtkObject *caller,
+                                  unsigned long eid,
                                   void *clientData, void *vtkNotUsed(callData) )
 {
   vtkMRMLScene *self = reinterpret_cast<vtkMRMLScene *>(clientData);
@@ -337,10 +357,26 @@ void vtkMRMLScene::SceneCallback( vtkObject *vtkNotUsed(caller),
   {
     return;
   }
-  // here we know that SceneCallback has only be called by DeleteEvent,
-  // we directly process the event here. If in the future, more events
-  // are processed, then add a ProcessMRMLEvents method (instead of
-  // doing everything in the static function).
+  if (eid == vtkMRMLDisplayableNode::DisplayModifiedEvent)
+  {
+    // a node with deferred bundle data: read the data if it is shown
+    vtkMRMLDisplayableNode* displayableNode = vtkMRMLDisplayableNode::SafeDownCast(caller);
+    if (!displayableNode)
+    {
+      return;
+    }
+    for (int displayNodeIndex = 0; displayNodeIndex < displayableNode->GetNumberOfDisplayNodes(); ++displayNodeIndex)
+    {
+      vtkMRMLDisplayNode* displayNode = displayableNode->GetNthDisplayNode(displayNodeIndex);
+      if (displayNode && displayNode->GetVisibility())
+      {
+        self->LoadDeferredBundleData(displayableNode);
+        break;
+      }
+    }
+    return;
+  }
+  // DeleteEvent of the scene
   self->Clear(1);
 }
 
@@ -355,8 +391,13 @@ void vtkMRMLScene::Clear(int removeSingletons)
   this->SetUndoOff();
   this->StartState(vtkMRMLScene::CloseState);
 
+  if (!this->BundleReadInProgress)
+  {
+    this->CloseBundle();
+  }
   this->RemoveAllNodes(removeSingletons);
   this->NodeReferences.clear();
+  this->NodeReferencedIDs.clear();
   this->ReferencedIDChanges.clear();
   this->ResetNodes();
 
@@ -1347,6 +1388,10 @@ vtkMRMLNode* vtkMRMLScene::AddNodeNoNotify(vtkMRMLNode *n)
 
   // cache the node so the whole scene cache stays up-to date
   this->AddNodeID(n);
+  if (this->AddingNodes && n->GetName())
+  {
+    this->AddingNodesNames.insert(n->GetName());
+  }
 
   // Keep the SH up-to-date
   if (vtkMRMLSubjectHierarchyNode::SafeDownCast(n) != nullptr &&
@@ -1425,6 +1470,151 @@ vtkMRMLNode* vtkMRMLScene::AddNode(vtkMRMLNode *n)
   return node;
 }
 
+//------------------------------------------------------------------------------
+void vtkMRMLScene::AddNodes(const std::vector<vtkMRMLNode*>& nodesToAdd, std::vector<vtkMRMLNode*>* addedNodes/*=nullptr*/)
+{
+  if (addedNodes)
+  {
+    addedNodes->clear();
+  }
+
+  // Collect the scene nodes once instead of calling IsNodePresent() for each node
+  std::set<vtkMRMLNode*> sceneNodes;
+  vtkMRMLNode* sceneNode = nullptr;
+  vtkCollectionSimpleIterator it;
+  for (this->Nodes->InitTraversal(it);
+       (sceneNode = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+  {
+    sceneNodes.insert(sceneNode);
+  }
+
+  vtkNew<vtkCollection> nodesToAddCollection;
+  std::vector<vtkMRMLNode*> validNodesToAdd;
+  for (vtkMRMLNode* n : nodesToAdd)
+  {
+    if (!n)
+    {
+      vtkErrorMacro("AddNodes: unable to add a null node to the scene");
+      continue;
+    }
+    if (!n->GetAddToScene())
+    {
+      continue;
+    }
+    if (!sceneNodes.insert(n).second)
+    {
+      vtkErrorMacro("AddNodes: Node " << n->GetClassName() << "/"
+        << (n->GetName() ? n->GetName() : "(undefined)") << "/"
+        << (n->GetID() ? n->GetID() : "(undefined)")
+        << "[" << n << "]" << " already added");
+      continue;
+    }
+    validNodesToAdd.push_back(n);
+    nodesToAddCollection->AddItem(n);
+  }
+  if (validNodesToAdd.empty())
+  {
+    return;
+  }
+
+  this->StartState(vtkMRMLScene::BatchProcessState);
+  this->InvokeEvent(vtkMRMLScene::NodesAboutToBeAddedEvent, nodesToAddCollection.GetPointer());
+
+  // Names in the scene and IDs referenced in the undo stack are collected once,
+  // AddNodeNoNotify() keeps them up-to-date while nodes are added.
+  this->AddingNodes = true;
+  this->AddingNodesNames.clear();
+  for (this->Nodes->InitTraversal(it);
+       (sceneNode = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+  {
+    if (sceneNode->GetName())
+    {
+      this->AddingNodesNames.insert(sceneNode->GetName());
+    }
+  }
+  this->GetNodeReferenceIDsFromUndoStack(this->AddingNodesUndoReferenceIDs);
+
+  // Nodes in the scene that correspond to the nodes to add (singletons may be merged into existing nodes)
+  std::vector<vtkMRMLNode*> sceneNodesToUpdate;
+  vtkNew<vtkCollection> addedNodesCollection;
+  for (vtkMRMLNode* n : validNodesToAdd)
+  {
+    bool add = (n->GetSingletonTag() == nullptr || this->GetSingletonNode(n) == nullptr);
+    if (add)
+    {
+      this->InvokeEvent(this->NodeAboutToBeAddedEvent, n);
+    }
+    vtkMRMLNode* node = this->AddNodeNoNotify(n);
+    if (!node)
+    {
+      continue;
+    }
+    sceneNodesToUpdate.push_back(node);
+    if (add)
+    {
+      addedNodesCollection->AddItem(node);
+    }
+  }
+
+  this->AddingNodes = false;
+  this->AddingNodesNames.clear();
+  this->AddingNodesUndoReferenceIDs.clear();
+
+  for (int nodeIndex = 0; nodeIndex < addedNodesCollection->GetNumberOfItems(); ++nodeIndex)
+  {
+    this->InvokeEvent(this->NodeAddedEvent, addedNodesCollection->GetItemAsObject(nodeIndex));
+  }
+  // Convert all node reference IDs to pointers and add observers after all the nodes are added,
+  // so that references between the added nodes are resolved, too
+  // (only do that if not importing, because during import node IDs are not final yet).
+  if (!this->IsImporting() && !this->IsRestoring())
+  {
+    for (vtkMRMLNode* node : sceneNodesToUpdate)
+    {
+      node->UpdateNodeReferences();
+    }
+  }
+  this->InvokeEvent(vtkMRMLScene::NodesAddedEvent, addedNodesCollection.GetPointer());
+  this->Modified();
+  this->EndState(vtkMRMLScene::BatchProcessState);
+
+  if (addedNodes)
+  {
+    for (int nodeIndex = 0; nodeIndex < addedNodesCollection->GetNumberOfItems(); ++nodeIndex)
+    {
+      addedNodes->push_back(vtkMRMLNode::SafeDownCast(addedNodesCollection->GetItemAsObject(nodeIndex)));
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLScene::AddNodes(vtkCollection* nodesToAdd, vtkCollection* addedNodes/*=nullptr*/)
+{
+  if (addedNodes)
+  {
+    addedNodes->RemoveAllItems();
+  }
+  if (!nodesToAdd)
+  {
+    vtkErrorMacro("AddNodes: invalid input node collection");
+    return;
+  }
+  std::vector<vtkMRMLNode*> nodes;
+  for (int nodeIndex = 0; nodeIndex < nodesToAdd->GetNumberOfItems(); ++nodeIndex)
+  {
+    nodes.push_back(vtkMRMLNode::SafeDownCast(nodesToAdd->GetItemAsObject(nodeIndex)));
+  }
+  std::vector<vtkMRMLNode*> addedNodesVector;
+  this->AddNodes(nodes, addedNodes ? &addedNodesVector : nullptr);
+  if (addedNodes)
+  {
+    for (vtkMRMLNode* node : addedNodesVector)
+    {
+      addedNodes->AddItem(node);
+    }
+  }
+}
+
 //------------------------------------------------------------------------------
 vtkMRMLNode* vtkMRMLScene::AddNewNodeByClass(
     std::string className, std::string nodeBaseName /* = "" */)
@@ -1578,7 +1768,7 @@ void vtkMRMLScene::RemoveNode(vtkMRMLNode *n)
     if (referencedNodeIdIt!=this->NodeReferences.end())
     {
       // make a copy of the referring node list, as the list may change as a result of UpdateReferences calls
-      std::set<std::string> referringNodes=referencedNodeIdIt->second;
+      NodeReferencesType::mapped_type referringNodes=referencedNodeIdIt->second;
       for (NodeReferencesType::value_type::second_type::iterator referringNodesIt = referringNodes.begin();
         referringNodesIt != referringNodes.end();
         ++referringNodesIt)
@@ -1619,6 +1809,11 @@ void vtkMRMLScene::RemoveReferencedNodeID(const char *id, vtkMRMLNode *referenci
     return;
   }
   referenceIt->second.erase(referencingNode->GetID());
+  NodeReferencesType::iterator referencedIDsIt = this->NodeReferencedIDs.find(referencingNode->GetID());
+  if (referencedIDsIt != this->NodeReferencedIDs.end())
+  {
+    referencedIDsIt->second.erase(id);
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -1636,18 +1831,22 @@ void vtkMRMLScene::RemoveNodeReferences(vtkMRMLNode *n)
   }
   std::string nid=n->GetID();
 
-  NodeReferencesType::value_type::second_type::iterator referringNodesIt;
-  for (NodeReferencesType::iterator referenceIt = this->NodeReferences.begin();
-    referenceIt != this->NodeReferences.end();
-    ++referenceIt)
+  // Only visit the IDs that this node refers to
+  NodeReferencesType::iterator referencedIDsIt = this->NodeReferencedIDs.find(nid);
+  if (referencedIDsIt == this->NodeReferencedIDs.end())
   {
-    referringNodesIt=referenceIt->second.find(nid);
-    if (referringNodesIt!=referenceIt->second.end())
+    return;
+  }
+  for (const std::string& referencedID : referencedIDsIt->second)
+  {
+    NodeReferencesType::iterator referenceIt = this->NodeReferences.find(referencedID);
+    if (referenceIt != this->NodeReferences.end())
     {
       // observation has been deleted, so remove it from the index
-      referenceIt->second.erase(referringNodesIt);
+      referenceIt->second.erase(nid);
     }
   }
+  this->NodeReferencedIDs.erase(referencedIDsIt);
 }
 
 //------------------------------------------------------------------------------
@@ -1694,6 +1893,21 @@ void vtkMRMLScene::RemoveUnusedNodeReferences()
     // go to next referenced ID
     ++referenceIt;
   }
+
+  this->UpdateNodeReferencedIDs();
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLScene::UpdateNodeReferencedIDs()
+{
+  this->NodeReferencedIDs.clear();
+  for (const NodeReferencesType::value_type& reference : this->NodeReferences)
+  {
+    for (const std::string& referencingID : reference.second)
+    {
+      this->NodeReferencedIDs[referencingID].insert(reference.first);
+    }
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -1704,7 +1918,20 @@ void vtkMRMLScene::RemoveReferencesToNode(vtkMRMLNode *n)
     vtkErrorMacro("RemoveReferencesToNode: node is null or has null id, can't remove refs");
     return;
   }
-  this->NodeReferences.erase(n->GetID());
+  NodeReferencesType::iterator referenceIt = this->NodeReferences.find(n->GetID());
+  if (referenceIt == this->NodeReferences.end())
+  {
+    return;
+  }
+  for (const std::string& referencingID : referenceIt->second)
+  {
+    NodeReferencesType::iterator referencedIDsIt = this->NodeReferencedIDs.find(referencingID);
+    if (referencedIDsIt != this->NodeReferencedIDs.end())
+    {
+      referencedIDsIt->second.erase(n->GetID());
+    }
+  }
+  this->NodeReferences.erase(referenceIt);
 }
 
 //------------------------------------------------------------------------------
@@ -2311,6 +2538,9 @@ void vtkMRMLScene::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "LastLoadedExtensions= " << (this->GetLastLoadedExtensions() ? this->GetLastLoadedExtensions() : "NULL") << "\n";
   os << indent << "URL = " << this->GetURL() << "\n";
   os << indent << "Root Directory = " << this->GetRootDirectory() << "\n";
+  os << indent << "MaximumNumberOfBundleWriteThreads = " << this->MaximumNumberOfBundleWriteThreads << "\n";
+  os << indent << "LazyBundleDataLoading = " << (this->LazyBundleDataLoading ? "true" : "false") << "\n";
+  os << indent << "NumberOfNodesWithDeferredBundleData = " << this->DeferredBundleData.size() << "\n";
 
   this->Nodes->vtkCollection::PrintSelf(os,indent);
   std::list<std::string> classes = this->GetNodeClassesList();
@@ -2513,6 +2743,12 @@ bool vtkMRMLScene::IsNodeIDReservedByUndo(const std::string id) const
     return false;
   }
 
+  if (this->AddingNodes)
+  {
+    // Undo stack is not changed while AddNodes() adds nodes
+    return this->AddingNodesUndoReferenceIDs.find(id) != this->AddingNodesUndoReferenceIDs.end();
+  }
+
   std::set<std::string> undoReferenceIDs;
   this->GetNodeReferenceIDsFromUndoStack(undoReferenceIDs);
   if (undoReferenceIDs.find(id) != undoReferenceIDs.end())
@@ -2626,7 +2862,14 @@ int vtkMRMLScene::GetUniqueNameIndex(const std::string& baseName)
   {
     ++index;
     std::string candidateName = this->BuildName(baseName, index);
-    isUnique = (this->GetFirstNodeByName(candidateName.c_str()) == nullptr);
+    if (this->AddingNodes)
+    {
+      isUnique = (this->AddingNodesNames.find(candidateName) == this->AddingNodesNames.end());
+    }
+    else
+    {
+      isUnique = (this->GetFirstNodeByName(candidateName.c_str()) == nullptr);
+    }
   }
   return index;
 }
@@ -3212,6 +3455,7 @@ void vtkMRMLScene::AddReferencedNodeID(const char *id, vtkMRMLNode *referencingN
     return;
   }
   this->NodeReferences[id].insert(referencingNode->GetID());
+  this->NodeReferencedIDs[referencingNode->GetID()].insert(id);
 }
 
 //------------------------------------------------------------------------------
@@ -3285,6 +3529,17 @@ const char* vtkMRMLScene::GetChangedID(const char* id)
 //------------------------------------------------------------------------------
 void vtkMRMLScene::UpdateNodeReferences(vtkCollection* checkNodes/*=nullptr*/)
 {
+  // Collect the nodes to check once instead of searching the collection for each referencing node
+  std::set<vtkMRMLNode*> checkNodesSet;
+  if (checkNodes != nullptr)
+  {
+    vtkObject* checkNode = nullptr;
+    vtkCollectionSimpleIterator it;
+    for (checkNodes->InitTraversal(it); (checkNode = checkNodes->GetNextItemAsObject(it));)
+    {
+      checkNodesSet.insert(vtkMRMLNode::SafeDownCast(checkNode));
+    }
+  }
   for (std::map< std::string, std::string>::const_iterator iterChanged = this->ReferencedIDChanges.begin();
     iterChanged != this->ReferencedIDChanges.end(); iterChanged++)
   {
@@ -3297,7 +3552,7 @@ void vtkMRMLScene::UpdateNodeReferences(vtkCollection* checkNodes/*=nullptr*/)
       continue;
     }
     // make a copy of the node list, as the list may change as a result of UpdateReferenceID calls
-    std::set<std::string> nodesToNotify=referencedIdIt->second;
+    NodeReferencesType::mapped_type nodesToNotify=referencedIdIt->second;
     for (NodeReferencesType::value_type::second_type::iterator referringNodesIt = nodesToNotify.begin();
       referringNodesIt!=nodesToNotify.end();
       ++referringNodesIt)
@@ -3307,7 +3562,7 @@ void vtkMRMLScene::UpdateNodeReferences(vtkCollection* checkNodes/*=nullptr*/)
       {
         continue;
       }
-      if (checkNodes!=nullptr && !checkNodes->IsItemPresent(node))
+      if (checkNodes!=nullptr && checkNodesSet.find(node) == checkNodesSet.end())
       {
         continue;
       }
@@ -3343,15 +3598,13 @@ void vtkMRMLScene::AddReferencedNodes(vtkMRMLNode *node, vtkCollection *refNodes
 
   std::deque<vtkMRMLNode*> newFoundReferencedNodes;
 
-  for (NodeReferencesType::iterator referenceIt = this->NodeReferences.begin();
-    referenceIt != this->NodeReferences.end();
-    ++referenceIt)
+  NodeReferencesType::iterator referencedIDsIt = this->NodeReferencedIDs.find(node->GetID());
+  if (referencedIDsIt != this->NodeReferencedIDs.end())
   {
-    NodeReferencesType::value_type::second_type::iterator referringNodesIt = referenceIt->second.find(node->GetID());
-    if (referringNodesIt!=referenceIt->second.end())
+    for (const std::string& referencedID : referencedIDsIt->second)
     {
       // this ID is referenced by this node
-      vtkMRMLNode *referencedNode = this->GetNodeByID(referenceIt->first);
+      vtkMRMLNode *referencedNode = this->GetNodeByID(referencedID);
       if (referencedNode!=nullptr && !refNodes->IsItemPresent(referencedNode))
       {
         // this ID is not yet in the list of reference nodes, so add it
@@ -3416,6 +3669,21 @@ void vtkMRMLScene::GetReferencingNodes(vtkMRMLNode* referencedNode, std::vector<
   }
 }
 
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::GetReferencingNodes(vtkMRMLNode* referencedNode, const char* referenceRole,
+  std::vector<vtkMRMLNode *> &referencingNodes)
+{
+  this->GetReferencingNodes(referencedNode, referencingNodes);
+  if (!referenceRole || referencingNodes.empty())
+  {
+    return;
+  }
+  const char* referencedId = referencedNode->GetID();
+  referencingNodes.erase(std::remove_if(referencingNodes.begin(), referencingNodes.end(),
+    [referenceRole, referencedId](vtkMRMLNode* node) { return !node->HasNodeReferenceID(referenceRole, referencedId); }),
+    referencingNodes.end());
+}
+
 //------------------------------------------------------------------------------
 void vtkMRMLScene::CopyNodeReferences(vtkMRMLScene *scene)
 {
@@ -3426,6 +3694,7 @@ void vtkMRMLScene::CopyNodeReferences(vtkMRMLScene *scene)
 
   //assuming the nodes exist in this scene
   this->NodeReferences=scene->NodeReferences;
+  this->NodeReferencedIDs=scene->NodeReferencedIDs;
 }
 
 //------------------------------------------------------------------------------
@@ -3834,16 +4103,38 @@ int vtkMRMLScene::GetNumberOfNodeReferences()
   return totalNumberOfReferences;
 }
 
+namespace
+{
+//-----------------------------------------------------------------------------
+// Node references are stored in a hash map, which has no well-defined order.
+// Return the references sorted by referenced ID, so that the n-th
+// ReferencedID-ReferencingNode pair does not depend on the hashing.
+template <class NodeReferencesMapType>
+std::vector<typename NodeReferencesMapType::const_iterator> GetSortedNodeReferences(
+  const NodeReferencesMapType& nodeReferences)
+{
+  std::vector<typename NodeReferencesMapType::const_iterator> sortedReferences;
+  sortedReferences.reserve(nodeReferences.size());
+  for (typename NodeReferencesMapType::const_iterator referenceIt = nodeReferences.begin();
+    referenceIt != nodeReferences.end(); ++referenceIt)
+  {
+    sortedReferences.push_back(referenceIt);
+  }
+  std::sort(sortedReferences.begin(), sortedReferences.end(),
+    [](const typename NodeReferencesMapType::const_iterator& a, const typename NodeReferencesMapType::const_iterator& b)
+    { return a->first < b->first; });
+  return sortedReferences;
+}
+}
+
 //-----------------------------------------------------------------------------
 vtkMRMLNode* vtkMRMLScene::GetNthReferencingNode(int n)
 {
-  for (NodeReferencesType::iterator referenceIt = this->NodeReferences.begin();
-    referenceIt != this->NodeReferences.end();
-    ++referenceIt)
+  for (const NodeReferencesType::const_iterator& referenceIt : GetSortedNodeReferences(this->NodeReferences))
   {
     if (n<static_cast<int>(referenceIt->second.size()))
     {
-      NodeReferencesType::value_type::second_type::iterator referringNodesIt=referenceIt->second.begin();
+      NodeReferencesType::mapped_type::const_iterator referringNodesIt=referenceIt->second.begin();
       std::advance( referringNodesIt, n );
       return this->GetNodeByID(*referringNodesIt);
     }
@@ -3855,13 +4146,10 @@ vtkMRMLNode* vtkMRMLScene::GetNthReferencingNode(int n)
 //-----------------------------------------------------------------------------
 const char* vtkMRMLScene::GetNthReferencedID(int n)
 {
-  for (NodeReferencesType::iterator referenceIt = this->NodeReferences.begin();
-    referenceIt != this->NodeReferences.end();
-    ++referenceIt)
+  for (const NodeReferencesType::const_iterator& referenceIt : GetSortedNodeReferences(this->NodeReferences))
   {
     if (n<static_cast<int>(referenceIt->second.size()))
     {
-      //NodeReferencesType::value_type::second_type::iterator referringNodesIt=referenceIt->second.begin();
       return referenceIt->first.c_str();
     }
     n-=referenceIt->second.size();
@@ -3969,22 +4257,39 @@ bool vtkMRMLScene::WriteToMRB(const char* filename, vtkImageData* thumbnail/*=nu
   }
 
   //
-  // Now save the scene into the bundle directory and then make a zip (mrb) file
-  // in the user's selected file location
+  // Now save the scene into the bundle directory. Files are added to the zip (mrb) file
+  // in the user's selected file location as soon as they are written.
   //
-  bool retval = this->SaveSceneToSlicerDataBundleDirectory(bundleDir.c_str(), thumbnail, userMessages);
-  if (!retval)
+  vtkDebugMacro("Zipping to " << mrbFilePath);
+  vtkNew<vtkArchive> archive;
+  if (!archive->BeginZip(mrbFilePath.c_str())
+    || !archive->AddDirectoryToZip(vtksys::SystemTools::GetFilenameName(bundleDir).c_str()))
   {
+    archive->EndZip();
     vtkErrorToMessageCollectionMacro(userMessages, "vtkMRMLScene::WriteToMRB",
-      "Failed to save '" << filename << "': Failed to save scene to data bundle directory '" << bundleDir << "'");
+      "Failed to save '" << filename << "': Could not create archive file");
     return false;
   }
 
-  vtkDebugMacro("Zipping to " << mrbFilePath);
-  if (!vtkArchive::Zip(mrbFilePath.c_str(), bundleDir.c_str()))
+  bool retval = this->SaveSceneToSlicerDataBundleDirectoryInternal(bundleDir.c_str(), thumbnail, userMessages, archive);
+  if (!archive->EndZip())
+  {
+    if (retval)
+    {
+      vtkErrorToMessageCollectionMacro(userMessages, "vtkMRMLScene::WriteToMRB",
+        "Failed to save '" << filename << "': Could not compress bundle in directory '" << bundleDir << "'");
+    }
+    retval = false;
+  }
+  else if (!retval)
   {
     vtkErrorToMessageCollectionMacro(userMessages, "vtkMRMLScene::WriteToMRB",
-      "Failed to save '" << filename << "': Could not compress bundle in directory '" << bundleDir << "'");
+      "Failed to save '" << filename << "': Failed to save scene to data bundle directory '" << bundleDir << "'");
+  }
+  if (!retval)
+  {
+    // do not leave an incomplete archive behind
+    vtksys::SystemTools::RemoveFile(mrbFilePath);
     return false;
   }
 
@@ -4011,6 +4316,16 @@ bool vtkMRMLScene::ReadFromMRB(const char* fullName, bool clear/*=false*/, vtkMR
     userMessages = vtkSmartPointer<vtkMRMLMessageCollection>::New();
   }
 
+  // Only one bundle is read from at a time
+  if (clear)
+  {
+    this->CloseBundle();
+  }
+  else
+  {
+    this->LoadDeferredBundleData();
+  }
+
   std::string tempBaseDir;
   if (this->GetDataIOManager()
     && this->GetDataIOManager()->GetCacheManager()
@@ -4048,9 +4363,49 @@ bool vtkMRMLScene::ReadFromMRB(const char* fullName, bool clear/*=false*/, vtkMR
     return false;
   }
 
-  std::string mrmlFile = vtkMRMLScene::UnpackSlicerDataBundle(fullName, unpackDir.c_str());
+  // Only extract the scene file, storage nodes extract data files from the bundle when they read them.
+  // If the zip index cannot be read directly then fall back to extracting the entire bundle.
+  std::string mrmlFile;
+  vtkArchive* archive = vtkArchive::New();
+  if (archive->OpenZipIndex(fullName))
+  {
+    // use the first scene file that is closest to the top of the bundle
+    int mrmlEntryIndex = -1;
+    size_t mrmlEntryDepth = 0;
+    for (int entryIndex = 0; entryIndex < archive->GetNumberOfZipEntries(); ++entryIndex)
+    {
+      std::string entryName = archive->GetNthZipEntryName(entryIndex);
+      if (entryName.size() < 5 || vtksys::SystemTools::LowerCase(entryName.substr(entryName.size() - 5)) != ".mrml")
+      {
+        continue;
+      }
+      size_t entryDepth = std::count(entryName.begin(), entryName.end(), '/');
+      if (mrmlEntryIndex < 0 || entryDepth < mrmlEntryDepth)
+      {
+        mrmlEntryIndex = entryIndex;
+        mrmlEntryDepth = entryDepth;
+      }
+    }
+    std::string mrmlEntryFile = unpackDir + "/" + archive->GetNthZipEntryName(mrmlEntryIndex);
+    if (mrmlEntryIndex >= 0 && archive->ExtractNthZipEntry(mrmlEntryIndex, mrmlEntryFile.c_str()))
+    {
+      mrmlFile = mrmlEntryFile;
+    }
+  }
+  if (mrmlFile.empty())
+  {
+    archive->Delete();
+    mrmlFile = vtkMRMLScene::UnpackSlicerDataBundle(fullName, unpackDir.c_str());
+  }
+  else
+  {
+    this->BundleArchive = archive;
+    this->BundleExtractDirectory = unpackDir;
+  }
+
   this->SetURL(mrmlFile.c_str());
   int success = false;
+  this->BundleReadInProgress = true;
   if (clear)
   {
     success = this->Connect(userMessages);
@@ -4059,6 +4414,7 @@ bool vtkMRMLScene::ReadFromMRB(const char* fullName, bool clear/*=false*/, vtkMR
   {
     success = this->Import(userMessages);
   }
+  this->BundleReadInProgress = false;
   if (!vtksys::SystemTools::RemoveADirectory(unpackDir))
   {
     vtkWarningToMessageCollectionMacro(userMessages, "vtkMRMLScene::ReadFromMRB",
@@ -4126,6 +4482,12 @@ bool vtkMRMLScene::ReadFromMRB(const char* fullName, bool clear/*=false*/, vtkMR
   // and mark storable nodes as modified since read
   this->SetStorableNodesModifiedSinceRead();
 
+  // keep the bundle open only if there are nodes that will read their data later
+  if (this->DeferredBundleData.empty())
+  {
+    this->CloseBundle();
+  }
+
   if (userMessages->GetNumberOfMessagesOfType(vtkCommand::ErrorEvent) > 0)
   {
     success = 0;
@@ -4173,9 +4535,407 @@ std::string vtkMRMLScene::UnpackSlicerDataBundle(const char* sdbFilePath, const
   return(files[0]);
 }
 
+//----------------------------------------------------------------------------
+vtkArchive* vtkMRMLScene::GetBundleArchive()
+{
+  return this->BundleArchive;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLScene::ExtractFromBundle(vtkMRMLStorageNode* storageNode, vtkMRMLNode* refNode,
+  std::vector<std::string>& extractedFileNames)
+{
+  if (!this->BundleArchive || !storageNode)
+  {
+    return false;
+  }
+
+  // Defer reading data of hidden nodes
+  vtkMRMLDisplayableNode* displayableNode = vtkMRMLDisplayableNode::SafeDownCast(refNode);
+  if (this->LazyBundleDataLoading && this->BundleReadInProgress
+    && displayableNode && !displayableNode->IsA("vtkMRMLVolumeNode")
+    && displayableNode->GetNumberOfDisplayNodes() > 0)
+  {
+    bool visible = false;
+    for (int displayNodeIndex = 0; displayNodeIndex < displayableNode->GetNumberOfDisplayNodes(); ++displayNodeIndex)
+    {
+      vtkMRMLDisplayNode* displayNode = displayableNode->GetNthDisplayNode(displayNodeIndex);
+      if (!displayNode || displayNode->GetVisibility())
+      {
+        visible = true;
+        break;
+      }
+    }
+    if (!visible)
+    {
+      DeferredBundleDataItem item;
+      item.StorableNode = displayableNode;
+      item.StorageNode = storageNode;
+      item.FileName = (storageNode->GetFileName() ? storageNode->GetFileName() : "");
+      for (int fileIndex = 0; fileIndex < storageNode->GetNumberOfFileNames(); ++fileIndex)
+      {
+        item.FileNameList.emplace_back(storageNode->GetNthFileName(fileIndex));
+      }
+      if (!this->HasDeferredBundleData(displayableNode))
+      {
+        displayableNode->AddObserver(vtkMRMLDisplayableNode::DisplayModifiedEvent, this->DeferredBundleDataCallback);
+      }
+      this->DeferredBundleData.push_back(item);
+      return true;
+    }
+  }
+
+  // Collect names of archive entries that the storage node needs
+  std::vector<std::string> fileNames;
+  if (storageNode->GetFileName())
+  {
+    fileNames.push_back(storageNode->GetFullNameFromFileName());
+  }
+  for (int fileIndex = 0; fileIndex < storageNode->GetNumberOfFileNames(); ++fileIndex)
+  {
+    fileNames.push_back(storageNode->GetFullNameFromNthFileName(fileIndex));
+  }
+  std::set<int> entryIndices;
+  for (const std::string& fileName : fileNames)
+  {
+    std::string entryName = vtksys::SystemTools::RelativePath(this->BundleExtractDirectory, fileName);
+    if (entryName.empty() || vtksys::SystemTools::StringStartsWith(entryName, ".."))
+    {
+      // not in the bundle
+      continue;
+    }
+    int entryIndex = this->BundleArchive->FindZipEntry(entryName.c_str());
+    if (entryIndex < 0)
+    {
+      continue;
+    }
+    entryIndices.insert(entryIndex);
+    // Companion files (for example, image data of a detached header) have the same base name
+    std::string entryDirectory = vtksys::SystemTools::GetFilenamePath(entryName);
+    std::string companionPrefix = vtksys::SystemTools::GetFilenameWithoutLastExtension(entryName) + ".";
+    if (!entryDirectory.empty())
+    {
+      companionPrefix = entryDirectory + "/" + vtksys::SystemTools::GetFilenameWithoutLastExtension(
+        vtksys::SystemTools::GetFilenameName(entryName)) + ".";
+    }
+    for (int companionIndex = 0; companionIndex < this->BundleArchive->GetNumberOfZipEntries(); ++companionIndex)
+    {
+      std::string companionName = this->BundleArchive->GetNthZipEntryName(companionIndex);
+      if (vtksys::SystemTools::StringStartsWith(companionName, companionPrefix.c_str())
+        && companionName.find('/', companionPrefix.size()) == std::string::npos)
+      {
+        entryIndices.insert(companionIndex);
+      }
+    }
+  }
+
+  for (int entryIndex : entryIndices)
+  {
+    std::string extractedFileName = this->BundleExtractDirectory + "/" + this->BundleArchive->GetNthZipEntryName(entryIndex);
+    if (vtksys::SystemTools::FileExists(extractedFileName))
+    {
+      continue;
+    }
+    if (!this->BundleArchive->ExtractNthZipEntry(entryIndex, extractedFileName.c_str()))
+    {
+      vtkWarningToMessageCollectionMacro(storageNode->GetUserMessages(), "vtkMRMLScene::ExtractFromBundle",
+        "Failed to extract " << this->BundleArchive->GetNthZipEntryName(entryIndex) << " from the scene bundle.");
+      continue;
+    }
+    extractedFileNames.push_back(extractedFileName);
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLScene::ReleaseBundleFiles(const std::vector<std::string>& extractedFileNames)
+{
+  for (const std::string& extractedFileName : extractedFileNames)
+  {
+    vtksys::SystemTools::RemoveFile(extractedFileName);
+  }
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLScene::HasDeferredBundleData(vtkMRMLStorableNode* node/*=nullptr*/)
+{
+  if (!node)
+  {
+    return !this->DeferredBundleData.empty();
+  }
+  for (const DeferredBundleDataItem& item : this->DeferredBundleData)
+  {
+    if (item.StorableNode == node)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLScene::LoadDeferredBundleData(vtkMRMLStorableNode* node/*=nullptr*/)
+{
+  // Remove items from the list before reading, as reading may trigger loading of other nodes
+  std::vector<DeferredBundleDataItem> itemsToLoad;
+  for (std::vector<DeferredBundleDataItem>::iterator itemIt = this->DeferredBundleData.begin();
+    itemIt != this->DeferredBundleData.end();)
+  {
+    if (!node || itemIt->StorableNode == node)
+    {
+      itemsToLoad.push_back(*itemIt);
+      itemIt = this->DeferredBundleData.erase(itemIt);
+    }
+    else
+    {
+      ++itemIt;
+    }
+  }
+
+  bool success = true;
+  for (DeferredBundleDataItem& item : itemsToLoad)
+  {
+    vtkMRMLStorableNode* storableNode = item.StorableNode;
+    vtkMRMLStorageNode* storageNode = item.StorageNode;
+    if (!storableNode || !storageNode || storableNode->GetScene() != this)
+    {
+      // node has been removed
+      continue;
+    }
+    if (!this->HasDeferredBundleData(storableNode))
+    {
+      storableNode->RemoveObserver(this->DeferredBundleDataCallback);
+    }
+
+    // Use the file names that the storage node had when reading was deferred
+    std::string currentFileName = (storageNode->GetFileName() ? storageNode->GetFileName() : "");
+    std::vector<std::string> currentFileNameList;
+    for (int fileIndex = 0; fileIndex < storageNode->GetNumberOfFileNames(); ++fileIndex)
+    {
+      currentFileNameList.emplace_back(storageNode->GetNthFileName(fileIndex));
+    }
+    int disabledModify = storageNode->StartModify();
+    storageNode->SetFileName(item.FileName.empty() ? nullptr : item.FileName.c_str());
+    storageNode->ResetFileNameList();
+    for (const std::string& fileName : item.FileNameList)
+    {
+      storageNode->AddFileName(fileName.c_str());
+    }
+    storageNode->SetDisableModifiedEvent(disabledModify);
+
+    storageNode->GetUserMessages()->ClearMessages();
+    if (!storageNode->ReadData(storableNode))
+    {
+      vtkErrorMacro("LoadDeferredBundleData: failed to read data of node " << (storableNode->GetID() ? storableNode->GetID() : "(null)")
+        << " from the scene bundle. " << storageNode->GetUserMessages()->GetAllMessagesAsString());
+      success = false;
+    }
+
+    disabledModify = storageNode->StartModify();
+    storageNode->SetFileName(currentFileName.empty() ? nullptr : currentFileName.c_str());
+    storageNode->ResetFileNameList();
+    for (const std::string& fileName : currentFileNameList)
+    {
+      storageNode->AddFileName(fileName.c_str());
+    }
+    storageNode->SetDisableModifiedEvent(disabledModify);
+
+    // data is not stored at the current file location yet
+    storableNode->StorableModified();
+  }
+
+  if (this->DeferredBundleData.empty() && !this->BundleReadInProgress)
+  {
+    this->CloseBundle();
+  }
+  return success;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLScene::CloseBundle()
+{
+  for (const DeferredBundleDataItem& item : this->DeferredBundleData)
+  {
+    if (item.StorableNode)
+    {
+      item.StorableNode->RemoveObserver(this->DeferredBundleDataCallback);
+    }
+  }
+  this->DeferredBundleData.clear();
+  if (this->BundleArchive)
+  {
+    this->BundleArchive->Delete();
+    this->BundleArchive = nullptr;
+  }
+  if (!this->BundleExtractDirectory.empty() && vtksys::SystemTools::FileIsDirectory(this->BundleExtractDirectory))
+  {
+    vtksys::SystemTools::RemoveADirectory(this->BundleExtractDirectory);
+  }
+  this->BundleExtractDirectory.clear();
+}
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+struct BundleNodeWriteItem
+{
+  vtkMRMLStorableNode* StorableNode{ nullptr };
+  vtkMRMLStorageNode* StorageNode{ nullptr };
+  bool Concurrent{ false };
+  int WasModifying{ 0 };
+  int Success{ 0 };
+  bool Completed{ false };
+};
+
+//----------------------------------------------------------------------------
+void AddStorageNodeMessages(vtkMRMLStorableNode* storableNode, vtkMRMLStorageNode* storageNode,
+  vtkMRMLMessageCollection* userMessages)
+{
+  if (!userMessages)
+  {
+    return;
+  }
+  std::string messagePrefix = std::string(storableNode->GetName() ? storableNode->GetName() : "unknown") + " ("
+    + (storableNode->GetID() ? storableNode->GetID() : "none") + "): ";
+  userMessages->AddMessages(storageNode->GetUserMessages(), messagePrefix);
+}
+
+//----------------------------------------------------------------------------
+bool AddStorageNodeFilesToArchive(vtkMRMLStorageNode* storageNode, vtkArchive* archive, const std::string& archiveBaseDir)
+{
+  std::vector<std::string> fileNames;
+  fileNames.push_back(storageNode->GetFullNameFromFileName());
+  for (int i = 0; i < storageNode->GetNumberOfFileNames(); ++i)
+  {
+    fileNames.push_back(storageNode->GetFullNameFromNthFileName(i));
+  }
+  bool success = true;
+  for (const std::string& fileName : fileNames)
+  {
+    if (fileName.empty() || !vtksys::SystemTools::FileExists(fileName, true))
+    {
+      // skipped or not written (e.g., empty model), nothing to add
+      continue;
+    }
+    std::string entryName = vtksys::SystemTools::RelativePath(archiveBaseDir, fileName);
+    if (archive->HasZipEntry(entryName.c_str()))
+    {
+      continue;
+    }
+    if (!archive->AddFileToZip(fileName.c_str(), entryName.c_str()))
+    {
+      success = false;
+    }
+  }
+  return success;
+}
+
+//----------------------------------------------------------------------------
+/// Write data of storable nodes. Nodes that allow it are written in worker threads,
+/// all other nodes in the calling thread. Write results (user messages, archive entries)
+/// are processed in the order of the items, so the output does not depend on the order
+/// in which the writes are completed.
+bool WriteStorableNodes(std::vector<BundleNodeWriteItem>& items, int maximumNumberOfThreads,
+  vtkMRMLMessageCollection* userMessages, vtkArchive* archive, const std::string& archiveBaseDir)
+{
+  std::vector<size_t> concurrentItemIndices;
+  for (size_t itemIndex = 0; itemIndex < items.size(); ++itemIndex)
+  {
+    BundleNodeWriteItem& item = items[itemIndex];
+    item.StorageNode->GetUserMessages()->ClearMessages();
+    if (maximumNumberOfThreads != 1 && item.StorageNode->CanWriteDataConcurrently(item.StorableNode))
+    {
+      // Modified events of the storage node are invoked when the write is completed, in this thread
+      item.Concurrent = true;
+      item.WasModifying = item.StorageNode->StartModify();
+      concurrentItemIndices.push_back(itemIndex);
+    }
+  }
+
+  int numberOfThreads = maximumNumberOfThreads;
+  if (numberOfThreads <= 0)
+  {
+    numberOfThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  }
+  numberOfThreads = std::min(numberOfThreads, static_cast<int>(concurrentItemIndices.size()));
+
+  std::mutex completedMutex;
+  std::condition_variable completedCondition;
+  std::atomic<size_t> nextConcurrentItem(0);
+  auto writeConcurrentItems = [&]()
+  {
+    for (size_t next = nextConcurrentItem++; next < concurrentItemIndices.size(); next = nextConcurrentItem++)
+    {
+      BundleNodeWriteItem& item = items[concurrentItemIndices[next]];
+      int success = 0;
+      try
+      {
+        success = item.StorageNode->WriteData(item.StorableNode);
+      }
+      catch (...)
+      {
+        success = 0;
+      }
+      {
+        std::lock_guard<std::mutex> lock(completedMutex);
+        item.Success = success;
+        item.Completed = true;
+      }
+      completedCondition.notify_all();
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int threadIndex = 0; threadIndex < numberOfThreads; ++threadIndex)
+  {
+    threads.emplace_back(writeConcurrentItems);
+  }
+
+  bool success = true;
+  for (BundleNodeWriteItem& item : items)
+  {
+    if (item.Concurrent)
+    {
+      {
+        std::unique_lock<std::mutex> lock(completedMutex);
+        completedCondition.wait(lock, [&item] { return item.Completed; });
+      }
+      item.StorageNode->EndModify(item.WasModifying);
+    }
+    else
+    {
+      item.Success = item.StorageNode->WriteData(item.StorableNode);
+    }
+    if (!item.Success)
+    {
+      success = false;
+    }
+    AddStorageNodeMessages(item.StorableNode, item.StorageNode, userMessages);
+    if (archive && item.Success && !AddStorageNodeFilesToArchive(item.StorageNode, archive, archiveBaseDir))
+    {
+      success = false;
+    }
+  }
+
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+  return success;
+}
+
+} // namespace
+
 //----------------------------------------------------------------------------
 bool vtkMRMLScene::SaveSceneToSlicerDataBundleDirectory(const char* sdbDir,
-  vtkImageData* screenShot/*=nullptr*/, vtkMRMLMessageCollection* userMessagesInput/*=nullptr*/)
+  vtkImageData* screenShot/*=nullptr*/, vtkMRMLMessageCollection* userMessages/*=nullptr*/)
+{
+  return this->SaveSceneToSlicerDataBundleDirectoryInternal(sdbDir, screenShot, userMessages, nullptr);
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLScene::SaveSceneToSlicerDataBundleDirectoryInternal(const char* sdbDir,
+  vtkImageData* screenShot, vtkMRMLMessageCollection* userMessagesInput, vtkArchive* archive)
 {
   // Overview:
   // - confirm the arguments are valid and create directories if needed
@@ -4202,6 +4962,14 @@ bool vtkMRMLScene::SaveSceneToSlicerDataBundleDirectory(const char* sdbDir,
     return false;
   }
 
+  // Nodes may be written in worker threads, therefore deferred data is read here
+  if (!this->LoadDeferredBundleData())
+  {
+    vtkErrorToMessageCollectionMacro(userMessages, "vtkMRMLScene::SaveSceneToSlicerDataBundleDirectory",
+      "Save scene to data bundle directory failed: could not read data of all nodes from the scene bundle");
+    return false;
+  }
+
   // if the path to the directory is not absolute, return
   if (!vtksys::SystemTools::FileIsFullPath(sdbDir))
   {
@@ -4289,12 +5057,15 @@ bool vtkMRMLScene::SaveSceneToSlicerDataBundleDirectory(const char* sdbDir,
   }
 
 
-  // Change all storage nodes and file names to be unique in the new directory.
-  // Write the new data as we go; save old values.
+  // Change all storage nodes and file names to be unique in the new directory; save old values.
   // Use a map to store the file names from a storage node, the 0th one is by
   // definition the GetFileName returned value, then the rest are at index n+1
   // from GetNthFileName(n).
+  // File names are all assigned in node order before writing any data, so that
+  // they do not depend on the order of completion of concurrent writes.
   std::map<vtkMRMLStorageNode*, std::vector<std::string> > originalStorageNodeFileNames;
+  std::set<std::string> usedFileNames;
+  std::vector<BundleNodeWriteItem> writeItems;
 
   bool success = true;
   std::map<std::string, vtkMRMLNode *> storableNodes;
@@ -4313,13 +5084,22 @@ bool vtkMRMLScene::SaveSceneToSlicerDataBundleDirectory(const char* sdbDir,
       // get all storable nodes in the main scene
       // and store them in the map by ID to avoid duplicates for the scene views
       vtkMRMLStorableNode* storableNode = vtkMRMLStorableNode::SafeDownCast(mrmlNode);
-      if (!this->SaveStorableNodeToSlicerDataBundleDirectory(storableNode, dataDir, originalStorageNodeFileNames, userMessages))
+      BundleNodeWriteItem writeItem;
+      writeItem.StorableNode = storableNode;
+      writeItem.StorageNode = this->PrepareStorableNodeForSlicerDataBundleDirectory(
+        storableNode, dataDir, originalStorageNodeFileNames, usedFileNames);
+      if (writeItem.StorageNode)
       {
-        success = false;
+        writeItems.push_back(writeItem);
       }
       storableNodes[std::string(storableNode->GetID())] = storableNode;
     }
   }
+  std::string archiveBaseDir = vtksys::SystemTools::GetParentDirectory(rootDir);
+  if (!WriteStorableNodes(writeItems, this->MaximumNumberOfBundleWriteThreads, userMessages, archive, archiveBaseDir))
+  {
+    success = false;
+  }
   // Update all storage nodes in all scene views.
   // Nodes that are not present in the main scene are actually saved to file, others just have their paths updated.
   for (int i = 0; i < numNodes; ++i)
@@ -4345,7 +5125,8 @@ bool vtkMRMLScene::SaveSceneToSlicerDataBundleDirectory(const char* sdbDir,
         userMessages->SetObservedObject(storableNode);
         storableNode->UpdateScene(this);
         userMessages->SetObservedObject(nullptr);
-        if (!this->SaveStorableNodeToSlicerDataBundleDirectory(storableNode, dataDir, originalStorageNodeFileNames, userMessages))
+        if (!this->SaveStorableNodeToSlicerDataBundleDirectory(storableNode, dataDir, originalStorageNodeFileNames,
+          usedFileNames, userMessages))
         {
           success = false;
         }
@@ -4384,6 +5165,21 @@ bool vtkMRMLScene::SaveSceneToSlicerDataBundleDirectory(const char* sdbDir,
   vtkDebugMacro("calling commit on the scene, to url " << this->GetURL());
   this->Commit(nullptr, userMessages);
 
+  if (archive)
+  {
+    // add the scene file, then all remaining files (screenshot, files written for scene views, etc.)
+    std::string sceneFileName = this->GetURL();
+    if (vtksys::SystemTools::FileExists(sceneFileName, true)
+      && !archive->AddFileToZip(sceneFileName.c_str(), vtksys::SystemTools::RelativePath(archiveBaseDir, sceneFileName).c_str()))
+    {
+      success = false;
+    }
+    if (!archive->AddDirectoryContentToZip(rootDir.c_str(), archiveBaseDir.c_str()))
+    {
+      success = false;
+    }
+  }
+
   //
   // Now, restore the state of the scene
   //
@@ -4565,12 +5361,31 @@ std::string vtkMRMLScene::CreateUniqueFileName(const std::string& filename, cons
 
 //----------------------------------------------------------------------------
 bool vtkMRMLScene::SaveStorableNodeToSlicerDataBundleDirectory(vtkMRMLStorableNode* storableNode, std::string &dataDir,
-  std::map<vtkMRMLStorageNode*, std::vector<std::string> > &originalStorageNodeFileNames, vtkMRMLMessageCollection* userMessages)
+  std::map<vtkMRMLStorageNode*, std::vector<std::string> > &originalStorageNodeFileNames,
+  std::set<std::string>& usedFileNames, vtkMRMLMessageCollection* userMessages)
 {
-  if (!storableNode || !storableNode->GetSaveWithScene())
+  vtkMRMLStorageNode* storageNode = this->PrepareStorableNodeForSlicerDataBundleDirectory(
+    storableNode, dataDir, originalStorageNodeFileNames, usedFileNames);
+  if (!storageNode)
   {
+    // no need to store this node
     return true;
   }
+  storageNode->GetUserMessages()->ClearMessages();
+  int success = storageNode->WriteData(storableNode);
+  AddStorageNodeMessages(storableNode, storageNode, userMessages);
+  return success;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLStorageNode* vtkMRMLScene::PrepareStorableNodeForSlicerDataBundleDirectory(vtkMRMLStorableNode* storableNode,
+  const std::string& dataDir, std::map<vtkMRMLStorageNode*, std::vector<std::string> > &originalStorageNodeFileNames,
+  std::set<std::string>& usedFileNames)
+{
+  if (!storableNode || !storableNode->GetSaveWithScene())
+  {
+    return nullptr;
+  }
   // adjust the file paths for storable nodes
   vtkMRMLStorageNode* storageNode = storableNode->GetStorageNode();
   if (!storageNode)
@@ -4581,7 +5396,7 @@ bool vtkMRMLScene::SaveStorableNodeToSlicerDataBundleDirectory(vtkMRMLStorableNo
     if (!storageNode)
     {
       // no need for storage node to store this node
-      return true;
+      return nullptr;
     }
   }
 
@@ -4630,25 +5445,26 @@ bool vtkMRMLScene::SaveStorableNodeToSlicerDataBundleDirectory(vtkMRMLStorableNo
     << " file name is now: " << storageNode->GetFileName());
 
   // Make sure the filename is unique (default filenames may be the same if for example there are multiple
-  // nodes with the same name).
+  // nodes with the same name). Files of previous nodes may not be written yet, therefore names that
+  // are already assigned are checked, too. Comparison is case insensitive to get the same names on all platforms.
   std::string existingFileName = (storageNode->GetFileName() ? storageNode->GetFileName() : "");
-  if (vtksys::SystemTools::FileExists(existingFileName, true))
+  std::string uniqueFileName = existingFileName;
+  if (!uniqueFileName.empty())
   {
     std::string currentExtension = storageNode->GetSupportedFileExtension(existingFileName.c_str());
-    std::string uniqueFileName = this->CreateUniqueFileName(existingFileName, currentExtension);
-    vtkDebugMacro("file " << existingFileName << " already exists, use " << uniqueFileName << " filename instead");
-    storageNode->SetFileName(uniqueFileName.c_str());
+    while (usedFileNames.find(vtksys::SystemTools::LowerCase(uniqueFileName)) != usedFileNames.end()
+      || vtksys::SystemTools::FileExists(uniqueFileName, true))
+    {
+      uniqueFileName = this->CreateUniqueFileName(uniqueFileName, currentExtension);
+    }
+    usedFileNames.insert(vtksys::SystemTools::LowerCase(uniqueFileName));
   }
-
-  storageNode->GetUserMessages()->ClearMessages();
-  int success = storageNode->WriteData(storableNode);
-  if (userMessages)
+  if (uniqueFileName != existingFileName)
   {
-    std::string messagePrefix = std::string(storableNode->GetName() ? storableNode->GetName() : "unknown") + " ("
-      + (storableNode->GetID() ? storableNode->GetID() : "none") + "): ";
-    userMessages->AddMessages(storageNode->GetUserMessages(), messagePrefix);
+    vtkDebugMacro("file " << existingFileName << " already exists, use " << uniqueFileName << " filename instead");
+    storageNode->SetFileName(uniqueFileName.c_str());
   }
-  return success;
+  return storageNode;
 }
 
 //----------------------------------------------------------------------------
@@ -17,6 +17,7 @@ Version:   $Revision: 1.18 $
 
 // MRML includes
 #include "vtkMRML.h"
+class vtkArchive;
 class vtkCacheManager;
 class vtkDataIOManager;
 class vtkMRMLMessageCollection;
@@ -43,6 +44,7 @@ class vtkImageData;
 #include <random>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 /// \brief A set of MRML Nodes that supports serialization and undo/redo.
@@ -226,6 +228,31 @@ public:
   /// \sa AddNewNodeByClass(), CreateNodeByClass(), vtkMRMLNode::SetName(), vtkMRMLNode::SetID(), AddNode()
   vtkMRMLNode* AddNewNodeByClassWithID(std::string className, std::string nodeBaseName, std::string nodeID);
 
+  /// \brief Add multiple nodes to the scene in one pass.
+  ///
+  /// Nodes are added the same way as by AddNode() (unique IDs and names are
+  /// generated, singletons are merged into existing singleton nodes), but
+  /// the scene is traversed only once for all the nodes instead of once for
+  /// each node, node references are updated after all the nodes are added
+  /// (so nodes may refer to each other), and the scene is modified only once.
+  ///
+  /// The nodes are added within a vtkMRMLScene::BatchProcessState.
+  /// vtkMRMLScene::NodesAboutToBeAddedEvent is invoked before the nodes are added
+  /// and vtkMRMLScene::NodesAddedEvent is invoked after all the nodes are added,
+  /// with the vtkCollection of nodes as call data. This allows observers to
+  /// process the new nodes in bulk.
+  /// vtkMRMLScene::NodeAboutToBeAddedEvent and vtkMRMLScene::NodeAddedEvent are
+  /// still invoked for each node for backward compatibility: observers that
+  /// handle the aggregated events can ignore them while the scene is batch processing.
+  ///
+  /// Null nodes, nodes that are not allowed to be added to the scene, and nodes that
+  /// are already in the scene are skipped.
+  /// \param addedNodes If not nullptr then nodes that are added to the scene
+  ///   are returned in it (singletons that are merged into existing nodes are not included).
+  /// \sa AddNode()
+  void AddNodes(const std::vector<vtkMRMLNode*>& nodesToAdd, std::vector<vtkMRMLNode*>* addedNodes = nullptr);
+  void AddNodes(vtkCollection* nodesToAdd, vtkCollection* addedNodes = nullptr);
+
   /// Add a copy of a node to the scene.
   vtkMRMLNode* CopyNode(vtkMRMLNode *n);
 
@@ -420,6 +447,8 @@ public:
   /// that is 'has an interest' in the given ID so that the scene
   /// can notify that node when the ID has been remapped.   It does
   /// this notification through the UpdateNodeReferences() call.
+  /// The inverse map (NodeReferencedIDs) is kept in sync, so that referencing
+  /// and referenced nodes of a node can be found without traversing all references.
   void AddReferencedNodeID(const char *id, vtkMRMLNode *refrencingNode);
   bool IsNodeReferencingNodeID(vtkMRMLNode* referencingNode, const char* id);
 
@@ -428,10 +457,12 @@ public:
   /// \warning Only for testing and debugging.
   int GetNumberOfNodeReferences();
   /// Get the ReferencingNode component of the n-th ReferencedID-ReferencingNode pair.
-  /// Only for testing and debugging.
+  /// Pairs are ordered by ReferencedID, then by the ID of the ReferencingNode.
+  /// Only for testing and debugging, the pairs are sorted at each call.
   vtkMRMLNode* GetNthReferencingNode(int n);
   /// Get the ReferencedID component of the n-th ReferencedID-ReferencingNode pair.
-  /// Only for testing and debugging.
+  /// Pairs are ordered the same way as in GetNthReferencingNode().
+  /// Only for testing and debugging, the pairs are sorted at each call.
   const char* GetNthReferencedID(int n);
 
   void RemoveReferencedNodeID(const char *id, vtkMRMLNode *refrencingNode);
@@ -487,6 +518,11 @@ public:
   /// Get vector of nodes containing references to an input node
   void GetReferencingNodes(vtkMRMLNode* referencedNode, std::vector<vtkMRMLNode *> &referencingNodes);
 
+  /// Get vector of nodes containing references to an input node with the specified reference role.
+  /// If \a referenceRole is nullptr then references with any role are taken into account.
+  void GetReferencingNodes(vtkMRMLNode* referencedNode, const char* referenceRole,
+    std::vector<vtkMRMLNode *> &referencingNodes);
+
   /// \brief Get a sub-scene containing all nodes directly or indirectly
   /// referenced by the input node.
   ///
@@ -675,6 +711,10 @@ public:
     NodeAboutToBeRemovedEvent,
     NodeRemovedEvent,
     NodeClassRegisteredEvent,
+    /// Invoked by AddNodes() before nodes are added. Call data is the vtkCollection of nodes to add.
+    NodesAboutToBeAddedEvent,
+    /// Invoked by AddNodes() after all nodes are added. Call data is the vtkCollection of added nodes.
+    NodesAddedEvent,
 
     NewSceneEvent = 66030,
     MetadataAddedEvent = 66032, // ### Slicer 4.5: Simplify - Do not explicitly set for backward compat. See issue #3472
@@ -811,6 +851,52 @@ public:
   /// Returns false if the save failed
   bool SaveSceneToSlicerDataBundleDirectory(const char* sdbDir, vtkImageData* thumbnail=nullptr, vtkMRMLMessageCollection* userMessages=nullptr);
 
+  /// \brief Maximum number of threads used for writing storable nodes into a data bundle.
+  /// Data of storable nodes whose storage node supports it (see vtkMRMLStorageNode::CanWriteDataConcurrently)
+  /// are written in worker threads by SaveSceneToSlicerDataBundleDirectory and WriteToMRB.
+  /// File names and archive content do not depend on the number of threads.
+  /// 0 (default) means the number of available CPU cores, 1 means all nodes are written in the main thread.
+  vtkSetClampMacro(MaximumNumberOfBundleWriteThreads, int, 0, VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfBundleWriteThreads, int);
+
+  /// \brief Load data of hidden nodes from a scene bundle only when they are shown.
+  /// If enabled then ReadFromMRB does not read data of displayable nodes (except volumes)
+  /// that have display nodes and all of them are hidden. Data of these nodes is read from the bundle
+  /// when any of their display nodes is made visible, before the node is saved,
+  /// or when LoadDeferredBundleData is called.
+  /// The bundle file must not be modified or removed while it has deferred data.
+  /// Disabled by default.
+  vtkSetMacro(LazyBundleDataLoading, bool);
+  vtkGetMacro(LazyBundleDataLoading, bool);
+  vtkBooleanMacro(LazyBundleDataLoading, bool);
+
+  /// Returns true if reading data of the node (or any node, if nullptr)
+  /// has been deferred by lazy bundle data loading.
+  /// \sa LazyBundleDataLoading
+  bool HasDeferredBundleData(vtkMRMLStorableNode* node = nullptr);
+
+  /// Read deferred data of the node (or all nodes, if nullptr) from the scene bundle.
+  /// Returns false if reading of any node failed.
+  /// \sa LazyBundleDataLoading
+  bool LoadDeferredBundleData(vtkMRMLStorableNode* node = nullptr);
+
+  /// \brief Scene bundle that storage nodes currently read their data from.
+  /// Set by ReadFromMRB while the scene is being imported and kept
+  /// as long as there are nodes with deferred data.
+  /// Returns nullptr if data is not read from a bundle.
+  vtkArchive* GetBundleArchive();
+
+  /// \brief Get data files of a storage node from the scene bundle.
+  /// Called by vtkMRMLStorageNode::ReadData before reading data from files.
+  /// Returns true if reading data of the node must be deferred (lazy bundle data loading).
+  /// Otherwise the files of the storage node are extracted from the bundle and their names are added to
+  /// extractedFileNames, so that they can be removed by ReleaseBundleFiles after reading.
+  /// Files that are not in the bundle or already exist on disk are left unchanged.
+  bool ExtractFromBundle(vtkMRMLStorageNode* storageNode, vtkMRMLNode* refNode, std::vector<std::string>& extractedFileNames);
+
+  /// Remove files that ExtractFromBundle extracted from the scene bundle.
+  void ReleaseBundleFiles(const std::vector<std::string>& extractedFileNames);
+
   /// \brief Utility function to write the scene thumbnail to a file in the scene's root folder.
   void SaveSceneScreenshot(vtkImageData* thumbnail);
 
@@ -834,7 +920,7 @@ public:
 
 protected:
 
-  typedef std::map< std::string, std::set<std::string> > NodeReferencesType;
+  typedef std::unordered_map< std::string, std::set<std::string> > NodeReferencesType;
 
   vtkMRMLScene();
   ~vtkMRMLScene() override;
@@ -859,6 +945,7 @@ protected:
   void RemoveInvalidNodeReferences(vtkCollection* checkNodes, const std::set<std::string> &validNodeIDs);
 
   /// Handle vtkMRMLScene::DeleteEvent: clear the scene.
+  /// Handle vtkMRMLDisplayableNode::DisplayModifiedEvent: load deferred bundle data of shown nodes.
   static void SceneCallback(vtkObject *caller, unsigned long eid, void *clientData, void *callData);
 
   std::string GenerateUniqueID(vtkMRMLNode* node);
@@ -892,6 +979,9 @@ protected:
   /// Clear NodeIDs map used to speedup GetByID() method.
   void ClearNodeIDs();
 
+  /// Rebuild the NodeReferencedIDs map from the NodeReferences map.
+  void UpdateNodeReferencedIDs();
+
   /// Get a NodeReferences iterator for a node reference.
   NodeReferencesType::iterator FindNodeReference(const char* referencedId, vtkMRMLNode* referencingNode);
 
@@ -909,12 +999,30 @@ protected:
 
   virtual void SetSubjectHierarchyNode(vtkMRMLSubjectHierarchyNode*);
 
+  /// Save the scene into a data bundle directory.
+  /// If archive is not nullptr then data files are added to it as soon as they are written,
+  /// followed by the scene file and all other files in the directory.
+  bool SaveSceneToSlicerDataBundleDirectoryInternal(const char* sdbDir, vtkImageData* thumbnail,
+    vtkMRMLMessageCollection* userMessages, vtkArchive* archive);
+
+  /// Set up the storage node of a storable node to write into dataDir while storing original filenames.
+  /// File names are made unique: names that are in usedFileNames (lowercase) or exist on disk are not used,
+  /// and the chosen name is added to usedFileNames.
+  /// Returns the storage node that needs to write the data, nullptr if the node does not need to be written.
+  vtkMRMLStorageNode* PrepareStorableNodeForSlicerDataBundleDirectory(vtkMRMLStorableNode* storableNode, const std::string& dataDir,
+    std::map<vtkMRMLStorageNode*, std::vector<std::string> > &originalStorageNodeFileNames, std::set<std::string>& usedFileNames);
+
+  /// Stop reading data from the scene bundle: deferred data is discarded and
+  /// extracted files are removed.
+  void CloseBundle();
+
   /// Saves a storable node while storing original filenames.
   /// Returns true on success (written successfully or no need to write the node).
   /// If userMessages is not nullptr then the method may add messages to it about issues
   /// encountered during the operation.
   bool SaveStorableNodeToSlicerDataBundleDirectory(vtkMRMLStorableNode* storableNode, std::string& dataDir,
-    std::map<vtkMRMLStorageNode*, std::vector<std::string> > &originalStorageNodeFileNames, vtkMRMLMessageCollection* userMessages);
+    std::map<vtkMRMLStorageNode*, std::vector<std::string> > &originalStorageNodeFileNames,
+    std::set<std::string>& usedFileNames, vtkMRMLMessageCollection* userMessages);
 
   vtkCollection*  Nodes;
 
@@ -932,6 +1040,27 @@ protected:
   int  MaximumNumberOfSavedUndoStates;
   bool UndoFlag;
 
+  int MaximumNumberOfBundleWriteThreads{ 0 };
+
+  /// Node whose data reading has been deferred by lazy bundle data loading,
+  /// with the file names that the storage node had when reading was requested.
+  struct DeferredBundleDataItem
+  {
+    vtkWeakPointer<vtkMRMLStorableNode> StorableNode;
+    vtkWeakPointer<vtkMRMLStorageNode> StorageNode;
+    std::string FileName;
+    std::vector<std::string> FileNameList;
+  };
+
+  bool LazyBundleDataLoading{ false };
+  /// Scene bundle that storage nodes read data from, nullptr if not reading from a bundle
+  vtkArchive* BundleArchive{ nullptr };
+  /// Directory where scene bundle files are extracted to
+  std::string BundleExtractDirectory;
+  /// Set while ReadFromMRB imports the scene
+  bool BundleReadInProgress{ false };
+  std::vector<DeferredBundleDataItem> DeferredBundleData;
+
   std::list< vtkCollection* >  UndoStack;
   std::list< vtkCollection* >  RedoStack;
 
@@ -942,11 +1071,18 @@ protected:
   std::map<std::string, int> UniqueNames;
   std::set<std::string>   ReservedIDs;
 
+  /// Set while AddNodes() adds nodes. Unique names and IDs are then looked up
+  /// in the sets below instead of traversing the scene and undo stack for each node.
+  bool AddingNodes{ false };
+  std::set<std::string> AddingNodesNames;
+  std::set<std::string> AddingNodesUndoReferenceIDs;
+
   std::vector< vtkMRMLNode* > RegisteredNodeClasses;
   std::vector< std::string >  RegisteredNodeTags;
   std::map< std::string, std::string > RegisteredAbstractNodeClassTypeDisplayNames; // map class name to type display name
 
   NodeReferencesType NodeReferences; // ReferencedIDs (string), ReferencingNodes (node pointer)
+  NodeReferencesType NodeReferencedIDs; // ReferencingNodes (node ID), ReferencedIDs (string)
   std::map< std::string, std::string > ReferencedIDChanges;
   std::map< std::string, vtkSmartPointer<vtkMRMLNode> > NodeIDs;
 
@@ -974,6 +1110,7 @@ protected:
   char* LastLoadedExtensions;
 
   vtkCallbackCommand *DeleteEventCallback;
+  vtkCallbackCommand *DeferredBundleDataCallback;
 
   std::default_random_engine RandomGenerator;
 
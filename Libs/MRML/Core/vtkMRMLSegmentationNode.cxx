@@ -1090,22 +1090,14 @@ double* vtkMRMLSegmentationNode::GetSegmentCenter(const std::string& segmentID)
     castToUint->SetInputData(resampledLabelmap);
     castToUint->SetOutputScalarTypeToUnsignedInt();
 
+    // Only the extent of the largest island is needed, the island image is not generated
     vtkNew<vtkITKIslandMath> islandMath;
     islandMath->SetInputConnection(castToUint->GetOutputPort());
-
-    vtkNew<vtkImageThreshold> largestIslandFilter;
-    largestIslandFilter->SetInputConnection(islandMath->GetOutputPort());
-    largestIslandFilter->ThresholdBetween(1.0, 1.0);
-    largestIslandFilter->SetInValue(1.0);
-    largestIslandFilter->SetOutValue(0.0);
-    largestIslandFilter->Update();
-
-    vtkNew<vtkOrientedImageData> largestResampledIsland;
-    largestResampledIsland->ShallowCopy(largestIslandFilter->GetOutput());
-    largestResampledIsland->CopyDirections(resampledLabelmap);
+    islandMath->GenerateOutputImageOff();
+    islandMath->Update();
 
     int resampledLabelEffectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
-    if (!vtkOrientedImageDataResample::CalculateEffectiveExtent(largestResampledIsland, resampledLabelEffectiveExtent))
+    if (islandMath->GetNumberOfIslands() == 0 || !islandMath->GetIslandExtent(0, resampledLabelEffectiveExtent))
     {
       vtkWarningMacro("GetSegmentCenter: segment " << segmentID << " is empty");
       return nullptr;
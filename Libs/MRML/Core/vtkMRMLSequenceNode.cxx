@@ -22,11 +22,14 @@
 #include "vtkMRMLStorableNode.h"
 
 // MRML includes
+#include <vtkMRMLLinearTransformNode.h>
 #include <vtkMRMLScene.h>
 
 // VTK includes
 #include <vtkNew.h>
 #include <vtkCollection.h>
+#include <vtkDoubleArray.h>
+#include <vtkMatrix4x4.h>
 #include <vtkObjectFactory.h>
 #include <vtkSmartPointer.h>
 #include <vtkTimerLog.h>
@@ -36,6 +39,10 @@
 
 #define SAFE_CHAR_POINTER(unsafeString) ( unsafeString==nullptr?"":unsafeString )
 
+// Data node ID written to the scene for items that are stored in the compact transform matrix array.
+// These items are restored by the storage node.
+static const char TRANSFORM_MATRIX_DATA_NODE_ID[] = "TransformMatrix";
+
 // This macro sets a member variable and sets both this node and the storage node as modified.
 // This macro can be used for properties that are stored in both the scene and in the stored file.
 #define vtkCxxSetVariableInDataAndStorageNodeMacro(name, type) \
@@ -79,6 +86,7 @@ vtkMRMLSequenceNode::~vtkMRMLSequenceNode()
 void vtkMRMLSequenceNode::RemoveAllDataNodes()
 {
   this->IndexEntries.clear();
+  this->RemoveAllTransformMatrices();
   if (!this->SequenceScene)
   {
     return;
@@ -105,6 +113,11 @@ void vtkMRMLSequenceNode::WriteXML(ostream& of, int nIndent)
 
   of << indent << " numericIndexValueTolerance=\"" << this->NumericIndexValueTolerance << "\"";
 
+  if (this->MaximumNumberOfDataNodes > 0)
+  {
+    of << indent << " maximumNumberOfDataNodes=\"" << this->MaximumNumberOfDataNodes << "\"";
+  }
+
   of << indent << " indexValues=\"";
   for(std::deque< IndexEntryType >::iterator indexIt=this->IndexEntries.begin(); indexIt!=this->IndexEntries.end(); ++indexIt)
   {
@@ -113,7 +126,11 @@ void vtkMRMLSequenceNode::WriteXML(ostream& of, int nIndent)
       // not the first index, add a separator before adding values
       of << ";";
     }
-    if (indexIt->DataNode==nullptr)
+    if (indexIt->TransformMatrixRow >= 0)
+    {
+      of << TRANSFORM_MATRIX_DATA_NODE_ID << ":" << indexIt->IndexValue;
+    }
+    else if (indexIt->DataNode==nullptr)
     {
       // If we have a data node ID then store that, it is the most we know about the node that should be there
       if (!indexIt->DataNodeID.empty())
@@ -173,6 +190,14 @@ void vtkMRMLSequenceNode::ReadXMLAttributes(const char** atts)
       ss >> numericIndexValueTolerance;
       this->SetNumericIndexValueTolerance(numericIndexValueTolerance);
     }
+    else if (!strcmp(attName, "maximumNumberOfDataNodes"))
+    {
+      std::stringstream ss;
+      ss << attValue;
+      int maximumNumberOfDataNodes = 0;
+      ss >> maximumNumberOfDataNodes;
+      this->SetMaximumNumberOfDataNodes(maximumNumberOfDataNodes);
+    }
     else if (!strcmp(attName, "indexValues"))
     {
       ReadIndexValues(attValue);
@@ -188,6 +213,7 @@ void vtkMRMLSequenceNode::ReadIndexValues(const std::string& indexText)
   if (!this->IndexEntries.empty())
   {
     this->IndexEntries.clear();
+    this->RemoveAllTransformMatrices();
     modified = true;
   }
 
@@ -236,6 +262,7 @@ void vtkMRMLSequenceNode::Copy(vtkMRMLNode *anode)
   this->SetIndexUnit(snode->GetIndexUnit());
   this->SetIndexType(snode->GetIndexType());
   this->SetNumericIndexValueTolerance(snode->GetNumericIndexValueTolerance());
+  this->SetMaximumNumberOfDataNodes(snode->GetMaximumNumberOfDataNodes());
 
   // Clear nodes: RemoveAllNodes is not a public method, so it's simpler to just delete and recreate the scene
   if (this->SequenceScene)
@@ -268,11 +295,26 @@ void vtkMRMLSequenceNode::Copy(vtkMRMLNode *anode)
   bool mapDataNodeIds = !sourceToTargetDataNodeID.empty();
 
   this->IndexEntries.clear();
+  this->RemoveAllTransformMatrices();
+  this->TransformMatrixBaseName = snode->TransformMatrixBaseName;
   for(std::deque< IndexEntryType >::iterator sourceIndexIt=snode->IndexEntries.begin(); sourceIndexIt!=snode->IndexEntries.end(); ++sourceIndexIt)
   {
     IndexEntryType seqItem;
     seqItem.IndexValue=sourceIndexIt->IndexValue;
     seqItem.DataNode = nullptr;
+    if (sourceIndexIt->TransformMatrixRow >= 0)
+    {
+      // copy the matrix, the data node is not created yet
+      if (!this->TransformMatrices)
+      {
+        this->TransformMatrices = vtkSmartPointer<vtkDoubleArray>::New();
+        this->TransformMatrices->SetNumberOfComponents(16);
+      }
+      seqItem.TransformMatrixRow = this->TransformMatrices->InsertNextTuple(
+        sourceIndexIt->TransformMatrixRow, snode->TransformMatrices);
+      this->IndexEntries.push_back(seqItem);
+      continue;
+    }
     if (sourceIndexIt->DataNode!=nullptr)
     {
       std::string targetDataNodeID = sourceToTargetDataNodeID[sourceIndexIt->DataNode->GetID()];
@@ -306,9 +348,12 @@ void vtkMRMLSequenceNode::CopySequenceIndex(vtkMRMLNode *anode)
   this->SetIndexUnit(snode->GetIndexUnit());
   this->SetIndexType(snode->GetIndexType());
   this->SetNumericIndexValueTolerance(snode->GetNumericIndexValueTolerance());
+  // Data node IDs are copied, therefore all data nodes must exist in the source
+  snode->CreateDataNodesFromTransformMatrices();
   if (this->IndexEntries.size() > 0 || snode->IndexEntries.size() > 0)
   {
     this->IndexEntries.clear();
+    this->RemoveAllTransformMatrices();
     for (std::deque< IndexEntryType >::iterator sourceIndexIt = snode->IndexEntries.begin(); sourceIndexIt != snode->IndexEntries.end(); ++sourceIndexIt)
     {
       IndexEntryType seqItem;
@@ -340,6 +385,9 @@ void vtkMRMLSequenceNode::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "indexType: " << indexTypeString << "\n";
 
   os << indent << "numericIndexValueTolerance: " << this->NumericIndexValueTolerance << "\n";
+  os << indent << "maximumNumberOfDataNodes: " << this->MaximumNumberOfDataNodes << "\n";
+  os << indent << "numberOfTransformMatrices: "
+    << (this->TransformMatrices ? this->TransformMatrices->GetNumberOfTuples() - static_cast<vtkIdType>(this->FreeTransformMatrixRows.size()) : 0) << "\n";
 
   os << indent << "indexValues: ";
   if (this->IndexEntries.empty())
@@ -417,6 +465,7 @@ vtkMRMLNode* vtkMRMLSequenceNode::SetDataNodeAtValue(vtkMRMLNode* node, const st
   if (seqItemIndex >= 0)
   {
     oldNode = this->IndexEntries[seqItemIndex].DataNode;
+    this->ReleaseTransformMatrixRow(this->IndexEntries[seqItemIndex]);
   }
   else
   {
@@ -448,6 +497,99 @@ vtkMRMLNode* vtkMRMLSequenceNode::SetDataNodeAtValue(vtkMRMLNode* node, const st
   return newNode;
 }
 
+//----------------------------------------------------------------------------
+bool vtkMRMLSequenceNode::RecordDataNodeAtValue(vtkMRMLNode* node, const std::string& indexValue, bool shareData /* = false */)
+{
+  if (node == nullptr)
+  {
+    vtkErrorMacro("vtkMRMLSequenceNode::RecordDataNodeAtValue failed, invalid node");
+    return false;
+  }
+
+  // Fast path is only used for appending items after the last item
+  bool append = (this->IndexType == vtkMRMLSequenceNode::NumericIndex);
+  if (append && !this->IndexEntries.empty())
+  {
+    double lastNumericIndexValue = atof(this->IndexEntries.back().IndexValue.c_str());
+    append = (atof(indexValue.c_str()) > lastNumericIndexValue + this->NumericIndexValueTolerance);
+  }
+  if (!append)
+  {
+    return (this->SetDataNodeAtValue(node, indexValue) != nullptr);
+  }
+
+  MRMLNodeModifyBlocker blocker(this);
+  // Make sure the sequence scene is created
+  this->GetSequenceScene();
+
+  bool compactTransform = (strcmp(node->GetClassName(), "vtkMRMLLinearTransformNode") == 0);
+
+  // Remove oldest items if the maximum number of items is reached, but keep one data node for reuse
+  vtkSmartPointer<vtkMRMLNode> reusedDataNode;
+  while (this->MaximumNumberOfDataNodes > 0 && static_cast<int>(this->IndexEntries.size()) >= this->MaximumNumberOfDataNodes)
+  {
+    IndexEntryType& oldestEntry = this->IndexEntries.front();
+    this->ReleaseTransformMatrixRow(oldestEntry);
+    vtkMRMLNode* oldestDataNode = oldestEntry.DataNode;
+    if (oldestDataNode)
+    {
+      if (!reusedDataNode && !compactTransform && strcmp(oldestDataNode->GetClassName(), node->GetClassName()) == 0)
+      {
+        reusedDataNode = oldestDataNode;
+      }
+      else
+      {
+        this->SequenceScene->RemoveNode(oldestDataNode);
+      }
+    }
+    this->IndexEntries.pop_front();
+  }
+
+  IndexEntryType seqItem;
+  seqItem.IndexValue = indexValue;
+  if (compactTransform)
+  {
+    if (!this->TransformMatrices)
+    {
+      this->TransformMatrices = vtkSmartPointer<vtkDoubleArray>::New();
+      this->TransformMatrices->SetNumberOfComponents(16);
+    }
+    vtkNew<vtkMatrix4x4> matrix;
+    vtkMRMLLinearTransformNode::SafeDownCast(node)->GetMatrixTransformToParent(matrix);
+    if (this->FreeTransformMatrixRows.empty())
+    {
+      seqItem.TransformMatrixRow = this->TransformMatrices->InsertNextTypedTuple(matrix->GetData());
+    }
+    else
+    {
+      // reuse the row of a removed item
+      seqItem.TransformMatrixRow = this->FreeTransformMatrixRows.back();
+      this->FreeTransformMatrixRows.pop_back();
+      this->TransformMatrices->SetTypedTuple(seqItem.TransformMatrixRow, matrix->GetData());
+    }
+    this->TransformMatrixBaseName = vtkMRMLSequenceNode::GetDataNodeBaseName(node);
+  }
+  else if (reusedDataNode)
+  {
+    reusedDataNode->CopyContent(node, !shareData);
+    seqItem.DataNode = reusedDataNode;
+  }
+  else
+  {
+    seqItem.DataNode = this->CopyNodeToScene(node, this->SequenceScene, !shareData);
+  }
+  this->IndexEntries.push_back(seqItem);
+
+  if (this->IndexEntries.size() <= 1)
+  {
+    this->SetAttribute("DataNodeClassName", node->GetClassName());
+  }
+
+  this->Modified();
+  this->StorableModifiedTime.Modified();
+  return true;
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLSequenceNode::RemoveDataNodeAtValue(const std::string& indexValue)
 {
@@ -463,6 +605,7 @@ void vtkMRMLSequenceNode::RemoveDataNodeAtValue(const std::string& indexValue)
     return;
   }
   // TODO: remove associated nodes as well (such as storage node)?
+  this->ReleaseTransformMatrixRow(this->IndexEntries[seqItemIndex]);
   vtkMRMLNode* dataNode = this->IndexEntries[seqItemIndex].DataNode;
   if (dataNode)
   {
@@ -565,7 +708,7 @@ vtkMRMLNode* vtkMRMLSequenceNode::GetDataNodeAtValue(const std::string& indexVal
     // not found
     return nullptr;
   }
-  return this->IndexEntries[seqItemIndex].DataNode;
+  return this->GetEntryDataNode(seqItemIndex);
 }
 
 //---------------------------------------------------------------------------
@@ -628,6 +771,10 @@ std::string vtkMRMLSequenceNode::GetDataNodeClassName()
     return "";
   }
   // All the nodes should be of the same class, so just get the class from the first one
+  if (this->IndexEntries[0].TransformMatrixRow >= 0)
+  {
+    return "vtkMRMLLinearTransformNode";
+  }
   vtkMRMLNode* node=this->IndexEntries[0].DataNode;
   if (node==nullptr)
   {
@@ -647,7 +794,7 @@ std::string vtkMRMLSequenceNode::GetDataNodeTagName()
     return undefinedReturn;
   }
   // All the nodes should be of the same class, so just get the class from the first one
-  vtkMRMLNode* node=this->IndexEntries[0].DataNode;
+  vtkMRMLNode* node=this->GetEntryDataNode(0);
   if (node==nullptr)
   {
     vtkErrorMacro("vtkMRMLSequenceNode::GetDataNodeClassName node is invalid");
@@ -669,7 +816,176 @@ vtkMRMLNode* vtkMRMLSequenceNode::GetNthDataNode(int itemNumber)
     vtkErrorMacro("vtkMRMLSequenceNode::GetNthDataNode failed: itemNumber "<<itemNumber<<" is out of range");
     return nullptr;
   }
-  return this->IndexEntries[itemNumber].DataNode;
+  return this->GetEntryDataNode(itemNumber);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkMRMLSequenceNode::IsNthDataNodeTransformMatrix(int itemNumber)
+{
+  if (itemNumber < 0 || itemNumber >= static_cast<int>(this->IndexEntries.size()))
+  {
+    return false;
+  }
+  return (this->IndexEntries[itemNumber].TransformMatrixRow >= 0);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkMRMLSequenceNode::GetNthTransformMatrix(int itemNumber, vtkMatrix4x4* matrix)
+{
+  if (!matrix || itemNumber < 0 || itemNumber >= static_cast<int>(this->IndexEntries.size()))
+  {
+    vtkErrorMacro("vtkMRMLSequenceNode::GetNthTransformMatrix failed: invalid matrix or itemNumber " << itemNumber << " is out of range");
+    return false;
+  }
+  const IndexEntryType& entry = this->IndexEntries[itemNumber];
+  if (entry.TransformMatrixRow >= 0)
+  {
+    this->TransformMatrices->GetTypedTuple(entry.TransformMatrixRow, matrix->GetData());
+    matrix->Modified();
+    return true;
+  }
+  vtkMRMLTransformNode* transformNode = vtkMRMLTransformNode::SafeDownCast(entry.DataNode);
+  if (!transformNode || !transformNode->IsLinear())
+  {
+    return false;
+  }
+  transformNode->GetMatrixTransformToParent(matrix);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkMRMLSequenceNode::SetTransformMatrices(vtkDoubleArray* matrices, const std::vector<std::string>& indexValues,
+  const char* dataNodeBaseName /* = nullptr */)
+{
+  if (!matrices || matrices->GetNumberOfComponents() != 16
+    || matrices->GetNumberOfTuples() != static_cast<vtkIdType>(indexValues.size()))
+  {
+    vtkErrorMacro("vtkMRMLSequenceNode::SetTransformMatrices failed: matrices must have 16 components"
+      << " and the same number of tuples as the number of index values");
+    return false;
+  }
+  MRMLNodeModifyBlocker blocker(this);
+  this->RemoveAllDataNodes();
+  // Make sure the sequence scene is created
+  this->GetSequenceScene();
+  this->TransformMatrices = vtkSmartPointer<vtkDoubleArray>::New();
+  this->TransformMatrices->SetNumberOfComponents(16);
+  this->TransformMatrices->Allocate(matrices->GetNumberOfValues());
+  this->TransformMatrixBaseName = (dataNodeBaseName ? dataNodeBaseName : "Data");
+
+  double lastNumericIndexValue = 0.0;
+  vtkIdType numberOfItems = matrices->GetNumberOfTuples();
+  for (vtkIdType itemIndex = 0; itemIndex < numberOfItems; ++itemIndex)
+  {
+    const std::string& indexValue = indexValues[itemIndex];
+    bool append = (this->IndexEntries.empty());
+    if (!append && this->IndexType == vtkMRMLSequenceNode::NumericIndex)
+    {
+      append = (atof(indexValue.c_str()) > lastNumericIndexValue + this->NumericIndexValueTolerance);
+    }
+    if (!append)
+    {
+      // Index value is not sorted or already exists, insert it as a node
+      vtkNew<vtkMatrix4x4> matrix;
+      matrices->GetTypedTuple(itemIndex, matrix->GetData());
+      matrix->Modified();
+      vtkNew<vtkMRMLLinearTransformNode> transformNode;
+      transformNode->SetMatrixTransformToParent(matrix);
+      transformNode->SetName(this->TransformMatrixBaseName.c_str());
+      this->SetDataNodeAtValue(transformNode, indexValue);
+      continue;
+    }
+    IndexEntryType seqItem;
+    seqItem.IndexValue = indexValue;
+    seqItem.TransformMatrixRow = this->TransformMatrices->InsertNextTuple(itemIndex, matrices);
+    this->IndexEntries.push_back(seqItem);
+    if (this->IndexType == vtkMRMLSequenceNode::NumericIndex)
+    {
+      lastNumericIndexValue = atof(indexValue.c_str());
+    }
+  }
+  if (!this->IndexEntries.empty())
+  {
+    this->SetAttribute("DataNodeClassName", "vtkMRMLLinearTransformNode");
+  }
+  this->Modified();
+  this->StorableModifiedTime.Modified();
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkMRMLSequenceNode::GetTransformMatrices(vtkDoubleArray* matrices)
+{
+  if (!matrices)
+  {
+    vtkErrorMacro("vtkMRMLSequenceNode::GetTransformMatrices failed: invalid matrices");
+    return false;
+  }
+  int numberOfItems = this->GetNumberOfDataNodes();
+  matrices->SetNumberOfComponents(16);
+  matrices->SetNumberOfTuples(numberOfItems);
+  vtkNew<vtkMatrix4x4> matrix;
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+  {
+    if (!this->GetNthTransformMatrix(itemNumber, matrix))
+    {
+      vtkErrorMacro("vtkMRMLSequenceNode::GetTransformMatrices failed: item " << itemNumber << " is not a linear transform");
+      return false;
+    }
+    matrices->SetTypedTuple(itemNumber, matrix->GetData());
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+vtkMRMLNode* vtkMRMLSequenceNode::GetEntryDataNode(int itemNumber)
+{
+  IndexEntryType& entry = this->IndexEntries[itemNumber];
+  if (entry.DataNode == nullptr && entry.TransformMatrixRow >= 0)
+  {
+    vtkNew<vtkMatrix4x4> matrix;
+    this->TransformMatrices->GetTypedTuple(entry.TransformMatrixRow, matrix->GetData());
+    matrix->Modified();
+    vtkNew<vtkMRMLLinearTransformNode> transformNode;
+    transformNode->SetMatrixTransformToParent(matrix);
+    transformNode->SetName(this->TransformMatrixBaseName.c_str());
+    transformNode->SetAttribute("Sequences.BaseName", this->TransformMatrixBaseName.c_str());
+    entry.DataNode = this->GetSequenceScene()->AddNode(transformNode);
+    this->ReleaseTransformMatrixRow(entry);
+  }
+  return entry.DataNode;
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLSequenceNode::CreateDataNodesFromTransformMatrices()
+{
+  if (!this->TransformMatrices)
+  {
+    return;
+  }
+  for (int itemNumber = 0; itemNumber < static_cast<int>(this->IndexEntries.size()); ++itemNumber)
+  {
+    this->GetEntryDataNode(itemNumber);
+  }
+  this->RemoveAllTransformMatrices();
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLSequenceNode::ReleaseTransformMatrixRow(IndexEntryType& entry)
+{
+  if (entry.TransformMatrixRow < 0)
+  {
+    return;
+  }
+  this->FreeTransformMatrixRows.push_back(entry.TransformMatrixRow);
+  entry.TransformMatrixRow = -1;
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLSequenceNode::RemoveAllTransformMatrices()
+{
+  this->TransformMatrices = nullptr;
+  this->FreeTransformMatrixRows.clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -700,7 +1016,8 @@ vtkMRMLStorageNode* vtkMRMLSequenceNode::CreateDefaultStorageNode()
 std::string vtkMRMLSequenceNode::GetDefaultStorageNodeClassName(const char* filename /* =nullptr */)
 {
   // No need to create storage node if there are no nodes to store
-  if (this->GetSequenceScene() == nullptr || this->GetSequenceScene()->GetNumberOfNodes() == 0)
+  if (this->GetSequenceScene() == nullptr
+    || (this->GetSequenceScene()->GetNumberOfNodes() == 0 && !this->IsNthDataNodeTransformMatrix(0)))
   {
     return "";
   }
@@ -748,7 +1065,7 @@ void vtkMRMLSequenceNode::UpdateSequenceIndex()
   }
   for (std::deque< IndexEntryType >::iterator indexIt = this->IndexEntries.begin(); indexIt != this->IndexEntries.end(); ++indexIt)
   {
-    if (indexIt->DataNode == nullptr)
+    if (indexIt->DataNode == nullptr && indexIt->TransformMatrixRow < 0)
     {
       indexIt->DataNode = this->SequenceScene->GetNodeByID(indexIt->DataNodeID);
       if (indexIt->DataNode != nullptr)
@@ -802,11 +1119,12 @@ int vtkMRMLSequenceNode::GetIndexTypeFromString(const std::string& indexTypeStri
 //-----------------------------------------------------------
 vtkMRMLNode* vtkMRMLSequenceNode::DeepCopyNodeToScene(vtkMRMLNode* source, vtkMRMLScene* scene)
 {
-  if (source == nullptr)
-  {
-    vtkGenericWarningMacro("vtkMRMLSequenceNode::DeepCopyNodeToScene failed, invalid node");
-    return nullptr;
-  }
+  return this->CopyNodeToScene(source, scene, true);
+}
+
+//-----------------------------------------------------------
+std::string vtkMRMLSequenceNode::GetDataNodeBaseName(vtkMRMLNode* source)
+{
   std::string baseName = "Data";
   if (source->GetAttribute("Sequences.BaseName") != 0)
   {
@@ -816,10 +1134,22 @@ vtkMRMLNode* vtkMRMLSequenceNode::DeepCopyNodeToScene(vtkMRMLNode* source, vtkMR
   {
     baseName = source->GetName();
   }
+  return baseName;
+}
+
+//-----------------------------------------------------------
+vtkMRMLNode* vtkMRMLSequenceNode::CopyNodeToScene(vtkMRMLNode* source, vtkMRMLScene* scene, bool deepCopy)
+{
+  if (source == nullptr)
+  {
+    vtkGenericWarningMacro("vtkMRMLSequenceNode::CopyNodeToScene failed, invalid node");
+    return nullptr;
+  }
+  std::string baseName = vtkMRMLSequenceNode::GetDataNodeBaseName(source);
   std::string newNodeName = baseName;
 
   vtkSmartPointer<vtkMRMLNode> target = vtkSmartPointer<vtkMRMLNode>::Take(source->CreateNodeInstance());
-  target->CopyContent(source); // deep-copy
+  target->CopyContent(source, deepCopy);
 
   // Generating unique node names is slow, and makes adding many nodes to a sequence too slow
   // We will instead ensure that all file names for storable nodes are unique when saving
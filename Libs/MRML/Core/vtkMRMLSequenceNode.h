@@ -22,9 +22,16 @@
 #include <vtkMRML.h>
 #include <vtkMRMLStorableNode.h>
 
+// VTK includes
+#include <vtkSmartPointer.h>
+
 // std includes
 #include <deque>
 #include <set>
+#include <vector>
+
+class vtkDoubleArray;
+class vtkMatrix4x4;
 
 
 /// \brief MRML node for representing a sequence of MRML nodes
@@ -107,6 +114,50 @@ public:
   /// Returns the data node copy that has just been created.
   vtkMRMLNode* SetDataNodeAtValue(vtkMRMLNode* node, const std::string& indexValue);
 
+  /// Add the current state of the provided node to this sequence, optimized for recording at high frame rate.
+  /// If the index is numeric and the index value is larger than all existing index values then the item
+  /// is appended without creating a new data node if possible:
+  /// - Linear transforms are stored in a compact matrix array. The data node is only created
+  ///   when it is requested (by GetNthDataNode, GetDataNodeAtValue, saving the sequence, etc.).
+  /// - If MaximumNumberOfDataNodes is reached then the oldest item is removed and its data node
+  ///   is reused for storing the new item.
+  /// If shareData is enabled then the item shares the data objects (image data, mesh, etc.) of the
+  /// provided node instead of deep-copying them. This is only safe if the data source sets a new data object
+  /// in the node for each frame (instead of modifying the current data object in place).
+  /// In all other cases, the node is added the same way as with SetDataNodeAtValue.
+  /// Returns true on success.
+  bool RecordDataNodeAtValue(vtkMRMLNode* node, const std::string& indexValue, bool shareData = false);
+
+  /// Maximum number of items that RecordDataNodeAtValue keeps in the sequence.
+  /// When the limit is reached then the oldest items are removed (ring buffer).
+  /// 0 means that there is no limit (default).
+  vtkSetMacro(MaximumNumberOfDataNodes, int);
+  vtkGetMacro(MaximumNumberOfDataNodes, int);
+
+  /// Return true if the item is stored in the compact transform matrix array
+  /// (its data node has not been created yet).
+  bool IsNthDataNodeTransformMatrix(int itemNumber);
+
+  /// Get the transform to parent matrix of a linear transform item.
+  /// If the item is stored in the compact transform matrix array then no data node is created.
+  /// Returns false if the item is not a linear transform.
+  bool GetNthTransformMatrix(int itemNumber, vtkMatrix4x4* matrix);
+
+  /// Replace all items by linear transforms.
+  /// Matrices are specified as transform to parent matrices in a Nx16 array (row-major order),
+  /// one row for each index value. Items are stored in the compact transform matrix array,
+  /// data nodes are only created when they are requested.
+  /// If the index is numeric then index values are expected to be sorted in ascending order
+  /// (unsorted or duplicate index values are supported but stored less efficiently).
+  /// Data nodes that are created from the matrices are named dataNodeBaseName.
+  bool SetTransformMatrices(vtkDoubleArray* matrices, const std::vector<std::string>& indexValues,
+    const char* dataNodeBaseName = nullptr);
+
+  /// Get transform to parent matrices of all items in a Nx16 array (row-major order).
+  /// Data nodes are not created for items that are stored in the compact transform matrix array.
+  /// Returns false if any of the items is not a linear transform.
+  bool GetTransformMatrices(vtkDoubleArray* matrices);
+
   /// Update an existing data node.
   /// Return true if a data node was found by that index.
   bool UpdateDataNodeAtValue(vtkMRMLNode* node, const std::string& indexValue, bool shallowCopy = false);
@@ -183,13 +234,33 @@ protected:
 
   vtkMRMLNode* DeepCopyNodeToScene(vtkMRMLNode* source, vtkMRMLScene* scene);
 
+  /// Add a copy of the source node to the scene. If deepCopy is false then data objects are shared.
+  vtkMRMLNode* CopyNodeToScene(vtkMRMLNode* source, vtkMRMLScene* scene, bool deepCopy);
+
+  /// Get base name of data nodes created from the source node.
+  static std::string GetDataNodeBaseName(vtkMRMLNode* source);
+
   struct IndexEntryType
   {
     std::string IndexValue;
     vtkWeakPointer<vtkMRMLNode> DataNode;
     std::string DataNodeID; // only used temporarily, during scene load
+    vtkIdType TransformMatrixRow{-1}; // row in TransformMatrices, if the data node is not created yet
   };
 
+  /// Get data node of an item. If the item is stored in the compact transform matrix array
+  /// then the data node is created now.
+  vtkMRMLNode* GetEntryDataNode(int itemNumber);
+
+  /// Create data nodes for all items that are stored in the compact transform matrix array.
+  void CreateDataNodesFromTransformMatrices();
+
+  /// Mark the transform matrix row of the item as unused, so that it can be reused by a new item.
+  void ReleaseTransformMatrixRow(IndexEntryType& entry);
+
+  /// Remove all rows from the compact transform matrix array.
+  void RemoveAllTransformMatrices();
+
 protected:
 
   /// Describes index of the sequence node
@@ -204,6 +275,16 @@ protected:
 
   /// List of data items (the scene may contain some more nodes, such as storage nodes)
   std::deque< IndexEntryType > IndexEntries;
+
+  /// Transform to parent matrices of linear transform items added by RecordDataNodeAtValue
+  /// (16 components per row, row-major order).
+  vtkSmartPointer<vtkDoubleArray> TransformMatrices;
+  /// Rows of TransformMatrices that are not used by any item
+  std::vector<vtkIdType> FreeTransformMatrixRows;
+  /// Base name of data nodes created from TransformMatrices
+  std::string TransformMatrixBaseName;
+
+  int MaximumNumberOfDataNodes{0};
 };
 
 #endif
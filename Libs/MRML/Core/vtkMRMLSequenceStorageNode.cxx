@@ -241,17 +241,20 @@ std::string vtkMRMLSequenceStorageNode::GetSequenceBaseName(const std::string& f
     recognizedExtensions.push_back(std::string(NODE_BASE_NAME_SEPARATOR) + itemName + NODE_BASE_NAME_SEPARATOR + "Seq.seq.mhd");
     recognizedExtensions.push_back(std::string(NODE_BASE_NAME_SEPARATOR) + itemName + NODE_BASE_NAME_SEPARATOR + "Seq.seq.nrrd");
     recognizedExtensions.push_back(std::string(NODE_BASE_NAME_SEPARATOR) + itemName + NODE_BASE_NAME_SEPARATOR + "Seq.seq.nhdr");
+    recognizedExtensions.push_back(std::string(NODE_BASE_NAME_SEPARATOR) + itemName + NODE_BASE_NAME_SEPARATOR + "Seq.seq.tfmb");
   }
   recognizedExtensions.push_back(std::string(NODE_BASE_NAME_SEPARATOR) + "Seq.seq.mrb");
   recognizedExtensions.push_back(std::string(NODE_BASE_NAME_SEPARATOR) + "Seq.seq.mha");
   recognizedExtensions.push_back(std::string(NODE_BASE_NAME_SEPARATOR) + "Seq.seq.mhd");
   recognizedExtensions.push_back(std::string(NODE_BASE_NAME_SEPARATOR) + "Seq.seq.nrrd");
   recognizedExtensions.push_back(std::string(NODE_BASE_NAME_SEPARATOR) + "Seq.seq.nhdr");
+  recognizedExtensions.push_back(std::string(NODE_BASE_NAME_SEPARATOR) + "Seq.seq.tfmb");
   recognizedExtensions.push_back(".seq.mrb");
   recognizedExtensions.push_back(".seq.mha");
   recognizedExtensions.push_back(".seq.mhd");
   recognizedExtensions.push_back(".seq.nrrd");
   recognizedExtensions.push_back(".seq.nhdr");
+  recognizedExtensions.push_back(".seq.tfmb");
   recognizedExtensions.push_back(".mrb");
   recognizedExtensions.push_back(".mhd");
   recognizedExtensions.push_back(".mha");
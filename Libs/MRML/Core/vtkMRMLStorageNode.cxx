@@ -1210,6 +1210,12 @@ bool vtkMRMLStorageNode::CanWriteFromReferenceNode(vtkMRMLNode *refNode)
   return this->CanReadInReferenceNode(refNode);
 }
 
+//------------------------------------------------------------------------------
+bool vtkMRMLStorageNode::CanWriteDataConcurrently(vtkMRMLNode* vtkNotUsed(refNode))
+{
+  return false;
+}
+
 //------------------------------------------------------------------------------
 int vtkMRMLStorageNode::ReadData(vtkMRMLNode* refNode, bool temporary)
 {
@@ -1245,6 +1251,17 @@ int vtkMRMLStorageNode::ReadData(vtkMRMLNode* refNode, bool temporary)
     return 0;
   }
 
+  // When the scene is read from a bundle, files are extracted from the bundle right before reading them
+  std::vector<std::string> extractedBundleFileNames;
+  if (this->GetScene() && this->GetScene()->GetBundleArchive() && !temporary)
+  {
+    if (this->GetScene()->ExtractFromBundle(this, refNode, extractedBundleFileNames))
+    {
+      // reading is deferred until the node is shown
+      return 1;
+    }
+  }
+
   this->StageReadData(refNode);
   if ( this->GetReadState() != this->TransferDone )
   {
@@ -1258,6 +1275,10 @@ int vtkMRMLStorageNode::ReadData(vtkMRMLNode* refNode, bool temporary)
     << "filename = " << (this->GetFileName() == nullptr ? "null" : this->GetFileName()));
   vtkMRMLStorableNode* storableNode = vtkMRMLStorableNode::SafeDownCast(refNode);
   int success = this->ReadDataInternal(refNode);
+  if (!extractedBundleFileNames.empty())
+  {
+    this->GetScene()->ReleaseBundleFiles(extractedBundleFileNames);
+  }
   if (!success)
   {
     // failed
@@ -1326,6 +1347,13 @@ int vtkMRMLStorageNode::WriteData(vtkMRMLNode* refNode)
     return 0;
   }
 
+  // Data that has not been read from the scene bundle yet must be read before it is written
+  vtkMRMLStorableNode* storableNode = vtkMRMLStorableNode::SafeDownCast(refNode);
+  if (storableNode && this->GetScene() && this->GetScene()->HasDeferredBundleData(storableNode))
+  {
+    this->GetScene()->LoadDeferredBundleData(storableNode);
+  }
+
   int success = this->WriteDataInternal(refNode);
 
   // If there were error messages, then do not return that we were successful
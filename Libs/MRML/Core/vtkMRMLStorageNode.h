@@ -309,6 +309,16 @@ public:
   /// \sa CanReadInReferenceNode, WriteData
   virtual bool CanWriteFromReferenceNode(vtkMRMLNode* refNode);
 
+  /// Return true if WriteData can be called for the reference node from a worker thread,
+  /// while other nodes are being written (for example, when a scene bundle is saved).
+  /// Writing must only read the reference node and must not modify other objects.
+  /// Modified events of the storage node are postponed until the write is completed.
+  /// The method is called from the main thread right before writing, therefore
+  /// subclasses may bring the data of the reference node up-to-date here.
+  /// By default it returns false.
+  /// \sa WriteData
+  virtual bool CanWriteDataConcurrently(vtkMRMLNode* refNode);
+
   ///
   /// Configure the storage node for data exchange. This is an
   /// opportunity to optimize the storage node's settings, for
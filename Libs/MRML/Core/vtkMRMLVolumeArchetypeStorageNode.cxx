@@ -24,6 +24,11 @@ Version:   $Revision: 1.6 $
 #endif
 #include "vtkMRMLVolumeArchetypeStorageNode.h"
 
+#ifdef MRML_USE_vtkTeem
+// vtkTeem includes
+#include <vtkTeemNRRDReader.h>
+#endif
+
 // VTK ITK includes
 #include "vtkITKArchetypeImageSeriesScalarReader.h"
 #include "vtkITKArchetypeDiffusionTensorImageReaderFile.h"
@@ -40,10 +45,13 @@ Version:   $Revision: 1.6 $
 #include <vtkDataArray.h>
 #include <vtkErrorCode.h>
 #include <vtkImageChangeInformation.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
 #include <vtkMatrix3x3.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
 #include <vtkSmartPointer.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
 #include <vtkStringArray.h>
 #include <vtksys/Directory.hxx>
 #include <vtkTransform.h>
@@ -146,6 +154,7 @@ void vtkMRMLVolumeArchetypeStorageNode::Copy(vtkMRMLNode *anode)
   this->SetSingleFile(node->SingleFile);
   this->SetUseOrientationFromFile(node->UseOrientationFromFile);
   this->SetForceRightHandedIJKCoordinateSystem(node->ForceRightHandedIJKCoordinateSystem);
+  this->SetMemoryMapping(node->MemoryMapping);
 
   this->EndModify(disabledModify);
 }
@@ -158,6 +167,7 @@ void vtkMRMLVolumeArchetypeStorageNode::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "SingleFile:   " << this->SingleFile << "\n";
   os << indent << "UseOrientationFromFile:   " << this->UseOrientationFromFile << "\n";
   os << indent << "ForceRightHandedIJKCoordinateSystem:   " << (this->ForceRightHandedIJKCoordinateSystem ? "true" : "false") << "\n";
+  os << indent << "MemoryMapping:   " << (this->MemoryMapping ? "true" : "false") << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -201,6 +211,30 @@ bool vtkMRMLVolumeArchetypeStorageNode::CanWriteFromReferenceNode(vtkMRMLNode *r
   return refNode->IsA("vtkMRMLScalarVolumeNode");
 }
 
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeArchetypeStorageNode::CanWriteDataConcurrently(vtkMRMLNode* refNode)
+{
+  vtkMRMLVolumeNode* volNode = vtkMRMLVolumeNode::SafeDownCast(refNode);
+  if (!volNode || !this->CanWriteFromReferenceNode(refNode))
+  {
+    return false;
+  }
+  // Update the image data in the main thread
+  vtkImageData* imageData = volNode->GetImageData();
+  if (imageData
+    && volNode->GetVoxelVectorType() == vtkMRMLVolumeNode::VoxelVectorTypeSpatial
+    && imageData->GetNumberOfScalarComponents() == 3)
+  {
+    return false;
+  }
+  if (this->WriteFileFormat && this->GetScene() && this->GetScene()->GetDataIOManager())
+  {
+    // Make sure the file format helper is created in the main thread
+    this->GetScene()->GetDataIOManager()->GetFileFormatHelper();
+  }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 vtkITKArchetypeImageSeriesReader*
 vtkMRMLVolumeArchetypeStorageNode::InstantiateVectorVolumeReader(const std::string& fullName)
@@ -299,6 +333,56 @@ void ApplyImageSeriesReaderWorkaround(vtkMRMLVolumeArchetypeStorageNode * storag
   }
 }
 
+#ifdef MRML_USE_vtkTeem
+//----------------------------------------------------------------------------
+// Get voxels of an uncompressed single-file NRRD volume by memory-mapping the file.
+// Geometry and metadata are still provided by the archetype reader (its information is updated),
+// only the voxel buffer comes from the NRRD reader. Returns nullptr if the voxels cannot be mapped.
+vtkSmartPointer<vtkImageData> ReadMemoryMappedNRRDVoxels(vtkITKArchetypeImageSeriesReader* reader, const std::string& fullName)
+{
+  std::string fileExt = vtkMRMLStorageNode::GetLowercaseExtensionFromFileName(fullName);
+  if (fileExt != ".nrrd" && fileExt != ".nhdr")
+  {
+    return nullptr;
+  }
+  reader->UpdateInformation();
+  if (reader->GetNumberOfFileNames() > 1)
+  {
+    return nullptr;
+  }
+  vtkNew<vtkTeemNRRDReader> nrrdReader;
+  nrrdReader->SetFileName(fullName.c_str());
+  nrrdReader->MemoryMappingOn();
+  nrrdReader->UpdateInformation();
+  if (nrrdReader->GetReadStatus() != 0 || !nrrdReader->CanMapData()
+    || nrrdReader->GetPointDataType() != vtkDataSetAttributes::SCALARS)
+  {
+    return nullptr;
+  }
+  // voxels are in file order in both readers (native orientation), the layout must match
+  vtkInformation* readerInfo = reader->GetOutputInformation(0);
+  vtkInformation* nrrdReaderInfo = nrrdReader->GetOutputInformation(0);
+  int readerExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  int nrrdReaderExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  readerInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), readerExtent);
+  nrrdReaderInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), nrrdReaderExtent);
+  if (!std::equal(readerExtent, readerExtent + 6, nrrdReaderExtent)
+    || vtkImageData::GetScalarType(readerInfo) != nrrdReader->GetDataType()
+    || vtkImageData::GetNumberOfScalarComponents(readerInfo) != nrrdReader->GetNumberOfComponents())
+  {
+    return nullptr;
+  }
+  nrrdReader->Update();
+  if (!nrrdReader->GetDataMemoryMapped())
+  {
+    return nullptr;
+  }
+  vtkSmartPointer<vtkImageData> mappedImage = vtkSmartPointer<vtkImageData>::New();
+  mappedImage->ShallowCopy(nrrdReader->GetOutput());
+  return mappedImage;
+}
+#endif
+
 } // end of anonymous namespace
 
 //----------------------------------------------------------------------------
@@ -396,10 +480,20 @@ int vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
 
   bool readingWorked = true;
   std::string errorMessage = "";
+  vtkSmartPointer<vtkImageData> mappedImage;
   try
   {
+#ifdef MRML_USE_vtkTeem
+    if (this->MemoryMapping && reader->IsA("vtkITKArchetypeImageSeriesScalarReader"))
+    {
+      mappedImage = ReadMemoryMappedNRRDVoxels(reader, fullName);
+    }
+#endif
     vtkDebugMacro("ReadDataInternal: right before reader update, reader num files = " << reader->GetNumberOfFileNames());
-    reader->Update();
+    if (!mappedImage)
+    {
+      reader->Update();
+    }
     if (reader->GetErrorCode() != vtkErrorCode::NoError)
     {
       readingWorked = false;
@@ -427,14 +521,15 @@ int vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
     return 0;
   }
 
-  if (reader->GetOutput() == nullptr || reader->GetOutput()->GetPointData() == nullptr)
+  vtkImageData* readImage = (mappedImage ? mappedImage.GetPointer() : reader->GetOutput());
+  if (readImage == nullptr || readImage->GetPointData() == nullptr)
   {
     vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal",
       vtkMRMLI18N::Format(vtkMRMLTr("vtkMRMLVolumeArchetypeStorageNode", "Unable to read data from file: '%1'"), fullName.c_str()));
     return 0;
   }
 
-  vtkPointData* pointData = reader->GetOutput()->GetPointData();
+  vtkPointData* pointData = readImage->GetPointData();
   if (volNode->IsA("vtkMRMLDiffusionTensorVolumeNode"))
   {
     if (pointData->GetTensors() == nullptr || pointData->GetTensors()->GetNumberOfTuples() == 0)
@@ -494,7 +589,14 @@ int vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
   }
 
   vtkNew<vtkImageChangeInformation> ici;
-  ici->SetInputConnection(reader->GetOutputPort());
+  if (mappedImage)
+  {
+    ici->SetInputData(mappedImage);
+  }
+  else
+  {
+    ici->SetInputConnection(reader->GetOutputPort());
+  }
   ici->SetOutputSpacing( 1, 1, 1 );
   ici->SetOutputOrigin( 0, 0, 0 );
   ici->Update();
@@ -578,6 +680,12 @@ int vtkMRMLVolumeArchetypeStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
     return 0;
   }
 
+#ifdef MRML_USE_vtkTeem
+  // Voxels that are memory-mapped from a file that is replaced must be copied first,
+  // as unmodified voxels are read from the file (and mapped files cannot be removed on Windows).
+  vtkTeemNRRDReader::ReleaseMappedData(volNode->GetImageData(), fullName);
+#endif
+
   if (volNode->GetVoxelVectorType() == vtkMRMLVolumeNode::VoxelVectorTypeSpatial)
   {
     if (volNode->GetImageData()->GetNumberOfScalarComponents() != 3)
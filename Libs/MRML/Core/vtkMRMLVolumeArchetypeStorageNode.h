@@ -86,6 +86,15 @@ public:
   vtkBooleanMacro(ForceRightHandedIJKCoordinateSystem, bool);
   //@}
 
+  /// Map voxel data of uncompressed single-file NRRD volumes into memory instead of reading it
+  /// into a newly allocated buffer. Opening large volumes becomes almost instantaneous, as file content
+  /// is only loaded when it is accessed. Voxels can be modified (copy-on-write), the file is not changed.
+  /// Other files and NRRD files that cannot be mapped (for example, compressed) are read as usual.
+  /// This is a reading option, it is not saved in the scene. Disabled by default.
+  vtkSetMacro(MemoryMapping, bool);
+  vtkGetMacro(MemoryMapping, bool);
+  vtkBooleanMacro(MemoryMapping, bool);
+
   /// Convert voxel vector type enum from vtkITK type to MRML type
   static int ConvertVoxelVectorTypeVTKITKToMRML(int vtkitkType);
   /// Convert voxel vector type enum from MRML type to vtkITK type
@@ -95,6 +104,10 @@ public:
   bool CanReadInReferenceNode(vtkMRMLNode* refNode) override;
   bool CanWriteFromReferenceNode(vtkMRMLNode* refNode) override;
 
+  /// Volumes can be written concurrently, except spatial vector volumes
+  /// (their voxels are temporarily converted to LPS in place while writing).
+  bool CanWriteDataConcurrently(vtkMRMLNode* refNode) override;
+
   ///
   /// Configure the storage node for data exchange. This is an
   /// opportunity to optimize the storage node's settings, for
@@ -131,6 +144,7 @@ protected:
   int SingleFile;
   int UseOrientationFromFile;
   bool ForceRightHandedIJKCoordinateSystem;
+  bool MemoryMapping{ false };
 
 };
 
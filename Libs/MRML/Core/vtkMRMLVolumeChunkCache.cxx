@@ -0,0 +1,198 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLVolumeChunkCache.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkObjectFactory.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <iterator>
+#include <list>
+#include <map>
+#include <tuple>
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkMRMLVolumeChunkCache);
+
+//----------------------------------------------------------------------------
+class vtkMRMLVolumeChunkCache::vtkInternal
+{
+public:
+  struct ChunkKey
+  {
+    std::string Source;
+    int Level;
+    int Index[3];
+
+    bool operator<(const ChunkKey& other) const
+    {
+      return std::tie(this->Source, this->Level, this->Index[2], this->Index[1], this->Index[0])
+        < std::tie(other.Source, other.Level, other.Index[2], other.Index[1], other.Index[0]);
+    }
+  };
+
+  struct Chunk
+  {
+    ChunkKey Key;
+    vtkSmartPointer<vtkDataArray> Voxels;
+    vtkTypeInt64 Size;
+  };
+
+  /// Most recently used chunk is at the front
+  std::list<Chunk> Chunks;
+  std::map<ChunkKey, std::list<Chunk>::iterator> ChunkMap;
+  vtkTypeInt64 Size{ 0 };
+
+  static ChunkKey GetKey(const std::string& source, int level, const int chunkIndex[3])
+  {
+    ChunkKey key;
+    key.Source = source;
+    key.Level = level;
+    key.Index[0] = chunkIndex[0];
+    key.Index[1] = chunkIndex[1];
+    key.Index[2] = chunkIndex[2];
+    return key;
+  }
+
+  void Remove(std::list<Chunk>::iterator chunkIt)
+  {
+    this->Size -= chunkIt->Size;
+    this->ChunkMap.erase(chunkIt->Key);
+    this->Chunks.erase(chunkIt);
+  }
+};
+
+//----------------------------------------------------------------------------
+vtkMRMLVolumeChunkCache::vtkMRMLVolumeChunkCache()
+{
+  this->MaximumSize = 256 * 1024 * 1024;
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLVolumeChunkCache::~vtkMRMLVolumeChunkCache()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeChunkCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "MaximumSize: " << this->MaximumSize << "\n";
+  os << indent << "Size: " << this->Internal->Size << "\n";
+  os << indent << "NumberOfChunks: " << this->Internal->Chunks.size() << "\n";
+  os << indent << "NumberOfHits: " << this->NumberOfHits << "\n";
+  os << indent << "NumberOfMisses: " << this->NumberOfMisses << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeChunkCache::SetMaximumSize(vtkTypeInt64 maximumSize)
+{
+  if (this->MaximumSize == maximumSize)
+  {
+    return;
+  }
+  this->MaximumSize = maximumSize;
+  this->Shrink(this->MaximumSize);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkTypeInt64 vtkMRMLVolumeChunkCache::GetSize()
+{
+  return this->Internal->Size;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeChunkCache::GetNumberOfChunks()
+{
+  return static_cast<int>(this->Internal->Chunks.size());
+}
+
+//----------------------------------------------------------------------------
+vtkDataArray* vtkMRMLVolumeChunkCache::GetChunk(const std::string& source, int level, const int chunkIndex[3])
+{
+  auto chunkMapIt = this->Internal->ChunkMap.find(vtkInternal::GetKey(source, level, chunkIndex));
+  if (chunkMapIt == this->Internal->ChunkMap.end())
+  {
+    this->NumberOfMisses++;
+    return nullptr;
+  }
+  this->NumberOfHits++;
+  // move to the front of the list, iterators remain valid
+  this->Internal->Chunks.splice(this->Internal->Chunks.begin(), this->Internal->Chunks, chunkMapIt->second);
+  return chunkMapIt->second->Voxels;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeChunkCache::AddChunk(const std::string& source, int level, const int chunkIndex[3], vtkDataArray* voxels)
+{
+  if (!voxels)
+  {
+    vtkErrorMacro("AddChunk failed: invalid voxels");
+    return;
+  }
+  vtkInternal::ChunkKey key = vtkInternal::GetKey(source, level, chunkIndex);
+  auto chunkMapIt = this->Internal->ChunkMap.find(key);
+  if (chunkMapIt != this->Internal->ChunkMap.end())
+  {
+    this->Internal->Remove(chunkMapIt->second);
+  }
+  vtkTypeInt64 size = static_cast<vtkTypeInt64>(voxels->GetDataSize()) * voxels->GetDataTypeSize();
+  if (size > this->MaximumSize)
+  {
+    return;
+  }
+  this->Shrink(this->MaximumSize - size);
+  vtkInternal::Chunk chunk;
+  chunk.Key = key;
+  chunk.Voxels = voxels;
+  chunk.Size = size;
+  this->Internal->Chunks.push_front(chunk);
+  this->Internal->ChunkMap[key] = this->Internal->Chunks.begin();
+  this->Internal->Size += size;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeChunkCache::RemoveChunks(const std::string& source)
+{
+  for (auto chunkIt = this->Internal->Chunks.begin(); chunkIt != this->Internal->Chunks.end();)
+  {
+    auto nextChunkIt = std::next(chunkIt);
+    if (chunkIt->Key.Source == source)
+    {
+      this->Internal->Remove(chunkIt);
+    }
+    chunkIt = nextChunkIt;
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeChunkCache::RemoveAllChunks()
+{
+  this->Internal->Chunks.clear();
+  this->Internal->ChunkMap.clear();
+  this->Internal->Size = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeChunkCache::Shrink(vtkTypeInt64 maximumSize)
+{
+  while (!this->Internal->Chunks.empty() && this->Internal->Size > maximumSize)
+  {
+    this->Internal->Remove(std::prev(this->Internal->Chunks.end()));
+  }
+}
@@ -0,0 +1,87 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#ifndef __vtkMRMLVolumeChunkCache_h
+#define __vtkMRMLVolumeChunkCache_h
+
+// MRML includes
+#include "vtkMRML.h"
+
+// VTK includes
+#include <vtkObject.h>
+#include <vtkType.h>
+
+// STD includes
+#include <string>
+
+class vtkDataArray;
+
+/// \brief Bounded in-memory cache of volume chunks.
+///
+/// Chunks of chunked volumes (see vtkMRMLChunkedVolumeStorageNode) are identified
+/// by their source (data set location), resolution level, and chunk index.
+/// When the total size of cached chunks exceeds MaximumSize then the least recently
+/// used chunks are removed.
+/// A cache can be shared between multiple storage nodes.
+class VTK_MRML_EXPORT vtkMRMLVolumeChunkCache : public vtkObject
+{
+public:
+  static vtkMRMLVolumeChunkCache* New();
+  vtkTypeMacro(vtkMRMLVolumeChunkCache, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Maximum total size of cached chunks, in bytes. Default is 256MB.
+  /// Least recently used chunks are removed immediately if the new limit is exceeded.
+  void SetMaximumSize(vtkTypeInt64 maximumSize);
+  vtkGetMacro(MaximumSize, vtkTypeInt64);
+
+  /// Total size of currently cached chunks, in bytes.
+  vtkTypeInt64 GetSize();
+
+  /// Number of currently cached chunks.
+  int GetNumberOfChunks();
+
+  /// Get a chunk from the cache. Returns nullptr if the chunk is not cached.
+  /// The chunk becomes the most recently used one.
+  vtkDataArray* GetChunk(const std::string& source, int level, const int chunkIndex[3]);
+
+  /// Add a chunk to the cache. If the chunk is larger than MaximumSize then it is not stored.
+  void AddChunk(const std::string& source, int level, const int chunkIndex[3], vtkDataArray* voxels);
+
+  /// Remove all chunks of the specified source.
+  void RemoveChunks(const std::string& source);
+
+  /// Remove all chunks.
+  void RemoveAllChunks();
+
+  /// Number of GetChunk calls that found the chunk in the cache.
+  vtkGetMacro(NumberOfHits, vtkTypeInt64);
+  /// Number of GetChunk calls that did not find the chunk in the cache.
+  vtkGetMacro(NumberOfMisses, vtkTypeInt64);
+
+protected:
+  vtkMRMLVolumeChunkCache();
+  ~vtkMRMLVolumeChunkCache() override;
+  vtkMRMLVolumeChunkCache(const vtkMRMLVolumeChunkCache&);
+  void operator=(const vtkMRMLVolumeChunkCache&);
+
+  /// Remove least recently used chunks until size is within the limit
+  void Shrink(vtkTypeInt64 maximumSize);
+
+  vtkTypeInt64 MaximumSize;
+  vtkTypeInt64 NumberOfHits{ 0 };
+  vtkTypeInt64 NumberOfMisses{ 0 };
+
+  class vtkInternal;
+  vtkInternal* Internal;
+};
+
+#endif
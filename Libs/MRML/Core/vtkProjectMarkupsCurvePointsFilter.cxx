@@ -33,6 +33,10 @@
 #include <vtkPointLocator.h>
 #include <vtkTransformPolyDataFilter.h>
 
+// STL includes
+#include <algorithm>
+#include <vector>
+
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkProjectMarkupsCurvePointsFilter);
 
@@ -41,6 +45,7 @@ vtkProjectMarkupsCurvePointsFilter::vtkProjectMarkupsCurvePointsFilter()
   : InputCurveNode()
   , MaximumSearchRadiusTolerance(0.25)
   , PointProjection()
+  , NumberOfProjectedPoints(0)
 {}
 
 //------------------------------------------------------------------------------
@@ -170,36 +175,15 @@ bool vtkProjectMarkupsCurvePointsFilter::ConstrainPointsToSurfaceImpl(vtkOBBTree
   double rayLength = maximumSearchRadiusTolerance*sqrt(polydataDiagonalLength);
 
   size_t noIntersectionCount = 0;
+  vtkNew<vtkGenericCell> cell;
   for (vtkIdType controlPointIndex = 0; controlPointIndex < originalPoints->GetNumberOfPoints(); controlPointIndex++)
   {
     originalPoints->GetPoint(controlPointIndex, originalPoint);
     normalVectors->GetTuple(controlPointIndex, rayDirection);
-    // Cast ray and find model intersection point
-    double rayEndPoint[3] = { 0.0, 0.0, 0.0 };
-    rayEndPoint[0] = originalPoint[0] + rayDirection[0] * rayLength;
-    rayEndPoint[1] = originalPoint[1] + rayDirection[1] * rayLength;
-    rayEndPoint[2] = originalPoint[2] + rayDirection[2] * rayLength;
-
-    double t = 0.0;
-    double pcoords[3] = { 0.0, 0.0, 0.0 };
-    int subId = 0;
-    vtkIdType cellId = 0;
-    vtkNew <vtkGenericCell> cell;
-    int foundIntersection = surfaceObbTree->IntersectWithLine(rayEndPoint, originalPoint, tolerance, t, exteriorPoint, pcoords, subId, cellId, cell);
-    if(foundIntersection == 0)
+    if (!vtkProjectMarkupsCurvePointsFilter::ProjectPointToSurfaceAlongRay(surfaceObbTree, pointLocator, surfacePolydata,
+      tolerance, rayLength, originalPoint, rayDirection, cell, exteriorPoint))
     {
-      // If no intersection, reverse direction of normal vector ray
-      rayEndPoint[0] = originalPoint[0] + rayDirection[0] * -rayLength;
-      rayEndPoint[1] = originalPoint[1] + rayDirection[1] * -rayLength;
-      rayEndPoint[2] = originalPoint[2] + rayDirection[2] * -rayLength;
-      int foundIntersection = surfaceObbTree->IntersectWithLine(originalPoint, rayEndPoint, tolerance, t, exteriorPoint, pcoords, subId, cellId, cell);
-      if(foundIntersection == 0)
-      {
-        // If no intersection in either direction, use closest mesh point
-        vtkIdType closestPointId = pointLocator->FindClosestPoint(originalPoint);
-        surfacePolydata->GetPoint(closestPointId, exteriorPoint);
-        ++noIntersectionCount;
-      }
+      ++noIntersectionCount;
     }
     surfacePoints->InsertNextPoint(exteriorPoint);
   }
@@ -210,6 +194,42 @@ bool vtkProjectMarkupsCurvePointsFilter::ConstrainPointsToSurfaceImpl(vtkOBBTree
   return true;
 }
 
+//---------------------------------------------------------------------------
+bool vtkProjectMarkupsCurvePointsFilter::ProjectPointToSurfaceAlongRay(vtkOBBTree* surfaceObbTree, vtkPointLocator* pointLocator,
+  vtkPolyData* surfacePolydata, double tolerance, double rayLength, const double originalPoint[3], const double rayDirection[3],
+  vtkGenericCell* cell, double surfacePoint[3])
+{
+  // Cast ray and find model intersection point
+  double rayStartPoint[3] = { originalPoint[0], originalPoint[1], originalPoint[2] };
+  double rayEndPoint[3] = { 0.0, 0.0, 0.0 };
+  rayEndPoint[0] = originalPoint[0] + rayDirection[0] * rayLength;
+  rayEndPoint[1] = originalPoint[1] + rayDirection[1] * rayLength;
+  rayEndPoint[2] = originalPoint[2] + rayDirection[2] * rayLength;
+
+  double t = 0.0;
+  double pcoords[3] = { 0.0, 0.0, 0.0 };
+  int subId = 0;
+  vtkIdType cellId = 0;
+  int foundIntersection = surfaceObbTree->IntersectWithLine(rayEndPoint, rayStartPoint, tolerance, t, surfacePoint, pcoords, subId, cellId, cell);
+  if (foundIntersection != 0)
+  {
+    return true;
+  }
+  // If no intersection, reverse direction of normal vector ray
+  rayEndPoint[0] = originalPoint[0] + rayDirection[0] * -rayLength;
+  rayEndPoint[1] = originalPoint[1] + rayDirection[1] * -rayLength;
+  rayEndPoint[2] = originalPoint[2] + rayDirection[2] * -rayLength;
+  foundIntersection = surfaceObbTree->IntersectWithLine(rayStartPoint, rayEndPoint, tolerance, t, surfacePoint, pcoords, subId, cellId, cell);
+  if (foundIntersection != 0)
+  {
+    return true;
+  }
+  // If no intersection in either direction, use closest mesh point
+  vtkIdType closestPointId = pointLocator->FindClosestPoint(originalPoint);
+  surfacePolydata->GetPoint(closestPointId, surfacePoint);
+  return false;
+}
+
 //---------------------------------------------------------------------------
 bool vtkProjectMarkupsCurvePointsFilter::ConstrainPointsToSurface(vtkPoints* originalPoints, vtkDoubleArray* normalVectors, vtkPolyData* surfacePolydata,
   vtkPoints* surfacePoints, double maximumSearchRadiusTolerance)
@@ -250,10 +270,70 @@ bool vtkProjectMarkupsCurvePointsFilter::ProjectPointsToSurface(
   {
     return false;
   }
+  if (maximumSearchRadiusTolerance <= 0.0 || maximumSearchRadiusTolerance > 1.0)
+  {
+    vtkErrorMacro("vtkProjectMarkupsCurvePointsFilter::ProjectPointsToSurface failed: Invalid search radius");
+    return false;
+  }
+
+  // Points that have the same position and projection direction as in the previous update are not projected
+  // again, which makes updates fast when only a few control points of a long curve are moved.
+  // All points are projected if the surface or the search radius has changed.
+  ProjectionCacheType& cache = this->ProjectionCache;
+  const vtkIdType numberOfPoints = pointsToProject->GetNumberOfPoints();
+  bool cacheValid = (cache.SurfaceMTime == this->PointProjection.GetSurfaceMTime()
+    && cache.MaximumSearchRadiusTolerance == maximumSearchRadiusTolerance
+    && static_cast<vtkIdType>(cache.InputPoints.size()) == 3 * numberOfPoints);
+  if (!cacheValid)
+  {
+    cache.SurfaceMTime = this->PointProjection.GetSurfaceMTime();
+    cache.MaximumSearchRadiusTolerance = maximumSearchRadiusTolerance;
+    cache.InputPoints.assign(3 * numberOfPoints, 0.0);
+    cache.RayDirections.assign(3 * numberOfPoints, 0.0);
+    cache.ProjectedPoints.assign(3 * numberOfPoints, 0.0);
+  }
+
+  vtkOBBTree* surfaceObbTree = this->PointProjection.GetObbTree();
+  vtkPointLocator* pointLocator = this->PointProjection.GetPointLocator();
+  double tolerance = surfaceObbTree->GetTolerance();
+  // The allowable projection distance is a percentage of the model's bounding box diagonal (same as in ConstrainPointsToSurfaceImpl)
+  vtkBoundingBox modelBoundingBox;
+  modelBoundingBox.AddBounds(surfacePolydata->GetBounds());
+  double rayLength = maximumSearchRadiusTolerance * sqrt(modelBoundingBox.GetDiagonalLength());
 
-  return vtkProjectMarkupsCurvePointsFilter::ConstrainPointsToSurfaceImpl(this->PointProjection.GetObbTree(), this->PointProjection.GetPointLocator(),
-    pointsToProject, pointNormalArray, surfacePolydata,
-    outputPoints, maximumSearchRadiusTolerance);
+  outputPoints->SetNumberOfPoints(numberOfPoints);
+  size_t noIntersectionCount = 0;
+  this->NumberOfProjectedPoints = 0;
+  vtkNew<vtkGenericCell> cell;
+  double originalPoint[3] = { 0.0, 0.0, 0.0 };
+  double rayDirection[3] = { 0.0, 0.0, 0.0 };
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+  {
+    pointsToProject->GetPoint(pointIndex, originalPoint);
+    pointNormalArray->GetTuple(pointIndex, rayDirection);
+    double* cachedInputPoint = cache.InputPoints.data() + 3 * pointIndex;
+    double* cachedRayDirection = cache.RayDirections.data() + 3 * pointIndex;
+    double* cachedProjectedPoint = cache.ProjectedPoints.data() + 3 * pointIndex;
+    if (!cacheValid
+      || originalPoint[0] != cachedInputPoint[0] || originalPoint[1] != cachedInputPoint[1] || originalPoint[2] != cachedInputPoint[2]
+      || rayDirection[0] != cachedRayDirection[0] || rayDirection[1] != cachedRayDirection[1] || rayDirection[2] != cachedRayDirection[2])
+    {
+      if (!vtkProjectMarkupsCurvePointsFilter::ProjectPointToSurfaceAlongRay(surfaceObbTree, pointLocator, surfacePolydata,
+        tolerance, rayLength, originalPoint, rayDirection, cell, cachedProjectedPoint))
+      {
+        ++noIntersectionCount;
+      }
+      std::copy(originalPoint, originalPoint + 3, cachedInputPoint);
+      std::copy(rayDirection, rayDirection + 3, cachedRayDirection);
+      ++this->NumberOfProjectedPoints;
+    }
+    outputPoints->SetPoint(pointIndex, cachedProjectedPoint);
+  }
+  if (noIntersectionCount > 0)
+  {
+    vtkWarningMacro("No intersections found for " << noIntersectionCount << " points for curve ");
+  }
+  return true;
 }
 
 //---------------------------------------------------------------------------
@@ -294,6 +374,13 @@ vtkOBBTree* vtkProjectMarkupsCurvePointsFilter::PointProjectionHelper::GetObbTre
   return this->ModelObbTree;
 }
 
+//---------------------------------------------------------------------------
+vtkMTimeType vtkProjectMarkupsCurvePointsFilter::PointProjectionHelper::GetSurfaceMTime()
+{
+  this->UpdateAll();
+  return this->SurfaceUpdateTime.GetMTime();
+}
+
 //---------------------------------------------------------------------------
 bool vtkProjectMarkupsCurvePointsFilter::PointProjectionHelper::UpdateAll()
 {
@@ -314,6 +401,7 @@ bool vtkProjectMarkupsCurvePointsFilter::PointProjectionHelper::UpdateAll()
     || !this->ModelNormalVectorArray)
   {
     this->LastModelModifiedTime = this->Model->GetMTime();
+    this->SurfaceUpdateTime.Modified();
     this->SurfacePolyData = this->Model->GetPolyData();
     if (parentTransformNode)
     {
@@ -386,9 +474,19 @@ vtkSmartPointer<vtkDoubleArray> vtkProjectMarkupsCurvePointsFilter::PointProject
     return vtkSmartPointer<vtkDoubleArray>();
   }
 
+  // Surface normals at the control points (each one is used by many curve points)
+  const vtkIdType numberOfControlPoints = controlPoints->GetNumberOfPoints();
+  std::vector<double> controlPointNormals(3 * numberOfControlPoints);
+  for (vtkIdType controlPointIndex = 0; controlPointIndex < numberOfControlPoints; ++controlPointIndex)
+  {
+    vtkIdType pointId = this->ModelPointLocator->FindClosestPoint(controlPoints->GetPoint(controlPointIndex));
+    this->ModelNormalVectorArray->GetTuple(pointId, controlPointNormals.data() + 3 * controlPointIndex);
+  }
+
   auto normals = vtkSmartPointer<vtkDoubleArray>::New();
   normals->SetNumberOfComponents(3);
   const auto numberOfPoints = points->GetNumberOfPoints();
+  normals->Allocate(3 * numberOfPoints);
   for (vtkIdType i = 0; i < numberOfPoints; ++i)
   {
     const double* point = points->GetPoint(i);
@@ -429,12 +527,8 @@ vtkSmartPointer<vtkDoubleArray> vtkProjectMarkupsCurvePointsFilter::PointProject
     const auto distance2ToStart = vtkMath::Distance2BetweenPoints(point, segmentStartPoint);
     const auto distance2ToEnd = vtkMath::Distance2BetweenPoints(point, segmentEndPoint);
 
-    vtkIdType pointIdStart = this->ModelPointLocator->FindClosestPoint(segmentStartPoint);
-    double startNormal[3] = { 0.0, 0.0, 0.0 };
-    this->ModelNormalVectorArray->GetTuple(pointIdStart, startNormal);
-    vtkIdType pointIdEnd = this->ModelPointLocator->FindClosestPoint(segmentEndPoint);
-    double endNormal[3] = { 0.0, 0.0, 0.0 };
-    this->ModelNormalVectorArray->GetTuple(pointIdEnd, endNormal);
+    const double* startNormal = controlPointNormals.data() + 3 * segmentStartIndex;
+    const double* endNormal = controlPointNormals.data() + 3 * segmentEndIndex;
 
     const double startWeight = distance2ToEnd / (distance2ToStart + distance2ToEnd);
     const double endWeight = distance2ToStart / (distance2ToStart + distance2ToEnd);
@@ -24,7 +24,11 @@
 #include <vtkPolyDataAlgorithm.h>
 #include <vtkWeakPointer.h>
 
+// STL includes
+#include <vector>
+
 class vtkDoubleArray;
+class vtkGenericCell;
 class vtkOBBTree;
 class vtkPointLocator;
 class vtkPoints;
@@ -100,6 +104,11 @@ public:
   double GetMaximumSearchRadiusTolerance() const;
   ///@}
 
+  /// Get number of points that were projected to the surface in the last update.
+  /// Points that have not moved since the previous update (and whose projection direction has not changed)
+  /// reuse the previous projection result and are not included in this count.
+  vtkIdType GetNumberOfProjectedPoints() const { return this->NumberOfProjectedPoints; };
+
 protected:
   int FillInputPortInformation(int port, vtkInformation* info) override;
   int RequestData(vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector) override;
@@ -113,6 +122,11 @@ private:
   static bool ConstrainPointsToSurfaceImpl(vtkOBBTree* surfaceObbTree, vtkPointLocator* pointLocator,
       vtkPoints* originalPoints, vtkDoubleArray* normalVectors, vtkPolyData* surfacePolydata,
       vtkPoints* surfacePoints, double maximumSearchRadius=.25);
+  /// Project a point to the surface along the ray direction (or in the opposite direction if there is no intersection).
+  /// \return false if there was no intersection and the closest surface point was used instead.
+  static bool ProjectPointToSurfaceAlongRay(vtkOBBTree* surfaceObbTree, vtkPointLocator* pointLocator,
+      vtkPolyData* surfacePolydata, double tolerance, double rayLength, const double originalPoint[3], const double rayDirection[3],
+      vtkGenericCell* cell, double surfacePoint[3]);
 
   class PointProjectionHelper
   {
@@ -125,6 +139,8 @@ private:
     vtkPointLocator* GetPointLocator();
     vtkOBBTree* GetObbTree();
     vtkPolyData* GetSurfacePolyData();
+    /// Modification time of the surface data, changes each time the surface is updated from the model.
+    vtkMTimeType GetSurfaceMTime();
 
   private:
     vtkMRMLModelNode* Model;
@@ -134,12 +150,25 @@ private:
     vtkSmartPointer<vtkPointLocator> ModelPointLocator;
     vtkSmartPointer<vtkOBBTree> ModelObbTree;
     vtkSmartPointer<vtkPolyData> SurfacePolyData;
+    vtkTimeStamp SurfaceUpdateTime;
 
     bool UpdateAll();
     static vtkIdType GetClosestControlPointIndex(const double point[3], vtkPoints* controlPoints);
   };
 
   PointProjectionHelper PointProjection;
+
+  /// Inputs and results of the last projection, for only projecting points that have changed
+  struct ProjectionCacheType
+  {
+    vtkMTimeType SurfaceMTime{0};
+    double MaximumSearchRadiusTolerance{0.0};
+    std::vector<double> InputPoints;
+    std::vector<double> RayDirections;
+    std::vector<double> ProjectedPoints;
+  };
+  ProjectionCacheType ProjectionCache;
+  vtkIdType NumberOfProjectedPoints;
 };
 
 #endif
@@ -0,0 +1,168 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRMLDisplayableManager includes
+#include <vtkMRMLCellLocatorPicker.h>
+
+// VTK includes
+#include <vtkActor.h>
+#include <vtkCellPicker.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkSphereSource.h>
+#include <vtkTimerLog.h>
+#include <vtkTransform.h>
+
+#include "vtkMRMLCoreTestingMacros.h"
+
+//----------------------------------------------------------------------------
+namespace
+{
+
+const int NUMBER_OF_PICKS = 5;
+const double PICK_POSITIONS[NUMBER_OF_PICKS][2] = { { 150, 150 }, { 120, 170 }, { 180, 140 }, { 100, 100 }, { 200, 210 } };
+
+// Pick at all the test positions, check that both pickers give the same result,
+// and print the average pick time.
+int ComparePicks(vtkCellPicker* picker, vtkCellPicker* referencePicker, vtkRenderer* renderer, const char* description)
+{
+  vtkNew<vtkTimerLog> timer;
+  double pickTime = 0.0;
+  double referencePickTime = 0.0;
+  for (int i = 0; i < NUMBER_OF_PICKS; ++i)
+  {
+    timer->StartTimer();
+    int picked = picker->Pick(PICK_POSITIONS[i][0], PICK_POSITIONS[i][1], 0, renderer);
+    timer->StopTimer();
+    pickTime += timer->GetElapsedTime();
+
+    timer->StartTimer();
+    int referencePicked = referencePicker->Pick(PICK_POSITIONS[i][0], PICK_POSITIONS[i][1], 0, renderer);
+    timer->StopTimer();
+    referencePickTime += timer->GetElapsedTime();
+
+    CHECK_INT(picked, referencePicked);
+    CHECK_INT(picked, 1);
+    CHECK_INT(picker->GetCellId(), referencePicker->GetCellId());
+    CHECK_DOUBLE_TOLERANCE(sqrt(vtkMath::Distance2BetweenPoints(
+      picker->GetPickPosition(), referencePicker->GetPickPosition())), 0.0, 1e-3);
+  }
+  std::cout << description << ": average pick time with locator: " << pickTime / NUMBER_OF_PICKS * 1000.0
+    << "ms, without locator: " << referencePickTime / NUMBER_OF_PICKS * 1000.0 << "ms" << std::endl;
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLCellLocatorPickerTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  // Large mesh (about 2 million triangles)
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetRadius(50.0);
+  sphere->SetThetaResolution(1000);
+  sphere->SetPhiResolution(1000);
+  sphere->Update();
+  std::cout << "Number of cells: " << sphere->GetOutput()->GetNumberOfCells() << std::endl;
+
+  vtkNew<vtkPolyDataMapper> mapper;
+  mapper->SetInputConnection(sphere->GetOutputPort());
+  vtkNew<vtkActor> actor;
+  actor->SetMapper(mapper);
+
+  vtkNew<vtkRenderer> renderer;
+  renderer->AddActor(actor);
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetSize(300, 300);
+  renderWindow->AddRenderer(renderer);
+  renderer->ResetCamera();
+  renderWindow->Render();
+
+  vtkNew<vtkMRMLCellLocatorPicker> picker;
+  picker->SetTolerance(0.005);
+  vtkNew<vtkCellPicker> referencePicker;
+  referencePicker->SetTolerance(0.005);
+
+  // First pick builds the locator
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  picker->UpdateLocators(renderer);
+  timer->StopTimer();
+  std::cout << "Locator build time: " << timer->GetElapsedTime() * 1000.0 << "ms" << std::endl;
+  CHECK_INT(picker->GetNumberOfCachedLocators(), 1);
+  CHECK_INT(picker->GetNumberOfLocatorBuilds(), 1);
+
+  CHECK_EXIT_SUCCESS(ComparePicks(picker, referencePicker, renderer, "Initial mesh"));
+  CHECK_INT(picker->GetNumberOfLocatorBuilds(), 1);
+
+  // Changing the actor transform does not require rebuilding the locator
+  vtkNew<vtkTransform> actorTransform;
+  actorTransform->Translate(5.0, -3.0, 2.0);
+  actorTransform->RotateZ(30.0);
+  actor->SetUserTransform(actorTransform);
+  renderWindow->Render();
+  CHECK_EXIT_SUCCESS(ComparePicks(picker, referencePicker, renderer, "Transformed actor"));
+  CHECK_INT(picker->GetNumberOfLocatorBuilds(), 1);
+
+  // Changing the mesh rebuilds the locator
+  sphere->SetRadius(40.0);
+  renderWindow->Render();
+  CHECK_EXIT_SUCCESS(ComparePicks(picker, referencePicker, renderer, "Modified mesh"));
+  CHECK_INT(picker->GetNumberOfLocatorBuilds(), 2);
+
+  // Small meshes are picked without locator
+  sphere->SetThetaResolution(8);
+  sphere->SetPhiResolution(8);
+  renderWindow->Render();
+  CHECK_EXIT_SUCCESS(ComparePicks(picker, referencePicker, renderer, "Small mesh"));
+  CHECK_INT(picker->GetNumberOfCachedLocators(), 0);
+
+  // Locator is released when the actor is removed
+  sphere->SetThetaResolution(1000);
+  sphere->SetPhiResolution(1000);
+  renderWindow->Render();
+  picker->UpdateLocators(renderer);
+  CHECK_INT(picker->GetNumberOfCachedLocators(), 1);
+  renderer->RemoveActor(actor);
+  picker->UpdateLocators(renderer);
+  CHECK_INT(picker->GetNumberOfCachedLocators(), 0);
+
+  // Pickers that share the locator cache build each locator only once
+  renderer->AddActor(actor);
+  renderWindow->Render();
+  vtkNew<vtkMRMLCellLocatorPicker> sharingPicker;
+  sharingPicker->SetTolerance(0.005);
+  sharingPicker->SetLocatorCache(picker->GetLocatorCache());
+  CHECK_POINTER(sharingPicker->GetLocatorCache(), picker->GetLocatorCache());
+  const int numberOfLocatorBuilds = picker->GetNumberOfLocatorBuilds();
+  CHECK_EXIT_SUCCESS(ComparePicks(picker, referencePicker, renderer, "Picker owning the locator cache"));
+  CHECK_EXIT_SUCCESS(ComparePicks(sharingPicker, referencePicker, renderer, "Picker sharing the locator cache"));
+  CHECK_INT(sharingPicker->GetNumberOfCachedLocators(), 1);
+  CHECK_INT(sharingPicker->GetNumberOfLocatorBuilds(), numberOfLocatorBuilds + 1);
+
+  // Locators released by one picker are released for the other picker, too
+  renderer->RemoveActor(actor);
+  picker->UpdateLocators(renderer);
+  CHECK_INT(sharingPicker->GetNumberOfCachedLocators(), 0);
+  CHECK_INT(sharingPicker->Pick(PICK_POSITIONS[0][0], PICK_POSITIONS[0][1], 0, renderer), 0);
+
+  return EXIT_SUCCESS;
+}
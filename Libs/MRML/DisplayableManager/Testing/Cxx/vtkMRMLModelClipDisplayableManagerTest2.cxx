@@ -0,0 +1,231 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRMLDisplayableManager includes
+#include <vtkMRMLDisplayableManagerGroup.h>
+#include <vtkMRMLModelDisplayableManager.h>
+
+// MRMLLogic includes
+#include <vtkMRMLApplicationLogic.h>
+
+// MRML includes
+#include <vtkMRMLClipNode.h>
+#include <vtkMRMLCoreTestingMacros.h>
+#include <vtkMRMLLinearTransformNode.h>
+#include <vtkMRMLModelDisplayNode.h>
+#include <vtkMRMLModelNode.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSliceNode.h>
+#include <vtkMRMLViewNode.h>
+
+// VTK includes
+#include <vtkActor.h>
+#include <vtkAlgorithm.h>
+#include <vtkAppendFilter.h>
+#include <vtkDataSet.h>
+#include <vtkMapper.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkSphereSource.h>
+#include <vtkTimerLog.h>
+#include <vtkTransform.h>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+vtkDataSet* GetDisplayedMesh(vtkMRMLModelDisplayableManager* displayableManager, vtkMRMLModelDisplayNode* displayNode)
+{
+  vtkActor* actor = vtkActor::SafeDownCast(displayableManager->GetActorByID(displayNode->GetID()));
+  if (!actor || !actor->GetMapper())
+  {
+    return nullptr;
+  }
+  return actor->GetMapper()->GetInput();
+}
+
+//----------------------------------------------------------------------------
+const char* GetDisplayedMeshFilterClassName(vtkMRMLModelDisplayableManager* displayableManager,
+  vtkMRMLModelDisplayNode* displayNode)
+{
+  vtkActor* actor = vtkActor::SafeDownCast(displayableManager->GetActorByID(displayNode->GetID()));
+  if (!actor || !actor->GetMapper() || !actor->GetMapper()->GetInputAlgorithm())
+  {
+    return "";
+  }
+  return actor->GetMapper()->GetInputAlgorithm()->GetClassName();
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+// Check that clipped meshes are only recomputed when the mesh, the clip node,
+// or the transform changes, and not when only display properties change.
+int vtkMRMLModelClipDisplayableManagerTest2(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkRenderer> renderer;
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetSize(300, 300);
+  renderWindow->AddRenderer(renderer);
+  vtkNew<vtkRenderWindowInteractor> renderWindowInteractor;
+  renderWindow->SetInteractor(renderWindowInteractor);
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLApplicationLogic> applicationLogic;
+  applicationLogic->SetMRMLScene(scene);
+
+  vtkNew<vtkMRMLViewNode> viewNode;
+  scene->AddNode(viewNode);
+
+  vtkNew<vtkMRMLDisplayableManagerGroup> displayableManagerGroup;
+  displayableManagerGroup->SetRenderer(renderer);
+  displayableManagerGroup->SetMRMLDisplayableNode(viewNode);
+  vtkNew<vtkMRMLModelDisplayableManager> displayableManager;
+  displayableManager->SetMRMLApplicationLogic(applicationLogic);
+  displayableManagerGroup->AddDisplayableManager(displayableManager);
+  displayableManagerGroup->GetInteractor()->Initialize();
+
+  vtkNew<vtkTransform> sliceToRAS;
+  sliceToRAS->RotateX(60);
+  vtkNew<vtkMRMLSliceNode> sliceNode;
+  sliceNode->GetSliceToRAS()->DeepCopy(sliceToRAS->GetMatrix());
+  sliceNode->UpdateMatrices();
+  scene->AddNode(sliceNode);
+
+  vtkNew<vtkMRMLClipNode> clipNode;
+  scene->AddNode(clipNode);
+  clipNode->SetAndObserveClippingNodeID(sliceNode->GetID());
+
+  // Large surface mesh
+  vtkNew<vtkSphereSource> sphereSource;
+  sphereSource->SetRadius(10.0);
+  sphereSource->SetThetaResolution(500);
+  sphereSource->SetPhiResolution(500);
+  vtkNew<vtkMRMLModelNode> modelNode;
+  modelNode->SetPolyDataConnection(sphereSource->GetOutputPort());
+  scene->AddNode(modelNode);
+
+  vtkNew<vtkMRMLModelDisplayNode> modelDisplayNode;
+  modelDisplayNode->SetAndObserveClipNodeID(clipNode->GetID());
+  modelDisplayNode->ClippingOn();
+  scene->AddNode(modelDisplayNode);
+  modelNode->AddAndObserveDisplayNodeID(modelDisplayNode->GetID());
+
+  renderer->ResetCamera();
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  renderWindow->Render();
+  timer->StopTimer();
+  std::cout << "Initial clipping and rendering time: " << timer->GetElapsedTime() * 1000.0 << "ms" << std::endl;
+
+  vtkDataSet* clippedMesh = GetDisplayedMesh(displayableManager, modelDisplayNode);
+  CHECK_NOT_NULL(clippedMesh);
+  CHECK_STRING(GetDisplayedMeshFilterClassName(displayableManager, modelDisplayNode), "vtkClipPolyData");
+  vtkMTimeType clippedMeshMTime = clippedMesh->GetMTime();
+
+  // Display property changes do not re-clip the mesh
+  timer->StartTimer();
+  modelDisplayNode->SetColor(1.0, 0.0, 0.0);
+  modelDisplayNode->SetOpacity(0.5);
+  renderWindow->Render();
+  timer->StopTimer();
+  std::cout << "Display property change time: " << timer->GetElapsedTime() * 1000.0 << "ms" << std::endl;
+  CHECK_POINTER(GetDisplayedMesh(displayableManager, modelDisplayNode), clippedMesh);
+  CHECK_INT(clippedMesh->GetMTime(), clippedMeshMTime);
+
+  // Clipping results are kept when the scene is updated
+  vtkNew<vtkMRMLModelNode> otherModelNode;
+  scene->AddNode(otherModelNode);
+  renderWindow->Render();
+  CHECK_POINTER(GetDisplayedMesh(displayableManager, modelDisplayNode), clippedMesh);
+  CHECK_INT(clippedMesh->GetMTime(), clippedMeshMTime);
+
+  // Moving the clipping plane re-clips the mesh
+  vtkNew<vtkTransform> movedSliceToRAS;
+  movedSliceToRAS->Translate(0.0, 0.0, 3.0);
+  movedSliceToRAS->RotateX(60);
+  sliceNode->GetSliceToRAS()->DeepCopy(movedSliceToRAS->GetMatrix());
+  sliceNode->UpdateMatrices();
+  renderWindow->Render();
+  clippedMesh = GetDisplayedMesh(displayableManager, modelDisplayNode);
+  CHECK_BOOL(clippedMesh->GetMTime() > clippedMeshMTime, true);
+  clippedMeshMTime = clippedMesh->GetMTime();
+
+  // Linear transform of the model re-clips the mesh, but display property changes still do not
+  vtkNew<vtkMRMLLinearTransformNode> transformNode;
+  scene->AddNode(transformNode);
+  vtkNew<vtkMatrix4x4> transformMatrix;
+  transformMatrix->SetElement(2, 3, 5.0);
+  transformNode->SetMatrixTransformToParent(transformMatrix);
+  modelNode->SetAndObserveTransformNodeID(transformNode->GetID());
+  renderWindow->Render();
+  clippedMesh = GetDisplayedMesh(displayableManager, modelDisplayNode);
+  CHECK_BOOL(clippedMesh->GetMTime() > clippedMeshMTime, true);
+  clippedMeshMTime = clippedMesh->GetMTime();
+
+  modelDisplayNode->SetColor(0.0, 1.0, 0.0);
+  renderWindow->Render();
+  CHECK_POINTER(GetDisplayedMesh(displayableManager, modelDisplayNode), clippedMesh);
+  CHECK_INT(clippedMesh->GetMTime(), clippedMeshMTime);
+
+  transformMatrix->SetElement(2, 3, 2.0);
+  transformNode->SetMatrixTransformToParent(transformMatrix);
+  renderWindow->Render();
+  clippedMesh = GetDisplayedMesh(displayableManager, modelDisplayNode);
+  CHECK_BOOL(clippedMesh->GetMTime() > clippedMeshMTime, true);
+  clippedMeshMTime = clippedMesh->GetMTime();
+
+  // Mesh change re-clips the mesh
+  sphereSource->SetRadius(12.0);
+  renderWindow->Render();
+  clippedMesh = GetDisplayedMesh(displayableManager, modelDisplayNode);
+  CHECK_BOOL(clippedMesh->GetMTime() > clippedMeshMTime, true);
+
+  // Volumetric mesh clipped with the parallel filter
+  vtkNew<vtkAppendFilter> unstructuredGridFilter;
+  unstructuredGridFilter->SetInputConnection(sphereSource->GetOutputPort());
+  vtkNew<vtkMRMLModelNode> volumetricModelNode;
+  volumetricModelNode->SetUnstructuredGridConnection(unstructuredGridFilter->GetOutputPort());
+  scene->AddNode(volumetricModelNode);
+  vtkNew<vtkMRMLModelDisplayNode> volumetricModelDisplayNode;
+  volumetricModelDisplayNode->SetAndObserveClipNodeID(clipNode->GetID());
+  volumetricModelDisplayNode->ClippingOn();
+  scene->AddNode(volumetricModelDisplayNode);
+  volumetricModelNode->AddAndObserveDisplayNodeID(volumetricModelDisplayNode->GetID());
+  renderWindow->Render();
+  CHECK_STRING(GetDisplayedMeshFilterClassName(displayableManager, volumetricModelDisplayNode), "vtkClipDataSet");
+  vtkIdType numberOfClippedCells = GetDisplayedMesh(displayableManager, volumetricModelDisplayNode)->GetNumberOfCells();
+
+  displayableManager->ParallelClippingOn();
+  timer->StartTimer();
+  renderWindow->Render();
+  timer->StopTimer();
+  std::cout << "Parallel clipping and rendering time: " << timer->GetElapsedTime() * 1000.0 << "ms" << std::endl;
+  CHECK_STRING(GetDisplayedMeshFilterClassName(displayableManager, volumetricModelDisplayNode), "vtkTableBasedClipDataSet");
+  CHECK_BOOL(GetDisplayedMesh(displayableManager, volumetricModelDisplayNode)->GetNumberOfCells() > 0, true);
+  std::cout << "Number of clipped cells: " << numberOfClippedCells << " (vtkClipDataSet), "
+    << GetDisplayedMesh(displayableManager, volumetricModelDisplayNode)->GetNumberOfCells()
+    << " (vtkTableBasedClipDataSet)" << std::endl;
+
+  // Surface meshes are not affected by the parallel clipping option
+  CHECK_STRING(GetDisplayedMeshFilterClassName(displayableManager, modelDisplayNode), "vtkClipPolyData");
+
+  return EXIT_SUCCESS;
+}
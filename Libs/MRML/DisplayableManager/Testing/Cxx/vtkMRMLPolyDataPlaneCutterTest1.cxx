@@ -0,0 +1,94 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRMLDisplayableManager includes
+#include <vtkMRMLPolyDataPlaneCutter.h>
+
+// VTK includes
+#include <vtkCutter.h>
+#include <vtkNew.h>
+#include <vtkPlane.h>
+#include <vtkPolyData.h>
+#include <vtkSphereSource.h>
+
+#include "vtkMRMLCoreTestingMacros.h"
+
+//----------------------------------------------------------------------------
+namespace
+{
+
+// Compare the output of the indexed cutter to the output of vtkCutter
+int CheckCut(vtkMRMLPolyDataPlaneCutter* cutter, vtkAlgorithmOutput* input, vtkPlane* plane)
+{
+  cutter->Update();
+  vtkNew<vtkCutter> referenceCutter;
+  referenceCutter->SetCutFunction(plane);
+  referenceCutter->SetInputConnection(input);
+  referenceCutter->Update();
+  CHECK_BOOL(referenceCutter->GetOutput()->GetNumberOfLines() > 0, true);
+  CHECK_INT(cutter->GetOutput()->GetNumberOfLines(), referenceCutter->GetOutput()->GetNumberOfLines());
+  CHECK_INT(cutter->GetOutput()->GetNumberOfPoints(), referenceCutter->GetOutput()->GetNumberOfPoints());
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLPolyDataPlaneCutterTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetRadius(50.0);
+  sphere->SetThetaResolution(64);
+  sphere->SetPhiResolution(64);
+
+  vtkNew<vtkPlane> plane;
+  plane->SetNormal(0.0, 0.0, 1.0);
+  plane->SetOrigin(0.0, 0.0, 0.3);
+
+  vtkNew<vtkMRMLPolyDataPlaneCutter> cutter;
+  cutter->SetPlane(plane);
+  cutter->SetInputConnection(sphere->GetOutputPort());
+  CHECK_EXIT_SUCCESS(CheckCut(cutter, sphere->GetOutputPort(), plane));
+  CHECK_INT(cutter->GetNumberOfIndexBuilds(), 1);
+
+  // Moving the plane along its normal reuses the index
+  for (double offset = -45.3; offset < 45.0; offset += 10.0)
+  {
+    plane->SetOrigin(0.0, 0.0, offset);
+    CHECK_EXIT_SUCCESS(CheckCut(cutter, sphere->GetOutputPort(), plane));
+  }
+  CHECK_INT(cutter->GetNumberOfIndexBuilds(), 1);
+
+  // Plane outside the mesh
+  plane->SetOrigin(0.0, 0.0, 60.0);
+  cutter->Update();
+  CHECK_INT(cutter->GetOutput()->GetNumberOfLines(), 0);
+  CHECK_INT(cutter->GetNumberOfIndexBuilds(), 1);
+
+  // Rotating the plane rebuilds the index
+  plane->SetNormal(0.2, 0.3, 0.9);
+  plane->SetOrigin(1.1, -2.3, 4.7);
+  CHECK_EXIT_SUCCESS(CheckCut(cutter, sphere->GetOutputPort(), plane));
+  CHECK_INT(cutter->GetNumberOfIndexBuilds(), 2);
+
+  // Changing the mesh rebuilds the index
+  sphere->SetThetaResolution(32);
+  CHECK_EXIT_SUCCESS(CheckCut(cutter, sphere->GetOutputPort(), plane));
+  CHECK_INT(cutter->GetNumberOfIndexBuilds(), 3);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,183 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRMLDisplayableManager includes
+#include "vtkMRMLCellLocatorCache.h"
+
+// VTK includes
+#include <vtkActor.h>
+#include <vtkDataSet.h>
+#include <vtkMapper.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPropCollection.h>
+#include <vtkRenderer.h>
+#include <vtkSmartPointer.h>
+#include <vtkStaticCellLocator.h>
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <iterator>
+#include <map>
+#include <set>
+
+vtkStandardNewMacro(vtkMRMLCellLocatorCache);
+
+//----------------------------------------------------------------------------
+class vtkMRMLCellLocatorCache::vtkInternal
+{
+public:
+  struct CachedLocator
+  {
+    vtkWeakPointer<vtkDataSet> DataSet;
+    vtkSmartPointer<vtkStaticCellLocator> Locator;
+    vtkMTimeType DataSetMTime{ 0 };
+  };
+
+  /// Cached locators, the key is the mesh
+  std::map<vtkDataSet*, CachedLocator> Locators;
+};
+
+//----------------------------------------------------------------------------
+vtkMRMLCellLocatorCache::vtkMRMLCellLocatorCache()
+{
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLCellLocatorCache::~vtkMRMLCellLocatorCache()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLCellLocatorCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "MinimumNumberOfCells: " << this->MinimumNumberOfCells << "\n";
+  os << indent << "NumberOfLocators: " << this->Internal->Locators.size() << "\n";
+  os << indent << "NumberOfLocatorBuilds: " << this->NumberOfLocatorBuilds << "\n";
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLCellLocatorCache::GetNumberOfLocators()
+{
+  return static_cast<int>(this->Internal->Locators.size());
+}
+
+//----------------------------------------------------------------------------
+vtkAbstractCellLocator* vtkMRMLCellLocatorCache::GetNthLocator(int index)
+{
+  if (index < 0 || index >= this->GetNumberOfLocators())
+  {
+    vtkErrorMacro("GetNthLocator failed: index " << index << " is out of range");
+    return nullptr;
+  }
+  auto locatorIt = this->Internal->Locators.begin();
+  std::advance(locatorIt, index);
+  return locatorIt->second.Locator;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLCellLocatorCache::Clear()
+{
+  if (this->Internal->Locators.empty())
+  {
+    return;
+  }
+  this->Internal->Locators.clear();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLCellLocatorCache::Update(vtkRenderer* renderer)
+{
+  if (!renderer)
+  {
+    return;
+  }
+
+  // Collect meshes of all pickable actors (including parts of assemblies)
+  std::set<vtkDataSet*> meshes;
+  vtkNew<vtkPropCollection> actors;
+  vtkPropCollection* props = renderer->GetViewProps();
+  vtkCollectionSimpleIterator propIt;
+  vtkProp* prop = nullptr;
+  for (props->InitTraversal(propIt); (prop = props->GetNextProp(propIt));)
+  {
+    if (prop->GetVisibility() && prop->GetPickable())
+    {
+      prop->GetActors(actors);
+    }
+  }
+  for (actors->InitTraversal(propIt); (prop = actors->GetNextProp(propIt));)
+  {
+    vtkActor* actor = vtkActor::SafeDownCast(prop);
+    if (!actor || !actor->GetVisibility() || !actor->GetPickable() || !actor->GetMapper())
+    {
+      continue;
+    }
+    vtkDataSet* mesh = actor->GetMapper()->GetInput();
+    if (mesh && mesh->GetNumberOfCells() >= this->MinimumNumberOfCells)
+    {
+      meshes.insert(mesh);
+    }
+  }
+
+  bool modified = false;
+
+  // Release locators of meshes that are not displayed anymore
+  for (auto locatorIt = this->Internal->Locators.begin(); locatorIt != this->Internal->Locators.end();)
+  {
+    if (!locatorIt->second.DataSet || meshes.find(locatorIt->first) == meshes.end())
+    {
+      locatorIt = this->Internal->Locators.erase(locatorIt);
+      modified = true;
+    }
+    else
+    {
+      ++locatorIt;
+    }
+  }
+
+  // Create and build locators
+  for (vtkDataSet* mesh : meshes)
+  {
+    vtkInternal::CachedLocator& cachedLocator = this->Internal->Locators[mesh];
+    if (!cachedLocator.Locator)
+    {
+      cachedLocator.DataSet = mesh;
+      cachedLocator.Locator = vtkSmartPointer<vtkStaticCellLocator>::New();
+      cachedLocator.Locator->SetDataSet(mesh);
+      modified = true;
+    }
+    else if (cachedLocator.DataSetMTime == mesh->GetMTime())
+    {
+      // up-to-date
+      continue;
+    }
+    cachedLocator.Locator->BuildLocator();
+    cachedLocator.DataSetMTime = mesh->GetMTime();
+    this->NumberOfLocatorBuilds++;
+  }
+
+  if (modified)
+  {
+    // Pickers that use this cache update their list of locators
+    this->Modified();
+  }
+}
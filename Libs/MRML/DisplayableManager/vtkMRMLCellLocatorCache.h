@@ -0,0 +1,83 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkMRMLCellLocatorCache_h
+#define __vtkMRMLCellLocatorCache_h
+
+// MRMLDisplayableManager includes
+#include "vtkMRMLDisplayableManagerExport.h"
+
+// VTK includes
+#include <vtkObject.h>
+
+class vtkAbstractCellLocator;
+class vtkRenderer;
+
+/// \brief Cell locators of the large meshes displayed in a renderer.
+///
+/// A vtkStaticCellLocator is created for each visible and pickable actor whose input has at least
+/// MinimumNumberOfCells cells. Locators are only rebuilt when the modification time of the mesh changes
+/// and they are released when the mesh is no longer displayed.
+///
+/// The cache can be shared between several vtkMRMLCellLocatorPicker objects that pick in the same
+/// renderer, so that the locator of each mesh is built only once.
+/// \sa vtkMRMLCellLocatorPicker
+class VTK_MRML_DISPLAYABLEMANAGER_EXPORT vtkMRMLCellLocatorCache : public vtkObject
+{
+public:
+  static vtkMRMLCellLocatorCache* New();
+  vtkTypeMacro(vtkMRMLCellLocatorCache, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Meshes that have less cells than this do not get a locator,
+  /// because building the locator would take longer than picking all the cells. Default is 10000.
+  vtkSetMacro(MinimumNumberOfCells, vtkIdType);
+  vtkGetMacro(MinimumNumberOfCells, vtkIdType);
+
+  /// Number of cached locators.
+  int GetNumberOfLocators();
+
+  /// Get a cached locator.
+  vtkAbstractCellLocator* GetNthLocator(int index);
+
+  /// Number of times a locator has been built.
+  /// Can be used for checking that locators are reused.
+  vtkGetMacro(NumberOfLocatorBuilds, int);
+
+  /// Remove all cached locators.
+  void Clear();
+
+  /// Create or rebuild the locators of the meshes that are displayed in the renderer
+  /// and release locators of meshes that are not displayed anymore.
+  void Update(vtkRenderer* renderer);
+
+protected:
+  vtkMRMLCellLocatorCache();
+  ~vtkMRMLCellLocatorCache() override;
+
+  vtkIdType MinimumNumberOfCells{ 10000 };
+  int NumberOfLocatorBuilds{ 0 };
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkMRMLCellLocatorCache(const vtkMRMLCellLocatorCache&) = delete;
+  void operator=(const vtkMRMLCellLocatorCache&) = delete;
+};
+
+#endif
@@ -0,0 +1,144 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRMLDisplayableManager includes
+#include "vtkMRMLCellLocatorCache.h"
+#include "vtkMRMLCellLocatorPicker.h"
+
+// VTK includes
+#include <vtkAbstractCellLocator.h>
+#include <vtkObjectFactory.h>
+
+vtkStandardNewMacro(vtkMRMLCellLocatorPicker);
+
+//----------------------------------------------------------------------------
+vtkMRMLCellLocatorPicker::vtkMRMLCellLocatorPicker()
+{
+  this->LocatorCache = vtkSmartPointer<vtkMRMLCellLocatorCache>::New();
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLCellLocatorPicker::~vtkMRMLCellLocatorPicker() = default;
+
+//----------------------------------------------------------------------------
+void vtkMRMLCellLocatorPicker::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "LocatorCache:";
+  if (this->LocatorCache)
+  {
+    os << "\n";
+    this->LocatorCache->PrintSelf(os, indent.GetNextIndent());
+  }
+  else
+  {
+    os << " (none)\n";
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLCellLocatorCache* vtkMRMLCellLocatorPicker::GetLocatorCache()
+{
+  return this->LocatorCache;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLCellLocatorPicker::SetLocatorCache(vtkMRMLCellLocatorCache* locatorCache)
+{
+  if (!locatorCache)
+  {
+    vtkErrorMacro("SetLocatorCache failed: invalid locator cache");
+    return;
+  }
+  if (this->LocatorCache == locatorCache)
+  {
+    return;
+  }
+  this->LocatorCache = locatorCache;
+  this->PickerLocatorsUpdateTime = 0;
+  this->UpdatePickerLocators();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLCellLocatorPicker::SetMinimumNumberOfCells(vtkIdType minimumNumberOfCells)
+{
+  this->LocatorCache->SetMinimumNumberOfCells(minimumNumberOfCells);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkMRMLCellLocatorPicker::GetMinimumNumberOfCells()
+{
+  return this->LocatorCache->GetMinimumNumberOfCells();
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLCellLocatorPicker::GetNumberOfCachedLocators()
+{
+  return this->LocatorCache->GetNumberOfLocators();
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLCellLocatorPicker::GetNumberOfLocatorBuilds()
+{
+  return this->LocatorCache->GetNumberOfLocatorBuilds();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLCellLocatorPicker::ClearLocatorCache()
+{
+  this->LocatorCache->Clear();
+  this->UpdatePickerLocators();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLCellLocatorPicker::UpdateLocators(vtkRenderer* renderer)
+{
+  this->LocatorCache->Update(renderer);
+  this->UpdatePickerLocators();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLCellLocatorPicker::UpdatePickerLocators()
+{
+  if (this->PickerLocatorsUpdateTime == this->LocatorCache->GetMTime())
+  {
+    // The cache may be shared with other pickers, only re-register locators if the cache content has changed
+    return;
+  }
+  this->RemoveAllLocators();
+  int numberOfLocators = this->LocatorCache->GetNumberOfLocators();
+  for (int locatorIndex = 0; locatorIndex < numberOfLocators; locatorIndex++)
+  {
+    this->AddLocator(this->LocatorCache->GetNthLocator(locatorIndex));
+  }
+  this->PickerLocatorsUpdateTime = this->LocatorCache->GetMTime();
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLCellLocatorPicker::Pick(double selectionX, double selectionY, double selectionZ, vtkRenderer* renderer)
+{
+  this->UpdateLocators(renderer);
+  return this->Superclass::Pick(selectionX, selectionY, selectionZ, renderer);
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLCellLocatorPicker::Pick3DPoint(double selectionPt[3], vtkRenderer* renderer)
+{
+  this->UpdateLocators(renderer);
+  return this->Superclass::Pick3DPoint(selectionPt, renderer);
+}
@@ -0,0 +1,98 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkMRMLCellLocatorPicker_h
+#define __vtkMRMLCellLocatorPicker_h
+
+// MRMLDisplayableManager includes
+#include "vtkMRMLDisplayableManagerExport.h"
+
+// VTK includes
+#include <vtkCellPicker.h>
+#include <vtkSmartPointer.h>
+
+class vtkMRMLCellLocatorCache;
+
+/// \brief Cell picker that uses cached cell locators for large meshes.
+///
+/// vtkCellPicker tests every cell of a picked mesh unless a locator is registered for the mesh.
+/// Before each pick, this picker updates its locator cache (see vtkMRMLCellLocatorCache), which
+/// contains a vtkStaticCellLocator for each visible and pickable actor whose input has at least
+/// MinimumNumberOfCells cells, and registers the cached locators in the picker.
+/// Locators are kept between picks and they are only rebuilt when the modification time of the mesh
+/// changes (for example, because the mesh is edited or the display transform changes).
+/// Building a locator is multi-threaded. Transforms applied to actors (actor matrix) do not require
+/// rebuilding, as the picker intersects the actor with the ray in the coordinate system of the mesh.
+///
+/// Locators of meshes that are no longer displayed are released at the next pick.
+/// Pickers that pick in the same renderer can share the same locator cache (see SetLocatorCache)
+/// so that locators are only built once.
+class VTK_MRML_DISPLAYABLEMANAGER_EXPORT vtkMRMLCellLocatorPicker : public vtkCellPicker
+{
+public:
+  static vtkMRMLCellLocatorPicker* New();
+  vtkTypeMacro(vtkMRMLCellLocatorPicker, vtkCellPicker);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Locator cache used by this picker. Each picker creates its own cache by default.
+  /// Set the cache of another picker to share locators between pickers of the same renderer.
+  vtkMRMLCellLocatorCache* GetLocatorCache();
+  void SetLocatorCache(vtkMRMLCellLocatorCache* locatorCache);
+
+  /// Meshes that have less cells than this are picked without a locator,
+  /// because building the locator would take longer than picking all the cells. Default is 10000.
+  /// The value is stored in the locator cache.
+  void SetMinimumNumberOfCells(vtkIdType minimumNumberOfCells);
+  vtkIdType GetMinimumNumberOfCells();
+
+  /// Number of cached locators.
+  int GetNumberOfCachedLocators();
+
+  /// Number of times a locator has been built in the locator cache.
+  /// Can be used for checking that locators are reused.
+  int GetNumberOfLocatorBuilds();
+
+  /// Remove all cached locators.
+  void ClearLocatorCache();
+
+  /// Update cached locators then pick.
+  using vtkCellPicker::Pick;
+  using vtkCellPicker::Pick3DPoint;
+  int Pick(double selectionX, double selectionY, double selectionZ, vtkRenderer* renderer) override;
+  int Pick3DPoint(double selectionPt[3], vtkRenderer* renderer) override;
+
+  /// Create or rebuild the locators of the meshes that are displayed in the renderer.
+  /// It is called automatically before picking.
+  void UpdateLocators(vtkRenderer* renderer);
+
+protected:
+  vtkMRMLCellLocatorPicker();
+  ~vtkMRMLCellLocatorPicker() override;
+
+  /// Register the locators of the cache in the picker if the cache has changed.
+  void UpdatePickerLocators();
+
+  vtkSmartPointer<vtkMRMLCellLocatorCache> LocatorCache;
+  /// Modification time of the locator cache when its locators were registered in the picker
+  vtkMTimeType PickerLocatorsUpdateTime{ 0 };
+
+private:
+  vtkMRMLCellLocatorPicker(const vtkMRMLCellLocatorPicker&) = delete;
+  void operator=(const vtkMRMLCellLocatorPicker&) = delete;
+};
+
+#endif
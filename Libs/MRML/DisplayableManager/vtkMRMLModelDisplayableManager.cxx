@@ -9,6 +9,7 @@
 
 // MRMLDisplayableManager includes
 #include "vtkMRMLModelDisplayableManager.h"
+#include "vtkMRMLCellLocatorPicker.h"
 #include "vtkMRMLThreeDViewInteractorStyle.h"
 #include "vtkMRMLApplicationLogic.h"
 
@@ -67,6 +68,7 @@
 #include <vtkProperty.h>
 #include <vtkRenderWindowInteractor.h>
 #include <vtkSmartPointer.h>
+#include <vtkTableBasedClipDataSet.h>
 #include <vtkTexture.h>
 #include <vtkTransform.h>
 #include <vtkTransformFilter.h>
@@ -100,6 +102,19 @@ public:
   /// Find first picked node from prop3Ds in cell picker and set PickedNodeID in Internal
   void FindFirstPickedDisplayNodeFromPickerProp3Ds();
 
+  /// Get the clip function of a display node, updated from the clip node function and the
+  /// linear transform of the mesh. The function object is reused and it is only modified if
+  /// the clip node function or the transform changes. This way clipping filters are not
+  /// re-executed when the pipeline is updated because of display property changes.
+  vtkImplicitBoolean* UpdateClipFunction(const std::string& displayNodeID,
+    vtkImplicitFunction* clipNodeFunction, vtkMRMLTransformNode* linearTransformNode);
+
+  struct ClipFunctionInfo
+  {
+    vtkSmartPointer<vtkImplicitBoolean> Function;
+    vtkSmartPointer<vtkTransform> MeshToWorldTransform;
+  };
+
 public:
   vtkMRMLModelDisplayableManager* External;
 
@@ -111,10 +126,12 @@ public:
   std::map<std::string, vtkSmartPointer<vtkTransformFilter>>    DisplayNodeTransformFilters;
   std::map<std::string, vtkSmartPointer<vtkAlgorithm>>          Clippers;
   std::map<std::string, vtkSmartPointer<vtkCapPolyData>>        Cappers;
+  std::map<std::string, ClipFunctionInfo>                       ClipFunctions;
   std::map<std::string, vtkSmartPointer<vtkProp3D>>             DisplayedCapActors;
   std::map<std::string, vtkSmartPointer<vtkTransformFilter>>    DisplayNodeCapTransformFilters;
 
   bool IsUpdatingModelsFromMRML;
+  bool ParallelClipping;
 
   vtkSmartPointer<vtkWorldPointPicker> WorldPointPicker;
   vtkSmartPointer<vtkPropPicker>       PropPicker;
@@ -142,12 +159,14 @@ vtkMRMLModelDisplayableManager::vtkInternal::vtkInternal(vtkMRMLModelDisplayable
   // Instantiate and initialize Pickers
   this->WorldPointPicker = vtkSmartPointer<vtkWorldPointPicker>::New();
   this->PropPicker = vtkSmartPointer<vtkPropPicker>::New();
-  this->CellPicker = vtkSmartPointer<vtkCellPicker>::New();
+  // Use cached cell locators to make picking of large meshes fast
+  this->CellPicker = vtkSmartPointer<vtkMRMLCellLocatorPicker>::New();
   this->CellPicker->SetTolerance(0.00001);
   this->PointPicker = vtkSmartPointer<vtkPointPicker>::New();
   this->ResetPick();
 
   this->IsUpdatingModelsFromMRML = false;
+  this->ParallelClipping = false;
 }
 
 //---------------------------------------------------------------------------
@@ -165,6 +184,63 @@ void vtkMRMLModelDisplayableManager::vtkInternal::ResetPick()
   this->PickedPointID = -1;
 }
 
+//---------------------------------------------------------------------------
+vtkImplicitBoolean* vtkMRMLModelDisplayableManager::vtkInternal::UpdateClipFunction(const std::string& displayNodeID,
+  vtkImplicitFunction* clipNodeFunction, vtkMRMLTransformNode* linearTransformNode)
+{
+  ClipFunctionInfo& clipFunctionInfo = this->ClipFunctions[displayNodeID];
+  if (!clipFunctionInfo.Function)
+  {
+    clipFunctionInfo.Function = vtkSmartPointer<vtkImplicitBoolean>::New();
+  }
+  vtkImplicitBoolean* clipFunction = clipFunctionInfo.Function;
+
+  // Changes of the clip node function (such as moving a clipping plane) are detected
+  // by the clipping filters by the modification time of the function.
+  vtkImplicitFunctionCollection* functions = clipFunction->GetFunction();
+  if (functions->GetNumberOfItems() != 1 || functions->GetItemAsObject(0) != clipNodeFunction)
+  {
+    clipFunction->RemoveAllFunctions();
+    clipFunction->AddFunction(clipNodeFunction);
+  }
+
+  // The mesh is in local coordinates if the transform is linear (the transform is applied to the actor)
+  // therefore the clip function must be transformed to world coordinates.
+  if (!linearTransformNode)
+  {
+    if (clipFunction->GetTransform())
+    {
+      clipFunction->SetTransform(static_cast<vtkAbstractTransform*>(nullptr));
+    }
+    return clipFunction;
+  }
+  vtkNew<vtkMatrix4x4> meshToWorldMatrix;
+  linearTransformNode->GetMatrixTransformToWorld(meshToWorldMatrix);
+  if (!clipFunctionInfo.MeshToWorldTransform)
+  {
+    clipFunctionInfo.MeshToWorldTransform = vtkSmartPointer<vtkTransform>::New();
+  }
+  bool transformChanged = (clipFunction->GetTransform() != clipFunctionInfo.MeshToWorldTransform.GetPointer());
+  vtkMatrix4x4* cachedMatrix = clipFunctionInfo.MeshToWorldTransform->GetMatrix();
+  for (int row = 0; row < 4 && !transformChanged; ++row)
+  {
+    for (int column = 0; column < 4; ++column)
+    {
+      if (cachedMatrix->GetElement(row, column) != meshToWorldMatrix->GetElement(row, column))
+      {
+        transformChanged = true;
+        break;
+      }
+    }
+  }
+  if (transformChanged)
+  {
+    clipFunctionInfo.MeshToWorldTransform->SetMatrix(meshToWorldMatrix);
+    clipFunction->SetTransform(clipFunctionInfo.MeshToWorldTransform);
+  }
+  return clipFunction;
+}
+
 //---------------------------------------------------------------------------
 void vtkMRMLModelDisplayableManager::vtkInternal::FindPickedDisplayNodeFromMesh(vtkPointSet* mesh, double vtkNotUsed(pickedPoint)[3])
 {
@@ -316,6 +392,27 @@ void vtkMRMLModelDisplayableManager::PrintSelf(ostream& os, vtkIndent indent)
     << this->Internal->PickedRAS[1] << ", " << this->Internal->PickedRAS[2] << ")\n";
   os << indent << "PickedCellID = " << this->Internal->PickedCellID << "\n";
   os << indent << "PickedPointID = " << this->Internal->PickedPointID << "\n";
+  os << indent << "ParallelClipping = " << (this->Internal->ParallelClipping ? "true" : "false") << "\n";
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLModelDisplayableManager::SetParallelClipping(bool enable)
+{
+  if (this->Internal->ParallelClipping == enable)
+  {
+    return;
+  }
+  this->Internal->ParallelClipping = enable;
+  this->Modified();
+  // Clipping filters are replaced in the next update
+  this->SetUpdateFromMRMLRequested(true);
+  this->RequestRender();
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLModelDisplayableManager::GetParallelClipping()
+{
+  return this->Internal->ParallelClipping;
 }
 
 //---------------------------------------------------------------------------
@@ -691,6 +788,7 @@ void vtkMRMLModelDisplayableManager::ClearDisplayMaps()
   this->Internal->DisplayNodeTransformFilters.clear();
   this->Internal->Clippers.clear();
   this->Internal->Cappers.clear();
+  this->Internal->ClipFunctions.clear();
   if (this->GetRenderer())
   {
     for (auto iter = this->Internal->DisplayedCapActors.begin();
@@ -815,31 +913,22 @@ void vtkMRMLModelDisplayableManager::UpdateModelMesh(vtkMRMLDisplayableNode* dis
     vtkMRMLModelNode::MeshTypeHint meshType = modelNode ? modelNode->GetMeshType() : vtkMRMLModelNode::PolyDataMeshType;
 
     vtkAlgorithm* clipper = nullptr;
-    vtkSmartPointer<vtkImplicitBoolean> implicitBoolean;
-    if (clipping && modelDisplayNode && clipNode)
+    vtkImplicitBoolean* implicitBoolean = nullptr;
+    vtkImplicitFunction* implicitFunction = (clipping && modelDisplayNode && clipNode) ? clipNode->GetImplicitFunctionWorld() : nullptr;
+    if (implicitFunction)
     {
-      vtkImplicitFunction* implicitFunction = clipNode->GetImplicitFunctionWorld();
-      if (implicitFunction)
-      {
-        implicitBoolean = vtkSmartPointer<vtkImplicitBoolean>::New();
-        implicitBoolean->AddFunction(implicitFunction);
-
-        vtkSmartPointer<vtkAlgorithm> oldClipper = nullptr;
-        if (this->Internal->Clippers.find(modelDisplayNode->GetID()) != this->Internal->Clippers.end())
-        {
-          oldClipper = this->Internal->Clippers[modelDisplayNode->GetID()];
-        }
-        clipper = this->GetClipper(modelDisplayNode, meshType, implicitBoolean, clipNode->GetClippingMethod());
-        filterUpdateNeeded = oldClipper != clipper;
-      }
+      // If the transform is non-linear then the mesh is transformed to world coordinates
+      // by the transform filter, otherwise the clip function is transformed to the mesh coordinate system.
+      implicitBoolean = this->Internal->UpdateClipFunction(modelDisplayNode->GetID(), implicitFunction,
+        hasNonLinearTransform ? nullptr : tnode);
 
-      if (tnode && !hasNonLinearTransform)
+      vtkSmartPointer<vtkAlgorithm> oldClipper = nullptr;
+      if (this->Internal->Clippers.find(modelDisplayNode->GetID()) != this->Internal->Clippers.end())
       {
-        // If the transform is non-linear, worldTransform will have already been set.
-        // Only need to calculate here for linear transforms.
-        tnode->GetTransformToWorld(worldTransform);
-        implicitBoolean->SetTransform(worldTransform);
+        oldClipper = this->Internal->Clippers[modelDisplayNode->GetID()];
       }
+      clipper = this->GetClipper(modelDisplayNode, meshType, implicitBoolean, clipNode->GetClippingMethod());
+      filterUpdateNeeded = oldClipper != clipper;
     }
 
     // create TransformFilter for non-linear transform
@@ -896,13 +985,22 @@ void vtkMRMLModelDisplayableManager::UpdateModelMesh(vtkMRMLDisplayableNode* dis
         if (actor && actor->GetMapper())
         {
           vtkMapper* mapper = actor->GetMapper();
-          if (transformFilter)
+          vtkAlgorithmOutput* inputConnection = transformFilter ? transformFilter->GetOutputPort() : meshConnection;
+          if (clipper && !filterUpdateNeeded)
           {
-            mapper->SetInputConnection(transformFilter->GetOutputPort());
+            // Reconnecting the same input does not modify the filters, therefore
+            // the cached clipping result is reused if the mesh has not changed.
+            clipper->SetInputConnection(inputConnection);
+            auto capIter = this->Internal->Cappers.find(displayNode->GetID());
+            if (capIter != this->Internal->Cappers.end())
+            {
+              capIter->second->SetInputConnection(inputConnection);
+            }
+            mapper->SetInputConnection(clipper->GetOutputPort());
           }
-          else if (mapper && !clipping)
+          else if (!clipping)
           {
-            mapper->SetInputConnection(meshConnection);
+            mapper->SetInputConnection(inputConnection);
           }
           if ((meshType == vtkMRMLModelNode::UnstructuredGridMeshType && mapper->IsA("vtkDataSetMapper"))
             || (meshType == vtkMRMLModelNode::PolyDataMeshType && mapper->IsA("vtkPolyDataMapper")))
@@ -911,8 +1009,9 @@ void vtkMRMLModelDisplayableManager::UpdateModelMesh(vtkMRMLDisplayableNode* dis
           }
         }
 
-        vtkMRMLTransformNode* tnode = displayableNode->GetParentTransformNode();
-        if ((!clipping || tnode == nullptr) && !mapperUpdateNeeded && !filterUpdateNeeded)
+        // The clip function is updated in-place, therefore the pipeline does not have to be rebuilt
+        // when only the transform or the clip node has changed.
+        if (!mapperUpdateNeeded && !filterUpdateNeeded)
         {
           continue;
         }
@@ -1105,23 +1204,16 @@ void vtkMRMLModelDisplayableManager::RemoveModelProps()
     }
     else
     {
-      int clipModel = 0;
-      if (modelDisplayNode != nullptr)
-      {
-        clipModel = modelDisplayNode->GetClipping();
-      }
       auto clipIter = this->Internal->DisplayedClipState.find(iter->first);
       if (clipIter == this->Internal->DisplayedClipState.end())
       {
         vtkErrorMacro("vtkMRMLModelDisplayableManager::RemoveModelProps() Unknown clip state\n");
       }
-      else
+      else if (clipIter->second && !modelDisplayNode->GetClipping())
       {
-
-        if (clipIter->second || (modelDisplayNode->GetClipping() && clipIter->second != clipModel))
-        {
-          removedIDs.push_back(iter->first);
-        }
+        // Clipped actors are kept (and so the clipping results are reused) as long as clipping is enabled.
+        // Changes in the clip node, transform, or mesh are applied by UpdateModelMesh.
+        removedIDs.push_back(iter->first);
       }
     }
   }
@@ -1197,6 +1289,12 @@ void vtkMRMLModelDisplayableManager::RemoveDisplayedID(const std::string& id)
     this->Internal->Cappers.erase(capIter);
   }
 
+  auto clipFunctionIter = this->Internal->ClipFunctions.find(id);
+  if (clipFunctionIter != this->Internal->ClipFunctions.end())
+  {
+    this->Internal->ClipFunctions.erase(clipFunctionIter);
+  }
+
   auto capActorIter = this->Internal->DisplayedCapActors.find(id);
   if (capActorIter != this->Internal->DisplayedCapActors.end())
   {
@@ -1942,7 +2040,17 @@ vtkAlgorithm* vtkMRMLModelDisplayableManager::GetClipper(
 
   if (type == vtkMRMLModelNode::UnstructuredGridMeshType)
   {
-    if (clippingMethod == vtkMRMLClipNode::Straight)
+    if (clippingMethod == vtkMRMLClipNode::Straight && this->Internal->ParallelClipping)
+    {
+      vtkSmartPointer<vtkTableBasedClipDataSet> tableBasedClipDataSet = vtkTableBasedClipDataSet::SafeDownCast(clipper);
+      if (!tableBasedClipDataSet)
+      {
+        tableBasedClipDataSet = vtkSmartPointer<vtkTableBasedClipDataSet>::New();
+        clipper = tableBasedClipDataSet;
+      }
+      tableBasedClipDataSet->SetClipFunction(clipFunction);
+    }
+    else if (clippingMethod == vtkMRMLClipNode::Straight)
     {
       vtkSmartPointer<vtkClipDataSet> clipDataSet = vtkClipDataSet::SafeDownCast(clipper);
       if (!clipDataSet)
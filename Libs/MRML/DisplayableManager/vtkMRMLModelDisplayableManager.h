@@ -112,6 +112,14 @@ public:
   ///   False otherwise.
   static bool IsCellScalarsActive(vtkMRMLDisplayNode* displayNode, vtkMRMLModelNode* model = nullptr);
 
+  /// Use a multi-threaded filter (vtkTableBasedClipDataSet) for straight clipping of
+  /// unstructured grid models. It is faster for large volumetric meshes but the clipped mesh
+  /// may have different cell ordering and point merging than with vtkClipDataSet.
+  /// Surface models are always clipped with vtkClipPolyData. Disabled by default.
+  void SetParallelClipping(bool enable);
+  bool GetParallelClipping();
+  vtkBooleanMacro(ParallelClipping, bool);
+
 protected:
   int ActiveInteractionModes() override;
 
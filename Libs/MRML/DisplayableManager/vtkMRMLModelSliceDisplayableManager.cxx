@@ -18,6 +18,7 @@
 // MRMLDisplayableManager includes
 #include "vtkMRMLModelSliceDisplayableManager.h"
 #include "vtkMRMLModelDisplayableManager.h"
+#include "vtkMRMLPolyDataPlaneCutter.h"
 
 // MRML includes
 #include <vtkMRMLApplicationLogic.h>
@@ -59,7 +60,6 @@
 
 // VTK includes: customization
 #include <vtkGeometryFilter.h>
-#include <vtkPlaneCutter.h>
 #include <vtkSampleImplicitFunctionFilter.h>
 
 // STD includes
@@ -83,7 +83,7 @@ public:
     vtkSmartPointer<vtkDataSetSurfaceFilter> SurfaceExtractor;
     vtkSmartPointer<vtkTransformFilter> ModelWarper;
     vtkSmartPointer<vtkPlane> Plane;
-    vtkSmartPointer<vtkPlaneCutter> Cutter;
+    vtkSmartPointer<vtkMRMLPolyDataPlaneCutter> Cutter;
     vtkSmartPointer<vtkGeometryFilter> GeometryFilter;
     vtkSmartPointer<vtkSampleImplicitFunctionFilter> SliceDistance;
     vtkSmartPointer<vtkProp> Actor;
@@ -310,7 +310,7 @@ void vtkMRMLModelSliceDisplayableManager::vtkInternal
   // Create pipeline
   Pipeline* pipeline = new Pipeline();
   pipeline->Actor = actor.GetPointer();
-  pipeline->Cutter = vtkSmartPointer<vtkPlaneCutter>::New();
+  pipeline->Cutter = vtkSmartPointer<vtkMRMLPolyDataPlaneCutter>::New();
   pipeline->GeometryFilter = vtkSmartPointer<vtkGeometryFilter>::New();
   pipeline->SliceDistance = vtkSmartPointer<vtkSampleImplicitFunctionFilter>::New();
   pipeline->TransformToSlice = vtkSmartPointer<vtkTransform>::New();
@@ -323,8 +323,9 @@ void vtkMRMLModelSliceDisplayableManager::vtkInternal
   // Set up pipeline
   pipeline->Transformer->SetTransform(pipeline->TransformToSlice);
   pipeline->Transformer->SetInputConnection(pipeline->GeometryFilter->GetOutputPort());
+  // The cutter indexes the mesh cells along the slice normal, so that when only the slice offset changes
+  // (scrolling through slices) the mesh does not have to be processed again.
   pipeline->Cutter->SetPlane(pipeline->Plane);
-  pipeline->Cutter->BuildTreeOff(); // the cutter crashes for complex geometries if build tree is enabled
   pipeline->Cutter->SetInputConnection(pipeline->ModelWarper->GetOutputPort());
   pipeline->GeometryFilter->SetInputConnection(pipeline->Cutter->GetOutputPort());
   // Projection is created from outer surface of volumetric meshes (for polydata surface
@@ -436,7 +437,12 @@ void vtkMRMLModelSliceDisplayableManager::vtkInternal
     return;
   }
 
-  pipeline->ModelWarper->SetInputData(pointSet); //why here? +connection?
+  // Only set the input if it has changed, because setting the input data would re-execute
+  // the transform filter and the cutter would have to re-index the mesh.
+  if (pipeline->ModelWarper->GetInput() != pointSet)
+  {
+    pipeline->ModelWarper->SetInputData(pointSet);
+  }
   pipeline->ModelWarper->SetTransform(pipeline->NodeToWorld);
 
   // Set Plane Transform
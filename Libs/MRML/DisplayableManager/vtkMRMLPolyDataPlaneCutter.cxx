@@ -0,0 +1,459 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRMLDisplayableManager includes
+#include "vtkMRMLPolyDataPlaneCutter.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkGeometryFilter.h>
+#include <vtkIdList.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPlane.h>
+#include <vtkPlaneCutter.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+vtkStandardNewMacro(vtkMRMLPolyDataPlaneCutter);
+vtkCxxSetObjectMacro(vtkMRMLPolyDataPlaneCutter, Plane, vtkPlane);
+
+namespace
+{
+/// Number of consecutive cells in the index that share a maximum value.
+/// Blocks that are completely below the plane are skipped without visiting their cells.
+const int CELL_BLOCK_SIZE = 64;
+
+//----------------------------------------------------------------------------
+/// Compute projection of each point onto the plane normal.
+struct ProjectPointsWorker
+{
+  vtkPoints* Points;
+  const double* Normal;
+  std::vector<double>& PointProjections;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    double point[3];
+    for (vtkIdType pointId = begin; pointId < end; ++pointId)
+    {
+      this->Points->GetPoint(pointId, point);
+      this->PointProjections[pointId] = vtkMath::Dot(point, this->Normal);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+/// Compute the interval that each cell spans along the plane normal.
+struct CellRangeWorker
+{
+  vtkCellArray* Polys;
+  const std::vector<double>& PointProjections;
+  std::vector<double>& CellMinimum;
+  std::vector<double>& CellMaximum;
+  vtkSMPThreadLocalObject<vtkIdList> CellPointIds;
+
+  CellRangeWorker(vtkCellArray* polys, const std::vector<double>& pointProjections,
+    std::vector<double>& cellMinimum, std::vector<double>& cellMaximum)
+    : Polys(polys)
+    , PointProjections(pointProjections)
+    , CellMinimum(cellMinimum)
+    , CellMaximum(cellMaximum)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList* cellPointIds = this->CellPointIds.Local();
+    vtkIdType numberOfCellPoints = 0;
+    const vtkIdType* pointIds = nullptr;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      this->Polys->GetCellAtId(cellId, numberOfCellPoints, pointIds, cellPointIds);
+      double minimum = VTK_DOUBLE_MAX;
+      double maximum = VTK_DOUBLE_MIN;
+      for (vtkIdType i = 0; i < numberOfCellPoints; ++i)
+      {
+        double projection = this->PointProjections[pointIds[i]];
+        minimum = std::min(minimum, projection);
+        maximum = std::max(maximum, projection);
+      }
+      this->CellMinimum[cellId] = minimum;
+      this->CellMaximum[cellId] = maximum;
+    }
+  }
+};
+
+} // namespace
+
+//----------------------------------------------------------------------------
+class vtkMRMLPolyDataPlaneCutter::vtkInternal
+{
+public:
+  /// Returns true if the input can be cut using the cell index.
+  static bool CanUseIndex(vtkDataObject* input, vtkPlane* plane);
+
+  /// Returns true if the index was built for this input and normal.
+  bool IsIndexValid(vtkPolyData* input, const double normal[3]);
+
+  void BuildIndex(vtkPolyData* input, const double normal[3]);
+  void ClearIndex();
+
+  /// Cut the indexed input with the plane at the specified offset along the normal.
+  void Cut(vtkPolyData* input, double planeOffset, vtkPolyData* output);
+
+  // Key of the index
+  vtkPolyData* IndexedInput{ nullptr };
+  vtkMTimeType IndexedInputMTime{ 0 };
+  double IndexedNormal[3]{ 0.0, 0.0, 0.0 };
+
+  /// Projection of each point onto the plane normal
+  std::vector<double> PointProjections;
+  /// Cell IDs, ordered by the minimum of the projection of cell points
+  std::vector<vtkIdType> SortedCellIds;
+  /// Minimum and maximum projection of each cell, in the order of SortedCellIds
+  std::vector<double> SortedCellMinimum;
+  std::vector<double> SortedCellMaximum;
+  /// Maximum of SortedCellMaximum within each block of CELL_BLOCK_SIZE cells
+  std::vector<double> BlockMaximum;
+
+  // Used for cutting non-polygonal inputs
+  vtkSmartPointer<vtkPlaneCutter> PlaneCutter;
+  vtkSmartPointer<vtkGeometryFilter> GeometryFilter;
+};
+
+//----------------------------------------------------------------------------
+bool vtkMRMLPolyDataPlaneCutter::vtkInternal::CanUseIndex(vtkDataObject* input, vtkPlane* plane)
+{
+  vtkPolyData* polyData = vtkPolyData::SafeDownCast(input);
+  if (!polyData || !plane || plane->GetTransform())
+  {
+    return false;
+  }
+  // Cell IDs of polygons are only the same as cell IDs of the mesh if there are no other cells
+  return polyData->GetNumberOfVerts() == 0
+    && polyData->GetNumberOfLines() == 0
+    && polyData->GetNumberOfStrips() == 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLPolyDataPlaneCutter::vtkInternal::IsIndexValid(vtkPolyData* input, const double normal[3])
+{
+  const double tolerance = 1e-12;
+  return this->IndexedInput == input
+    && this->IndexedInputMTime == input->GetMTime()
+    && std::fabs(this->IndexedNormal[0] - normal[0]) < tolerance
+    && std::fabs(this->IndexedNormal[1] - normal[1]) < tolerance
+    && std::fabs(this->IndexedNormal[2] - normal[2]) < tolerance;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLPolyDataPlaneCutter::vtkInternal::BuildIndex(vtkPolyData* input, const double normal[3])
+{
+  this->IndexedInput = input;
+  this->IndexedInputMTime = input->GetMTime();
+  this->IndexedNormal[0] = normal[0];
+  this->IndexedNormal[1] = normal[1];
+  this->IndexedNormal[2] = normal[2];
+
+  vtkIdType numberOfPoints = input->GetNumberOfPoints();
+  this->PointProjections.resize(numberOfPoints);
+  ProjectPointsWorker projectPointsWorker{ input->GetPoints(), this->IndexedNormal, this->PointProjections };
+  vtkSMPTools::For(0, numberOfPoints, projectPointsWorker);
+
+  vtkCellArray* polys = input->GetPolys();
+  vtkIdType numberOfCells = polys->GetNumberOfCells();
+  std::vector<double> cellMinimum(numberOfCells);
+  std::vector<double> cellMaximum(numberOfCells);
+  CellRangeWorker cellRangeWorker(polys, this->PointProjections, cellMinimum, cellMaximum);
+  vtkSMPTools::For(0, numberOfCells, cellRangeWorker);
+
+  this->SortedCellIds.resize(numberOfCells);
+  std::iota(this->SortedCellIds.begin(), this->SortedCellIds.end(), 0);
+  vtkSMPTools::Sort(this->SortedCellIds.begin(), this->SortedCellIds.end(),
+    [&cellMinimum](vtkIdType a, vtkIdType b) { return cellMinimum[a] < cellMinimum[b]; });
+
+  this->SortedCellMinimum.resize(numberOfCells);
+  this->SortedCellMaximum.resize(numberOfCells);
+  this->BlockMaximum.assign((numberOfCells + CELL_BLOCK_SIZE - 1) / CELL_BLOCK_SIZE, VTK_DOUBLE_MIN);
+  for (vtkIdType i = 0; i < numberOfCells; ++i)
+  {
+    vtkIdType cellId = this->SortedCellIds[i];
+    this->SortedCellMinimum[i] = cellMinimum[cellId];
+    this->SortedCellMaximum[i] = cellMaximum[cellId];
+    double& blockMaximum = this->BlockMaximum[i / CELL_BLOCK_SIZE];
+    blockMaximum = std::max(blockMaximum, cellMaximum[cellId]);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLPolyDataPlaneCutter::vtkInternal::ClearIndex()
+{
+  this->IndexedInput = nullptr;
+  this->IndexedInputMTime = 0;
+  this->PointProjections.clear();
+  this->SortedCellIds.clear();
+  this->SortedCellMinimum.clear();
+  this->SortedCellMaximum.clear();
+  this->BlockMaximum.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLPolyDataPlaneCutter::vtkInternal::Cut(vtkPolyData* input, double planeOffset, vtkPolyData* output)
+{
+  vtkPoints* inputPoints = input->GetPoints();
+  vtkCellArray* polys = input->GetPolys();
+  vtkPointData* inputPointData = input->GetPointData();
+  vtkCellData* inputCellData = input->GetCellData();
+
+  // Only cells with minimum below the plane may intersect it
+  vtkIdType numberOfCandidateCells = static_cast<vtkIdType>(
+    std::upper_bound(this->SortedCellMinimum.begin(), this->SortedCellMinimum.end(), planeOffset)
+    - this->SortedCellMinimum.begin());
+
+  vtkNew<vtkPoints> outputPoints;
+  outputPoints->SetDataType(inputPoints->GetDataType());
+  vtkNew<vtkCellArray> outputLines;
+  vtkPointData* outputPointData = output->GetPointData();
+  vtkCellData* outputCellData = output->GetCellData();
+  outputPointData->InterpolateAllocate(inputPointData);
+  outputCellData->CopyAllocate(inputCellData);
+
+  // Intersection points on edges, shared by neighbor cells
+  std::map<std::pair<vtkIdType, vtkIdType>, vtkIdType> edgePointIds;
+  std::vector<vtkIdType> cellIntersectionPointIds;
+  vtkNew<vtkIdList> cellPointIdList;
+  vtkIdType numberOfCellPoints = 0;
+  const vtkIdType* cellPointIds = nullptr;
+  double point0[3];
+  double point1[3];
+  double intersectionPoint[3];
+
+  vtkIdType numberOfCandidateBlocks = (numberOfCandidateCells + CELL_BLOCK_SIZE - 1) / CELL_BLOCK_SIZE;
+  for (vtkIdType blockIndex = 0; blockIndex < numberOfCandidateBlocks; ++blockIndex)
+  {
+    if (this->BlockMaximum[blockIndex] < planeOffset)
+    {
+      // all cells of this block are below the plane
+      continue;
+    }
+    vtkIdType blockEnd = std::min((blockIndex + 1) * CELL_BLOCK_SIZE, numberOfCandidateCells);
+    for (vtkIdType sortedIndex = blockIndex * CELL_BLOCK_SIZE; sortedIndex < blockEnd; ++sortedIndex)
+    {
+      if (this->SortedCellMaximum[sortedIndex] < planeOffset)
+      {
+        continue;
+      }
+      vtkIdType cellId = this->SortedCellIds[sortedIndex];
+      polys->GetCellAtId(cellId, numberOfCellPoints, cellPointIds, cellPointIdList);
+
+      // Find intersection points on the cell edges (in the order of edges)
+      cellIntersectionPointIds.clear();
+      for (vtkIdType i = 0; i < numberOfCellPoints; ++i)
+      {
+        vtkIdType pointId0 = cellPointIds[i];
+        vtkIdType pointId1 = cellPointIds[(i + 1) % numberOfCellPoints];
+        // Order the edge points so that the same interpolated point is computed for neighbor cells
+        if (pointId0 > pointId1)
+        {
+          std::swap(pointId0, pointId1);
+        }
+        double distance0 = this->PointProjections[pointId0] - planeOffset;
+        double distance1 = this->PointProjections[pointId1] - planeOffset;
+        if ((distance0 < 0.0) == (distance1 < 0.0))
+        {
+          // edge does not cross the plane
+          continue;
+        }
+        std::pair<vtkIdType, vtkIdType> edge(pointId0, pointId1);
+        auto edgePointIt = edgePointIds.find(edge);
+        if (edgePointIt != edgePointIds.end())
+        {
+          cellIntersectionPointIds.push_back(edgePointIt->second);
+          continue;
+        }
+        double t = distance0 / (distance0 - distance1);
+        inputPoints->GetPoint(pointId0, point0);
+        inputPoints->GetPoint(pointId1, point1);
+        for (int axis = 0; axis < 3; ++axis)
+        {
+          intersectionPoint[axis] = point0[axis] + t * (point1[axis] - point0[axis]);
+        }
+        vtkIdType intersectionPointId = outputPoints->InsertNextPoint(intersectionPoint);
+        outputPointData->InterpolateEdge(inputPointData, intersectionPointId, pointId0, pointId1, t);
+        edgePointIds[edge] = intersectionPointId;
+        cellIntersectionPointIds.push_back(intersectionPointId);
+      }
+
+      size_t numberOfIntersectionPoints = cellIntersectionPointIds.size();
+      if (numberOfIntersectionPoints < 2)
+      {
+        continue;
+      }
+      if (numberOfIntersectionPoints > 2)
+      {
+        // Non-triangular polygon that crosses the plane multiple times. Order the points along the
+        // intersection line so that pairs of consecutive points delimit the segments inside the polygon.
+        double lineStart[3];
+        double lineDirection[3];
+        outputPoints->GetPoint(cellIntersectionPointIds[0], lineStart);
+        outputPoints->GetPoint(cellIntersectionPointIds[1], lineDirection);
+        vtkMath::Subtract(lineDirection, lineStart, lineDirection);
+        std::vector<std::pair<double, vtkIdType>> pointPositions;
+        for (vtkIdType intersectionPointId : cellIntersectionPointIds)
+        {
+          double position[3];
+          outputPoints->GetPoint(intersectionPointId, position);
+          vtkMath::Subtract(position, lineStart, position);
+          pointPositions.emplace_back(vtkMath::Dot(position, lineDirection), intersectionPointId);
+        }
+        std::sort(pointPositions.begin(), pointPositions.end());
+        for (size_t i = 0; i < numberOfIntersectionPoints; ++i)
+        {
+          cellIntersectionPointIds[i] = pointPositions[i].second;
+        }
+      }
+      for (size_t i = 0; i + 1 < numberOfIntersectionPoints; i += 2)
+      {
+        vtkIdType linePointIds[2] = { cellIntersectionPointIds[i], cellIntersectionPointIds[i + 1] };
+        vtkIdType lineId = outputLines->InsertNextCell(2, linePointIds);
+        outputCellData->CopyData(inputCellData, cellId, lineId);
+      }
+    }
+  }
+
+  outputPoints->Squeeze();
+  outputLines->Squeeze();
+  outputPointData->Squeeze();
+  outputCellData->Squeeze();
+  output->SetPoints(outputPoints);
+  output->SetLines(outputLines);
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLPolyDataPlaneCutter::vtkMRMLPolyDataPlaneCutter()
+{
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLPolyDataPlaneCutter::~vtkMRMLPolyDataPlaneCutter()
+{
+  this->SetPlane(nullptr);
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLPolyDataPlaneCutter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Plane: " << this->Plane << "\n";
+  os << indent << "NumberOfIndexBuilds: " << this->NumberOfIndexBuilds << "\n";
+  os << indent << "NumberOfIndexedCells: " << this->Internal->SortedCellIds.size() << "\n";
+}
+
+//----------------------------------------------------------------------------
+vtkMTimeType vtkMRMLPolyDataPlaneCutter::GetMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetMTime();
+  if (this->Plane)
+  {
+    mTime = std::max(mTime, this->Plane->GetMTime());
+  }
+  return mTime;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLPolyDataPlaneCutter::FillInputPortInformation(int vtkNotUsed(port), vtkInformation* info)
+{
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkDataSet");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLPolyDataPlaneCutter::RequestData(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkDataSet* input = vtkDataSet::GetData(inputVector[0], 0);
+  vtkPolyData* output = vtkPolyData::GetData(outputVector, 0);
+  if (!input || !output)
+  {
+    vtkErrorMacro("RequestData failed: invalid input or output");
+    return 0;
+  }
+  if (!this->Plane)
+  {
+    vtkErrorMacro("RequestData failed: plane is not set");
+    return 0;
+  }
+  if (input->GetNumberOfPoints() == 0 || input->GetNumberOfCells() == 0)
+  {
+    return 1;
+  }
+
+  if (!vtkInternal::CanUseIndex(input, this->Plane))
+  {
+    this->Internal->ClearIndex();
+    if (!this->Internal->PlaneCutter)
+    {
+      this->Internal->PlaneCutter = vtkSmartPointer<vtkPlaneCutter>::New();
+      this->Internal->PlaneCutter->BuildTreeOff(); // the cutter crashes for complex geometries if build tree is enabled
+      this->Internal->GeometryFilter = vtkSmartPointer<vtkGeometryFilter>::New();
+      this->Internal->GeometryFilter->SetInputConnection(this->Internal->PlaneCutter->GetOutputPort());
+    }
+    this->Internal->PlaneCutter->SetPlane(this->Plane);
+    this->Internal->PlaneCutter->SetInputData(input);
+    this->Internal->GeometryFilter->Update();
+    output->ShallowCopy(this->Internal->GeometryFilter->GetOutput());
+    // Do not keep a reference to the input
+    this->Internal->PlaneCutter->SetInputData(nullptr);
+    return 1;
+  }
+
+  vtkPolyData* polyData = vtkPolyData::SafeDownCast(input);
+  double normal[3];
+  this->Plane->GetNormal(normal);
+  if (vtkMath::Normalize(normal) == 0.0)
+  {
+    vtkErrorMacro("RequestData failed: invalid plane normal");
+    return 0;
+  }
+  if (!this->Internal->IsIndexValid(polyData, normal))
+  {
+    this->Internal->BuildIndex(polyData, normal);
+    this->NumberOfIndexBuilds++;
+  }
+  double planeOffset = vtkMath::Dot(this->Plane->GetOrigin(), normal);
+  this->Internal->Cut(polyData, planeOffset, output);
+  return 1;
+}
@@ -0,0 +1,79 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkMRMLPolyDataPlaneCutter_h
+#define __vtkMRMLPolyDataPlaneCutter_h
+
+// MRMLDisplayableManager includes
+#include "vtkMRMLDisplayableManagerExport.h"
+
+// VTK includes
+#include <vtkPolyDataAlgorithm.h>
+
+class vtkPlane;
+
+/// \brief Cut a surface mesh with a plane, using a cached index of the cells.
+///
+/// The filter computes the intersection lines of polygons of the input with the plane.
+/// Cells are indexed by the interval that they span along the plane normal. The index is built
+/// when the input mesh or the plane normal changes, and it is reused when only the plane
+/// position changes (for example, when scrolling through slices). Only the cells that straddle
+/// the plane are visited when cutting. Building of the index is parallelized.
+///
+/// Point data is interpolated and cell data is copied from the cut polygons to the output lines.
+///
+/// Inputs that are not polygonal meshes (for example, unstructured grids or polydata
+/// containing lines or triangle strips) and planes that have a transform are cut
+/// using vtkPlaneCutter.
+class VTK_MRML_DISPLAYABLEMANAGER_EXPORT vtkMRMLPolyDataPlaneCutter : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkMRMLPolyDataPlaneCutter* New();
+  vtkTypeMacro(vtkMRMLPolyDataPlaneCutter, vtkPolyDataAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Plane that the input is cut with.
+  virtual void SetPlane(vtkPlane* plane);
+  vtkGetObjectMacro(Plane, vtkPlane);
+
+  /// Returns the number of times the cell index has been built.
+  /// Can be used for checking that the index is reused.
+  vtkGetMacro(NumberOfIndexBuilds, int);
+
+  /// Modification time also depends on the plane.
+  vtkMTimeType GetMTime() override;
+
+protected:
+  vtkMRMLPolyDataPlaneCutter();
+  ~vtkMRMLPolyDataPlaneCutter() override;
+
+  int FillInputPortInformation(int port, vtkInformation* info) override;
+  int RequestData(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override;
+
+  vtkPlane* Plane{ nullptr };
+  int NumberOfIndexBuilds{ 0 };
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkMRMLPolyDataPlaneCutter(const vtkMRMLPolyDataPlaneCutter&) = delete;
+  void operator=(const vtkMRMLPolyDataPlaneCutter&) = delete;
+};
+
+#endif
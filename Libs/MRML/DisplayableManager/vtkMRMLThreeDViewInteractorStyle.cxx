@@ -16,10 +16,12 @@
 
 // MRML includes
 #include "vtkMRMLCameraDisplayableManager.h"
+#include "vtkMRMLCellLocatorPicker.h"
 #include "vtkMRMLCrosshairDisplayableManager.h"
 #include "vtkMRMLCrosshairNode.h"
 #include "vtkMRMLDisplayableManagerGroup.h"
 #include "vtkMRMLInteractionEventData.h"
+#include "vtkMRMLModelDisplayableManager.h"
 #include "vtkMRMLScene.h"
 
 // VTK includes
@@ -43,7 +45,8 @@ vtkStandardNewMacro(vtkMRMLThreeDViewInteractorStyle);
 vtkMRMLThreeDViewInteractorStyle::vtkMRMLThreeDViewInteractorStyle()
 {
   this->CameraNode = nullptr;
-  this->AccuratePicker = vtkSmartPointer<vtkCellPicker>::New();
+  // Use cached cell locators to make picking of large meshes fast
+  this->AccuratePicker = vtkSmartPointer<vtkMRMLCellLocatorPicker>::New();
   this->AccuratePicker->SetTolerance( .005 );
   this->QuickPicker = vtkSmartPointer<vtkWorldPointPicker>::New();
   this->QuickVolumePicker = vtkSmartPointer<vtkVolumePicker>::New();
@@ -87,6 +90,20 @@ void vtkMRMLThreeDViewInteractorStyle::SetDisplayableManagers(vtkMRMLDisplayable
           vtkMRMLCameraDisplayableManager::ActiveCameraChangedEvent,
           this->DisplayableManagerCallbackCommand);
   }
+
+  // Share cell locators with the picker of the model displayable manager, as both pickers
+  // pick in the same renderer. This way, locators of large meshes are only built once.
+  vtkMRMLModelDisplayableManager* modelDisplayableManager = vtkMRMLModelDisplayableManager::SafeDownCast(
+    this->DisplayableManagers->GetDisplayableManagerByClassName("vtkMRMLModelDisplayableManager"));
+  vtkMRMLCellLocatorPicker* accuratePicker = vtkMRMLCellLocatorPicker::SafeDownCast(this->AccuratePicker);
+  if (modelDisplayableManager && accuratePicker)
+  {
+    vtkMRMLCellLocatorPicker* modelCellPicker = vtkMRMLCellLocatorPicker::SafeDownCast(modelDisplayableManager->GetCellPicker());
+    if (modelCellPicker)
+    {
+      accuratePicker->SetLocatorCache(modelCellPicker->GetLocatorCache());
+    }
+  }
 }
 
 //----------------------------------------------------------------------------
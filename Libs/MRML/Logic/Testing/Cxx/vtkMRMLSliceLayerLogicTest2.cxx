@@ -0,0 +1,194 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRMLLogic includes
+#include "vtkMRMLSliceLayerLogic.h"
+
+// MRML includes
+#include "vtkMRMLChunkedVolumeStorageNode.h"
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScalarVolumeDisplayNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLSliceNode.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkImageReslice.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+// VTKSYS includes
+#include <vtksys/SystemTools.hxx>
+
+// Test that the slice layer logic reslices the region and resolution level of a chunked volume
+// that matches the field of view of the slice, when only a low-resolution preview is loaded.
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+double GetExpectedValue(int i, int j, int k)
+{
+  return i + 3 * j + 7 * k;
+}
+
+//---------------------------------------------------------------------------
+void SetSliceFieldOfView(vtkMRMLSliceNode* sliceNode, double fieldOfView, const double center[3])
+{
+  int wasModified = sliceNode->StartModify();
+  sliceNode->SetDimensions(256, 256, 1);
+  sliceNode->SetFieldOfView(fieldOfView, fieldOfView, 1.0);
+  vtkMatrix4x4* sliceToRAS = sliceNode->GetSliceToRAS();
+  sliceToRAS->Identity();
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    sliceToRAS->SetElement(axis, 3, center[axis]);
+  }
+  sliceNode->UpdateMatrices();
+  sliceNode->EndModify(wasModified);
+}
+
+//---------------------------------------------------------------------------
+int CheckExtentContains(const int* extent, const int ijk[3])
+{
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    CHECK_BOOL(extent[axis * 2] <= ijk[axis] && ijk[axis] <= extent[axis * 2 + 1], true);
+  }
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLSliceLayerLogicTest2(int argc, char* argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::string tempDir = std::string(argv[1]) + "/vtkMRMLSliceLayerLogicTest2";
+  vtksys::SystemTools::RemoveADirectory(tempDir);
+  CHECK_BOOL(vtksys::SystemTools::MakeDirectory(tempDir).IsSuccess(), true);
+
+  // Write a 70x50x9 volume as a resolution pyramid: 70x50x9, 35x25x5, 18x13x3, 9x7x2
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(70, 50, 9);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  for (int k = 0; k < 9; ++k)
+  {
+    for (int j = 0; j < 50; ++j)
+    {
+      for (int i = 0; i < 70; ++i)
+      {
+        imageData->SetScalarComponentFromDouble(i, j, k, 0, GetExpectedValue(i, j, k));
+      }
+    }
+  }
+  vtkNew<vtkMRMLScalarVolumeNode> fullResolutionVolumeNode;
+  fullResolutionVolumeNode->SetAndObserveImageData(imageData);
+  fullResolutionVolumeNode->SetOrigin(10.0, 20.0, 30.0);
+  fullResolutionVolumeNode->SetSpacing(1.0, 2.0, 3.0);
+  std::string fileName = tempDir + "/Volume.zarr";
+  vtkNew<vtkMRMLChunkedVolumeStorageNode> writerStorageNode;
+  writerStorageNode->SetChunkSize(16, 16, 4);
+  writerStorageNode->SetFileName(fileName.c_str());
+  CHECK_INT(writerStorageNode->WriteData(fullResolutionVolumeNode), 1);
+
+  // Read the preview (level 2)
+  vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLScalarVolumeNode", "Volume"));
+  vtkMRMLScalarVolumeDisplayNode* displayNode = vtkMRMLScalarVolumeDisplayNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLScalarVolumeDisplayNode"));
+  volumeNode->SetAndObserveDisplayNodeID(displayNode->GetID());
+  vtkMRMLChunkedVolumeStorageNode* storageNode = vtkMRMLChunkedVolumeStorageNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLChunkedVolumeStorageNode"));
+  storageNode->SetFileName(fileName.c_str());
+  storageNode->SetMaximumNumberOfPreviewVoxels(1000);
+  volumeNode->SetAndObserveStorageNodeID(storageNode->GetID());
+  CHECK_INT(storageNode->ReadData(volumeNode), 1);
+  CHECK_INT(storageNode->GetPreviewResolutionLevel(), 2);
+  vtkImageData* previewImageData = volumeNode->GetImageData();
+
+  vtkMRMLSliceNode* sliceNode = vtkMRMLSliceNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLSliceNode"));
+  // RAS position of voxel (30, 25, 4) of the full-resolution level
+  const double center[3] = { 40.0, 70.0, 42.0 };
+  const int centerIJK[3] = { 30, 25, 4 };
+  SetSliceFieldOfView(sliceNode, 16.0, center);
+
+  vtkNew<vtkMRMLSliceLayerLogic> logic;
+  logic->SetMRMLScene(scene);
+  logic->SetSliceNode(sliceNode);
+  logic->SetVolumeNode(volumeNode);
+
+  // Zoomed in: small region of the full-resolution level is resliced
+  CHECK_INT(logic->GetChunkedImageLevel(), 0);
+  int* extent = logic->GetChunkedImageExtent();
+  CHECK_EXIT_SUCCESS(CheckExtentContains(extent, centerIJK));
+  // 16 mm along I (1 mm spacing) and 8 voxels along J (2 mm spacing), with a voxel of margin
+  CHECK_BOOL(extent[1] - extent[0] <= 16 + 4, true);
+  CHECK_BOOL(extent[3] - extent[2] <= 8 + 4, true);
+  CHECK_BOOL(extent[5] - extent[4] <= 2, true);
+  vtkImageData* resliceInput = vtkImageData::SafeDownCast(logic->GetReslice()->GetInput());
+  CHECK_NOT_NULL(resliceInput);
+  CHECK_BOOL(resliceInput != previewImageData, true);
+  CHECK_DOUBLE(resliceInput->GetScalarComponentAsDouble(centerIJK[0], centerIJK[1], centerIJK[2], 0),
+    GetExpectedValue(centerIJK[0], centerIJK[1], centerIJK[2]));
+  // Center of the slice shows the full-resolution voxel values
+  logic->GetReslice()->Update();
+  vtkImageData* resliceOutput = logic->GetReslice()->GetOutput();
+  CHECK_DOUBLE_TOLERANCE(resliceOutput->GetScalarComponentAsDouble(128, 128, 0, 0),
+    GetExpectedValue(centerIJK[0], centerIJK[1], centerIJK[2]), 1.0);
+
+  // Zoomed out: full-resolution region would be too large, level 1 is used
+  SetSliceFieldOfView(sliceNode, 32.0, center);
+  CHECK_INT(logic->GetChunkedImageLevel(), 1);
+  // voxel (30, 25, 4) of level 0 is in voxel (14.75, 12.25, 1.75) of level 1
+  const int centerLevel1IJK[3] = { 14, 12, 1 };
+  CHECK_EXIT_SUCCESS(CheckExtentContains(logic->GetChunkedImageExtent(), centerLevel1IJK));
+  resliceInput = vtkImageData::SafeDownCast(logic->GetReslice()->GetInput());
+  CHECK_NOT_NULL(resliceInput);
+  CHECK_BOOL(resliceInput != previewImageData, true);
+  int levelDimensions[3] = { 0, 0, 0 };
+  CHECK_BOOL(storageNode->GetResolutionLevelDimensions(1, levelDimensions), true);
+  int* resliceInputExtent = resliceInput->GetExtent();
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    CHECK_BOOL(resliceInputExtent[axis * 2] >= 0, true);
+    CHECK_BOOL(resliceInputExtent[axis * 2 + 1] < levelDimensions[axis], true);
+  }
+
+  // Whole volume is visible: the preview has enough details
+  SetSliceFieldOfView(sliceNode, 400.0, center);
+  CHECK_INT(logic->GetChunkedImageLevel(), -1);
+  CHECK_POINTER(vtkImageData::SafeDownCast(logic->GetReslice()->GetInput()), previewImageData);
+
+  // Modified preview is resliced as is
+  SetSliceFieldOfView(sliceNode, 16.0, center);
+  CHECK_INT(logic->GetChunkedImageLevel(), 0);
+  previewImageData->SetScalarComponentFromDouble(0, 0, 0, 0, 100.0);
+  previewImageData->GetPointData()->GetScalars()->Modified();
+  volumeNode->Modified();
+  CHECK_INT(logic->GetChunkedImageLevel(), -1);
+  CHECK_POINTER(vtkImageData::SafeDownCast(logic->GetReslice()->GetInput()), previewImageData);
+
+  vtksys::SystemTools::RemoveADirectory(tempDir);
+  return EXIT_SUCCESS;
+}
@@ -16,6 +16,7 @@
 #include "vtkMRMLSliceLayerLogic.h"
 
 // MRML includes
+#include "vtkMRMLChunkedVolumeStorageNode.h"
 #include "vtkMRMLLabelMapVolumeNode.h"
 #include "vtkMRMLLabelMapVolumeDisplayNode.h"
 #include "vtkMRMLVectorVolumeDisplayNode.h"
@@ -50,6 +51,7 @@
 
 // STD includes
 #include <algorithm>
+#include <cmath>
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkMRMLSliceLayerLogic);
@@ -149,6 +151,13 @@ vtkMRMLSliceLayerLogic::vtkMRMLSliceLayerLogic()
   this->UpdatingTransforms = 0;
 
   this->InterpolationMode = VTK_RESLICE_LINEAR;
+
+  this->ChunkedImageData = vtkImageData::New();
+  this->ChunkedImageLevel = -1;
+  for (int i = 0; i < 6; ++i)
+  {
+    this->ChunkedImageExtent[i] = 0;
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -187,6 +196,8 @@ vtkMRMLSliceLayerLogic::~vtkMRMLSliceLayerLogic()
   this->AssignAttributeScalarsToTensors->Delete();
   this->AssignAttributeScalarsToTensorsUVW->Delete();
 
+  this->ChunkedImageData->Delete();
+
   if ( this->VolumeDisplayNode )
   {
     this->VolumeDisplayNode->Delete();
@@ -540,16 +551,29 @@ void vtkMRMLSliceLayerLogic::UpdateTransforms()
     // vtkImageReslice works faster if the input is a linear transform, so try to convert it
     // to a linear transform.
     // Also attempt to make it a permute transform, as it makes reslicing even faster.
+    bool wasChunkedImageUsed = (this->ChunkedImageLevel >= 0);
     vtkSmartPointer<vtkTransform> linearXYToIJKTransform = vtkSmartPointer<vtkTransform>::New();
     if (vtkMRMLTransformNode::IsGeneralTransformLinear(this->XYToIJKTransform, linearXYToIJKTransform))
     {
+      vtkNew<vtkMatrix4x4> xyToChunkedIJK;
+      if (this->UpdateChunkedImageData(linearXYToIJKTransform->GetMatrix(), dimensions, xyToChunkedIJK))
+      {
+        linearXYToIJKTransform->SetMatrix(xyToChunkedIJK);
+      }
       SnapToPermuteMatrix(linearXYToIJKTransform);
       this->Reslice->SetResliceTransform(linearXYToIJKTransform);
     }
     else
     {
+      // chunked volume regions are only used with linear transforms
+      this->ChunkedImageLevel = -1;
       this->Reslice->SetResliceTransform(this->XYToIJKTransform);
     }
+    if (wasChunkedImageUsed || this->ChunkedImageLevel >= 0)
+    {
+      // Input must be consistent with the reslice transform
+      this->Reslice->SetInputData(this->GetResliceInputImageData());
+    }
     vtkSmartPointer<vtkTransform> linearUVWToIJKTransform = vtkSmartPointer<vtkTransform>::New();
     if (vtkMRMLTransformNode::IsGeneralTransformLinear(this->UVWToIJKTransform, linearUVWToIJKTransform))
     {
@@ -597,6 +621,120 @@ void vtkMRMLSliceLayerLogic::UpdateTransforms()
   }
 }
 
+//----------------------------------------------------------------------------
+bool vtkMRMLSliceLayerLogic::UpdateChunkedImageData(vtkMatrix4x4* xyToIJK, const int dimensions[3], vtkMatrix4x4* xyToChunkedIJK)
+{
+  vtkImageData* imageData = (this->VolumeNode ? this->VolumeNode->GetImageData() : nullptr);
+  vtkMRMLChunkedVolumeStorageNode* storageNode = (this->VolumeNode ?
+    vtkMRMLChunkedVolumeStorageNode::SafeDownCast(this->VolumeNode->GetStorageNode()) : nullptr);
+  if (!this->SliceNode || !storageNode || !storageNode->IsPreviewImageData(imageData)
+    || storageNode->GetPreviewResolutionLevel() == 0 || imageData->GetNumberOfScalarComponents() != 1)
+  {
+    // full-resolution image data is available in the volume node
+    this->ChunkedImageLevel = -1;
+    this->ChunkedImageSource = nullptr;
+    return false;
+  }
+
+  // Size of a slice view pixel in full-resolution voxels
+  vtkNew<vtkMatrix4x4> previewIJKToLevel0IJK;
+  storageNode->GetPreviewIJKToLevelIJKMatrix(0, previewIJKToLevel0IJK);
+  vtkNew<vtkMatrix4x4> xyToLevel0IJK;
+  vtkMatrix4x4::Multiply4x4(previewIJKToLevel0IJK, xyToIJK, xyToLevel0IJK);
+  double pixelSize = VTK_DOUBLE_MAX;
+  for (int column = 0; column < 2; ++column)
+  {
+    double columnLength = std::sqrt(xyToLevel0IJK->GetElement(0, column) * xyToLevel0IJK->GetElement(0, column)
+      + xyToLevel0IJK->GetElement(1, column) * xyToLevel0IJK->GetElement(1, column)
+      + xyToLevel0IJK->GetElement(2, column) * xyToLevel0IJK->GetElement(2, column));
+    pixelSize = std::min(pixelSize, columnLength);
+  }
+
+  // Use the coarsest level that still has at least one voxel per pixel,
+  // unless the visible region of that level would be too large to read.
+  int numberOfLevels = storageNode->GetNumberOfResolutionLevels();
+  int level = 0;
+  while (level + 1 < numberOfLevels && (1 << (level + 1)) <= pixelSize)
+  {
+    ++level;
+  }
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  vtkNew<vtkMatrix4x4> xyToLevelIJK;
+  for (; level < numberOfLevels; ++level)
+  {
+    vtkNew<vtkMatrix4x4> previewIJKToLevelIJK;
+    storageNode->GetPreviewIJKToLevelIJKMatrix(level, previewIJKToLevelIJK);
+    vtkMatrix4x4::Multiply4x4(previewIJKToLevelIJK, xyToIJK, xyToLevelIJK);
+    int levelDimensions[3] = { 0, 0, 0 };
+    storageNode->GetResolutionLevelDimensions(level, levelDimensions);
+
+    // Bounding box of the slice view in the voxel coordinates of the level
+    double bounds[6] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+    for (int corner = 0; corner < 8; ++corner)
+    {
+      double xy[4] = { (corner & 1) ? dimensions[0] - 1.0 : 0.0, (corner & 2) ? dimensions[1] - 1.0 : 0.0,
+        (corner & 4) ? dimensions[2] - 1.0 : 0.0, 1.0 };
+      double ijk[4] = { 0.0, 0.0, 0.0, 1.0 };
+      xyToLevelIJK->MultiplyPoint(xy, ijk);
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        bounds[axis * 2] = std::min(bounds[axis * 2], ijk[axis]);
+        bounds[axis * 2 + 1] = std::max(bounds[axis * 2 + 1], ijk[axis]);
+      }
+    }
+    vtkTypeInt64 numberOfVoxels = 1;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      // add a voxel of margin for interpolation
+      extent[axis * 2] = std::max(static_cast<int>(std::floor(bounds[axis * 2])) - 1, 0);
+      extent[axis * 2 + 1] = std::min(static_cast<int>(std::ceil(bounds[axis * 2 + 1])) + 1, levelDimensions[axis] - 1);
+      numberOfVoxels *= std::max(extent[axis * 2 + 1] - extent[axis * 2] + 1, 0);
+    }
+    if (numberOfVoxels <= storageNode->GetMaximumNumberOfPreviewVoxels() || level == numberOfLevels - 1)
+    {
+      break;
+    }
+  }
+  if (level >= storageNode->GetPreviewResolutionLevel()
+    || extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5])
+  {
+    // preview has enough details or the slice does not intersect the volume
+    this->ChunkedImageLevel = -1;
+    return false;
+  }
+
+  bool regionLoaded = (this->ChunkedImageLevel == level && this->ChunkedImageSource.GetPointer() == imageData
+    && extent[0] >= this->ChunkedImageExtent[0] && extent[1] <= this->ChunkedImageExtent[1]
+    && extent[2] >= this->ChunkedImageExtent[2] && extent[3] <= this->ChunkedImageExtent[3]
+    && extent[4] >= this->ChunkedImageExtent[4] && extent[5] <= this->ChunkedImageExtent[5]);
+  if (!regionLoaded)
+  {
+    if (!storageNode->ReadRegion(level, extent, this->ChunkedImageData))
+    {
+      this->ChunkedImageLevel = -1;
+      return false;
+    }
+    this->ChunkedImageLevel = level;
+    this->ChunkedImageSource = imageData;
+    for (int i = 0; i < 6; ++i)
+    {
+      this->ChunkedImageExtent[i] = extent[i];
+    }
+  }
+  xyToChunkedIJK->DeepCopy(xyToLevelIJK);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkImageData* vtkMRMLSliceLayerLogic::GetResliceInputImageData()
+{
+  if (this->ChunkedImageLevel >= 0)
+  {
+    return this->ChunkedImageData;
+  }
+  return (this->VolumeNode ? this->VolumeNode->GetImageData() : nullptr);
+}
+
 //----------------------------------------------------------------------------
 vtkImageData* vtkMRMLSliceLayerLogic::GetImageData()
 {
@@ -760,7 +898,7 @@ void vtkMRMLSliceLayerLogic::UpdateImageDisplay()
 //      {
 //      volumeNode->GetImageData()->Print(std::cout);
 //      }
-    this->Reslice->SetInputData(volumeNode->GetImageData());
+    this->Reslice->SetInputData(this->GetResliceInputImageData());
     this->ResliceUVW->SetInputData(volumeNode->GetImageData());
     // use the label outline if we have a label map volume, this is the label
     // layer (turned on in slice logic when the label layer is instantiated)
@@ -46,6 +46,7 @@
 #include <vtkImageLogic.h>
 #include <vtkImageExtractComponents.h>
 #include <vtkVersion.h>
+#include <vtkWeakPointer.h>
 
 class vtkAssignAttribute;
 class vtkImageReslice;
@@ -55,6 +56,7 @@ class vtkGeneralTransform;
 //#include <cstdlib>
 
 class vtkImageLabelOutline;
+class vtkMatrix4x4;
 class vtkTransform;
 
 class VTK_MRML_LOGIC_EXPORT vtkMRMLSliceLayerLogic
@@ -135,6 +137,17 @@ public:
   vtkGetMacro(InterpolationMode, int);
   vtkSetMacro(InterpolationMode, int);
 
+  ///
+  /// Resolution level of the chunked volume region that is resliced instead of the volume node's image data.
+  /// It is -1 if the image data of the volume node is resliced.
+  /// \sa vtkMRMLChunkedVolumeStorageNode
+  vtkGetMacro(ChunkedImageLevel, int);
+
+  ///
+  /// Extent (in voxel coordinates of the resolution level) of the chunked volume region
+  /// that was read. Only valid if ChunkedImageLevel is not -1.
+  vtkGetVector6Macro(ChunkedImageExtent, int);
+
 protected:
   vtkMRMLSliceLayerLogic();
   ~vtkMRMLSliceLayerLogic() override;
@@ -161,6 +174,15 @@ protected:
   // Copy VolumeDisplayNodeObserved into VolumeDisplayNode
   void UpdateVolumeDisplayNode();
 
+  ///
+  /// If the volume is stored in a chunked volume storage node and only its low-resolution
+  /// preview is loaded then read the region of the resolution level that matches the slice view.
+  /// Returns true if the chunked region is used and sets the XY to chunked region IJK matrix.
+  bool UpdateChunkedImageData(vtkMatrix4x4* xyToIJK, const int dimensions[3], vtkMatrix4x4* xyToChunkedIJK);
+
+  /// Image data that is resliced: region of a chunked volume or image data of the volume node.
+  vtkImageData* GetResliceInputImageData();
+
   ///
   /// the MRML Nodes that define this Logic's parameters
   vtkMRMLVolumeNode *VolumeNode;
@@ -189,6 +211,12 @@ protected:
   int UpdatingTransforms;
 
   int InterpolationMode;
+
+  /// Region of a resolution level of a chunked volume
+  vtkImageData* ChunkedImageData;
+  int ChunkedImageLevel;
+  int ChunkedImageExtent[6];
+  vtkWeakPointer<vtkImageData> ChunkedImageSource;
 };
 
 #endif
@@ -0,0 +1,198 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+
+// Slicer includes
+#include "vtkSlicerConfigure.h"
+
+// qMRML includes
+#include "qMRMLSceneModel.h"
+#include "qMRMLSortFilterProxyModel.h"
+#include "qMRMLWidget.h"
+
+// CTK includes
+#include <ctkCoreTestingMacros.h>
+
+// MRML includes
+#include <vtkMRMLLinearTransformNode.h>
+#include <vtkMRMLModelNode.h>
+#include <vtkMRMLScene.h>
+
+// VTK includes
+#include <vtkNew.h>
+
+// STD includes
+#include <iostream>
+#include <vector>
+
+// Benchmark of the scene model and sort filter proxy model with a large scene.
+// Elapsed times are printed to the standard output, incremental updates are checked
+// against the time it takes to populate the model.
+// Subject hierarchy model is tested in qMRMLSubjectHierarchyModelTest1 of the SubjectHierarchy module.
+int qMRMLSceneModelTest2( int argc, char * argv [] )
+{
+  qMRMLWidget::preInitializeApplication();
+  QApplication app(argc, argv);
+  qMRMLWidget::postInitializeApplication();
+
+  const int numberOfNodes = 50000;
+
+  vtkNew<vtkMRMLScene> scene;
+  std::vector<vtkMRMLNode*> modelNodes;
+  for (int i = 0; i < numberOfNodes; ++i)
+  {
+    if (i % 2)
+    {
+      vtkNew<vtkMRMLLinearTransformNode> transformNode;
+      scene->AddNode(transformNode);
+    }
+    else
+    {
+      vtkNew<vtkMRMLModelNode> modelNode;
+      modelNode->SetAttribute("Benchmark.Group", (i % 4) ? "B" : "A");
+      scene->AddNode(modelNode);
+      modelNodes.push_back(modelNode);
+    }
+  }
+  const int numberOfSceneNodes = scene->GetNumberOfNodes();
+
+  QElapsedTimer timer;
+
+  // Populate
+  timer.start();
+  qMRMLSceneModel sceneModel;
+  sceneModel.setMRMLScene(scene);
+  const qint64 populateTime = timer.elapsed();
+  std::cout << "Populate model with " << numberOfSceneNodes << " nodes: " << populateTime << "ms" << std::endl;
+  CHECK_INT(sceneModel.rowCount(sceneModel.mrmlSceneIndex()), numberOfSceneNodes);
+
+  // Filter by node type and attribute
+  timer.start();
+  qMRMLSortFilterProxyModel proxyModel;
+  proxyModel.setSourceModel(&sceneModel);
+  proxyModel.setNodeTypes(QStringList() << "vtkMRMLModelNode");
+  proxyModel.addAttribute("vtkMRMLModelNode", "Benchmark.Group", "A");
+  std::cout << "Filter by node type and attribute: " << timer.elapsed() << "ms" << std::endl;
+  const int numberOfGroupANodes = numberOfNodes / 4;
+  CHECK_INT(proxyModel.rowCount(proxyModel.mrmlSceneIndex()), numberOfGroupANodes);
+
+  // Invalidate filter, node type filter results of unmodified nodes are reused
+  timer.start();
+  proxyModel.invalidate();
+  std::cout << "Invalidate filter: " << timer.elapsed() << "ms" << std::endl;
+  CHECK_INT(proxyModel.rowCount(proxyModel.mrmlSceneIndex()), numberOfGroupANodes);
+
+  // Modify nodes
+  const int numberOfModifiedNodes = 100;
+  timer.start();
+  for (int i = 0; i < numberOfModifiedNodes; ++i)
+  {
+    // Move node from group B to group A
+    modelNodes[i * 2 + 1]->SetAttribute("Benchmark.Group", "A");
+    modelNodes[i * 2 + 1]->Modified();
+  }
+  std::cout << "Modify " << numberOfModifiedNodes << " nodes: " << timer.elapsed() << "ms" << std::endl;
+  CHECK_INT(proxyModel.rowCount(proxyModel.mrmlSceneIndex()), numberOfGroupANodes + numberOfModifiedNodes);
+
+  // Look up nodes
+  timer.start();
+  for (vtkMRMLNode* node : modelNodes)
+  {
+    CHECK_BOOL(sceneModel.indexFromNode(node).isValid(), true);
+  }
+  std::cout << "Look up " << modelNodes.size() << " nodes: " << timer.elapsed() << "ms" << std::endl;
+
+  // Remove nodes
+  const int numberOfRemovedNodes = 1000;
+  timer.start();
+  for (int i = 0; i < numberOfRemovedNodes; ++i)
+  {
+    scene->RemoveNode(modelNodes.back());
+    modelNodes.pop_back();
+  }
+  std::cout << "Remove " << numberOfRemovedNodes << " nodes: " << timer.elapsed() << "ms" << std::endl;
+  CHECK_INT(sceneModel.rowCount(sceneModel.mrmlSceneIndex()), numberOfSceneNodes - numberOfRemovedNodes);
+  const int numberOfProxyNodes = proxyModel.rowCount(proxyModel.mrmlSceneIndex());
+
+  // Add and modify nodes in batch processing, the model is updated without being rebuilt
+  sceneModel.setLazyUpdate(true);
+  const int numberOfBatchAddedNodes = 50;
+  std::vector<vtkMRMLNode*> batchAddedNodes;
+  timer.start();
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+  for (int i = 0; i < numberOfBatchAddedNodes; ++i)
+  {
+    vtkNew<vtkMRMLModelNode> modelNode;
+    modelNode->SetAttribute("Benchmark.Group", "A");
+    scene->AddNode(modelNode);
+    batchAddedNodes.push_back(modelNode);
+  }
+  modelNodes[0]->SetName("Renamed");
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+  const qint64 smallBatchTime = timer.elapsed();
+  std::cout << "Add " << numberOfBatchAddedNodes << " nodes in batch processing: " << smallBatchTime << "ms" << std::endl;
+  CHECK_BOOL(smallBatchTime <= populateTime / 2 + 100, true);
+  CHECK_INT(sceneModel.rowCount(sceneModel.mrmlSceneIndex()), numberOfSceneNodes - numberOfRemovedNodes + numberOfBatchAddedNodes);
+  CHECK_INT(proxyModel.rowCount(proxyModel.mrmlSceneIndex()), numberOfProxyNodes + numberOfBatchAddedNodes);
+  CHECK_INT(sceneModel.indexFromNode(batchAddedNodes.back()).row(), numberOfSceneNodes - numberOfRemovedNodes + numberOfBatchAddedNodes - 1);
+  CHECK_QSTRING(sceneModel.indexFromNode(modelNodes[0], sceneModel.nameColumn()).data().toString(), QString("Renamed"));
+
+  // Remove nodes in batch processing, the model is rebuilt
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+  for (vtkMRMLNode* node : batchAddedNodes)
+  {
+    scene->RemoveNode(node);
+  }
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+  CHECK_INT(sceneModel.rowCount(sceneModel.mrmlSceneIndex()), numberOfSceneNodes - numberOfRemovedNodes);
+  CHECK_INT(proxyModel.rowCount(proxyModel.mrmlSceneIndex()), numberOfProxyNodes);
+
+  // Add many nodes in batch processing, they are inserted in a single block of rows
+  // instead of rebuilding the model
+  const int numberOfLargeBatchAddedNodes = 10000;
+  CHECK_BOOL(numberOfLargeBatchAddedNodes > qMRMLSceneModel::maximumNumberOfNodesToInsert(), true);
+  QSignalSpy insertSpy(&sceneModel, SIGNAL(rowsInserted(QModelIndex,int,int)));
+  QSignalSpy removeSpy(&sceneModel, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+  vtkMRMLNode* lastBatchAddedNode = nullptr;
+  for (int i = 0; i < numberOfLargeBatchAddedNodes; ++i)
+  {
+    vtkNew<vtkMRMLModelNode> modelNode;
+    modelNode->SetAttribute("Benchmark.Group", "A");
+    scene->AddNode(modelNode);
+    lastBatchAddedNode = modelNode;
+  }
+  timer.start();
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+  const qint64 largeBatchTime = timer.elapsed();
+  std::cout << "Insert " << numberOfLargeBatchAddedNodes << " nodes added in batch processing: " << largeBatchTime << "ms" << std::endl;
+  CHECK_INT(removeSpy.count(), 0);
+  CHECK_INT(insertSpy.count(), 1);
+  CHECK_INT(sceneModel.rowCount(sceneModel.mrmlSceneIndex()), numberOfSceneNodes - numberOfRemovedNodes + numberOfLargeBatchAddedNodes);
+  CHECK_INT(proxyModel.rowCount(proxyModel.mrmlSceneIndex()), numberOfProxyNodes + numberOfLargeBatchAddedNodes);
+  CHECK_INT(sceneModel.indexFromNode(lastBatchAddedNode).row(), numberOfSceneNodes - numberOfRemovedNodes + numberOfLargeBatchAddedNodes - 1);
+  CHECK_BOOL(sceneModel.indexFromNode(lastBatchAddedNode, sceneModel.nameColumn()).isValid(), true);
+  // Inserting the nodes one by one would be quadratic (each row insertion is linear in the
+  // number of rows of the proxy model), block insertion is faster than populating the model.
+  CHECK_BOOL(largeBatchTime <= populateTime + 1000, true);
+
+  return EXIT_SUCCESS;
+}
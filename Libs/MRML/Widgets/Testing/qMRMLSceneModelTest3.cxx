@@ -0,0 +1,118 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+
+// qMRML includes
+#include "qMRMLSceneModel.h"
+#include "qMRMLSortFilterProxyModel.h"
+#include "qMRMLWidget.h"
+
+// CTK includes
+#include <ctkCoreTestingMacros.h>
+
+// MRML includes
+#include <vtkMRMLModelNode.h>
+#include <vtkMRMLScene.h>
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <iostream>
+#include <vector>
+
+// Benchmark of adding many nodes to a scene that is observed by a scene model
+// and a sort filter proxy model. Elapsed times are printed to the standard output.
+int qMRMLSceneModelTest3( int argc, char * argv [] )
+{
+  qMRMLWidget::preInitializeApplication();
+  QApplication app(argc, argv);
+  qMRMLWidget::postInitializeApplication();
+
+  // Adding nodes one by one is quadratic in the number of nodes (the model index of
+  // each node is searched for in the whole scene), therefore fewer nodes are added that way.
+  const int numberOfNodes = 100000;
+  const int numberOfNodesAddedOneByOne = 5000;
+
+  vtkNew<vtkMRMLScene> scene;
+  qMRMLSceneModel sceneModel;
+  sceneModel.setMRMLScene(scene);
+  qMRMLSortFilterProxyModel proxyModel;
+  proxyModel.setSourceModel(&sceneModel);
+  proxyModel.setNodeTypes(QStringList() << "vtkMRMLModelNode");
+
+  QElapsedTimer timer;
+
+  // Add nodes at once
+  std::vector<vtkSmartPointer<vtkMRMLNode>> nodes;
+  std::vector<vtkMRMLNode*> nodesToAdd;
+  for (int i = 0; i < numberOfNodes; ++i)
+  {
+    vtkNew<vtkMRMLModelNode> modelNode;
+    nodes.push_back(modelNode.GetPointer());
+    nodesToAdd.push_back(modelNode);
+  }
+  QSignalSpy insertSpy(&sceneModel, SIGNAL(rowsInserted(QModelIndex,int,int)));
+  QSignalSpy removeSpy(&sceneModel, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+  timer.start();
+  scene->AddNodes(nodesToAdd);
+  std::cout << "AddNodes: " << numberOfNodes << " nodes in " << timer.elapsed() << "ms" << std::endl;
+  // Nodes are inserted in a single block of rows, the model is not rebuilt
+  CHECK_INT(insertSpy.count(), 1);
+  CHECK_INT(removeSpy.count(), 0);
+  CHECK_INT(sceneModel.rowCount(sceneModel.mrmlSceneIndex()), numberOfNodes);
+  CHECK_INT(proxyModel.rowCount(proxyModel.mrmlSceneIndex()), numberOfNodes);
+  CHECK_BOOL(sceneModel.indexFromNode(nodes[numberOfNodes - 1]).isValid(), true);
+
+  // Add a few nodes at once, they are inserted without rebuilding the model
+  std::vector<vtkSmartPointer<vtkMRMLNode>> fewNodes;
+  std::vector<vtkMRMLNode*> fewNodesToAdd;
+  for (int i = 0; i < 3; ++i)
+  {
+    vtkNew<vtkMRMLModelNode> modelNode;
+    fewNodes.push_back(modelNode.GetPointer());
+    fewNodesToAdd.push_back(modelNode);
+  }
+  timer.start();
+  scene->AddNodes(fewNodesToAdd);
+  std::cout << "AddNodes: " << fewNodesToAdd.size() << " nodes in " << timer.elapsed() << "ms" << std::endl;
+  CHECK_INT(sceneModel.rowCount(sceneModel.mrmlSceneIndex()), numberOfNodes + 3);
+  CHECK_INT(proxyModel.rowCount(proxyModel.mrmlSceneIndex()), numberOfNodes + 3);
+  CHECK_BOOL(sceneModel.indexFromNode(fewNodes[2]).isValid(), true);
+
+  // Add nodes one by one
+  vtkNew<vtkMRMLScene> referenceScene;
+  qMRMLSceneModel referenceSceneModel;
+  referenceSceneModel.setMRMLScene(referenceScene);
+  qMRMLSortFilterProxyModel referenceProxyModel;
+  referenceProxyModel.setSourceModel(&referenceSceneModel);
+  referenceProxyModel.setNodeTypes(QStringList() << "vtkMRMLModelNode");
+  timer.start();
+  for (int i = 0; i < numberOfNodesAddedOneByOne; ++i)
+  {
+    vtkNew<vtkMRMLModelNode> modelNode;
+    referenceScene->AddNode(modelNode);
+  }
+  std::cout << "AddNode: " << numberOfNodesAddedOneByOne << " nodes in " << timer.elapsed() << "ms" << std::endl;
+  CHECK_INT(referenceSceneModel.rowCount(referenceSceneModel.mrmlSceneIndex()), numberOfNodesAddedOneByOne);
+  CHECK_INT(referenceProxyModel.rowCount(referenceProxyModel.mrmlSceneIndex()), numberOfNodesAddedOneByOne);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,129 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright 2015 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QApplication>
+#include <QSignalSpy>
+
+// Slicer includes
+#include "vtkSlicerConfigure.h"
+
+// CTK includes
+#include <ctkCoreTestingMacros.h>
+
+// qMRML includes
+#include "qMRMLTableModel.h"
+
+// MRML includes
+#include "vtkMRMLTableNode.h"
+
+// VTK includes
+#include <vtkDoubleArray.h>
+#include <vtkNew.h>
+#include <vtkStringArray.h>
+#include <vtkTable.h>
+#include "qMRMLWidget.h"
+
+int qMRMLTableModelTest1( int argc, char * argv [] )
+{
+  qMRMLWidget::preInitializeApplication();
+  QApplication app(argc, argv);
+  qMRMLWidget::postInitializeApplication();
+
+  // Create a large table
+  const int numberOfRows = 100000;
+  vtkNew<vtkTable> table;
+  vtkNew<vtkDoubleArray> valueArray;
+  valueArray->SetName("Value");
+  valueArray->SetNumberOfValues(numberOfRows);
+  vtkNew<vtkStringArray> labelArray;
+  labelArray->SetName("Label");
+  labelArray->SetNumberOfValues(numberOfRows);
+  for (int i = 0; i < numberOfRows; ++i)
+  {
+    valueArray->SetValue(i, numberOfRows - i);
+    labelArray->SetValue(i, i % 2 ? "odd" : "even");
+  }
+  table->AddColumn(valueArray);
+  table->AddColumn(labelArray);
+  vtkNew<vtkMRMLTableNode> tableNode;
+  tableNode->SetAndObserveTable(table);
+
+  qMRMLTableModel model;
+  CHECK_INT(model.rowCount(), 0);
+  model.setMRMLTableNode(tableNode);
+
+  // First row contains the column names
+  CHECK_INT(model.rowCount(), numberOfRows + 1);
+  CHECK_INT(model.columnCount(), 2);
+  CHECK_QSTRING(model.data(model.index(0, 0)).toString(), QString("Value"));
+  CHECK_QSTRING(model.data(model.index(1, 0)).toString(), QString::number(numberOfRows));
+  CHECK_QSTRING(model.data(model.index(2, 1)).toString(), QString("odd"));
+  CHECK_INT(model.mrmlTableRowIndex(model.index(0, 0)), -1);
+  CHECK_INT(model.mrmlTableRowIndex(model.index(5, 0)), 4);
+
+  // Edit a cell
+  CHECK_BOOL(model.setData(model.index(1, 1), QString("first")), true);
+  CHECK_QSTRING(QString::fromStdString(table->GetValue(0, 1).ToString()), QString("first"));
+
+  // Adding a row is reported as row insertion
+  QSignalSpy rowsInsertedSpy(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+  QSignalSpy modelResetSpy(&model, SIGNAL(modelReset()));
+  tableNode->AddEmptyRow();
+  CHECK_INT(rowsInsertedSpy.count(), 1);
+  CHECK_INT(modelResetSpy.count(), 0);
+  CHECK_INT(model.rowCount(), numberOfRows + 2);
+
+  // Removing the last row is reported as row removal
+  QSignalSpy rowsRemovedSpy(&model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+  tableNode->RemoveRow(numberOfRows);
+  CHECK_INT(rowsRemovedSpy.count(), 1);
+  CHECK_INT(model.rowCount(), numberOfRows + 1);
+
+  // Sort by value: order of rows is reversed, header row is kept at the top
+  model.sort(0, Qt::AscendingOrder);
+  CHECK_INT(model.rowCount(), numberOfRows + 1);
+  CHECK_QSTRING(model.data(model.index(0, 0)).toString(), QString("Value"));
+  CHECK_QSTRING(model.data(model.index(1, 0)).toString(), QString("1"));
+  CHECK_INT(model.mrmlTableRowIndex(model.index(1, 0)), numberOfRows - 1);
+  CHECK_QSTRING(model.headerData(1, Qt::Vertical).toString(), QString::number(numberOfRows + 1));
+
+  // Filter rows
+  model.setFilterText("first");
+  CHECK_INT(model.rowCount(), 2);
+  CHECK_INT(model.mrmlTableRowIndex(model.index(1, 0)), 0);
+  model.setFilterText("ODD");
+  CHECK_INT(model.rowCount(), numberOfRows / 2 + 1);
+
+  // Restore original order
+  model.setFilterText(QString());
+  model.sort(-1);
+  CHECK_QSTRING(model.data(model.index(1, 0)).toString(), QString::number(numberOfRows));
+
+  // Transposed
+  model.setTransposed(true);
+  CHECK_INT(model.rowCount(), 2);
+  CHECK_INT(model.columnCount(), numberOfRows + 1);
+  CHECK_QSTRING(model.data(model.index(1, 0)).toString(), QString("Label"));
+  CHECK_QSTRING(model.data(model.index(1, 1)).toString(), QString("first"));
+
+  model.setMRMLTableNode(nullptr);
+  CHECK_INT(model.rowCount(), 0);
+  CHECK_INT(model.columnCount(), 0);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,133 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QApplication>
+#include <QHeaderView>
+#include <QSignalSpy>
+#include <QSortFilterProxyModel>
+
+// Slicer includes
+#include "vtkSlicerConfigure.h"
+
+// CTK includes
+#include <ctkCoreTestingMacros.h>
+
+// qMRML includes
+#include "qMRMLTableModel.h"
+#include "qMRMLTableView.h"
+#include "qMRMLWidget.h"
+
+// MRML includes
+#include "vtkMRMLTableNode.h"
+
+// VTK includes
+#include <vtkDoubleArray.h>
+#include <vtkNew.h>
+#include <vtkStringArray.h>
+#include <vtkTable.h>
+
+// Sort and filter rows through the table view
+int qMRMLTableViewTest2( int argc, char * argv [] )
+{
+  qMRMLWidget::preInitializeApplication();
+  QApplication app(argc, argv);
+  qMRMLWidget::postInitializeApplication();
+
+  const int numberOfRows = 1000;
+  vtkNew<vtkTable> table;
+  vtkNew<vtkDoubleArray> valueArray;
+  valueArray->SetName("Value");
+  valueArray->SetNumberOfValues(numberOfRows);
+  vtkNew<vtkStringArray> labelArray;
+  labelArray->SetName("Label");
+  labelArray->SetNumberOfValues(numberOfRows);
+  for (int i = 0; i < numberOfRows; ++i)
+  {
+    valueArray->SetValue(i, numberOfRows - i);
+    labelArray->SetValue(i, i % 2 ? "odd" : "even");
+  }
+  table->AddColumn(valueArray);
+  table->AddColumn(labelArray);
+  vtkNew<vtkMRMLTableNode> tableNode;
+  tableNode->SetAndObserveTable(table);
+
+  qMRMLTableView tableView;
+  tableView.setMRMLTableNode(tableNode);
+
+  // The view shows a pass-through proxy model, sorting and filtering are done by the table model
+  QAbstractItemModel* viewModel = tableView.model();
+  QSortFilterProxyModel* proxyModel = tableView.sortFilterProxyModel();
+  qMRMLTableModel* tableModel = tableView.tableModel();
+  CHECK_POINTER(viewModel, proxyModel);
+  CHECK_POINTER(proxyModel->sourceModel(), tableModel);
+  // First row contains the column names
+  CHECK_INT(viewModel->rowCount(), numberOfRows + 1);
+  CHECK_QSTRING(viewModel->data(viewModel->index(1, 0)).toString(), QString::number(numberOfRows));
+
+  // Sort by clicking on the column header
+  tableView.setSortingEnabled(true);
+  tableView.sortByColumn(0, Qt::AscendingOrder);
+  CHECK_INT(tableView.horizontalHeader()->sortIndicatorSection(), 0);
+  CHECK_INT(viewModel->rowCount(), numberOfRows + 1);
+  CHECK_QSTRING(viewModel->data(viewModel->index(0, 0)).toString(), QString("Value"));
+  CHECK_QSTRING(viewModel->data(viewModel->index(1, 0)).toString(), QString("1"));
+  CHECK_INT(tableModel->mrmlTableRowIndex(proxyModel->mapToSource(viewModel->index(1, 0))), numberOfRows - 1);
+  tableView.sortByColumn(0, Qt::DescendingOrder);
+  CHECK_QSTRING(viewModel->data(viewModel->index(1, 0)).toString(), QString::number(numberOfRows));
+
+  // Filter rows
+  tableModel->setFilterText("odd");
+  CHECK_INT(viewModel->rowCount(), numberOfRows / 2 + 1);
+  CHECK_QSTRING(viewModel->data(viewModel->index(1, 1)).toString(), QString("odd"));
+  CHECK_QSTRING(viewModel->data(viewModel->index(1, 0)).toString(), QString::number(numberOfRows - 1));
+
+  // Edit through the view model updates the table row that is displayed
+  CHECK_BOOL(viewModel->setData(viewModel->index(1, 1), QString("edited")), true);
+  CHECK_QSTRING(QString::fromStdString(table->GetValue(1, 1).ToString()), QString("edited"));
+
+  tableModel->setFilterText(QString());
+  CHECK_INT(viewModel->rowCount(), numberOfRows + 1);
+
+  // Table modifications while rows are sorted do not reset the model,
+  // the modified rows are moved and inserted and the current index follows its row.
+  tableView.sortByColumn(0, Qt::AscendingOrder);
+  CHECK_QSTRING(viewModel->data(viewModel->index(2, 0)).toString(), QString("2"));
+  tableView.setCurrentIndex(viewModel->index(2, 0));
+  QSignalSpy resetSpy(viewModel, SIGNAL(modelAboutToBeReset()));
+  QSignalSpy layoutSpy(viewModel, SIGNAL(layoutChanged()));
+  QSignalSpy insertSpy(viewModel, SIGNAL(rowsInserted(QModelIndex,int,int)));
+
+  // Move the last row to the top
+  valueArray->SetValue(0, 0.5);
+  valueArray->Modified();
+  tableNode->Modified();
+  CHECK_INT(resetSpy.count(), 0);
+  CHECK_BOOL(layoutSpy.count() > 0, true);
+  CHECK_INT(viewModel->rowCount(), numberOfRows + 1);
+  CHECK_QSTRING(viewModel->data(viewModel->index(1, 0)).toString(), QString("0.5"));
+  CHECK_INT(tableView.currentIndex().row(), 3);
+  CHECK_INT(tableModel->mrmlTableRowIndex(proxyModel->mapToSource(tableView.currentIndex())), numberOfRows - 2);
+
+  // Add a row, it is inserted at its sorted position
+  tableNode->AddEmptyRow();
+  CHECK_INT(resetSpy.count(), 0);
+  CHECK_INT(insertSpy.count(), 1);
+  CHECK_INT(viewModel->rowCount(), numberOfRows + 2);
+  CHECK_INT(tableModel->mrmlTableRowIndex(proxyModel->mapToSource(viewModel->index(1, 0))), numberOfRows);
+  CHECK_INT(tableView.currentIndex().row(), 4);
+
+  return EXIT_SUCCESS;
+}
@@ -20,6 +20,7 @@
 
 // Qt includes
 #include <QDebug>
+#include <QPair>
 #include <QTimer>
 
 // CTK includes
@@ -48,6 +49,8 @@ qMRMLSceneModelPrivate::qMRMLSceneModelPrivate(qMRMLSceneModel& object)
 
   this->CallBack = vtkSmartPointer<vtkCallbackCommand>::New();
   this->LazyUpdate = false;
+  this->AddingNodes = false;
+  this->BatchUpdateRequired = false;
   this->ListenNodeModifiedEvent = qMRMLSceneModel::NoNodes;
   this->PendingItemModified = -1; // -1 means not updating
 
@@ -91,7 +94,7 @@ void qMRMLSceneModelPrivate::init()
 }
 
 //------------------------------------------------------------------------------
-QModelIndexList qMRMLSceneModelPrivate::indexes(const QString& nodeID)const
+QModelIndexList qMRMLSceneModelPrivate::indexes(const QString& nodeID, vtkMRMLNode* node/*=nullptr*/)const
 {
   Q_Q(const qMRMLSceneModel);
   QModelIndex scene = q->mrmlSceneIndex();
@@ -99,11 +102,25 @@ QModelIndexList qMRMLSceneModelPrivate::indexes(const QString& nodeID)const
   {
     return QModelIndexList();
   }
-  // QAbstractItemModel::match doesn't browse through columns
-  // we need to do it manually
-  QModelIndexList nodeIndexes = q->match(
-    scene, qMRMLSceneModel::UIDRole, nodeID,
-    1, Qt::MatchExactly | Qt::MatchRecursive);
+  QModelIndexList nodeIndexes;
+  if (node && node->GetID() && nodeID == QString::fromUtf8(node->GetID()))
+  {
+    // Use the row cache, it is much faster than browsing the whole tree
+    QModelIndex nodeIndex = q->indexFromNode(node);
+    if (!nodeIndex.isValid())
+    {
+      return nodeIndexes;
+    }
+    nodeIndexes << nodeIndex;
+  }
+  else
+  {
+    // QAbstractItemModel::match doesn't browse through columns
+    // we need to do it manually
+    nodeIndexes = q->match(
+      scene, qMRMLSceneModel::UIDRole, nodeID,
+      1, Qt::MatchExactly | Qt::MatchRecursive);
+  }
   Q_ASSERT(nodeIndexes.size() <= 1); // we know for sure it won't be more than 1
   if (nodeIndexes.size() == 0)
   {
@@ -363,6 +380,8 @@ void qMRMLSceneModel::setMRMLScene(vtkMRMLScene* scene)
   {
     scene->AddObserver(vtkMRMLScene::NodeAboutToBeAddedEvent, d->CallBack, -10.);
     scene->AddObserver(vtkMRMLScene::NodeAddedEvent, d->CallBack, 10.);
+    scene->AddObserver(vtkMRMLScene::NodesAboutToBeAddedEvent, d->CallBack, -10.);
+    scene->AddObserver(vtkMRMLScene::NodesAddedEvent, d->CallBack, 10.);
     scene->AddObserver(vtkMRMLScene::NodeAboutToBeRemovedEvent, d->CallBack, -10.);
     scene->AddObserver(vtkMRMLScene::NodeRemovedEvent, d->CallBack, 10.);
     scene->AddObserver(vtkCommand::DeleteEvent, d->CallBack);
@@ -457,7 +476,7 @@ QModelIndex qMRMLSceneModel::indexFromNode(vtkMRMLNode* node, int column)const
   QModelIndex nodeIndex;
 
   // Try to find the nodeIndex in the cache first
-  QMap<vtkMRMLNode*,QPersistentModelIndex>::iterator rowCacheIt=d->RowCache.find(node);
+  QHash<vtkMRMLNode*,QPersistentModelIndex>::iterator rowCacheIt=d->RowCache.find(node);
   if (rowCacheIt==d->RowCache.end())
   {
     // not found in cache, therefore it cannot be in the model
@@ -515,7 +534,7 @@ QModelIndex qMRMLSceneModel::indexFromNode(vtkMRMLNode* node, int column)const
 QModelIndexList qMRMLSceneModel::indexes(vtkMRMLNode* node)const
 {
   Q_D(const qMRMLSceneModel);
-  return d->indexes(QString(node->GetID()));
+  return d->indexes(QString(node->GetID()), node);
 }
 
 //------------------------------------------------------------------------------
@@ -717,6 +736,9 @@ void qMRMLSceneModel::updateScene()
                  this, SLOT(onMRMLNodeIDChanged(vtkObject*,void*)));
 
   d->RowCache.clear();
+  d->BatchAddedNodes.clear();
+  d->BatchModifiedNodes.clear();
+  d->BatchUpdateRequired = false;
 
   // Enabled so it can be interacted with
   this->invisibleRootItem()->setFlags(Qt::ItemIsEnabled);
@@ -846,6 +868,192 @@ QStandardItem* qMRMLSceneModelPrivate::insertNode(vtkMRMLNode* node, int nodeInd
   return nodeItem;
 }
 
+//------------------------------------------------------------------------------
+void qMRMLSceneModelPrivate::insertNodes(const QList<vtkMRMLNode*>& nodes)
+{
+  Q_Q(qMRMLSceneModel);
+  if (nodes.isEmpty() || !this->MRMLScene)
+  {
+    return;
+  }
+  QSet<vtkMRMLNode*> nodesToInsert;
+  foreach(vtkMRMLNode* node, nodes)
+  {
+    nodesToInsert.insert(node);
+  }
+  const bool insertBlocks = (nodesToInsert.count() > qMRMLSceneModel::maximumNumberOfNodesToInsert());
+  // Nodes to insert in blocks, grouped by parent node. Parents are listed in the order
+  // of their first child in the scene, and nodes are in the order of their index.
+  QList<vtkMRMLNode*> parentNodes;
+  QHash<vtkMRMLNode*, QList<QPair<vtkMRMLNode*, int> > > nodesToInsertByParent;
+  // Same indexing as qMRMLSceneModel::nodeIndex(): index of the node among the
+  // scene nodes that have the same parent (nullptr parent is the scene).
+  QHash<vtkMRMLNode*, int> lastIndexOfParent;
+  this->MisplacedNodes.clear();
+  vtkMRMLNode* node = nullptr;
+  vtkCollectionSimpleIterator it;
+  for (this->MRMLScene->GetNodes()->InitTraversal(it);
+       (node = (vtkMRMLNode*)this->MRMLScene->GetNodes()->GetNextItemAsObject(it)) ;)
+  {
+    vtkMRMLNode* parentNode = q->parentNode(node);
+    int index = lastIndexOfParent.value(parentNode, -1) + 1;
+    lastIndexOfParent[parentNode] = index;
+    if (nodesToInsert.remove(node))
+    {
+      if (insertBlocks)
+      {
+        if (!nodesToInsertByParent.contains(parentNode))
+        {
+          parentNodes << parentNode;
+        }
+        nodesToInsertByParent[parentNode] << qMakePair(node, index);
+      }
+      else
+      {
+        this->insertNode(node, index);
+      }
+      if (nodesToInsert.isEmpty())
+      {
+        break;
+      }
+    }
+  }
+  foreach(vtkMRMLNode* parentNode, parentNodes)
+  {
+    // Split the nodes of the parent into blocks of consecutive indexes. Blocks are
+    // inserted in increasing index order, so all the preceding siblings are in the
+    // model when a block is inserted.
+    const QList<QPair<vtkMRMLNode*, int> >& parentNodesToInsert = nodesToInsertByParent[parentNode];
+    QList<vtkMRMLNode*> blockNodes;
+    int blockFirstIndex = -1;
+    for (int i = 0; i < parentNodesToInsert.count(); ++i)
+    {
+      if (!blockNodes.isEmpty() && parentNodesToInsert[i].second != blockFirstIndex + blockNodes.count())
+      {
+        this->insertNodeBlock(parentNode, blockNodes, blockFirstIndex);
+        blockNodes.clear();
+      }
+      if (blockNodes.isEmpty())
+      {
+        blockFirstIndex = parentNodesToInsert[i].second;
+      }
+      blockNodes << parentNodesToInsert[i].first;
+    }
+    this->insertNodeBlock(parentNode, blockNodes, blockFirstIndex);
+  }
+  foreach(vtkMRMLNode* misplacedNode, this->MisplacedNodes)
+  {
+    q->onMRMLNodeModified(misplacedNode);
+  }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSceneModelPrivate::insertNodeBlock(vtkMRMLNode* parentNode, const QList<vtkMRMLNode*>& nodes, int firstIndex)
+{
+  Q_Q(qMRMLSceneModel);
+  if (nodes.isEmpty())
+  {
+    return;
+  }
+  QStandardItem* parentItem = parentNode ? q->itemFromNode(parentNode) : q->mrmlSceneItem();
+  bool insertBlock = (parentItem != nullptr);
+  int row = -1;
+  if (parentItem)
+  {
+    int min = q->preItems(parentItem).count();
+    int max = parentItem->rowCount() - q->postItems(parentItem).count();
+    row = min + firstIndex;
+    insertBlock = (row <= max);
+  }
+  foreach(vtkMRMLNode* node, nodes)
+  {
+    if (!insertBlock)
+    {
+      break;
+    }
+    // A node can already be in the model if it is the parent of a node inserted one by one
+    insertBlock = !this->RowCache.contains(node);
+  }
+  if (!insertBlock)
+  {
+    int index = firstIndex;
+    foreach(vtkMRMLNode* node, nodes)
+    {
+      this->insertNode(node, index++);
+    }
+    return;
+  }
+
+  const int columnCount = q->columnCount();
+  QList<QList<QStandardItem*> > rowsItems;
+  QList<QStandardItem*> firstColumnItems;
+  foreach(vtkMRMLNode* node, nodes)
+  {
+    QList<QStandardItem*> items;
+    for (int column = 0; column < columnCount; ++column)
+    {
+      QStandardItem* newNodeItem = new QStandardItem();
+      q->updateItemFromNode(newNodeItem, node, column);
+      items.append(newNodeItem);
+    }
+    firstColumnItems << items[0];
+    rowsItems << items;
+    // See qMRMLSceneModel::insertNode(vtkMRMLNode*, QStandardItem*, int)
+    this->RowCache[node] = QModelIndex();
+  }
+  if (parentItem->columnCount() < columnCount)
+  {
+    parentItem->setColumnCount(columnCount);
+  }
+  // All the rows are inserted at once: views and proxy models are notified only once.
+  parentItem->insertRows(row, firstColumnItems);
+  if (columnCount > 1)
+  {
+    // QStandardItem::setChild() notifies a layout change for each item, instead
+    // the other columns are set silently and a single data change is notified.
+    bool wasBlocking = q->blockSignals(true);
+    for (int i = 0; i < rowsItems.count(); ++i)
+    {
+      for (int column = 1; column < columnCount; ++column)
+      {
+        parentItem->setChild(row + i, column, rowsItems[i][column]);
+      }
+    }
+    q->blockSignals(wasBlocking);
+    emit q->dataChanged(rowsItems.first()[1]->index(), rowsItems.last()[columnCount - 1]->index());
+  }
+  for (int i = 0; i < nodes.count(); ++i)
+  {
+    this->RowCache[nodes[i]] = firstColumnItems[i]->index();
+    if (this->ListenNodeModifiedEvent == qMRMLSceneModel::AllNodes)
+    {
+      q->observeNode(nodes[i]);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSceneModelPrivate::updateBatchProcessedNodes()
+{
+  Q_Q(qMRMLSceneModel);
+  if (this->BatchUpdateRequired)
+  {
+    q->updateScene();
+    return;
+  }
+  QList<vtkMRMLNode*> addedNodes = this->BatchAddedNodes;
+  QSet<vtkMRMLNode*> modifiedNodes = this->BatchModifiedNodes;
+  this->BatchAddedNodes.clear();
+  this->BatchModifiedNodes.clear();
+  // Nodes are not removed during the batch processing (otherwise the model
+  // would be rebuilt), therefore all the recorded nodes are still in the scene.
+  this->insertNodes(addedNodes);
+  foreach(vtkMRMLNode* modifiedNode, modifiedNodes)
+  {
+    q->updateNodeItems(modifiedNode, QString(modifiedNode->GetID()));
+  }
+}
+
 //------------------------------------------------------------------------------
 QStandardItem* qMRMLSceneModel::insertNode(vtkMRMLNode* node, QStandardItem* parent, int row)
 {
@@ -885,6 +1093,12 @@ QStandardItem* qMRMLSceneModel::insertNode(vtkMRMLNode* node, QStandardItem* par
   return items[0];
 }
 
+//------------------------------------------------------------------------------
+int qMRMLSceneModel::maximumNumberOfNodesToInsert()
+{
+  return 100;
+}
+
 //------------------------------------------------------------------------------
 void qMRMLSceneModel::observeNode(vtkMRMLNode* node)
 {
@@ -1164,6 +1378,12 @@ void qMRMLSceneModel::onMRMLSceneEvent(vtkObject* vtk_obj, unsigned long event,
       Q_ASSERT(node);
       sceneModel->onMRMLSceneNodeRemoved(scene, node);
       break;
+    case vtkMRMLScene::NodesAboutToBeAddedEvent:
+      sceneModel->onMRMLSceneNodesAboutToBeAdded(scene, reinterpret_cast<vtkCollection*>(call_data));
+      break;
+    case vtkMRMLScene::NodesAddedEvent:
+      sceneModel->onMRMLSceneNodesAdded(scene, reinterpret_cast<vtkCollection*>(call_data));
+      break;
     case vtkCommand::DeleteEvent:
       sceneModel->onMRMLSceneDeleted(scene);
       break;
@@ -1209,15 +1429,61 @@ void qMRMLSceneModel::onMRMLSceneNodeAdded(vtkMRMLScene* scene, vtkMRMLNode* nod
   Q_ASSERT(scene == d->MRMLScene);
   Q_ASSERT(vtkMRMLNode::SafeDownCast(node));
 
-  if (d->MRMLScene->IsImporting() || (d->LazyUpdate && d->MRMLScene->IsBatchProcessing()))
+  if (d->MRMLScene->IsImporting())
   {
     // Node IDs and references are not valid until the import is completed, therefore do not attempt
     // to add a node during importing (see https://issues.slicer.org/view.php?id=4080).
     return;
   }
+  if (d->LazyUpdate && d->MRMLScene->IsBatchProcessing())
+  {
+    // The node is inserted when batch processing ends
+    if (!d->BatchUpdateRequired)
+    {
+      d->BatchAddedNodes << node;
+    }
+    return;
+  }
+  if (d->AddingNodes)
+  {
+    // All the nodes are inserted in onMRMLSceneNodesAdded
+    return;
+  }
   this->insertNode(node);
 }
 
+//------------------------------------------------------------------------------
+void qMRMLSceneModel::onMRMLSceneNodesAboutToBeAdded(vtkMRMLScene* scene, vtkCollection* nodes)
+{
+  Q_D(qMRMLSceneModel);
+  Q_UNUSED(scene);
+  Q_UNUSED(nodes);
+  Q_ASSERT(scene == d->MRMLScene);
+  d->AddingNodes = true;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSceneModel::onMRMLSceneNodesAdded(vtkMRMLScene* scene, vtkCollection* nodes)
+{
+  Q_D(qMRMLSceneModel);
+  Q_UNUSED(scene);
+  Q_ASSERT(scene == d->MRMLScene);
+  d->AddingNodes = false;
+  if (!nodes || d->MRMLScene->IsImporting() || (d->LazyUpdate && d->MRMLScene->IsBatchProcessing()))
+  {
+    // The model is updated when the import or batch processing is completed
+    return;
+  }
+  QList<vtkMRMLNode*> addedNodes;
+  vtkMRMLNode* node = nullptr;
+  vtkCollectionSimpleIterator it;
+  for (nodes->InitTraversal(it); (node = vtkMRMLNode::SafeDownCast(nodes->GetNextItemAsObject(it)));)
+  {
+    addedNodes << node;
+  }
+  d->insertNodes(addedNodes);
+}
+
 //------------------------------------------------------------------------------
 void qMRMLSceneModel::onMRMLSceneNodeAboutToBeRemoved(vtkMRMLScene* scene, vtkMRMLNode* node)
 {
@@ -1226,10 +1492,18 @@ void qMRMLSceneModel::onMRMLSceneNodeAboutToBeRemoved(vtkMRMLScene* scene, vtkMR
   Q_UNUSED(scene);
   Q_ASSERT(scene == d->MRMLScene);
 
-  if (d->MRMLScene->IsClosing() || (d->LazyUpdate && d->MRMLScene->IsBatchProcessing()))
+  if (d->MRMLScene->IsClosing())
   {
     return;
   }
+  if (d->LazyUpdate && d->MRMLScene->IsBatchProcessing())
+  {
+    // The model is rebuilt when batch processing ends
+    d->BatchUpdateRequired = true;
+    d->BatchAddedNodes.clear();
+    d->BatchModifiedNodes.clear();
+    return;
+  }
 
   int connectionsRemoved =
     qvtkDisconnect(node, vtkCommand::ModifiedEvent,
@@ -1246,13 +1520,11 @@ void qMRMLSceneModel::onMRMLSceneNodeAboutToBeRemoved(vtkMRMLScene* scene, vtkMR
   // Remove all the observations on the node
   qvtkDisconnect(node, vtkCommand::NoEvent, this, nullptr);
 
-  // TODO: can be fasten by browsing the tree only once
-  QModelIndexList indexes = this->match(this->mrmlSceneIndex(), qMRMLSceneModel::UIDRole,
-                                        QString(node->GetID()), 1,
-                                        Qt::MatchExactly | Qt::MatchRecursive);
-  if (indexes.count())
+  // Row cache is used for finding the node index, browsing the whole tree would be slow for large scenes
+  QModelIndex nodeIndex = this->indexFromNode(node);
+  if (nodeIndex.isValid())
   {
-    QStandardItem* item = this->itemFromIndex(indexes[0].sibling(indexes[0].row(),0));
+    QStandardItem* item = this->itemFromIndex(nodeIndex.sibling(nodeIndex.row(),0));
     // The children may be lost if not reparented, we ensure they got reparented.
     while (item->rowCount())
     {
@@ -1269,8 +1541,9 @@ void qMRMLSceneModel::onMRMLSceneNodeAboutToBeRemoved(vtkMRMLScene* scene, vtkMR
         d->Orphans.removeAll(orphans);
       }
     }
-    this->removeRow(indexes[0].row(), indexes[0].parent());
+    this->removeRow(nodeIndex.row(), nodeIndex.parent());
   }
+  d->RowCache.remove(node);
 }
 
 //------------------------------------------------------------------------------
@@ -1378,10 +1651,28 @@ void qMRMLSceneModel::updateNodeItems(vtkMRMLNode* node, const QString& nodeUID)
 {
   Q_D(qMRMLSceneModel);
 
-  if (d->MRMLScene->IsClosing() || d->MRMLScene->IsImporting() || (d->LazyUpdate && d->MRMLScene->IsBatchProcessing()))
+  if (d->MRMLScene->IsClosing() || d->MRMLScene->IsImporting())
   {
     return;
   }
+  if (d->LazyUpdate && d->MRMLScene->IsBatchProcessing())
+  {
+    // Items are updated when batch processing ends
+    if (d->BatchUpdateRequired || !node || !node->GetScene())
+    {
+      return;
+    }
+    if (nodeUID != QString(node->GetID()))
+    {
+      // The items of the node cannot be found anymore by the new ID
+      d->BatchUpdateRequired = true;
+      d->BatchAddedNodes.clear();
+      d->BatchModifiedNodes.clear();
+      return;
+    }
+    d->BatchModifiedNodes.insert(node);
+    return;
+  }
 
   // If there is no node here or if the node has no scene. that means the node
   // has been removed from the scene but the scene model hasn't been notified
@@ -1395,7 +1686,7 @@ void qMRMLSceneModel::updateNodeItems(vtkMRMLNode* node, const QString& nodeUID)
     return;
   }
   //Q_ASSERT(node->GetScene()->IsNodePresent(node));
-  QModelIndexList nodeIndexes = d->indexes(nodeUID);
+  QModelIndexList nodeIndexes = d->indexes(nodeUID, node);
   //qDebug() << "onMRMLNodeModified" << node->GetID() << nodeIndexes;
   Q_ASSERT(nodeIndexes.count());
   for (int i = 0; i < nodeIndexes.size(); ++i)
@@ -1538,7 +1829,7 @@ void qMRMLSceneModel::onMRMLSceneEndBatchProcess(vtkMRMLScene* scene)
   Q_UNUSED(scene);
   if (d->LazyUpdate)
   {
-    this->updateScene();
+    d->updateBatchProcessedNodes();
     emit sceneUpdated();
   }
 }
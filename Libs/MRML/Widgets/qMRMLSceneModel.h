@@ -31,6 +31,7 @@
 // qMRML includes
 #include "qMRMLWidgetsExport.h"
 
+class vtkCollection;
 class vtkMRMLNode;
 class vtkMRMLScene;
 
@@ -217,12 +218,24 @@ public:
   /// \sa listenNodeModifiedEvent
   virtual void observeNode(vtkMRMLNode* node);
 
+  /// Maximum number of nodes that are inserted one by one after batch processing
+  /// or vtkMRMLScene::AddNodes(). Above this number, the nodes are inserted in blocks of
+  /// consecutive rows under their parent, without calling insertNode() for each node
+  /// (each row insertion is linear in the number of rows in sort filter proxy models).
+  /// Also used by subject hierarchy models.
+  static int maximumNumberOfNodesToInsert();
+
 protected slots:
 
   virtual void onMRMLSceneNodeAboutToBeAdded(vtkMRMLScene* scene, vtkMRMLNode* node);
   virtual void onMRMLSceneNodeAboutToBeRemoved(vtkMRMLScene* scene, vtkMRMLNode* node);
   virtual void onMRMLSceneNodeAdded(vtkMRMLScene* scene, vtkMRMLNode* node);
   virtual void onMRMLSceneNodeRemoved(vtkMRMLScene* scene, vtkMRMLNode* node);
+  /// Called when nodes are added by vtkMRMLScene::AddNodes().
+  /// Per-node added events are ignored while the nodes are added, all the nodes are
+  /// inserted into the model at once.
+  virtual void onMRMLSceneNodesAboutToBeAdded(vtkMRMLScene* scene, vtkCollection* nodes);
+  virtual void onMRMLSceneNodesAdded(vtkMRMLScene* scene, vtkCollection* nodes);
 
   virtual void onMRMLSceneAboutToBeImported(vtkMRMLScene* scene);
   virtual void onMRMLSceneImported(vtkMRMLScene* scene);
@@ -35,12 +35,15 @@
 // Qt includes
 class QStandardItemModel;
 #include <QFlags>
+#include <QHash>
 #include <QMap>
+#include <QSet>
 
 // qMRML includes
 #include "qMRMLSceneModel.h"
 
 // MRML includes
+class vtkMRMLNode;
 class vtkMRMLScene;
 
 // VTK includes
@@ -61,7 +64,10 @@ public:
   virtual ~qMRMLSceneModelPrivate();
   void init();
 
-  QModelIndexList indexes(const QString& nodeID)const;
+  /// Get model indexes of all the columns of a node.
+  /// If \a node is specified and its ID is \a nodeID then the node is looked up
+  /// in the row cache, otherwise the whole tree is searched for \a nodeID.
+  QModelIndexList indexes(const QString& nodeID, vtkMRMLNode* node = nullptr)const;
 
   QStringList extraItems(QStandardItem* parent, const QString& extraType)const;
   void insertExtraItem(int row, QStandardItem* parent,
@@ -78,9 +84,35 @@ public:
   /// qMRMLSceneModel::nodeIndex(vtkMRMLNode*).
   QStandardItem* insertNode(vtkMRMLNode* node, int index);
 
+  /// Insert nodes of the scene that are not in the model yet.
+  /// The index of all the nodes is found in a single scene traversal, instead of one
+  /// traversal per node with qMRMLSceneModel::insertNode(vtkMRMLNode*).
+  /// Above qMRMLSceneModel::maximumNumberOfNodesToInsert() nodes, the nodes are
+  /// inserted in blocks of consecutive rows.
+  void insertNodes(const QList<vtkMRMLNode*>& nodes);
+
+  /// Insert a block of \a nodes that have consecutive indexes under \a parentNode,
+  /// \a firstIndex being the index of the first node.
+  /// Nodes are inserted one by one if the block cannot be inserted at once (parent
+  /// not in the model yet, misplaced or already inserted nodes).
+  void insertNodeBlock(vtkMRMLNode* parentNode, const QList<vtkMRMLNode*>& nodes, int firstIndex);
+
+  /// Update the model after batch processing with lazy update. Nodes added during
+  /// batch processing are inserted and items of modified nodes are updated, the model
+  /// is only rebuilt if nodes were removed or node IDs changed.
+  void updateBatchProcessedNodes();
+
   vtkSmartPointer<vtkCallbackCommand> CallBack;
   qMRMLSceneModel::NodeTypes ListenNodeModifiedEvent;
   bool LazyUpdate;
+  /// Nodes are being added by vtkMRMLScene::AddNodes()
+  bool AddingNodes;
+  /// Nodes added and modified during batch processing with lazy update
+  QList<vtkMRMLNode*> BatchAddedNodes;
+  QSet<vtkMRMLNode*> BatchModifiedNodes;
+  /// The model must be rebuilt at the end of batch processing with lazy update
+  /// (nodes were removed or node IDs changed).
+  bool BatchUpdateRequired;
   int PendingItemModified;
 
   int NameColumn;
@@ -107,7 +139,7 @@ public:
   // not guaranteed to contain up-to-date information, should be just used
   // as a search hint. If the node cannot be found at the given index then
   // we need to browse through all model items.
-  mutable QMap<vtkMRMLNode*,QPersistentModelIndex> RowCache;
+  mutable QHash<vtkMRMLNode*,QPersistentModelIndex> RowCache;
 };
 
 #endif
@@ -27,6 +27,7 @@
 // VTK includes
 #include <vtkMRMLNode.h>
 #include <vtkMRMLScene.h>
+#include <vtkWeakPointer.h>
 
 // -----------------------------------------------------------------------------
 // qMRMLSortFilterProxyModelPrivate
@@ -34,8 +35,17 @@
 // -----------------------------------------------------------------------------
 class qMRMLSortFilterProxyModelPrivate
 {
+  Q_DECLARE_PUBLIC(qMRMLSortFilterProxyModel);
+protected:
+  qMRMLSortFilterProxyModel* const q_ptr;
 public:
-  qMRMLSortFilterProxyModelPrivate();
+  qMRMLSortFilterProxyModelPrivate(qMRMLSortFilterProxyModel& object);
+
+  /// Filter node by NodeTypes, ShowChildNodeTypes, HideChildNodeTypes and Attributes.
+  qMRMLSortFilterProxyModel::AcceptType filterAcceptsNodeType(vtkMRMLNode* node)const;
+
+  /// Remove the node of the item and the nodes of all its children from NodeTypeFilterCache.
+  void removeFromNodeTypeFilterCache(qMRMLSceneModel* sceneModel, QStandardItem* item);
 
   QStringList                      NodeTypes;
   bool                             ShowHidden;
@@ -48,23 +58,122 @@ public:
   typedef QPair<QString, QVariant> AttributeType;
   QHash<QString, AttributeType>    Attributes;
   qMRMLSortFilterProxyModel::FilterType Filter;
+
+  /// Result of filterAcceptsNodeType() for a node. It is valid until the node is modified.
+  struct NodeTypeFilterResult
+  {
+    vtkWeakPointer<vtkMRMLNode> Node;
+    vtkMTimeType MTime{ 0 };
+    qMRMLSortFilterProxyModel::AcceptType Accept{ qMRMLSortFilterProxyModel::Reject };
+  };
+  /// Filtering by node type and attributes is the most expensive part of the filtering
+  /// (and observes the nodes), therefore the result is cached. When the filter is invalidated
+  /// only the nodes that have been modified since the last evaluation need to be processed.
+  /// Must be cleared when NodeTypes, ShowChildNodeTypes, HideChildNodeTypes or Attributes change.
+  /// Nodes are removed from the cache when they are removed from the source model.
+  mutable QHash<vtkMRMLNode*, NodeTypeFilterResult> NodeTypeFilterCache;
 };
 
 // -----------------------------------------------------------------------------
-qMRMLSortFilterProxyModelPrivate::qMRMLSortFilterProxyModelPrivate()
+qMRMLSortFilterProxyModelPrivate::qMRMLSortFilterProxyModelPrivate(qMRMLSortFilterProxyModel& object)
+  : q_ptr(&object)
 {
   this->ShowHidden = false;
   this->ShowChildNodeTypes = true;
   this->Filter = qMRMLSortFilterProxyModel::UseFilters;
 }
 
+// -----------------------------------------------------------------------------
+qMRMLSortFilterProxyModel::AcceptType qMRMLSortFilterProxyModelPrivate
+::filterAcceptsNodeType(vtkMRMLNode* node)const
+{
+  Q_Q(const qMRMLSortFilterProxyModel);
+  foreach(const QString& nodeType, this->NodeTypes)
+  {
+    // filter by node type
+    if (!node->IsA(nodeType.toUtf8().data()))
+    {
+      //std::cout << "Reject node: " << node->GetName() << "(" << node->GetID()
+      //          << ") type: " << typeid(*node).name() <<std::endl;
+      continue;
+    }
+    // filter by excluded child node types
+    if (!this->ShowChildNodeTypes && nodeType != node->GetClassName())
+    {
+      continue;
+    }
+    // filter by HideChildNodeType
+    if (this->ShowChildNodeTypes)
+    {
+      foreach(const QString& hideChildNodeType, this->HideChildNodeTypes)
+      {
+        if (node->IsA(hideChildNodeType.toUtf8().data()))
+        {
+          return qMRMLSortFilterProxyModel::Reject;
+        }
+      }
+    }
+
+    // filter by attributes
+    if (this->Attributes.contains(nodeType))
+    {
+      // can be optimized if the event is AttributeModifiedEvent instead of modifiedevent
+      const_cast<qMRMLSortFilterProxyModel*>(q)->qvtkConnect(
+        node, vtkCommand::ModifiedEvent,
+        const_cast<qMRMLSortFilterProxyModel*>(q),
+        SLOT(invalidate()),0., Qt::UniqueConnection);
+
+      QString attributeName = this->Attributes[nodeType].first;
+      const char *nodeAttribute = node->GetAttribute(attributeName.toUtf8());
+      QString testAttribute = this->Attributes[nodeType].second.toString();
+
+      // fail if the attribute isn't defined on the node at all
+      if (nodeAttribute == nullptr)
+      {
+        return qMRMLSortFilterProxyModel::RejectButPotentiallyAcceptable;
+      }
+      // if the filter value is null, any node attribute value will match
+      if (!this->Attributes[nodeType].second.isNull())
+      {
+        // otherwise, the node and filter attributes have to match
+        if (testAttribute != nodeAttribute)
+        {
+          return qMRMLSortFilterProxyModel::RejectButPotentiallyAcceptable;
+        }
+      }
+    }
+    // Apply filter if any
+    return qMRMLSortFilterProxyModel::AcceptButPotentiallyRejectable;
+  }
+  return qMRMLSortFilterProxyModel::Reject;
+}
+
+// -----------------------------------------------------------------------------
+void qMRMLSortFilterProxyModelPrivate::removeFromNodeTypeFilterCache(
+  qMRMLSceneModel* sceneModel, QStandardItem* item)
+{
+  if (!item)
+  {
+    return;
+  }
+  vtkMRMLNode* node = sceneModel->mrmlNodeFromItem(item);
+  if (node)
+  {
+    this->NodeTypeFilterCache.remove(node);
+  }
+  for (int row = 0; row < item->rowCount(); ++row)
+  {
+    this->removeFromNodeTypeFilterCache(sceneModel, item->child(row));
+  }
+}
+
 // -----------------------------------------------------------------------------
 // qMRMLSortFilterProxyModel
 
 //------------------------------------------------------------------------------
 qMRMLSortFilterProxyModel::qMRMLSortFilterProxyModel(QObject *vparent)
   :QSortFilterProxyModel(vparent)
-  , d_ptr(new qMRMLSortFilterProxyModelPrivate)
+  , d_ptr(new qMRMLSortFilterProxyModelPrivate(*this))
 {
   // For speed issue, we might want to disable the dynamic sorting however
   // when having source models using QStandardItemModel, drag&drop is handled
@@ -134,6 +243,7 @@ void qMRMLSortFilterProxyModel::addAttribute(const QString& nodeType,
   }
   d->Attributes[nodeType] =
     qMRMLSortFilterProxyModelPrivate::AttributeType(attributeName, attributeValue);
+  d->NodeTypeFilterCache.clear();
   this->invalidateFilter();
 }
 
@@ -148,6 +258,7 @@ void qMRMLSortFilterProxyModel::removeAttribute(const QString& nodeType,
     return;
   }
   d->Attributes.remove(nodeType);
+  d->NodeTypeFilterCache.clear();
   this->invalidateFilter();
 }
 
@@ -266,66 +377,17 @@ qMRMLSortFilterProxyModel::AcceptType qMRMLSortFilterProxyModel
     // Apply filter if any
     return AcceptButPotentiallyRejectable;
   }
-  foreach(const QString& nodeType, d->NodeTypes)
+  // Node type and attribute filtering result is reused if the node has not been modified since
+  // it was computed. This makes invalidating the filter in large scenes much faster.
+  qMRMLSortFilterProxyModelPrivate::NodeTypeFilterResult& nodeTypeFilterResult = d->NodeTypeFilterCache[node];
+  if (nodeTypeFilterResult.Node.GetPointer() != node
+    || nodeTypeFilterResult.MTime != node->GetMTime())
   {
-    // filter by node type
-    if (!node->IsA(nodeType.toUtf8().data()))
-    {
-      //std::cout << "Reject node: " << node->GetName() << "(" << node->GetID()
-      //          << ") type: " << typeid(*node).name() <<std::endl;
-      continue;
-    }
-    // filter by excluded child node types
-    if (!d->ShowChildNodeTypes && nodeType != node->GetClassName())
-    {
-      continue;
-    }
-    // filter by HideChildNodeType
-    if (d->ShowChildNodeTypes)
-    {
-      foreach(const QString& hideChildNodeType, d->HideChildNodeTypes)
-      {
-        if (node->IsA(hideChildNodeType.toUtf8().data()))
-        {
-          return Reject;
-        }
-      }
-    }
-
-    // filter by attributes
-    if (d->Attributes.contains(nodeType))
-    {
-      // can be optimized if the event is AttributeModifiedEvent instead of modifiedevent
-      const_cast<qMRMLSortFilterProxyModel*>(this)->qvtkConnect(
-        node, vtkCommand::ModifiedEvent,
-        const_cast<qMRMLSortFilterProxyModel*>(this),
-        SLOT(invalidate()),0., Qt::UniqueConnection);
-
-      QString attributeName = d->Attributes[nodeType].first;
-      const char *nodeAttribute = node->GetAttribute(attributeName.toUtf8());
-      QString nodeAttributeQString = node->GetAttribute(attributeName.toUtf8());
-      QString testAttribute = d->Attributes[nodeType].second.toString();
-
-      //std::cout << "attribute name = " << qPrintable(attributeName) << "\n\ttestAttribute = " << qPrintable(testAttribute) << "\n\t" << node->GetID() << " nodeAttributeQString = " << qPrintable(nodeAttributeQString) << "\n\t\tas char str = " << (nodeAttribute ? nodeAttribute : "null") << "." << std::endl;
-      // fail if the attribute isn't defined on the node at all
-      if (nodeAttribute == nullptr)
-      {
-        return RejectButPotentiallyAcceptable;
-      }
-      // if the filter value is null, any node attribute value will match
-      if (!d->Attributes[nodeType].second.isNull())
-      {
-        // otherwise, the node and filter attributes have to match
-        if (testAttribute != nodeAttribute)
-        {
-          return RejectButPotentiallyAcceptable;
-        }
-      }
-    }
-    // Apply filter if any
-    return AcceptButPotentiallyRejectable;
+    nodeTypeFilterResult.Node = node;
+    nodeTypeFilterResult.MTime = node->GetMTime();
+    nodeTypeFilterResult.Accept = d->filterAcceptsNodeType(node);
   }
-  return Reject;
+  return nodeTypeFilterResult.Accept;
 }
 
 //-----------------------------------------------------------------------------
@@ -351,6 +413,7 @@ void qMRMLSortFilterProxyModel::setHideChildNodeTypes(const QStringList& _nodeTy
     return;
   }
   d->HideChildNodeTypes = _nodeTypes;
+  d->NodeTypeFilterCache.clear();
   this->invalidateFilter();
 }
 
@@ -363,6 +426,7 @@ void qMRMLSortFilterProxyModel::setNodeTypes(const QStringList& _nodeTypes)
     return;
   }
   d->NodeTypes = _nodeTypes;
+  d->NodeTypeFilterCache.clear();
   this->invalidateFilter();
 }
 
@@ -375,6 +439,7 @@ void qMRMLSortFilterProxyModel::setShowChildNodeTypes(bool _show)
     return;
   }
   d->ShowChildNodeTypes = _show;
+  d->NodeTypeFilterCache.clear();
   invalidateFilter();
 }
 
@@ -547,3 +612,37 @@ qMRMLSceneModel* qMRMLSortFilterProxyModel::sceneModel()const
 {
   return qobject_cast<qMRMLSceneModel*>(this->sourceModel());
 }
+
+// --------------------------------------------------------------------------
+void qMRMLSortFilterProxyModel::setSourceModel(QAbstractItemModel* newSourceModel)
+{
+  Q_D(qMRMLSortFilterProxyModel);
+  if (this->sourceModel())
+  {
+    QObject::disconnect(this->sourceModel(), SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)),
+                        this, SLOT(onSourceRowsAboutToBeRemoved(QModelIndex,int,int)));
+  }
+  d->NodeTypeFilterCache.clear();
+  this->Superclass::setSourceModel(newSourceModel);
+  if (newSourceModel)
+  {
+    QObject::connect(newSourceModel, SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)),
+                     this, SLOT(onSourceRowsAboutToBeRemoved(QModelIndex,int,int)));
+  }
+}
+
+// --------------------------------------------------------------------------
+void qMRMLSortFilterProxyModel::onSourceRowsAboutToBeRemoved(const QModelIndex& sourceParent, int first, int last)
+{
+  Q_D(qMRMLSortFilterProxyModel);
+  qMRMLSceneModel* sceneModel = this->sceneModel();
+  QStandardItem* parentItem = this->sourceItem(sourceParent);
+  if (d->NodeTypeFilterCache.isEmpty() || !sceneModel || !parentItem)
+  {
+    return;
+  }
+  for (int row = first; row <= last; ++row)
+  {
+    d->removeFromNodeTypeFilterCache(sceneModel, parentItem->child(row));
+  }
+}
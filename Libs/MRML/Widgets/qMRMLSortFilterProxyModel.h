@@ -216,6 +216,10 @@ public:
   /// Return the scene model used as input if any.
   Q_INVOKABLE qMRMLSceneModel* sceneModel()const;
 
+  /// Reimplemented to forget the cached filtering results of nodes that are
+  /// removed from the source model.
+  void setSourceModel(QAbstractItemModel* sourceModel) override;
+
 public slots:
   /// Set the showHidden flag.
   /// \sa showHidden, showHidden()
@@ -232,6 +236,10 @@ public slots:
   void setHideAll(bool hide);
 
   // TODO Add setMRMLScene() to propagate to the scene model
+
+protected slots:
+  void onSourceRowsAboutToBeRemoved(const QModelIndex& sourceParent, int first, int last);
+
 protected:
   /// This enum type is used to describe the behavior of a node with regard to
   /// filtering:
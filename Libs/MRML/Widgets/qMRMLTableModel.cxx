@@ -22,7 +22,9 @@
 
 // Qt includes
 #include <QApplication>
+#include <QFont>
 #include <QPalette>
+#include <QStandardItem>
 
 // qMRML includes
 #include "qMRMLUtils.h"
@@ -34,10 +36,17 @@
 // VTK includes
 #include <vtkBitArray.h>
 #include <vtkCallbackCommand.h>
+#include <vtkDataArray.h>
+#include <vtkMath.h>
 #include <vtkSmartPointer.h>
 #include <vtkStringArray.h>
 #include <vtkTable.h>
 
+// STD includes
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
 static int UserRoleValueType = Qt::UserRole + 1;
 
 //------------------------------------------------------------------------------
@@ -57,11 +66,50 @@ public:
   static QString columnNameFromIndex(int index);
 
   // Generate tooltip text
-  QString columnTooltipText(int tableCol);
+  QString columnTooltipText(int tableCol)const;
+
+  // Returns the table of the table node or nullptr if there is no table or the table is empty
+  vtkTable* table()const;
+
+  // Get text displayed in a table cell
+  static QString cellText(vtkTable* table, vtkIdType tableRow, vtkIdType tableCol);
+
+  // Returns true if model rows are mapped to table rows through RowIndexMap
+  bool isRowIndexMapUsed()const;
+
+  // Recompute RowIndexMap if it is used and it is not up-to-date
+  void updateRowIndexMap()const;
+
+  // Number of table rows that are displayed (not filtered out)
+  vtkIdType numberOfDisplayedTableRows()const;
+
+  // Get table row index from model row (or model column, if transposed).
+  // Returns -1 for the header row and -2 if the row is out of range.
+  vtkIdType tableRowFromModelRow(int modelRow)const;
+
+  // Compute number of model rows and columns from the current table content
+  void computeModelSize(int& numberOfModelRows, int& numberOfModelColumns)const;
 
   vtkSmartPointer<vtkCallbackCommand> CallBack;
   vtkSmartPointer<vtkMRMLTableNode>   MRMLTableNode;
   bool Transposed;
+
+  // Table node properties that the current model layout is based on
+  bool UseFirstColumnAsRowHeader;
+  bool UseColumnTitleAsColumnHeader;
+
+  // Model size that was last reported to views
+  int NumberOfModelRows;
+  int NumberOfModelColumns;
+
+  // Sorting and filtering
+  QString FilterText;
+  vtkIdType SortTableColumn;
+  Qt::SortOrder SortOrder;
+
+  // Table row index for each displayed data row. Only used if sorting or filtering is enabled.
+  mutable std::vector<vtkIdType> RowIndexMap;
+  mutable bool RowIndexMapValid;
 };
 
 //------------------------------------------------------------------------------
@@ -70,6 +118,13 @@ qMRMLTableModelPrivate::qMRMLTableModelPrivate(qMRMLTableModel& object)
 {
   this->CallBack = vtkSmartPointer<vtkCallbackCommand>::New();
   this->Transposed = false;
+  this->UseFirstColumnAsRowHeader = false;
+  this->UseColumnTitleAsColumnHeader = false;
+  this->NumberOfModelRows = 0;
+  this->NumberOfModelColumns = 0;
+  this->SortTableColumn = -1;
+  this->SortOrder = Qt::AscendingOrder;
+  this->RowIndexMapValid = false;
 }
 
 //------------------------------------------------------------------------------
@@ -87,8 +142,186 @@ void qMRMLTableModelPrivate::init()
   Q_Q(qMRMLTableModel);
   this->CallBack->SetClientData(q);
   this->CallBack->SetCallback(qMRMLTableModel::onMRMLNodeEvent);
-  q->setColumnCount(0);
-  QObject::connect(q, SIGNAL(itemChanged(QStandardItem*)), q, SLOT(onItemChanged(QStandardItem*)), Qt::UniqueConnection);
+}
+
+//------------------------------------------------------------------------------
+vtkTable* qMRMLTableModelPrivate::table()const
+{
+  vtkTable* table = (this->MRMLTableNode ? this->MRMLTableNode->GetTable() : nullptr);
+  if (table == nullptr || table->GetNumberOfColumns() == 0)
+  {
+    return nullptr;
+  }
+  return table;
+}
+
+//------------------------------------------------------------------------------
+QString qMRMLTableModelPrivate::cellText(vtkTable* table, vtkIdType tableRow, vtkIdType tableCol)
+{
+  vtkVariant variant = table->GetValue(tableRow, tableCol);
+  int dataType = table->GetColumn(tableCol)->GetDataType();
+  if (dataType == VTK_CHAR || dataType == VTK_UNSIGNED_CHAR || dataType == VTK_SIGNED_CHAR)
+  {
+    // vtkVariant converts char type to string as a single letter, therefore we need to use
+    // custom converter
+    return QString::number(variant.ToInt());
+  }
+  return QString::fromStdString(variant.ToString());
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLTableModelPrivate::isRowIndexMapUsed()const
+{
+  if (this->Transposed)
+  {
+    return false;
+  }
+  return (this->SortTableColumn >= 0 || !this->FilterText.isEmpty());
+}
+
+//------------------------------------------------------------------------------
+void qMRMLTableModelPrivate::updateRowIndexMap()const
+{
+  if (this->RowIndexMapValid || !this->isRowIndexMapUsed())
+  {
+    return;
+  }
+  this->RowIndexMapValid = true;
+  this->RowIndexMap.clear();
+  vtkTable* table = this->table();
+  if (!table)
+  {
+    return;
+  }
+  vtkIdType numberOfTableRows = table->GetNumberOfRows();
+  vtkIdType numberOfTableColumns = table->GetNumberOfColumns();
+
+  // Filter
+  if (this->FilterText.isEmpty())
+  {
+    this->RowIndexMap.resize(numberOfTableRows);
+    std::iota(this->RowIndexMap.begin(), this->RowIndexMap.end(), 0);
+  }
+  else
+  {
+    for (vtkIdType tableRow = 0; tableRow < numberOfTableRows; ++tableRow)
+    {
+      for (vtkIdType tableCol = 0; tableCol < numberOfTableColumns; ++tableCol)
+      {
+        if (qMRMLTableModelPrivate::cellText(table, tableRow, tableCol).contains(this->FilterText, Qt::CaseInsensitive))
+        {
+          this->RowIndexMap.push_back(tableRow);
+          break;
+        }
+      }
+    }
+  }
+
+  // Sort
+  if (this->SortTableColumn < 0 || this->SortTableColumn >= numberOfTableColumns)
+  {
+    return;
+  }
+  bool ascending = (this->SortOrder == Qt::AscendingOrder);
+  vtkAbstractArray* columnArray = table->GetColumn(this->SortTableColumn);
+  vtkDataArray* dataArray = vtkDataArray::SafeDownCast(columnArray);
+  if (dataArray)
+  {
+    // Numeric column: sort by value of the first component.
+    // NaN values are placed before all other values.
+    std::vector<double> keys(numberOfTableRows);
+    for (vtkIdType tableRow : this->RowIndexMap)
+    {
+      keys[tableRow] = dataArray->GetComponent(tableRow, 0);
+    }
+    std::stable_sort(this->RowIndexMap.begin(), this->RowIndexMap.end(),
+      [&keys, ascending](vtkIdType row1, vtkIdType row2)
+      {
+        double value1 = ascending ? keys[row1] : keys[row2];
+        double value2 = ascending ? keys[row2] : keys[row1];
+        if (vtkMath::IsNan(value1) || vtkMath::IsNan(value2))
+        {
+          return vtkMath::IsNan(value1) && !vtkMath::IsNan(value2);
+        }
+        return value1 < value2;
+      });
+  }
+  else
+  {
+    std::vector<QString> keys(numberOfTableRows);
+    for (vtkIdType tableRow : this->RowIndexMap)
+    {
+      keys[tableRow] = qMRMLTableModelPrivate::cellText(table, tableRow, this->SortTableColumn);
+    }
+    std::stable_sort(this->RowIndexMap.begin(), this->RowIndexMap.end(),
+      [&keys, ascending](vtkIdType row1, vtkIdType row2)
+      {
+        return ascending ? (keys[row1].localeAwareCompare(keys[row2]) < 0)
+          : (keys[row2].localeAwareCompare(keys[row1]) < 0);
+      });
+  }
+}
+
+//------------------------------------------------------------------------------
+vtkIdType qMRMLTableModelPrivate::numberOfDisplayedTableRows()const
+{
+  vtkTable* table = this->table();
+  if (!table)
+  {
+    return 0;
+  }
+  if (!this->isRowIndexMapUsed())
+  {
+    return table->GetNumberOfRows();
+  }
+  if (this->FilterText.isEmpty())
+  {
+    // Sorting does not change the number of rows, no need to compute the row index map yet
+    return table->GetNumberOfRows();
+  }
+  this->updateRowIndexMap();
+  return static_cast<vtkIdType>(this->RowIndexMap.size());
+}
+
+//------------------------------------------------------------------------------
+vtkIdType qMRMLTableModelPrivate::tableRowFromModelRow(int modelRow)const
+{
+  // offset: modelIndex = mrmlIndex - offset
+  vtkIdType tableRowOffset = this->UseColumnTitleAsColumnHeader ? 0 : -1;
+  vtkIdType dataRow = modelRow + tableRowOffset;
+  if (dataRow < 0)
+  {
+    return -1;
+  }
+  if (!this->isRowIndexMapUsed())
+  {
+    return dataRow;
+  }
+  this->updateRowIndexMap();
+  if (dataRow >= static_cast<vtkIdType>(this->RowIndexMap.size()))
+  {
+    return -2;
+  }
+  return this->RowIndexMap[dataRow];
+}
+
+//------------------------------------------------------------------------------
+void qMRMLTableModelPrivate::computeModelSize(int& numberOfModelRows, int& numberOfModelColumns)const
+{
+  numberOfModelRows = 0;
+  numberOfModelColumns = 0;
+  vtkTable* table = this->table();
+  if (!table)
+  {
+    return;
+  }
+  // offset: modelIndex = mrmlIndex - offset
+  vtkIdType tableColOffset = this->UseFirstColumnAsRowHeader ? 1 : 0;
+  vtkIdType tableRowOffset = this->UseColumnTitleAsColumnHeader ? 0 : -1;
+  int numberOfRows = static_cast<int>(this->numberOfDisplayedTableRows() - tableRowOffset);
+  int numberOfColumns = static_cast<int>(table->GetNumberOfColumns() - tableColOffset);
+  numberOfModelRows = this->Transposed ? numberOfColumns : numberOfRows;
+  numberOfModelColumns = this->Transposed ? numberOfRows : numberOfColumns;
 }
 
 //------------------------------------------------------------------------------
@@ -105,9 +338,9 @@ QString qMRMLTableModelPrivate::columnNameFromIndex(int index)
 }
 
 //------------------------------------------------------------------------------
-QString qMRMLTableModelPrivate::columnTooltipText(int tableCol)
+QString qMRMLTableModelPrivate::columnTooltipText(int tableCol)const
 {
-  Q_Q(qMRMLTableModel);
+  Q_Q(const qMRMLTableModel);
   vtkMRMLTableNode* tableNode = q->mrmlTableNode();
   if (tableNode == nullptr)
   {
@@ -178,7 +411,7 @@ QString qMRMLTableModelPrivate::columnTooltipText(int tableCol)
 // qMRMLTableModel
 //------------------------------------------------------------------------------
 qMRMLTableModel::qMRMLTableModel(QObject *_parent)
-  : QStandardItemModel(_parent)
+  : QAbstractTableModel(_parent)
   , d_ptr(new qMRMLTableModelPrivate(*this))
 {
   Q_D(qMRMLTableModel);
@@ -187,7 +420,7 @@ qMRMLTableModel::qMRMLTableModel(QObject *_parent)
 
 //------------------------------------------------------------------------------
 qMRMLTableModel::qMRMLTableModel(qMRMLTableModelPrivate* pimpl, QObject *parentObject)
-  : QStandardItemModel(parentObject)
+  : QAbstractTableModel(parentObject)
   , d_ptr(pimpl)
 {
   Q_D(qMRMLTableModel);
@@ -209,8 +442,13 @@ void qMRMLTableModel::setMRMLTableNode(vtkMRMLTableNode* tableNode)
   {
     tableNode->AddObserver(vtkCommand::ModifiedEvent, d->CallBack);
   }
+  this->beginResetModel();
   d->MRMLTableNode = tableNode;
-  this->updateModelFromMRML();
+  d->UseFirstColumnAsRowHeader = (tableNode ? tableNode->GetUseFirstColumnAsRowHeader() : false);
+  d->UseColumnTitleAsColumnHeader = (tableNode ? tableNode->GetUseColumnTitleAsColumnHeader() : false);
+  d->RowIndexMapValid = false;
+  d->computeModelSize(d->NumberOfModelRows, d->NumberOfModelColumns);
+  this->endResetModel();
 }
 
 //------------------------------------------------------------------------------
@@ -225,355 +463,511 @@ void qMRMLTableModel::updateModelFromMRML()
 {
   Q_D(qMRMLTableModel);
 
-  QObject::disconnect(this, SIGNAL(itemChanged(QStandardItem*)), this, SLOT(onItemChanged(QStandardItem*)));
+  vtkMRMLTableNode* tableNode = d->MRMLTableNode;
+  bool useFirstColumnAsRowHeader = (tableNode ? tableNode->GetUseFirstColumnAsRowHeader() : false);
+  bool useColumnTitleAsColumnHeader = (tableNode ? tableNode->GetUseColumnTitleAsColumnHeader() : false);
 
-  vtkMRMLTableNode* tableNode = vtkMRMLTableNode::SafeDownCast(d->MRMLTableNode);
-  vtkTable* table = (tableNode ? tableNode->GetTable() : nullptr);
-  if (table==nullptr || table->GetNumberOfColumns()==0)
+  if (useFirstColumnAsRowHeader != d->UseFirstColumnAsRowHeader
+    || useColumnTitleAsColumnHeader != d->UseColumnTitleAsColumnHeader)
   {
-    beginResetModel();
-    // setRowCount and setColumnCount to 0 would not be enough, it's necessary to remove the header as well
-    setRowCount(0);
-    setColumnCount(0);
-    endResetModel();
-    QObject::connect(this, SIGNAL(itemChanged(QStandardItem*)), this, SLOT(onItemChanged(QStandardItem*)), Qt::UniqueConnection);
+    // Cells are moved to different model rows or columns, all indices become invalid
+    this->beginResetModel();
+    d->UseFirstColumnAsRowHeader = useFirstColumnAsRowHeader;
+    d->UseColumnTitleAsColumnHeader = useColumnTitleAsColumnHeader;
+    d->RowIndexMapValid = false;
+    d->computeModelSize(d->NumberOfModelRows, d->NumberOfModelColumns);
+    this->endResetModel();
     return;
   }
 
-  bool tableLocked = tableNode->GetLocked();
-  bool labelInFirstTableColumn = tableNode->GetUseFirstColumnAsRowHeader();
-  bool useColumnTitleAsColumnHeader = tableNode->GetUseColumnTitleAsColumnHeader();
+  if (d->isRowIndexMapUsed() && d->RowIndexMapValid)
+  {
+    // Rows are sorted or filtered: only the rows that are filtered out, shown, or moved
+    // by the modification are reported to the views.
+    std::vector<vtkIdType> previousRowIndexMap;
+    previousRowIndexMap.swap(d->RowIndexMap);
+    d->RowIndexMapValid = false;
+    d->updateRowIndexMap();
+    if (d->RowIndexMap != previousRowIndexMap && !this->remapRows(previousRowIndexMap))
+    {
+      this->beginResetModel();
+      d->computeModelSize(d->NumberOfModelRows, d->NumberOfModelColumns);
+      this->endResetModel();
+      return;
+    }
+  }
+  else
+  {
+    // The row index map is computed when the rows are accessed
+    d->RowIndexMapValid = false;
+  }
 
-  vtkIdType numberOfTableColumns = table->GetNumberOfColumns();
-  vtkIdType numberOfTableRows = table->GetNumberOfRows();
-  // offset: modelIndex = mrmlIndex - offset
-  vtkIdType tableColOffset = labelInFirstTableColumn ? 1 : 0;
-  vtkIdType tableRowOffset = useColumnTitleAsColumnHeader ? 0 : -1;
-  if (d->Transposed)
+  // Rows and columns are typically added or removed at the end of the table,
+  // report them as inserted or removed so that views can keep their state (selection, scroll position).
+  int numberOfModelRows = 0;
+  int numberOfModelColumns = 0;
+  d->computeModelSize(numberOfModelRows, numberOfModelColumns);
+  if (numberOfModelRows < d->NumberOfModelRows)
+  {
+    this->beginRemoveRows(QModelIndex(), numberOfModelRows, d->NumberOfModelRows - 1);
+    d->NumberOfModelRows = numberOfModelRows;
+    this->endRemoveRows();
+  }
+  if (numberOfModelColumns < d->NumberOfModelColumns)
+  {
+    this->beginRemoveColumns(QModelIndex(), numberOfModelColumns, d->NumberOfModelColumns - 1);
+    d->NumberOfModelColumns = numberOfModelColumns;
+    this->endRemoveColumns();
+  }
+  if (numberOfModelRows > d->NumberOfModelRows)
+  {
+    this->beginInsertRows(QModelIndex(), d->NumberOfModelRows, numberOfModelRows - 1);
+    d->NumberOfModelRows = numberOfModelRows;
+    this->endInsertRows();
+  }
+  if (numberOfModelColumns > d->NumberOfModelColumns)
+  {
+    this->beginInsertColumns(QModelIndex(), d->NumberOfModelColumns, numberOfModelColumns - 1);
+    d->NumberOfModelColumns = numberOfModelColumns;
+    this->endInsertColumns();
+  }
+
+  // Cell values are read from the table on request, so notifying about
+  // all cells is cheap: views only read the cells that are visible.
+  if (d->NumberOfModelRows > 0 && d->NumberOfModelColumns > 0)
+  {
+    emit dataChanged(this->index(0, 0), this->index(d->NumberOfModelRows - 1, d->NumberOfModelColumns - 1));
+  }
+  if (d->NumberOfModelColumns > 0)
   {
-    setRowCount(static_cast<int>(numberOfTableColumns-tableColOffset));
-    setColumnCount(static_cast<int>(numberOfTableRows-tableRowOffset));
+    emit headerDataChanged(Qt::Horizontal, 0, d->NumberOfModelColumns - 1);
+  }
+  if (d->NumberOfModelRows > 0)
+  {
+    emit headerDataChanged(Qt::Vertical, 0, d->NumberOfModelRows - 1);
+  }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLTableModel::updateMRMLFromModel(QStandardItem* item)
+{
+  qWarning("qMRMLTableModel::updateMRMLFromModel(QStandardItem*) is deprecated, use setData() instead.");
+  if (item == nullptr)
+  {
+    return;
+  }
+  QModelIndex index = this->index(item->row(), item->column());
+  if (!index.isValid())
+  {
+    qWarning("qMRMLTableModel::updateMRMLFromModel failed: item is not in the table (row %d, column %d)",
+      item->row(), item->column());
+    return;
+  }
+  if (item->isCheckable())
+  {
+    this->setData(index, item->checkState(), Qt::CheckStateRole);
   }
   else
   {
-    setRowCount(static_cast<int>(numberOfTableRows-tableRowOffset));
-    setColumnCount(static_cast<int>(numberOfTableColumns-tableColOffset));
+    this->setData(index, item->text(), Qt::EditRole);
   }
+}
 
-  // Setup items for each table column
-  for (vtkIdType tableCol = tableColOffset; tableCol < numberOfTableColumns; ++tableCol)
+//------------------------------------------------------------------------------
+bool qMRMLTableModel::remapRows(const std::vector<vtkIdType>& previousRowIndexMap)
+{
+  Q_D(qMRMLTableModel);
+  // Number of model rows before the first data row (header row)
+  int headerRows = d->UseColumnTitleAsColumnHeader ? 0 : 1;
+  if (static_cast<int>(previousRowIndexMap.size()) + headerRows != d->NumberOfModelRows)
+  {
+    // The previous row index map does not describe the rows that views know about
+    return false;
+  }
+  vtkTable* table = d->table();
+  vtkIdType numberOfTableRows = (table ? table->GetNumberOfRows() : 0);
+  std::vector<char> displayedAfter(numberOfTableRows, 0);
+  for (vtkIdType tableRow : d->RowIndexMap)
   {
-    int modelCol = static_cast<int>(tableCol - tableColOffset);
+    displayedAfter[tableRow] = 1;
+  }
+  // Table rows that are displayed both before and after the modification, in previous order
+  std::vector<char> kept(numberOfTableRows, 0);
+  std::vector<vtkIdType> keptRows;
+  for (vtkIdType tableRow : previousRowIndexMap)
+  {
+    if (tableRow < numberOfTableRows && displayedAfter[tableRow])
+    {
+      kept[tableRow] = 1;
+      keptRows.push_back(tableRow);
+    }
+  }
 
-    QString columnName(table->GetColumnName(tableCol));
-    vtkAbstractArray* columnArray = table->GetColumn(tableCol);
+  // Remove rows that are not displayed anymore, last rows first
+  int dataRow = static_cast<int>(previousRowIndexMap.size()) - 1;
+  while (dataRow >= 0)
+  {
+    vtkIdType tableRow = previousRowIndexMap[dataRow];
+    if (tableRow < numberOfTableRows && kept[tableRow])
+    {
+      --dataRow;
+      continue;
+    }
+    int lastRemovedDataRow = dataRow;
+    while (dataRow >= 0 && (previousRowIndexMap[dataRow] >= numberOfTableRows || !kept[previousRowIndexMap[dataRow]]))
+    {
+      --dataRow;
+    }
+    this->beginRemoveRows(QModelIndex(), dataRow + 1 + headerRows, lastRemovedDataRow + headerRows);
+    d->NumberOfModelRows -= lastRemovedDataRow - dataRow;
+    this->endRemoveRows();
+  }
 
-    // If column title is used as header then the column title is shown in the header,
-    // otherwise the column name is shown in the editable first row of the table.
-    if (useColumnTitleAsColumnHeader)
+  // Move kept rows to their new position (for example, a sorted value was changed)
+  std::vector<vtkIdType> newKeptRows;
+  newKeptRows.reserve(keptRows.size());
+  for (vtkIdType tableRow : d->RowIndexMap)
+  {
+    if (kept[tableRow])
     {
-      QString headerText = QString::fromStdString(tableNode->GetColumnTitle(columnName.toStdString()));
-      if (headerText.isEmpty())
-      {
-        headerText = columnName;
-      }
-      QString units = QString::fromStdString(tableNode->GetColumnUnitLabel(columnName.toStdString()));
-      if (!units.isEmpty())
+      newKeptRows.push_back(tableRow);
+    }
+  }
+  if (newKeptRows != keptRows)
+  {
+    std::vector<int> newKeptPosition(numberOfTableRows, -1);
+    for (size_t keptIndex = 0; keptIndex < newKeptRows.size(); ++keptIndex)
+    {
+      newKeptPosition[newKeptRows[keptIndex]] = static_cast<int>(keptIndex);
+    }
+    emit layoutAboutToBeChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+    QModelIndexList fromIndexes = this->persistentIndexList();
+    QModelIndexList toIndexes;
+    foreach(const QModelIndex& fromIndex, fromIndexes)
+    {
+      int keptIndex = fromIndex.row() - headerRows;
+      if (keptIndex < 0 || keptIndex >= static_cast<int>(keptRows.size()))
       {
-        headerText += " [" + units + "]";
+        // header row
+        toIndexes << fromIndex;
+        continue;
       }
-      setHeaderData(modelCol, d->Transposed ? Qt::Vertical : Qt::Horizontal, headerText);
+      toIndexes << this->createIndex(newKeptPosition[keptRows[keptIndex]] + headerRows, fromIndex.column());
     }
-    else
+    this->changePersistentIndexList(fromIndexes, toIndexes);
+    emit layoutChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+  }
+
+  // Insert rows that are displayed now
+  int numberOfDataRows = static_cast<int>(d->RowIndexMap.size());
+  dataRow = 0;
+  while (dataRow < numberOfDataRows)
+  {
+    if (kept[d->RowIndexMap[dataRow]])
     {
-      QString autoColumnHeader = d->columnNameFromIndex(modelCol);
-      setHeaderData(modelCol, d->Transposed ? Qt::Vertical : Qt::Horizontal, autoColumnHeader);
+      ++dataRow;
+      continue;
     }
-
-    // Go through the rows of the current column
-    for (vtkIdType tableRow = tableRowOffset; tableRow < numberOfTableRows; ++tableRow)
+    int firstInsertedDataRow = dataRow;
+    while (dataRow < numberOfDataRows && !kept[d->RowIndexMap[dataRow]])
     {
-      int modelRow = static_cast<int>(tableRow - tableRowOffset);
+      ++dataRow;
+    }
+    this->beginInsertRows(QModelIndex(), firstInsertedDataRow + headerRows, dataRow - 1 + headerRows);
+    d->NumberOfModelRows += dataRow - firstInsertedDataRow;
+    this->endInsertRows();
+  }
+  return true;
+}
 
-      // Use existing item if already created
-      QStandardItem* existingItem = nullptr;
-      if (d->Transposed)
-      {
-        existingItem = this->item(modelCol, modelRow);
-      }
-      else
-      {
-        existingItem = this->item(modelRow, modelCol);
-      }
-      QStandardItem* item = existingItem;
-      // Create item if did not exist
-      if (item==nullptr)
-      {
-        item = new QStandardItem();
-      }
+//------------------------------------------------------------------------------
+int qMRMLTableModel::rowCount(const QModelIndex& parent)const
+{
+  Q_D(const qMRMLTableModel);
+  if (parent.isValid())
+  {
+    return 0;
+  }
+  return d->NumberOfModelRows;
+}
 
-      // Items in first row use bold font, the others regular
-      if (tableRow>=0)
-      {
-        vtkVariant variant = table->GetValue(tableRow, tableCol);
-        if (tableRow==0)
-        {
-          // the first row might have been bold earlier, make sure
-          // it is reset to non-bold
-          QFont font;
-          item->setData(font, Qt::FontRole);
-        }
+//------------------------------------------------------------------------------
+int qMRMLTableModel::columnCount(const QModelIndex& parent)const
+{
+  Q_D(const qMRMLTableModel);
+  if (parent.isValid())
+  {
+    return 0;
+  }
+  return d->NumberOfModelColumns;
+}
 
-        int dataType = columnArray->GetDataType();
+//------------------------------------------------------------------------------
+QVariant qMRMLTableModel::data(const QModelIndex& index, int role)const
+{
+  Q_D(const qMRMLTableModel);
+  vtkTable* table = d->table();
+  if (!index.isValid() || table == nullptr)
+  {
+    return QVariant();
+  }
+  vtkIdType tableRow = d->tableRowFromModelRow(d->Transposed ? index.column() : index.row());
+  vtkIdType tableCol = this->mrmlTableColumnIndex(index);
+  if (tableRow < -1 || tableRow >= table->GetNumberOfRows()
+    || tableCol < 0 || tableCol >= table->GetNumberOfColumns())
+  {
+    return QVariant();
+  }
 
-        // Set item property for known types.
-        // Special types are defined to be displayed differently, handled by qMRMLTableItemDelegate.
-        // NOTE: The data type itself can be enough, but in future types it will be necessary to define display role
-        //       as well, e.g. double array can be both color and position.
-        if (vtkBitArray::SafeDownCast(columnArray))
-        {
-          // Boolean values indicated by a column of vtkBitArray type are displayed as checkboxes
-          item->setData(VTK_BIT, UserRoleValueType);
-          item->setCheckable(true);
-          item->setCheckState(variant.ToInt() ? Qt::Checked : Qt::Unchecked);
-          item->setText(QString()); // No text is supposed to be in the cell
-        }
-        // Default display as text
-        else
-        {
-          if (dataType == VTK_CHAR || dataType == VTK_UNSIGNED_CHAR || dataType == VTK_SIGNED_CHAR)
-          {
-            // vtkVariant converts char type to string as a single letter, therefore we need to use
-            // custom converter
-            item->setText(QString::number(variant.ToInt()));
-          }
-          else
-          {
-            item->setText(QString(variant.ToString().c_str()));
-          }
-          item->setData(QVariant(), UserRoleValueType);
-          item->setCheckable(false);
-          item->setData(QVariant(), Qt::CheckStateRole);
-        }
-      }
-      else
-      {
-        item->setText(columnName);
-        QFont font;
-        font.setBold(true);
-        item->setData(font, Qt::FontRole);
-      }
+  if (role == Qt::ToolTipRole)
+  {
+    return d->columnTooltipText(static_cast<int>(tableCol));
+  }
 
-      // Handle locked flag
-      if (item->isCheckable())
-      {
-        if (tableLocked)
-        {
-          // Item is view-only, clear the ItemIsUserCheckable flag
-          item->setFlags(item->flags() & (~Qt::ItemIsUserCheckable));
-        }
-        else
-        {
-          // Item is editable, set the ItemIsUserCheckable flag
-          item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
-        }
-        // Item text is empty and should not be editable
-        item->setFlags(item->flags() & (~Qt::ItemIsEditable));
-      }
-      else
-      {
-        if (tableLocked)
-        {
-          // Item is view-only, clear the ItemIsEditable flag
-          item->setFlags(item->flags() & (~Qt::ItemIsEditable));
-        }
-        else
-        {
-          // Item is editable, set the ItemIsEditable flag
-          item->setFlags(item->flags() | Qt::ItemIsEditable);
-        }
-      }
+  if (tableRow < 0)
+  {
+    // Column names are displayed in the first row, in bold
+    if (role == Qt::DisplayRole || role == Qt::EditRole)
+    {
+      return QString(table->GetColumnName(tableCol));
+    }
+    if (role == Qt::FontRole)
+    {
+      QFont font;
+      font.setBold(true);
+      return font;
+    }
+    return QVariant();
+  }
 
-      // Add item if just created
-      if (item!=existingItem)
-      {
-        if (d->Transposed)
-        {
-          setItem(modelCol, modelRow, item);
-        }
-        else
-        {
-          setItem(modelRow, modelCol, item);
-        }
-      }
+  // Set item property for known types.
+  // Special types are defined to be displayed differently, handled by qMRMLTableItemDelegate.
+  // NOTE: The data type itself can be enough, but in future types it will be necessary to define display role
+  //       as well, e.g. double array can be both color and position.
+  bool checkable = (vtkBitArray::SafeDownCast(table->GetColumn(tableCol)) != nullptr);
+  if (role == UserRoleValueType)
+  {
+    return checkable ? QVariant(VTK_BIT) : QVariant();
+  }
+  if (checkable)
+  {
+    // Boolean values indicated by a column of vtkBitArray type are displayed as checkboxes,
+    // no text is supposed to be in the cell
+    if (role == Qt::CheckStateRole)
+    {
+      return table->GetValue(tableRow, tableCol).ToInt() ? Qt::Checked : Qt::Unchecked;
     }
+    return QVariant();
   }
-  // Set row label: either simply 1, 2, ... or values of the first column
-  for (vtkIdType tableRow = tableRowOffset; tableRow < numberOfTableRows; ++tableRow)
+  if (role == Qt::DisplayRole || role == Qt::EditRole)
   {
-    int modelRow = static_cast<int>(tableRow - tableRowOffset);
-    QString rowLabel;
-    if(labelInFirstTableColumn)
+    return qMRMLTableModelPrivate::cellText(table, tableRow, tableCol);
+  }
+  return QVariant();
+}
+
+//------------------------------------------------------------------------------
+Qt::ItemFlags qMRMLTableModel::flags(const QModelIndex& index)const
+{
+  Q_D(const qMRMLTableModel);
+  vtkTable* table = d->table();
+  if (!index.isValid() || table == nullptr)
+  {
+    return Qt::NoItemFlags;
+  }
+  Qt::ItemFlags itemFlags = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+  if (d->MRMLTableNode->GetLocked())
+  {
+    // Item is view-only
+    return itemFlags;
+  }
+  int tableRow = this->mrmlTableRowIndex(index);
+  int tableCol = this->mrmlTableColumnIndex(index);
+  if (tableRow >= 0 && tableCol >= 0 && tableCol < table->GetNumberOfColumns()
+    && vtkBitArray::SafeDownCast(table->GetColumn(tableCol)))
+  {
+    // Item text is empty and should not be editable
+    itemFlags |= Qt::ItemIsUserCheckable;
+  }
+  else
+  {
+    itemFlags |= Qt::ItemIsEditable;
+  }
+  return itemFlags;
+}
+
+//------------------------------------------------------------------------------
+QVariant qMRMLTableModel::headerData(int section, Qt::Orientation orientation, int role)const
+{
+  Q_D(const qMRMLTableModel);
+  vtkTable* table = d->table();
+  if (table == nullptr || section < 0 || role != Qt::DisplayRole)
+  {
+    return this->Superclass::headerData(section, orientation, role);
+  }
+
+  bool tableColumnHeader = ((orientation == Qt::Horizontal) != d->Transposed);
+  if (tableColumnHeader)
+  {
+    // If column title is used as header then the column title is shown in the header,
+    // otherwise the column name is shown in the editable first row of the table.
+    if (!d->UseColumnTitleAsColumnHeader)
     {
-      if (tableRow>=0)
-      {
-        rowLabel = QString(table->GetValue(tableRow, 0).ToString().c_str());
-      }
-      else
-      {
-        rowLabel = QString(table->GetColumnName(0));;
-      }
+      return qMRMLTableModelPrivate::columnNameFromIndex(section);
     }
-    else
+    vtkIdType tableCol = section + (d->UseFirstColumnAsRowHeader ? 1 : 0);
+    if (tableCol >= table->GetNumberOfColumns())
+    {
+      return QVariant();
+    }
+    std::string columnName = table->GetColumnName(tableCol) ? table->GetColumnName(tableCol) : "";
+    QString headerText = QString::fromStdString(d->MRMLTableNode->GetColumnTitle(columnName));
+    if (headerText.isEmpty())
     {
-      rowLabel = QString::number(modelRow+1);
+      headerText = QString::fromStdString(columnName);
     }
-    setHeaderData(modelRow, d->Transposed ? Qt::Horizontal : Qt::Vertical, rowLabel);
+    QString units = QString::fromStdString(d->MRMLTableNode->GetColumnUnitLabel(columnName));
+    if (!units.isEmpty())
+    {
+      headerText += " [" + units + "]";
+    }
+    return headerText;
   }
 
-  // Add tooltip text
-  for (vtkIdType tableCol = tableColOffset; tableCol < numberOfTableColumns; ++tableCol)
+  // Set row label: either simply 1, 2, ... or values of the first column
+  vtkIdType tableRow = d->tableRowFromModelRow(section);
+  if (tableRow < -1 || tableRow >= table->GetNumberOfRows())
   {
-    int modelCol = static_cast<int>(tableCol - tableColOffset);
-    QString tooltipText = d->columnTooltipText(tableCol);
-    for (vtkIdType tableRow = tableRowOffset; tableRow < numberOfTableRows; ++tableRow)
+    return QVariant();
+  }
+  if (d->UseFirstColumnAsRowHeader)
+  {
+    if (tableRow >= 0)
     {
-      int modelRow = static_cast<int>(tableRow - tableRowOffset);
-      QStandardItem* existingItem = nullptr;
-      if (d->Transposed)
-      {
-        existingItem = this->item(modelCol, modelRow);
-      }
-      else
-      {
-        existingItem = this->item(modelRow, modelCol);
-      }
-      existingItem->setToolTip(tooltipText);
+      return QString::fromStdString(table->GetValue(tableRow, 0).ToString());
     }
+    return QString(table->GetColumnName(0));
   }
-
-  QObject::connect(this, SIGNAL(itemChanged(QStandardItem*)), this, SLOT(onItemChanged(QStandardItem*)), Qt::UniqueConnection);
+  // Table row number (it is the same as the model row number if rows are not sorted)
+  vtkIdType tableRowOffset = d->UseColumnTitleAsColumnHeader ? 0 : -1;
+  return QString::number(tableRow - tableRowOffset + 1);
 }
 
 //------------------------------------------------------------------------------
-void qMRMLTableModel::updateMRMLFromModel(QStandardItem* item)
+bool qMRMLTableModel::setData(const QModelIndex& index, const QVariant& value, int role)
 {
   Q_D(qMRMLTableModel);
-  if (item == nullptr)
+  if (!index.isValid())
   {
-    qCritical("qMRMLTableModel::updateMRMLFromModel failed: item is invalid");
-    return;
+    return false;
   }
-  vtkMRMLTableNode* tableNode = vtkMRMLTableNode::SafeDownCast(d->MRMLTableNode);
+  vtkMRMLTableNode* tableNode = d->MRMLTableNode;
   if (tableNode==nullptr)
   {
-    qCritical("qMRMLTableModel::updateMRMLFromModel failed: tableNode is invalid");
-    return;
+    qCritical("qMRMLTableModel::setData failed: tableNode is invalid");
+    return false;
   }
   vtkTable* table = tableNode->GetTable();
   if (table==nullptr)
   {
-    qCritical("qMRMLTableModel::updateMRMLFromModel failed: table is invalid");
-    return;
+    qCritical("qMRMLTableModel::setData failed: table is invalid");
+    return false;
   }
 
-  int tableRow = mrmlTableRowIndex(item->index());
-  int tableCol = mrmlTableColumnIndex(item->index());
+  int tableRow = mrmlTableRowIndex(index);
+  int tableCol = mrmlTableColumnIndex(index);
+  if (tableRow < -1 || tableRow >= table->GetNumberOfRows()
+    || tableCol < 0 || tableCol >= table->GetNumberOfColumns())
+  {
+    return false;
+  }
 
-  if (tableRow>=0)
+  if (tableRow < 0)
   {
-    // Get item value according to type
-    int widgetType = item->data(UserRoleValueType).toInt();
-    if (widgetType == VTK_BIT)
+    // Column header changed
+    if (role != Qt::EditRole)
     {
-      // Cell bool value changed
-      int checked = item->checkState();
-      int valueBefore = table->GetValue(tableRow, tableCol).ToInt();
-      if (checked == valueBefore)
-      {
-        // The value is not changed, this means that the table cannot store this value - revert the value in the table
-        this->blockSignals(true);
-        item->setCheckState(valueBefore ? Qt::Checked : Qt::Unchecked);
-        item->setText(QString()); // No text is supposed to be in the cell
-        this->blockSignals(false);
-      }
-      else
+      return false;
+    }
+    vtkAbstractArray* column = table->GetColumn(tableCol);
+    QString valueBefore = QString::fromStdString(column->GetName()?column->GetName():"");
+    if (valueBefore != value.toString())
+    {
+      tableNode->RenameColumn(tableCol, value.toString().toUtf8().constData());
+    }
+    emit dataChanged(index, index);
+    return true;
+  }
+
+  if (vtkBitArray::SafeDownCast(table->GetColumn(tableCol)))
+  {
+    // Cell bool value changed
+    if (role != Qt::CheckStateRole)
+    {
+      return false;
+    }
+    int checked = (value.toInt() == Qt::Unchecked) ? 0 : 1;
+    int valueBefore = table->GetValue(tableRow, tableCol).ToInt();
+    if (checked != valueBefore)
+    {
+      table->SetValue(tableRow, tableCol, vtkVariant(checked));
+      table->GetColumn(tableCol)->Modified(); // Enable observation of checked state changed separately
+      table->Modified();
+    }
+    emit dataChanged(index, index);
+    return true;
+  }
+
+  if (role != Qt::EditRole)
+  {
+    return false;
+  }
+  // Cell text value changed
+  QString text = value.toString();
+  int dataType = table->GetColumn(tableCol)->GetDataType();
+  if (dataType == VTK_CHAR || dataType == VTK_UNSIGNED_CHAR || dataType == VTK_SIGNED_CHAR)
+  {
+    // vtkVariant would convert char to a letter, so we need custom conversion here
+    bool valid = false;
+    int newValue = text.toInt(&valid);
+    if (dataType == VTK_UNSIGNED_CHAR)
+    {
+      if (newValue < VTK_UNSIGNED_CHAR_MIN || newValue > VTK_UNSIGNED_CHAR_MAX)
       {
-        table->SetValue(tableRow, tableCol, vtkVariant(checked));
-        table->GetColumn(tableCol)->Modified(); // Enable observation of checked state changed separately
-        table->Modified();
+        valid = false;
       }
     }
     else
     {
-      // Cell text value changed
-      int dataType = table->GetColumn(tableCol)->GetDataType();
-      if (dataType == VTK_CHAR || dataType == VTK_UNSIGNED_CHAR || dataType == VTK_SIGNED_CHAR)
+      if (newValue < VTK_SIGNED_CHAR_MIN || newValue > VTK_SIGNED_CHAR_MAX)
       {
-        // vtkVariant would convert char to a letter, so we need custom conversion here
-        bool valid = false;
-        int newValue = item->text().toInt(&valid);
-        if (dataType == VTK_UNSIGNED_CHAR)
-        {
-          if (newValue < VTK_UNSIGNED_CHAR_MIN || newValue > VTK_UNSIGNED_CHAR_MAX)
-          {
-            valid = false;
-          }
-        }
-        else
-        {
-          if (newValue < VTK_SIGNED_CHAR_MIN || newValue > VTK_SIGNED_CHAR_MAX)
-          {
-            valid = false;
-          }
-        }
-        if (valid)
-        {
-          table->SetValue(tableRow, tableCol, newValue);
-          table->Modified();
-        }
-        else
-        {
-          vtkVariant valueInTableBefore = table->GetValue(tableRow, tableCol); // restore this value if new value is invalid
-          this->blockSignals(true);
-          item->setText(QString::number(valueInTableBefore.ToInt()));
-          this->blockSignals(false);
-        }
-      }
-      else
-      {
-        vtkVariant valueInTableBefore = table->GetValue(tableRow, tableCol); // restore this value if new value is invalid
-        vtkVariant itemText(item->text().toUtf8().constData()); // the vtkVariant constructor makes a copy of the input buffer, so using constData is safe
-        table->SetValue(tableRow, tableCol, itemText);
-        vtkVariant valueInTableAfter = table->GetValue(tableRow, tableCol);
-        if (valueInTableBefore == valueInTableAfter)
-        {
-          // The value is not changed then it means it is invalid,
-          // restore previous value
-          this->blockSignals(true);
-          item->setText(QString(valueInTableBefore.ToString().c_str()));
-          this->blockSignals(false);
-        }
-        else
-        {
-          table->Modified();
-        }
+        valid = false;
       }
     }
+    if (!valid)
+    {
+      // the table cannot store this value, keep the previous value
+      return false;
+    }
+    table->SetValue(tableRow, tableCol, newValue);
+    table->Modified();
   }
   else
   {
-    // Column header changed
-    vtkAbstractArray* column = table->GetColumn(tableCol);
-    if (column)
+    vtkVariant valueInTableBefore = table->GetValue(tableRow, tableCol);
+    vtkVariant itemText(text.toUtf8().constData()); // the vtkVariant constructor makes a copy of the input buffer, so using constData is safe
+    table->SetValue(tableRow, tableCol, itemText);
+    vtkVariant valueInTableAfter = table->GetValue(tableRow, tableCol);
+    if (valueInTableBefore == valueInTableAfter)
     {
-      QString valueBefore = QString::fromStdString(column->GetName()?column->GetName():"");
-      if (valueBefore!=item->text())
-      {
-        tableNode->RenameColumn(tableCol, item->text().toUtf8().constData());
-      }
+      // The value is not changed then it means it is invalid,
+      // the previous value is kept
+      return false;
     }
+    table->Modified();
   }
+  emit dataChanged(index, index);
+  return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -605,25 +999,67 @@ void qMRMLTableModel::onMRMLTableNodeModified(vtkObject* node)
 }
 
 //------------------------------------------------------------------------------
-void qMRMLTableModel::onItemChanged(QStandardItem * item)
+void qMRMLTableModel::setTransposed(bool transposed)
 {
-  if (item == this->invisibleRootItem())
+  Q_D(qMRMLTableModel);
+  if (d->Transposed == transposed)
   {
     return;
   }
-  this->updateMRMLFromModel(item);
+  this->beginResetModel();
+  d->Transposed = transposed;
+  d->RowIndexMapValid = false;
+  d->computeModelSize(d->NumberOfModelRows, d->NumberOfModelColumns);
+  this->endResetModel();
 }
 
 //------------------------------------------------------------------------------
-void qMRMLTableModel::setTransposed(bool transposed)
+void qMRMLTableModel::setFilterText(const QString& filterText)
 {
   Q_D(qMRMLTableModel);
-  if (d->Transposed == transposed)
+  if (d->FilterText == filterText)
   {
     return;
   }
-  d->Transposed = transposed;
-  this->updateModelFromMRML();
+  this->beginResetModel();
+  d->FilterText = filterText;
+  d->RowIndexMapValid = false;
+  d->computeModelSize(d->NumberOfModelRows, d->NumberOfModelColumns);
+  this->endResetModel();
+}
+
+//------------------------------------------------------------------------------
+QString qMRMLTableModel::filterText()const
+{
+  Q_D(const qMRMLTableModel);
+  return d->FilterText;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLTableModel::sort(int column, Qt::SortOrder order)
+{
+  Q_D(qMRMLTableModel);
+  vtkIdType sortTableColumn = -1;
+  if (column >= 0)
+  {
+    if (d->Transposed)
+    {
+      qWarning("qMRMLTableModel::sort failed: sorting is not available in transposed mode");
+      return;
+    }
+    sortTableColumn = column + (d->UseFirstColumnAsRowHeader ? 1 : 0);
+  }
+  if (d->SortTableColumn == sortTableColumn && d->SortOrder == order)
+  {
+    return;
+  }
+  // The row index map is computed when the rows are accessed
+  this->beginResetModel();
+  d->SortTableColumn = sortTableColumn;
+  d->SortOrder = order;
+  d->RowIndexMapValid = false;
+  d->computeModelSize(d->NumberOfModelRows, d->NumberOfModelColumns);
+  this->endResetModel();
 }
 
 //------------------------------------------------------------------------------
@@ -642,14 +1078,7 @@ int qMRMLTableModel::mrmlTableRowIndex(QModelIndex modelIndex)const
     qWarning("qMRMLTableModel::mrmlTableRowIndex failed: invalid table node");
     return -1;
   }
-  if (d->Transposed)
-  {
-    return d->MRMLTableNode->GetUseColumnTitleAsColumnHeader() ? modelIndex.column() : modelIndex.column()-1;
-  }
-  else
-  {
-    return d->MRMLTableNode->GetUseColumnTitleAsColumnHeader() ? modelIndex.row() : modelIndex.row()-1;
-  }
+  return static_cast<int>(d->tableRowFromModelRow(d->Transposed ? modelIndex.column() : modelIndex.row()));
 }
 
 //------------------------------------------------------------------------------
@@ -661,14 +1090,8 @@ int qMRMLTableModel::mrmlTableColumnIndex(QModelIndex modelIndex)const
     qWarning("qMRMLTableModel::mrmlTableColumnIndex failed: invalid table node");
     return -1;
   }
-  if (d->Transposed)
-  {
-    return d->MRMLTableNode->GetUseFirstColumnAsRowHeader() ? modelIndex.row()+1 : modelIndex.row();
-  }
-  else
-  {
-    return d->MRMLTableNode->GetUseFirstColumnAsRowHeader() ? modelIndex.column()+1 : modelIndex.column();
-  }
+  int modelColumn = (d->Transposed ? modelIndex.row() : modelIndex.column());
+  return d->UseFirstColumnAsRowHeader ? modelColumn+1 : modelColumn;
 }
 
 //------------------------------------------------------------------------------
@@ -686,6 +1109,11 @@ int qMRMLTableModel::removeSelectionFromMRML(QModelIndexList selection, bool rem
   foreach(index, selection)
   {
     int mrmlIndex = removeMRMLRows ? mrmlTableRowIndex(index) : mrmlTableColumnIndex(index);
+    if (mrmlIndex < -1)
+    {
+      // out of range
+      continue;
+    }
     if (!mrmlIndexList.contains(mrmlIndex))
     {
       // insert unique row/column index only
@@ -712,7 +1140,7 @@ int qMRMLTableModel::removeSelectionFromMRML(QModelIndexList selection, bool rem
               vtkAbstractArray* column = table->GetColumn(columnIndex);
               if (!column)
               {
-                qCritical("qMRMLTableModel::updateMRMLFromModel failed: column %d is invalid", columnIndex);
+                qCritical("qMRMLTableModel::removeSelectionFromMRML failed: column %d is invalid", columnIndex);
                 continue;
               }
               d->MRMLTableNode->RenameColumn(columnIndex, table->GetValue(0, columnIndex).ToString().c_str());
@@ -721,7 +1149,7 @@ int qMRMLTableModel::removeSelectionFromMRML(QModelIndexList selection, bool rem
         }
         else
         {
-          qCritical("qMRMLTableModel::updateMRMLFromModel failed: table is invalid");
+          qCritical("qMRMLTableModel::removeSelectionFromMRML failed: table is invalid");
         }
       }
       else
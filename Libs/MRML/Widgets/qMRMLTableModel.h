@@ -24,7 +24,7 @@
 #define __qMRMLTableModel_h
 
 // Qt includes
-#include <QStandardItemModel>
+#include <QAbstractTableModel>
 
 // CTK includes
 #include <ctkPimpl.h>
@@ -33,19 +33,45 @@
 // qMRML includes
 #include "qMRMLWidgetsExport.h"
 
+// VTK includes
+#include <vtkType.h>
+
+// STD includes
+#include <vector>
+
 class vtkMRMLNode;
 class vtkMRMLTableNode;
 class QAction;
+class QStandardItem;
 
 class qMRMLTableModelPrivate;
 
 //------------------------------------------------------------------------------
-class QMRML_WIDGETS_EXPORT qMRMLTableModel : public QStandardItemModel
+/// \brief Item model that displays the content of a MRML table node.
+///
+/// Cell values are not copied into the model: they are read from the columns
+/// of the vtkTable when the view requests them, therefore the memory usage and
+/// update time of the model does not depend on the size of the table.
+/// When the table node is modified then rows and columns that were added or
+/// removed at the end of the table are reported as inserted or removed,
+/// and all other cells are reported as changed.
+///
+/// Rows of the table can be sorted (see sort()) and filtered (see setFilterText()).
+/// The mapping between model rows and table rows is only computed when sorting
+/// or filtering is enabled and it is recomputed lazily, when the model is accessed
+/// after a table modification. Table modifications while sorting or filtering is
+/// enabled are reported as removed, moved, and inserted rows, the model is not reset.
+///
+/// \note The model used to be a QStandardItemModel. Item-based methods (item(),
+/// setItem(), itemChanged() signal) are not available anymore, use index(),
+/// data(), setData() and the dataChanged() signal instead.
+class QMRML_WIDGETS_EXPORT qMRMLTableModel : public QAbstractTableModel
 {
   Q_OBJECT
   QVTK_OBJECT
   Q_ENUMS(ItemDataRole)
   Q_PROPERTY(bool transposed READ transposed WRITE setTransposed)
+  Q_PROPERTY(QString filterText READ filterText WRITE setFilterText)
 
 public:
   typedef QAbstractItemModel Superclass;
@@ -64,16 +90,40 @@ public:
   void setTransposed(bool transposed);
   bool transposed()const;
 
-  /// Return the VTK table cell associated to the node index.
+  /// Update the MRML table cell at the row and column of the item from the item's
+  /// text or check state.
+  /// \deprecated The model does not use QStandardItem anymore, use setData() instead.
   void updateMRMLFromModel(QStandardItem* item);
 
-  /// Update the entire table from the MRML node
+  /// Update the model from the MRML node.
+  /// Rows and columns added or removed at the end of the table are reported
+  /// as inserted or removed, all other cells are reported as changed.
   void updateModelFromMRML();
 
-  /// Get MRML table index from model index
+  /// Only show table rows that contain the filter text in any of the cells
+  /// (case insensitive). Empty string (default) shows all rows.
+  /// The header row is always shown.
+  void setFilterText(const QString& filterText);
+  QString filterText()const;
+
+  /// Sort the table rows by values of the specified model column.
+  /// Numeric columns are sorted by value, other columns by text.
+  /// If column is -1 then the original order of the table rows is restored.
+  /// Sorting is not available in transposed mode.
+  void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+  int rowCount(const QModelIndex& parent = QModelIndex())const override;
+  int columnCount(const QModelIndex& parent = QModelIndex())const override;
+  QVariant data(const QModelIndex& index, int role = Qt::DisplayRole)const override;
+  bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+  QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole)const override;
+  Qt::ItemFlags flags(const QModelIndex& index)const override;
+
+  /// Get MRML table row index from model index.
+  /// Returns -1 for the header row (if column names are displayed in the first row).
   int mrmlTableRowIndex(QModelIndex modelIndex)const;
 
-  /// Get MRML table index from model index
+  /// Get MRML table column index from model index
   int mrmlTableColumnIndex(QModelIndex modelIndex)const;
 
   /// Delete entire row or column from the MRML table that contains item in the selection.
@@ -84,12 +134,16 @@ public:
 
 protected slots:
   void onMRMLTableNodeModified(vtkObject* node);
-  void onItemChanged(QStandardItem * item);
 
 protected:
 
   qMRMLTableModel(qMRMLTableModelPrivate* pimpl, QObject *parent=nullptr);
 
+  /// Report the difference between the previous and current row index map
+  /// as removed, moved, and inserted rows.
+  /// Returns false if the previous map does not match the current model size.
+  bool remapRows(const std::vector<vtkIdType>& previousRowIndexMap);
+
   static void onMRMLNodeEvent(vtkObject* vtk_obj, unsigned long event,
                               void* client_data, void* call_data);
 protected:
@@ -28,7 +28,6 @@
 #include <QHBoxLayout>
 #include <QMessageBox>
 #include <QKeyEvent>
-#include <QSortFilterProxyModel>
 #include <QString>
 #include <QToolButton>
 
@@ -92,8 +91,10 @@ void qMRMLTableViewPrivate::init()
 {
   Q_Q(qMRMLTableView);
 
+  // Rows are sorted and filtered by the table model, the proxy model only
+  // forwards sort requests to the table model.
   qMRMLTableModel* tableModel = new qMRMLTableModel(q);
-  QSortFilterProxyModel* sortFilterModel = new QSortFilterProxyModel(q);
+  qMRMLTableViewSortFilterProxyModel* sortFilterModel = new qMRMLTableViewSortFilterProxyModel(q);
   sortFilterModel->setSourceModel(tableModel);
   q->setModel(sortFilterModel);
 
@@ -160,6 +161,13 @@ bool qMRMLTableViewPrivate::verifyTableModelAndNode(const char* methodName) cons
   return true;
 }
 
+// --------------------------------------------------------------------------
+QModelIndexList qMRMLTableViewPrivate::selectedTableModelIndexes() const
+{
+  Q_Q(const qMRMLTableView);
+  return q->sortFilterProxyModel()->mapSelectionToSource(q->selectionModel()->selection()).indexes();
+}
+
 // --------------------------------------------------------------------------
 void qMRMLTableViewPrivate::updateWidgetFromViewNode()
 {
@@ -220,7 +228,6 @@ void qMRMLTableView::setMRMLTableNode(vtkMRMLTableNode* node)
   }
 
   mrmlModel->setMRMLTableNode(node);
-  this->sortFilterProxyModel()->invalidate();
 
   this->horizontalHeader()->setMinimumSectionSize(60);
   this->resizeColumnsToContents();
@@ -296,11 +303,12 @@ void qMRMLTableView::copySelection()
     return;
   }
 
-  qMRMLTableModel* mrmlModel = tableModel();
+  // Selection is in the coordinate system of the view model
+  QAbstractItemModel* viewModel = this->model();
   QItemSelectionModel* selection = selectionModel();
   QString textToCopy;
   bool firstLine = true;
-  for (int rowIndex=0; rowIndex<mrmlModel->rowCount(); rowIndex++)
+  for (int rowIndex=0; rowIndex<viewModel->rowCount(); rowIndex++)
   {
     if (!selection->rowIntersectsSelection(rowIndex, QModelIndex()))
     {
@@ -316,7 +324,7 @@ void qMRMLTableView::copySelection()
       textToCopy.append('\n');
     }
     bool firstItemInLine = true;
-    for (int columnIndex=0; columnIndex<mrmlModel->columnCount(); columnIndex++)
+    for (int columnIndex=0; columnIndex<viewModel->columnCount(); columnIndex++)
     {
       if (!selection->columnIntersectsSelection(columnIndex, QModelIndex()))
       {
@@ -331,14 +339,15 @@ void qMRMLTableView::copySelection()
       {
         textToCopy.append('\t');
       }
-      QStandardItem *item = mrmlModel->item(rowIndex, columnIndex);
-      if (item->isCheckable())
+      QModelIndex index = viewModel->index(rowIndex, columnIndex);
+      QVariant checkState = viewModel->data(index, Qt::CheckStateRole);
+      if (checkState.isValid())
       {
-        textToCopy.append(item->checkState() == Qt::Checked ? "1" : "0");
+        textToCopy.append(checkState.toInt() == Qt::Checked ? "1" : "0");
       }
       else
       {
-        textToCopy.append(item->text());
+        textToCopy.append(viewModel->data(index).toString());
       }
     }
   }
@@ -377,12 +386,13 @@ void qMRMLTableView::pasteSelection()
 
   // If there is no selection then paste from top-left
   qMRMLTableModel* mrmlModel = tableModel();
-  int rowIndex = currentIndex().row();
+  QModelIndex currentTableModelIndex = sortFilterProxyModel()->mapToSource(currentIndex());
+  int rowIndex = currentTableModelIndex.row();
   if (rowIndex < 0)
   {
     rowIndex = 0;
   }
-  int startColumnIndex = currentIndex().column();
+  int startColumnIndex = currentTableModelIndex.column();
   if (startColumnIndex < 0)
   {
     startColumnIndex = 0;
@@ -425,16 +435,16 @@ void qMRMLTableView::pasteSelection()
         mrmlModel->updateModelFromMRML();
       }
       // Set values in items
-      QStandardItem* item = mrmlModel->item(rowIndex,columnIndex);
-      if (item != nullptr)
+      QModelIndex index = mrmlModel->index(rowIndex, columnIndex);
+      if (index.isValid())
       {
-        if (item->isCheckable())
+        if (mrmlModel->data(index, Qt::CheckStateRole).isValid())
         {
-          item->setCheckState(cell.toInt() == 0 ? Qt::Unchecked : Qt::Checked);
+          mrmlModel->setData(index, cell.toInt() == 0 ? Qt::Unchecked : Qt::Checked, Qt::CheckStateRole);
         }
         else
         {
-          item->setText(cell);
+          mrmlModel->setData(index, cell, Qt::EditRole);
         }
       }
       else
@@ -674,7 +684,7 @@ void qMRMLTableView::deleteColumn()
 {
   Q_D(qMRMLTableView);
   CTK_CHECK_AND_RETURN_IF_FAIL(d->verifyTableModelAndNode)
-  tableModel()->removeSelectionFromMRML(selectionModel()->selectedIndexes(), false);
+  tableModel()->removeSelectionFromMRML(d->selectedTableModelIndexes(), false);
   clearSelection();
 }
 
@@ -698,7 +708,7 @@ void qMRMLTableView::deleteRow()
 {
   Q_D(qMRMLTableView);
   CTK_CHECK_AND_RETURN_IF_FAIL(d->verifyTableModelAndNode)
-  tableModel()->removeSelectionFromMRML(selectionModel()->selectedIndexes(), true);
+  tableModel()->removeSelectionFromMRML(d->selectedTableModelIndexes(), true);
   clearSelection();
 }
 
@@ -842,8 +852,9 @@ vtkMRMLScene* qMRMLTableView::mrmlScene()const
 //---------------------------------------------------------------------------
 QList<int> qMRMLTableView::selectedMRMLTableColumnIndices()const
 {
+  Q_D(const qMRMLTableView);
   QList<int> mrmlColumnIndexList;
-  QModelIndexList selection = selectionModel()->selectedIndexes();
+  QModelIndexList selection = d->selectedTableModelIndexes();
   qMRMLTableModel* tableModel = this->tableModel();
   QModelIndex index;
   foreach(index, selection)
@@ -58,6 +58,10 @@ public:
   Q_INVOKABLE vtkMRMLTableNode* mrmlTableNode()const;
 
   Q_INVOKABLE qMRMLTableModel* tableModel()const;
+  /// Proxy model that is set on the view, its source model is tableModel().
+  /// The proxy keeps rows in source order: sort() is forwarded to qMRMLTableModel::sort()
+  /// and rows are filtered most efficiently by qMRMLTableModel::setFilterText().
+  /// Indexes of the view (selection, current index) are indexes of this proxy model.
   Q_INVOKABLE QSortFilterProxyModel* sortFilterProxyModel()const;
 
   bool transposed()const;
@@ -35,6 +35,7 @@
 //
 
 // Qt includes
+#include <QSortFilterProxyModel>
 class QToolButton;
 
 // VTK includes
@@ -46,6 +47,7 @@ class QToolButton;
 class ctkPopupWidget;
 
 // qMRML includes
+#include "qMRMLTableModel.h"
 #include "qMRMLTableView.h"
 
 class vtkMRMLTableViewNode;
@@ -56,6 +58,33 @@ class vtkMRMLDoubleArrayNode;
 class vtkObject;
 class vtkStringArray;
 
+//-----------------------------------------------------------------------------
+/// Pass-through sort filter proxy model of the table view.
+/// Sorting is forwarded to qMRMLTableModel::sort(), which computes the row order
+/// lazily, so the proxy itself keeps the rows in source order.
+class qMRMLTableViewSortFilterProxyModel : public QSortFilterProxyModel
+{
+public:
+  qMRMLTableViewSortFilterProxyModel(QObject* parent = nullptr)
+    : QSortFilterProxyModel(parent)
+  {
+    // Rows are not sorted by the proxy, there is no need to re-sort or re-filter
+    // all rows when cells of the table are modified.
+    this->setDynamicSortFilter(false);
+  }
+
+  void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override
+  {
+    qMRMLTableModel* tableModel = qobject_cast<qMRMLTableModel*>(this->sourceModel());
+    if (!tableModel)
+    {
+      this->QSortFilterProxyModel::sort(column, order);
+      return;
+    }
+    tableModel->sort(column, order);
+  }
+};
+
 //-----------------------------------------------------------------------------
 class qMRMLTableViewPrivate: public QObject
 {
@@ -75,6 +104,9 @@ public:
 
   bool verifyTableModelAndNode(const char* methodName) const;
 
+  /// Selected indexes of the view mapped to the table model
+  QModelIndexList selectedTableModelIndexes() const;
+
 public slots:
   /// Handle MRML scene event
   void startProcessing();
@@ -0,0 +1,94 @@
+import unittest
+
+import numpy
+import vtk
+import vtkITK
+from vtk.util import numpy_support as ns
+
+
+class vtkITKImageMarginTest(unittest.TestCase):
+    def setUp(self):
+        # Small segment in a large image, with anisotropic spacing and non-zero extent start
+        self.spacing = [0.7, 1.0, 1.6]
+        shape = (40, 60, 80)  # k, j, i
+        k, j, i = numpy.indices(shape)
+        labels = numpy.zeros(shape, dtype=numpy.uint8)
+        labels[((i - 30) * self.spacing[0]) ** 2 + ((j - 25) * self.spacing[1]) ** 2 + ((k - 20) * self.spacing[2]) ** 2 <= 36] = 1
+        labels[18:22, 20:45, 28:33] = 1
+        # segment touching the image boundary
+        labels[0:3, 0:4, 70:80] = 1
+        self.labels = labels
+
+        self.image = vtk.vtkImageData()
+        self.image.SetExtent(5, 5 + shape[2] - 1, -3, -3 + shape[1] - 1, 2, 2 + shape[0] - 1)
+        self.image.SetSpacing(self.spacing)
+        scalars = ns.numpy_to_vtk(labels.ravel(), deep=True, array_type=vtk.VTK_UNSIGNED_CHAR)
+        self.image.GetPointData().SetScalars(scalars)
+
+    def computeMargin(self, narrowBand, outerMargin, innerMargin=None, inMM=True):
+        margin = vtkITK.vtkITKImageMargin()
+        margin.SetInputData(self.image)
+        margin.SetNarrowBand(narrowBand)
+        margin.SetCalculateMarginInMM(inMM)
+        if inMM:
+            margin.SetOuterMarginMM(outerMargin)
+            if innerMargin is not None:
+                margin.SetInnerMarginMM(innerMargin)
+        else:
+            margin.SetOuterMarginVoxels(outerMargin)
+            if innerMargin is not None:
+                margin.SetInnerMarginVoxels(innerMargin)
+        margin.Update()
+        output = vtk.vtkImageData()
+        output.DeepCopy(margin.GetOutput())
+        return output
+
+    def toArray(self, image):
+        extent = image.GetExtent()
+        shape = (extent[5] - extent[4] + 1, extent[3] - extent[2] + 1, extent[1] - extent[0] + 1)
+        return ns.vtk_to_numpy(image.GetPointData().GetScalars()).reshape(shape)
+
+    def assertNarrowBandMatchesFullImage(self, outerMargin, innerMargin=None, inMM=True):
+        fullResult = self.computeMargin(False, outerMargin, innerMargin, inMM)
+        narrowBandResult = self.computeMargin(True, outerMargin, innerMargin, inMM)
+
+        fullExtent = fullResult.GetExtent()
+        bandExtent = narrowBandResult.GetExtent()
+        self.assertEqual(fullExtent, self.image.GetExtent())
+        for axis in range(3):
+            self.assertGreaterEqual(bandExtent[axis * 2], fullExtent[axis * 2])
+            self.assertLessEqual(bandExtent[axis * 2 + 1], fullExtent[axis * 2 + 1])
+
+        # Inside the band the results are the same, outside the band the full result is empty
+        fullArray = self.toArray(fullResult)
+        bandSlices = tuple(slice(bandExtent[axis * 2] - fullExtent[axis * 2], bandExtent[axis * 2 + 1] - fullExtent[axis * 2] + 1)
+                           for axis in (2, 1, 0))
+        numpy.testing.assert_array_equal(self.toArray(narrowBandResult), fullArray[bandSlices])
+        self.assertEqual(numpy.count_nonzero(fullArray), numpy.count_nonzero(fullArray[bandSlices]))
+        return narrowBandResult
+
+    def test_grow(self):
+        result = self.assertNarrowBandMatchesFullImage(3.0)
+        # The band is much smaller than the input image
+        self.assertLess(result.GetNumberOfPoints(), self.image.GetNumberOfPoints() / 2)
+
+    def test_shrink(self):
+        self.assertNarrowBandMatchesFullImage(-1.5)
+
+    def test_hollow(self):
+        self.assertNarrowBandMatchesFullImage(1.0, -1.0)
+        self.assertNarrowBandMatchesFullImage(0.0, -2.5)
+
+    def test_margin_in_voxels(self):
+        self.assertNarrowBandMatchesFullImage(2.0, inMM=False)
+        self.assertNarrowBandMatchesFullImage(2.0, -1.0, inMM=False)
+
+    def test_empty_input(self):
+        self.labels[:] = 0
+        self.image.GetPointData().GetScalars().Fill(0)
+        result = self.computeMargin(True, 3.0)
+        self.assertEqual(result.GetNumberOfPoints(), 0)
+
+
+if __name__ == "__main__":
+    unittest.main()
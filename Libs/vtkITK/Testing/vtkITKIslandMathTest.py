@@ -0,0 +1,112 @@
+import unittest
+
+import numpy
+import vtk
+import vtkITK
+from vtk.util import numpy_support as ns
+
+
+class vtkITKIslandMathTest(unittest.TestCase):
+    def setUp(self):
+        shape = (30, 40, 50)  # k, j, i
+        k, j, i = numpy.indices(shape)
+        labels = numpy.zeros(shape, dtype=numpy.uint16)
+        # large sphere, a bar that only touches the sphere diagonally, and small islands of equal size
+        labels[(i - 20) ** 2 + (j - 20) ** 2 + (k - 15) ** 2 <= 64] = 3
+        labels[5:8, 5:8, 30:45] = 1
+        labels[8, 8, 45:48] = 2
+        labels[20, 35, 5] = 1
+        labels[25, 35, 5] = 1
+        labels[20, 5, 45:47] = 7
+        # random noise in a corner
+        rng = numpy.random.default_rng(42)
+        labels[20:30, 25:40, 35:50][rng.random((10, 15, 15)) < 0.3] = 5
+        self.labels = labels
+
+        self.image = vtk.vtkImageData()
+        self.image.SetExtent(-5, -5 + shape[2] - 1, 3, 3 + shape[1] - 1, 10, 10 + shape[0] - 1)
+        scalars = ns.numpy_to_vtk(labels.ravel(), deep=True, array_type=vtk.VTK_UNSIGNED_SHORT)
+        self.image.GetPointData().SetScalars(scalars)
+
+    def computeIslands(self, useRunLengthEncoding, fullyConnected, minimumSize=0, generateOutputImage=True):
+        islandMath = vtkITK.vtkITKIslandMath()
+        islandMath.SetInputData(self.image)
+        islandMath.SetUseRunLengthEncoding(useRunLengthEncoding)
+        islandMath.SetFullyConnected(fullyConnected)
+        islandMath.SetMinimumSize(minimumSize)
+        islandMath.SetGenerateOutputImage(generateOutputImage)
+        islandMath.Update()
+        return islandMath
+
+    def toArray(self, image):
+        extent = image.GetExtent()
+        shape = (extent[5] - extent[4] + 1, extent[3] - extent[2] + 1, extent[1] - extent[0] + 1)
+        return ns.vtk_to_numpy(image.GetPointData().GetScalars()).reshape(shape)
+
+    def assertSameAsITK(self, fullyConnected, minimumSize=0):
+        itkIslands = self.computeIslands(False, fullyConnected, minimumSize)
+        runLengthIslands = self.computeIslands(True, fullyConnected, minimumSize)
+        self.assertEqual(runLengthIslands.GetNumberOfIslands(), itkIslands.GetNumberOfIslands())
+        self.assertEqual(runLengthIslands.GetOriginalNumberOfIslands(), itkIslands.GetOriginalNumberOfIslands())
+        numpy.testing.assert_array_equal(self.toArray(runLengthIslands.GetOutput()), self.toArray(itkIslands.GetOutput()))
+        for islandIndex in range(itkIslands.GetNumberOfIslands()):
+            self.assertEqual(runLengthIslands.GetIslandSize(islandIndex), itkIslands.GetIslandSize(islandIndex))
+        return runLengthIslands
+
+    def test_face_connected(self):
+        islands = self.assertSameAsITK(False)
+        self.assertGreater(islands.GetNumberOfIslands(), 6)
+
+    def test_fully_connected(self):
+        islands = self.assertSameAsITK(True)
+        faceConnectedIslands = self.computeIslands(True, False)
+        self.assertLess(islands.GetOriginalNumberOfIslands(), faceConnectedIslands.GetOriginalNumberOfIslands())
+
+    def test_minimum_size(self):
+        islands = self.assertSameAsITK(False, 3)
+        self.assertLess(islands.GetNumberOfIslands(), islands.GetOriginalNumberOfIslands())
+        for islandIndex in range(islands.GetNumberOfIslands()):
+            self.assertGreaterEqual(islands.GetIslandSize(islandIndex), 3)
+
+    def test_island_statistics(self):
+        islands = self.computeIslands(True, False)
+        labelArray = self.toArray(islands.GetOutput())
+        extent = self.image.GetExtent()
+        for islandIndex in range(islands.GetNumberOfIslands()):
+            k, j, i = numpy.nonzero(labelArray == islandIndex + 1)
+            i = i + extent[0]
+            j = j + extent[2]
+            k = k + extent[4]
+            self.assertEqual(islands.GetIslandSize(islandIndex), len(i))
+            if islandIndex > 0:
+                self.assertLessEqual(islands.GetIslandSize(islandIndex), islands.GetIslandSize(islandIndex - 1))
+            islandExtent = [0, -1, 0, -1, 0, -1]
+            self.assertTrue(islands.GetIslandExtent(islandIndex, islandExtent))
+            self.assertEqual(islandExtent, [i.min(), i.max(), j.min(), j.max(), k.min(), k.max()])
+            centroid = [0.0, 0.0, 0.0]
+            self.assertTrue(islands.GetIslandCentroid(islandIndex, centroid))
+            numpy.testing.assert_allclose(centroid, [i.mean(), j.mean(), k.mean()])
+
+    def test_statistics_without_output_image(self):
+        islands = self.computeIslands(True, False)
+        statisticsOnly = self.computeIslands(True, False, generateOutputImage=False)
+        self.assertEqual(statisticsOnly.GetOutput().GetNumberOfPoints(), 0)
+        self.assertEqual(statisticsOnly.GetNumberOfIslands(), islands.GetNumberOfIslands())
+        for islandIndex in range(islands.GetNumberOfIslands()):
+            self.assertEqual(statisticsOnly.GetIslandSize(islandIndex), islands.GetIslandSize(islandIndex))
+            extent = [0, -1, 0, -1, 0, -1]
+            statisticsOnlyExtent = [0, -1, 0, -1, 0, -1]
+            islands.GetIslandExtent(islandIndex, extent)
+            statisticsOnly.GetIslandExtent(islandIndex, statisticsOnlyExtent)
+            self.assertEqual(statisticsOnlyExtent, extent)
+
+    def test_empty_input(self):
+        self.image.GetPointData().GetScalars().Fill(0)
+        islands = self.computeIslands(True, True)
+        self.assertEqual(islands.GetNumberOfIslands(), 0)
+        self.assertEqual(islands.GetOriginalNumberOfIslands(), 0)
+        self.assertEqual(numpy.count_nonzero(self.toArray(islands.GetOutput())), 0)
+
+
+if __name__ == "__main__":
+    unittest.main()
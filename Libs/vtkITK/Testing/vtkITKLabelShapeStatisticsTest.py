@@ -0,0 +1,82 @@
+import unittest
+
+import numpy
+import vtk
+import vtkITK
+from vtk.util import numpy_support as ns
+
+
+class vtkITKLabelShapeStatisticsTest(unittest.TestCase):
+    def setUp(self):
+        # Labelmap with a sphere (label 1), a box (label 2), and scattered voxels (label 7)
+        self.spacing = [0.5, 0.8, 1.2]
+        self.origin = [10.0, -20.0, 5.0]
+        shape = (30, 40, 50)  # k, j, i
+        k, j, i = numpy.indices(shape)
+        labels = numpy.zeros(shape, dtype=numpy.int16)
+        labels[(i - 15) ** 2 + (j - 20) ** 2 + (k - 12) ** 2 <= 25] = 1
+        labels[2:8, 30:38, 35:48] = 2
+        random = numpy.random.RandomState(0)
+        scattered = random.randint(0, shape[0] * shape[1] * shape[2], 50)
+        labels.flat[scattered] = 7
+        self.labels = labels
+
+        self.image = vtk.vtkImageData()
+        self.image.SetDimensions(shape[2], shape[1], shape[0])
+        self.image.SetSpacing(self.spacing)
+        self.image.SetOrigin(self.origin)
+        scalars = ns.numpy_to_vtk(labels.ravel(), deep=True, array_type=vtk.VTK_SHORT)
+        self.image.GetPointData().SetScalars(scalars)
+
+    def computeStatistics(self, parallel):
+        shapeStatistics = vtkITK.vtkITKLabelShapeStatistics()
+        shapeStatistics.SetInputData(self.image)
+        shapeStatistics.SetParallelLabelComputation(parallel)
+        shapeStatistics.ComputeShapeStatisticOn("FeretDiameter")
+        shapeStatistics.ComputeShapeStatisticOn("Perimeter")
+        shapeStatistics.Update()
+        return shapeStatistics
+
+    def voxelPositions(self, labelValue):
+        k, j, i = numpy.nonzero(self.labels == labelValue)
+        return numpy.column_stack((i, j, k)) * self.spacing + self.origin
+
+    def test_statistics(self):
+        shapeStatistics = self.computeStatistics(parallel=True)
+        table = shapeStatistics.GetOutput()
+
+        # Background (label 0 is not background for signed images) and labels are listed in ascending order
+        labelValues = ns.vtk_to_numpy(table.GetColumnByName("LabelValue"))
+        self.assertEqual(list(labelValues), [0, 1, 2, 7])
+
+        centroids = ns.vtk_to_numpy(table.GetColumnByName("Centroid"))
+        feretDiameters = ns.vtk_to_numpy(table.GetColumnByName("FeretDiameter"))
+        for rowIndex, labelValue in enumerate(labelValues):
+            if labelValue == 0:
+                continue
+            positions = self.voxelPositions(labelValue)
+            numpy.testing.assert_allclose(centroids[rowIndex], positions.mean(axis=0), atol=1e-6)
+            differences = positions[:, numpy.newaxis, :] - positions[numpy.newaxis, :, :]
+            expectedFeretDiameter = numpy.sqrt((differences ** 2).sum(axis=2).max())
+            self.assertAlmostEqual(feretDiameters[rowIndex], expectedFeretDiameter, places=6)
+
+        # Computation time is reported for each step
+        stepNames = shapeStatistics.GetComputationStepNames()
+        for stepName in ["LabelExtraction", "ShapeLabelMap", "FeretDiameter"]:
+            self.assertIn(stepName, stepNames)
+            self.assertGreaterEqual(shapeStatistics.GetComputationTime(stepName), 0.0)
+
+    def test_serial_and_parallel_results_match(self):
+        parallelTable = self.computeStatistics(parallel=True).GetOutput()
+        serialTable = self.computeStatistics(parallel=False).GetOutput()
+        self.assertEqual(parallelTable.GetNumberOfColumns(), serialTable.GetNumberOfColumns())
+        for columnIndex in range(parallelTable.GetNumberOfColumns()):
+            parallelColumn = parallelTable.GetColumn(columnIndex)
+            serialColumn = serialTable.GetColumnByName(parallelColumn.GetName())
+            numpy.testing.assert_allclose(ns.vtk_to_numpy(parallelColumn), ns.vtk_to_numpy(serialColumn))
+
+    def runTest(self):
+        self.setUp()
+        self.test_statistics()
+        self.setUp()
+        self.test_serial_and_parallel_results_match()
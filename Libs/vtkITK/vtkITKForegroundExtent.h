@@ -0,0 +1,122 @@
+/*=========================================================================
+
+  Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+==========================================================================*/
+
+#ifndef __vtkITKForegroundExtent_h
+#define __vtkITKForegroundExtent_h
+
+//
+// This file is not part of the vtkITK API. It is only used internally by
+// vtkITK filters to crop their processing region to the foreground.
+//
+
+// VTK includes
+#include <vtkSMPTools.h>
+#include <vtkType.h>
+
+// STD includes
+#include <algorithm>
+#include <vector>
+
+namespace vtkITKForegroundExtent
+{
+
+//----------------------------------------------------------------------------
+/// Compute the bounding box of the voxels that are not equal to the background
+/// value in each slice. Extent of slice k is stored in sliceExtents[4*k]...sliceExtents[4*k+3]
+/// as (iMin, iMax, jMin, jMax), iMin > iMax if the slice has no foreground.
+template <class T>
+class SliceExtentFunctor
+{
+public:
+  SliceExtentFunctor(const T* scalars, const int dims[3], T backgroundValue, std::vector<int>& sliceExtents)
+    : Scalars(scalars)
+    , BackgroundValue(backgroundValue)
+    , SliceExtents(sliceExtents)
+  {
+    std::copy(dims, dims + 3, this->Dims);
+  }
+
+  void operator()(vtkIdType beginSlice, vtkIdType endSlice) const
+  {
+    for (vtkIdType k = beginSlice; k < endSlice; ++k)
+    {
+      int* sliceExtent = &this->SliceExtents[4 * k];
+      sliceExtent[0] = this->Dims[0];
+      sliceExtent[1] = -1;
+      sliceExtent[2] = this->Dims[1];
+      sliceExtent[3] = -1;
+      const T* rowPtr = this->Scalars + k * this->Dims[0] * this->Dims[1];
+      for (int j = 0; j < this->Dims[1]; ++j, rowPtr += this->Dims[0])
+      {
+        // Only the first and last foreground voxels of the row are needed
+        int i0 = 0;
+        while (i0 < this->Dims[0] && rowPtr[i0] == this->BackgroundValue)
+        {
+          ++i0;
+        }
+        if (i0 == this->Dims[0])
+        {
+          continue;
+        }
+        int i1 = this->Dims[0] - 1;
+        while (rowPtr[i1] == this->BackgroundValue)
+        {
+          --i1;
+        }
+        sliceExtent[0] = std::min(sliceExtent[0], i0);
+        sliceExtent[1] = std::max(sliceExtent[1], i1);
+        sliceExtent[2] = std::min(sliceExtent[2], j);
+        sliceExtent[3] = j;
+      }
+    }
+  }
+
+private:
+  const T* Scalars;
+  vtkIdType Dims[3];
+  T BackgroundValue;
+  std::vector<int>& SliceExtents;
+};
+
+//----------------------------------------------------------------------------
+/// Compute the bounding box of the voxels that are not equal to the background value.
+/// Slices are processed in parallel. \a foregroundExtent is relative to the first voxel of the image.
+/// Returns false if the image has no foreground voxel.
+template <class T>
+bool ComputeForegroundExtent(const T* scalars, const int dims[3], T backgroundValue, int foregroundExtent[6])
+{
+  std::vector<int> sliceExtents(4 * static_cast<size_t>(std::max(dims[2], 0)));
+  SliceExtentFunctor<T> sliceExtentFunctor(scalars, dims, backgroundValue, sliceExtents);
+  vtkSMPTools::For(0, dims[2], sliceExtentFunctor);
+  foregroundExtent[0] = dims[0];
+  foregroundExtent[1] = -1;
+  foregroundExtent[2] = dims[1];
+  foregroundExtent[3] = -1;
+  foregroundExtent[4] = dims[2];
+  foregroundExtent[5] = -1;
+  for (int k = 0; k < dims[2]; ++k)
+  {
+    const int* sliceExtent = &sliceExtents[4 * k];
+    if (sliceExtent[0] > sliceExtent[1])
+    {
+      continue;
+    }
+    foregroundExtent[0] = std::min(foregroundExtent[0], sliceExtent[0]);
+    foregroundExtent[1] = std::max(foregroundExtent[1], sliceExtent[1]);
+    foregroundExtent[2] = std::min(foregroundExtent[2], sliceExtent[2]);
+    foregroundExtent[3] = std::max(foregroundExtent[3], sliceExtent[3]);
+    foregroundExtent[4] = std::min(foregroundExtent[4], k);
+    foregroundExtent[5] = k;
+  }
+  return foregroundExtent[4] <= foregroundExtent[5];
+}
+
+} // namespace vtkITKForegroundExtent
+
+#endif
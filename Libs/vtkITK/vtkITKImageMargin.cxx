@@ -19,21 +19,32 @@
 ==============================================================================*/
 
 /// vtkITK includes
+#include "vtkITKForegroundExtent.h"
 #include "vtkITKImageMargin.h"
 
 /// VTK includes
 #include <vtkAlgorithm.h>
 #include <vtkDataArray.h>
 #include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
 #include <vtkMath.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
+#include <vtkSMPTools.h>
 
 /// ITK includes
 #include <itkBinaryThresholdImageFilter.h>
 #include <itkCommand.h>
+#include <itkNumericTraits.h>
 #include <itkSignedMaurerDistanceMapImageFilter.h>
 
+/// STD includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
 vtkStandardNewMacro(vtkITKImageMargin);
 
 //----------------------------------------------------------------------------
@@ -50,6 +61,7 @@ vtkITKImageMargin::~vtkITKImageMargin() = default;
 void vtkITKImageMargin::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "NarrowBand: " << (this->NarrowBand ? "true" : "false") << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -143,6 +155,369 @@ void vtkITKImageMarginExecute(vtkITKImageMargin *self, vtkImageData* input,
   }
 }
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Squared Euclidean distance transform of a sampled function along a line
+/// (lower envelope of parabolas, see Felzenszwalb and Huttenlocher, "Distance Transforms of Sampled Functions").
+/// \param f input values, infinite at positions that are not feature points
+/// \param weight squared sample spacing
+/// \param d output squared distance
+/// \param v, z work buffers of size n and n+1
+void SquaredDistanceTransform1D(const double* f, int n, double weight, double* d, int* v, double* z)
+{
+  const double inf = std::numeric_limits<double>::infinity();
+  int k = -1;
+  for (int q = 0; q < n; q++)
+  {
+    if (f[q] == inf)
+    {
+      continue;
+    }
+    double s = -inf;
+    while (k >= 0)
+    {
+      s = ((f[q] + weight * q * q) - (f[v[k]] + weight * v[k] * v[k])) / (2.0 * weight * (q - v[k]));
+      if (s > z[k])
+      {
+        break;
+      }
+      k--;
+    }
+    k++;
+    v[k] = q;
+    z[k] = (k == 0 ? -inf : s);
+    z[k + 1] = inf;
+  }
+  if (k < 0)
+  {
+    // no feature points in this line
+    std::fill(d, d + n, inf);
+    return;
+  }
+  k = 0;
+  for (int q = 0; q < n; q++)
+  {
+    while (z[k + 1] < q)
+    {
+      k++;
+    }
+    d[q] = weight * (q - v[k]) * (q - v[k]) + f[v[k]];
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Compute squared distance transform along one axis of a volume, in place.
+class SquaredDistanceTransformAlongAxis
+{
+public:
+  SquaredDistanceTransformAlongAxis(std::vector<double>& distances, const int dims[3], int axis, double spacing)
+    : Distances(distances)
+    , Axis(axis)
+    , Weight(spacing * spacing)
+  {
+    std::copy(dims, dims + 3, this->Dims);
+    vtkIdType increments[3] = { 1, dims[0], static_cast<vtkIdType>(dims[0]) * dims[1] };
+    this->LineIncrement = increments[axis];
+    // The other two axes enumerate the lines
+    this->OuterAxes[0] = (axis + 1) % 3;
+    this->OuterAxes[1] = (axis + 2) % 3;
+    this->OuterIncrements[0] = increments[this->OuterAxes[0]];
+    this->OuterIncrements[1] = increments[this->OuterAxes[1]];
+  }
+
+  vtkIdType GetNumberOfLines() const
+  {
+    return static_cast<vtkIdType>(this->Dims[this->OuterAxes[0]]) * this->Dims[this->OuterAxes[1]];
+  }
+
+  void operator()(vtkIdType beginLine, vtkIdType endLine) const
+  {
+    int n = this->Dims[this->Axis];
+    std::vector<double> f(n);
+    std::vector<double> d(n);
+    std::vector<int> v(n);
+    std::vector<double> z(n + 1);
+    for (vtkIdType line = beginLine; line < endLine; line++)
+    {
+      vtkIdType lineStart = (line % this->Dims[this->OuterAxes[0]]) * this->OuterIncrements[0]
+        + (line / this->Dims[this->OuterAxes[0]]) * this->OuterIncrements[1];
+      double* values = this->Distances.data() + lineStart;
+      for (int q = 0; q < n; q++)
+      {
+        f[q] = values[q * this->LineIncrement];
+      }
+      SquaredDistanceTransform1D(f.data(), n, this->Weight, d.data(), v.data(), z.data());
+      for (int q = 0; q < n; q++)
+      {
+        values[q * this->LineIncrement] = d[q];
+      }
+    }
+  }
+
+private:
+  std::vector<double>& Distances;
+  int Dims[3];
+  int Axis;
+  int OuterAxes[2];
+  vtkIdType LineIncrement;
+  vtkIdType OuterIncrements[2];
+  double Weight;
+};
+
+//----------------------------------------------------------------------------
+/// Initialize distances in the narrow band: 0 at foreground voxels that have a background voxel
+/// in their 26-neighborhood (same boundary definition as in itk::SignedMaurerDistanceMapImageFilter),
+/// infinity elsewhere.
+template <class T>
+class InitializeBoundaryFunctor
+{
+public:
+  InitializeBoundaryFunctor(const T* scalars, const int dims[3], const int bandExtent[6], T backgroundValue, std::vector<double>& distances)
+    : Scalars(scalars)
+    , BackgroundValue(backgroundValue)
+    , Distances(distances)
+  {
+    std::copy(dims, dims + 3, this->Dims);
+    std::copy(bandExtent, bandExtent + 6, this->BandExtent);
+  }
+
+  bool IsBoundary(int i, int j, int k) const
+  {
+    for (int nk = std::max(k - 1, 0); nk <= std::min(k + 1, this->Dims[2] - 1); nk++)
+    {
+      for (int nj = std::max(j - 1, 0); nj <= std::min(j + 1, this->Dims[1] - 1); nj++)
+      {
+        const T* row = this->Scalars + (static_cast<vtkIdType>(nk) * this->Dims[1] + nj) * this->Dims[0];
+        for (int ni = std::max(i - 1, 0); ni <= std::min(i + 1, this->Dims[0] - 1); ni++)
+        {
+          if (row[ni] == this->BackgroundValue)
+          {
+            return true;
+          }
+        }
+      }
+    }
+    return false;
+  }
+
+  void operator()(vtkIdType beginSlice, vtkIdType endSlice) const
+  {
+    const double inf = std::numeric_limits<double>::infinity();
+    int bandDims[2] = { this->BandExtent[1] - this->BandExtent[0] + 1, this->BandExtent[3] - this->BandExtent[2] + 1 };
+    for (vtkIdType bandK = beginSlice; bandK < endSlice; bandK++)
+    {
+      int k = static_cast<int>(bandK) + this->BandExtent[4];
+      double* distance = this->Distances.data() + bandK * bandDims[0] * bandDims[1];
+      for (int j = this->BandExtent[2]; j <= this->BandExtent[3]; j++)
+      {
+        const T* voxel = this->Scalars + (static_cast<vtkIdType>(k) * this->Dims[1] + j) * this->Dims[0] + this->BandExtent[0];
+        for (int i = this->BandExtent[0]; i <= this->BandExtent[1]; i++, voxel++, distance++)
+        {
+          *distance = (*voxel != this->BackgroundValue && this->IsBoundary(i, j, k)) ? 0.0 : inf;
+        }
+      }
+    }
+  }
+
+private:
+  const T* Scalars;
+  int Dims[3];
+  int BandExtent[6];
+  T BackgroundValue;
+  std::vector<double>& Distances;
+};
+
+//----------------------------------------------------------------------------
+/// Threshold signed squared distances (negative inside the foreground) in the narrow band.
+template <class T>
+class ThresholdBandFunctor
+{
+public:
+  ThresholdBandFunctor(const T* scalars, const int dims[3], const int bandExtent[6], T backgroundValue,
+    const std::vector<double>& distances, double lowerThreshold, double upperThreshold, T* outPtr)
+    : Scalars(scalars)
+    , BackgroundValue(backgroundValue)
+    , Distances(distances)
+    , LowerThreshold(lowerThreshold)
+    , UpperThreshold(upperThreshold)
+    , OutPtr(outPtr)
+  {
+    std::copy(dims, dims + 3, this->Dims);
+    std::copy(bandExtent, bandExtent + 6, this->BandExtent);
+  }
+
+  void operator()(vtkIdType beginSlice, vtkIdType endSlice) const
+  {
+    const T insideValue = itk::NumericTraits<T>::max();
+    const T outsideValue = itk::NumericTraits<T>::ZeroValue();
+    vtkIdType bandSliceSize = static_cast<vtkIdType>(this->BandExtent[1] - this->BandExtent[0] + 1)
+      * (this->BandExtent[3] - this->BandExtent[2] + 1);
+    for (vtkIdType bandK = beginSlice; bandK < endSlice; bandK++)
+    {
+      int k = static_cast<int>(bandK) + this->BandExtent[4];
+      const double* distance = this->Distances.data() + bandK * bandSliceSize;
+      T* outVoxel = this->OutPtr + bandK * bandSliceSize;
+      for (int j = this->BandExtent[2]; j <= this->BandExtent[3]; j++)
+      {
+        const T* voxel = this->Scalars + (static_cast<vtkIdType>(k) * this->Dims[1] + j) * this->Dims[0] + this->BandExtent[0];
+        for (int i = this->BandExtent[0]; i <= this->BandExtent[1]; i++, voxel++, distance++, outVoxel++)
+        {
+          double signedDistance = (*voxel != this->BackgroundValue ? -(*distance) : *distance);
+          *outVoxel = (signedDistance >= this->LowerThreshold && signedDistance <= this->UpperThreshold) ? insideValue : outsideValue;
+        }
+      }
+    }
+  }
+
+private:
+  const T* Scalars;
+  int Dims[3];
+  int BandExtent[6];
+  T BackgroundValue;
+  const std::vector<double>& Distances;
+  double LowerThreshold;
+  double UpperThreshold;
+  T* OutPtr;
+};
+
+} // namespace
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkITKImageMarginNarrowBandExecute(vtkITKImageMargin *self, vtkImageData* input, vtkImageData* output, T* inPtr)
+{
+  int inExt[6] = { 0, -1, 0, -1, 0, -1 };
+  input->GetExtent(inExt);
+  int dims[3] = { 0, 0, 0 };
+  input->GetDimensions(dims);
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  double innerMarginDistance = self->GetInnerMarginVoxels();
+  double outerMarginDistance = self->GetOuterMarginVoxels();
+  if (self->GetCalculateMarginInMM())
+  {
+    input->GetSpacing(spacing);
+    innerMarginDistance = self->GetInnerMarginMM();
+    outerMarginDistance = self->GetOuterMarginMM();
+  }
+  T backgroundValue = static_cast<T>(self->GetBackgroundValue());
+
+  // Bounding box of the foreground
+  int foregroundExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (!vtkITKForegroundExtent::ComputeForegroundExtent(inPtr, dims, backgroundValue, foregroundExtent))
+  {
+    // No foreground, the output is empty
+    output->SetExtent(0, -1, 0, -1, 0, -1);
+    output->AllocateScalars(input->GetScalarType(), 1);
+    return;
+  }
+
+  // The band contains the foreground and all voxels that are closer to it than the outer margin,
+  // plus one voxel so that all neighbors of foreground voxels are available.
+  int bandExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  for (int axis = 0; axis < 3; axis++)
+  {
+    int padding = 1;
+    if (outerMarginDistance > 0.0)
+    {
+      padding += static_cast<int>(std::ceil(outerMarginDistance / spacing[axis]));
+    }
+    bandExtent[axis * 2] = std::max(0, foregroundExtent[axis * 2] - padding);
+    bandExtent[axis * 2 + 1] = std::min(dims[axis] - 1, foregroundExtent[axis * 2 + 1] + padding);
+  }
+  int bandDims[3] = { bandExtent[1] - bandExtent[0] + 1, bandExtent[3] - bandExtent[2] + 1, bandExtent[5] - bandExtent[4] + 1 };
+
+  // Squared distance from the foreground boundary
+  std::vector<double> distances(static_cast<size_t>(bandDims[0]) * bandDims[1] * bandDims[2]);
+  InitializeBoundaryFunctor<T> initializeBoundaryFunctor(inPtr, dims, bandExtent, backgroundValue, distances);
+  vtkSMPTools::For(0, bandDims[2], initializeBoundaryFunctor);
+  for (int axis = 0; axis < 3; axis++)
+  {
+    SquaredDistanceTransformAlongAxis distanceTransform(distances, bandDims, axis, spacing[axis]);
+    vtkSMPTools::For(0, distanceTransform.GetNumberOfLines(), distanceTransform);
+  }
+
+  // Output (extent is relative to the input extent)
+  output->SetExtent(inExt[0] + bandExtent[0], inExt[0] + bandExtent[1],
+    inExt[2] + bandExtent[2], inExt[2] + bandExtent[3],
+    inExt[4] + bandExtent[4], inExt[4] + bandExtent[5]);
+  output->AllocateScalars(input->GetScalarType(), 1);
+  T* outPtr = static_cast<T*>(output->GetScalarPointer());
+
+  // Use the same thresholds as sdfMargin
+  innerMarginDistance -= std::numeric_limits<double>::epsilon();
+  outerMarginDistance += std::numeric_limits<double>::epsilon();
+  double lowerThreshold = vtkMath::NegInf();
+  if (innerMarginDistance > vtkMath::NegInf())
+  {
+    lowerThreshold = innerMarginDistance * std::abs(innerMarginDistance);
+  }
+  double upperThreshold = outerMarginDistance * std::abs(outerMarginDistance);
+  ThresholdBandFunctor<T> thresholdFunctor(inPtr, dims, bandExtent, backgroundValue, distances, lowerThreshold, upperThreshold, outPtr);
+  vtkSMPTools::For(0, bandDims[2], thresholdFunctor);
+}
+
+//----------------------------------------------------------------------------
+int vtkITKImageMargin::RequestData(vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  if (!this->NarrowBand)
+  {
+    return this->Superclass::RequestData(request, inputVector, outputVector);
+  }
+
+  // Output extent is determined by the foreground extent, therefore the output is
+  // not allocated here (unlike in the superclass).
+  vtkImageData* input = vtkImageData::GetData(inputVector[0]);
+  vtkImageData* output = vtkImageData::GetData(outputVector);
+  if (!input || !output)
+  {
+    vtkErrorMacro(<< "Invalid input or output");
+    return 0;
+  }
+  int inExt[6] = { 0, -1, 0, -1, 0, -1 };
+  input->GetExtent(inExt);
+  if (inExt[1] < inExt[0] || inExt[3] < inExt[2] || inExt[5] < inExt[4])
+  {
+    return 1;
+  }
+  this->NarrowBandExecute(input, output);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkITKImageMargin::NarrowBandExecute(vtkImageData* input, vtkImageData* output)
+{
+  vtkDebugMacro(<< "Executing Image Margin in narrow band");
+
+  if (this->GetInnerMarginMM() > this->GetOuterMarginMM())
+  {
+    vtkErrorMacro(<< "Outer margin must be greater than inner margin");
+  }
+
+  vtkDataArray* inScalars = (input->GetPointData() ? input->GetPointData()->GetScalars() : nullptr);
+  if (inScalars == nullptr)
+  {
+    vtkErrorMacro(<< "Scalars must be defined for image margin");
+    return;
+  }
+  if (inScalars->GetNumberOfComponents() != 1)
+  {
+    vtkErrorMacro(<< "Only single component images supported.");
+    return;
+  }
+
+  void* inPtr = input->GetScalarPointer();
+  switch (inScalars->GetDataType())
+  {
+    vtkTemplateMacro(vtkITKImageMarginNarrowBandExecute(this, input, output, static_cast<VTK_TT*>(inPtr)));
+    default:
+    {
+      vtkErrorMacro(<< "Unsupported scalar type for narrow band image margin.");
+    }
+  }
+}
+
 //----------------------------------------------------------------------------
 void vtkITKImageMargin::SimpleExecute(vtkImageData *input, vtkImageData *output)
 {
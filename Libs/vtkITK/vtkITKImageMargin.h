@@ -69,6 +69,17 @@ class VTK_ITK_EXPORT vtkITKImageMargin : public vtkSimpleImageToImageFilter
   vtkGetMacro(InnerMarginVoxels, double);
   vtkSetMacro(InnerMarginVoxels, double);
 
+  /// If enabled then distances are only computed in the bounding box of the foreground,
+  /// padded by the outer margin, using an exact separable Euclidean distance transform.
+  /// The output image extent is limited to this region (voxels outside of it would be
+  /// all background), so computation time and memory usage are proportional to the size
+  /// of the foreground instead of the size of the input image.
+  /// Results are the same as without the narrow band, within the output extent.
+  /// Default value is false.
+  vtkGetMacro(NarrowBand, bool);
+  vtkSetMacro(NarrowBand, bool);
+  vtkBooleanMacro(NarrowBand, bool);
+
 protected:
   int BackgroundValue{0};
   bool CalculateMarginInMM{true};
@@ -76,13 +87,19 @@ protected:
   double InnerMarginMM{0.0};
   double OuterMarginVoxels{0.0};
   double InnerMarginVoxels{0.0};
+  bool NarrowBand{false};
 
 protected:
   vtkITKImageMargin();
   ~vtkITKImageMargin() override;
 
+  int RequestData(vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector) override;
   void SimpleExecute(vtkImageData* input, vtkImageData* output) override;
 
+  /// Compute the margin in the narrow band around the foreground.
+  /// Output extent is set and output scalars are allocated in this method.
+  void NarrowBandExecute(vtkImageData* input, vtkImageData* output);
+
 private:
   vtkITKImageMargin(const vtkITKImageMargin&) = delete;
   void operator=(const vtkITKImageMargin&) = delete;
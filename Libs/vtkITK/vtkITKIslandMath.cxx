@@ -7,6 +7,7 @@
 
 ==========================================================================*/
 
+#include "vtkITKForegroundExtent.h"
 #include "vtkITKIslandMath.h"
 #include "vtkObjectFactory.h"
 
@@ -14,15 +15,333 @@
 #include "vtkPointData.h"
 #include "vtkImageData.h"
 #include "vtkAlgorithm.h"
+#include <vtkInformationVector.h>
+#include <vtkSMPTools.h>
 #include <vtkVersion.h>
 
 #include "itkConnectedComponentImageFilter.h"
 #include "itkRelabelComponentImageFilter.h"
 #include "itkCommand.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkITKIslandMath);
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Size, bounding box and centroid of an island
+struct IslandStatistics
+{
+  vtkIdType Size{0};
+  int Extent[6]{ VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN };
+  double Sum[3]{ 0.0, 0.0, 0.0 };
+
+  void AddRun(int i0, int i1, int j, int k)
+  {
+    vtkIdType length = i1 - i0 + 1;
+    this->Size += length;
+    this->Extent[0] = std::min(this->Extent[0], i0);
+    this->Extent[1] = std::max(this->Extent[1], i1);
+    this->Extent[2] = std::min(this->Extent[2], j);
+    this->Extent[3] = std::max(this->Extent[3], j);
+    this->Extent[4] = std::min(this->Extent[4], k);
+    this->Extent[5] = std::max(this->Extent[5], k);
+    this->Sum[0] += 0.5 * (static_cast<double>(i0) + i1) * length;
+    this->Sum[1] += static_cast<double>(j) * length;
+    this->Sum[2] += static_cast<double>(k) * length;
+  }
+};
+
+//----------------------------------------------------------------------------
+/// Horizontal run of consecutive foreground voxels in an image row.
+/// Begin and End (inclusive) are voxel indices within the row.
+struct IslandRun
+{
+  int Begin;
+  int End;
+};
+
+//----------------------------------------------------------------------------
+/// Run-length encoded foreground of the cropped input image.
+/// Runs are stored in raster order. Runs of row (j, k) are Runs[RowOffsets[row]] ... Runs[RowOffsets[row+1]-1],
+/// where row = k * Dimensions[1] + j (j, k are relative to the cropped extent).
+struct IslandRunLengthImage
+{
+  int Extent[6]{ 0, -1, 0, -1, 0, -1 };
+  int Dimensions[3]{ 0, 0, 0 };
+  std::vector<vtkIdType> RowOffsets;
+  std::vector<IslandRun> Runs;
+
+  vtkIdType GetRow(int j, int k) const
+  {
+    return static_cast<vtkIdType>(k) * this->Dimensions[1] + j;
+  }
+};
+
+//----------------------------------------------------------------------------
+/// Extract runs of non-zero voxels of each slice of the cropped region.
+template <class T>
+class IslandRunExtractionFunctor
+{
+public:
+  IslandRunExtractionFunctor(const T* inPtr, const int inDims[3], IslandRunLengthImage& runLengthImage,
+    std::vector<std::vector<IslandRun> >& sliceRuns)
+    : InPtr(inPtr)
+    , RunLengthImage(runLengthImage)
+    , SliceRuns(sliceRuns)
+  {
+    std::copy(inDims, inDims + 3, this->InDims);
+  }
+
+  void operator()(vtkIdType beginSlice, vtkIdType endSlice) const
+  {
+    const int* cropExtent = this->RunLengthImage.Extent;
+    const int* cropDims = this->RunLengthImage.Dimensions;
+    for (vtkIdType k = beginSlice; k < endSlice; ++k)
+    {
+      std::vector<IslandRun>& runs = this->SliceRuns[k];
+      for (int j = 0; j < cropDims[1]; ++j)
+      {
+        const T* rowPtr = this->InPtr + cropExtent[0]
+          + (j + cropExtent[2]) * this->InDims[0]
+          + (k + cropExtent[4]) * this->InDims[0] * this->InDims[1];
+        size_t numberOfRunsBefore = runs.size();
+        int i = 0;
+        while (i < cropDims[0])
+        {
+          if (rowPtr[i] == 0)
+          {
+            ++i;
+            continue;
+          }
+          IslandRun run;
+          run.Begin = i;
+          while (i < cropDims[0] && rowPtr[i] != 0)
+          {
+            ++i;
+          }
+          run.End = i - 1;
+          runs.push_back(run);
+        }
+        // Number of runs is stored for now, converted to offsets later
+        this->RunLengthImage.RowOffsets[this->RunLengthImage.GetRow(j, static_cast<int>(k)) + 1] =
+          static_cast<vtkIdType>(runs.size() - numberOfRunsBefore);
+      }
+    }
+  }
+
+private:
+  const T* InPtr;
+  vtkIdType InDims[3];
+  IslandRunLengthImage& RunLengthImage;
+  std::vector<std::vector<IslandRun> >& SliceRuns;
+};
+
+//----------------------------------------------------------------------------
+/// Union-find of runs. Parent of a run always has a smaller or equal index,
+/// therefore the root of each island is its first run in raster order.
+class IslandRunUnionFind
+{
+public:
+  IslandRunUnionFind(const IslandRunLengthImage& runLengthImage, bool fullyConnected)
+    : RunLengthImage(runLengthImage)
+    , Tolerance(fullyConnected ? 1 : 0)
+    , FullyConnected(fullyConnected)
+  {
+    this->Parent.resize(runLengthImage.Runs.size());
+    for (size_t runIndex = 0; runIndex < this->Parent.size(); ++runIndex)
+    {
+      this->Parent[runIndex] = static_cast<vtkIdType>(runIndex);
+    }
+  }
+
+  vtkIdType Find(vtkIdType runIndex)
+  {
+    while (this->Parent[runIndex] != runIndex)
+    {
+      this->Parent[runIndex] = this->Parent[this->Parent[runIndex]];
+      runIndex = this->Parent[runIndex];
+    }
+    return runIndex;
+  }
+
+  void Union(vtkIdType runIndex1, vtkIdType runIndex2)
+  {
+    vtkIdType root1 = this->Find(runIndex1);
+    vtkIdType root2 = this->Find(runIndex2);
+    if (root1 < root2)
+    {
+      this->Parent[root2] = root1;
+    }
+    else if (root2 < root1)
+    {
+      this->Parent[root1] = root2;
+    }
+  }
+
+  /// Merge touching runs of two rows
+  void ConnectRows(vtkIdType row, vtkIdType neighborRow)
+  {
+    vtkIdType runIndex = this->RunLengthImage.RowOffsets[row];
+    const vtkIdType rowEnd = this->RunLengthImage.RowOffsets[row + 1];
+    vtkIdType neighborRunIndex = this->RunLengthImage.RowOffsets[neighborRow];
+    const vtkIdType neighborRowEnd = this->RunLengthImage.RowOffsets[neighborRow + 1];
+    const std::vector<IslandRun>& runs = this->RunLengthImage.Runs;
+    while (runIndex < rowEnd && neighborRunIndex < neighborRowEnd)
+    {
+      const IslandRun& run = runs[runIndex];
+      const IslandRun& neighborRun = runs[neighborRunIndex];
+      if (run.Begin <= neighborRun.End + this->Tolerance && neighborRun.Begin <= run.End + this->Tolerance)
+      {
+        this->Union(runIndex, neighborRunIndex);
+      }
+      // Runs in a row are separated by at least one background voxel, therefore
+      // the run that ends first cannot touch any further runs of the other row.
+      if (run.End < neighborRun.End)
+      {
+        ++runIndex;
+      }
+      else
+      {
+        ++neighborRunIndex;
+      }
+    }
+  }
+
+  /// Merge runs of a slice with the previous row in the same slice
+  /// and optionally with the rows of the previous slice.
+  void ConnectSlice(int k, bool connectToPreviousSlice)
+  {
+    const int* dims = this->RunLengthImage.Dimensions;
+    for (int j = 0; j < dims[1]; ++j)
+    {
+      vtkIdType row = this->RunLengthImage.GetRow(j, k);
+      if (this->RunLengthImage.RowOffsets[row] == this->RunLengthImage.RowOffsets[row + 1])
+      {
+        // empty row
+        continue;
+      }
+      if (j > 0)
+      {
+        this->ConnectRows(row, this->RunLengthImage.GetRow(j - 1, k));
+      }
+      if (!connectToPreviousSlice || k == 0)
+      {
+        continue;
+      }
+      this->ConnectRows(row, this->RunLengthImage.GetRow(j, k - 1));
+      if (this->FullyConnected)
+      {
+        if (j > 0)
+        {
+          this->ConnectRows(row, this->RunLengthImage.GetRow(j - 1, k - 1));
+        }
+        if (j + 1 < dims[1])
+        {
+          this->ConnectRows(row, this->RunLengthImage.GetRow(j + 1, k - 1));
+        }
+      }
+    }
+  }
+
+  std::vector<vtkIdType> Parent;
+
+private:
+  const IslandRunLengthImage& RunLengthImage;
+  const int Tolerance;
+  const bool FullyConnected;
+};
+
+//----------------------------------------------------------------------------
+/// Label runs of slabs (ranges of consecutive slices) independently.
+/// Runs of different slabs are not connected, therefore slabs can be processed in parallel.
+class IslandSlabLabelingFunctor
+{
+public:
+  IslandSlabLabelingFunctor(IslandRunUnionFind& unionFind, const std::vector<int>& slabStartSlices)
+    : UnionFind(unionFind)
+    , SlabStartSlices(slabStartSlices)
+  {
+  }
+
+  void operator()(vtkIdType beginSlab, vtkIdType endSlab) const
+  {
+    for (vtkIdType slab = beginSlab; slab < endSlab; ++slab)
+    {
+      int slabStartSlice = this->SlabStartSlices[slab];
+      for (int k = slabStartSlice; k < this->SlabStartSlices[slab + 1]; ++k)
+      {
+        this->UnionFind.ConnectSlice(k, k > slabStartSlice);
+      }
+    }
+  }
+
+private:
+  IslandRunUnionFind& UnionFind;
+  const std::vector<int>& SlabStartSlices;
+};
+
+//----------------------------------------------------------------------------
+/// Write island label of each run into the output image.
+template <class T>
+class IslandOutputFunctor
+{
+public:
+  IslandOutputFunctor(T* outPtr, const int outDims[3], const IslandRunLengthImage& runLengthImage,
+    const std::vector<vtkIdType>& runIslands, const std::vector<unsigned long>& islandLabels)
+    : OutPtr(outPtr)
+    , RunLengthImage(runLengthImage)
+    , RunIslands(runIslands)
+    , IslandLabels(islandLabels)
+  {
+    std::copy(outDims, outDims + 3, this->OutDims);
+  }
+
+  void operator()(vtkIdType beginSlice, vtkIdType endSlice) const
+  {
+    const int* cropExtent = this->RunLengthImage.Extent;
+    const int* cropDims = this->RunLengthImage.Dimensions;
+    for (vtkIdType k = beginSlice; k < endSlice; ++k)
+    {
+      for (int j = 0; j < cropDims[1]; ++j)
+      {
+        T* rowPtr = this->OutPtr + cropExtent[0]
+          + (j + cropExtent[2]) * this->OutDims[0]
+          + (k + cropExtent[4]) * this->OutDims[0] * this->OutDims[1];
+        vtkIdType row = this->RunLengthImage.GetRow(j, static_cast<int>(k));
+        for (vtkIdType runIndex = this->RunLengthImage.RowOffsets[row]; runIndex < this->RunLengthImage.RowOffsets[row + 1]; ++runIndex)
+        {
+          const IslandRun& run = this->RunLengthImage.Runs[runIndex];
+          T label = static_cast<T>(this->IslandLabels[this->RunIslands[runIndex]]);
+          std::fill(rowPtr + run.Begin, rowPtr + run.End + 1, label);
+        }
+      }
+    }
+  }
+
+private:
+  T* OutPtr;
+  vtkIdType OutDims[3];
+  const IslandRunLengthImage& RunLengthImage;
+  const std::vector<vtkIdType>& RunIslands;
+  const std::vector<unsigned long>& IslandLabels;
+};
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+class vtkITKIslandMath::vtkInternal
+{
+public:
+  /// Statistics of islands, in the order of island labels
+  std::vector<IslandStatistics> Islands;
+};
+
 vtkITKIslandMath::vtkITKIslandMath()
+  : Internal(new vtkInternal())
 {
   this->FullyConnected = 0;
   this->SliceBySlice = 0;
@@ -33,7 +352,11 @@ vtkITKIslandMath::vtkITKIslandMath()
 
 }
 
-vtkITKIslandMath::~vtkITKIslandMath() = default;
+vtkITKIslandMath::~vtkITKIslandMath()
+{
+  delete this->Internal;
+  this->Internal = nullptr;
+}
 
 void vtkITKIslandMath::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -45,6 +368,68 @@ void vtkITKIslandMath::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "MaximumSize: " << MaximumSize << std::endl;
   os << indent << "NumberOfIslands: " << NumberOfIslands << std::endl;
   os << indent << "OriginalNumberOfIslands: " << OriginalNumberOfIslands << std::endl;
+  os << indent << "UseRunLengthEncoding: " << (UseRunLengthEncoding ? "true" : "false") << std::endl;
+  os << indent << "GenerateOutputImage: " << (GenerateOutputImage ? "true" : "false") << std::endl;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkITKIslandMath::GetIslandSize(unsigned long islandIndex)
+{
+  if (islandIndex >= this->Internal->Islands.size())
+  {
+    vtkErrorMacro("GetIslandSize: invalid island index " << islandIndex);
+    return 0;
+  }
+  return this->Internal->Islands[islandIndex].Size;
+}
+
+//----------------------------------------------------------------------------
+bool vtkITKIslandMath::GetIslandExtent(unsigned long islandIndex, int extent[6])
+{
+  if (islandIndex >= this->Internal->Islands.size())
+  {
+    vtkErrorMacro("GetIslandExtent: invalid island index " << islandIndex);
+    return false;
+  }
+  std::copy(this->Internal->Islands[islandIndex].Extent, this->Internal->Islands[islandIndex].Extent + 6, extent);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkITKIslandMath::GetIslandCentroid(unsigned long islandIndex, double centroid_IJK[3])
+{
+  if (islandIndex >= this->Internal->Islands.size())
+  {
+    vtkErrorMacro("GetIslandCentroid: invalid island index " << islandIndex);
+    return false;
+  }
+  const IslandStatistics& island = this->Internal->Islands[islandIndex];
+  for (int i = 0; i < 3; ++i)
+  {
+    centroid_IJK[i] = island.Sum[i] / island.Size;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkITKIslandMath::RequestData(vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  if (this->GenerateOutputImage)
+  {
+    return this->Superclass::RequestData(request, inputVector, outputVector);
+  }
+
+  // Only island statistics are computed, the output image is not allocated
+  vtkImageData* input = vtkImageData::GetData(inputVector[0]);
+  vtkImageData* output = vtkImageData::GetData(outputVector);
+  if (!input || !output)
+  {
+    vtkErrorMacro(<< "Invalid input or output");
+    return 0;
+  }
+  output->Initialize();
+  this->SimpleExecute(input, output);
+  return 1;
 }
 
 // Note: local function not method - conforms to signature in itkCommand.h
@@ -60,14 +445,179 @@ void vtkITKIslandMathHandleProgressEvent (itk::Object *caller,
   }
 };
 
+//----------------------------------------------------------------------------
+template <class T>
+void vtkITKIslandMathRunLengthExecute(vtkITKIslandMath *self, vtkImageData* input,
+                T* inPtr, T* outPtr, std::vector<IslandStatistics>& islands)
+{
+  int inExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  input->GetExtent(inExtent);
+  int dims[3] = { 0, 0, 0 };
+  input->GetDimensions(dims);
+
+  // Crop to the bounding box of the foreground
+  IslandRunLengthImage runLengthImage;
+  int* cropExtent = runLengthImage.Extent;
+  // cropExtent is empty if there is no foreground
+  vtkITKForegroundExtent::ComputeForegroundExtent(inPtr, dims, static_cast<T>(0), cropExtent);
+  if (outPtr)
+  {
+    std::fill(outPtr, outPtr + static_cast<size_t>(dims[0]) * dims[1] * dims[2], static_cast<T>(0));
+  }
+  if (cropExtent[4] > cropExtent[5])
+  {
+    // empty image
+    self->SetNumberOfIslands(0);
+    self->SetOriginalNumberOfIslands(0);
+    return;
+  }
+  for (int i = 0; i < 3; ++i)
+  {
+    runLengthImage.Dimensions[i] = cropExtent[2 * i + 1] - cropExtent[2 * i] + 1;
+  }
+  self->UpdateProgress(0.1);
+
+  // Run-length encoding
+  const int* cropDims = runLengthImage.Dimensions;
+  runLengthImage.RowOffsets.resize(static_cast<size_t>(cropDims[1]) * cropDims[2] + 1, 0);
+  std::vector<std::vector<IslandRun> > sliceRuns(cropDims[2]);
+  IslandRunExtractionFunctor<T> runExtractionFunctor(inPtr, dims, runLengthImage, sliceRuns);
+  vtkSMPTools::For(0, cropDims[2], runExtractionFunctor);
+  for (size_t row = 1; row < runLengthImage.RowOffsets.size(); ++row)
+  {
+    runLengthImage.RowOffsets[row] += runLengthImage.RowOffsets[row - 1];
+  }
+  runLengthImage.Runs.reserve(runLengthImage.RowOffsets.back());
+  for (std::vector<IslandRun>& runs : sliceRuns)
+  {
+    runLengthImage.Runs.insert(runLengthImage.Runs.end(), runs.begin(), runs.end());
+    std::vector<IslandRun>().swap(runs);
+  }
+  self->UpdateProgress(0.4);
+
+  // Label slabs in parallel, then merge islands along slab boundaries
+  IslandRunUnionFind unionFind(runLengthImage, self->GetFullyConnected() != 0);
+  int numberOfSlabs = std::min(cropDims[2], 4 * std::max(1, vtkSMPTools::GetEstimatedNumberOfThreads()));
+  std::vector<int> slabStartSlices(numberOfSlabs + 1);
+  for (int slab = 0; slab <= numberOfSlabs; ++slab)
+  {
+    slabStartSlices[slab] = static_cast<int>(static_cast<vtkIdType>(slab) * cropDims[2] / numberOfSlabs);
+  }
+  IslandSlabLabelingFunctor slabLabelingFunctor(unionFind, slabStartSlices);
+  vtkSMPTools::For(0, numberOfSlabs, 1, slabLabelingFunctor);
+  for (int slab = 1; slab < numberOfSlabs; ++slab)
+  {
+    // Only connect to the previous slice, in-slice connections are already done
+    int k = slabStartSlices[slab];
+    for (int j = 0; j < cropDims[1]; ++j)
+    {
+      vtkIdType row = runLengthImage.GetRow(j, k);
+      if (runLengthImage.RowOffsets[row] == runLengthImage.RowOffsets[row + 1])
+      {
+        continue;
+      }
+      unionFind.ConnectRows(row, runLengthImage.GetRow(j, k - 1));
+      if (self->GetFullyConnected())
+      {
+        if (j > 0)
+        {
+          unionFind.ConnectRows(row, runLengthImage.GetRow(j - 1, k - 1));
+        }
+        if (j + 1 < cropDims[1])
+        {
+          unionFind.ConnectRows(row, runLengthImage.GetRow(j + 1, k - 1));
+        }
+      }
+    }
+  }
+  self->UpdateProgress(0.7);
+
+  // Assign island index to each run. Islands are numbered in raster order of their first voxel
+  // (same as the connected component labels in ITK). Since the parent of a run always precedes
+  // the run, a single pass is enough and the parent array can be reused for storing island indices.
+  std::vector<vtkIdType>& runIslands = unionFind.Parent;
+  vtkIdType numberOfIslands = 0;
+  for (vtkIdType runIndex = 0; runIndex < static_cast<vtkIdType>(runIslands.size()); ++runIndex)
+  {
+    vtkIdType parent = runIslands[runIndex];
+    runIslands[runIndex] = (parent == runIndex ? numberOfIslands++ : runIslands[parent]);
+  }
+
+  // Island statistics
+  std::vector<IslandStatistics> allIslands(numberOfIslands);
+  for (int k = 0; k < cropDims[2]; ++k)
+  {
+    for (int j = 0; j < cropDims[1]; ++j)
+    {
+      vtkIdType row = runLengthImage.GetRow(j, k);
+      for (vtkIdType runIndex = runLengthImage.RowOffsets[row]; runIndex < runLengthImage.RowOffsets[row + 1]; ++runIndex)
+      {
+        const IslandRun& run = runLengthImage.Runs[runIndex];
+        allIslands[runIslands[runIndex]].AddRun(
+          run.Begin + cropExtent[0] + inExtent[0], run.End + cropExtent[0] + inExtent[0],
+          j + cropExtent[2] + inExtent[2], k + cropExtent[4] + inExtent[4]);
+      }
+    }
+  }
+
+  // Sort by size (same order as in itk::RelabelComponentImageFilter) and remove small islands
+  std::vector<vtkIdType> sortedIslands(numberOfIslands);
+  for (vtkIdType islandIndex = 0; islandIndex < numberOfIslands; ++islandIndex)
+  {
+    sortedIslands[islandIndex] = islandIndex;
+  }
+  std::sort(sortedIslands.begin(), sortedIslands.end(), [&allIslands](vtkIdType a, vtkIdType b)
+    {
+      if (allIslands[a].Size != allIslands[b].Size)
+      {
+        return allIslands[a].Size > allIslands[b].Size;
+      }
+      return a < b;
+    });
+  std::vector<unsigned long> islandLabels(numberOfIslands, 0);
+  islands.clear();
+  for (vtkIdType islandIndex : sortedIslands)
+  {
+    if (allIslands[islandIndex].Size < self->GetMinimumSize())
+    {
+      break;
+    }
+    islands.push_back(allIslands[islandIndex]);
+    islandLabels[islandIndex] = static_cast<unsigned long>(islands.size());
+  }
+  self->SetNumberOfIslands(static_cast<unsigned long>(islands.size()));
+  self->SetOriginalNumberOfIslands(static_cast<unsigned long>(numberOfIslands));
+  self->UpdateProgress(0.8);
+
+  if (outPtr)
+  {
+    IslandOutputFunctor<T> outputFunctor(outPtr, dims, runLengthImage, runIslands, islandLabels);
+    vtkSMPTools::For(0, cropDims[2], outputFunctor);
+  }
+  self->UpdateProgress(1.0);
+}
+
+//----------------------------------------------------------------------------
 template <class T>
 void vtkITKIslandMathExecute(vtkITKIslandMath *self, vtkImageData* input,
                 vtkImageData* vtkNotUsed(output),
-                T* inPtr, T* outPtr)
+                T* inPtr, T* outPtr, std::vector<IslandStatistics>& islands)
 {
-
+  islands.clear();
   int dims[3];
   input->GetDimensions(dims);
+  if (dims[0] <= 0 || dims[1] <= 0 || dims[2] <= 0)
+  {
+    self->SetNumberOfIslands(0);
+    self->SetOriginalNumberOfIslands(0);
+    return;
+  }
+  if (self->GetUseRunLengthEncoding())
+  {
+    vtkITKIslandMathRunLengthExecute(self, input, inPtr, outPtr, islands);
+    return;
+  }
+
   double spacing[3];
   input->GetSpacing(spacing);
 
@@ -113,10 +663,32 @@ void vtkITKIslandMathExecute(vtkITKIslandMath *self, vtkImageData* input,
   self->SetNumberOfIslands(relabel->GetNumberOfObjects());
   self->SetOriginalNumberOfIslands(relabel->GetOriginalNumberOfObjects());
 
-  // Copy to the output
-  memcpy(outPtr, relabel->GetOutput()->GetBufferPointer(),
-         relabel->GetOutput()->GetBufferedRegion().GetNumberOfPixels() * sizeof(T));
+  // Island statistics
+  const T* labelPtr = relabel->GetOutput()->GetBufferPointer();
+  int inExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  input->GetExtent(inExtent);
+  islands.resize(relabel->GetNumberOfObjects());
+  for (int k = 0; k < dims[2]; ++k)
+  {
+    for (int j = 0; j < dims[1]; ++j)
+    {
+      for (int i = 0; i < dims[0]; ++i, ++labelPtr)
+      {
+        if (*labelPtr != 0)
+        {
+          islands[static_cast<size_t>(*labelPtr) - 1].AddRun(
+            i + inExtent[0], i + inExtent[0], j + inExtent[2], k + inExtent[4]);
+        }
+      }
+    }
+  }
 
+  // Copy to the output
+  if (outPtr)
+  {
+    memcpy(outPtr, relabel->GetOutput()->GetBufferPointer(),
+           relabel->GetOutput()->GetBufferedRegion().GetNumberOfPixels() * sizeof(T));
+  }
 }
 
 
@@ -127,6 +699,7 @@ void vtkITKIslandMathExecute(vtkITKIslandMath *self, vtkImageData* input,
 void vtkITKIslandMath::SimpleExecute(vtkImageData *input, vtkImageData *output)
 {
   vtkDebugMacro(<< "Executing Island Math");
+  this->Internal->Islands.clear();
 
   //
   // Initialize and check input
@@ -152,10 +725,10 @@ void vtkITKIslandMath::SimpleExecute(vtkImageData *input, vtkImageData *output)
 #undef VTK_TYPE_USE_LONG_LONG
 #undef VTK_TYPE_USE___INT64
 
-#define CALL  vtkITKIslandMathExecute(this, input, output, static_cast<VTK_TT *>(inPtr), static_cast<VTK_TT *>(outPtr));
+#define CALL  vtkITKIslandMathExecute(this, input, output, static_cast<VTK_TT *>(inPtr), static_cast<VTK_TT *>(outPtr), this->Internal->Islands);
 
     void* inPtr = input->GetScalarPointer();
-    void* outPtr = output->GetScalarPointer();
+    void* outPtr = (this->GenerateOutputImage ? output->GetScalarPointer() : nullptr);
 
     switch (inScalars->GetDataType())
     {
@@ -14,7 +14,17 @@
 #include "vtkSimpleImageToImageFilter.h"
 
 /// \brief ITK-based utilities for manipulating connected regions in label maps.
-/// Limitation: The filter does not work correctly with input volume that has
+///
+/// All non-zero voxels are considered foreground. Output voxel values are island labels,
+/// islands are sorted by size (label 1 is the largest island), background is 0.
+///
+/// By default islands are computed using a run-length encoded union-find algorithm
+/// that only processes the bounding box of the foreground. Slabs of the image are
+/// labeled in parallel and then merged along slab boundaries. Size, bounding box and
+/// centroid of each island is computed during labeling, therefore if only these are
+/// needed then generation of the output image can be disabled (see GenerateOutputImage).
+///
+/// Limitation: The ITK-based method does not work correctly with input volume that has
 /// unsigned long scalar type on Linux and macOS.
 ///
 class VTK_ITK_EXPORT vtkITKIslandMath : public vtkSimpleImageToImageFilter
@@ -58,11 +68,36 @@ class VTK_ITK_EXPORT vtkITKIslandMath : public vtkSimpleImageToImageFilter
   vtkGetMacro(OriginalNumberOfIslands, unsigned long);
   vtkSetMacro(OriginalNumberOfIslands, unsigned long);
 
+  ///
+  /// If enabled (default), islands are computed using run-length encoding of the foreground
+  /// and multi-threaded union-find. If disabled then ITK connected component filters are used.
+  /// Both methods produce the same output.
+  vtkGetMacro(UseRunLengthEncoding, bool);
+  vtkSetMacro(UseRunLengthEncoding, bool);
+  vtkBooleanMacro(UseRunLengthEncoding, bool);
+
+  ///
+  /// If enabled (default), the relabeled image is written to the output.
+  /// If disabled then only the number of islands and island statistics are computed
+  /// and the output image is left empty.
+  vtkGetMacro(GenerateOutputImage, bool);
+  vtkSetMacro(GenerateOutputImage, bool);
+  vtkBooleanMacro(GenerateOutputImage, bool);
+
+  ///
+  /// Island statistics. Islands are indexed by label value - 1 (index 0 is the largest island),
+  /// valid index range is 0 to NumberOfIslands-1.
+  /// Extent and centroid are in the IJK coordinate system of the input image.
+  vtkIdType GetIslandSize(unsigned long islandIndex);
+  bool GetIslandExtent(unsigned long islandIndex, int extent[6]);
+  bool GetIslandCentroid(unsigned long islandIndex, double centroid_IJK[3]);
+
 
 protected:
   vtkITKIslandMath();
   ~vtkITKIslandMath() override;
 
+  int RequestData(vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector) override;
   void SimpleExecute(vtkImageData* input, vtkImageData* output) override;
 
   int FullyConnected;
@@ -73,6 +108,12 @@ protected:
   unsigned long NumberOfIslands;
   unsigned long OriginalNumberOfIslands;
 
+  bool UseRunLengthEncoding{true};
+  bool GenerateOutputImage{true};
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
 private:
   vtkITKIslandMath(const vtkITKIslandMath&) = delete;
   void operator=(const vtkITKIslandMath&) = delete;
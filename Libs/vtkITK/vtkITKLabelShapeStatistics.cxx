@@ -30,11 +30,19 @@
 #include <vtkObjectFactory.h>
 #include <vtkPoints.h>
 #include <vtkPointData.h>
+#include <vtkSMPTools.h>
+#include <vtkTimerLog.h>
 
 // ITK includes
+#include <itkImage.h>
 #include <itkLabelImageToShapeLabelMapFilter.h>
+#include <itkNumericTraits.h>
 #include <itkShapeLabelObject.h>
-#include <itkVTKImageToImageFilter.h>
+
+// STL includes
+#include <algorithm>
+#include <array>
+#include <cmath>
 
 vtkStandardNewMacro(vtkITKLabelShapeStatistics);
 
@@ -57,6 +65,12 @@ vtkITKLabelShapeStatistics::~vtkITKLabelShapeStatistics()
 void vtkITKLabelShapeStatistics::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "ParallelLabelComputation: " << (this->ParallelLabelComputation ? "true" : "false") << "\n";
+  os << indent << "ComputationTimes:\n";
+  for (const std::pair<const std::string, double>& computationTime : this->ComputationTimes)
+  {
+    os << indent.GetNextIndent() << computationTime.first << ": " << computationTime.second << "s\n";
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -155,18 +169,26 @@ bool vtkITKLabelShapeStatistics::GetComputeShapeStatistic(std::string statisticN
 }
 
 //----------------------------------------------------------------------------
-// Note: local function not method - conforms to signature in itkCommand.h
-void vtkITKLabelShapeStatisticsHandleProgressEvent (itk::Object *caller,
-                                          const itk::EventObject& vtkNotUsed(eventObject),
-                                          void *clientdata)
+double vtkITKLabelShapeStatistics::GetComputationTime(std::string stepName)
 {
-  itk::ProcessObject *itkFilter = dynamic_cast<itk::ProcessObject*>(caller);
-  vtkAlgorithm *vtkFilter = reinterpret_cast<vtkAlgorithm*>(clientdata);
-  if ( itkFilter && vtkFilter )
+  std::map<std::string, double>::iterator timeIt = this->ComputationTimes.find(stepName);
+  if (timeIt == this->ComputationTimes.end())
   {
-    vtkFilter->UpdateProgress ( itkFilter->GetProgress() );
+    return 0.0;
   }
-};
+  return timeIt->second;
+}
+
+//----------------------------------------------------------------------------
+std::vector<std::string> vtkITKLabelShapeStatistics::GetComputationStepNames()
+{
+  std::vector<std::string> stepNames;
+  for (const std::pair<const std::string, double>& computationTime : this->ComputationTimes)
+  {
+    stepNames.push_back(computationTime.first);
+  }
+  return stepNames;
+}
 
 //----------------------------------------------------------------------------
 template <class T>
@@ -199,31 +221,256 @@ T* GetArray(vtkTable* table, std::string name, int numberOfComponents, std::vect
   return array.GetPointer();
 }
 
+namespace
+{
+
+using LabelImageType = itk::Image<unsigned char, 3>;
+using ShapeLabelObjectType = itk::ShapeLabelObject<unsigned char, 3>;
+using LabelMapType = itk::LabelMap<ShapeLabelObjectType>;
+using LabelShapeFilterType = itk::LabelImageToShapeLabelMapFilter<LabelImageType, LabelMapType>;
+using GridPointType = std::array<int, 3>;
+
+const char* LABEL_EXTRACTION_STEP_NAME = "LabelExtraction";
+const char* SHAPE_LABEL_MAP_STEP_NAME = "ShapeLabelMap";
+const char* FERET_DIAMETER_STEP_NAME = "FeretDiameter";
+
+//----------------------------------------------------------------------------
+/// Shape statistics computed for a single label
+struct LabelShapeResult
+{
+  long LabelValue{0};
+  /// Bounding box of the label voxels
+  int Extent[6]{0, -1, 0, -1, 0, -1};
+  ShapeLabelObjectType::Pointer ShapeObject;
+  double FeretDiameter{0.0};
+  double LabelExtractionTime{0.0};
+  double ShapeLabelMapTime{0.0};
+  double FeretDiameterTime{0.0};
+};
+
 //----------------------------------------------------------------------------
+/// Get bounding box of all labels in a single pass through the image.
+/// Voxels with the background value are ignored.
 template <class T>
-void vtkITKLabelShapeStatisticsExecute(vtkITKLabelShapeStatistics* self, vtkImageData* input, vtkTable* output,
-  vtkMatrix4x4* directionMatrix, T* vtkNotUsed(inPtr))
+void GetLabelExtents(vtkImageData* input, T* inPtr, T backgroundValue, std::map<T, LabelShapeResult>& labels)
 {
-  if (!self || !input || !output)
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  input->GetExtent(extent);
+  typename std::map<T, LabelShapeResult>::iterator labelIt = labels.end();
+  T* voxel = inPtr;
+  for (int k = extent[4]; k <= extent[5]; k++)
   {
-    return;
+    for (int j = extent[2]; j <= extent[3]; j++)
+    {
+      for (int i = extent[0]; i <= extent[1]; i++, voxel++)
+      {
+        if (*voxel == backgroundValue)
+        {
+          continue;
+        }
+        // Consecutive voxels usually have the same label, so only search when the label changes
+        if (labelIt == labels.end() || labelIt->first != *voxel)
+        {
+          labelIt = labels.find(*voxel);
+          if (labelIt == labels.end())
+          {
+            LabelShapeResult result;
+            result.LabelValue = static_cast<long>(*voxel);
+            result.Extent[0] = result.Extent[1] = i;
+            result.Extent[2] = result.Extent[3] = j;
+            result.Extent[4] = result.Extent[5] = k;
+            labelIt = labels.insert(std::make_pair(*voxel, result)).first;
+            continue;
+          }
+        }
+        int* labelExtent = labelIt->second.Extent;
+        labelExtent[0] = std::min(labelExtent[0], i);
+        labelExtent[1] = std::max(labelExtent[1], i);
+        labelExtent[2] = std::min(labelExtent[2], j);
+        labelExtent[3] = std::max(labelExtent[3], j);
+        labelExtent[4] = std::min(labelExtent[4], k);
+        labelExtent[5] = std::max(labelExtent[5], k);
+      }
+    }
   }
+}
 
-  // Clear current results
-  output->Initialize();
+//----------------------------------------------------------------------------
+/// Remove points that are not vertices of the convex hull of the points in their plane.
+/// Planes are orthogonal to normalAxis. Points must be unique.
+/// A vertex of the convex hull of all the points is always a vertex of the convex hull of
+/// any subset of points that contains it, therefore vertices of the 3D convex hull are all preserved.
+void KeepPlanarConvexHullVertices(std::vector<GridPointType>& points, int normalAxis)
+{
+  const int axis0 = (normalAxis == 0 ? 1 : 0);
+  const int axis1 = (normalAxis == 2 ? 1 : 2);
+  std::sort(points.begin(), points.end(),
+    [normalAxis, axis0, axis1](const GridPointType& a, const GridPointType& b)
+    {
+      if (a[normalAxis] != b[normalAxis])
+      {
+        return a[normalAxis] < b[normalAxis];
+      }
+      if (a[axis0] != b[axis0])
+      {
+        return a[axis0] < b[axis0];
+      }
+      return a[axis1] < b[axis1];
+    });
+  // Positive if o->a->b is a counter-clockwise turn
+  auto cross = [axis0, axis1](const GridPointType& o, const GridPointType& a, const GridPointType& b)
+  {
+    return static_cast<long long>(a[axis0] - o[axis0]) * (b[axis1] - o[axis1])
+      - static_cast<long long>(a[axis1] - o[axis1]) * (b[axis0] - o[axis0]);
+  };
+
+  std::vector<GridPointType> hullVertices;
+  std::vector<GridPointType> hull;
+  size_t planeStart = 0;
+  while (planeStart < points.size())
+  {
+    size_t planeEnd = planeStart + 1;
+    while (planeEnd < points.size() && points[planeEnd][normalAxis] == points[planeStart][normalAxis])
+    {
+      planeEnd++;
+    }
+    size_t numberOfPlanePoints = planeEnd - planeStart;
+    if (numberOfPlanePoints < 3)
+    {
+      hullVertices.insert(hullVertices.end(), points.begin() + planeStart, points.begin() + planeEnd);
+      planeStart = planeEnd;
+      continue;
+    }
+    // Andrew's monotone chain algorithm, points are already sorted along axis0 and axis1.
+    // Collinear points are removed, as they cannot be convex hull vertices.
+    hull.resize(2 * numberOfPlanePoints);
+    size_t hullSize = 0;
+    for (size_t i = planeStart; i < planeEnd; i++)
+    {
+      while (hullSize >= 2 && cross(hull[hullSize - 2], hull[hullSize - 1], points[i]) <= 0)
+      {
+        hullSize--;
+      }
+      hull[hullSize++] = points[i];
+    }
+    const size_t lowerHullSize = hullSize + 1;
+    for (size_t i = planeEnd - 1; i-- > planeStart;)
+    {
+      while (hullSize >= lowerHullSize && cross(hull[hullSize - 2], hull[hullSize - 1], points[i]) <= 0)
+      {
+        hullSize--;
+      }
+      hull[hullSize++] = points[i];
+    }
+    // the last point is the same as the first one
+    hullVertices.insert(hullVertices.end(), hull.begin(), hull.begin() + (hullSize - 1));
+    planeStart = planeEnd;
+  }
+  points.swap(hullVertices);
+}
+
+//----------------------------------------------------------------------------
+/// Compute the largest distance between voxel centers of the label (same as the Feret diameter
+/// computed by itk::ShapeLabelMapFilter). The maximum distance is always found between two
+/// vertices of the convex hull, therefore only the convex hull vertex candidates are compared:
+/// first and last voxel in each row, reduced to the convex hull vertices in each slice.
+double ComputeFeretDiameter(LabelImageType* labelImage)
+{
+  const LabelImageType::RegionType& region = labelImage->GetBufferedRegion();
+  const LabelImageType::SizeType& size = region.GetSize();
+  const LabelImageType::SpacingType& spacing = labelImage->GetSpacing();
+  const unsigned char* voxel = labelImage->GetBufferPointer();
+
+  std::vector<GridPointType> points;
+  for (int k = 0; k < static_cast<int>(size[2]); k++)
+  {
+    for (int j = 0; j < static_cast<int>(size[1]); j++, voxel += size[0])
+    {
+      int first = -1;
+      int last = -1;
+      for (int i = 0; i < static_cast<int>(size[0]); i++)
+      {
+        if (voxel[i])
+        {
+          if (first < 0)
+          {
+            first = i;
+          }
+          last = i;
+        }
+      }
+      if (first < 0)
+      {
+        continue;
+      }
+      points.push_back(GridPointType{ { first, j, k } });
+      if (last != first)
+      {
+        points.push_back(GridPointType{ { last, j, k } });
+      }
+    }
+  }
+
+  KeepPlanarConvexHullVertices(points, 2);
+  KeepPlanarConvexHullVertices(points, 1);
+  KeepPlanarConvexHullVertices(points, 0);
+
+  double maximumDistance2 = 0.0;
+  for (size_t pointIndex1 = 0; pointIndex1 < points.size(); pointIndex1++)
+  {
+    const GridPointType& point1 = points[pointIndex1];
+    for (size_t pointIndex2 = pointIndex1 + 1; pointIndex2 < points.size(); pointIndex2++)
+    {
+      const GridPointType& point2 = points[pointIndex2];
+      double distance2 = 0.0;
+      for (int axis = 0; axis < 3; axis++)
+      {
+        double difference = (point1[axis] - point2[axis]) * spacing[axis];
+        distance2 += difference * difference;
+      }
+      maximumDistance2 = std::max(maximumDistance2, distance2);
+    }
+  }
+  return std::sqrt(maximumDistance2);
+}
+
+//----------------------------------------------------------------------------
+/// Compute shape statistics of a single label on the region of the input image that contains the label.
+/// Only reads the input image, so it can be called for multiple labels concurrently.
+template <class T>
+void ComputeLabelShapeStatistics(vtkImageData* input, T* inPtr, vtkMatrix4x4* directionMatrix, T labelValue,
+  bool computePerimeter, bool computeOrientedBoundingBox, bool computeFeretDiameter, bool multithreaded,
+  LabelShapeResult& result)
+{
+  double startTime = vtkTimerLog::GetUniversalTime();
 
-  // Wrap VTK image into an ITK image
-  using ImageType = itk::Image<T, 3> ;
-  using VTKToITKFilterType = itk::VTKImageToImageFilter<ImageType>;
-  typename VTKToITKFilterType::Pointer vtkToITKFilter = VTKToITKFilterType::New();
-  vtkToITKFilter->SetInput(input);
-  vtkToITKFilter->Update();
-  ImageType* inImage = vtkToITKFilter->GetOutput();
+  // Crop the label with a one voxel margin, so that the label boundary is in the cropped image
+  int inputExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  input->GetExtent(inputExtent);
+  int croppedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  for (int axis = 0; axis < 3; axis++)
+  {
+    croppedExtent[2 * axis] = std::max(result.Extent[2 * axis] - 1, inputExtent[2 * axis]);
+    croppedExtent[2 * axis + 1] = std::min(result.Extent[2 * axis + 1] + 1, inputExtent[2 * axis + 1]);
+  }
 
+  // Voxel indices are the same as in the input image, therefore origin and spacing can be used as is
+  LabelImageType::IndexType croppedIndex;
+  LabelImageType::SizeType croppedSize;
+  for (int axis = 0; axis < 3; axis++)
+  {
+    croppedIndex[axis] = croppedExtent[2 * axis];
+    croppedSize[axis] = croppedExtent[2 * axis + 1] - croppedExtent[2 * axis] + 1;
+  }
+  LabelImageType::RegionType croppedRegion(croppedIndex, croppedSize);
+  LabelImageType::Pointer labelImage = LabelImageType::New();
+  labelImage->SetRegions(croppedRegion);
+  labelImage->SetOrigin(input->GetOrigin());
+  labelImage->SetSpacing(input->GetSpacing());
   // TODO: When vtkImageData is updated to include direction, this should be updated
   if (directionMatrix)
   {
-    typename ImageType::DirectionType gridDirectionMatrix;
+    LabelImageType::DirectionType gridDirectionMatrix;
     for (unsigned int row = 0; row < 3; row++)
     {
       for (unsigned int column = 0; column < 3; column++)
@@ -231,17 +478,74 @@ void vtkITKLabelShapeStatisticsExecute(vtkITKLabelShapeStatistics* self, vtkImag
         gridDirectionMatrix(row, column) = directionMatrix->GetElement(row, column);
       }
     }
-    inImage->SetDirection(gridDirectionMatrix);
+    labelImage->SetDirection(gridDirectionMatrix);
   }
+  labelImage->Allocate();
 
-  // Set up the progress callback
-  itk::CStyleCommand::Pointer progressCommand = itk::CStyleCommand::New();
-  progressCommand->SetClientData(static_cast<void*>(self));
-  progressCommand->SetCallback(vtkITKLabelShapeStatisticsHandleProgressEvent);
+  const vtkIdType rowSize = inputExtent[1] - inputExtent[0] + 1;
+  const vtkIdType sliceSize = rowSize * (inputExtent[3] - inputExtent[2] + 1);
+  unsigned char* labelVoxel = labelImage->GetBufferPointer();
+  for (int k = croppedExtent[4]; k <= croppedExtent[5]; k++)
+  {
+    for (int j = croppedExtent[2]; j <= croppedExtent[3]; j++)
+    {
+      const T* inputVoxel = inPtr + (k - inputExtent[4]) * sliceSize + (j - inputExtent[2]) * rowSize
+        + (croppedExtent[0] - inputExtent[0]);
+      for (int i = croppedExtent[0]; i <= croppedExtent[1]; i++, inputVoxel++, labelVoxel++)
+      {
+        *labelVoxel = (*inputVoxel == labelValue ? 1 : 0);
+      }
+    }
+  }
+  double endTime = vtkTimerLog::GetUniversalTime();
+  result.LabelExtractionTime = endTime - startTime;
+  startTime = endTime;
+
+  // Feret diameter is computed separately, ITK compares all pairs of boundary voxels
+  LabelShapeFilterType::Pointer labelFilter = LabelShapeFilterType::New();
+  labelFilter->SetInput(labelImage);
+  labelFilter->SetBackgroundValue(0);
+  labelFilter->SetComputeFeretDiameter(false);
+  labelFilter->SetComputePerimeter(computePerimeter);
+  labelFilter->SetComputeOrientedBoundingBox(computeOrientedBoundingBox);
+  if (!multithreaded)
+  {
+    labelFilter->SetNumberOfWorkUnits(1);
+  }
+  labelFilter->Update();
+  LabelMapType* labelMap = labelFilter->GetOutput();
+  if (labelMap->HasLabel(1))
+  {
+    result.ShapeObject = labelMap->GetLabelObject(1);
+    // The computed attributes are kept, but voxel runs are not needed anymore
+    result.ShapeObject->Clear();
+  }
+  endTime = vtkTimerLog::GetUniversalTime();
+  result.ShapeLabelMapTime = endTime - startTime;
+  startTime = endTime;
 
-  using ShapeLabelObjectType = itk::ShapeLabelObject<T, 3>;
-  using LabelMapType = itk::LabelMap<ShapeLabelObjectType>;
-  using LableShapeFilterType = itk::LabelImageToShapeLabelMapFilter<ImageType, LabelMapType>;
+  if (computeFeretDiameter)
+  {
+    result.FeretDiameter = ComputeFeretDiameter(labelImage);
+    result.FeretDiameterTime = vtkTimerLog::GetUniversalTime() - startTime;
+  }
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkITKLabelShapeStatisticsExecute(vtkITKLabelShapeStatistics* self, vtkImageData* input, vtkTable* output,
+  vtkMatrix4x4* directionMatrix, std::map<std::string, double>& computationTimes, T* inPtr)
+{
+  if (!self || !input || !output)
+  {
+    return;
+  }
+
+  // Clear current results
+  output->Initialize();
+  computationTimes.clear();
 
   bool computeFeretDiameter = self->GetComputeShapeStatistic(self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::ShapeStatistic::FeretDiameter));
   bool computePerimeter = self->GetComputeShapeStatistic(self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::ShapeStatistic::Perimeter)) ||
@@ -249,27 +553,58 @@ void vtkITKLabelShapeStatisticsExecute(vtkITKLabelShapeStatistics* self, vtkImag
   bool computeOrientedBoundingBox =
   self->GetComputeShapeStatistic(self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::ShapeStatistic::OrientedBoundingBox));
 
-  typename LableShapeFilterType::Pointer labelFilter = LableShapeFilterType::New();
-  labelFilter->AddObserver(itk::ProgressEvent(), progressCommand);
-  labelFilter->SetInput(inImage);
-  labelFilter->SetComputeFeretDiameter(computeFeretDiameter);
-  labelFilter->SetComputePerimeter(computePerimeter);
-  labelFilter->SetComputeOrientedBoundingBox(computeOrientedBoundingBox);
-  labelFilter->Update();
+  // Same background value as in itk::LabelImageToShapeLabelMapFilter
+  const T backgroundValue = itk::NumericTraits<T>::NonpositiveMin();
+
+  // Labels are ordered by label value, as in the ITK label map
+  std::map<T, LabelShapeResult> labels;
+  double startTime = vtkTimerLog::GetUniversalTime();
+  GetLabelExtents<T>(input, inPtr, backgroundValue, labels);
+  computationTimes[LABEL_EXTRACTION_STEP_NAME] = vtkTimerLog::GetUniversalTime() - startTime;
+
+  std::vector<std::pair<T, LabelShapeResult*>> labelResults;
+  for (typename std::map<T, LabelShapeResult>::value_type& label : labels)
+  {
+    labelResults.push_back(std::make_pair(label.first, &label.second));
+  }
 
-  typename LabelMapType::Pointer labelmapObject = labelFilter->GetOutput();
-  const std::vector<typename ShapeLabelObjectType::LabelType> labelValues = labelmapObject->GetLabels();
+  // Labels are processed in batches, so that progress can be reported from the main thread
+  const bool parallel = self->GetParallelLabelComputation() && labelResults.size() > 1;
+  const size_t batchSize = parallel ? 4 * static_cast<size_t>(std::max(1, vtkSMPTools::GetEstimatedNumberOfThreads())) : 1;
+  for (size_t batchStart = 0; batchStart < labelResults.size(); batchStart += batchSize)
+  {
+    const size_t batchEnd = std::min(batchStart + batchSize, labelResults.size());
+    vtkSMPTools::For(static_cast<vtkIdType>(batchStart), static_cast<vtkIdType>(batchEnd), 1,
+      [&](vtkIdType firstLabelIndex, vtkIdType lastLabelIndex)
+      {
+        for (vtkIdType labelIndex = firstLabelIndex; labelIndex < lastLabelIndex; labelIndex++)
+        {
+          ComputeLabelShapeStatistics<T>(input, inPtr, directionMatrix, labelResults[labelIndex].first,
+            computePerimeter, computeOrientedBoundingBox, computeFeretDiameter, !parallel,
+            *labelResults[labelIndex].second);
+        }
+      });
+    self->UpdateProgress(static_cast<double>(batchEnd) / labelResults.size());
+  }
 
   // Number of rows in the table is equal to the number of label values
-  output->SetNumberOfRows(labelValues.size());
+  output->SetNumberOfRows(labelResults.size());
 
   int rowIndex = -1;
-  for (unsigned int i = 0; i < labelValues.size(); ++i)
+  for (unsigned int i = 0; i < labelResults.size(); ++i)
   {
     rowIndex++;
-    int labelValue = labelValues[i];
+    const LabelShapeResult& result = *labelResults[i].second;
+    long labelValue = result.LabelValue;
+
+    computationTimes[LABEL_EXTRACTION_STEP_NAME] += result.LabelExtractionTime;
+    computationTimes[SHAPE_LABEL_MAP_STEP_NAME] += result.ShapeLabelMapTime;
+    if (computeFeretDiameter)
+    {
+      computationTimes[FERET_DIAMETER_STEP_NAME] += result.FeretDiameterTime;
+    }
 
-    typename ShapeLabelObjectType::ShapeLabelObject::Pointer shapeObject = labelmapObject->GetLabelObject(labelValue);
+    ShapeLabelObjectType* shapeObject = result.ShapeObject;
     if (!shapeObject)
     {
       continue;
@@ -282,7 +617,7 @@ void vtkITKLabelShapeStatisticsExecute(vtkITKLabelShapeStatistics* self, vtkImag
     {
       if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::Centroid))
       {
-        typename ShapeLabelObjectType::CentroidType centroidObject = shapeObject->GetCentroid();
+        ShapeLabelObjectType::CentroidType centroidObject = shapeObject->GetCentroid();
         vtkDoubleArray* array = GetArray<vtkDoubleArray>(output, statisticName, 3);
         array->InsertTuple3(rowIndex, centroidObject[0], centroidObject[1], centroidObject[2]);
       }
@@ -306,7 +641,7 @@ void vtkITKLabelShapeStatisticsExecute(vtkITKLabelShapeStatistics* self, vtkImag
       }
       else if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::FeretDiameter))
       {
-        double feretDiameter = shapeObject->GetFeretDiameter();
+        double feretDiameter = result.FeretDiameter;
         vtkDoubleArray* array = GetArray<vtkDoubleArray>(output, statisticName, 1);
         array->InsertTuple1(rowIndex, feretDiameter);
       }
@@ -318,16 +653,16 @@ void vtkITKLabelShapeStatisticsExecute(vtkITKLabelShapeStatistics* self, vtkImag
       }
       else if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::OrientedBoundingBox))
       {
-        typename ShapeLabelObjectType::OrientedBoundingBoxPointType boundingBoxOrigin = shapeObject->GetOrientedBoundingBoxOrigin();
+        ShapeLabelObjectType::OrientedBoundingBoxPointType boundingBoxOrigin = shapeObject->GetOrientedBoundingBoxOrigin();
         vtkDoubleArray* obbOriginArray = GetArray<vtkDoubleArray>(output, "OrientedBoundingBoxOrigin", 3);
         obbOriginArray->InsertTuple3(rowIndex, boundingBoxOrigin[0], boundingBoxOrigin[1], boundingBoxOrigin[2]);
 
-        typename ShapeLabelObjectType::OrientedBoundingBoxSizeType boundingBoxSize = shapeObject->GetOrientedBoundingBoxSize();
+        ShapeLabelObjectType::OrientedBoundingBoxSizeType boundingBoxSize = shapeObject->GetOrientedBoundingBoxSize();
         std::vector<std::string> componentNames = { "x", "y", "z" };
         vtkDoubleArray* obbSizeArray = GetArray<vtkDoubleArray>(output, "OrientedBoundingBoxSize", 3, &componentNames);
         obbSizeArray->InsertTuple3(rowIndex, boundingBoxSize[0], boundingBoxSize[1], boundingBoxSize[2]);
 
-        typename ShapeLabelObjectType::OrientedBoundingBoxDirectionType boundingBoxDirections = shapeObject->GetOrientedBoundingBoxDirection();
+        ShapeLabelObjectType::OrientedBoundingBoxDirectionType boundingBoxDirections = shapeObject->GetOrientedBoundingBoxDirection();
         vtkDoubleArray* obbDirectionXArray = GetArray<vtkDoubleArray>(output, "OrientedBoundingBoxDirectionX", 3);
         obbDirectionXArray->InsertTuple3(rowIndex, boundingBoxDirections(0, 0), boundingBoxDirections(0, 1), boundingBoxDirections(0, 2));
         vtkDoubleArray* obbDirectionYArray = GetArray<vtkDoubleArray>(output, "OrientedBoundingBoxDirectionY", 3);
@@ -337,13 +672,13 @@ void vtkITKLabelShapeStatisticsExecute(vtkITKLabelShapeStatistics* self, vtkImag
       }
       else if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::PrincipalMoments))
       {
-        typename ShapeLabelObjectType::VectorType principalMoments = shapeObject->GetPrincipalMoments();
+        ShapeLabelObjectType::VectorType principalMoments = shapeObject->GetPrincipalMoments();
         vtkDoubleArray* principalMomentsArray = GetArray<vtkDoubleArray>(output, statisticName, 3);
         principalMomentsArray->InsertTuple3(rowIndex, principalMoments[0], principalMoments[1], principalMoments[2]);
       }
       else if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::PrincipalAxes))
       {
-        typename ShapeLabelObjectType::MatrixType principalAxes = shapeObject->GetPrincipalAxes();
+        ShapeLabelObjectType::MatrixType principalAxes = shapeObject->GetPrincipalAxes();
         vtkDoubleArray* principalAxisXArray = GetArray<vtkDoubleArray>(output, "PrincipalAxisX", 3);
         principalAxisXArray->InsertTuple3(rowIndex, principalAxes(0, 0), principalAxes(0, 1), principalAxes(0, 2));
         vtkDoubleArray* principalAxisYArray = GetArray<vtkDoubleArray>(output, "PrincipalAxisY", 3);
@@ -397,7 +732,7 @@ int vtkITKLabelShapeStatistics::RequestData(
 #undef VTK_TYPE_USE_LONG_LONG
 #undef VTK_TYPE_USE___INT64
 
-#define CALL  vtkITKLabelShapeStatisticsExecute(this, input, output, this->Directions, static_cast<VTK_TT *>(inPtr));
+#define CALL  vtkITKLabelShapeStatisticsExecute(this, input, output, this->Directions, this->ComputationTimes, static_cast<VTK_TT *>(inPtr));
 
     void* inPtr = input->GetScalarPointer();
     switch (inScalars->GetDataType())
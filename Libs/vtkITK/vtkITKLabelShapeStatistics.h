@@ -34,6 +34,7 @@
 #include <vtkAddonSetGet.h>
 
 // std includes
+#include <map>
 #include <vector>
 
 class vtkPoints;
@@ -45,6 +46,11 @@ class vtkPoints;
 /// For a list of available parameters, see: vtkITKLabelShapeStatistics::ShapeStatistic
 /// Calculated statistics can be changed using the SetComputeShapeStatistic/ComputeShapeStatisticOn/ComputeShapeStatisticOff methods.
 /// Output statistics are represented in a vtkTable where each column represents a statistic and each row is a different label value.
+///
+/// Each label is cropped to its bounding box (found in a single pass through the input image) and processed
+/// separately, therefore memory usage does not grow with the number of labels and labels can be processed in parallel.
+/// Feret diameter is computed from the vertices of the convex hull of the label voxels, which gives the same result
+/// as comparing all pairs of boundary voxels, at a fraction of the cost.
 class VTK_ITK_EXPORT vtkITKLabelShapeStatistics : public vtkTableAlgorithm
 {
 public:
@@ -92,6 +98,26 @@ public:
   void ComputeShapeStatisticOn(std::string statisticName);
   void ComputeShapeStatisticOff(std::string statisticName);
 
+  //@{
+  /// If enabled (default) then multiple labels are processed concurrently.
+  /// If disabled then labels are processed one by one, each using multiple threads.
+  vtkSetMacro(ParallelLabelComputation, bool);
+  vtkGetMacro(ParallelLabelComputation, bool);
+  vtkBooleanMacro(ParallelLabelComputation, bool);
+  //@}
+
+  /// Get time (in seconds) spent in a computation step during the last update, summed for all labels.
+  /// Computation steps:
+  /// - LabelExtraction: cropping the label from the input image
+  /// - ShapeLabelMap: ITK shape statistics (all statistics except Feret diameter; perimeter and
+  ///   oriented bounding box are only computed if requested)
+  /// - FeretDiameter: Feret diameter computation
+  /// Returns 0 if the step was not performed.
+  double GetComputationTime(std::string stepName);
+
+  /// Get names of the computation steps performed during the last update.
+  std::vector<std::string> GetComputationStepNames();
+
 protected:
   vtkITKLabelShapeStatistics();
   ~vtkITKLabelShapeStatistics() override;
@@ -104,6 +130,8 @@ protected:
 protected:
   std::vector<std::string> ComputedStatistics;
   vtkMatrix4x4* Directions;
+  bool ParallelLabelComputation{true};
+  std::map<std::string, double> ComputationTimes;
 
 private:
   vtkITKLabelShapeStatistics(const vtkITKLabelShapeStatistics&) = delete;
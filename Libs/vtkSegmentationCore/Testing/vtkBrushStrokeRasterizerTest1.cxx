@@ -0,0 +1,257 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkIdList.h>
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+
+// SegmentationCore includes
+#include "vtkBrushStrokeRasterizer.h"
+#include "vtkOrientedImageDataResample.h"
+
+// STD includes
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+void CreateEmptyLabelmap(vtkImageData* image)
+{
+  image->SetExtent(0, 39, 0, 39, 0, 39);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  vtkOrientedImageDataResample::FillImage(image, 0);
+}
+
+//----------------------------------------------------------------------------
+double DistanceToSegment(const double p[3], const double a[3], const double b[3], const double scale[3])
+{
+  double ab[3] = { 0.0 };
+  double ap[3] = { 0.0 };
+  for (int i = 0; i < 3; i++)
+  {
+    ab[i] = (b[i] - a[i]) * scale[i];
+    ap[i] = (p[i] - a[i]) * scale[i];
+  }
+  double ab2 = ab[0] * ab[0] + ab[1] * ab[1] + ab[2] * ab[2];
+  double t = 0.0;
+  if (ab2 > 0.0)
+  {
+    t = std::min(1.0, std::max(0.0, (ap[0] * ab[0] + ap[1] * ab[1] + ap[2] * ab[2]) / ab2));
+  }
+  double d2 = 0.0;
+  for (int i = 0; i < 3; i++)
+  {
+    d2 += (ap[i] - t * ab[i]) * (ap[i] - t * ab[i]);
+  }
+  return sqrt(d2);
+}
+
+//----------------------------------------------------------------------------
+bool IsInsideExtent(int i, int j, int k, const int extent[6])
+{
+  return i >= extent[0] && i <= extent[1] && j >= extent[2] && j <= extent[3] && k >= extent[4] && k <= extent[5];
+}
+
+//----------------------------------------------------------------------------
+int TestSphereStroke()
+{
+  vtkNew<vtkImageData> image;
+  CreateEmptyLabelmap(image);
+  // Voxels that already have a larger value must be preserved
+  image->SetScalarComponentFromDouble(20, 10, 10, 0, 5);
+
+  // Voxel size is 2mm along I axis
+  vtkNew<vtkMatrix4x4> brushToImageIjk;
+  brushToImageIjk->SetElement(0, 0, 0.5);
+  double scale[3] = { 2.0, 1.0, 1.0 };
+
+  vtkNew<vtkPoints> strokePoints;
+  double startPoint[3] = { 8.0, 10.0, 10.0 };
+  double endPoint[3] = { 25.3, 14.2, 12.5 };
+  strokePoints->InsertNextPoint(startPoint);
+  strokePoints->InsertNextPoint(endPoint);
+
+  vtkNew<vtkBrushStrokeRasterizer> rasterizer;
+  rasterizer->SetBrushShapeToSphere();
+  rasterizer->SetRadius(5.5);
+  rasterizer->SetFillValue(1);
+  rasterizer->SetBrushToImageIjkMatrix(brushToImageIjk);
+  int modifiedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (!rasterizer->PaintStroke(image, strokePoints, nullptr, modifiedExtent))
+  {
+    std::cerr << __LINE__ << ": PaintStroke failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  int* extent = image->GetExtent();
+  for (int k = extent[4]; k <= extent[5]; k++)
+  {
+    for (int j = extent[2]; j <= extent[3]; j++)
+    {
+      for (int i = extent[0]; i <= extent[1]; i++)
+      {
+        double voxel[3] = { static_cast<double>(i), static_cast<double>(j), static_cast<double>(k) };
+        int expectedValue = (DistanceToSegment(voxel, startPoint, endPoint, scale) <= 5.5 ? 1 : 0);
+        if (i == 20 && j == 10 && k == 10)
+        {
+          expectedValue = 5;
+        }
+        int value = static_cast<int>(image->GetScalarComponentAsDouble(i, j, k, 0));
+        if (value != expectedValue)
+        {
+          std::cerr << __LINE__ << ": Voxel (" << i << ", " << j << ", " << k << ") value is " << value
+            << ", expected " << expectedValue << std::endl;
+          return EXIT_FAILURE;
+        }
+        if (value == 1 && !IsInsideExtent(i, j, k, modifiedExtent))
+        {
+          std::cerr << __LINE__ << ": Painted voxel (" << i << ", " << j << ", " << k << ") is outside the modified extent" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestDiskStroke()
+{
+  vtkNew<vtkImageData> image;
+  CreateEmptyLabelmap(image);
+
+  // Disk axis is aligned with the J axis
+  vtkNew<vtkMatrix4x4> brushToImageIjk;
+  brushToImageIjk->SetElement(1, 1, 0.0);
+  brushToImageIjk->SetElement(1, 2, 1.0);
+  brushToImageIjk->SetElement(2, 2, 0.0);
+  brushToImageIjk->SetElement(2, 1, 1.0);
+
+  // Two separate strokes, the first one is a single point
+  vtkNew<vtkPoints> strokePoints;
+  strokePoints->InsertNextPoint(5.0, 20.0, 5.0);
+  strokePoints->InsertNextPoint(10.0, 20.0, 30.0);
+  strokePoints->InsertNextPoint(30.0, 20.0, 30.0);
+  vtkNew<vtkIdList> strokeStartPointIds;
+  strokeStartPointIds->InsertNextId(1);
+
+  vtkNew<vtkBrushStrokeRasterizer> rasterizer;
+  rasterizer->SetBrushShapeToDisk();
+  rasterizer->SetRadius(3.0);
+  rasterizer->SetDiskHeight(1.0);
+  rasterizer->SetFillValue(2);
+  rasterizer->SetBrushToImageIjkMatrix(brushToImageIjk);
+  int modifiedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (!rasterizer->PaintStroke(image, strokePoints, strokeStartPointIds, modifiedExtent))
+  {
+    std::cerr << __LINE__ << ": PaintStroke failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (modifiedExtent[2] != 20 || modifiedExtent[3] != 20)
+  {
+    std::cerr << __LINE__ << ": Disk stroke must only modify a single slice, modified J range: "
+      << modifiedExtent[2] << ".." << modifiedExtent[3] << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  struct ExpectedVoxel
+  {
+    int Position[3];
+    int Value;
+  };
+  ExpectedVoxel expectedVoxels[] =
+  {
+    { { 5, 20, 5 }, 2 }, // single point stroke
+    { { 5, 20, 8 }, 2 }, // edge of the single point stroke
+    { { 5, 20, 9 }, 0 },
+    { { 5, 21, 5 }, 0 }, // neighbor slice
+    { { 7, 20, 17 }, 0 }, // between the two strokes
+    { { 20, 20, 27 }, 2 }, // along the second stroke
+    { { 20, 20, 34 }, 0 },
+    { { 33, 20, 30 }, 2 }, // end cap
+    { { 33, 20, 31 }, 0 },
+    { { 20, 19, 30 }, 0 }
+  };
+  for (const ExpectedVoxel& expectedVoxel : expectedVoxels)
+  {
+    const int* p = expectedVoxel.Position;
+    int value = static_cast<int>(image->GetScalarComponentAsDouble(p[0], p[1], p[2], 0));
+    if (value != expectedVoxel.Value)
+    {
+      std::cerr << __LINE__ << ": Voxel (" << p[0] << ", " << p[1] << ", " << p[2] << ") value is " << value
+        << ", expected " << expectedVoxel.Value << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestStrokeOutsideImage()
+{
+  vtkNew<vtkImageData> image;
+  CreateEmptyLabelmap(image);
+  vtkNew<vtkPoints> strokePoints;
+  strokePoints->InsertNextPoint(-20.0, -20.0, -20.0);
+  strokePoints->InsertNextPoint(-20.0, 80.0, -20.0);
+  vtkNew<vtkBrushStrokeRasterizer> rasterizer;
+  rasterizer->SetRadius(3.0);
+  int modifiedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (!rasterizer->PaintStroke(image, strokePoints, nullptr, modifiedExtent))
+  {
+    std::cerr << __LINE__ << ": PaintStroke failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (modifiedExtent[0] <= modifiedExtent[1])
+  {
+    std::cerr << __LINE__ << ": Modified extent is expected to be empty" << std::endl;
+    return EXIT_FAILURE;
+  }
+  double* scalarRange = image->GetScalarRange();
+  if (scalarRange[1] != 0.0)
+  {
+    std::cerr << __LINE__ << ": Image is expected to remain empty" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkBrushStrokeRasterizerTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  if (TestSphereStroke() != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+  if (TestDiskStroke() != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+  if (TestStrokeOutsideImage() != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+  std::cout << "Brush stroke rasterizer test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,377 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// SegmentationCore includes
+#include "vtkBrushStrokeRasterizer.h"
+
+// VTK includes
+#include <vtkIdList.h>
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkSMPTools.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+vtkStandardNewMacro(vtkBrushStrokeRasterizer);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Line segment of the stroke. The brush is swept from StartIjk to StartIjk + (end - start).
+struct StrokeSegment
+{
+  double StartIjk[3];
+  /// Vector from start to end point, in the brush coordinate system
+  double Direction_Brush[3];
+  /// Extent of the voxels that may be inside the swept brush (clipped to the image extent)
+  int Extent[6];
+};
+
+//----------------------------------------------------------------------------
+bool IsInsideSweptSphere(const double position_Brush[3], const double direction_Brush[3], double radius2)
+{
+  double directionLength2 = vtkMath::Dot(direction_Brush, direction_Brush);
+  double t = 0.0;
+  if (directionLength2 > 0.0)
+  {
+    t = std::min(1.0, std::max(0.0, vtkMath::Dot(position_Brush, direction_Brush) / directionLength2));
+  }
+  double dx = position_Brush[0] - t * direction_Brush[0];
+  double dy = position_Brush[1] - t * direction_Brush[1];
+  double dz = position_Brush[2] - t * direction_Brush[2];
+  return dx * dx + dy * dy + dz * dz <= radius2;
+}
+
+//----------------------------------------------------------------------------
+bool IsInsideSweptDisk(const double position_Brush[3], const double direction_Brush[3], double radius2, double halfHeight)
+{
+  // Range of sweep parameter values where the point is between the two faces of the disk
+  double tMin = 0.0;
+  double tMax = 1.0;
+  if (fabs(direction_Brush[2]) > 1e-12)
+  {
+    double t0 = (position_Brush[2] - halfHeight) / direction_Brush[2];
+    double t1 = (position_Brush[2] + halfHeight) / direction_Brush[2];
+    if (t0 > t1)
+    {
+      std::swap(t0, t1);
+    }
+    tMin = std::max(tMin, t0);
+    tMax = std::min(tMax, t1);
+    if (tMin > tMax)
+    {
+      return false;
+    }
+  }
+  else if (fabs(position_Brush[2]) > halfHeight)
+  {
+    return false;
+  }
+
+  // Closest in-plane distance within that range
+  double inPlaneLength2 = direction_Brush[0] * direction_Brush[0] + direction_Brush[1] * direction_Brush[1];
+  double t = tMin;
+  if (inPlaneLength2 > 0.0)
+  {
+    t = (position_Brush[0] * direction_Brush[0] + position_Brush[1] * direction_Brush[1]) / inPlaneLength2;
+    t = std::min(tMax, std::max(tMin, t));
+  }
+  double dx = position_Brush[0] - t * direction_Brush[0];
+  double dy = position_Brush[1] - t * direction_Brush[1];
+  return dx * dx + dy * dy <= radius2;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+class PaintStrokeWorker
+{
+public:
+  PaintStrokeWorker(vtkImageData* image, const std::vector<StrokeSegment>& segments,
+    double imageIjkToBrush[3][3], int brushShape, double radius, double diskHeight, double fillValue)
+    : Segments(segments)
+    , BrushShape(brushShape)
+    , Radius2(radius * radius)
+    , HalfHeight(diskHeight / 2.0)
+    , FillValue(static_cast<T>(fillValue))
+  {
+    this->Scalars = static_cast<T*>(image->GetScalarPointer());
+    image->GetExtent(this->ImageExtent);
+    image->GetIncrements(this->Increments);
+    for (int row = 0; row < 3; row++)
+    {
+      for (int column = 0; column < 3; column++)
+      {
+        this->ImageIjkToBrush[row][column] = imageIjkToBrush[row][column];
+      }
+    }
+  }
+
+  void operator()(vtkIdType beginSlice, vtkIdType endSlice) const
+  {
+    // Each thread processes a distinct set of slices, therefore voxels are never written concurrently
+    // Change of brush coordinates when moving to the next voxel along the I axis
+    const double stepI[3] = { this->ImageIjkToBrush[0][0], this->ImageIjkToBrush[1][0], this->ImageIjkToBrush[2][0] };
+    for (vtkIdType k = beginSlice; k < endSlice; k++)
+    {
+      for (const StrokeSegment& segment : this->Segments)
+      {
+        if (k < segment.Extent[4] || k > segment.Extent[5])
+        {
+          continue;
+        }
+        for (int j = segment.Extent[2]; j <= segment.Extent[3]; j++)
+        {
+          double offsetIjk[3] = { segment.Extent[0] - segment.StartIjk[0], j - segment.StartIjk[1], k - segment.StartIjk[2] };
+          double position_Brush[3] = { 0.0, 0.0, 0.0 };
+          vtkMath::Multiply3x3(this->ImageIjkToBrush, offsetIjk, position_Brush);
+          T* voxel = this->Scalars
+            + (segment.Extent[0] - this->ImageExtent[0]) * this->Increments[0]
+            + (j - this->ImageExtent[2]) * this->Increments[1]
+            + (k - this->ImageExtent[4]) * this->Increments[2];
+          for (int i = segment.Extent[0]; i <= segment.Extent[1]; i++)
+          {
+            if (*voxel < this->FillValue)
+            {
+              bool inside = (this->BrushShape == vtkBrushStrokeRasterizer::BRUSH_SHAPE_SPHERE)
+                ? IsInsideSweptSphere(position_Brush, segment.Direction_Brush, this->Radius2)
+                : IsInsideSweptDisk(position_Brush, segment.Direction_Brush, this->Radius2, this->HalfHeight);
+              if (inside)
+              {
+                *voxel = this->FillValue;
+              }
+            }
+            position_Brush[0] += stepI[0];
+            position_Brush[1] += stepI[1];
+            position_Brush[2] += stepI[2];
+            voxel += this->Increments[0];
+          }
+        }
+      }
+    }
+  }
+
+private:
+  T* Scalars{nullptr};
+  int ImageExtent[6];
+  vtkIdType Increments[3];
+  double ImageIjkToBrush[3][3];
+  const std::vector<StrokeSegment>& Segments;
+  int BrushShape;
+  double Radius2;
+  double HalfHeight;
+  T FillValue;
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+void PaintStrokeGeneric(vtkImageData* image, const std::vector<StrokeSegment>& segments, const int sliceRange[2],
+  double imageIjkToBrush[3][3], int brushShape, double radius, double diskHeight, double fillValue)
+{
+  PaintStrokeWorker<T> worker(image, segments, imageIjkToBrush, brushShape, radius, diskHeight, fillValue);
+  vtkSMPTools::For(sliceRange[0], sliceRange[1] + 1, worker);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+vtkBrushStrokeRasterizer::vtkBrushStrokeRasterizer()
+{
+  for (int row = 0; row < 3; row++)
+  {
+    for (int column = 0; column < 3; column++)
+    {
+      this->BrushToImageIjk[row][column] = (row == column ? 1.0 : 0.0);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkBrushStrokeRasterizer::~vtkBrushStrokeRasterizer() = default;
+
+//----------------------------------------------------------------------------
+void vtkBrushStrokeRasterizer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "BrushShape: " << (this->BrushShape == BRUSH_SHAPE_SPHERE ? "sphere" : "disk") << "\n";
+  os << indent << "Radius: " << this->Radius << "\n";
+  os << indent << "DiskHeight: " << this->DiskHeight << "\n";
+  os << indent << "FillValue: " << this->FillValue << "\n";
+  os << indent << "BrushToImageIjk:";
+  for (int row = 0; row < 3; row++)
+  {
+    os << " [" << this->BrushToImageIjk[row][0] << ", " << this->BrushToImageIjk[row][1] << ", " << this->BrushToImageIjk[row][2] << "]";
+  }
+  os << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkBrushStrokeRasterizer::SetBrushToImageIjkMatrix(vtkMatrix4x4* brushToImageIjkMatrix)
+{
+  for (int row = 0; row < 3; row++)
+  {
+    for (int column = 0; column < 3; column++)
+    {
+      this->BrushToImageIjk[row][column] = brushToImageIjkMatrix ? brushToImageIjkMatrix->GetElement(row, column) : (row == column ? 1.0 : 0.0);
+    }
+  }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkBrushStrokeRasterizer::PaintStroke(vtkImageData* image, vtkPoints* strokePoints_Ijk, vtkIdList* strokeStartPointIds, int modifiedExtent[6])
+{
+  for (int i = 0; i < 3; i++)
+  {
+    modifiedExtent[i * 2] = 0;
+    modifiedExtent[i * 2 + 1] = -1;
+  }
+  if (!image || !strokePoints_Ijk)
+  {
+    vtkErrorMacro("PaintStroke: Invalid input image or stroke points");
+    return false;
+  }
+  if (!image->GetPointData() || !image->GetPointData()->GetScalars())
+  {
+    vtkErrorMacro("PaintStroke: Input image has no scalars");
+    return false;
+  }
+  if (vtkMath::Determinant3x3(this->BrushToImageIjk) == 0.0)
+  {
+    vtkErrorMacro("PaintStroke: Brush to image IJK transform is not invertible");
+    return false;
+  }
+  vtkIdType numberOfPoints = strokePoints_Ijk->GetNumberOfPoints();
+  int imageExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  image->GetExtent(imageExtent);
+  if (numberOfPoints == 0 || imageExtent[0] > imageExtent[1] || imageExtent[2] > imageExtent[3] || imageExtent[4] > imageExtent[5])
+  {
+    // nothing to paint
+    return true;
+  }
+
+  double imageIjkToBrush[3][3];
+  vtkMath::Invert3x3(this->BrushToImageIjk, imageIjkToBrush);
+
+  // Half size of the brush bounding box along each IJK axis
+  double halfHeight = (this->BrushShape == BRUSH_SHAPE_DISK ? this->DiskHeight / 2.0 : 0.0);
+  double brushHalfSizeIjk[3] = { 0.0, 0.0, 0.0 };
+  for (int row = 0; row < 3; row++)
+  {
+    const double* m = this->BrushToImageIjk[row];
+    if (this->BrushShape == BRUSH_SHAPE_SPHERE)
+    {
+      brushHalfSizeIjk[row] = this->Radius * sqrt(m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
+    }
+    else
+    {
+      brushHalfSizeIjk[row] = this->Radius * sqrt(m[0] * m[0] + m[1] * m[1]) + halfHeight * fabs(m[2]);
+    }
+  }
+
+  std::vector<bool> isStrokeStartPoint(numberOfPoints, false);
+  isStrokeStartPoint[0] = true;
+  if (strokeStartPointIds)
+  {
+    for (vtkIdType index = 0; index < strokeStartPointIds->GetNumberOfIds(); index++)
+    {
+      vtkIdType pointId = strokeStartPointIds->GetId(index);
+      if (pointId >= 0 && pointId < numberOfPoints)
+      {
+        isStrokeStartPoint[pointId] = true;
+      }
+    }
+  }
+
+  // Each point is covered by the segment that connects it to the previous point
+  // (or by a zero-length segment if it starts a new stroke).
+  std::vector<StrokeSegment> segments;
+  segments.reserve(numberOfPoints);
+  double previousPoint[3] = { 0.0, 0.0, 0.0 };
+  for (vtkIdType pointId = 0; pointId < numberOfPoints; pointId++)
+  {
+    double point[3] = { 0.0, 0.0, 0.0 };
+    strokePoints_Ijk->GetPoint(pointId, point);
+    if (isStrokeStartPoint[pointId])
+    {
+      previousPoint[0] = point[0];
+      previousPoint[1] = point[1];
+      previousPoint[2] = point[2];
+    }
+    StrokeSegment segment;
+    double directionIjk[3] = { 0.0, 0.0, 0.0 };
+    bool emptySegment = false;
+    for (int i = 0; i < 3; i++)
+    {
+      segment.StartIjk[i] = previousPoint[i];
+      directionIjk[i] = point[i] - previousPoint[i];
+      segment.Extent[i * 2] = std::max(imageExtent[i * 2],
+        static_cast<int>(ceil(std::min(previousPoint[i], point[i]) - brushHalfSizeIjk[i])));
+      segment.Extent[i * 2 + 1] = std::min(imageExtent[i * 2 + 1],
+        static_cast<int>(floor(std::max(previousPoint[i], point[i]) + brushHalfSizeIjk[i])));
+      if (segment.Extent[i * 2] > segment.Extent[i * 2 + 1])
+      {
+        emptySegment = true;
+      }
+    }
+    previousPoint[0] = point[0];
+    previousPoint[1] = point[1];
+    previousPoint[2] = point[2];
+    if (emptySegment)
+    {
+      continue;
+    }
+    vtkMath::Multiply3x3(imageIjkToBrush, directionIjk, segment.Direction_Brush);
+    if (segments.empty())
+    {
+      std::copy(segment.Extent, segment.Extent + 6, modifiedExtent);
+    }
+    else
+    {
+      for (int i = 0; i < 3; i++)
+      {
+        modifiedExtent[i * 2] = std::min(modifiedExtent[i * 2], segment.Extent[i * 2]);
+        modifiedExtent[i * 2 + 1] = std::max(modifiedExtent[i * 2 + 1], segment.Extent[i * 2 + 1]);
+      }
+    }
+    segments.push_back(segment);
+  }
+  if (segments.empty())
+  {
+    // stroke is outside the image
+    return true;
+  }
+
+  int sliceRange[2] = { modifiedExtent[4], modifiedExtent[5] };
+  switch (image->GetScalarType())
+  {
+    vtkTemplateMacro(PaintStrokeGeneric<VTK_TT>(image, segments, sliceRange,
+      imageIjkToBrush, this->BrushShape, this->Radius, this->DiskHeight, this->FillValue));
+  default:
+    vtkErrorMacro("PaintStroke: Unknown scalar type");
+    return false;
+  }
+  image->Modified();
+  return true;
+}
@@ -0,0 +1,113 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkBrushStrokeRasterizer_h
+#define __vtkBrushStrokeRasterizer_h
+
+// Segmentation includes
+#include "vtkSegmentationCoreConfigure.h"
+
+// VTK includes
+#include <vtkObject.h>
+
+class vtkIdList;
+class vtkImageData;
+class vtkMatrix4x4;
+class vtkPoints;
+
+/// \brief Paint a brush stroke directly into a labelmap image.
+///
+/// The brush shape (sphere or disk) is swept analytically along the line segments
+/// connecting consecutive stroke points, in the IJK coordinate system of the image.
+/// Only voxels within the bounding box of each segment are visited and each voxel center
+/// is tested against the swept shape, without creating brush polydata or stencils.
+/// Voxels inside the stroke are set to FillValue unless they already have a larger value
+/// (same result as merging brush images using maximum operation).
+///
+/// Image slices are processed in parallel.
+class vtkSegmentationCore_EXPORT vtkBrushStrokeRasterizer : public vtkObject
+{
+public:
+  static vtkBrushStrokeRasterizer *New();
+  vtkTypeMacro(vtkBrushStrokeRasterizer, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  enum
+  {
+    BRUSH_SHAPE_SPHERE,
+    BRUSH_SHAPE_DISK
+  };
+
+  //@{
+  /// Brush shape. Disk is a cylinder in the brush coordinate system, with its axis along the Z axis.
+  vtkSetClampMacro(BrushShape, int, BRUSH_SHAPE_SPHERE, BRUSH_SHAPE_DISK);
+  vtkGetMacro(BrushShape, int);
+  void SetBrushShapeToSphere() { this->SetBrushShape(BRUSH_SHAPE_SPHERE); };
+  void SetBrushShapeToDisk() { this->SetBrushShape(BRUSH_SHAPE_DISK); };
+  //@}
+
+  //@{
+  /// Radius of the sphere or disk, in the brush coordinate system.
+  vtkSetMacro(Radius, double);
+  vtkGetMacro(Radius, double);
+  //@}
+
+  //@{
+  /// Thickness of the disk along its axis, in the brush coordinate system.
+  /// Only used if brush shape is disk.
+  vtkSetMacro(DiskHeight, double);
+  vtkGetMacro(DiskHeight, double);
+  //@}
+
+  //@{
+  /// Value that is written into the voxels inside the stroke.
+  vtkSetMacro(FillValue, double);
+  vtkGetMacro(FillValue, double);
+  //@}
+
+  /// Set linear transform from the brush coordinate system (origin at the brush center)
+  /// to the image IJK coordinate system. Translation component is ignored.
+  /// If not set then identity transform is used.
+  void SetBrushToImageIjkMatrix(vtkMatrix4x4* brushToImageIjkMatrix);
+
+  /// Paint the stroke into the image.
+  /// \param image Image to modify. Only its scalars and extent are used, stroke points must be in IJK coordinates.
+  /// \param strokePoints_Ijk Brush positions in the IJK coordinate system of the image.
+  /// \param strokeStartPointIds Optional list of point indices where a new stroke begins
+  ///   (the point is not connected to the previous point). First point always starts a stroke.
+  /// \param modifiedExtent Output extent that contains all the painted voxels, clipped to the image extent.
+  ///   Set to an empty extent if the stroke is outside of the image.
+  /// \return Success flag
+  bool PaintStroke(vtkImageData* image, vtkPoints* strokePoints_Ijk, vtkIdList* strokeStartPointIds, int modifiedExtent[6]);
+
+protected:
+  vtkBrushStrokeRasterizer();
+  ~vtkBrushStrokeRasterizer() override;
+
+protected:
+  int BrushShape{BRUSH_SHAPE_SPHERE};
+  double Radius{1.0};
+  double DiskHeight{1.0};
+  double FillValue{1.0};
+  double BrushToImageIjk[3][3];
+
+private:
+  vtkBrushStrokeRasterizer(const vtkBrushStrokeRasterizer&) = delete;
+  void operator=(const vtkBrushStrokeRasterizer&) = delete;
+};
+
+#endif
@@ -0,0 +1,277 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkTeem includes
+#include <vtkTeemNRRDReader.h>
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+// VTKSYS includes
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+const int Dimensions[3] = { 5, 4, 3 };
+
+//----------------------------------------------------------------------------
+bool IsHostLittleEndian()
+{
+  unsigned short value = 1;
+  return *reinterpret_cast<unsigned char*>(&value) == 1;
+}
+
+//----------------------------------------------------------------------------
+double GetExpectedValue(const std::string& type, int voxelIndex)
+{
+  return (type == "float" ? voxelIndex * 0.5 - 3.0 : voxelIndex * 3 - 7);
+}
+
+//----------------------------------------------------------------------------
+// Write voxels in the requested byte order, starting at dataOffset in dataFileName.
+// Data file is the header file if the data is attached.
+bool WriteVoxels(const std::string& dataFileName, std::ios::openmode mode, const std::string& type,
+  bool littleEndian, size_t dataOffset)
+{
+  int numberOfVoxels = Dimensions[0] * Dimensions[1] * Dimensions[2];
+  std::vector<char> data;
+  for (int voxelIndex = 0; voxelIndex < numberOfVoxels; ++voxelIndex)
+  {
+    char bytes[4] = { 0 };
+    size_t size = 0;
+    if (type == "float")
+    {
+      float value = static_cast<float>(GetExpectedValue(type, voxelIndex));
+      memcpy(bytes, &value, sizeof(value));
+      size = sizeof(value);
+    }
+    else
+    {
+      short value = static_cast<short>(GetExpectedValue(type, voxelIndex));
+      memcpy(bytes, &value, sizeof(value));
+      size = sizeof(value);
+    }
+    if (littleEndian != IsHostLittleEndian())
+    {
+      std::reverse(bytes, bytes + size);
+    }
+    data.insert(data.end(), bytes, bytes + size);
+  }
+  std::ofstream file(dataFileName.c_str(), mode | std::ios::binary);
+  if (!file.is_open())
+  {
+    return false;
+  }
+  if (static_cast<size_t>(file.tellp()) != dataOffset)
+  {
+    std::cerr << "Unexpected data offset " << file.tellp() << ", expected " << dataOffset << std::endl;
+    return false;
+  }
+  file.write(data.data(), data.size());
+  return file.good();
+}
+
+//----------------------------------------------------------------------------
+// Write a NRRD file. Header is padded by a comment so that voxel data starts at a multiple of
+// dataAlignment plus misalignment bytes.
+bool WriteNRRD(const std::string& fileName, const std::string& type, bool littleEndian,
+  int dataAlignment, int misalignment, bool detached)
+{
+  std::stringstream header;
+  header << "NRRD0004\n"
+    << "type: " << type << "\n"
+    << "dimension: 3\n"
+    << "space: left-posterior-superior\n"
+    << "sizes: " << Dimensions[0] << " " << Dimensions[1] << " " << Dimensions[2] << "\n"
+    << "space directions: (1,0,0) (0,1,0) (0,0,2.5)\n"
+    << "kinds: domain domain domain\n"
+    << "endian: " << (littleEndian ? "little" : "big") << "\n"
+    << "encoding: raw\n"
+    << "space origin: (10,20,30)\n";
+  std::string dataFileName = fileName;
+  if (detached)
+  {
+    dataFileName = vtksys::SystemTools::GetFilenamePath(fileName) + "/"
+      + vtksys::SystemTools::GetFilenameWithoutLastExtension(fileName) + ".raw";
+    header << "data file: " << vtksys::SystemTools::GetFilenameName(dataFileName) << "\n";
+  }
+  std::string headerString = header.str();
+  // comment line is at least "#\n", header ends with an empty line
+  size_t headerSize = headerString.size() + 2 + 1;
+  size_t paddingSize = (dataAlignment - headerSize % dataAlignment) % dataAlignment + misalignment;
+  headerString += "#" + std::string(paddingSize, ' ') + "\n\n";
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary);
+  file << headerString;
+  file.close();
+  if (!file.good())
+  {
+    return false;
+  }
+  if (detached)
+  {
+    return WriteVoxels(dataFileName, std::ios::out, type, littleEndian, 0);
+  }
+  return WriteVoxels(dataFileName, std::ios::out | std::ios::app | std::ios::ate, type, littleEndian, headerString.size());
+}
+
+//----------------------------------------------------------------------------
+int CheckVoxels(vtkImageData* imageData, const std::string& type, int line)
+{
+  int* dimensions = imageData->GetDimensions();
+  if (dimensions[0] != Dimensions[0] || dimensions[1] != Dimensions[1] || dimensions[2] != Dimensions[2])
+  {
+    std::cerr << "Line " << line << ": unexpected image dimensions" << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (int k = 0; k < Dimensions[2]; ++k)
+  {
+    for (int j = 0; j < Dimensions[1]; ++j)
+    {
+      for (int i = 0; i < Dimensions[0]; ++i)
+      {
+        int voxelIndex = i + Dimensions[0] * (j + Dimensions[1] * k);
+        double value = imageData->GetScalarComponentAsDouble(i, j, k, 0);
+        if (value != GetExpectedValue(type, voxelIndex))
+        {
+          std::cerr << "Line " << line << ": voxel (" << i << ", " << j << ", " << k << ") value is " << value
+            << ", expected " << GetExpectedValue(type, voxelIndex) << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestReadFile(const std::string& fileName, const std::string& type, bool expectedMemoryMapped, int line)
+{
+  vtkNew<vtkTeemNRRDReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->MemoryMappingOn();
+  reader->Update();
+  if (reader->GetReadStatus() != 0)
+  {
+    std::cerr << "Line " << line << ": failed to read " << fileName << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (reader->GetDataMemoryMapped() != expectedMemoryMapped)
+  {
+    std::cerr << "Line " << line << ": memory mapped is " << reader->GetDataMemoryMapped()
+      << ", expected " << expectedMemoryMapped << " for " << fileName << std::endl;
+    return EXIT_FAILURE;
+  }
+  return CheckVoxels(reader->GetOutput(), type, line);
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkTeemNRRDReaderMemoryMappingTest1(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::string tempDir = std::string(argv[1]) + "/vtkTeemNRRDReaderMemoryMappingTest1";
+  vtksys::SystemTools::MakeDirectory(tempDir);
+  bool hostLittleEndian = IsHostLittleEndian();
+
+  // Native byte order, aligned: memory-mapped
+  std::string nativeFileName = tempDir + "/Native.nrrd";
+  if (!WriteNRRD(nativeFileName, "short", hostLittleEndian, 8, 0, false)
+    || TestReadFile(nativeFileName, "short", true, __LINE__) != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Detached header: memory-mapped
+  std::string detachedFileName = tempDir + "/Detached.nhdr";
+  if (!WriteNRRD(detachedFileName, "float", hostLittleEndian, 1, 0, true)
+    || TestReadFile(detachedFileName, "float", true, __LINE__) != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Byte order is different from the host: read with byte swapping
+  std::string swappedFileName = tempDir + "/Swapped.nrrd";
+  if (!WriteNRRD(swappedFileName, "short", !hostLittleEndian, 8, 0, false)
+    || TestReadFile(swappedFileName, "short", false, __LINE__) != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Data is not aligned to the voxel component size: read into an aligned buffer
+  std::string misalignedFileName = tempDir + "/Misaligned.nrrd";
+  if (!WriteNRRD(misalignedFileName, "float", hostLittleEndian, 4, 2, false)
+    || TestReadFile(misalignedFileName, "float", false, __LINE__) != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Modifying memory-mapped voxels does not change the file
+  {
+    vtkNew<vtkTeemNRRDReader> reader;
+    reader->SetFileName(nativeFileName.c_str());
+    reader->MemoryMappingOn();
+    reader->Update();
+    vtkNew<vtkImageData> imageData;
+    imageData->ShallowCopy(reader->GetOutput());
+    if (!reader->GetDataMemoryMapped())
+    {
+      std::cerr << "Line " << __LINE__ << ": data is expected to be memory-mapped" << std::endl;
+      return EXIT_FAILURE;
+    }
+    imageData->SetScalarComponentFromDouble(1, 2, 1, 0, 1234);
+    if (imageData->GetScalarComponentAsDouble(1, 2, 1, 0) != 1234)
+    {
+      std::cerr << "Line " << __LINE__ << ": failed to modify memory-mapped voxel" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (TestReadFile(nativeFileName, "short", true, __LINE__) != EXIT_SUCCESS)
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Memory mapping is disabled by default
+  {
+    vtkNew<vtkTeemNRRDReader> reader;
+    reader->SetFileName(nativeFileName.c_str());
+    reader->Update();
+    if (reader->GetDataMemoryMapped() || CheckVoxels(reader->GetOutput(), "short", __LINE__) != EXIT_SUCCESS)
+    {
+      std::cerr << "Line " << __LINE__ << ": data is not expected to be memory-mapped" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  vtksys::SystemTools::RemoveADirectory(tempDir);
+  std::cout << "NRRD reader memory mapping test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -41,19 +41,164 @@
 #include "vtkMath.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
+#include "vtkPointData.h"
 #include "vtkShortArray.h"
 #include <vtkStreamingDemandDrivenPipeline.h>
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnsignedShortArray.h"
 #include "vtkUnsignedIntArray.h"
 #include "vtkUnsignedLongArray.h"
+#include <vtksys/Encoding.hxx>
+#include <vtksys/FStream.hxx>
 #include <vtksys/SystemTools.hxx>
 
 // Teem includes
 #include "teem/ten.h"
 
+// STD includes
+#include <mutex>
+
+// Memory mapping
+#if defined(_WIN32) && !defined(__CYGWIN__)
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <unistd.h>
+#endif
+
 vtkStandardNewMacro(vtkTeemNRRDReader);
 
+namespace
+{
+
+/// Start address, length, and source file of mapped file regions, indexed by the address of the voxel data
+struct MappedRegion
+{
+  void* Address;
+  size_t Length;
+  std::string FileName;
+};
+std::mutex MappedRegionsMutex;
+std::map<void*, MappedRegion> MappedRegions;
+
+//----------------------------------------------------------------------------
+// Map a region of a file into memory (copy-on-write). Returns nullptr on failure.
+void* MapFileRegion(const std::string& fileName, vtkTypeInt64 offset, vtkTypeInt64 size)
+{
+  // mapping must start at a multiple of the allocation granularity
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  vtkTypeInt64 granularity = systemInfo.dwAllocationGranularity;
+#else
+  vtkTypeInt64 granularity = sysconf(_SC_PAGESIZE);
+#endif
+  vtkTypeInt64 mappingOffset = offset - offset % granularity;
+  MappedRegion region = { nullptr, static_cast<size_t>(offset - mappingOffset + size), fileName };
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  HANDLE fileHandle = CreateFileW(vtksys::Encoding::ToWide(fileName).c_str(), GENERIC_READ,
+    FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (fileHandle == INVALID_HANDLE_VALUE)
+  {
+    return nullptr;
+  }
+  HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  if (mappingHandle)
+  {
+    region.Address = MapViewOfFile(mappingHandle, FILE_MAP_COPY,
+      static_cast<DWORD>(mappingOffset >> 32), static_cast<DWORD>(mappingOffset & 0xFFFFFFFF), region.Length);
+    // the view keeps the file mapped
+    CloseHandle(mappingHandle);
+  }
+  CloseHandle(fileHandle);
+  if (!region.Address)
+  {
+    return nullptr;
+  }
+#else
+  int fileDescriptor = open(fileName.c_str(), O_RDONLY);
+  if (fileDescriptor < 0)
+  {
+    return nullptr;
+  }
+  void* address = mmap(nullptr, region.Length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileDescriptor,
+    static_cast<off_t>(mappingOffset));
+  // the mapping keeps the file open
+  close(fileDescriptor);
+  if (address == MAP_FAILED)
+  {
+    return nullptr;
+  }
+  region.Address = address;
+#endif
+
+  void* data = static_cast<char*>(region.Address) + (offset - mappingOffset);
+  std::lock_guard<std::mutex> lock(MappedRegionsMutex);
+  MappedRegions[data] = region;
+  return data;
+}
+
+//----------------------------------------------------------------------------
+// Free function of data arrays that use memory-mapped voxel data
+void UnmapFileRegion(void* data)
+{
+  MappedRegion region;
+  {
+    std::lock_guard<std::mutex> lock(MappedRegionsMutex);
+    std::map<void*, MappedRegion>::iterator regionIt = MappedRegions.find(data);
+    if (regionIt == MappedRegions.end())
+    {
+      return;
+    }
+    region = regionIt->second;
+    MappedRegions.erase(regionIt);
+  }
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  UnmapViewOfFile(region.Address);
+#else
+  munmap(region.Address, region.Length);
+#endif
+}
+
+//----------------------------------------------------------------------------
+// Returns true if writing fileName may overwrite mappedFileName: it is the same file or
+// a detached data file that the writer would create next to the header (same directory and name).
+bool IsFileOverwrittenByWrite(const std::string& mappedFileName, const std::string& fileName)
+{
+  std::string mappedFullPath = vtksys::SystemTools::CollapseFullPath(mappedFileName);
+  std::string fullPath = vtksys::SystemTools::CollapseFullPath(fileName);
+  if (vtksys::SystemTools::SameFile(mappedFullPath, fullPath) || mappedFullPath == fullPath)
+  {
+    return true;
+  }
+  return vtksys::SystemTools::GetFilenamePath(mappedFullPath) == vtksys::SystemTools::GetFilenamePath(fullPath)
+    && vtksys::SystemTools::GetFilenameWithoutExtension(mappedFullPath)
+      == vtksys::SystemTools::GetFilenameWithoutExtension(fullPath);
+}
+
+//----------------------------------------------------------------------------
+// Returns position of data attached to the header (after the first empty line), -1 if not found
+vtkTypeInt64 GetAttachedDataOffset(const char* fileName)
+{
+  vtksys::ifstream file(fileName, std::ios::in | std::ios::binary);
+  std::string line;
+  while (std::getline(file, line))
+  {
+    if (line.empty() || line == "\r")
+    {
+      return static_cast<vtkTypeInt64>(file.tellg());
+    }
+  }
+  return -1;
+}
+
+} // end of anonymous namespace
+
 //----------------------------------------------------------------------------
 vtkTeemNRRDReader::vtkTeemNRRDReader()
 {
@@ -67,6 +212,10 @@ vtkTeemNRRDReader::vtkTeemNRRDReader()
   this->DataType = -1;
   this->NumberOfComponents = -1;
   this->DataArrayName = "NRRDImage";
+  this->MemoryMapping = false;
+  this->DataMemoryMapped = false;
+  this->RawDataOffset = -1;
+  this->RawDataSize = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -359,6 +508,9 @@ void vtkTeemNRRDReader::ExecuteInformation()
     return;
   }
   this->CurrentFileName = this->GetFileName();
+  this->RawDataFileName.clear();
+  this->RawDataOffset = -1;
+  this->RawDataSize = 0;
 
   nrrdNuke(this->nrrd); // nuke and reallocate to reset the state
   this->nrrd = nrrdNew();
@@ -674,10 +826,137 @@ void vtkTeemNRRDReader::ExecuteInformation()
     }
   }
 
+  // Find raw voxel data that can be memory-mapped: it must be stored in a single file
+  // in the same layout and byte order as in memory and aligned to the component size.
+  unsigned int rangeAxisIdx[NRRD_DIM_MAX] = { 0 };
+  unsigned int rangeAxisNum = nrrdRangeAxesGet(this->nrrd, rangeAxisIdx);
+  vtkTypeInt64 elementSize = static_cast<vtkTypeInt64>(nrrdElementSize(this->nrrd));
+  if (nio->encoding == nrrdEncodingRaw
+    && (elementSize == 1 || nio->endian == airMyEndian())
+    && nio->lineSkip == 0 && nio->byteSkip >= -1
+    && nio->dataFNArr->len <= 1
+    && (rangeAxisNum == 0 || (rangeAxisNum == 1 && rangeAxisIdx[0] == 0))
+    && nrrdKind3DMaskedSymMatrix != this->nrrd->axis[0].kind
+    && nrrdKind3DSymMatrix != this->nrrd->axis[0].kind)
+  {
+    std::string rawDataFileName = this->GetFileName();
+    vtkTypeInt64 rawDataOffset = nio->byteSkip;
+    if (nio->dataFNArr->len == 1)
+    {
+      // detached header, data file name is relative to the header
+      rawDataFileName = nio->dataFN[0];
+      if (!vtksys::SystemTools::FileIsFullPath(rawDataFileName))
+      {
+        rawDataFileName = vtksys::SystemTools::CollapseFullPath(rawDataFileName,
+          vtksys::SystemTools::GetFilenamePath(this->GetFileName()));
+      }
+    }
+    else if (nio->byteSkip >= 0)
+    {
+      vtkTypeInt64 headerSize = GetAttachedDataOffset(this->GetFileName());
+      rawDataOffset = (headerSize >= 0 ? headerSize + nio->byteSkip : -1);
+    }
+    vtkTypeInt64 rawDataSize = elementSize * static_cast<vtkTypeInt64>(nrrdElementNumber(this->nrrd));
+    vtkTypeInt64 fileSize = static_cast<vtkTypeInt64>(vtksys::SystemTools::FileLength(rawDataFileName));
+    if (nio->byteSkip == -1)
+    {
+      // data is at the end of the file
+      rawDataOffset = fileSize - rawDataSize;
+    }
+    if (rawDataOffset < 0 || rawDataSize <= 0 || rawDataOffset + rawDataSize > fileSize)
+    {
+      vtkDebugMacro("ExecuteInformation: cannot locate raw voxel data in " << rawDataFileName << ", it will not be memory-mapped");
+    }
+    else if (rawDataOffset % elementSize != 0)
+    {
+      vtkDebugMacro("ExecuteInformation: raw voxel data in " << rawDataFileName << " is not aligned, it will not be memory-mapped");
+    }
+    else
+    {
+      this->RawDataFileName = rawDataFileName;
+      this->RawDataOffset = rawDataOffset;
+      this->RawDataSize = rawDataSize;
+    }
+  }
+
   this->vtkImageReader2::ExecuteInformation();
   nio = nrrdIoStateNix(nio);
 }
 
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDReader::MapData(vtkImageData* imageData)
+{
+  if (this->RawDataFileName.empty())
+  {
+    return false;
+  }
+  vtkDataArray* dataArray = nullptr;
+  switch (this->PointDataType)
+  {
+    case vtkDataSetAttributes::SCALARS:
+      dataArray = imageData->GetPointData()->GetScalars();
+      break;
+    case vtkDataSetAttributes::VECTORS:
+      dataArray = imageData->GetPointData()->GetVectors();
+      break;
+    case vtkDataSetAttributes::NORMALS:
+      dataArray = imageData->GetPointData()->GetNormals();
+      break;
+    case vtkDataSetAttributes::TENSORS:
+      dataArray = imageData->GetPointData()->GetTensors();
+      break;
+  }
+  if (!dataArray || dataArray->GetNumberOfValues() * dataArray->GetDataTypeSize() != this->RawDataSize)
+  {
+    return false;
+  }
+  void* data = MapFileRegion(this->RawDataFileName, this->RawDataOffset, this->RawDataSize);
+  if (!data)
+  {
+    vtkDebugMacro("MapData: failed to map " << this->RawDataFileName << ", voxel data is read instead");
+    return false;
+  }
+  dataArray->SetVoidArray(data, dataArray->GetNumberOfValues(), 0, vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED);
+  dataArray->SetArrayFreeFunction(UnmapFileRegion);
+  dataArray->SetName(this->DataArrayName.c_str());
+  dataArray->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDReader::ReleaseMappedData(vtkImageData* imageData, const std::string& fileName)
+{
+  if (!imageData || !imageData->GetPointData())
+  {
+    return false;
+  }
+  vtkPointData* pointData = imageData->GetPointData();
+  bool released = false;
+  for (int arrayIndex = 0; arrayIndex < pointData->GetNumberOfArrays(); ++arrayIndex)
+  {
+    vtkDataArray* dataArray = pointData->GetArray(arrayIndex);
+    if (!dataArray || dataArray->GetNumberOfValues() == 0)
+    {
+      continue;
+    }
+    {
+      std::lock_guard<std::mutex> lock(MappedRegionsMutex);
+      std::map<void*, MappedRegion>::iterator regionIt = MappedRegions.find(dataArray->GetVoidPointer(0));
+      if (regionIt == MappedRegions.end() || !IsFileOverwrittenByWrite(regionIt->second.FileName, fileName))
+      {
+        continue;
+      }
+    }
+    // Sharing the buffer of the copy releases the mapped buffer, which unmaps the file
+    vtkSmartPointer<vtkDataArray> copiedArray = vtkSmartPointer<vtkDataArray>::Take(dataArray->NewInstance());
+    copiedArray->DeepCopy(dataArray);
+    dataArray->ShallowCopy(copiedArray);
+    dataArray->Modified();
+    released = true;
+  }
+  return released;
+}
+
 //----------------------------------------------------------------------------
 vtkImageData *vtkTeemNRRDReader::AllocateOutputData(vtkDataObject *out, vtkInformation* outInfo)
 {
@@ -923,6 +1202,14 @@ void vtkTeemNRRDReader::ExecuteDataWithInformation(vtkDataObject *output, vtkInf
     return;
   }
 
+  this->DataMemoryMapped = false;
+  if (this->MemoryMapping && this->MapData(imageData))
+  {
+    this->DataMemoryMapped = true;
+    this->ComputeDataIncrements();
+    return;
+  }
+
   // Read in the this->nrrd.  Yes, this means that the header is being read
   // twice: once by ExecuteInformation, and once here
   if ( nrrdLoad(this->nrrd, this->GetFileName(), nullptr) != 0 )
@@ -1112,4 +1399,6 @@ void vtkTeemNRRDReader::ExecuteDataWithInformation(vtkDataObject *output, vtkInf
 void vtkTeemNRRDReader::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "MemoryMapping: " << (this->MemoryMapping ? "true" : "false") << "\n";
+  os << indent << "DataMemoryMapped: " << (this->DataMemoryMapped ? "true" : "false") << "\n";
 }
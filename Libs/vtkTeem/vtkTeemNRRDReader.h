@@ -155,6 +155,35 @@ public:
   vtkSetMacro(DataArrayName, std::string);
   vtkGetMacro(DataArrayName, std::string);
 
+  ///
+  /// Map raw voxel data of the file into memory instead of reading it into a newly allocated buffer.
+  /// The mapping is copy-on-write: voxels can be modified without changing the file.
+  /// File content is loaded when it is accessed, and processes that map the same file share memory pages.
+  /// Data is read as usual if it cannot be mapped: compressed or text encoding, byte order that is
+  /// different from the host, data offset that is not a multiple of the voxel component size,
+  /// or voxels that need reordering (tensors, non-scalar axis is not the fastest).
+  /// Disabled by default.
+  vtkSetMacro(MemoryMapping, bool);
+  vtkGetMacro(MemoryMapping, bool);
+  vtkBooleanMacro(MemoryMapping, bool);
+
+  ///
+  /// Returns true if voxel data of the file can be memory-mapped.
+  /// Valid after the information is updated.
+  bool CanMapData() { return !this->RawDataFileName.empty(); }
+
+  ///
+  /// Returns true if voxel data was memory-mapped by the last update.
+  vtkGetMacro(DataMemoryMapped, bool);
+
+  ///
+  /// Replace memory-mapped voxel data of the image with an in-memory copy if writing
+  /// the file \a fileName may overwrite the mapped file (same file or detached data file
+  /// next to the header). Unmodified voxels of a mapping are read from the file, therefore
+  /// this must be called before the mapped file is overwritten.
+  /// Returns true if any data array was copied.
+  static bool ReleaseMappedData(vtkImageData* imageData, const std::string& fileName);
+
   int NrrdToVTKScalarType( const int nrrdPixelType ) const
   {
   switch( nrrdPixelType )
@@ -277,6 +306,19 @@ protected:
 
   int tenSpaceDirectionReduce(Nrrd *nout, const Nrrd *nin, double SD[9]);
 
+  /// Use memory-mapped raw voxel data of the file as point data of the image.
+  /// Returns false if the data cannot be mapped.
+  bool MapData(vtkImageData* imageData);
+
+  bool MemoryMapping;
+  bool DataMemoryMapped;
+
+  /// Location of raw voxel data that can be memory-mapped.
+  /// RawDataFileName is empty if data cannot be mapped.
+  std::string RawDataFileName;
+  vtkTypeInt64 RawDataOffset;
+  vtkTypeInt64 RawDataSize;
+
 private:
   vtkTeemNRRDReader(const vtkTeemNRRDReader&) = delete;
   void operator=(const vtkTeemNRRDReader&) = delete;
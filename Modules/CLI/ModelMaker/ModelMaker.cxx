@@ -44,11 +44,14 @@ Version:   $Revision$
 #include <vtkImageToStructuredPoints.h>
 #include <vtkInformation.h>
 #include <vtkLookupTable.h>
+#include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
+#include <vtkPolyData.h>
 #include <vtkPolyDataNormals.h>
 #include <vtkPolyDataWriter.h>
 #include <vtkReverseSense.h>
+#include <vtkSMPTools.h>
 #include <vtkSmartPointer.h>
 #include <vtkSmoothPolyDataFilter.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
@@ -62,6 +65,377 @@ Version:   $Revision$
 // VTKsys includes
 #include <vtksys/SystemTools.hxx>
 
+// STL includes
+#include <algorithm>
+#include <unordered_map>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Model generation state of a single label in parallel mode.
+struct LabelModelJob
+{
+  int Label{0};
+  std::string LabelName;
+  /// Bounding box of the label voxels (IJK). Empty if extent[0] > extent[1].
+  int Extent[6]{0, -1, 0, -1, 0, -1};
+  /// Final model, in LPS coordinate system
+  vtkSmartPointer<vtkPolyData> Model;
+  /// Intermediate models, only stored if intermediate models are saved
+  vtkSmartPointer<vtkPolyData> MarchingCubesModel;
+  vtkSmartPointer<vtkPolyData> DecimatedModel;
+  vtkSmartPointer<vtkPolyData> SmoothedModel;
+  bool Failed{false};
+};
+
+//----------------------------------------------------------------------------
+/// Update the bounding box of each label by iterating through the voxels once.
+/// labelToJobIndex maps the requested labels to an index in jobs. Only the requested labels
+/// are stored, so sparse label values (e.g. 1 and 100000) do not need a large lookup table.
+template <class T>
+void ComputeLabelExtents(vtkImageData* image, T* scalars, int minimumLabel, int maximumLabel,
+                         const std::unordered_map<int, int>& labelToJobIndex, std::vector<LabelModelJob>& jobs)
+{
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  image->GetExtent(extent);
+  // Neighbor voxels usually have the same value, reuse the result of the previous lookup
+  T previousValue = static_cast<T>(0);
+  int previousJobIndex = -1;
+  bool previousValueValid = false;
+  T* voxel = scalars;
+  for (int k = extent[4]; k <= extent[5]; k++)
+  {
+    for (int j = extent[2]; j <= extent[3]; j++)
+    {
+      for (int i = extent[0]; i <= extent[1]; i++, voxel++)
+      {
+        int jobIndex = -1;
+        if (previousValueValid && *voxel == previousValue)
+        {
+          jobIndex = previousJobIndex;
+        }
+        else
+        {
+          double value = static_cast<double>(*voxel);
+          if (value >= minimumLabel && value <= maximumLabel && static_cast<int>(value) == value)
+          {
+            std::unordered_map<int, int>::const_iterator labelIt = labelToJobIndex.find(static_cast<int>(value));
+            if (labelIt != labelToJobIndex.end())
+            {
+              jobIndex = labelIt->second;
+            }
+          }
+          previousValue = *voxel;
+          previousJobIndex = jobIndex;
+          previousValueValid = true;
+        }
+        if (jobIndex < 0)
+        {
+          continue;
+        }
+        int* labelExtent = jobs[jobIndex].Extent;
+        if (labelExtent[0] > labelExtent[1])
+        {
+          // first voxel of this label
+          labelExtent[0] = labelExtent[1] = i;
+          labelExtent[2] = labelExtent[3] = j;
+          labelExtent[4] = labelExtent[5] = k;
+          continue;
+        }
+        labelExtent[0] = std::min(labelExtent[0], i);
+        labelExtent[1] = std::max(labelExtent[1], i);
+        labelExtent[2] = std::min(labelExtent[2], j);
+        labelExtent[3] = std::max(labelExtent[3], j);
+        labelExtent[4] = std::min(labelExtent[4], k);
+        labelExtent[5] = std::max(labelExtent[5], k);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Create a binary image (label voxels = 200, other voxels = 0), cropped to the
+/// label bounding box with a one voxel margin. The margin is filled with 0 outside
+/// the input image if padding is requested, to get closed surfaces.
+template <class T>
+void ExtractLabelImage(vtkImageData* image, T* scalars, int label, const int labelExtent[6], bool pad,
+                       vtkImageData* labelImage)
+{
+  int imageExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  image->GetExtent(imageExtent);
+  int croppedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  for (int axis = 0; axis < 3; axis++)
+  {
+    int minimumIndex = pad ? imageExtent[2 * axis] - 1 : imageExtent[2 * axis];
+    int maximumIndex = pad ? imageExtent[2 * axis + 1] + 1 : imageExtent[2 * axis + 1];
+    croppedExtent[2 * axis] = std::max(labelExtent[2 * axis] - 1, minimumIndex);
+    croppedExtent[2 * axis + 1] = std::min(labelExtent[2 * axis + 1] + 1, maximumIndex);
+  }
+  labelImage->SetExtent(croppedExtent);
+  labelImage->SetOrigin(0.0, 0.0, 0.0);
+  labelImage->SetSpacing(1.0, 1.0, 1.0);
+  labelImage->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  unsigned char* labelVoxel = static_cast<unsigned char*>(labelImage->GetScalarPointer());
+  const vtkIdType rowSize = imageExtent[1] - imageExtent[0] + 1;
+  const vtkIdType sliceSize = rowSize * (imageExtent[3] - imageExtent[2] + 1);
+  const T labelValue = static_cast<T>(label);
+  for (int k = croppedExtent[4]; k <= croppedExtent[5]; k++)
+  {
+    for (int j = croppedExtent[2]; j <= croppedExtent[3]; j++)
+    {
+      for (int i = croppedExtent[0]; i <= croppedExtent[1]; i++, labelVoxel++)
+      {
+        if (i < imageExtent[0] || i > imageExtent[1]
+          || j < imageExtent[2] || j > imageExtent[3]
+          || k < imageExtent[4] || k > imageExtent[5])
+        {
+          // padding
+          *labelVoxel = 0;
+          continue;
+        }
+        T value = scalars[(k - imageExtent[4]) * sliceSize + (j - imageExtent[2]) * rowSize + (i - imageExtent[0])];
+        *labelVoxel = (value == labelValue ? 200 : 0);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Generate the model of a single label. Each call uses its own pipeline and it only
+/// reads the shared input image, therefore it can be called from multiple threads.
+void GenerateLabelModel(vtkImageData* image, vtkMatrix4x4* ijkToLpsMatrix, bool pad, float decimate, int smooth,
+                        bool sincFilter, bool splitNormals, bool pointNormals, bool saveIntermediateModels,
+                        LabelModelJob& job)
+{
+  vtkNew<vtkImageData> labelImage;
+  switch (image->GetScalarType())
+  {
+    vtkTemplateMacro(ExtractLabelImage(image, static_cast<VTK_TT*>(image->GetScalarPointer()),
+                                       job.Label, job.Extent, pad, labelImage));
+    default:
+      job.Failed = true;
+      return;
+  }
+
+  vtkNew<vtkFlyingEdges3D> mcubes;
+  mcubes->SetInputData(labelImage);
+  mcubes->SetValue(0, 100.5);
+  mcubes->ComputeScalarsOff();
+  mcubes->ComputeGradientsOff();
+  mcubes->ComputeNormalsOff();
+  mcubes->Update();
+  if (mcubes->GetOutput()->GetNumberOfPolys() == 0)
+  {
+    // no model is generated, reported by the caller
+    return;
+  }
+  if (saveIntermediateModels)
+  {
+    job.MarchingCubesModel = vtkSmartPointer<vtkPolyData>::New();
+    job.MarchingCubesModel->ShallowCopy(mcubes->GetOutput());
+  }
+
+  vtkNew<vtkDecimatePro> decimator;
+  decimator->SetInputConnection(mcubes->GetOutputPort());
+  decimator->SetFeatureAngle(60);
+  decimator->SplittingOff();
+  decimator->PreserveTopologyOn();
+  decimator->SetMaximumError(1);
+  decimator->SetTargetReduction(decimate);
+  decimator->Update();
+  if (saveIntermediateModels)
+  {
+    job.DecimatedModel = vtkSmartPointer<vtkPolyData>::New();
+    job.DecimatedModel->ShallowCopy(decimator->GetOutput());
+  }
+
+  vtkAlgorithmOutput* decimatedOutputPort = decimator->GetOutputPort();
+  vtkNew<vtkReverseSense> reverser;
+  if (ijkToLpsMatrix->Determinant() < 0)
+  {
+    reverser->SetInputConnection(decimator->GetOutputPort());
+    reverser->ReverseNormalsOn();
+    decimatedOutputPort = reverser->GetOutputPort();
+  }
+
+  vtkSmartPointer<vtkPolyDataAlgorithm> smoother;
+  if (sincFilter)
+  {
+    vtkNew<vtkWindowedSincPolyDataFilter> smootherSinc;
+    smootherSinc->SetPassBand(0.1);
+    smootherSinc->SetNumberOfIterations(smooth);
+    smootherSinc->FeatureEdgeSmoothingOff();
+    smootherSinc->BoundarySmoothingOff();
+    smoother = smootherSinc.GetPointer();
+  }
+  else
+  {
+    vtkNew<vtkSmoothPolyDataFilter> smootherPoly;
+    smootherPoly->SetRelaxationFactor(0.33);
+    smootherPoly->SetFeatureAngle(60);
+    smootherPoly->SetConvergence(0);
+    smootherPoly->SetNumberOfIterations(smooth);
+    smootherPoly->FeatureEdgeSmoothingOff();
+    smootherPoly->BoundarySmoothingOff();
+    smoother = smootherPoly.GetPointer();
+  }
+  smoother->SetInputConnection(decimatedOutputPort);
+  smoother->Update();
+  if (saveIntermediateModels)
+  {
+    job.SmoothedModel = vtkSmartPointer<vtkPolyData>::New();
+    job.SmoothedModel->ShallowCopy(smoother->GetOutput());
+  }
+
+  // transforms are not shared between threads
+  vtkNew<vtkTransform> transformIJKtoLPS;
+  transformIJKtoLPS->SetMatrix(ijkToLpsMatrix);
+  vtkNew<vtkTransformPolyDataFilter> transformer;
+  transformer->SetInputConnection(smoother->GetOutputPort());
+  transformer->SetTransform(transformIJKtoLPS);
+
+  vtkNew<vtkPolyDataNormals> normals;
+  normals->SetComputePointNormals(pointNormals);
+  normals->SetInputConnection(transformer->GetOutputPort());
+  normals->SetFeatureAngle(60);
+  normals->SetSplitting(splitNormals);
+
+  vtkNew<vtkStripper> stripper;
+  stripper->SetInputConnection(normals->GetOutputPort());
+  stripper->Update();
+
+  job.Model = vtkSmartPointer<vtkPolyData>::New();
+  job.Model->ShallowCopy(stripper->GetOutput());
+}
+
+//----------------------------------------------------------------------------
+bool WriteModel(vtkPolyData* model, const std::string& fileName, const char* header)
+{
+  vtkNew<vtkPolyDataWriter> writer;
+  writer->SetInputData(model);
+  writer->SetHeader(header);
+  writer->SetFileType(2);
+  writer->SetFileName(fileName.c_str());
+  return writer->Write() != 0;
+}
+
+//----------------------------------------------------------------------------
+/// Add a model node with storage and display nodes to the output scene and put it in the model hierarchy.
+void AddModelToScene(vtkMRMLScene* modelScene, const std::string& labelName, const std::string& fileName, int label,
+                     vtkMRMLColorTableNode* colorNode, vtkMRMLModelHierarchyNode* topColorHierarchyNode,
+                     vtkMRMLNode* rnd, bool debug)
+{
+  if (debug)
+  {
+    std::cout << "Adding model " << labelName << " to the output scene, with filename " << fileName.c_str()
+              << endl;
+  }
+  // each model needs a mrml node, a storage node and a display node
+  vtkNew<vtkMRMLModelNode> mnode;
+  mnode->SetScene(modelScene);
+  mnode->SetName(labelName.c_str());
+
+  vtkNew<vtkMRMLModelStorageNode> snode;
+  snode->SetFileName(fileName.c_str());
+  if (modelScene->AddNode(snode.GetPointer()) == nullptr)
+  {
+    std::cerr << "ERROR: unable to add the storage node to the model scene" << endl;
+  }
+  vtkNew<vtkMRMLModelDisplayNode> dnode;
+  dnode->SetColor(0.5, 0.5, 0.5);
+  double *rgba;
+  if (colorNode != nullptr)
+  {
+    rgba = colorNode->GetLookupTable()->GetTableValue(label);
+    if (rgba != nullptr)
+    {
+      if (debug)
+      {
+        std::cout << "Got color: " << rgba[0] << " " << rgba[1] << " " << rgba[2] << " " << rgba[3] << endl;
+      }
+      dnode->SetColor(rgba[0], rgba[1], rgba[2]);
+    }
+    else
+    {
+      std::cerr << "Couldn't get look up table value for " << label << ", display node color is not set (grey)"
+                << endl;
+    }
+  }
+
+  dnode->SetVisibility(1);
+  modelScene->AddNode(dnode.GetPointer());
+  if (debug)
+  {
+    std::cout << "Added display node: id = " << (dnode->GetID() == nullptr ? "(null)" : dnode->GetID()) << endl;
+    std::cout << "Setting model's storage node: id = "
+              << (snode->GetID() == nullptr ? "(null)" : snode->GetID()) << endl;
+  }
+  mnode->SetAndObserveStorageNodeID(snode->GetID());
+  mnode->SetAndObserveDisplayNodeID(dnode->GetID());
+  modelScene->AddNode(mnode.GetPointer());
+
+  // put it in the hierarchy, either the flat one by default or
+  // try to find the matching color hierarchy node to make this an
+  // associated node
+  std::string colorName;
+  if (colorNode != nullptr)
+  {
+    colorName = std::string(colorNode->GetColorNameAsFileName(label));
+  }
+  else
+  {
+    // might be in a testing case where the hierarchy nodes are
+    // numbered (made from the generic colors)
+    std::stringstream ss;
+    ss << label;
+    colorName = ss.str();
+    if (debug)
+    {
+      std::cout << "No color node, guessing at color name being same as label number " << colorName.c_str() << std::endl;
+    }
+  }
+  vtkMRMLNode *mrmlNode = nullptr;
+  if (colorName.compare("") != 0)
+  {
+    mrmlNode = modelScene->GetFirstNodeByName(colorName.c_str());
+  }
+  // if there's no color hierarchy, or no color name or the mrml node
+  // named for the color isn't a model hierarchy node, use a flat hierarchy
+  if (topColorHierarchyNode == nullptr ||
+      colorName.compare("") == 0 ||
+      mrmlNode == nullptr ||
+      strcmp(mrmlNode->GetClassName(),"vtkMRMLModelHierarchyNode") != 0)
+  {
+    vtkNew<vtkMRMLModelHierarchyNode> mhnd;
+    mhnd->SetHideFromEditors(1);
+    modelScene->AddNode(mhnd.GetPointer());
+    mhnd->SetParentNodeID(rnd->GetID());
+    mhnd->SetModelNodeID(mnode->GetID());
+  }
+  else
+  {
+    // use the template color hierarchy
+    vtkMRMLModelHierarchyNode *colorHierarchyNode = vtkMRMLModelHierarchyNode::SafeDownCast(mrmlNode);
+    if (colorHierarchyNode)
+    {
+      colorHierarchyNode->SetAssociatedNodeID(mnode->GetID());
+      // and hide it so that it doesn't clutter up the tree
+      colorHierarchyNode->SetHideFromEditors(1);
+      if (debug)
+      {
+        std::cout << "Found a color hierarchy node with name " << colorHierarchyNode->GetName() << ", set it's associated node to this model id: " << mnode->GetID() << std::endl;
+      }
+    }
+  }
+  if (debug)
+  {
+    std::cout << "...done adding model to output scene" << endl;
+  }
+}
+
+} // namespace
+
 int main(int argc, char * argv[])
 {
   PARSE_ARGS;
@@ -851,6 +1225,16 @@ int main(int argc, char * argv[])
   transformIJKtoLPS->Scale(-1.0, -1.0, 1.0); // RAS to LPS
   transformIJKtoLPS->Concatenate(ijkToRasMatrix);
 
+  // In parallel mode the loop below only collects the labels to process, the models
+  // are generated from cropped label images in worker threads after the loop.
+  // Joint smoothing extracts all the models from a single mesh, so it is always serial.
+  bool generateInParallel = (Parallel && !JointSmoothing);
+  if (Parallel && JointSmoothing)
+  {
+    std::cout << "Parallel mode is not available with joint smoothing, generating models serially." << endl;
+  }
+  std::vector<LabelModelJob> labelModelJobs;
+
   //
   // Loop through all the labels
   //
@@ -981,6 +1365,15 @@ int main(int argc, char * argv[])
       */
     }
 
+    if (generateInParallel)
+    {
+      LabelModelJob job;
+      job.Label = i;
+      job.LabelName = labelName;
+      labelModelJobs.push_back(job);
+      continue;
+    }
+
     // threshold
     if (JointSmoothing == 0)
     {
@@ -1619,115 +2012,152 @@ int main(int argc, char * argv[])
       writer = nullptr;
       if (modelScene.GetPointer() != nullptr)
       {
-        if (debug)
-        {
-          std::cout << "Adding model " << labelName << " to the output scene, with filename " << fileName.c_str()
-                    << endl;
-        }
-        // each model needs a mrml node, a storage node and a display node
-        vtkNew<vtkMRMLModelNode> mnode;
-        mnode->SetScene(modelScene.GetPointer());
-        mnode->SetName(labelName.c_str());
-
-        vtkNew<vtkMRMLModelStorageNode> snode;
-        snode->SetFileName(fileName.c_str());
-        if (modelScene->AddNode(snode.GetPointer()) == nullptr)
-        {
-          std::cerr << "ERROR: unable to add the storage node to the model scene" << endl;
-        }
-        vtkNew<vtkMRMLModelDisplayNode> dnode;
-        dnode->SetColor(0.5, 0.5, 0.5);
-        double *rgba;
-        if (colorNode != nullptr)
+        AddModelToScene(modelScene, labelName, fileName, i, colorNode, topColorHierarchyNode, rnd, debug);
+      }
+    } // end of skipping an empty label
+  }   // end of loop over labels
+
+  if (generateInParallel && !labelModelJobs.empty())
+  {
+    // Get bounding box of all the labels in a single pass
+    int minimumLabel = labelModelJobs[0].Label;
+    int maximumLabel = labelModelJobs[0].Label;
+    for (const LabelModelJob& job : labelModelJobs)
+    {
+      minimumLabel = std::min(minimumLabel, job.Label);
+      maximumLabel = std::max(maximumLabel, job.Label);
+    }
+    std::unordered_map<int, int> labelToJobIndex;
+    labelToJobIndex.reserve(labelModelJobs.size());
+    for (::size_t jobIndex = 0; jobIndex < labelModelJobs.size(); jobIndex++)
+    {
+      labelToJobIndex[labelModelJobs[jobIndex].Label] = static_cast<int>(jobIndex);
+    }
+    switch (image->GetScalarType())
+    {
+      vtkTemplateMacro(ComputeLabelExtents(image, static_cast<VTK_TT*>(image->GetScalarPointer()),
+                                           minimumLabel, maximumLabel, labelToJobIndex, labelModelJobs));
+      default:
+        std::cerr << "ERROR: unsupported input volume scalar type " << image->GetScalarTypeAsString() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Generate the models in worker threads. Progress of the individual filters is not
+    // reported, as the filter watchers are not thread-safe.
+    if (strcmp(FilterType.c_str(), "Sinc") == 0 && Smooth == 1)
+    {
+      std::cerr << "Warning: Smoothing iterations of 1 not allowed for Sinc filter, using 2" << endl;
+      Smooth = 2;
+    }
+    if (NumberOfThreads > 0)
+    {
+      vtkSMPTools::Initialize(NumberOfThreads);
+    }
+    if (debug)
+    {
+      std::cout << "Generating " << labelModelJobs.size() << " models using up to "
+                << vtkSMPTools::GetEstimatedNumberOfThreads() << " threads" << endl;
+    }
+    vtkMatrix4x4* ijkToLpsMatrix = transformIJKtoLPS->GetMatrix();
+    bool sincFilter = (strcmp(FilterType.c_str(), "Sinc") == 0);
+    // Labels are processed in batches to limit the number of models kept in memory
+    const ::size_t batchSize = 2 * static_cast<size_t>(std::max(1, vtkSMPTools::GetEstimatedNumberOfThreads()));
+    for (::size_t batchStart = 0; batchStart < labelModelJobs.size(); batchStart += batchSize)
+    {
+      ::size_t batchEnd = std::min(batchStart + batchSize, labelModelJobs.size());
+      vtkSMPTools::For(static_cast<vtkIdType>(batchStart), static_cast<vtkIdType>(batchEnd), 1,
+        [&](vtkIdType firstJobIndex, vtkIdType lastJobIndex)
         {
-          rgba = colorNode->GetLookupTable()->GetTableValue(i);
-          if (rgba != nullptr)
+          for (vtkIdType jobIndex = firstJobIndex; jobIndex < lastJobIndex; jobIndex++)
           {
-            if (debug)
+            LabelModelJob& job = labelModelJobs[jobIndex];
+            if (job.Extent[0] > job.Extent[1])
             {
-              std::cout << "Got color: " << rgba[0] << " " << rgba[1] << " " << rgba[2] << " " << rgba[3] << endl;
+              // no voxels with this label
+              continue;
+            }
+            try
+            {
+              GenerateLabelModel(image, ijkToLpsMatrix, Pad, Decimate, Smooth, sincFilter,
+                                 SplitNormals, PointNormals, SaveIntermediateModels, job);
+            }
+            catch(...)
+            {
+              job.Failed = true;
             }
-            dnode->SetColor(rgba[0], rgba[1], rgba[2]);
-          }
-          else
-          {
-            std::cerr << "Couldn't get look up table value for " << i << ", display node color is not set (grey)"
-                      << endl;
           }
-        }
-
-        dnode->SetVisibility(1);
-        modelScene->AddNode(dnode.GetPointer());
-        if (debug)
+        });
+
+      // Write the models and add them to the scene in label order, so that the output
+      // is the same regardless of the order of completion of the worker threads.
+      for (::size_t jobIndex = batchStart; jobIndex < batchEnd; jobIndex++)
+      {
+        LabelModelJob& job = labelModelJobs[jobIndex];
+        std::cout << "<filter-progress>"
+                  << static_cast<float>(jobIndex + 1) / labelModelJobs.size()
+                  << "</filter-progress>"
+                  << std::endl
+                  << std::flush;
+        if (job.Failed)
         {
-          std::cout << "Added display node: id = " << (dnode->GetID() == nullptr ? "(null)" : dnode->GetID()) << endl;
-          std::cout << "Setting model's storage node: id = "
-                    << (snode->GetID() == nullptr ? "(null)" : snode->GetID()) << endl;
+          std::cerr << "ERROR while generating model for label " << job.Label << std::endl;
+          return EXIT_FAILURE;
         }
-        mnode->SetAndObserveStorageNodeID(snode->GetID());
-        mnode->SetAndObserveDisplayNodeID(dnode->GetID());
-        modelScene->AddNode(mnode.GetPointer());
-
-        // put it in the hierarchy, either the flat one by default or
-        // try to find the matching color hierarchy node to make this an
-        // associated node
-        std::string colorName;
-        if (colorNode != nullptr)
+        if (job.Model == nullptr || job.Model->GetNumberOfPolys() + job.Model->GetNumberOfStrips() == 0)
         {
-          colorName = std::string(colorNode->GetColorNameAsFileName(i));
+          std::cout << "Cannot create a model from label " << job.Label
+                    << "\nNo polygons can be created,\nthere may be no voxels with this label in the volume." << endl;
+          std::cout << "...continuing" << endl;
+          continue;
         }
-        else
+        std::string filePrefix = (rootDir != "" ? rootDir + std::string("/") : std::string()) + job.LabelName;
+        if (SaveIntermediateModels)
         {
-          // might be in a testing case where the hierarchy nodes are
-          // numbered (made from the generic colors)
-          std::stringstream ss;
-          ss << i;
-          colorName = ss.str();
-          if (debug)
+          const std::pair<vtkPolyData*, std::string> intermediateModels[3] =
           {
-            std::cout << "No color node, guessing at color name being same as label number " << colorName.c_str() << std::endl;
+            { job.MarchingCubesModel, "-MarchingCubes.vtk" },
+            { job.DecimatedModel, "-Decimated.vtk" },
+            { job.SmoothedModel, "-Smoothed.vtk" }
+          };
+          for (const std::pair<vtkPolyData*, std::string>& intermediateModel : intermediateModels)
+          {
+            std::string fileName = filePrefix + intermediateModel.second;
+            if (debug)
+            {
+              std::cout << "Writing intermediate file " << fileName.c_str() << std::endl;
+            }
+            if (!WriteModel(intermediateModel.first, fileName, modelFileHeader))
+            {
+              std::cerr << "ERROR: Failed to write intermediate file " << fileName.c_str() << std::endl;
+            }
           }
         }
-        vtkMRMLNode *mrmlNode = nullptr;
-        if (colorName.compare("") != 0)
+
+        if (rootDir == "")
         {
-          mrmlNode = modelScene->GetFirstNodeByName(colorName.c_str());
+          std::cout << "WARNING: output directory is an empty string..." << endl;
         }
-        // if there's no color hierarchy, or no color name or the mrml node
-        // named for the color isn't a model hierarchy node, use a flat hierarchy
-        if (topColorHierarchyNode == nullptr ||
-            colorName.compare("") == 0 ||
-            mrmlNode == nullptr ||
-            strcmp(mrmlNode->GetClassName(),"vtkMRMLModelHierarchyNode") != 0)
+        std::string fileName = filePrefix + std::string(".vtk");
+        if (debug)
         {
-          vtkNew<vtkMRMLModelHierarchyNode> mhnd;
-          mhnd->SetHideFromEditors(1);
-          modelScene->AddNode(mhnd.GetPointer());
-          mhnd->SetParentNodeID(rnd->GetID());
-          mhnd->SetModelNodeID(mnode->GetID());
+          std::cout << "Writing model " << " " << job.LabelName << " to file " << fileName << endl;
         }
-        else
+        if (!WriteModel(job.Model, fileName, modelFileHeader))
         {
-          // use the template color hierarchy
-          vtkMRMLModelHierarchyNode *colorHierarchyNode = vtkMRMLModelHierarchyNode::SafeDownCast(mrmlNode);
-          if (colorHierarchyNode)
-          {
-            colorHierarchyNode->SetAssociatedNodeID(mnode->GetID());
-            // and hide it so that it doesn't clutter up the tree
-            colorHierarchyNode->SetHideFromEditors(1);
-            if (debug)
-            {
-              std::cout << "Found a color hierarchy node with name " << colorHierarchyNode->GetName() << ", set it's associated node to this model id: " << mnode->GetID() << std::endl;
-            }
-          }
+          std::cerr << "ERROR: Failed to write model file " << fileName.c_str() << std::endl;
         }
-        if (debug)
+        // release memory as soon as possible
+        job.Model = nullptr;
+        job.MarchingCubesModel = nullptr;
+        job.DecimatedModel = nullptr;
+        job.SmoothedModel = nullptr;
+        if (modelScene.GetPointer() != nullptr)
         {
-          std::cout << "...done adding model to output scene" << endl;
+          AddModelToScene(modelScene, job.LabelName, fileName, job.Label, colorNode, topColorHierarchyNode, rnd, debug);
         }
       }
-    } // end of skipping an empty label
-  }   // end of loop over labels
+    }
+  }
   if (debug)
   {
     std::cout << "End of looping over labels" << endl;
@@ -1,5 +1,18 @@
 #include "itkTestMain.h"
 
+// MRML includes
+#include <vtkMRMLModelNode.h>
+#include <vtkMRMLScene.h>
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkPolyData.h>
+
+// STD includes
+#include <cmath>
+#include <iostream>
+#include <vector>
+
 #ifdef WIN32
 #define MODULE_IMPORT __declspec(dllimport)
 #else
@@ -8,7 +21,82 @@
 
 extern "C" MODULE_IMPORT int ModuleEntryPoint(int, char * []);
 
+//----------------------------------------------------------------------------
+// Compare the models of two scenes written by ModelMaker (e.g. serial and parallel output).
+// Models are matched by name and must have the same number of points and cells and the same bounds.
+int ModelMakerCompareModels(int argc, char * argv [])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Usage: " << argv[0] << " referenceScene.mrml scene.mrml" << std::endl;
+    return EXIT_FAILURE;
+  }
+  vtkNew<vtkMRMLScene> referenceScene;
+  referenceScene->SetURL(argv[1]);
+  vtkNew<vtkMRMLScene> scene;
+  scene->SetURL(argv[2]);
+  if (!referenceScene->Connect() || !scene->Connect())
+  {
+    std::cerr << "Failed to read scenes " << argv[1] << " and " << argv[2] << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<vtkMRMLNode*> referenceModelNodes;
+  referenceScene->GetNodesByClass("vtkMRMLModelNode", referenceModelNodes);
+  std::vector<vtkMRMLNode*> modelNodes;
+  scene->GetNodesByClass("vtkMRMLModelNode", modelNodes);
+  if (referenceModelNodes.empty() || referenceModelNodes.size() != modelNodes.size())
+  {
+    std::cerr << "Number of models mismatch: " << referenceModelNodes.size()
+              << " (reference) != " << modelNodes.size() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const double boundsTolerance = 1e-3;
+  for (vtkMRMLNode* referenceNode : referenceModelNodes)
+  {
+    vtkMRMLModelNode* referenceModelNode = vtkMRMLModelNode::SafeDownCast(referenceNode);
+    vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(scene->GetFirstNodeByName(referenceModelNode->GetName()));
+    if (!modelNode)
+    {
+      std::cerr << "Model " << referenceModelNode->GetName() << " is not found in " << argv[2] << std::endl;
+      return EXIT_FAILURE;
+    }
+    vtkPolyData* referenceModel = referenceModelNode->GetPolyData();
+    vtkPolyData* model = modelNode->GetPolyData();
+    if (!referenceModel || !model)
+    {
+      std::cerr << "Model " << referenceModelNode->GetName() << " has no mesh" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (referenceModel->GetNumberOfPoints() != model->GetNumberOfPoints()
+      || referenceModel->GetNumberOfCells() != model->GetNumberOfCells())
+    {
+      std::cerr << "Model " << referenceModelNode->GetName() << " mismatch: "
+                << model->GetNumberOfPoints() << " points, " << model->GetNumberOfCells() << " cells, expected "
+                << referenceModel->GetNumberOfPoints() << " points, " << referenceModel->GetNumberOfCells() << " cells"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+    double referenceBounds[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+    referenceModel->GetBounds(referenceBounds);
+    double bounds[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+    model->GetBounds(bounds);
+    for (int i = 0; i < 6; i++)
+    {
+      if (std::abs(referenceBounds[i] - bounds[i]) > boundsTolerance)
+      {
+        std::cerr << "Model " << referenceModelNode->GetName() << " bounds mismatch at index " << i << ": "
+                  << bounds[i] << ", expected " << referenceBounds[i] << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
 void RegisterTests()
 {
   StringToTestFunctionMap["ModuleEntryPoint"] = ModuleEntryPoint;
+  StringToTestFunctionMap["ModelMakerCompareModels"] = ModelMakerCompareModels;
 }
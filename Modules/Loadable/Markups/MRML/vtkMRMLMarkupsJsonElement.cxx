@@ -28,10 +28,13 @@
 #include "rapidjson/prettywriter.h" // for stringify JSON
 #include "rapidjson/filereadstream.h"
 #include "rapidjson/filewritestream.h"
+#include "rapidjson/reader.h"
 
 #include <vtkMRMLMarkupsJsonElement_Private.h>
 
 // VTK include
+#include "vtkBase64Utilities.h"
+#include "vtkByteSwap.h"
 #include "vtkCommand.h"
 #include "vtkDoubleArray.h"
 #include <vtkObjectFactory.h>
@@ -39,10 +42,650 @@
 // MRML include
 #include "vtkCodedEntry.h"
 
+// STD includes
+#include <algorithm>
+#include <cstring>
+#include <string>
+
 vtkStandardNewMacro(vtkMRMLMarkupsJsonElement);
 vtkStandardNewMacro(vtkMRMLMarkupsJsonReader);
 vtkStandardNewMacro(vtkMRMLMarkupsJsonWriter);
 
+namespace
+{
+
+//---------------------------------------------------------------------------
+// Encode values as little endian 64-bit floating-point numbers in base64.
+std::string EncodeBase64DoubleArray(const double* values, size_t numberOfValues)
+{
+  std::vector<double> littleEndianValues(values, values + numberOfValues);
+  vtkByteSwap::SwapLERange(littleEndianValues.data(), littleEndianValues.size());
+  size_t numberOfBytes = numberOfValues * sizeof(double);
+  std::vector<unsigned char> encoded((numberOfBytes + 2) / 3 * 4 + 1);
+  unsigned long encodedLength = vtkBase64Utilities::Encode(
+    reinterpret_cast<const unsigned char*>(littleEndianValues.data()),
+    static_cast<unsigned long>(numberOfBytes), encoded.data());
+  return std::string(reinterpret_cast<const char*>(encoded.data()), encodedLength);
+}
+
+//---------------------------------------------------------------------------
+// Decode base64-encoded little endian 64-bit floating-point numbers.
+bool DecodeBase64DoubleArray(const std::string& encoded, std::vector<double>& values)
+{
+  std::vector<unsigned char> decoded(encoded.size() / 4 * 3 + 3);
+  size_t decodedLength = vtkBase64Utilities::DecodeSafely(
+    reinterpret_cast<const unsigned char*>(encoded.c_str()), encoded.size(), decoded.data(), decoded.size());
+  if (decodedLength % sizeof(double) != 0)
+  {
+    return false;
+  }
+  values.resize(decodedLength / sizeof(double));
+  if (!values.empty())
+  {
+    memcpy(values.data(), decoded.data(), decodedLength);
+    vtkByteSwap::SwapLERange(values.data(), values.size());
+  }
+  return true;
+}
+
+//---------------------------------------------------------------------------
+// Binary array that is stored as a JSON object (with base64-encoded data) in the file.
+struct StreamedBinaryArray
+{
+  std::string Encoding{ "base64" };
+  std::string ComponentType{ "float64" };
+  std::string ByteOrder{ "little" };
+  int NumberOfComponents{ 1 };
+  std::string Data;
+};
+
+//---------------------------------------------------------------------------
+// SAX handler that forwards all parsing events to a rapidjson document, except
+// control points of markups. Control points are stored directly in compact
+// StreamedControlPoint structures, without creating a JSON value for each point.
+// Binary-encoded control point positions and orientations are decoded directly
+// into these structures, too.
+class MarkupsJsonStreamHandler
+{
+public:
+  typedef vtkMRMLMarkupsJsonElement::StreamedControlPoint StreamedControlPoint;
+  typedef std::map<int, std::vector<StreamedControlPoint>> StreamedControlPointsMap;
+
+  MarkupsJsonStreamHandler(rapidjson::Document& document, StreamedControlPointsMap& streamedControlPoints)
+    : Document(document)
+    , StreamedControlPoints(streamedControlPoints)
+  {
+  }
+
+  // Error message that explains why parsing was aborted by the handler
+  std::string ErrorMessage;
+
+  //---------------------------------------------------------------------------
+  // rapidjson handler interface
+
+  bool Null()
+  {
+    if (this->Capture != CaptureNone)
+    {
+      return this->CaptureScalar();
+    }
+    return this->BeginValue() && this->Document.Null();
+  }
+
+  bool Bool(bool b)
+  {
+    if (this->Capture == CaptureControlPoints)
+    {
+      if (this->CaptureDepth == 1 && this->CurrentControlPoint)
+      {
+        if (this->CaptureKey == "selected")
+        {
+          this->CurrentControlPoint->HasSelected = true;
+          this->CurrentControlPoint->Selected = b;
+        }
+        else if (this->CaptureKey == "locked")
+        {
+          this->CurrentControlPoint->HasLocked = true;
+          this->CurrentControlPoint->Locked = b;
+        }
+        else if (this->CaptureKey == "visibility")
+        {
+          this->CurrentControlPoint->HasVisibility = true;
+          this->CurrentControlPoint->Visibility = b;
+        }
+        return true;
+      }
+      return this->CaptureScalar();
+    }
+    else if (this->Capture != CaptureNone)
+    {
+      return this->CaptureScalar();
+    }
+    return this->BeginValue() && this->Document.Bool(b);
+  }
+
+  bool Int(int i)
+  {
+    if (this->Capture != CaptureNone)
+    {
+      return this->CaptureNumber(i);
+    }
+    return this->BeginValue() && this->Document.Int(i);
+  }
+
+  bool Uint(unsigned int i)
+  {
+    if (this->Capture != CaptureNone)
+    {
+      return this->CaptureNumber(i);
+    }
+    return this->BeginValue() && this->Document.Uint(i);
+  }
+
+  bool Int64(int64_t i)
+  {
+    if (this->Capture != CaptureNone)
+    {
+      return this->CaptureNumber(static_cast<double>(i));
+    }
+    return this->BeginValue() && this->Document.Int64(i);
+  }
+
+  bool Uint64(uint64_t i)
+  {
+    if (this->Capture != CaptureNone)
+    {
+      return this->CaptureNumber(static_cast<double>(i));
+    }
+    return this->BeginValue() && this->Document.Uint64(i);
+  }
+
+  bool Double(double d)
+  {
+    if (this->Capture != CaptureNone)
+    {
+      return this->CaptureNumber(d);
+    }
+    return this->BeginValue() && this->Document.Double(d);
+  }
+
+  bool RawNumber(const char* str, rapidjson::SizeType length, bool copy)
+  {
+    // only called if kParseNumbersAsStringsFlag is used
+    if (this->Capture != CaptureNone)
+    {
+      return this->CaptureScalar();
+    }
+    return this->BeginValue() && this->Document.RawNumber(str, length, copy);
+  }
+
+  bool String(const char* str, rapidjson::SizeType length, bool copy)
+  {
+    if (this->Capture == CaptureControlPoints)
+    {
+      if (this->CaptureDepth == 1 && this->CurrentControlPoint)
+      {
+        std::string* target = nullptr;
+        if (this->CaptureKey == "id")
+        {
+          target = &this->CurrentControlPoint->ID;
+        }
+        else if (this->CaptureKey == "label")
+        {
+          target = &this->CurrentControlPoint->Label;
+        }
+        else if (this->CaptureKey == "description")
+        {
+          target = &this->CurrentControlPoint->Description;
+        }
+        else if (this->CaptureKey == "associatedNodeID")
+        {
+          target = &this->CurrentControlPoint->AssociatedNodeID;
+        }
+        else if (this->CaptureKey == "positionStatus")
+        {
+          target = &this->CurrentControlPoint->PositionStatus;
+          this->CurrentControlPoint->HasPositionStatus = true;
+        }
+        if (target)
+        {
+          target->assign(str, length);
+        }
+        return true;
+      }
+      return this->CaptureScalar();
+    }
+    else if (this->Capture == CaptureBinaryArray)
+    {
+      if (this->CaptureDepth == 1)
+      {
+        if (this->CaptureKey == "data")
+        {
+          this->CurrentBinaryArray.Data.assign(str, length);
+        }
+        else if (this->CaptureKey == "encoding")
+        {
+          this->CurrentBinaryArray.Encoding.assign(str, length);
+        }
+        else if (this->CaptureKey == "componentType")
+        {
+          this->CurrentBinaryArray.ComponentType.assign(str, length);
+        }
+        else if (this->CaptureKey == "byteOrder")
+        {
+          this->CurrentBinaryArray.ByteOrder.assign(str, length);
+        }
+      }
+      return true;
+    }
+    return this->BeginValue() && this->Document.String(str, length, copy);
+  }
+
+  bool StartObject()
+  {
+    if (this->Capture == CaptureControlPoints)
+    {
+      if (this->CaptureDepth == 0)
+      {
+        std::vector<StreamedControlPoint>& controlPoints = this->StreamedControlPoints[this->CurrentMarkupIndex];
+        controlPoints.emplace_back();
+        this->CurrentControlPoint = &controlPoints.back();
+      }
+      else
+      {
+        this->InvalidateVector();
+      }
+      this->CaptureDepth++;
+      return true;
+    }
+    else if (this->Capture == CaptureBinaryArray)
+    {
+      this->CaptureDepth++;
+      return true;
+    }
+
+    if (this->IsInMarkupObject() && !this->HeldKey.empty())
+    {
+      if (this->HeldKey == "controlPointPositions" || this->HeldKey == "controlPointOrientations")
+      {
+        this->Capture = CaptureBinaryArray;
+        this->CaptureDepth = 1;
+        this->CaptureKey.clear();
+        this->CurrentBinaryArray = StreamedBinaryArray();
+        return true;
+      }
+    }
+
+    if (!this->BeginValue())
+    {
+      return false;
+    }
+    if (this->IsInMarkupsArray())
+    {
+      this->CurrentMarkupIndex = static_cast<int>(this->Containers.back().NumberOfValues) - 1;
+    }
+    this->Containers.push_back(Container{ true, 0 });
+    return this->Document.StartObject();
+  }
+
+  bool Key(const char* str, rapidjson::SizeType length, bool copy)
+  {
+    if (this->Capture != CaptureNone)
+    {
+      if (this->CaptureDepth == 1)
+      {
+        this->CaptureKey.assign(str, length);
+      }
+      return true;
+    }
+    this->LastKey.assign(str, length);
+    if (this->IsInMarkupObject()
+      && (this->LastKey == "controlPoints"
+      || this->LastKey == "controlPointPositions"
+      || this->LastKey == "controlPointOrientations"))
+    {
+      // Decision about streaming can only be made when we see the type of the value
+      this->HeldKey = this->LastKey;
+      return true;
+    }
+    return this->Document.Key(str, length, copy);
+  }
+
+  bool EndObject(rapidjson::SizeType vtkNotUsed(memberCount))
+  {
+    if (this->Capture == CaptureControlPoints)
+    {
+      this->CaptureDepth--;
+      if (this->CaptureDepth == 0)
+      {
+        this->CurrentControlPoint = nullptr;
+      }
+      else if (this->CaptureDepth == 1)
+      {
+        // end of an object in a control point vector property
+        this->EndVector();
+      }
+      return true;
+    }
+    else if (this->Capture == CaptureBinaryArray)
+    {
+      this->CaptureDepth--;
+      if (this->CaptureDepth == 0)
+      {
+        this->PendingBinaryArrays[this->HeldKey] = this->CurrentBinaryArray;
+        this->CurrentBinaryArray = StreamedBinaryArray();
+        this->HeldKey.clear();
+        this->Capture = CaptureNone;
+      }
+      return true;
+    }
+
+    bool endOfMarkupObject = this->IsInMarkupObject();
+    if (endOfMarkupObject)
+    {
+      // A held key must have been followed by a value, therefore it must have been already processed by now
+      if (!this->ApplyBinaryArrays())
+      {
+        return false;
+      }
+    }
+    // Members that were streamed are not added to the document, therefore the number of
+    // members in the document may be different from the number of members in the file.
+    rapidjson::SizeType numberOfMembers = this->Containers.back().NumberOfValues;
+    this->Containers.pop_back();
+    if (endOfMarkupObject)
+    {
+      this->CurrentMarkupIndex = -1;
+    }
+    return this->Document.EndObject(numberOfMembers);
+  }
+
+  bool StartArray()
+  {
+    if (this->Capture == CaptureControlPoints)
+    {
+      if (this->CaptureDepth == 1 && this->CurrentControlPoint
+        && (this->CaptureKey == "position" || this->CaptureKey == "orientation"))
+      {
+        this->VectorKey = this->CaptureKey;
+        this->VectorSize = 0;
+        this->VectorValid = true;
+      }
+      else
+      {
+        this->InvalidateVector();
+      }
+      this->CaptureDepth++;
+      return true;
+    }
+    else if (this->Capture == CaptureBinaryArray)
+    {
+      this->CaptureDepth++;
+      return true;
+    }
+
+    if (this->IsInMarkupObject() && this->HeldKey == "controlPoints")
+    {
+      // Stream control points
+      this->HeldKey.clear();
+      this->Capture = CaptureControlPoints;
+      this->CaptureDepth = 0;
+      this->CaptureKey.clear();
+      this->StreamedControlPoints[this->CurrentMarkupIndex].clear();
+      // The array in the document remains empty
+      this->Containers.back().NumberOfValues++;
+      return this->Document.Key("controlPoints", static_cast<rapidjson::SizeType>(strlen("controlPoints")), true)
+        && this->Document.StartArray();
+    }
+
+    if (!this->BeginValue())
+    {
+      return false;
+    }
+    bool startOfMarkupsArray = (this->Containers.size() == 1 && this->Containers.back().IsObject
+      && this->LastKey == "markups" && this->MarkupsArrayDepth < 0);
+    this->Containers.push_back(Container{ false, 0 });
+    if (startOfMarkupsArray)
+    {
+      this->MarkupsArrayDepth = static_cast<int>(this->Containers.size());
+    }
+    return this->Document.StartArray();
+  }
+
+  bool EndArray(rapidjson::SizeType vtkNotUsed(elementCount))
+  {
+    if (this->Capture == CaptureControlPoints)
+    {
+      if (this->CaptureDepth == 0)
+      {
+        // end of controlPoints array
+        this->Capture = CaptureNone;
+        this->CurrentControlPoint = nullptr;
+        return this->Document.EndArray(0);
+      }
+      this->CaptureDepth--;
+      if (this->CaptureDepth == 1)
+      {
+        this->EndVector();
+      }
+      return true;
+    }
+    else if (this->Capture == CaptureBinaryArray)
+    {
+      this->CaptureDepth--;
+      return true;
+    }
+
+    if (static_cast<int>(this->Containers.size()) == this->MarkupsArrayDepth)
+    {
+      // end of markups array, there can be only one
+      this->MarkupsArrayDepth = -2;
+    }
+    rapidjson::SizeType numberOfElements = this->Containers.back().NumberOfValues;
+    this->Containers.pop_back();
+    return this->Document.EndArray(numberOfElements);
+  }
+
+protected:
+  enum CaptureModes
+  {
+    CaptureNone,
+    CaptureControlPoints,
+    CaptureBinaryArray
+  };
+
+  //---------------------------------------------------------------------------
+  // Returns true if the current container is the top-level markups array
+  bool IsInMarkupsArray()
+  {
+    return this->MarkupsArrayDepth > 0 && static_cast<int>(this->Containers.size()) == this->MarkupsArrayDepth;
+  }
+
+  //---------------------------------------------------------------------------
+  // Returns true if the current container is a markup object (item of the top-level markups array)
+  bool IsInMarkupObject()
+  {
+    return this->CurrentMarkupIndex >= 0 && this->MarkupsArrayDepth > 0
+      && static_cast<int>(this->Containers.size()) == this->MarkupsArrayDepth + 1
+      && this->Containers.back().IsObject;
+  }
+
+  //---------------------------------------------------------------------------
+  // Must be called at the start of each value that is forwarded to the document.
+  bool BeginValue()
+  {
+    if (!this->Containers.empty())
+    {
+      this->Containers.back().NumberOfValues++;
+    }
+    if (!this->HeldKey.empty())
+    {
+      // The value type does not allow streaming, add it to the document
+      std::string heldKey = this->HeldKey;
+      this->HeldKey.clear();
+      return this->Document.Key(heldKey.c_str(), static_cast<rapidjson::SizeType>(heldKey.size()), true);
+    }
+    return true;
+  }
+
+  //---------------------------------------------------------------------------
+  bool CaptureScalar()
+  {
+    if (this->Capture == CaptureControlPoints && this->CaptureDepth == 2)
+    {
+      // non-numeric value in a vector
+      this->InvalidateVector();
+    }
+    return true;
+  }
+
+  //---------------------------------------------------------------------------
+  bool CaptureNumber(double value)
+  {
+    if (this->Capture == CaptureBinaryArray)
+    {
+      if (this->CaptureDepth == 1 && this->CaptureKey == "numberOfComponents")
+      {
+        this->CurrentBinaryArray.NumberOfComponents = static_cast<int>(value);
+      }
+      return true;
+    }
+    if (this->CaptureDepth != 2 || this->VectorKey.empty() || !this->CurrentControlPoint)
+    {
+      return true;
+    }
+    double* vector = (this->VectorKey == "position" ? this->CurrentControlPoint->Position : this->CurrentControlPoint->OrientationMatrix);
+    int maxVectorSize = (this->VectorKey == "position" ? 3 : 9);
+    if (this->VectorSize < maxVectorSize)
+    {
+      vector[this->VectorSize] = value;
+    }
+    this->VectorSize++;
+    return true;
+  }
+
+  //---------------------------------------------------------------------------
+  void InvalidateVector()
+  {
+    if (this->CaptureDepth >= 2)
+    {
+      this->VectorValid = false;
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  void EndVector()
+  {
+    if (this->VectorKey.empty() || !this->CurrentControlPoint)
+    {
+      return;
+    }
+    if (this->VectorKey == "position")
+    {
+      this->CurrentControlPoint->HasPosition = (this->VectorValid && this->VectorSize == 3);
+    }
+    else
+    {
+      this->CurrentControlPoint->HasOrientation = (this->VectorValid && this->VectorSize == 9);
+    }
+    this->VectorKey.clear();
+  }
+
+  //---------------------------------------------------------------------------
+  // Decode binary arrays and set the values in the streamed control points of the current markup.
+  bool ApplyBinaryArrays()
+  {
+    if (this->PendingBinaryArrays.empty())
+    {
+      return true;
+    }
+    std::vector<StreamedControlPoint>& controlPoints = this->StreamedControlPoints[this->CurrentMarkupIndex];
+    for (const auto& keyAndArray : this->PendingBinaryArrays)
+    {
+      const std::string& propertyName = keyAndArray.first;
+      const StreamedBinaryArray& binaryArray = keyAndArray.second;
+      bool positions = (propertyName == "controlPointPositions");
+      int expectedNumberOfComponents = (positions ? 3 : 9);
+      if (binaryArray.Encoding != "base64" || binaryArray.ComponentType != "float64" || binaryArray.ByteOrder != "little")
+      {
+        this->ErrorMessage = "Property " + propertyName + " uses unsupported encoding (only base64-encoded"
+          " little endian float64 is supported)";
+        return false;
+      }
+      if (binaryArray.NumberOfComponents != expectedNumberOfComponents)
+      {
+        this->ErrorMessage = "Property " + propertyName + " is expected to have "
+          + std::to_string(expectedNumberOfComponents) + " components";
+        return false;
+      }
+      std::vector<double> values;
+      if (!DecodeBase64DoubleArray(binaryArray.Data, values))
+      {
+        this->ErrorMessage = "Property " + propertyName + " contains invalid base64-encoded data";
+        return false;
+      }
+      if (values.size() != controlPoints.size() * expectedNumberOfComponents)
+      {
+        this->ErrorMessage = "Property " + propertyName + " contains " + std::to_string(values.size())
+          + " values, expected " + std::to_string(controlPoints.size() * expectedNumberOfComponents)
+          + " (number of control points x " + std::to_string(expectedNumberOfComponents) + ")";
+        return false;
+      }
+      const double* valuesPtr = values.data();
+      for (StreamedControlPoint& controlPoint : controlPoints)
+      {
+        if (positions)
+        {
+          std::copy(valuesPtr, valuesPtr + 3, controlPoint.Position);
+          controlPoint.HasPosition = true;
+        }
+        else
+        {
+          std::copy(valuesPtr, valuesPtr + 9, controlPoint.OrientationMatrix);
+          controlPoint.HasOrientation = true;
+        }
+        valuesPtr += expectedNumberOfComponents;
+      }
+    }
+    this->PendingBinaryArrays.clear();
+    return true;
+  }
+
+  rapidjson::Document& Document;
+  StreamedControlPointsMap& StreamedControlPoints;
+
+  // Object or array that is forwarded to the document
+  struct Container
+  {
+    bool IsObject;
+    // Number of values (array elements or object members) added to the document
+    rapidjson::SizeType NumberOfValues;
+  };
+  std::vector<Container> Containers;
+  std::string LastKey;
+  // Key that is not forwarded to the document yet (because its value may be streamed)
+  std::string HeldKey;
+
+  // Depth of the top-level "markups" array (-1 = not found yet, -2 = already processed)
+  int MarkupsArrayDepth{ -1 };
+  int CurrentMarkupIndex{ -1 };
+
+  int Capture{ CaptureNone };
+  // Nesting level within the captured value
+  int CaptureDepth{ 0 };
+  std::string CaptureKey;
+
+  StreamedControlPoint* CurrentControlPoint{ nullptr };
+  std::string VectorKey;
+  int VectorSize{ 0 };
+  bool VectorValid{ false };
+
+  StreamedBinaryArray CurrentBinaryArray;
+  std::map<std::string, StreamedBinaryArray> PendingBinaryArrays;
+};
+
+}
+
 //---------------------------------------------------------------------------
 // vtkInternal methods
 
@@ -274,6 +917,14 @@ vtkMRMLMarkupsJsonElement* vtkMRMLMarkupsJsonElement::GetArrayProperty(const cha
     return nullptr;
   }
   jsonArray->Internal->JsonRoot = this->Internal->JsonRoot;
+  if (this->Internal->IsDocumentRoot && strcmp(arrayName, "markups") == 0)
+  {
+    jsonArray->Internal->IsMarkupsArray = true;
+  }
+  else if (this->Internal->MarkupIndex >= 0 && strcmp(arrayName, "controlPoints") == 0)
+  {
+    jsonArray->Internal->StreamedControlPointsMarkupIndex = this->Internal->MarkupIndex;
+  }
   jsonArray->Register(this);
   return jsonArray;
 }
@@ -320,6 +971,10 @@ vtkMRMLMarkupsJsonElement* vtkMRMLMarkupsJsonElement::GetArrayItem(int childItem
     return nullptr;
   }
   jsonArray->Internal->JsonRoot = this->Internal->JsonRoot;
+  if (this->Internal->IsMarkupsArray)
+  {
+    jsonArray->Internal->MarkupIndex = childItemIndex;
+  }
   jsonArray->Register(this);
   return jsonArray;
 }
@@ -410,6 +1065,21 @@ bool vtkMRMLMarkupsJsonElement::GetStringVectorProperty(const char* propertyName
   return success;
 }
 
+//----------------------------------------------------------------------------
+std::vector<vtkMRMLMarkupsJsonElement::StreamedControlPoint>* vtkMRMLMarkupsJsonElement::GetStreamedControlPoints()
+{
+  if (this->Internal->StreamedControlPointsMarkupIndex < 0 || !this->Internal->JsonRoot)
+  {
+    return nullptr;
+  }
+  auto streamedControlPointsIt = this->Internal->JsonRoot->StreamedControlPoints.find(this->Internal->StreamedControlPointsMarkupIndex);
+  if (streamedControlPointsIt == this->Internal->JsonRoot->StreamedControlPoints.end())
+  {
+    return nullptr;
+  }
+  return &streamedControlPointsIt->second;
+}
+
 //----------------------------------------------------------------------------
 bool vtkMRMLMarkupsJsonElement::HasErrors()
 {
@@ -498,6 +1168,7 @@ vtkMRMLMarkupsJsonReader::~vtkMRMLMarkupsJsonReader()
 void vtkMRMLMarkupsJsonReader::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf(os, indent);
+  os << indent << "StreamControlPoints: " << (this->StreamControlPoints ? "true" : "false") << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -531,9 +1202,30 @@ vtkMRMLMarkupsJsonElement* vtkMRMLMarkupsJsonReader::ReadFromFile(const char* fi
 
   jsonElement->Internal->JsonRoot = std::make_shared<vtkMRMLMarkupsJsonElement::vtkInternal::JsonDocumentContainer>();
 
-  char buffer[4096];
-  rapidjson::FileReadStream fs(fp, buffer, sizeof(buffer));
-  if (jsonElement->Internal->JsonRoot->Document->ParseStream(fs).HasParseError())
+  std::vector<char> buffer(65536);
+  rapidjson::FileReadStream fs(fp, buffer.data(), buffer.size());
+  if (this->StreamControlPoints)
+  {
+    // Control points are parsed directly from the stream, all other values are stored in the document
+    rapidjson::Document* document = jsonElement->Internal->JsonRoot->Document;
+    rapidjson::Reader reader;
+    MarkupsJsonStreamHandler handler(*document, jsonElement->Internal->JsonRoot->StreamedControlPoints);
+    auto generator = [&reader, &fs, &handler](rapidjson::Document&) -> bool
+    {
+      return !reader.Parse(fs, handler).IsError();
+    };
+    document->Populate(generator);
+    if (reader.HasParseError())
+    {
+      vtkErrorToMessageCollectionWithObjectMacro(this, this->GetUserMessages(),
+        "vtkMRMLMarkupsJsonIO::ReadFromFile",
+        "Error parsing the file '" << filePath << "'"
+        << (handler.ErrorMessage.empty() ? std::string() : ": " + handler.ErrorMessage));
+      fclose(fp);
+      return nullptr;
+    }
+  }
+  else if (jsonElement->Internal->JsonRoot->Document->ParseStream(fs).HasParseError())
   {
     vtkErrorToMessageCollectionWithObjectMacro(this, this->GetUserMessages(),
       "vtkMRMLMarkupsJsonIO::ReadFromFile",
@@ -558,6 +1250,7 @@ vtkMRMLMarkupsJsonElement* vtkMRMLMarkupsJsonReader::ReadFromFile(const char* fi
       "Error parsing the file '" << filePath << "' - root item must be array or list");
     return nullptr;
   }
+  jsonElement->Internal->IsDocumentRoot = true;
 
   jsonElement->Register(this);
   return jsonElement;
@@ -770,6 +1463,21 @@ void vtkMRMLMarkupsJsonWriter::WriteDoubleArrayProperty(const char* propertyName
   this->WriteArrayPropertyEnd();
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsJsonWriter::WriteBinaryDoubleArrayProperty(const char* propertyName, vtkDoubleArray* doubleArray)
+{
+  std::string encodedValues = EncodeBase64DoubleArray(doubleArray->GetPointer(0),
+    static_cast<size_t>(doubleArray->GetNumberOfValues()));
+  this->WriteObjectPropertyStart(propertyName);
+  this->WriteStringProperty("encoding", "base64");
+  this->WriteStringProperty("componentType", "float64");
+  this->WriteStringProperty("byteOrder", "little");
+  this->WriteIntProperty("numberOfComponents", doubleArray->GetNumberOfComponents());
+  this->Internal->Writer->Key("data");
+  this->Internal->Writer->String(encodedValues.c_str(), static_cast<rapidjson::SizeType>(encodedValues.size()));
+  this->WriteObjectPropertyEnd();
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLMarkupsJsonWriter::WriteArrayPropertyStart(const std::string& propertyName)
 {
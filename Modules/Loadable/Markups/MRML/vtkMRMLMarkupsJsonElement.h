@@ -30,9 +30,11 @@
 #include "vtkSmartPointer.h"
 #include "vtkNew.h"
 
+#include <string>
 #include <vector>
 
 class vtkCodedEntry;
+class vtkDoubleArray;
 
 /// \brief Represents a json object or list.
 ///
@@ -131,6 +133,37 @@ public:
   VTK_NEWINSTANCE
   vtkMRMLMarkupsJsonElement* GetArrayItem(int childItemIndex);
 
+  /// Control point properties that are parsed directly from the file stream,
+  /// without creating a JSON value for each control point.
+  struct StreamedControlPoint
+  {
+    std::string ID;
+    std::string Label;
+    std::string Description;
+    std::string AssociatedNodeID;
+    std::string PositionStatus;
+    double Position[3] = { 0.0, 0.0, 0.0 };
+    double OrientationMatrix[9] = { 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
+    bool HasPositionStatus{ false };
+    /// Set to true if a valid 3-element numeric position is found.
+    bool HasPosition{ false };
+    /// Set to true if a valid 9-element numeric orientation is found.
+    bool HasOrientation{ false };
+    bool HasSelected{ false };
+    bool Selected{ true };
+    bool HasLocked{ false };
+    bool Locked{ false };
+    bool HasVisibility{ false };
+    bool Visibility{ true };
+  };
+
+  /// Get control points that were parsed directly from the file stream.
+  /// Only available for the "controlPoints" array of a markup if the file was read
+  /// with vtkMRMLMarkupsJsonReader::StreamControlPoints enabled. In this case
+  /// the "controlPoints" array itself is empty.
+  /// Returns nullptr if control points of this element were not streamed.
+  std::vector<StreamedControlPoint>* GetStreamedControlPoints();
+
   /// Returns user-displayable messages that may contain details about any failed operation.
   vtkGetObjectMacro(UserMessages, vtkMRMLMessageCollection);
 
@@ -167,6 +200,18 @@ public:
   VTK_NEWINSTANCE
   vtkMRMLMarkupsJsonElement* ReadFromFile(const char* filePath);
 
+  /// If enabled then control points of markups are parsed directly from the file stream
+  /// (SAX-style), without building a JSON DOM value for each control point.
+  /// This greatly reduces memory usage and reading time for markups with many control points.
+  /// Streamed control points can be retrieved by calling vtkMRMLMarkupsJsonElement::GetStreamedControlPoints()
+  /// on the "controlPoints" array element. Binary-encoded control point positions and
+  /// orientations ("controlPointPositions" and "controlPointOrientations" properties)
+  /// are only decoded if this option is enabled.
+  /// Disabled by default.
+  vtkSetMacro(StreamControlPoints, bool);
+  vtkGetMacro(StreamControlPoints, bool);
+  vtkBooleanMacro(StreamControlPoints, bool);
+
   /// Returns user-displayable messages that may contain details about any failed operation.
   vtkGetObjectMacro(UserMessages, vtkMRMLMessageCollection);
 
@@ -180,6 +225,8 @@ protected:
   void operator=(const vtkMRMLMarkupsJsonReader&);
 
   vtkNew<vtkMRMLMessageCollection> UserMessages;
+
+  bool StreamControlPoints{ false };
 };
 
 
@@ -228,7 +275,11 @@ public:
   void WriteVectorProperty(const std::string& propertyName, double* v, int numberOfComponents = 3);
   void WriteMatrix4x4Property(const std::string& propertyName, double v[16], bool flipRasLps);
   void WriteDoubleArrayProperty(const char* propertyName, vtkDoubleArray* doubleArray);
-/// @}
+  /// @}
+
+  /// Write a multi-component floating-point array as a binary (base64-encoded, little endian, 64-bit)
+  /// object property. Much faster to write and read than WriteDoubleArrayProperty for large arrays.
+  void WriteBinaryDoubleArrayProperty(const char* propertyName, vtkDoubleArray* doubleArray);
 
   /// Returns user-displayable messages that may contain details about any failed operation.
   vtkGetObjectMacro(UserMessages, vtkMRMLMessageCollection);
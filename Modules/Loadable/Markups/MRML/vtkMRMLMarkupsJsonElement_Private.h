@@ -39,6 +39,7 @@
 #include "rapidjson/filewritestream.h"
 
 #include <deque>
+#include <map>
 #include <memory>
 
 //---------------------------------------------------------------------------
@@ -61,6 +62,9 @@ public:
     JsonDocumentContainer(const JsonDocumentContainer&) = delete;
     JsonDocumentContainer& operator= (const JsonDocumentContainer&) = delete;
     rapidjson::Document* Document;
+    /// Control points of each markup that were parsed directly from the file stream
+    /// (map key is the index of the markup in the "markups" array).
+    std::map<int, std::vector<vtkMRMLMarkupsJsonElement::StreamedControlPoint>> StreamedControlPoints;
   };
 
   // Helper methods
@@ -70,6 +74,15 @@ public:
   std::shared_ptr<JsonDocumentContainer> JsonRoot;
   rapidjson::Value JsonValue;
 
+  // Set to true for the element that represents the whole document
+  bool IsDocumentRoot{ false };
+  // Set to true for the top-level "markups" array element
+  bool IsMarkupsArray{ false };
+  // Index of the markup in the top-level "markups" array (-1 if this element is not a markup)
+  int MarkupIndex{ -1 };
+  // Index of the markup that this "controlPoints" array element belongs to (-1 if not a streamed control points array)
+  int StreamedControlPointsMarkupIndex{ -1 };
+
 
 protected:
   vtkMRMLMarkupsJsonElement* External;
@@ -34,6 +34,8 @@
 #include <vtksys/RegularExpression.hxx>
 #include <vtksys/SystemTools.hxx>
 
+#include <memory>
+
 #include "itkNumberToString.h"
 
 namespace
@@ -67,24 +69,38 @@ vtkMRMLMarkupsJsonStorageNode::~vtkMRMLMarkupsJsonStorageNode() = default;
 void vtkMRMLMarkupsJsonStorageNode::WriteXML(ostream& of, int nIndent)
 {
   Superclass::WriteXML(of,nIndent);
+  vtkMRMLWriteXMLBeginMacro(of);
+  vtkMRMLWriteXMLBooleanMacro(binaryControlPointCoordinates, BinaryControlPointCoordinates);
+  vtkMRMLWriteXMLEndMacro();
 }
 
 //----------------------------------------------------------------------------
 void vtkMRMLMarkupsJsonStorageNode::ReadXMLAttributes(const char** atts)
 {
+  MRMLNodeModifyBlocker blocker(this);
   Superclass::ReadXMLAttributes(atts);
+  vtkMRMLReadXMLBeginMacro(atts);
+  vtkMRMLReadXMLBooleanMacro(binaryControlPointCoordinates, BinaryControlPointCoordinates);
+  vtkMRMLReadXMLEndMacro();
 }
 
 //----------------------------------------------------------------------------
 void vtkMRMLMarkupsJsonStorageNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf(os,indent);
+  vtkMRMLPrintBeginMacro(os, indent);
+  vtkMRMLPrintBooleanMacro(BinaryControlPointCoordinates);
+  vtkMRMLPrintEndMacro();
 }
 
 //----------------------------------------------------------------------------
 void vtkMRMLMarkupsJsonStorageNode::Copy(vtkMRMLNode *anode)
 {
+  MRMLNodeModifyBlocker blocker(this);
   Superclass::Copy(anode);
+  vtkMRMLCopyBeginMacro(anode);
+  vtkMRMLCopyBooleanMacro(BinaryControlPointCoordinates);
+  vtkMRMLCopyEndMacro();
 }
 
 //----------------------------------------------------------------------------
@@ -97,6 +113,7 @@ bool vtkMRMLMarkupsJsonStorageNode::CanReadInReferenceNode(vtkMRMLNode *refNode)
 void vtkMRMLMarkupsJsonStorageNode::GetMarkupsTypesInFile(const char* filePath, std::vector<std::string>& outputMarkupsTypes)
 {
   vtkNew<vtkMRMLMarkupsJsonReader> jsonReader;
+  jsonReader->StreamControlPointsOn();
   vtkSmartPointer<vtkMRMLMarkupsJsonElement> jsonElement = vtkSmartPointer<vtkMRMLMarkupsJsonElement>::Take(jsonReader->ReadFromFile(filePath));
   if (!jsonElement.GetPointer())
   {
@@ -125,6 +142,7 @@ vtkMRMLMarkupsNode* vtkMRMLMarkupsJsonStorageNode::AddNewMarkupsNodeFromFile(con
     return nullptr;
   }
   vtkNew<vtkMRMLMarkupsJsonReader> jsonReader;
+  jsonReader->StreamControlPointsOn();
   vtkSmartPointer<vtkMRMLMarkupsJsonElement> jsonElement = vtkSmartPointer<vtkMRMLMarkupsJsonElement>::Take(jsonReader->ReadFromFile(filePath));
   if (!jsonElement.GetPointer())
   {
@@ -236,6 +254,7 @@ int vtkMRMLMarkupsJsonStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
     return 0;
   }
   vtkNew<vtkMRMLMarkupsJsonReader> jsonReader;
+  jsonReader->StreamControlPointsOn();
   vtkSmartPointer<vtkMRMLMarkupsJsonElement> jsonElement = vtkSmartPointer<vtkMRMLMarkupsJsonElement>::Take(jsonReader->ReadFromFile(filePath));
   if (!jsonElement.GetPointer())
   {
@@ -663,6 +682,7 @@ std::string vtkMRMLMarkupsJsonStorageNode::GetCoordinateUnitsFromSceneAsString(v
 vtkMRMLMarkupsJsonElement* vtkMRMLMarkupsJsonStorageNode::ReadMarkupsFile(const char* filePath)
 {
   vtkNew<vtkMRMLMarkupsJsonReader> jsonReader;
+  jsonReader->StreamControlPointsOn();
   vtkSmartPointer<vtkMRMLMarkupsJsonElement> jsonElement = vtkSmartPointer<vtkMRMLMarkupsJsonElement>::Take(jsonReader->ReadFromFile(filePath));
   if (!jsonElement.GetPointer())
   {
@@ -719,6 +739,17 @@ bool vtkMRMLMarkupsJsonStorageNode::ReadControlPoints(vtkMRMLMarkupsJsonElement*
   }
   bool wasUpdatingPoints = markupsNode->IsUpdatingPoints;
   markupsNode->IsUpdatingPoints = true;
+
+  std::vector<vtkMRMLMarkupsJsonElement::StreamedControlPoint>* streamedControlPoints = controlPointsArray->GetStreamedControlPoints();
+  if (streamedControlPoints)
+  {
+    // Control points were parsed directly from the file stream
+    bool success = this->ReadStreamedControlPoints(*streamedControlPoints, coordinateSystem, markupsNode);
+    markupsNode->IsUpdatingPoints = wasUpdatingPoints;
+    markupsNode->UpdateAllMeasurements();
+    return success;
+  }
+
   int numberOfControlPoints = controlPointsArray->GetArraySize();
   for (int controlPointIndex = 0; controlPointIndex < numberOfControlPoints; ++controlPointIndex)
   {
@@ -821,6 +852,90 @@ bool vtkMRMLMarkupsJsonStorageNode::ReadControlPoints(vtkMRMLMarkupsJsonElement*
   return true;
 }
 
+//----------------------------------------------------------------------------
+bool vtkMRMLMarkupsJsonStorageNode::ReadStreamedControlPoints(
+  std::vector<vtkMRMLMarkupsJsonElement::StreamedControlPoint>& streamedControlPoints,
+  int coordinateSystem, vtkMRMLMarkupsNode* markupsNode)
+{
+  int controlPointIndex = 0;
+  for (vtkMRMLMarkupsJsonElement::StreamedControlPoint& controlPointItem : streamedControlPoints)
+  {
+    std::unique_ptr<vtkMRMLMarkupsNode::ControlPoint> cp(new vtkMRMLMarkupsNode::ControlPoint);
+    cp->ID.swap(controlPointItem.ID);
+    cp->Label.swap(controlPointItem.Label);
+    cp->Description.swap(controlPointItem.Description);
+    cp->AssociatedNodeID.swap(controlPointItem.AssociatedNodeID);
+
+    if (controlPointItem.HasPositionStatus)
+    {
+      int positionStatus = vtkMRMLMarkupsNode::GetPositionStatusFromString(controlPointItem.PositionStatus.c_str());
+      if (positionStatus < 0)
+      {
+        vtkErrorToMessageCollectionWithObjectMacro(this, this->GetUserMessages(),
+          "vtkMRMLMarkupsJsonStorageNode::ReadStreamedControlPoints",
+          "File reading failed: invalid positionStatus '" << controlPointItem.PositionStatus
+          << "' for control point " << controlPointIndex + 1 << ".");
+        return false;
+      }
+      cp->PositionStatus = positionStatus;
+    }
+    else
+    {
+      // If positionStatus is not missing it means that the position is defined.
+      cp->PositionStatus = vtkMRMLMarkupsNode::PositionDefined;
+    }
+
+    if (controlPointItem.HasPosition)
+    {
+      std::copy(controlPointItem.Position, controlPointItem.Position + 3, cp->Position);
+      if (coordinateSystem == vtkMRMLStorageNode::CoordinateSystemLPS)
+      {
+        cp->Position[0] = -cp->Position[0];
+        cp->Position[1] = -cp->Position[1];
+      }
+    }
+    else
+    {
+      if (cp->PositionStatus == vtkMRMLMarkupsNode::PositionDefined)
+      {
+        vtkWarningToMessageCollectionWithObjectMacro(this, this->GetUserMessages(),
+          "vtkMRMLMarkupsJsonStorageNode::ReadStreamedControlPoints",
+          "File content is inconsistent: control point position is expected but not found"
+          << " for control point " << controlPointIndex + 1 << ". Setting position status to undefined.");
+        cp->PositionStatus = vtkMRMLMarkupsNode::PositionUndefined;
+      }
+    }
+
+    if (controlPointItem.HasOrientation)
+    {
+      std::copy(controlPointItem.OrientationMatrix, controlPointItem.OrientationMatrix + 9, cp->OrientationMatrix);
+      if (coordinateSystem == vtkMRMLStorageNode::CoordinateSystemLPS)
+      {
+        for (int i = 0; i < 6; ++i)
+        {
+          cp->OrientationMatrix[i] *= -1.0;
+        }
+      }
+    }
+
+    if (controlPointItem.HasSelected)
+    {
+      cp->Selected = controlPointItem.Selected;
+    }
+    if (controlPointItem.HasLocked)
+    {
+      cp->Locked = controlPointItem.Locked;
+    }
+    if (controlPointItem.HasVisibility)
+    {
+      cp->Visibility = controlPointItem.Visibility;
+    }
+    markupsNode->AddControlPoint(cp.release(), false);
+    ++controlPointIndex;
+  }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 bool vtkMRMLMarkupsJsonStorageNode::ReadMeasurements(vtkMRMLMarkupsJsonElement* measurementsArray, vtkMRMLMarkupsNode* markupsNode)
 {
@@ -1003,6 +1118,19 @@ bool vtkMRMLMarkupsJsonStorageNode::WriteControlPoints(
   writer->WriteArrayPropertyStart("controlPoints");
 
   int numberOfControlPoints = markupsNode->GetNumberOfControlPoints();
+
+  // In binary mode, positions and orientations of all control points are written
+  // as binary arrays after the control points array.
+  vtkNew<vtkDoubleArray> positions;
+  vtkNew<vtkDoubleArray> orientations;
+  if (this->BinaryControlPointCoordinates)
+  {
+    positions->SetNumberOfComponents(3);
+    positions->SetNumberOfTuples(numberOfControlPoints);
+    orientations->SetNumberOfComponents(9);
+    orientations->SetNumberOfTuples(numberOfControlPoints);
+  }
+
   for (int controlPointIndex = 0; controlPointIndex < numberOfControlPoints; controlPointIndex++)
   {
     vtkMRMLMarkupsNode::ControlPoint* cp = markupsNode->GetNthControlPoint(controlPointIndex);
@@ -1014,7 +1142,23 @@ bool vtkMRMLMarkupsJsonStorageNode::WriteControlPoints(
     writer->WriteStringProperty("description", cp->Description.c_str());
     writer->WriteStringProperty("associatedNodeID", cp->AssociatedNodeID.c_str());
 
-    if(cp->PositionStatus == vtkMRMLMarkupsNode::PositionDefined)
+    if (this->BinaryControlPointCoordinates)
+    {
+      double* xyz = positions->GetPointer(3 * controlPointIndex);
+      double* orientationMatrix = orientations->GetPointer(9 * controlPointIndex);
+      std::copy(cp->Position, cp->Position + 3, xyz);
+      std::copy(cp->OrientationMatrix, cp->OrientationMatrix + 9, orientationMatrix);
+      if (coordinateSystem == vtkMRMLStorageNode::CoordinateSystemLPS)
+      {
+        xyz[0] = -xyz[0];
+        xyz[1] = -xyz[1];
+        for (int i = 0; i < 6; ++i)
+        {
+          orientationMatrix[i] = -orientationMatrix[i];
+        }
+      }
+    }
+    else if (cp->PositionStatus == vtkMRMLMarkupsNode::PositionDefined)
     {
       double xyz[3] = { 0.0, 0.0, 0.0 };
       markupsNode->GetNthControlPointPosition(controlPointIndex, xyz);
@@ -1029,19 +1173,22 @@ bool vtkMRMLMarkupsJsonStorageNode::WriteControlPoints(
     {
       writer->WriteStringProperty("position", "");
     }
-    double* orientationMatrix = markupsNode->GetNthControlPointOrientationMatrix(controlPointIndex);
-    if (coordinateSystem == vtkMRMLStorageNode::CoordinateSystemLPS)
+    if (!this->BinaryControlPointCoordinates)
     {
-      double orientationMatrixLPS[9] = {
-        -orientationMatrix[0], -orientationMatrix[1], -orientationMatrix[2],
-        -orientationMatrix[3], -orientationMatrix[4], -orientationMatrix[5],
-         orientationMatrix[6],  orientationMatrix[7],  orientationMatrix[8]
-        };
-      writer->WriteVectorProperty("orientation", orientationMatrixLPS, 9);
-    }
-    else
-    {
-      writer->WriteVectorProperty("orientation", orientationMatrix, 9);
+      double* orientationMatrix = markupsNode->GetNthControlPointOrientationMatrix(controlPointIndex);
+      if (coordinateSystem == vtkMRMLStorageNode::CoordinateSystemLPS)
+      {
+        double orientationMatrixLPS[9] = {
+          -orientationMatrix[0], -orientationMatrix[1], -orientationMatrix[2],
+          -orientationMatrix[3], -orientationMatrix[4], -orientationMatrix[5],
+           orientationMatrix[6],  orientationMatrix[7],  orientationMatrix[8]
+          };
+        writer->WriteVectorProperty("orientation", orientationMatrixLPS, 9);
+      }
+      else
+      {
+        writer->WriteVectorProperty("orientation", orientationMatrix, 9);
+      }
     }
 
     writer->WriteBoolProperty("selected", cp->Selected);
@@ -1053,6 +1200,12 @@ bool vtkMRMLMarkupsJsonStorageNode::WriteControlPoints(
   }
 
   writer->WriteArrayPropertyEnd();
+
+  if (this->BinaryControlPointCoordinates)
+  {
+    writer->WriteBinaryDoubleArrayProperty("controlPointPositions", positions);
+    writer->WriteBinaryDoubleArrayProperty("controlPointOrientations", orientations);
+  }
   return true;
 }
 
@@ -25,10 +25,9 @@
 
 // Markups includes
 #include "vtkSlicerMarkupsModuleMRMLExport.h"
+#include "vtkMRMLMarkupsJsonElement.h"
 #include "vtkMRMLMarkupsStorageNode.h"
 
-
-class vtkMRMLMarkupsJsonElement;
 class vtkMRMLMarkupsJsonWriter;
 class vtkMRMLMarkupsDisplayNode;
 class vtkMRMLMarkupsNode;
@@ -64,6 +63,16 @@ public:
   /// The types are ordered by the index in which they appear in the Json file.
   void GetMarkupsTypesInFile(const char* filePath, std::vector<std::string>& outputMarkupsTypes);
 
+  /// If enabled then positions and orientations of all control points are written
+  /// into base64-encoded binary arrays ("controlPointPositions" and "controlPointOrientations")
+  /// instead of formatting them as text for each control point.
+  /// This makes reading and writing of markups with many control points much faster,
+  /// but the coordinate values are not human-readable in the file.
+  /// Disabled by default.
+  vtkSetMacro(BinaryControlPointCoordinates, bool);
+  vtkGetMacro(BinaryControlPointCoordinates, bool);
+  vtkBooleanMacro(BinaryControlPointCoordinates, bool);
+
 protected:
   vtkMRMLMarkupsJsonStorageNode();
   ~vtkMRMLMarkupsJsonStorageNode() override;
@@ -92,6 +101,9 @@ protected:
   virtual bool UpdateMarkupsDisplayNodeFromJsonValue(vtkMRMLMarkupsDisplayNode* displayNode, vtkMRMLMarkupsJsonElement* markupObject);
 
   virtual bool ReadControlPoints(vtkMRMLMarkupsJsonElement* controlPointsArray, int coordinateSystem, vtkMRMLMarkupsNode* markupsNode);
+  /// Create control points from control point properties that the reader parsed directly from the file stream.
+  bool ReadStreamedControlPoints(std::vector<vtkMRMLMarkupsJsonElement::StreamedControlPoint>& streamedControlPoints,
+    int coordinateSystem, vtkMRMLMarkupsNode* markupsNode);
   virtual bool ReadMeasurements(vtkMRMLMarkupsJsonElement* measurementsArray, vtkMRMLMarkupsNode* markupsNode);
 
   virtual bool WriteMarkup(vtkMRMLMarkupsJsonWriter* writer, vtkMRMLMarkupsNode* markupsNode);
@@ -101,6 +113,8 @@ protected:
   virtual bool WriteDisplayProperties(vtkMRMLMarkupsJsonWriter* writer, vtkMRMLMarkupsDisplayNode* markupsDisplayNode);
 
   std::string GetCoordinateUnitsFromSceneAsString(vtkMRMLMarkupsNode* markupsNode);
+
+  bool BinaryControlPointCoordinates{ false };
 };
 
 #endif
@@ -0,0 +1,982 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MarkupsModule/MRMLDisplayableManager includes
+#include "vtkMRMLMarkupsBatchedRepresentation.h"
+
+// MarkupsModule/VTKWidgets includes
+#include <vtkFastSelectVisiblePoints.h>
+#include <vtkMarkupsGlyphSource2D.h>
+#include <vtkSlicerMarkupsWidgetRepresentation.h>
+
+// MRMLDisplayableManager includes
+#include <vtkMRMLAbstractThreeDViewDisplayableManager.h>
+
+// MRML includes
+#include <vtkMRMLAbstractViewNode.h>
+#include <vtkMRMLFolderDisplayNode.h>
+#include <vtkMRMLInteractionEventData.h>
+#include <vtkMRMLMarkupsDisplayNode.h>
+#include <vtkMRMLMarkupsNode.h>
+
+// VTK includes
+#include <vtkActor.h>
+#include <vtkActor2D.h>
+#include <vtkBoundingBox.h>
+#include <vtkCamera.h>
+#include <vtkDoubleArray.h>
+#include <vtkGlyph3DMapper.h>
+#include <vtkLabelPlacementMapper.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPointSetToLabelHierarchy.h>
+#include <vtkPolyData.h>
+#include <vtkProperty.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkStringArray.h>
+#include <vtkTextProperty.h>
+#include <vtkTimeStamp.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <string>
+
+vtkStandardNewMacro(vtkMRMLMarkupsBatchedRepresentation);
+
+//----------------------------------------------------------------------------
+class vtkMRMLMarkupsBatchedRepresentation::vtkInternal
+{
+public:
+  /// Rendering pipeline shared by all display nodes of the same markups type, glyph type,
+  /// glyph sizing mode, and label text properties
+  struct Batch
+  {
+    Batch();
+
+    /// Set glyph source of the batch. 2D glyphs are oriented to face the camera.
+    void SetGlyphType(int glyphType);
+
+    vtkSmartPointer<vtkPoints> ControlPoints;
+    vtkSmartPointer<vtkUnsignedCharArray> Colors;
+    vtkSmartPointer<vtkDoubleArray> Scales;
+    vtkSmartPointer<vtkPolyData> ControlPointsPolyData;
+    vtkSmartPointer<vtkSphereSource> GlyphSourceSphere;
+    vtkSmartPointer<vtkMarkupsGlyphSource2D> GlyphSource2D;
+    vtkSmartPointer<vtkDoubleArray> GlyphOrientations;
+    vtkSmartPointer<vtkGlyph3DMapper> GlyphMapper;
+    vtkSmartPointer<vtkProperty> Property;
+    vtkSmartPointer<vtkActor> Actor;
+
+    vtkSmartPointer<vtkPoints> LabelControlPoints;
+    vtkSmartPointer<vtkStringArray> Labels;
+    vtkSmartPointer<vtkStringArray> LabelsPriority;
+    vtkSmartPointer<vtkPolyData> LabelControlPointsPolyData;
+    vtkSmartPointer<vtkPolyData> VisiblePointsPolyData;
+    vtkSmartPointer<vtkFastSelectVisiblePoints> SelectVisiblePoints;
+    vtkSmartPointer<vtkTextProperty> TextProperty;
+    vtkSmartPointer<vtkPointSetToLabelHierarchy> PointSetToLabelHierarchyFilter;
+    vtkSmartPointer<vtkLabelPlacementMapper> LabelsMapper;
+    vtkSmartPointer<vtkActor2D> LabelsActor;
+
+    /// Glyph type of the display nodes (vtkMRMLMarkupsDisplayNode::GlyphShapes)
+    int GlyphType{ vtkMRMLMarkupsDisplayNode::Sphere3D };
+    /// Time of the last update of the 2D glyph orientations
+    vtkTimeStamp GlyphOrientationsUpdateTime;
+    /// Glyph size is specified relative to the screen size (scale factor is updated when the view changes)
+    bool RelativeGlyphSize{ true };
+    /// Largest value in the scales array
+    double MaximumScale{ 0.0 };
+    /// Text property has been set from a display node during the current rebuild
+    bool TextPropertyInitialized{ false };
+  };
+
+  vtkInternal(vtkMRMLMarkupsBatchedRepresentation* external);
+
+  bool IsDisplayNodeVisible(vtkMRMLMarkupsDisplayNode* displayNode);
+  void GetDisplayNodeColor(vtkMRMLMarkupsDisplayNode* displayNode, bool selected, double color[3]);
+  double GetDisplayNodeOpacity(vtkMRMLMarkupsDisplayNode* displayNode);
+  /// Get diameter of the control point glyphs of the display node, in world coordinates
+  double GetControlPointSize(vtkMRMLMarkupsDisplayNode* displayNode);
+  double GetScreenScaleFactor();
+  /// Get text properties of the point labels of the display node
+  void GetLabelTextProperty(vtkMRMLMarkupsDisplayNode* displayNode, vtkTextProperty* textProperty);
+  std::string GetBatchKey(vtkMRMLMarkupsDisplayNode* displayNode);
+  /// Orient 2D glyphs of the batch to face the camera, same as in vtkSlicerMarkupsWidgetRepresentation3D
+  void UpdateGlyphOrientations(Batch& batch);
+
+  vtkMRMLMarkupsBatchedRepresentation* External;
+
+  vtkWeakPointer<vtkRenderer> Renderer;
+  vtkWeakPointer<vtkMRMLAbstractViewNode> ViewNode;
+
+  /// Display nodes and their excluded state
+  std::map<vtkSmartPointer<vtkMRMLMarkupsDisplayNode>, bool> DisplayNodes;
+
+  /// Batches, the key is the markups type, glyph type, glyph sizing mode, and label text properties
+  std::map<std::string, Batch> Batches;
+  /// Text property used for computing batch keys
+  vtkNew<vtkTextProperty> KeyTextProperty;
+  bool BatchesModified{ true };
+
+  double ScreenSizePixel{ 1000.0 };
+  double ViewScaleFactorMmPerPixel{ 1.0 };
+  double RelativeGlyphScaleFactor{ 0.0 };
+};
+
+//----------------------------------------------------------------------------
+vtkMRMLMarkupsBatchedRepresentation::vtkInternal::Batch::Batch()
+{
+  this->ControlPoints = vtkSmartPointer<vtkPoints>::New();
+  this->Colors = vtkSmartPointer<vtkUnsignedCharArray>::New();
+  this->Colors->SetName("colors");
+  this->Colors->SetNumberOfComponents(4);
+  this->Scales = vtkSmartPointer<vtkDoubleArray>::New();
+  this->Scales->SetName("scales");
+  this->ControlPointsPolyData = vtkSmartPointer<vtkPolyData>::New();
+  this->ControlPointsPolyData->SetPoints(this->ControlPoints);
+  this->ControlPointsPolyData->GetPointData()->AddArray(this->Colors);
+  this->ControlPointsPolyData->GetPointData()->AddArray(this->Scales);
+
+  this->GlyphSourceSphere = vtkSmartPointer<vtkSphereSource>::New();
+  this->GlyphSourceSphere->SetRadius(0.5);
+  this->GlyphSource2D = vtkSmartPointer<vtkMarkupsGlyphSource2D>::New();
+  this->GlyphOrientations = vtkSmartPointer<vtkDoubleArray>::New();
+  this->GlyphOrientations->SetName("direction");
+  this->GlyphOrientations->SetNumberOfComponents(4);
+
+  // vtkGlyph3DMapper renders all the glyphs with a single instanced draw call
+  this->GlyphMapper = vtkSmartPointer<vtkGlyph3DMapper>::New();
+  this->GlyphMapper->SetInputData(this->ControlPointsPolyData);
+  this->GlyphMapper->SetSourceConnection(this->GlyphSourceSphere->GetOutputPort());
+  this->GlyphMapper->OrientOff();
+  this->GlyphMapper->SetOrientationModeToQuaternion();
+  this->GlyphMapper->SetOrientationArray("direction");
+  this->GlyphMapper->ScalingOn();
+  this->GlyphMapper->SetScaleModeToScaleByMagnitude();
+  this->GlyphMapper->SetScaleArray("scales");
+  this->GlyphMapper->SetScaleFactor(1.0);
+  this->GlyphMapper->ScalarVisibilityOn();
+  this->GlyphMapper->SetScalarModeToUsePointFieldData();
+  this->GlyphMapper->SelectColorArray("colors");
+  this->GlyphMapper->SetColorModeToDirectScalars();
+
+  this->Property = vtkSmartPointer<vtkProperty>::New();
+  this->Property->SetRepresentationToSurface();
+  this->Property->SetAmbient(0.0);
+  this->Property->SetDiffuse(1.0);
+  this->Property->SetSpecular(0.0);
+  this->Property->SetShading(true);
+  this->Property->SetSpecularPower(1.0);
+
+  this->Actor = vtkSmartPointer<vtkActor>::New();
+  this->Actor->SetMapper(this->GlyphMapper);
+  this->Actor->SetProperty(this->Property);
+  this->Actor->PickableOff();
+  this->Actor->DragableOff();
+
+  this->LabelControlPoints = vtkSmartPointer<vtkPoints>::New();
+  this->Labels = vtkSmartPointer<vtkStringArray>::New();
+  this->Labels->SetName("labels");
+  this->LabelsPriority = vtkSmartPointer<vtkStringArray>::New();
+  this->LabelsPriority->SetName("priority");
+  this->LabelControlPointsPolyData = vtkSmartPointer<vtkPolyData>::New();
+  this->LabelControlPointsPolyData->SetPoints(this->LabelControlPoints);
+  this->LabelControlPointsPolyData->GetPointData()->AddArray(this->Labels);
+  this->LabelControlPointsPolyData->GetPointData()->AddArray(this->LabelsPriority);
+
+  this->VisiblePointsPolyData = vtkSmartPointer<vtkPolyData>::New();
+
+  // The SelectVisiblePoints filter is updated in RenderOverlay, after opaque geometry is rendered.
+  this->SelectVisiblePoints = vtkSmartPointer<vtkFastSelectVisiblePoints>::New();
+  this->SelectVisiblePoints->SetInputData(this->LabelControlPointsPolyData);
+  this->SelectVisiblePoints->SetTolerance(1e-4);
+  this->SelectVisiblePoints->SetOutput(this->VisiblePointsPolyData);
+
+  this->TextProperty = vtkSmartPointer<vtkTextProperty>::New();
+  this->TextProperty->SetFontSize(15);
+  this->TextProperty->SetFontFamily(vtkTextProperty::GetFontFamilyFromString("Arial"));
+
+  this->PointSetToLabelHierarchyFilter = vtkSmartPointer<vtkPointSetToLabelHierarchy>::New();
+  this->PointSetToLabelHierarchyFilter->SetTextProperty(this->TextProperty);
+  this->PointSetToLabelHierarchyFilter->SetLabelArrayName("labels");
+  this->PointSetToLabelHierarchyFilter->SetPriorityArrayName("priority");
+  this->PointSetToLabelHierarchyFilter->SetInputData(this->VisiblePointsPolyData);
+
+  this->LabelsMapper = vtkSmartPointer<vtkLabelPlacementMapper>::New();
+  this->LabelsMapper->SetInputConnection(this->PointSetToLabelHierarchyFilter->GetOutputPort());
+  this->LabelsMapper->PlaceAllLabelsOn();
+
+  this->LabelsActor = vtkSmartPointer<vtkActor2D>::New();
+  this->LabelsActor->SetMapper(this->LabelsMapper);
+  this->LabelsActor->PickableOff();
+  this->LabelsActor->DragableOff();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBatchedRepresentation::vtkInternal::Batch::SetGlyphType(int glyphType)
+{
+  this->GlyphType = glyphType;
+  if (glyphType == vtkMRMLMarkupsDisplayNode::Sphere3D)
+  {
+    this->GlyphMapper->SetSourceConnection(this->GlyphSourceSphere->GetOutputPort());
+    this->GlyphMapper->OrientOff();
+    this->ControlPointsPolyData->GetPointData()->RemoveArray("direction");
+  }
+  else
+  {
+    this->GlyphSource2D->SetGlyphType(vtkSlicerMarkupsWidgetRepresentation::GetGlyphTypeSourceFromDisplay(glyphType));
+    this->GlyphMapper->SetSourceConnection(this->GlyphSource2D->GetOutputPort());
+    this->GlyphMapper->OrientOn();
+    this->ControlPointsPolyData->GetPointData()->AddArray(this->GlyphOrientations);
+  }
+  this->GlyphOrientationsUpdateTime = vtkTimeStamp();
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLMarkupsBatchedRepresentation::vtkInternal::vtkInternal(vtkMRMLMarkupsBatchedRepresentation* external)
+  : External(external)
+{
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLMarkupsBatchedRepresentation::vtkInternal::IsDisplayNodeVisible(vtkMRMLMarkupsDisplayNode* displayNode)
+{
+  if (!displayNode
+    || !this->ViewNode
+    || !displayNode->GetMarkupsNode()
+    || !displayNode->GetVisibility()
+    || !displayNode->GetVisibility3D()
+    || !displayNode->IsDisplayableInView(this->ViewNode->GetID()))
+  {
+    return false;
+  }
+  if (displayNode->GetFolderDisplayOverrideAllowed()
+    && !vtkMRMLFolderDisplayNode::GetHierarchyVisibility(displayNode->GetDisplayableNode()))
+  {
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBatchedRepresentation::vtkInternal::GetDisplayNodeColor(
+  vtkMRMLMarkupsDisplayNode* displayNode, bool selected, double color[3])
+{
+  // If a folder is overriding display properties then use the color defined by the folder
+  if (displayNode->GetFolderDisplayOverrideAllowed())
+  {
+    vtkMRMLDisplayNode* overrideHierarchyDisplayNode =
+      vtkMRMLFolderDisplayNode::GetOverridingHierarchyDisplayNode(displayNode->GetDisplayableNode());
+    if (overrideHierarchyDisplayNode)
+    {
+      overrideHierarchyDisplayNode->GetColor(color);
+      return;
+    }
+  }
+  if (selected)
+  {
+    displayNode->GetSelectedColor(color);
+  }
+  else
+  {
+    displayNode->GetColor(color);
+  }
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLMarkupsBatchedRepresentation::vtkInternal::GetDisplayNodeOpacity(vtkMRMLMarkupsDisplayNode* displayNode)
+{
+  double hierarchyOpacity = 1.0;
+  if (displayNode->GetFolderDisplayOverrideAllowed())
+  {
+    hierarchyOpacity = vtkMRMLFolderDisplayNode::GetHierarchyOpacity(displayNode->GetDisplayableNode());
+  }
+  return displayNode->GetOpacity() * hierarchyOpacity;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLMarkupsBatchedRepresentation::vtkInternal::GetScreenScaleFactor()
+{
+  return this->ViewNode ? this->ViewNode->GetScreenScaleFactor() : 1.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLMarkupsBatchedRepresentation::vtkInternal::GetControlPointSize(vtkMRMLMarkupsDisplayNode* displayNode)
+{
+  // Same as vtkSlicerMarkupsWidgetRepresentation3D::UpdateControlPointSize()
+  if (displayNode->GetUseGlyphScale())
+  {
+    return this->ScreenSizePixel * this->GetScreenScaleFactor()
+      * displayNode->GetGlyphScale() / 100.0 * this->ViewScaleFactorMmPerPixel;
+  }
+  return displayNode->GetGlyphSize();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBatchedRepresentation::vtkInternal::GetLabelTextProperty(
+  vtkMRMLMarkupsDisplayNode* displayNode, vtkTextProperty* textProperty)
+{
+  // Same as vtkSlicerMarkupsWidgetRepresentation3D::UpdateFromMRML() for unselected control points
+  double color[3] = { 0.5, 0.5, 0.5 };
+  this->GetDisplayNodeColor(displayNode, false, color);
+  double opacity = this->GetDisplayNodeOpacity(displayNode);
+  textProperty->ShallowCopy(displayNode->GetTextProperty());
+  textProperty->SetColor(color);
+  textProperty->SetOpacity(opacity);
+  textProperty->SetFontSize(static_cast<int>(displayNode->GetTextProperty()->GetFontSize()
+    * displayNode->GetTextScale() * this->GetScreenScaleFactor() * 5.0));
+  textProperty->SetBackgroundOpacity(opacity * displayNode->GetTextProperty()->GetBackgroundOpacity());
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLMarkupsBatchedRepresentation::vtkInternal::GetBatchKey(vtkMRMLMarkupsDisplayNode* displayNode)
+{
+  std::ostringstream key;
+  key << displayNode->GetMarkupsNode()->GetMarkupType();
+  key << (displayNode->GetUseGlyphScale() ? "/relative" : "/absolute");
+  key << "/glyph" << displayNode->GetGlyphType();
+  if (displayNode->GetPointLabelsVisibility())
+  {
+    // All labels of a batch are drawn with the same text property
+    vtkTextProperty* textProperty = this->KeyTextProperty;
+    this->GetLabelTextProperty(displayNode, textProperty);
+    const double* color = textProperty->GetColor();
+    const double* backgroundColor = textProperty->GetBackgroundColor();
+    const double* frameColor = textProperty->GetFrameColor();
+    key << "/labels " << textProperty->GetFontFamily() << " " << (textProperty->GetFontFile() ? textProperty->GetFontFile() : "")
+      << " " << textProperty->GetFontSize() << " " << textProperty->GetBold() << textProperty->GetItalic() << textProperty->GetShadow()
+      << " " << color[0] << " " << color[1] << " " << color[2] << " " << textProperty->GetOpacity()
+      << " " << backgroundColor[0] << " " << backgroundColor[1] << " " << backgroundColor[2] << " " << textProperty->GetBackgroundOpacity()
+      << " " << textProperty->GetFrame() << " " << frameColor[0] << " " << frameColor[1] << " " << frameColor[2]
+      << " " << textProperty->GetFrameWidth();
+  }
+  return key.str();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBatchedRepresentation::vtkInternal::UpdateGlyphOrientations(Batch& batch)
+{
+  vtkCamera* camera = this->Renderer ? this->Renderer->GetActiveCamera() : nullptr;
+  if (!camera)
+  {
+    // Orientation array must have a value for each point
+    vtkIdType numberOfPoints = batch.ControlPoints->GetNumberOfPoints();
+    batch.GlyphOrientations->SetNumberOfTuples(numberOfPoints);
+    batch.GlyphOrientations->FillComponent(0, 1.0);
+    for (int component = 1; component < 4; ++component)
+    {
+      batch.GlyphOrientations->FillComponent(component, 0.0);
+    }
+    batch.GlyphOrientations->Modified();
+    return;
+  }
+  if (batch.GlyphOrientationsUpdateTime > camera->GetMTime()
+    && batch.GlyphOrientationsUpdateTime > batch.ControlPoints->GetMTime())
+  {
+    return;
+  }
+
+  double cameraPosition[3] = { 0.0, 0.0, 0.0 };
+  camera->GetPosition(cameraPosition);
+  if (camera->GetParallelProjection())
+  {
+    // Glyphs must face the camera plane normal: use a far camera position
+    // so that directions from all points are approximately parallel.
+    double directionOfProjection[3] = { 0.0, 0.0, 0.0 };
+    camera->GetDirectionOfProjection(directionOfProjection);
+    double distance = 100.0 * camera->GetParallelScale();
+    for (int i = 0; i < 3; ++i)
+    {
+      cameraPosition[i] -= directionOfProjection[i] * distance;
+    }
+  }
+  double viewUp[3] = { 0.0, 0.0, 0.0 };
+  camera->GetViewUp(viewUp);
+
+  vtkIdType numberOfPoints = batch.ControlPoints->GetNumberOfPoints();
+  batch.GlyphOrientations->SetNumberOfTuples(numberOfPoints);
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; ++pointIndex)
+  {
+    double worldPos[3] = { 0.0, 0.0, 0.0 };
+    batch.ControlPoints->GetPoint(pointIndex, worldPos);
+    double z[3] = { 0.0, 0.0, 0.0 };
+    vtkMath::Subtract(worldPos, cameraPosition, z);
+    vtkMath::Normalize(z);
+    double x[3] = { 0.0, 0.0, 0.0 };
+    vtkMath::Cross(viewUp, z, x);
+    double y[3] = { 0.0, 0.0, 0.0 };
+    vtkMath::Cross(z, x, y);
+    double orientation[3][3];
+    for (int i = 0; i < 3; ++i)
+    {
+      orientation[i][0] = x[i];
+      orientation[i][1] = y[i];
+      orientation[i][2] = z[i];
+    }
+    double orientationQuaternion[4] = { 0.0, 0.0, 0.0, 0.0 };
+    vtkMath::Matrix3x3ToQuaternion(orientation, orientationQuaternion);
+    batch.GlyphOrientations->SetTypedTuple(pointIndex, orientationQuaternion);
+  }
+  batch.GlyphOrientations->Modified();
+  batch.GlyphOrientationsUpdateTime.Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLMarkupsBatchedRepresentation::vtkMRMLMarkupsBatchedRepresentation()
+{
+  this->Internal = new vtkInternal(this);
+  vtkMath::UninitializeBounds(this->Bounds);
+  this->PickableOff();
+  this->DragableOff();
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLMarkupsBatchedRepresentation::~vtkMRMLMarkupsBatchedRepresentation()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBatchedRepresentation::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "PickingTolerance: " << this->PickingTolerance << "\n";
+  os << indent << "NumberOfDisplayNodes: " << this->Internal->DisplayNodes.size() << "\n";
+  os << indent << "NumberOfBatches: " << this->Internal->Batches.size() << "\n";
+  os << indent << "NumberOfBatchUpdates: " << this->NumberOfBatchUpdates << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBatchedRepresentation::SetRenderer(vtkRenderer* renderer)
+{
+  if (this->Internal->Renderer == renderer)
+  {
+    return;
+  }
+  this->Internal->Renderer = renderer;
+  for (auto& batchIt : this->Internal->Batches)
+  {
+    batchIt.second.SelectVisiblePoints->SetRenderer(renderer);
+  }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkRenderer* vtkMRMLMarkupsBatchedRepresentation::GetRenderer()
+{
+  return this->Internal->Renderer;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBatchedRepresentation::SetViewNode(vtkMRMLAbstractViewNode* viewNode)
+{
+  if (this->Internal->ViewNode == viewNode)
+  {
+    return;
+  }
+  this->Internal->ViewNode = viewNode;
+  this->UpdateFromMRML();
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLAbstractViewNode* vtkMRMLMarkupsBatchedRepresentation::GetViewNode()
+{
+  return this->Internal->ViewNode;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBatchedRepresentation::AddDisplayNode(vtkMRMLMarkupsDisplayNode* displayNode)
+{
+  if (!displayNode || this->HasDisplayNode(displayNode))
+  {
+    return;
+  }
+  this->Internal->DisplayNodes[displayNode] = false;
+  this->UpdateFromMRML();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBatchedRepresentation::RemoveDisplayNode(vtkMRMLMarkupsDisplayNode* displayNode)
+{
+  auto displayNodeIt = this->Internal->DisplayNodes.find(displayNode);
+  if (displayNodeIt == this->Internal->DisplayNodes.end())
+  {
+    return;
+  }
+  this->Internal->DisplayNodes.erase(displayNodeIt);
+  this->UpdateFromMRML();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBatchedRepresentation::RemoveAllDisplayNodes()
+{
+  if (this->Internal->DisplayNodes.empty())
+  {
+    return;
+  }
+  this->Internal->DisplayNodes.clear();
+  this->UpdateFromMRML();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLMarkupsBatchedRepresentation::HasDisplayNode(vtkMRMLMarkupsDisplayNode* displayNode)
+{
+  return this->Internal->DisplayNodes.find(displayNode) != this->Internal->DisplayNodes.end();
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLMarkupsBatchedRepresentation::GetNumberOfDisplayNodes()
+{
+  return static_cast<int>(this->Internal->DisplayNodes.size());
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBatchedRepresentation::GetDisplayNodes(std::vector<vtkMRMLMarkupsDisplayNode*>& displayNodes)
+{
+  displayNodes.clear();
+  for (auto& displayNodeIt : this->Internal->DisplayNodes)
+  {
+    displayNodes.push_back(displayNodeIt.first);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBatchedRepresentation::SetDisplayNodeExcluded(vtkMRMLMarkupsDisplayNode* displayNode, bool excluded)
+{
+  auto displayNodeIt = this->Internal->DisplayNodes.find(displayNode);
+  if (displayNodeIt == this->Internal->DisplayNodes.end() || displayNodeIt->second == excluded)
+  {
+    return;
+  }
+  displayNodeIt->second = excluded;
+  this->UpdateFromMRML();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLMarkupsBatchedRepresentation::GetDisplayNodeExcluded(vtkMRMLMarkupsDisplayNode* displayNode)
+{
+  auto displayNodeIt = this->Internal->DisplayNodes.find(displayNode);
+  if (displayNodeIt == this->Internal->DisplayNodes.end())
+  {
+    return false;
+  }
+  return displayNodeIt->second;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBatchedRepresentation::GetExcludedDisplayNodes(std::vector<vtkMRMLMarkupsDisplayNode*>& displayNodes)
+{
+  displayNodes.clear();
+  for (auto& displayNodeIt : this->Internal->DisplayNodes)
+  {
+    if (displayNodeIt.second)
+    {
+      displayNodes.push_back(displayNodeIt.first);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBatchedRepresentation::UpdateFromMRML()
+{
+  this->Internal->BatchesModified = true;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBatchedRepresentation::UpdateBatches()
+{
+  if (!this->Internal->BatchesModified)
+  {
+    return;
+  }
+  this->Internal->BatchesModified = false;
+  this->NumberOfBatchUpdates++;
+
+  for (auto& batchIt : this->Internal->Batches)
+  {
+    vtkInternal::Batch& batch = batchIt.second;
+    batch.ControlPoints->Reset();
+    batch.Colors->Reset();
+    batch.Scales->Reset();
+    batch.LabelControlPoints->Reset();
+    batch.Labels->Reset();
+    batch.LabelsPriority->Reset();
+    batch.MaximumScale = 0.0;
+    batch.TextPropertyInitialized = false;
+  }
+
+  for (auto& displayNodeIt : this->Internal->DisplayNodes)
+  {
+    vtkMRMLMarkupsDisplayNode* displayNode = displayNodeIt.first;
+    bool excluded = displayNodeIt.second;
+    if (excluded || !this->Internal->IsDisplayNodeVisible(displayNode))
+    {
+      continue;
+    }
+    vtkMRMLMarkupsNode* markupsNode = displayNode->GetMarkupsNode();
+
+    std::string batchKey = this->Internal->GetBatchKey(displayNode);
+    bool newBatch = (this->Internal->Batches.find(batchKey) == this->Internal->Batches.end());
+    vtkInternal::Batch& batch = this->Internal->Batches[batchKey];
+    if (newBatch)
+    {
+      batch.SelectVisiblePoints->SetRenderer(this->Internal->Renderer);
+      batch.SetGlyphType(displayNode->GetGlyphType());
+    }
+    batch.RelativeGlyphSize = displayNode->GetUseGlyphScale();
+
+    double opacity = this->Internal->GetDisplayNodeOpacity(displayNode);
+    unsigned char rgba[2][4];
+    for (int selected = 0; selected < 2; ++selected)
+    {
+      double color[3] = { 0.5, 0.5, 0.5 };
+      this->Internal->GetDisplayNodeColor(displayNode, selected, color);
+      for (int i = 0; i < 3; ++i)
+      {
+        rgba[selected][i] = static_cast<unsigned char>(vtkMath::ClampValue(color[i], 0.0, 1.0) * 255.0);
+      }
+      rgba[selected][3] = static_cast<unsigned char>(vtkMath::ClampValue(opacity, 0.0, 1.0) * 255.0);
+    }
+    // Relative glyph sizes are multiplied by the view-dependent glyph mapper scale factor
+    double scale = batch.RelativeGlyphSize ? displayNode->GetGlyphScale() : displayNode->GetGlyphSize();
+    batch.MaximumScale = std::max(batch.MaximumScale, scale);
+
+    bool showLabels = displayNode->GetPointLabelsVisibility();
+    if (showLabels && !batch.TextPropertyInitialized)
+    {
+      // Text properties are part of the batch key, therefore they are the same for all display nodes of the batch
+      this->Internal->GetLabelTextProperty(displayNode, batch.TextProperty);
+      batch.TextPropertyInitialized = true;
+    }
+
+    int numberOfControlPoints = markupsNode->GetNumberOfControlPoints();
+    for (int pointIndex = 0; pointIndex < numberOfControlPoints; ++pointIndex)
+    {
+      if (!(markupsNode->GetNthControlPointPositionVisibility(pointIndex)
+        && markupsNode->GetNthControlPointVisibility(pointIndex)))
+      {
+        continue;
+      }
+      double worldPos[3] = { 0.0, 0.0, 0.0 };
+      markupsNode->GetNthControlPointPositionWorld(pointIndex, worldPos);
+      batch.ControlPoints->InsertNextPoint(worldPos);
+      batch.Colors->InsertNextTypedTuple(rgba[markupsNode->GetNthControlPointSelected(pointIndex) ? 1 : 0]);
+      batch.Scales->InsertNextValue(scale);
+      if (showLabels)
+      {
+        batch.LabelControlPoints->InsertNextPoint(worldPos);
+        batch.Labels->InsertNextValue(markupsNode->GetNthControlPointLabel(pointIndex));
+        batch.LabelsPriority->InsertNextValue(std::to_string(pointIndex));
+      }
+    }
+  }
+
+  for (auto& batchIt : this->Internal->Batches)
+  {
+    vtkInternal::Batch& batch = batchIt.second;
+    batch.ControlPoints->Modified();
+    batch.Colors->Modified();
+    batch.Scales->Modified();
+    batch.ControlPointsPolyData->Modified();
+    batch.LabelControlPoints->Modified();
+    batch.Labels->Modified();
+    batch.LabelsPriority->Modified();
+    batch.LabelControlPointsPolyData->Modified();
+    if (batch.GlyphType != vtkMRMLMarkupsDisplayNode::Sphere3D)
+    {
+      this->Internal->UpdateGlyphOrientations(batch);
+    }
+    batch.Actor->SetVisibility(batch.ControlPoints->GetNumberOfPoints() > 0);
+    batch.LabelsActor->SetVisibility(batch.LabelControlPoints->GetNumberOfPoints() > 0);
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLMarkupsBatchedRepresentation::GetNumberOfBatches()
+{
+  this->UpdateBatches();
+  int numberOfBatches = 0;
+  for (auto& batchIt : this->Internal->Batches)
+  {
+    if (batchIt.second.ControlPoints->GetNumberOfPoints() > 0)
+    {
+      numberOfBatches++;
+    }
+  }
+  return numberOfBatches;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkMRMLMarkupsBatchedRepresentation::GetNumberOfControlPoints()
+{
+  this->UpdateBatches();
+  vtkIdType numberOfControlPoints = 0;
+  for (auto& batchIt : this->Internal->Batches)
+  {
+    numberOfControlPoints += batchIt.second.ControlPoints->GetNumberOfPoints();
+  }
+  return numberOfControlPoints;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBatchedRepresentation::UpdateViewScaleFactor()
+{
+  // Same as vtkSlicerMarkupsWidgetRepresentation3D::UpdateViewScaleFactor()
+  this->Internal->ViewScaleFactorMmPerPixel = 1.0;
+  this->Internal->ScreenSizePixel = 1000.0;
+  vtkRenderer* renderer = this->Internal->Renderer;
+  if (!renderer || !renderer->GetActiveCamera() || !renderer->GetRenderWindow())
+  {
+    return;
+  }
+  if (renderer->GetRenderWindow()->GetNeverRendered())
+  {
+    // In VR, calling GetScreenSize() without rendering can cause a crash.
+    return;
+  }
+  const int* screenSize = renderer->GetRenderWindow()->GetScreenSize();
+  double screenSizePixel = sqrt(screenSize[0] * screenSize[0] + screenSize[1] * screenSize[1]);
+  if (screenSizePixel < 1.0)
+  {
+    // render window is not fully initialized yet
+    return;
+  }
+  this->Internal->ScreenSizePixel = screenSizePixel;
+  double cameraFP[3] = { 0.0 };
+  renderer->GetActiveCamera()->GetFocalPoint(cameraFP);
+  this->Internal->ViewScaleFactorMmPerPixel = vtkMRMLAbstractThreeDViewDisplayableManager::
+    GetViewScaleFactorAtPosition(renderer, cameraFP);
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLMarkupsDisplayNode* vtkMRMLMarkupsBatchedRepresentation::FindClosestDisplayNode(
+  vtkMRMLInteractionEventData* eventData, double& closestDistance2)
+{
+  closestDistance2 = VTK_DOUBLE_MAX;
+  vtkRenderer* renderer = this->Internal->Renderer;
+  if (!eventData || !renderer || this->Internal->DisplayNodes.empty())
+  {
+    return nullptr;
+  }
+
+  // Display position is valid in case of desktop interactions. Otherwise it is a 3D only context such as
+  // virtual reality, and then we expect a valid world position in the absence of display position.
+  double displayPosition3[3] = { 0.0, 0.0, 0.0 };
+  bool useDisplayPosition = eventData->IsDisplayPositionValid();
+  if (useDisplayPosition)
+  {
+    const int* displayPosition = eventData->GetDisplayPosition();
+    displayPosition3[0] = static_cast<double>(displayPosition[0]);
+    displayPosition3[1] = static_cast<double>(displayPosition[1]);
+  }
+  else if (!eventData->IsWorldPositionValid())
+  {
+    return nullptr;
+  }
+
+  this->UpdateViewScaleFactor();
+  double screenScaleFactor = this->Internal->GetScreenScaleFactor();
+
+  vtkMRMLMarkupsDisplayNode* closestDisplayNode = nullptr;
+  for (auto& displayNodeIt : this->Internal->DisplayNodes)
+  {
+    vtkMRMLMarkupsDisplayNode* displayNode = displayNodeIt.first;
+    if (!this->Internal->IsDisplayNodeVisible(displayNode) || displayNode->GetMarkupsNode()->GetLocked())
+    {
+      continue;
+    }
+    vtkMRMLMarkupsNode* markupsNode = displayNode->GetMarkupsNode();
+    double controlPointSize = this->Internal->GetControlPointSize(displayNode);
+    int numberOfControlPoints = markupsNode->GetNumberOfControlPoints();
+    for (int pointIndex = 0; pointIndex < numberOfControlPoints; ++pointIndex)
+    {
+      if (!(markupsNode->GetNthControlPointPositionVisibility(pointIndex)
+        && markupsNode->GetNthControlPointVisibility(pointIndex)))
+      {
+        continue;
+      }
+      double pointPosWorld[3] = { 0.0, 0.0, 0.0 };
+      markupsNode->GetNthControlPointPositionWorld(pointIndex, pointPosWorld);
+      double dist2 = VTK_DOUBLE_MAX;
+      double tolerance = 0.0;
+      if (useDisplayPosition)
+      {
+        double pointPosDisplay[3] = { 0.0, 0.0, 0.0 };
+        eventData->WorldToDisplay(pointPosWorld, pointPosDisplay);
+        pointPosDisplay[2] = 0.0;
+        dist2 = vtkMath::Distance2BetweenPoints(pointPosDisplay, displayPosition3);
+        tolerance = controlPointSize / 2.0 / vtkMRMLAbstractThreeDViewDisplayableManager::
+          GetViewScaleFactorAtPosition(renderer, pointPosWorld, eventData)
+          + this->PickingTolerance * screenScaleFactor;
+      }
+      else
+      {
+        dist2 = vtkMath::Distance2BetweenPoints(pointPosWorld, eventData->GetWorldPosition());
+        tolerance = controlPointSize / 2.0 + this->PickingTolerance / eventData->GetWorldToPhysicalScale();
+      }
+      if (dist2 < tolerance * tolerance && dist2 < closestDistance2)
+      {
+        closestDistance2 = dist2;
+        closestDisplayNode = displayNode;
+      }
+    }
+  }
+  return closestDisplayNode;
+}
+
+//----------------------------------------------------------------------------
+double* vtkMRMLMarkupsBatchedRepresentation::GetBounds()
+{
+  this->UpdateBatches();
+  vtkBoundingBox boundingBox;
+  for (auto& batchIt : this->Internal->Batches)
+  {
+    vtkInternal::Batch& batch = batchIt.second;
+    if (batch.Actor->GetVisibility())
+    {
+      boundingBox.AddBounds(batch.Actor->GetBounds());
+    }
+  }
+  if (!boundingBox.IsValid())
+  {
+    return nullptr;
+  }
+  boundingBox.GetBounds(this->Bounds);
+  return this->Bounds;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBatchedRepresentation::GetActors(vtkPropCollection* vtkNotUsed(pc))
+{
+  // Batched control points are not pickable
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBatchedRepresentation::ReleaseGraphicsResources(vtkWindow* window)
+{
+  for (auto& batchIt : this->Internal->Batches)
+  {
+    batchIt.second.Actor->ReleaseGraphicsResources(window);
+    batchIt.second.LabelsActor->ReleaseGraphicsResources(window);
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLMarkupsBatchedRepresentation::RenderOpaqueGeometry(vtkViewport* viewport)
+{
+  this->UpdateBatches();
+
+  // Recompute glyph size if it is relative to the screen size
+  // (it gets smaller/larger as the camera is moved or zoomed)
+  this->UpdateViewScaleFactor();
+  double relativeGlyphScaleFactor = this->Internal->ScreenSizePixel * this->Internal->GetScreenScaleFactor()
+    / 100.0 * this->Internal->ViewScaleFactorMmPerPixel;
+  // Only update the size if there is noticeable difference to avoid slight flickering when the camera is moved
+  if (this->Internal->RelativeGlyphScaleFactor <= 0.0
+    || fabs(relativeGlyphScaleFactor - this->Internal->RelativeGlyphScaleFactor) / this->Internal->RelativeGlyphScaleFactor > 0.05)
+  {
+    this->Internal->RelativeGlyphScaleFactor = relativeGlyphScaleFactor;
+  }
+
+  int count = 0;
+  for (auto& batchIt : this->Internal->Batches)
+  {
+    vtkInternal::Batch& batch = batchIt.second;
+    if (!batch.Actor->GetVisibility())
+    {
+      continue;
+    }
+    batch.GlyphMapper->SetScaleFactor(batch.RelativeGlyphSize ? this->Internal->RelativeGlyphScaleFactor : 1.0);
+    if (batch.GlyphType != vtkMRMLMarkupsDisplayNode::Sphere3D)
+    {
+      this->Internal->UpdateGlyphOrientations(batch);
+    }
+    count += batch.Actor->RenderOpaqueGeometry(viewport);
+  }
+  return count;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLMarkupsBatchedRepresentation::RenderTranslucentPolygonalGeometry(vtkViewport* viewport)
+{
+  int count = 0;
+  for (auto& batchIt : this->Internal->Batches)
+  {
+    vtkInternal::Batch& batch = batchIt.second;
+    if (batch.Actor->GetVisibility() && batch.Actor->HasTranslucentPolygonalGeometry())
+    {
+      count += batch.Actor->RenderTranslucentPolygonalGeometry(viewport);
+    }
+  }
+  return count;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLMarkupsBatchedRepresentation::RenderOverlay(vtkViewport* viewport)
+{
+  int count = 0;
+  vtkFloatArray* zBuffer = nullptr;
+  for (auto& batchIt : this->Internal->Batches)
+  {
+    vtkInternal::Batch& batch = batchIt.second;
+    if (!batch.LabelsActor->GetVisibility())
+    {
+      continue;
+    }
+    // Hide labels of occluded control points. The z-buffer is read only once for all batches.
+    if (!zBuffer)
+    {
+      batch.SelectVisiblePoints->UpdateZBuffer();
+      zBuffer = batch.SelectVisiblePoints->GetZBuffer();
+    }
+    else
+    {
+      batch.SelectVisiblePoints->SetZBuffer(zBuffer);
+    }
+    double controlPointSize = batch.MaximumScale * (batch.RelativeGlyphSize ? this->Internal->RelativeGlyphScaleFactor : 1.0);
+    batch.SelectVisiblePoints->SetToleranceWorld(controlPointSize * 0.7);
+    batch.SelectVisiblePoints->Update();
+    count += batch.LabelsActor->RenderOverlay(viewport);
+  }
+  return count;
+}
+
+//----------------------------------------------------------------------------
+vtkTypeBool vtkMRMLMarkupsBatchedRepresentation::HasTranslucentPolygonalGeometry()
+{
+  this->UpdateBatches();
+  for (auto& batchIt : this->Internal->Batches)
+  {
+    vtkInternal::Batch& batch = batchIt.second;
+    if (batch.Actor->GetVisibility() && batch.Actor->HasTranslucentPolygonalGeometry())
+    {
+      return true;
+    }
+  }
+  return false;
+}
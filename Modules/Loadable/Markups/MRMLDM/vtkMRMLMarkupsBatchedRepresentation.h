@@ -0,0 +1,129 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef vtkMRMLMarkupsBatchedRepresentation_h
+#define vtkMRMLMarkupsBatchedRepresentation_h
+
+// MarkupsModule includes
+#include "vtkSlicerMarkupsModuleMRMLDisplayableManagerExport.h"
+
+// VTK includes
+#include <vtkProp.h>
+
+// STD includes
+#include <vector>
+
+class vtkMRMLAbstractViewNode;
+class vtkMRMLInteractionEventData;
+class vtkMRMLMarkupsDisplayNode;
+class vtkRenderer;
+
+/// \brief Draws control points of many markups nodes in a 3D view using shared glyph mappers.
+///
+/// Each markups widget has its own rendering pipeline (glyph mappers, label mappers, actors),
+/// which makes rendering and scene loading slow when thousands of markups nodes are displayed.
+/// This representation draws the control points of all its display nodes with one instanced
+/// glyph mapper (vtkGlyph3DMapper) and one label mapper per markups type, glyph type, glyph sizing mode,
+/// and label text properties (display nodes that show labels in a different color or font are drawn
+/// in separate batches). Per-node properties (color, selected color, opacity, glyph size) are stored
+/// in point data arrays. 2D glyphs are oriented to face the camera.
+///
+/// Only control point glyphs and point labels are drawn, without occluded visibility.
+/// Display nodes can be temporarily excluded from drawing (while a full widget displays them)
+/// but they are still taken into account in FindClosestDisplayNode().
+///
+/// Geometry is rebuilt before the next render after UpdateFromMRML() is called.
+class VTK_SLICER_MARKUPS_MODULE_MRMLDISPLAYABLEMANAGER_EXPORT vtkMRMLMarkupsBatchedRepresentation : public vtkProp
+{
+public:
+  static vtkMRMLMarkupsBatchedRepresentation* New();
+  vtkTypeMacro(vtkMRMLMarkupsBatchedRepresentation, vtkProp);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  void SetRenderer(vtkRenderer* renderer);
+  vtkRenderer* GetRenderer();
+
+  void SetViewNode(vtkMRMLAbstractViewNode* viewNode);
+  vtkMRMLAbstractViewNode* GetViewNode();
+
+  void AddDisplayNode(vtkMRMLMarkupsDisplayNode* displayNode);
+  void RemoveDisplayNode(vtkMRMLMarkupsDisplayNode* displayNode);
+  void RemoveAllDisplayNodes();
+  bool HasDisplayNode(vtkMRMLMarkupsDisplayNode* displayNode);
+  int GetNumberOfDisplayNodes();
+  void GetDisplayNodes(std::vector<vtkMRMLMarkupsDisplayNode*>& displayNodes);
+
+  /// Excluded display nodes are not drawn (they are displayed by a widget instead).
+  void SetDisplayNodeExcluded(vtkMRMLMarkupsDisplayNode* displayNode, bool excluded);
+  bool GetDisplayNodeExcluded(vtkMRMLMarkupsDisplayNode* displayNode);
+  void GetExcludedDisplayNodes(std::vector<vtkMRMLMarkupsDisplayNode*>& displayNodes);
+
+  /// Request rebuild of the batched geometry. It is performed before the next render.
+  void UpdateFromMRML();
+
+  /// Rebuild the batched geometry now if an update was requested.
+  /// It is called automatically before rendering.
+  void UpdateBatches();
+
+  /// Number of glyph batches (one for each markups type, glyph type, glyph sizing mode, and label text properties).
+  int GetNumberOfBatches();
+  /// Number of drawn control points in all batches.
+  vtkIdType GetNumberOfControlPoints();
+  /// Number of times the batched geometry has been rebuilt.
+  /// Can be used for checking that updates are coalesced.
+  vtkGetMacro(NumberOfBatchUpdates, int);
+
+  /// Find the display node (including excluded display nodes) that has a control point
+  /// closest to the interaction position, within the picking tolerance.
+  /// Returns nullptr if there is no control point near the position.
+  vtkMRMLMarkupsDisplayNode* FindClosestDisplayNode(vtkMRMLInteractionEventData* eventData, double& closestDistance2);
+
+  /// Tolerance for finding control points, in pixels. Default is the same as for widget representations.
+  vtkSetMacro(PickingTolerance, double);
+  vtkGetMacro(PickingTolerance, double);
+
+  //@{
+  /// Methods to make this class behave as a vtkProp.
+  double* GetBounds() VTK_SIZEHINT(6) override;
+  void GetActors(vtkPropCollection* pc) override;
+  void ReleaseGraphicsResources(vtkWindow* window) override;
+  int RenderOpaqueGeometry(vtkViewport* viewport) override;
+  int RenderTranslucentPolygonalGeometry(vtkViewport* viewport) override;
+  int RenderOverlay(vtkViewport* viewport) override;
+  vtkTypeBool HasTranslucentPolygonalGeometry() override;
+  //@}
+
+protected:
+  vtkMRMLMarkupsBatchedRepresentation();
+  ~vtkMRMLMarkupsBatchedRepresentation() override;
+
+  /// Update the screen size and view scale factor that relative glyph sizes are computed from.
+  void UpdateViewScaleFactor();
+
+  double PickingTolerance{ 30.0 };
+  int NumberOfBatchUpdates{ 0 };
+  double Bounds[6];
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkMRMLMarkupsBatchedRepresentation(const vtkMRMLMarkupsBatchedRepresentation&) = delete;
+  void operator=(const vtkMRMLMarkupsBatchedRepresentation&) = delete;
+};
+
+#endif
@@ -70,6 +70,7 @@ vtkMRMLMarkupsDisplayableManager::vtkMRMLMarkupsDisplayableManager()
   this->Helper = vtkSmartPointer<vtkMRMLMarkupsDisplayableManagerHelper>::New();
   this->Helper->SetDisplayableManager(this);
   this->DisableInteractorStyleEventsProcessing = 0;
+  this->BatchedRepresentationMinimumNumberOfNodes = 100;
 
   this->LastClickWorldCoordinates[0]=0.0;
   this->LastClickWorldCoordinates[1]=0.0;
@@ -90,6 +91,7 @@ void vtkMRMLMarkupsDisplayableManager::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 
   os << indent << "DisableInteractorStyleEventsProcessing = " << this->DisableInteractorStyleEventsProcessing << std::endl;
+  os << indent << "BatchedRepresentationMinimumNumberOfNodes = " << this->BatchedRepresentationMinimumNumberOfNodes << std::endl;
   if (this->SliceNode &&
       this->SliceNode->GetID())
   {
@@ -113,6 +115,18 @@ bool vtkMRMLMarkupsDisplayableManager::Is2DDisplayableManager()
   return this->GetMRMLSliceNode() != nullptr;
 }
 
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsDisplayableManager::SetBatchedRepresentationMinimumNumberOfNodes(int minimumNumberOfNodes)
+{
+  if (this->BatchedRepresentationMinimumNumberOfNodes == minimumNumberOfNodes)
+  {
+    return;
+  }
+  this->BatchedRepresentationMinimumNumberOfNodes = minimumNumberOfNodes;
+  this->Helper->UpdateBatchingEnabled(static_cast<int>(this->Helper->MarkupsNodes.size()));
+  this->Modified();
+}
+
 //---------------------------------------------------------------------------
 void vtkMRMLMarkupsDisplayableManager::RequestRender()
 {
@@ -142,6 +156,10 @@ void vtkMRMLMarkupsDisplayableManager::UpdateFromMRML()
 
   std::vector<vtkMRMLNode*> markupNodes;
   this->GetMRMLScene()->GetNodesByClass("vtkMRMLMarkupsNode", markupNodes);
+
+  // Decide if display nodes are drawn by the batched representation before widgets are created
+  this->Helper->UpdateBatchingEnabled(static_cast<int>(markupNodes.size()));
+
   for (std::vector< vtkMRMLNode* >::iterator nodeIt = markupNodes.begin(); nodeIt != markupNodes.end(); ++nodeIt)
   {
     vtkMRMLMarkupsNode *markupsNode = vtkMRMLMarkupsNode::SafeDownCast(*nodeIt);
@@ -215,6 +233,16 @@ void vtkMRMLMarkupsDisplayableManager::UpdateFromMRML()
     }
   }
 
+  // Remove batched display nodes that have been deleted from the scene
+  std::vector<vtkMRMLMarkupsDisplayNode*> batchedDisplayNodes;
+  this->Helper->GetBatchedRepresentation()->GetDisplayNodes(batchedDisplayNodes);
+  for (vtkMRMLMarkupsDisplayNode* batchedDisplayNode : batchedDisplayNodes)
+  {
+    if (!this->GetMRMLScene()->IsNodePresent(batchedDisplayNode))
+    {
+      this->Helper->RemoveDisplayNode(batchedDisplayNode);
+    }
+  }
 }
 
 //---------------------------------------------------------------------------
@@ -253,6 +281,18 @@ void vtkMRMLMarkupsDisplayableManager
     for (int displayNodeIndex = 0; displayNodeIndex < markupsNode->GetNumberOfDisplayNodes(); displayNodeIndex++)
     {
       vtkMRMLMarkupsDisplayNode* displayNode = vtkMRMLMarkupsDisplayNode::SafeDownCast(markupsNode->GetNthDisplayNode(displayNodeIndex));
+      if (this->Helper->IsDisplayNodeBatched(displayNode))
+      {
+        if (this->Helper->CanBatchDisplayNode(displayNode))
+        {
+          // Batched geometry is rebuilt once before the next render
+          this->Helper->GetBatchedRepresentation()->UpdateFromMRML();
+          renderRequested = true;
+          continue;
+        }
+        // The display node now uses features that only the widget can display
+        this->Helper->UnbatchDisplayNode(displayNode);
+      }
       vtkSlicerMarkupsWidget *widget = this->Helper->GetWidget(displayNode);
       if (!widget)
       {
@@ -367,6 +407,7 @@ void vtkMRMLMarkupsDisplayableManager::OnMRMLSceneNodeAdded(vtkMRMLNode* node)
   if (node->IsA("vtkMRMLMarkupsNode"))
   {
     this->Helper->AddMarkupsNode(vtkMRMLMarkupsNode::SafeDownCast(node));
+    this->Helper->UpdateBatchingEnabled(static_cast<int>(this->Helper->MarkupsNodes.size()));
 
     // and render again
     this->RequestRender();
@@ -419,6 +460,7 @@ void vtkMRMLMarkupsDisplayableManager::OnMRMLSceneNodeRemoved(vtkMRMLNode* node)
   if (markupsNode)
   {
     this->Helper->RemoveMarkupsNode(markupsNode);
+    this->Helper->UpdateBatchingEnabled(static_cast<int>(this->Helper->MarkupsNodes.size()));
     modified = true;
   }
 
@@ -479,6 +521,13 @@ void vtkMRMLMarkupsDisplayableManager::OnMRMLViewNodeModifiedEvent(vtkMRMLAbstra
 {
   bool renderRequested = false;
 
+  if (this->Helper->GetBatchedRepresentation()->GetNumberOfDisplayNodes() > 0)
+  {
+    // Screen scale factor and label visibility may have changed
+    this->Helper->GetBatchedRepresentation()->UpdateFromMRML();
+    renderRequested = true;
+  }
+
   // run through all markup nodes in the helper
   vtkMRMLMarkupsDisplayableManagerHelper::DisplayNodeToWidgetIt it
     = this->Helper->MarkupsDisplayNodesToWidgets.begin();
@@ -519,12 +568,14 @@ void vtkMRMLMarkupsDisplayableManager::OnMRMLViewNodeModifiedEvent(vtkMRMLAbstra
 //---------------------------------------------------------------------------
 vtkSlicerMarkupsWidget* vtkMRMLMarkupsDisplayableManager::GetWidget(vtkMRMLMarkupsDisplayNode * node)
 {
+  this->Helper->UnbatchDisplayNode(node);
   return this->Helper->GetWidget(node);
 }
 
 //---------------------------------------------------------------------------
 vtkSlicerMarkupsInteractionWidget* vtkMRMLMarkupsDisplayableManager::GetInteractionWidget(vtkMRMLMarkupsDisplayNode * node)
 {
+  this->Helper->UnbatchDisplayNode(node);
   return this->Helper->GetInteractionWidget(node);
 }
 
@@ -594,6 +645,10 @@ vtkMRMLAbstractWidget* vtkMRMLMarkupsDisplayableManager::FindClosestWidget(vtkMR
   vtkMRMLAbstractWidget* closestWidget = nullptr;
   closestDistance2 = VTK_DOUBLE_MAX;
 
+  // Create widgets for batched markups that are near the interaction position
+  // and release widgets of batched markups that are not interacted with anymore.
+  this->Helper->UpdateBatchedDisplayNodes(callData, this->LastActiveWidget);
+
   for (vtkMRMLMarkupsDisplayableManagerHelper::DisplayNodeToWidgetIt widgetIterator = this->Helper->MarkupsDisplayNodesToWidgets.begin();
     widgetIterator != this->Helper->MarkupsDisplayNodesToWidgets.end(); ++widgetIterator)
   {
@@ -889,6 +944,8 @@ vtkSlicerMarkupsWidget* vtkMRMLMarkupsDisplayableManager::GetWidgetForPlacement(
     {
       return nullptr;
     }
+    // Points are placed using the widget
+    this->Helper->UnbatchMarkupsNode(activeMarkupsNode);
   }
 
   if (activeMarkupsNode && activeMarkupsNode->GetMaximumNumberOfControlPoints() >= 0
@@ -924,6 +981,7 @@ vtkSlicerMarkupsWidget* vtkMRMLMarkupsDisplayableManager::GetWidgetForPlacement(
     if (activeMarkupsNode)
     {
       selectionNode->SetReferenceActivePlaceNodeID(activeMarkupsNode->GetID());
+      this->Helper->UnbatchMarkupsNode(activeMarkupsNode);
     }
     else
     {
@@ -991,6 +1049,12 @@ void vtkMRMLMarkupsDisplayableManager::Create()
   this->InteractionRenderer->SetActiveCamera(renderer->GetActiveCamera());
   this->InteractionRenderer->SetLayer(INTERACTION_RENDERER_LAYER);
   renderWindow->AddRenderer(this->InteractionRenderer);
+
+  vtkMRMLMarkupsBatchedRepresentation* batchedRepresentation = this->Helper->GetBatchedRepresentation();
+  batchedRepresentation->SetRenderer(renderer);
+  batchedRepresentation->SetViewNode(vtkMRMLAbstractViewNode::SafeDownCast(this->GetMRMLDisplayableNode()));
+  renderer->AddViewProp(batchedRepresentation);
+
   for (auto interactionWidget : this->Helper->MarkupsDisplayNodesToInteractionWidgets)
   {
     // Update the renderer of any interaction widgets that were already created.
@@ -83,11 +83,21 @@ public:
   void ConvertDeviceToXYZ(double x, double y, double xyz[3]);
 
   /// Get the widget of a node.
+  /// If the node is drawn by the batched representation then a widget is created for it.
   vtkSlicerMarkupsWidget* GetWidget(vtkMRMLMarkupsDisplayNode * node);
 
   /// Get the interaction widget of a node.
+  /// If the node is drawn by the batched representation then a widget is created for it.
   vtkSlicerMarkupsInteractionWidget* GetInteractionWidget(vtkMRMLMarkupsDisplayNode * node);
 
+  /// Point lists are drawn in 3D views by a shared batched representation instead of
+  /// individual widgets when the scene contains at least this many markups nodes.
+  /// Widgets are still created for markups that are hovered, placed, or edited.
+  /// Negative value disables batching. Default is 100.
+  /// \sa vtkMRMLMarkupsBatchedRepresentation
+  void SetBatchedRepresentationMinimumNumberOfNodes(int minimumNumberOfNodes);
+  vtkGetMacro(BatchedRepresentationMinimumNumberOfNodes, int);
+
 protected:
 
   vtkMRMLMarkupsDisplayableManager();
@@ -164,6 +174,8 @@ private:
 
   int DisableInteractorStyleEventsProcessing;
 
+  int BatchedRepresentationMinimumNumberOfNodes;
+
   // by default, this displayableManager handles a 2d view, so the SliceNode
   // must be set when it's assigned to a viewer
   vtkWeakPointer<vtkMRMLSliceNode> SliceNode;
@@ -61,6 +61,8 @@ vtkMRMLMarkupsDisplayableManagerHelper::vtkMRMLMarkupsDisplayableManagerHelper()
 {
   this->DisplayableManager = nullptr;
   this->AddingMarkupsNode = false;
+  this->BatchedRepresentation = vtkSmartPointer<vtkMRMLMarkupsBatchedRepresentation>::New();
+  this->BatchingEnabled = false;
   this->ObservedMarkupNodeEvents.push_back(vtkCommand::ModifiedEvent);
   this->ObservedMarkupNodeEvents.push_back(vtkMRMLTransformableNode::TransformModifiedEvent);
   this->ObservedMarkupNodeEvents.push_back(vtkMRMLDisplayableNode::DisplayModifiedEvent);
@@ -109,6 +111,10 @@ void vtkMRMLMarkupsDisplayableManagerHelper::PrintSelf(ostream& os, vtkIndent in
       os << indent.GetNextIndent().GetNextIndent() << "number of nodes = " << numberOfNodes << std::endl;
     }
   }
+
+  os << indent << "BatchingEnabled: " << (this->BatchingEnabled ? "true" : "false") << std::endl;
+  os << indent << "BatchedRepresentation:" << std::endl;
+  this->BatchedRepresentation->PrintSelf(os, indent.GetNextIndent());
 };
 
 //---------------------------------------------------------------------------
@@ -188,6 +194,9 @@ void vtkMRMLMarkupsDisplayableManagerHelper::RemoveAllWidgetsAndNodes()
     this->RemoveObservations(*markupsIterator);
   }
   this->MarkupsNodes.clear();
+
+  this->BatchedRepresentation->RemoveAllDisplayNodes();
+  this->BatchingEnabled = false;
 }
 
 //---------------------------------------------------------------------------
@@ -291,6 +300,17 @@ void vtkMRMLMarkupsDisplayableManagerHelper::RemoveMarkupsNode(vtkMRMLMarkupsNod
     }
   }
 
+  // Remove batched display nodes corresponding to this markups node
+  std::vector<vtkMRMLMarkupsDisplayNode*> batchedDisplayNodes;
+  this->BatchedRepresentation->GetDisplayNodes(batchedDisplayNodes);
+  for (vtkMRMLMarkupsDisplayNode* batchedDisplayNode : batchedDisplayNodes)
+  {
+    if (batchedDisplayNode->GetDisplayableNode() == node)
+    {
+      this->BatchedRepresentation->RemoveDisplayNode(batchedDisplayNode);
+    }
+  }
+
   this->RemoveObservations(node);
   this->MarkupsNodes.erase(displayableIt);
 }
@@ -302,6 +322,17 @@ void vtkMRMLMarkupsDisplayableManagerHelper::AddDisplayNode(vtkMRMLMarkupsDispla
   {
     return;
   }
+  if (this->BatchedRepresentation->HasDisplayNode(markupsDisplayNode))
+  {
+    // already added
+    return;
+  }
+  if (this->BatchingEnabled && this->CanBatchDisplayNode(markupsDisplayNode))
+  {
+    this->BatchedRepresentation->AddDisplayNode(markupsDisplayNode);
+    this->DisplayableManager->RequestRender();
+    return;
+  }
   this->AddWidget(markupsDisplayNode);
   this->AddInteractionWidget(markupsDisplayNode);
 }
@@ -424,7 +455,13 @@ void vtkMRMLMarkupsDisplayableManagerHelper::RemoveDisplayNode(vtkMRMLMarkupsDis
   {
     return;
   }
+  this->BatchedRepresentation->RemoveDisplayNode(markupsDisplayNode);
+  this->RemoveWidgets(markupsDisplayNode);
+}
 
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsDisplayableManagerHelper::RemoveWidgets(vtkMRMLMarkupsDisplayNode* markupsDisplayNode)
+{
   vtkMRMLMarkupsDisplayableManagerHelper::DisplayNodeToWidgetIt displayNodeIt
     = this->MarkupsDisplayNodesToWidgets.find(markupsDisplayNode);
   if (displayNodeIt != this->MarkupsDisplayNodesToWidgets.end())
@@ -548,3 +585,161 @@ vtkSlicerMarkupsInteractionWidget* vtkMRMLMarkupsDisplayableManagerHelper::GetIn
 
   return it->second;
 }
+
+//---------------------------------------------------------------------------
+vtkMRMLMarkupsBatchedRepresentation* vtkMRMLMarkupsDisplayableManagerHelper::GetBatchedRepresentation()
+{
+  return this->BatchedRepresentation;
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsDisplayableManagerHelper::UpdateBatchingEnabled(int numberOfMarkupsNodes)
+{
+  if (!this->DisplayableManager)
+  {
+    return;
+  }
+  int minimumNumberOfNodes = this->DisplayableManager->GetBatchedRepresentationMinimumNumberOfNodes();
+  bool batchingEnabled = !this->DisplayableManager->Is2DDisplayableManager()
+    && minimumNumberOfNodes >= 0 && numberOfMarkupsNodes >= minimumNumberOfNodes;
+  if (batchingEnabled == this->BatchingEnabled)
+  {
+    return;
+  }
+  this->BatchingEnabled = batchingEnabled;
+
+  std::vector<vtkMRMLMarkupsDisplayNode*> displayNodes;
+  if (batchingEnabled)
+  {
+    // Move display nodes from widgets into the batched representation
+    for (DisplayNodeToWidgetIt widgetIterator = this->MarkupsDisplayNodesToWidgets.begin();
+      widgetIterator != this->MarkupsDisplayNodesToWidgets.end(); ++widgetIterator)
+    {
+      displayNodes.push_back(widgetIterator->first);
+    }
+    for (vtkMRMLMarkupsDisplayNode* displayNode : displayNodes)
+    {
+      if (!this->CanBatchDisplayNode(displayNode)
+        || this->GetWidget(displayNode) == this->DisplayableManager->LastActiveWidget.GetPointer())
+      {
+        continue;
+      }
+      this->RemoveWidgets(displayNode);
+      this->BatchedRepresentation->AddDisplayNode(displayNode);
+    }
+  }
+  else
+  {
+    // Create widgets for all batched display nodes
+    this->BatchedRepresentation->GetDisplayNodes(displayNodes);
+    this->BatchedRepresentation->RemoveAllDisplayNodes();
+    for (vtkMRMLMarkupsDisplayNode* displayNode : displayNodes)
+    {
+      this->AddWidget(displayNode);
+      this->AddInteractionWidget(displayNode);
+    }
+  }
+  this->DisplayableManager->RequestRender();
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLMarkupsDisplayableManagerHelper::CanBatchDisplayNode(vtkMRMLMarkupsDisplayNode* displayNode)
+{
+  if (!displayNode || !this->DisplayableManager || this->DisplayableManager->Is2DDisplayableManager())
+  {
+    return false;
+  }
+  // The batched representation only draws control points, therefore it is only used for point lists
+  vtkMRMLMarkupsNode* markupsNode = displayNode->GetMarkupsNode();
+  if (!markupsNode || !markupsNode->IsA("vtkMRMLMarkupsFiducialNode"))
+  {
+    return false;
+  }
+  // Features that require a widget
+  if ((displayNode->GetOccludedVisibility() && displayNode->GetOccludedOpacity() > 0.0)
+    || displayNode->GetHandlesInteractive()
+    || displayNode->HasActiveComponent())
+  {
+    return false;
+  }
+  // Node that is being placed
+  if (this->DisplayableManager->GetCurrentInteractionMode() == vtkMRMLInteractionNode::Place
+    && this->DisplayableManager->GetActiveMarkupsNodeForPlacement() == markupsNode)
+  {
+    return false;
+  }
+  return true;
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLMarkupsDisplayableManagerHelper::IsDisplayNodeBatched(vtkMRMLMarkupsDisplayNode* displayNode)
+{
+  return this->BatchedRepresentation->HasDisplayNode(displayNode)
+    && !this->BatchedRepresentation->GetDisplayNodeExcluded(displayNode);
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsDisplayableManagerHelper::UnbatchDisplayNode(vtkMRMLMarkupsDisplayNode* displayNode)
+{
+  if (!this->IsDisplayNodeBatched(displayNode))
+  {
+    return;
+  }
+  // The display node is kept in the batched representation (but not drawn there)
+  // so that it can be moved back when it is not interacted with anymore.
+  this->BatchedRepresentation->SetDisplayNodeExcluded(displayNode, true);
+  this->AddWidget(displayNode);
+  this->AddInteractionWidget(displayNode);
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsDisplayableManagerHelper::UnbatchMarkupsNode(vtkMRMLMarkupsNode* markupsNode)
+{
+  if (!markupsNode)
+  {
+    return;
+  }
+  for (int displayNodeIndex = 0; displayNodeIndex < markupsNode->GetNumberOfDisplayNodes(); displayNodeIndex++)
+  {
+    this->UnbatchDisplayNode(vtkMRMLMarkupsDisplayNode::SafeDownCast(markupsNode->GetNthDisplayNode(displayNodeIndex)));
+  }
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsDisplayableManagerHelper::UpdateBatchedDisplayNodes(
+  vtkMRMLInteractionEventData* eventData, vtkMRMLAbstractWidget* activeWidget)
+{
+  if (this->BatchedRepresentation->GetNumberOfDisplayNodes() == 0)
+  {
+    return;
+  }
+  double closestDistance2 = VTK_DOUBLE_MAX;
+  vtkMRMLMarkupsDisplayNode* hoveredDisplayNode =
+    this->BatchedRepresentation->FindClosestDisplayNode(eventData, closestDistance2);
+
+  // Move display nodes that are not interacted with anymore back into the batched representation
+  bool renderRequested = false;
+  std::vector<vtkMRMLMarkupsDisplayNode*> excludedDisplayNodes;
+  this->BatchedRepresentation->GetExcludedDisplayNodes(excludedDisplayNodes);
+  for (vtkMRMLMarkupsDisplayNode* displayNode : excludedDisplayNodes)
+  {
+    if (displayNode == hoveredDisplayNode
+      || (activeWidget && (activeWidget == this->GetWidget(displayNode) || activeWidget == this->GetInteractionWidget(displayNode)))
+      || !this->CanBatchDisplayNode(displayNode))
+    {
+      continue;
+    }
+    this->RemoveWidgets(displayNode);
+    this->BatchedRepresentation->SetDisplayNodeExcluded(displayNode, false);
+    renderRequested = true;
+  }
+
+  // Create widgets for the node that is near the interaction position
+  // so that it can be highlighted and edited.
+  this->UnbatchDisplayNode(hoveredDisplayNode);
+
+  if (renderRequested)
+  {
+    this->DisplayableManager->RequestRender();
+  }
+}
@@ -22,6 +22,10 @@
 ///   b) the vtkWidget to show this markup (Widgets)
 ///   c) a vtkWidget to represent sliceIntersections in the slice viewers (WidgetIntersections)
 ///
+/// When many markups nodes are displayed in a 3D view, then instead of creating widgets,
+/// point lists are drawn by a shared vtkMRMLMarkupsBatchedRepresentation. A widget is only created
+/// for a batched node while it is hovered, placed, or edited.
+///
 
 
 #ifndef vtkMRMLMarkupsDisplayableManagerHelper_h
@@ -30,6 +34,9 @@
 // MarkupsModule includes
 #include "vtkSlicerMarkupsModuleMRMLDisplayableManagerExport.h"
 
+// MarkupsModule/MRMLDisplayableManager includes
+#include "vtkMRMLMarkupsBatchedRepresentation.h"
+
 // MarkupsModule/MRML includes
 #include <vtkMRMLMarkupsNode.h>
 
@@ -46,6 +53,8 @@
 // STL includes
 #include <set>
 
+class vtkMRMLAbstractWidget;
+class vtkMRMLInteractionEventData;
 class vtkMRMLMarkupsDisplayableManager;
 class vtkMRMLMarkupsDisplayNode;
 class vtkMRMLInteractionNode;
@@ -104,6 +113,32 @@ public:
   void AddObservations(vtkMRMLMarkupsNode* node);
   void RemoveObservations(vtkMRMLMarkupsNode* node);
 
+  /// Representation that draws display nodes that are not displayed by widgets.
+  vtkMRMLMarkupsBatchedRepresentation* GetBatchedRepresentation();
+
+  /// Enable batched display if there are at least BatchedRepresentationMinimumNumberOfNodes
+  /// markups nodes in a 3D view, and move display nodes between widgets and the batched
+  /// representation accordingly.
+  /// \sa vtkMRMLMarkupsDisplayableManager::SetBatchedRepresentationMinimumNumberOfNodes
+  void UpdateBatchingEnabled(int numberOfMarkupsNodes);
+  vtkGetMacro(BatchingEnabled, bool);
+
+  /// Returns true if the display node can be drawn by the batched representation:
+  /// it is a point list in a 3D view, uses only features that the batched representation supports,
+  /// and it is not being placed or interacted with.
+  bool CanBatchDisplayNode(vtkMRMLMarkupsDisplayNode* displayNode);
+  /// Returns true if the display node is currently drawn by the batched representation.
+  bool IsDisplayNodeBatched(vtkMRMLMarkupsDisplayNode* displayNode);
+
+  /// Create widgets for a display node that is drawn by the batched representation.
+  void UnbatchDisplayNode(vtkMRMLMarkupsDisplayNode* displayNode);
+  /// Create widgets for all display nodes of a markups node that are drawn by the batched representation.
+  void UnbatchMarkupsNode(vtkMRMLMarkupsNode* markupsNode);
+
+  /// Create widgets for the batched display node near the interaction position and
+  /// move display nodes that are not interacted with anymore back into the batched representation.
+  void UpdateBatchedDisplayNodes(vtkMRMLInteractionEventData* eventData, vtkMRMLAbstractWidget* activeWidget);
+
 protected:
 
   vtkMRMLMarkupsDisplayableManagerHelper();
@@ -114,6 +149,9 @@ private:
   vtkMRMLMarkupsDisplayableManagerHelper(const vtkMRMLMarkupsDisplayableManagerHelper&) = delete;
   void operator=(const vtkMRMLMarkupsDisplayableManagerHelper&) = delete;
 
+  /// Delete the widget and interaction widget of the display node.
+  void RemoveWidgets(vtkMRMLMarkupsDisplayNode* displayNode);
+
   /// Keep a record of the current glyph type for the handles in the widget
   /// associated with this node, prevents changing them unnecessarily
   std::map<vtkMRMLNode*, std::vector<int> > NodeGlyphTypes;
@@ -122,6 +160,9 @@ private:
 
   std::vector<unsigned long> ObservedMarkupNodeEvents;
 
+  vtkSmartPointer<vtkMRMLMarkupsBatchedRepresentation> BatchedRepresentation;
+  bool BatchingEnabled;
+
   vtkMRMLMarkupsDisplayableManager* DisplayableManager;
 };
 
@@ -0,0 +1,193 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLInteractionEventData.h"
+#include "vtkMRMLMarkupsDisplayNode.h"
+#include "vtkMRMLMarkupsFiducialNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLViewNode.h"
+
+// Markups MRMLDM includes
+#include "vtkMRMLMarkupsBatchedRepresentation.h"
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <vector>
+
+// Draw many point lists with the batched representation and check that
+// per-node display properties and picking are taken into account.
+
+//----------------------------------------------------------------------------
+int vtkMRMLMarkupsBatchedRepresentationTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLViewNode> viewNode;
+  scene->AddNode(viewNode);
+
+  vtkNew<vtkRenderer> renderer;
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetSize(600, 600);
+  renderWindow->AddRenderer(renderer);
+
+  vtkNew<vtkMRMLMarkupsBatchedRepresentation> batchedRepresentation;
+  batchedRepresentation->SetRenderer(renderer);
+  batchedRepresentation->SetViewNode(viewNode);
+  renderer->AddViewProp(batchedRepresentation);
+
+  // Point lists on a grid, each with two control points
+  const int numberOfRows = 10;
+  const int numberOfColumns = 20;
+  const double spacing = 20.0;
+  std::vector<vtkMRMLMarkupsFiducialNode*> markupsNodes;
+  for (int row = 0; row < numberOfRows; ++row)
+  {
+    for (int column = 0; column < numberOfColumns; ++column)
+    {
+      vtkMRMLMarkupsFiducialNode* markupsNode = vtkMRMLMarkupsFiducialNode::SafeDownCast(
+        scene->AddNewNodeByClass("vtkMRMLMarkupsFiducialNode"));
+      markupsNode->CreateDefaultDisplayNodes();
+      markupsNode->AddControlPoint(vtkVector3d(column * spacing, row * spacing, 0.0));
+      markupsNode->AddControlPoint(vtkVector3d(column * spacing + 5.0, row * spacing, 0.0));
+      batchedRepresentation->AddDisplayNode(markupsNode->GetMarkupsDisplayNode());
+      markupsNodes.push_back(markupsNode);
+    }
+  }
+  const int numberOfNodes = numberOfRows * numberOfColumns;
+  CHECK_INT(batchedRepresentation->GetNumberOfDisplayNodes(), numberOfNodes);
+
+  renderer->ResetCamera();
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  renderWindow->Render();
+  timer->StopTimer();
+  std::cout << "First render time of " << numberOfNodes << " point lists: "
+    << timer->GetElapsedTime() * 1000.0 << "ms" << std::endl;
+
+  // All control points are drawn by a single glyph mapper
+  CHECK_INT(batchedRepresentation->GetNumberOfBatches(), 1);
+  CHECK_INT(batchedRepresentation->GetNumberOfControlPoints(), 2 * numberOfNodes);
+  CHECK_INT(batchedRepresentation->GetNumberOfBatchUpdates(), 1);
+
+  // Rendering again does not rebuild the batches
+  timer->StartTimer();
+  renderWindow->Render();
+  timer->StopTimer();
+  std::cout << "Render time without changes: " << timer->GetElapsedTime() * 1000.0 << "ms" << std::endl;
+  CHECK_INT(batchedRepresentation->GetNumberOfBatchUpdates(), 1);
+
+  // Multiple update requests are coalesced into one rebuild
+  batchedRepresentation->UpdateFromMRML();
+  batchedRepresentation->UpdateFromMRML();
+  renderWindow->Render();
+  CHECK_INT(batchedRepresentation->GetNumberOfBatchUpdates(), 2);
+
+  // Absolute glyph size is drawn by a separate glyph mapper
+  markupsNodes[0]->GetMarkupsDisplayNode()->SetUseGlyphScale(false);
+  batchedRepresentation->UpdateFromMRML();
+  renderWindow->Render();
+  CHECK_INT(batchedRepresentation->GetNumberOfBatches(), 2);
+  CHECK_INT(batchedRepresentation->GetNumberOfControlPoints(), 2 * numberOfNodes);
+
+  // 2D glyphs are drawn by a separate glyph mapper
+  markupsNodes[4]->GetMarkupsDisplayNode()->SetGlyphType(vtkMRMLMarkupsDisplayNode::Cross2D);
+  batchedRepresentation->UpdateFromMRML();
+  renderWindow->Render();
+  CHECK_INT(batchedRepresentation->GetNumberOfBatches(), 3);
+  CHECK_INT(batchedRepresentation->GetNumberOfControlPoints(), 2 * numberOfNodes);
+
+  // Labels of a different color are drawn by a separate label mapper
+  for (vtkMRMLMarkupsFiducialNode* markupsNode : markupsNodes)
+  {
+    markupsNode->GetMarkupsDisplayNode()->SetPointLabelsVisibility(true);
+  }
+  double originalColor[3] = { 0.0, 0.0, 0.0 };
+  markupsNodes[5]->GetMarkupsDisplayNode()->GetColor(originalColor);
+  markupsNodes[5]->GetMarkupsDisplayNode()->SetColor(0.1, 0.9, 0.1);
+  batchedRepresentation->UpdateFromMRML();
+  renderWindow->Render();
+  CHECK_INT(batchedRepresentation->GetNumberOfBatches(), 4);
+  markupsNodes[5]->GetMarkupsDisplayNode()->SetColor(originalColor);
+  batchedRepresentation->UpdateFromMRML();
+  renderWindow->Render();
+  CHECK_INT(batchedRepresentation->GetNumberOfBatches(), 3);
+  CHECK_INT(batchedRepresentation->GetNumberOfControlPoints(), 2 * numberOfNodes);
+
+  // Hidden nodes are not drawn
+  markupsNodes[1]->GetMarkupsDisplayNode()->SetVisibility(false);
+  batchedRepresentation->UpdateFromMRML();
+  renderWindow->Render();
+  CHECK_INT(batchedRepresentation->GetNumberOfControlPoints(), 2 * (numberOfNodes - 1));
+
+  // Excluded nodes are not drawn
+  vtkMRMLMarkupsDisplayNode* excludedDisplayNode = markupsNodes[2]->GetMarkupsDisplayNode();
+  batchedRepresentation->SetDisplayNodeExcluded(excludedDisplayNode, true);
+  CHECK_BOOL(batchedRepresentation->GetDisplayNodeExcluded(excludedDisplayNode), true);
+  renderWindow->Render();
+  CHECK_INT(batchedRepresentation->GetNumberOfControlPoints(), 2 * (numberOfNodes - 2));
+
+  // Find node near a control point, excluded nodes are found, too
+  vtkNew<vtkMRMLInteractionEventData> eventData;
+  eventData->SetRenderer(renderer);
+  const int testedNodeIndices[3] = { 2, 55, numberOfNodes - 1 };
+  for (int testedNodeIndex : testedNodeIndices)
+  {
+    double pointPosition[3] = { 0.0, 0.0, 0.0 };
+    markupsNodes[testedNodeIndex]->GetNthControlPointPositionWorld(1, pointPosition);
+    renderer->SetWorldPoint(pointPosition[0], pointPosition[1], pointPosition[2], 1.0);
+    renderer->WorldToDisplay();
+    double* displayPosition = renderer->GetDisplayPoint();
+    int eventPosition[2] = { static_cast<int>(displayPosition[0] + 0.5), static_cast<int>(displayPosition[1] + 0.5) };
+    eventData->SetDisplayPosition(eventPosition);
+
+    double closestDistance2 = VTK_DOUBLE_MAX;
+    timer->StartTimer();
+    vtkMRMLMarkupsDisplayNode* foundDisplayNode = batchedRepresentation->FindClosestDisplayNode(eventData, closestDistance2);
+    timer->StopTimer();
+    std::cout << "Find closest display node time: " << timer->GetElapsedTime() * 1000.0 << "ms" << std::endl;
+    CHECK_POINTER(foundDisplayNode, markupsNodes[testedNodeIndex]->GetMarkupsDisplayNode());
+    CHECK_BOOL(closestDistance2 < 2.0, true);
+  }
+
+  // Locked nodes cannot be interacted with (event position is still at the last tested node)
+  vtkMRMLMarkupsFiducialNode* lockedNode = markupsNodes[testedNodeIndices[2]];
+  lockedNode->SetLocked(true);
+  double closestDistance2 = VTK_DOUBLE_MAX;
+  CHECK_BOOL(batchedRepresentation->FindClosestDisplayNode(eventData, closestDistance2)
+    == lockedNode->GetMarkupsDisplayNode(), false);
+
+  // Removing display nodes
+  batchedRepresentation->RemoveDisplayNode(markupsNodes[3]->GetMarkupsDisplayNode());
+  CHECK_INT(batchedRepresentation->GetNumberOfDisplayNodes(), numberOfNodes - 1);
+  renderWindow->Render();
+  CHECK_INT(batchedRepresentation->GetNumberOfControlPoints(), 2 * (numberOfNodes - 3));
+
+  batchedRepresentation->RemoveAllDisplayNodes();
+  CHECK_INT(batchedRepresentation->GetNumberOfDisplayNodes(), 0);
+  renderWindow->Render();
+  CHECK_INT(batchedRepresentation->GetNumberOfBatches(), 0);
+  CHECK_INT(batchedRepresentation->GetNumberOfControlPoints(), 0);
+
+  renderer->RemoveViewProp(batchedRepresentation);
+  return EXIT_SUCCESS;
+}
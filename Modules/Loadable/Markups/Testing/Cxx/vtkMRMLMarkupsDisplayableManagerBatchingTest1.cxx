@@ -0,0 +1,243 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Markups includes
+#include "vtkMRMLMarkupsDisplayableManager.h"
+#include "vtkMRMLMarkupsDisplayableManagerHelper.h"
+#include "vtkSlicerMarkupsLogic.h"
+
+// MRMLDisplayableManager includes
+#include <vtkMRMLDisplayableManagerGroup.h>
+
+// MRMLLogic includes
+#include <vtkMRMLApplicationLogic.h>
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLInteractionEventData.h"
+#include "vtkMRMLInteractionNode.h"
+#include "vtkMRMLMarkupsDisplayNode.h"
+#include "vtkMRMLMarkupsFiducialNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLSelectionNode.h"
+#include "vtkMRMLViewNode.h"
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
+
+// STD includes
+#include <vector>
+
+// Switch between widgets and the batched representation in the markups displayable manager:
+// batching is enabled when the number of markups nodes reaches the threshold, widgets are created
+// for hovered and placed nodes and released after the interaction, and batching can be disabled.
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Deliver a mouse move event to the displayable manager the same way as vtkMRMLViewInteractorStyle
+class MouseMoveSimulator
+{
+public:
+  MouseMoveSimulator(vtkMRMLMarkupsDisplayableManager* displayableManager, vtkRenderer* renderer)
+    : DisplayableManager(displayableManager)
+    , Renderer(renderer)
+  {
+    this->EventData->SetType(vtkCommand::MouseMoveEvent);
+    this->EventData->SetRenderer(renderer);
+    this->EventData->SetViewNode(vtkMRMLAbstractViewNode::SafeDownCast(displayableManager->GetMRMLDisplayableNode()));
+  }
+
+  void MoveTo(const double worldPosition[3])
+  {
+    this->Renderer->SetWorldPoint(worldPosition[0], worldPosition[1], worldPosition[2], 1.0);
+    this->Renderer->WorldToDisplay();
+    double* displayPosition = this->Renderer->GetDisplayPoint();
+    int eventPosition[2] = { static_cast<int>(displayPosition[0] + 0.5), static_cast<int>(displayPosition[1] + 0.5) };
+    this->EventData->SetDisplayPosition(eventPosition);
+    this->EventData->SetWorldPosition(worldPosition);
+
+    double closestDistance2 = VTK_DOUBLE_MAX;
+    if (this->DisplayableManager->CanProcessInteractionEvent(this->EventData, closestDistance2))
+    {
+      if (!this->HasFocus)
+      {
+        this->DisplayableManager->SetHasFocus(true, this->EventData);
+        this->HasFocus = true;
+      }
+      this->DisplayableManager->ProcessInteractionEvent(this->EventData);
+    }
+    else if (this->HasFocus)
+    {
+      this->DisplayableManager->SetHasFocus(false, this->EventData);
+      this->HasFocus = false;
+    }
+  }
+
+  vtkMRMLMarkupsDisplayableManager* DisplayableManager;
+  vtkRenderer* Renderer;
+  vtkNew<vtkMRMLInteractionEventData> EventData;
+  bool HasFocus{ false };
+};
+
+//----------------------------------------------------------------------------
+vtkMRMLMarkupsFiducialNode* AddPointList(vtkMRMLScene* scene, double x, double y)
+{
+  vtkMRMLMarkupsFiducialNode* markupsNode = vtkMRMLMarkupsFiducialNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLMarkupsFiducialNode"));
+  markupsNode->CreateDefaultDisplayNodes();
+  markupsNode->AddControlPoint(vtkVector3d(x, y, 0.0));
+  return markupsNode;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLMarkupsDisplayableManagerBatchingTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkRenderer> renderer;
+  vtkNew<vtkRenderWindow> renderWindow;
+  vtkNew<vtkRenderWindowInteractor> renderWindowInteractor;
+  renderWindow->SetSize(600, 600);
+  renderWindow->AddRenderer(renderer);
+  renderWindow->SetInteractor(renderWindowInteractor);
+
+  vtkNew<vtkMRMLScene> scene;
+
+  // Application logic - Handle creation of vtkMRMLSelectionNode and vtkMRMLInteractionNode
+  vtkNew<vtkMRMLApplicationLogic> applicationLogic;
+  applicationLogic->SetMRMLScene(scene);
+
+  vtkNew<vtkSlicerMarkupsLogic> markupsLogic;
+  markupsLogic->SetMRMLApplicationLogic(applicationLogic);
+  markupsLogic->SetMRMLScene(scene);
+  applicationLogic->SetModuleLogic("Markups", markupsLogic);
+
+  vtkNew<vtkMRMLViewNode> viewNode;
+  scene->AddNode(viewNode);
+
+  vtkNew<vtkMRMLDisplayableManagerGroup> displayableManagerGroup;
+  displayableManagerGroup->SetRenderer(renderer);
+  displayableManagerGroup->SetMRMLDisplayableNode(viewNode);
+
+  const int minimumNumberOfNodes = 10;
+  vtkNew<vtkMRMLMarkupsDisplayableManager> displayableManager;
+  displayableManager->SetBatchedRepresentationMinimumNumberOfNodes(minimumNumberOfNodes);
+  displayableManager->SetMRMLApplicationLogic(applicationLogic);
+  displayableManager->SetMRMLScene(scene);
+  displayableManagerGroup->AddDisplayableManager(displayableManager);
+  vtkMRMLMarkupsDisplayableManagerHelper* helper = displayableManager->GetHelper();
+  vtkMRMLMarkupsBatchedRepresentation* batchedRepresentation = helper->GetBatchedRepresentation();
+
+  // Below the threshold each point list has its own widget
+  const double spacing = 20.0;
+  std::vector<vtkMRMLMarkupsFiducialNode*> markupsNodes;
+  for (int nodeIndex = 0; nodeIndex < minimumNumberOfNodes - 1; ++nodeIndex)
+  {
+    markupsNodes.push_back(AddPointList(scene, nodeIndex * spacing, 0.0));
+  }
+  // 2D glyphs are drawn by the batched representation, too
+  markupsNodes[3]->GetMarkupsDisplayNode()->SetGlyphType(vtkMRMLMarkupsDisplayNode::Cross2D);
+  CHECK_BOOL(helper->GetBatchingEnabled(), false);
+  CHECK_INT(batchedRepresentation->GetNumberOfDisplayNodes(), 0);
+  CHECK_INT(static_cast<int>(helper->MarkupsDisplayNodesToWidgets.size()), minimumNumberOfNodes - 1);
+
+  // Batching is enabled when the number of nodes reaches the threshold
+  markupsNodes.push_back(AddPointList(scene, (minimumNumberOfNodes - 1) * spacing, 0.0));
+  CHECK_BOOL(helper->GetBatchingEnabled(), true);
+  CHECK_INT(batchedRepresentation->GetNumberOfDisplayNodes(), minimumNumberOfNodes);
+  CHECK_INT(static_cast<int>(helper->MarkupsDisplayNodesToWidgets.size()), 0);
+  for (vtkMRMLMarkupsFiducialNode* markupsNode : markupsNodes)
+  {
+    CHECK_BOOL(helper->IsDisplayNodeBatched(markupsNode->GetMarkupsDisplayNode()), true);
+  }
+
+  // Nodes added after batching is enabled are batched
+  markupsNodes.push_back(AddPointList(scene, minimumNumberOfNodes * spacing, 0.0));
+  CHECK_BOOL(helper->IsDisplayNodeBatched(markupsNodes.back()->GetMarkupsDisplayNode()), true);
+  CHECK_INT(static_cast<int>(helper->MarkupsDisplayNodesToWidgets.size()), 0);
+
+  renderer->ResetCamera();
+  renderWindow->Render();
+
+  MouseMoveSimulator mouse(displayableManager, renderer);
+  const double farPosition[3] = { -1000.0, -1000.0, 0.0 };
+
+  // A widget is created for the hovered node
+  vtkMRMLMarkupsFiducialNode* hoveredNode = markupsNodes[5];
+  vtkMRMLMarkupsDisplayNode* hoveredDisplayNode = hoveredNode->GetMarkupsDisplayNode();
+  double controlPointPosition[3] = { 0.0, 0.0, 0.0 };
+  hoveredNode->GetNthControlPointPositionWorld(0, controlPointPosition);
+  mouse.MoveTo(controlPointPosition);
+  CHECK_BOOL(helper->IsDisplayNodeBatched(hoveredDisplayNode), false);
+  CHECK_NOT_NULL(helper->GetWidget(hoveredDisplayNode));
+  CHECK_INT(static_cast<int>(helper->MarkupsDisplayNodesToWidgets.size()), 1);
+  // The node is kept in the batched representation, just not drawn there
+  CHECK_BOOL(batchedRepresentation->HasDisplayNode(hoveredDisplayNode), true);
+
+  // The node moves back into the batch after the mouse moves away
+  mouse.MoveTo(farPosition);
+  mouse.MoveTo(farPosition);
+  CHECK_BOOL(helper->IsDisplayNodeBatched(hoveredDisplayNode), true);
+  CHECK_NULL(helper->GetWidget(hoveredDisplayNode));
+  CHECK_INT(static_cast<int>(helper->MarkupsDisplayNodesToWidgets.size()), 0);
+
+  // A widget is created for the node that is being placed
+  vtkMRMLInteractionNode* interactionNode = applicationLogic->GetInteractionNode();
+  vtkMRMLSelectionNode* selectionNode = applicationLogic->GetSelectionNode();
+  CHECK_NOT_NULL(interactionNode);
+  CHECK_NOT_NULL(selectionNode);
+  vtkMRMLMarkupsFiducialNode* placedNode = markupsNodes[2];
+  vtkMRMLMarkupsDisplayNode* placedDisplayNode = placedNode->GetMarkupsDisplayNode();
+  selectionNode->SetReferenceActivePlaceNodeClassName("vtkMRMLMarkupsFiducialNode");
+  selectionNode->SetActivePlaceNodeID(placedNode->GetID());
+  interactionNode->SetCurrentInteractionMode(vtkMRMLInteractionNode::Place);
+  mouse.MoveTo(farPosition);
+  CHECK_BOOL(helper->IsDisplayNodeBatched(placedDisplayNode), false);
+  CHECK_NOT_NULL(helper->GetWidget(placedDisplayNode));
+  CHECK_BOOL(helper->CanBatchDisplayNode(placedDisplayNode), false);
+
+  // The node moves back into the batch after placement is finished
+  interactionNode->SetCurrentInteractionMode(vtkMRMLInteractionNode::ViewTransform);
+  mouse.MoveTo(farPosition);
+  mouse.MoveTo(farPosition);
+  CHECK_BOOL(helper->IsDisplayNodeBatched(placedDisplayNode), true);
+  CHECK_NULL(helper->GetWidget(placedDisplayNode));
+  CHECK_INT(static_cast<int>(helper->MarkupsDisplayNodesToWidgets.size()), 0);
+
+  // Negative threshold disables batching, all nodes get widgets
+  displayableManager->SetBatchedRepresentationMinimumNumberOfNodes(-1);
+  CHECK_BOOL(helper->GetBatchingEnabled(), false);
+  CHECK_INT(batchedRepresentation->GetNumberOfDisplayNodes(), 0);
+  CHECK_INT(static_cast<int>(helper->MarkupsDisplayNodesToWidgets.size()), static_cast<int>(markupsNodes.size()));
+  for (vtkMRMLMarkupsFiducialNode* markupsNode : markupsNodes)
+  {
+    CHECK_NOT_NULL(helper->GetWidget(markupsNode->GetMarkupsDisplayNode()));
+  }
+
+  // Nodes added while batching is disabled get widgets
+  markupsNodes.push_back(AddPointList(scene, 0.0, spacing));
+  CHECK_BOOL(helper->GetBatchingEnabled(), false);
+  CHECK_INT(batchedRepresentation->GetNumberOfDisplayNodes(), 0);
+  CHECK_NOT_NULL(helper->GetWidget(markupsNodes.back()->GetMarkupsDisplayNode()));
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,218 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkCurveSegmentLocator.h"
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLMarkupsClosedCurveNode.h"
+#include "vtkMRMLMarkupsCurveNode.h"
+
+// VTK includes
+#include <vtkIdList.h>
+#include <vtkLine.h>
+#include <vtkMath.h>
+#include <vtkMinimalStandardRandomSequence.h>
+#include <vtkNew.h>
+#include <vtkPlane.h>
+#include <vtkPoints.h>
+#include <vtkRegularPolygonSource.h>
+
+// Test spatial queries on curves (closest point, curve length at point, farthest point, plane intersection)
+// by comparing results to exhaustive search through all the curve segments.
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+double GetClosestPointOnCurveExhaustive(vtkPoints* points, bool closed, const double pos[3], double closestPos[3])
+{
+  vtkIdType numberOfPoints = points->GetNumberOfPoints();
+  vtkIdType numberOfSegments = closed ? numberOfPoints : numberOfPoints - 1;
+  double closestDistance2 = VTK_DOUBLE_MAX;
+  for (vtkIdType segmentIndex = 0; segmentIndex < numberOfSegments; segmentIndex++)
+  {
+    double p0[3] = { 0.0 };
+    double p1[3] = { 0.0 };
+    points->GetPoint(segmentIndex, p0);
+    points->GetPoint((segmentIndex + 1) % numberOfPoints, p1);
+    double t = 0.0;
+    double closestPosOnSegment[3] = { 0.0 };
+    double distance2 = vtkLine::DistanceToLine(pos, p0, p1, t, closestPosOnSegment);
+    if (distance2 < closestDistance2)
+    {
+      closestDistance2 = distance2;
+      closestPos[0] = closestPosOnSegment[0];
+      closestPos[1] = closestPosOnSegment[1];
+      closestPos[2] = closestPosOnSegment[2];
+    }
+  }
+  return closestDistance2;
+}
+
+//---------------------------------------------------------------------------
+int TestCurveQueries(vtkMRMLMarkupsCurveNode* curveNode)
+{
+  vtkPoints* curvePointsWorld = curveNode->GetCurvePointsWorld();
+  CHECK_NOT_NULL(curvePointsWorld);
+  vtkIdType numberOfCurvePoints = curvePointsWorld->GetNumberOfPoints();
+  bool closed = curveNode->GetCurveClosed();
+
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+  double bounds[6] = { 0.0 };
+  curvePointsWorld->GetBounds(bounds);
+  for (int testIndex = 0; testIndex < 200; testIndex++)
+  {
+    double pos[3] = { 0.0 };
+    for (int i = 0; i < 3; i++)
+    {
+      pos[i] = random->GetNextRangeValue(bounds[2 * i] - 20.0, bounds[2 * i + 1] + 20.0);
+    }
+
+    // Closest point along the curve
+    double closestPos[3] = { 0.0 };
+    vtkIdType segmentIndex = curveNode->GetClosestPointPositionAlongCurveWorld(pos, closestPos);
+    CHECK_BOOL(segmentIndex >= 0, true);
+    double expectedClosestPos[3] = { 0.0 };
+    double expectedDistance2 = GetClosestPointOnCurveExhaustive(curvePointsWorld, closed, pos, expectedClosestPos);
+    CHECK_DOUBLE_TOLERANCE(vtkMath::Distance2BetweenPoints(pos, closestPos), expectedDistance2, 1e-6);
+
+    // Curve length at the closest point
+    double closestPosFromLength[3] = { 0.0 };
+    double curveLengthAtPos = curveNode->GetCurveLengthToClosestPointPositionWorld(pos, closestPosFromLength);
+    double expectedCurveLength = curveNode->GetCurveLengthWorld(0, segmentIndex + 1)
+      + sqrt(vtkMath::Distance2BetweenPoints(curvePointsWorld->GetPoint(segmentIndex), closestPos));
+    CHECK_DOUBLE_TOLERANCE(curveLengthAtPos, expectedCurveLength, 1e-6);
+    CHECK_DOUBLE_TOLERANCE(vtkMath::Distance2BetweenPoints(closestPos, closestPosFromLength), 0.0, 1e-12);
+
+    // Farthest point
+    vtkIdType farthestPointIndex = curveNode->GetFarthestCurvePointIndexToPositionWorld(pos);
+    CHECK_INT(farthestPointIndex, vtkMRMLMarkupsCurveNode::GetFarthestCurvePointIndexToPosition(curvePointsWorld, pos));
+
+    // Plane intersection
+    double normal[3] = { random->GetNextRangeValue(-1.0, 1.0), random->GetNextRangeValue(-1.0, 1.0), random->GetNextRangeValue(-1.0, 1.0) };
+    vtkMath::Normalize(normal);
+    vtkNew<vtkPlane> plane;
+    plane->SetOrigin(pos);
+    plane->SetNormal(normal);
+    vtkNew<vtkPoints> intersectionPoints;
+    CHECK_BOOL(curveNode->GetPointsOnPlaneWorld(plane, intersectionPoints), true);
+    int expectedNumberOfIntersectionPoints = 0;
+    vtkIdType numberOfSegments = closed ? numberOfCurvePoints : numberOfCurvePoints - 1;
+    for (vtkIdType curveSegmentIndex = 0; curveSegmentIndex < numberOfSegments; curveSegmentIndex++)
+    {
+      double startDistance = plane->EvaluateFunction(curvePointsWorld->GetPoint(curveSegmentIndex));
+      double endDistance = plane->EvaluateFunction(curvePointsWorld->GetPoint((curveSegmentIndex + 1) % numberOfCurvePoints));
+      if (startDistance * endDistance < 0)
+      {
+        expectedNumberOfIntersectionPoints++;
+      }
+    }
+    CHECK_INT(intersectionPoints->GetNumberOfPoints(), expectedNumberOfIntersectionPoints);
+    for (vtkIdType pointIndex = 0; pointIndex < intersectionPoints->GetNumberOfPoints(); pointIndex++)
+    {
+      CHECK_DOUBLE_TOLERANCE(plane->EvaluateFunction(intersectionPoints->GetPoint(pointIndex)), 0.0, 1e-6);
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestCurveSegmentLocatorUpdate()
+{
+  vtkNew<vtkPoints> points;
+  for (int pointIndex = 0; pointIndex < 100; pointIndex++)
+  {
+    points->InsertNextPoint(pointIndex, 0.0, 0.0);
+  }
+  vtkNew<vtkCurveSegmentLocator> locator;
+  locator->SetPoints(points);
+  CHECK_INT(locator->GetNumberOfSegments(), 99);
+  CHECK_DOUBLE(locator->GetCurveLength(), 99.0);
+
+  double pos[3] = { 10.25, 5.0, 0.0 };
+  double closestPos[3] = { 0.0 };
+  double parametricCoordinate = 0.0;
+  double distance2 = 0.0;
+  CHECK_INT(locator->FindClosestSegment(pos, closestPos, parametricCoordinate, distance2), 10);
+  CHECK_DOUBLE_TOLERANCE(parametricCoordinate, 0.25, 1e-9);
+  CHECK_DOUBLE_TOLERANCE(distance2, 25.0, 1e-9);
+  CHECK_DOUBLE_TOLERANCE(locator->GetCurveLengthAtClosestPosition(pos), 10.25, 1e-9);
+  CHECK_INT(locator->FindFarthestPoint(pos), 99);
+
+  // Modified points must be taken into account in the next query
+  points->SetPoint(50, 10.25, 4.0, 0.0);
+  points->Modified();
+  CHECK_INT(locator->FindClosestSegment(pos, closestPos, parametricCoordinate, distance2), 49);
+  CHECK_DOUBLE_TOLERANCE(distance2, 1.0, 1e-9);
+
+  // Closing segment
+  locator->CurveClosedOn();
+  CHECK_INT(locator->GetNumberOfSegments(), 100);
+  double posNearClosingSegment[3] = { 50.0, -1.0, 0.0 };
+  CHECK_INT(locator->FindClosestSegment(posNearClosingSegment, closestPos, parametricCoordinate, distance2), 99);
+  CHECK_DOUBLE_TOLERANCE(distance2, 1.0, 1e-9);
+
+  // Plane crossing through a curve point is only reported once
+  double origin[3] = { 20.0, 0.0, 0.0 };
+  double normal[3] = { 1.0, 0.0, 0.0 };
+  vtkNew<vtkPoints> intersectionPoints;
+  vtkNew<vtkIdList> segmentIds;
+  locator->CurveClosedOff();
+  locator->IntersectWithPlane(origin, normal, intersectionPoints, segmentIds);
+  CHECK_INT(intersectionPoints->GetNumberOfPoints(), 1);
+  CHECK_INT(segmentIds->GetId(0), 19);
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//---------------------------------------------------------------------------
+int vtkMRMLMarkupsNodeTest7(int , char * [] )
+{
+  CHECK_EXIT_SUCCESS(TestCurveSegmentLocatorUpdate());
+
+  // Open curve with many curve points
+  vtkNew<vtkMRMLMarkupsCurveNode> curveNode;
+  for (int pointIndex = 0; pointIndex < 50; pointIndex++)
+  {
+    double angle = pointIndex * 0.4;
+    curveNode->AddControlPoint(vtkVector3d(30.0 * cos(angle), 30.0 * sin(angle), pointIndex * 2.0));
+  }
+  CHECK_EXIT_SUCCESS(TestCurveQueries(curveNode));
+
+  // Moving a control point must update the query results
+  curveNode->SetNthControlPointPositionWorld(0, 200.0, 0.0, 0.0);
+  double pos[3] = { 210.0, 0.0, 0.0 };
+  double closestPos[3] = { 0.0 };
+  CHECK_INT(curveNode->GetClosestPointPositionAlongCurveWorld(pos, closestPos), 0);
+  CHECK_DOUBLE_TOLERANCE(closestPos[0], 200.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(curveNode->GetCurveLengthToClosestPointPositionWorld(pos), 0.0, 1e-6);
+  CHECK_EXIT_SUCCESS(TestCurveQueries(curveNode));
+
+  // Closed curve
+  vtkNew<vtkMRMLMarkupsClosedCurveNode> closedCurveNode;
+  vtkNew<vtkRegularPolygonSource> polygonSource;
+  polygonSource->SetNumberOfSides(30);
+  polygonSource->SetRadius(15.0);
+  polygonSource->SetCenter(3.0, 4.0, 9.0);
+  polygonSource->Update();
+  closedCurveNode->SetControlPointPositionsWorld(polygonSource->GetOutput()->GetPoints());
+  CHECK_EXIT_SUCCESS(TestCurveQueries(closedCurveNode));
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,150 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkCurveMeasurementsCalculator.h"
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLMarkupsClosedCurveNode.h"
+#include "vtkMRMLMarkupsCurveNode.h"
+#include "vtkMRMLMeasurement.h"
+
+// VTK includes
+#include <vtkDoubleArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+// Test that curvature that is updated after moving control points (only the modified
+// part of the curve is recomputed) matches curvature computed for the entire curve.
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+void EnableCurvatureMeasurements(vtkMRMLMarkupsCurveNode* curveNode)
+{
+  curveNode->GetMeasurement(vtkCurveMeasurementsCalculator::GetMeanCurvatureName())->SetEnabled(true);
+  curveNode->GetMeasurement(vtkCurveMeasurementsCalculator::GetMaxCurvatureName())->SetEnabled(true);
+}
+
+//---------------------------------------------------------------------------
+int CompareCurvatureWithFullComputation(vtkMRMLMarkupsCurveNode* curveNode)
+{
+  // Reference curve computes curvature for the entire curve
+  vtkSmartPointer<vtkMRMLMarkupsCurveNode> referenceCurveNode = vtkSmartPointer<vtkMRMLMarkupsCurveNode>::Take(
+    vtkMRMLMarkupsCurveNode::SafeDownCast(curveNode->CreateNodeInstance()));
+  referenceCurveNode->SetCurveType(curveNode->GetCurveType());
+  vtkNew<vtkPoints> controlPoints;
+  curveNode->GetControlPointPositionsWorld(controlPoints);
+  referenceCurveNode->SetControlPointPositionsWorld(controlPoints);
+  EnableCurvatureMeasurements(referenceCurveNode);
+
+  vtkPolyData* curve = curveNode->GetCurveWorld();
+  vtkPolyData* referenceCurve = referenceCurveNode->GetCurveWorld();
+  CHECK_NOT_NULL(curve);
+  CHECK_NOT_NULL(referenceCurve);
+  vtkDoubleArray* curvature = vtkDoubleArray::SafeDownCast(
+    curve->GetPointData()->GetArray(vtkCurveMeasurementsCalculator::GetCurvatureArrayName()));
+  vtkDoubleArray* referenceCurvature = vtkDoubleArray::SafeDownCast(
+    referenceCurve->GetPointData()->GetArray(vtkCurveMeasurementsCalculator::GetCurvatureArrayName()));
+  CHECK_NOT_NULL(curvature);
+  CHECK_NOT_NULL(referenceCurvature);
+  CHECK_INT(curvature->GetNumberOfTuples(), referenceCurvature->GetNumberOfTuples());
+  for (vtkIdType pointIndex = 0; pointIndex < curvature->GetNumberOfTuples(); ++pointIndex)
+  {
+    CHECK_DOUBLE_TOLERANCE(curvature->GetValue(pointIndex), referenceCurvature->GetValue(pointIndex), 1e-9);
+  }
+
+  const char* measurementNames[] = { vtkCurveMeasurementsCalculator::GetMeanCurvatureName(),
+    vtkCurveMeasurementsCalculator::GetMaxCurvatureName() };
+  for (const char* measurementName : measurementNames)
+  {
+    CHECK_DOUBLE_TOLERANCE(curveNode->GetMeasurement(measurementName)->GetValue(),
+      referenceCurveNode->GetMeasurement(measurementName)->GetValue(), 1e-9);
+  }
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestMoveControlPoints(vtkMRMLMarkupsCurveNode* curveNode)
+{
+  // Long helix
+  const int numberOfControlPoints = 200;
+  for (int pointIndex = 0; pointIndex < numberOfControlPoints; ++pointIndex)
+  {
+    double angle = pointIndex * 0.3;
+    curveNode->AddControlPoint(vtkVector3d(30.0 * cos(angle), 30.0 * sin(angle), pointIndex * 2.0));
+  }
+  EnableCurvatureMeasurements(curveNode);
+  CHECK_EXIT_SUCCESS(CompareCurvatureWithFullComputation(curveNode));
+
+  // Move a single control point in the middle, near the start, and near the end of the curve
+  const int movedControlPointIndices[] = { 100, 1, numberOfControlPoints - 1, 100 };
+  for (int movedControlPointIndex : movedControlPointIndices)
+  {
+    double position[3] = { 0.0, 0.0, 0.0 };
+    curveNode->GetNthControlPointPositionWorld(movedControlPointIndex, position);
+    curveNode->SetNthControlPointPositionWorld(movedControlPointIndex, position[0] + 15.0, position[1] - 10.0, position[2] + 5.0);
+    CHECK_EXIT_SUCCESS(CompareCurvatureWithFullComputation(curveNode));
+  }
+
+  // Sharp corner that has the maximum curvature is moved back
+  double position[3] = { 0.0, 0.0, 0.0 };
+  curveNode->GetNthControlPointPositionWorld(50, position);
+  curveNode->SetNthControlPointPositionWorld(50, position[0] + 100.0, position[1], position[2]);
+  CHECK_EXIT_SUCCESS(CompareCurvatureWithFullComputation(curveNode));
+  curveNode->SetNthControlPointPositionWorld(50, position);
+  CHECK_EXIT_SUCCESS(CompareCurvatureWithFullComputation(curveNode));
+
+  // Many small edits, running statistics must not drift
+  for (int editIndex = 0; editIndex < 100; ++editIndex)
+  {
+    int controlPointIndex = 20 + editIndex;
+    curveNode->GetNthControlPointPositionWorld(controlPointIndex, position);
+    curveNode->SetNthControlPointPositionWorld(controlPointIndex, position[0] + 0.5, position[1], position[2]);
+    curveNode->GetCurveWorld();
+  }
+  CHECK_EXIT_SUCCESS(CompareCurvatureWithFullComputation(curveNode));
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkMRMLMarkupsNodeTest8(int , char * [] )
+{
+  vtkNew<vtkMRMLMarkupsCurveNode> kochanekCurveNode;
+  kochanekCurveNode->SetCurveTypeToKochanekSpline();
+  CHECK_EXIT_SUCCESS(TestMoveControlPoints(kochanekCurveNode));
+
+  vtkNew<vtkMRMLMarkupsCurveNode> linearCurveNode;
+  linearCurveNode->SetCurveTypeToLinear();
+  CHECK_EXIT_SUCCESS(TestMoveControlPoints(linearCurveNode));
+
+  // Cardinal spline and closed curves use full comparison of curve points
+  vtkNew<vtkMRMLMarkupsCurveNode> cardinalCurveNode;
+  cardinalCurveNode->SetCurveTypeToCardinalSpline();
+  CHECK_EXIT_SUCCESS(TestMoveControlPoints(cardinalCurveNode));
+
+  vtkNew<vtkMRMLMarkupsClosedCurveNode> closedCurveNode;
+  closedCurveNode->SetCurveTypeToKochanekSpline();
+  CHECK_EXIT_SUCCESS(TestMoveControlPoints(closedCurveNode));
+
+  return EXIT_SUCCESS;
+}
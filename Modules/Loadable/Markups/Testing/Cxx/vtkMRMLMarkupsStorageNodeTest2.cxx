@@ -262,6 +262,68 @@ int TestStoragNode(vtkMRMLMarkupsNode* markupsNode, vtkMRMLMarkupsStorageNode* s
   return EXIT_SUCCESS;
 }
 
+int TestBinaryControlPointCoordinates(const std::string& fileName)
+{
+  std::cout << "--------------------------------" << std::endl;
+  std::cout << "TestBinaryControlPointCoordinates" << std::endl;
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLApplicationLogic> applicationLogic;
+  applicationLogic->SetMRMLScene(scene);
+
+  vtkNew<vtkMRMLMarkupsCurveNode> markupsNode;
+  scene->AddNode(markupsNode);
+  const int numberOfControlPoints = 1000;
+  for (int i = 0; i < numberOfControlPoints; ++i)
+  {
+    // use values that cannot be represented exactly in text
+    vtkVector3d position(i / 3.0, -i / 7.0, i * 1.1);
+    markupsNode->AddControlPoint(position, std::to_string(i));
+  }
+  double orientationWXYZ[4] = { 30.0, 0.0, 0.0, 1.0 };
+  markupsNode->SetNthControlPointOrientation(2, orientationWXYZ);
+  markupsNode->UnsetNthControlPointPosition(3);
+
+  vtkNew<vtkMRMLMarkupsJsonStorageNode> storageNode;
+  scene->AddNode(storageNode);
+  storageNode->BinaryControlPointCoordinatesOn();
+  storageNode->SetFileName(fileName.c_str());
+  CHECK_BOOL(storageNode->WriteData(markupsNode), true);
+
+  vtkNew<vtkMRMLMarkupsCurveNode> markupsNode2;
+  scene->AddNode(markupsNode2);
+  vtkNew<vtkMRMLMarkupsJsonStorageNode> storageNode2;
+  scene->AddNode(storageNode2);
+  storageNode2->SetFileName(fileName.c_str());
+  CHECK_BOOL(storageNode2->ReadData(markupsNode2), true);
+
+  CHECK_INT(markupsNode2->GetNumberOfControlPoints(), numberOfControlPoints);
+  for (int i = 0; i < numberOfControlPoints; ++i)
+  {
+    if (i == 3)
+    {
+      CHECK_INT(markupsNode2->GetNthControlPointPositionStatus(i), vtkMRMLMarkupsNode::PositionUndefined);
+      continue;
+    }
+    // binary encoding must preserve values exactly
+    vtkVector3d position = markupsNode->GetNthControlPointPositionVector(i);
+    vtkVector3d position2 = markupsNode2->GetNthControlPointPositionVector(i);
+    for (int c = 0; c < 3; ++c)
+    {
+      CHECK_DOUBLE(position2[c], position[c]);
+    }
+    CHECK_STD_STRING(markupsNode2->GetNthControlPointLabel(i), std::to_string(i));
+  }
+  double* orientationMatrix = markupsNode->GetNthControlPointOrientationMatrix(2);
+  double* orientationMatrix2 = markupsNode2->GetNthControlPointOrientationMatrix(2);
+  for (int c = 0; c < 9; ++c)
+  {
+    CHECK_DOUBLE_TOLERANCE(orientationMatrix2[c], orientationMatrix[c], 1e-12);
+  }
+
+  return EXIT_SUCCESS;
+}
+
 int vtkMRMLMarkupsStorageNodeTest2(int argc, char* argv[])
 {
   vtkNew<vtkMRMLMarkupsFiducialStorageNode> storageNodeFcsv;
@@ -300,6 +362,7 @@ int vtkMRMLMarkupsStorageNodeTest2(int argc, char* argv[])
   CHECK_EXIT_SUCCESS(TestStoragNode(
     vtkSmartPointer<vtkMRMLMarkupsROINode>::New(),
     vtkSmartPointer<vtkMRMLMarkupsROIJsonStorageNode>::New(), tempFolder + "/vtkMRMLMarkupsStorageNodeTest2-roi-temp.mrk.json"));
+  CHECK_EXIT_SUCCESS(TestBinaryControlPointCoordinates(tempFolder + "/vtkMRMLMarkupsStorageNodeTest2-binary-temp.mrk.json"));
 
   // Test if markups node can be instantiated correctly
   vtkNew<vtkMRMLScene> scene;
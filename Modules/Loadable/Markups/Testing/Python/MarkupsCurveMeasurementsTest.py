@@ -1,6 +1,7 @@
 from slicer.util import TESTING_DATA_URL
 import os
 import numpy as np
+from vtk.util.numpy_support import vtk_to_numpy
 
 
 def verifyArrays(pointData, arrayNames):
@@ -220,6 +221,28 @@ if abs(closedCurveNode.GetMeasurement("curvature max").GetValue() - 1 / radius)
     exceptionMessage = "Unexpected curvature max value: " + str(closedCurveNode.GetMeasurement("curvature max").GetValue())
     raise Exception(exceptionMessage)
 
+# Move a single control point: curvature is only recomputed near the moved point,
+# the result must match the curvature computed for the entire curve.
+closedCurveNode.SetNthControlPointPosition(5, 1.2 * radius * math.sin(2.0 * math.pi * 5 / numberOfControlPoints),
+                                           1.2 * radius * math.cos(2.0 * math.pi * 5 / numberOfControlPoints), 3.0)
+updatedCurvatureArray = closedCurveNode.GetCurveWorld().GetPointData().GetArray("Curvature")
+referenceCurveNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLMarkupsClosedCurveNode")
+referenceControlPoints = vtk.vtkPoints()
+closedCurveNode.GetControlPointPositionsWorld(referenceControlPoints)
+referenceCurveNode.SetControlPointPositionsWorld(referenceControlPoints)
+referenceCurveNode.GetMeasurement("curvature mean").SetEnabled(True)
+referenceCurveNode.GetMeasurement("curvature max").SetEnabled(True)
+referenceCurvatureArray = referenceCurveNode.GetCurveWorld().GetPointData().GetArray("Curvature")
+if not np.allclose(vtk_to_numpy(updatedCurvatureArray), vtk_to_numpy(referenceCurvatureArray)):
+    raise Exception("Curvature values after moving a control point do not match full curvature computation")
+if abs(closedCurveNode.GetMeasurement("curvature mean").GetValue() - referenceCurveNode.GetMeasurement("curvature mean").GetValue()) > 1e-8:
+    raise Exception("Curvature mean value after moving a control point does not match full curvature computation")
+slicer.mrmlScene.RemoveNode(referenceCurveNode)
+
+# Restore original control point position
+closedCurveNode.SetNthControlPointPosition(5, radius * math.sin(2.0 * math.pi * 5 / numberOfControlPoints),
+                                           radius * math.cos(2.0 * math.pi * 5 / numberOfControlPoints), 0.0)
+
 # Check length and area
 
 closedCurveNode.GetMeasurement("length").SetEnabled(True)
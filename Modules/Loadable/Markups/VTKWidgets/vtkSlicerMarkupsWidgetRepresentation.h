@@ -148,13 +148,13 @@ public:
   bool IsDisplayable();
   //@}
 
+  /// Convert glyph types from display node enums to 2D glyph source enums
+  static int GetGlyphTypeSourceFromDisplay(int glyphTypeDisplay);
+
 protected:
   vtkSlicerMarkupsWidgetRepresentation();
   ~vtkSlicerMarkupsWidgetRepresentation() override;
 
-  // Convert glyph types from display node enums to 2D glyph source enums
-  static int GetGlyphTypeSourceFromDisplay(int glyphTypeDisplay);
-
   class ControlPointsPipeline
   {
   public:
@@ -347,6 +347,34 @@ vtkMRMLModelNode* vtkSlicerModelsLogic::AddModel(const char* filename,
   return modelNode;
 }
 
+//----------------------------------------------------------------------------
+vtkMRMLModelNode* vtkSlicerModelsLogic::AddPreloadedModel(vtkMRMLModelNode* modelNode,
+  vtkMRMLModelStorageNode* storageNode)
+{
+  if (this->GetMRMLScene() == nullptr || modelNode == nullptr || storageNode == nullptr
+    || storageNode->GetFileName() == nullptr)
+  {
+    vtkErrorMacro("AddPreloadedModel: invalid scene, model node, or storage node");
+    return nullptr;
+  }
+  std::string baseName = storageNode->GetFileNameWithoutExtension(storageNode->GetFileName());
+  std::string uniqueName(this->GetMRMLScene()->GetUniqueNameByString(baseName.c_str()));
+  modelNode->SetName(uniqueName.c_str());
+  if (!this->GetMRMLScene()->AddNode(modelNode))
+  {
+    return nullptr;
+  }
+
+  // Associate with storage node
+  this->GetMRMLScene()->AddNode(storageNode);
+  modelNode->SetAndObserveStorageNodeID(storageNode->GetID());
+
+  // Add display node
+  modelNode->CreateDefaultDisplayNodes();
+
+  return modelNode;
+}
+
 //----------------------------------------------------------------------------
 int vtkSlicerModelsLogic::SaveModel (const char* filename, vtkMRMLModelNode *modelNode,
   int coordinateSystem/*=-1*/, vtkMRMLMessageCollection* userMessages/*=nullptr*/)
@@ -27,6 +27,7 @@
 
 class vtkMRMLMessageCollection;
 class vtkMRMLModelNode;
+class vtkMRMLModelStorageNode;
 class vtkMRMLStorageNode;
 class vtkMRMLTransformNode;
 class vtkAlgorithmOutput;
@@ -62,6 +63,12 @@ class VTK_SLICER_MODELS_MODULE_LOGIC_EXPORT vtkSlicerModelsLogic
   vtkMRMLModelNode* AddModel(const char* filename, int coordinateSystem = vtkMRMLStorageNode::CoordinateSystemLPS,
     vtkMRMLMessageCollection* userMessages = nullptr);
 
+  /// Add into the scene a model node that is not in the scene yet and whose
+  /// mesh has already been read by \a storageNode (for example, in a worker thread).
+  /// The storage node and a display node are also added into the scene.
+  /// The model node name is generated from the file name.
+  vtkMRMLModelNode* AddPreloadedModel(vtkMRMLModelNode* modelNode, vtkMRMLModelStorageNode* storageNode);
+
   /// Create model nodes and
   /// read their polydata from a specified directory
   /// \param coordinateSystem If coordinate system is not specified
@@ -35,9 +35,12 @@
 #include "vtkMRMLDisplayNode.h"
 #include "vtkMRMLMessageCollection.h"
 #include "vtkMRMLModelNode.h"
+#include "vtkMRMLModelStorageNode.h"
 #include <vtkMRMLScene.h>
 
 // VTK includes
+#include <vtkCollection.h>
+#include <vtkNew.h>
 #include <vtkSmartPointer.h>
 
 //-----------------------------------------------------------------------------
@@ -155,6 +158,78 @@ bool qSlicerModelsReader::load(const IOProperties& properties)
     // errors are already logged and userMessages contain details that can be displayed to users
     return false;
   }
+  this->finalizeLoad(node, properties);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerModelsReader::canPreload(const IOProperties& properties)const
+{
+  QString fileName = properties.value("fileName").toString();
+  // Remote files are downloaded by the cache manager of the scene
+  return !fileName.isEmpty() && !fileName.contains("://");
+}
+
+//-----------------------------------------------------------------------------
+vtkSmartPointer<vtkObject> qSlicerModelsReader::preload(const IOProperties& properties,
+  vtkMRMLMessageCollection* userMessages)const
+{
+  QString fileName = properties.value("fileName").toString();
+  int coordinateSystem = vtkMRMLStorageNode::CoordinateSystemLPS; // default
+  if (properties.contains("coordinateSystem"))
+  {
+    coordinateSystem = properties["coordinateSystem"].toInt();
+  }
+
+  // Nodes are not in the scene, therefore they can be used in a worker thread
+  vtkNew<vtkMRMLModelStorageNode> storageNode;
+  storageNode->SetFileName(fileName.toUtf8());
+  storageNode->SetCoordinateSystem(coordinateSystem);
+  if (!storageNode->SupportedFileType(fileName.toUtf8()))
+  {
+    vtkErrorToMessageCollectionWithObjectMacro(storageNode, userMessages, "qSlicerModelsReader::preload",
+      "Could not find a suitable storage node for file '" << fileName.toStdString() << "'.");
+    return nullptr;
+  }
+  vtkNew<vtkMRMLModelNode> modelNode;
+  if (!storageNode->ReadData(modelNode))
+  {
+    if (userMessages)
+    {
+      userMessages->AddMessages(storageNode->GetUserMessages());
+    }
+    return nullptr;
+  }
+  vtkSmartPointer<vtkCollection> preloadedNodes = vtkSmartPointer<vtkCollection>::New();
+  preloadedNodes->AddItem(modelNode);
+  preloadedNodes->AddItem(storageNode);
+  return preloadedNodes;
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerModelsReader::loadPreloaded(const IOProperties& properties, vtkObject* preloadedData)
+{
+  Q_D(qSlicerModelsReader);
+  this->setLoadedNodes(QStringList());
+  vtkCollection* preloadedNodes = vtkCollection::SafeDownCast(preloadedData);
+  if (!d->ModelsLogic || !preloadedNodes)
+  {
+    return this->load(properties);
+  }
+  vtkMRMLModelNode* node = d->ModelsLogic->AddPreloadedModel(
+    vtkMRMLModelNode::SafeDownCast(preloadedNodes->GetItemAsObject(0)),
+    vtkMRMLModelStorageNode::SafeDownCast(preloadedNodes->GetItemAsObject(1)));
+  if (!node)
+  {
+    return false;
+  }
+  this->finalizeLoad(node, properties);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerModelsReader::finalizeLoad(vtkMRMLModelNode* node, const IOProperties& properties)
+{
   this->setLoadedNodes( QStringList(QString(node->GetID())) );
   if (properties.contains("name"))
   {
@@ -187,6 +262,4 @@ bool qSlicerModelsReader::load(const IOProperties& properties)
       app->layoutManager()->resetThreeDViews();
     }
   }
-
-  return true;
 }
@@ -26,6 +26,7 @@
 class qSlicerModelsReaderPrivate;
 
 // Slicer includes
+class vtkMRMLModelNode;
 class vtkSlicerModelsLogic;
 
 //-----------------------------------------------------------------------------
@@ -54,6 +55,16 @@ public:
 
   bool load(const IOProperties& properties) override;
 
+  /// Local model files can be read in a worker thread.
+  bool canPreload(const IOProperties& properties)const override;
+  vtkSmartPointer<vtkObject> preload(const IOProperties& properties,
+    vtkMRMLMessageCollection* userMessages)const override;
+  bool loadPreloaded(const IOProperties& properties, vtkObject* preloadedData) override;
+
+protected:
+  /// Set loaded nodes, apply node name, and reset 3D views if this is the only displayed node.
+  void finalizeLoad(vtkMRMLModelNode* node, const IOProperties& properties);
+
 protected:
   QScopedPointer<qSlicerModelsReaderPrivate> d_ptr;
 
@@ -200,6 +200,8 @@ class SegmentEditorHollowEffect(AbstractScriptedSegmentEditorEffect):
         margin = vtkITK.vtkITKImageMargin()
         margin.SetInputConnection(thresh.GetOutputPort())
         margin.CalculateMarginInMMOn()
+        # Only compute distances near the segment, output extent is limited to the shell
+        margin.NarrowBandOn()
 
         spacing = selectedSegmentLabelmap.GetSpacing()
         voxelDiameter = min(selectedSegmentLabelmap.GetSpacing())
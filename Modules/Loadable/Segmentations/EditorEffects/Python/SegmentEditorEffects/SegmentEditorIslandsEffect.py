@@ -156,12 +156,6 @@ about each operation, hover the mouse over the option and wait for the tooltip t
         islandMath.SetMinimumSize(minimumSize)
         islandMath.Update()
 
-        islandImage = slicer.vtkOrientedImageData()
-        islandImage.ShallowCopy(islandMath.GetOutput())
-        selectedSegmentLabelmapImageToWorldMatrix = vtk.vtkMatrix4x4()
-        selectedSegmentLabelmap.GetImageToWorldMatrix(selectedSegmentLabelmapImageToWorldMatrix)
-        islandImage.SetImageToWorldMatrix(selectedSegmentLabelmapImageToWorldMatrix)
-
         islandCount = islandMath.GetNumberOfIslands()
         islandOrigCount = islandMath.GetOriginalNumberOfIslands()
         ignoredIslands = islandOrigCount - islandCount
@@ -177,9 +171,6 @@ about each operation, hover the mouse over the option and wait for the tooltip t
             if selectedSegmentName is not None and selectedSegmentName != "":
                 baseSegmentName = selectedSegmentName
 
-            labelValues = vtk.vtkIntArray()
-            slicer.vtkSlicerSegmentationsModuleLogic.GetAllLabelValues(labelValues, islandImage)
-
             # Erase segment from in original labelmap.
             # Individual islands will be added back later.
             threshold = vtk.vtkImageThreshold()
@@ -194,13 +185,14 @@ about each operation, hover the mouse over the option and wait for the tooltip t
             self.scriptedEffect.modifySegmentByLabelmap(segmentationNode, selectedSegmentID, emptyLabelmap,
                                                         slicer.qSlicerSegmentEditorAbstractEffect.ModificationModeSet)
 
-            for i in range(labelValues.GetNumberOfTuples()):
+            # Island label values are 1, 2, ... islandCount (sorted by size)
+            for i in range(islandCount):
                 if maxNumberOfSegments > 0 and i >= maxNumberOfSegments:
                     # We only care about the segments up to maxNumberOfSegments.
                     # If we do not want to split segments, we only care about the first.
                     break
 
-                labelValue = int(labelValues.GetTuple1(i))
+                labelValue = i + 1
                 segment = selectedSegment
                 segmentID = selectedSegmentID
                 if i != 0 and split:
@@ -226,7 +218,13 @@ about each operation, hover the mouse over the option and wait for the tooltip t
                     threshold.ThresholdBetween(labelValue, labelValue)
                     threshold.SetInValue(1)
                     threshold.SetOutValue(0)
-                threshold.Update()
+                if not split and maxNumberOfSegments <= 0:
+                    threshold.Update()
+                else:
+                    # only process the bounding box of the island
+                    islandExtent = [0, -1, 0, -1, 0, -1]
+                    islandMath.GetIslandExtent(i, islandExtent)
+                    threshold.UpdateExtent(islandExtent)
 
                 modificationMode = slicer.qSlicerSegmentEditorAbstractEffect.ModificationModeAdd
                 if i == 0:
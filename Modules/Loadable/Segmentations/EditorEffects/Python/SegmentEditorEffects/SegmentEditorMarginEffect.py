@@ -165,6 +165,29 @@ class SegmentEditorMarginEffect(AbstractScriptedSegmentEditorEffect):
         slicer.util.showStatusMessage(msg, timeoutMsec)
         slicer.app.processEvents()
 
+    def clipToEffectiveExtent(self, labelmap):
+        """Clip labelmap to the extent of its non-zero voxels, padded by one voxel
+        (so that the segment boundary can be determined). Returns the input if it is empty.
+        """
+        import vtkSegmentationCorePython as vtkSegmentationCore
+
+        effectiveExtent = [0, -1, 0, -1, 0, -1]
+        if not vtkSegmentationCore.vtkOrientedImageDataResample.CalculateEffectiveExtent(labelmap, effectiveExtent, 0):
+            return labelmap
+        if effectiveExtent[0] > effectiveExtent[1] or effectiveExtent[2] > effectiveExtent[3] or effectiveExtent[4] > effectiveExtent[5]:
+            return labelmap
+        clipper = vtk.vtkImageClip()
+        clipper.SetOutputWholeExtent(effectiveExtent[0] - 1, effectiveExtent[1] + 1,
+                                     effectiveExtent[2] - 1, effectiveExtent[3] + 1,
+                                     effectiveExtent[4] - 1, effectiveExtent[5] + 1)
+        clipper.SetInputData(labelmap)
+        clipper.SetClipData(True)
+        clipper.Update()
+        clippedLabelmap = slicer.vtkOrientedImageData()
+        clippedLabelmap.ShallowCopy(clipper.GetOutput())
+        clippedLabelmap.CopyDirections(labelmap)
+        return clippedLabelmap
+
     def processMargin(self):
         # Get modifier labelmap and parameters
         modifierLabelmap = self.scriptedEffect.defaultModifierLabelmap()
@@ -172,6 +195,10 @@ class SegmentEditorMarginEffect(AbstractScriptedSegmentEditorEffect):
 
         marginSizeMM = self.scriptedEffect.doubleParameter("MarginSizeMm")
 
+        if marginSizeMM < 0:
+            # Shrinking only removes voxels from the segment, therefore it is enough to process the segment's extent
+            selectedSegmentLabelmap = self.clipToEffectiveExtent(selectedSegmentLabelmap)
+
         # We need to know exactly the value of the segment voxels, apply threshold to make force the selected label value
         labelValue = 1
         backgroundValue = 0
@@ -194,6 +221,9 @@ class SegmentEditorMarginEffect(AbstractScriptedSegmentEditorEffect):
         margin.SetInputConnection(thresh.GetOutputPort())
         margin.CalculateMarginInMMOn()
         margin.SetOuterMarginMM(abs(marginSizeMM))
+        if marginSizeMM >= 0:
+            # Only compute distances near the segment, output extent is limited to the grown segment
+            margin.NarrowBandOn()
         margin.Update()
 
         if marginSizeMM >= 0:
@@ -25,6 +25,7 @@
 #include "vtkMRMLSegmentationDisplayNode.h"
 #include "vtkMRMLSegmentationsDisplayableManager2D.h"
 #include "vtkMRMLSegmentEditorNode.h"
+#include "vtkBrushStrokeRasterizer.h"
 #include "vtkOrientedImageData.h"
 
 // Qt includes
@@ -49,10 +50,6 @@
 #include <vtkGlyph2D.h>
 #include <vtkGlyph3D.h>
 #include <vtkIdList.h>
-#include <vtkImageChangeInformation.h>
-#include <vtkImageStencil.h>
-#include <vtkImageStencilData.h>
-#include <vtkImageStencilToImage.h>
 #include <vtkMath.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
@@ -63,7 +60,6 @@
 #include <vtkPolyDataMapper.h>
 #include <vtkPolyDataMapper2D.h>
 #include <vtkPolyDataNormals.h>
-#include <vtkPolyDataToImageStencil.h>
 #include <vtkProperty2D.h>
 #include <vtkProperty.h>
 #include <vtkPropPicker.h>
@@ -245,6 +241,7 @@ qSlicerSegmentEditorPaintEffectPrivate::qSlicerSegmentEditorPaintEffectPrivate(q
   , BrushPixelModeCheckbox(nullptr)
 {
   this->PaintCoordinates_World = vtkSmartPointer<vtkPoints>::New();
+  this->PaintStrokeStartPointIds = vtkSmartPointer<vtkIdList>::New();
   this->FeedbackPointsPolyData = vtkSmartPointer<vtkPolyData>::New();
   this->FeedbackPointsPolyData->SetPoints(this->PaintCoordinates_World);
 
@@ -264,13 +261,7 @@ qSlicerSegmentEditorPaintEffectPrivate::qSlicerSegmentEditorPaintEffectPrivate(q
   this->WorldOriginToWorldTransformer->SetTransform(this->WorldOriginToWorldTransform);
   this->WorldOriginToWorldTransformer->SetInputConnection(this->BrushPolyDataNormals->GetOutputPort());
 
-  this->WorldOriginToModifierLabelmapIjkTransformer = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
-  this->WorldOriginToModifierLabelmapIjkTransform = vtkSmartPointer<vtkTransform>::New();
-  this->WorldOriginToModifierLabelmapIjkTransformer->SetTransform(this->WorldOriginToModifierLabelmapIjkTransform);
-  this->WorldOriginToModifierLabelmapIjkTransformer->SetInputConnection(this->BrushPolyDataNormals->GetOutputPort());
-  this->BrushPolyDataToStencil = vtkSmartPointer<vtkPolyDataToImageStencil>::New();
-  this->BrushPolyDataToStencil->SetOutputSpacing(1.0,1.0,1.0);
-  this->BrushPolyDataToStencil->SetInputConnection(this->WorldOriginToModifierLabelmapIjkTransformer->GetOutputPort());
+  this->BrushStrokeRasterizer = vtkSmartPointer<vtkBrushStrokeRasterizer>::New();
 
   this->FeedbackGlyphFilter = vtkSmartPointer<vtkGlyph3D>::New();
   this->FeedbackGlyphFilter->SetInputData(this->FeedbackPointsPolyData);
@@ -358,6 +349,11 @@ void qSlicerSegmentEditorPaintEffectPrivate::paintAddPoint(qMRMLWidget* viewWidg
       }
     }
   }
+  else
+  {
+    // this point is not connected to the previous point
+    this->PaintStrokeStartPointIds->InsertNextId(this->PaintCoordinates_World->GetNumberOfPoints());
+  }
   this->PaintCoordinates_World->InsertNextPoint(brushPosition_World);
   this->PaintCoordinates_World->Modified();
 
@@ -369,55 +365,68 @@ void qSlicerSegmentEditorPaintEffectPrivate::paintAddPoint(qMRMLWidget* viewWidg
 }
 
 //-----------------------------------------------------------------------------
-void qSlicerSegmentEditorPaintEffectPrivate::updateBrushStencil(qMRMLWidget* viewWidget)
+bool qSlicerSegmentEditorPaintEffectPrivate::updateBrushStrokeRasterizer(vtkOrientedImageData* labelmap, qMRMLWidget* viewWidget)
 {
   Q_Q(qSlicerSegmentEditorPaintEffect);
-  Q_UNUSED(viewWidget);
 
   if (!q->parameterSetNode())
   {
     qCritical() << Q_FUNC_INFO << ": Invalid segment editor parameter set node!";
-    return;
+    return false;
   }
   vtkMRMLSegmentationNode* segmentationNode = q->parameterSetNode()->GetSegmentationNode();
   if (!segmentationNode)
   {
     qCritical() << Q_FUNC_INFO << ": Invalid segmentationNode";
-    return;
+    return false;
   }
-  vtkOrientedImageData* modifierLabelmap = q->modifierLabelmap();
-  if (!modifierLabelmap)
+  if (!labelmap)
   {
-    qCritical() << Q_FUNC_INFO << ": Invalid modifierLabelmap";
-    return;
+    qCritical() << Q_FUNC_INFO << ": Invalid labelmap";
+    return false;
+  }
+
+  // Brush shape (same as in updateBrushModel)
+
+  double diameterMm = q->doubleParameter("BrushAbsoluteDiameter");
+  this->BrushStrokeRasterizer->SetRadius(diameterMm / 2.0);
+  this->BrushStrokeRasterizer->SetFillValue(q->m_FillValue);
+
+  vtkNew<vtkMatrix4x4> brushToWorldOriginTransformMatrix;
+  qMRMLSliceWidget* sliceWidget = qobject_cast<qMRMLSliceWidget*>(viewWidget);
+  if (!sliceWidget || q->integerParameter("BrushSphere"))
+  {
+    this->BrushStrokeRasterizer->SetBrushShapeToSphere();
+  }
+  else
+  {
+    this->BrushStrokeRasterizer->SetBrushShapeToDisk();
+    this->BrushStrokeRasterizer->SetDiskHeight(qSlicerSegmentEditorAbstractEffect::sliceSpacing(sliceWidget));
+    // disk axis is the slice normal
+    brushToWorldOriginTransformMatrix->DeepCopy(sliceWidget->sliceLogic()->GetSliceNode()->GetSliceToRAS());
+    brushToWorldOriginTransformMatrix->SetElement(0,3, 0);
+    brushToWorldOriginTransformMatrix->SetElement(1,3, 0);
+    brushToWorldOriginTransformMatrix->SetElement(2,3, 0);
   }
 
-  // Brush stencil transform
+  // Brush to labelmap IJK transform (only the linear part is used by the rasterizer)
 
-  this->WorldOriginToModifierLabelmapIjkTransform->Identity();
+  vtkNew<vtkTransform> brushToLabelmapIjkTransform;
 
   vtkNew<vtkMatrix4x4> segmentationToSegmentationIjkTransformMatrix;
-  modifierLabelmap->GetImageToWorldMatrix(segmentationToSegmentationIjkTransformMatrix.GetPointer());
-  segmentationToSegmentationIjkTransformMatrix->Invert();
-  segmentationToSegmentationIjkTransformMatrix->SetElement(0,3, 0);
-  segmentationToSegmentationIjkTransformMatrix->SetElement(1,3, 0);
-  segmentationToSegmentationIjkTransformMatrix->SetElement(2,3, 0);
-  this->WorldOriginToModifierLabelmapIjkTransform->Concatenate(segmentationToSegmentationIjkTransformMatrix.GetPointer());
+  labelmap->GetWorldToImageMatrix(segmentationToSegmentationIjkTransformMatrix.GetPointer());
+  brushToLabelmapIjkTransform->Concatenate(segmentationToSegmentationIjkTransformMatrix.GetPointer());
 
   vtkNew<vtkMatrix4x4> worldToSegmentationTransformMatrix;
   // We don't support painting in non-linearly transformed node (it could be implemented, but would probably slow down things too much)
   // TODO: show a meaningful error message to the user if attempted
   vtkMRMLTransformNode::GetMatrixTransformBetweenNodes(nullptr, segmentationNode->GetParentTransformNode(), worldToSegmentationTransformMatrix.GetPointer());
-  worldToSegmentationTransformMatrix->SetElement(0,3, 0);
-  worldToSegmentationTransformMatrix->SetElement(1,3, 0);
-  worldToSegmentationTransformMatrix->SetElement(2,3, 0);
-  this->WorldOriginToModifierLabelmapIjkTransform->Concatenate(worldToSegmentationTransformMatrix.GetPointer());
-
-  this->WorldOriginToModifierLabelmapIjkTransformer->Update();
-  vtkPolyData* brushModel_ModifierLabelmapIjk = this->WorldOriginToModifierLabelmapIjkTransformer->GetOutput();
-  double* boundsIjk = brushModel_ModifierLabelmapIjk->GetBounds();
-  this->BrushPolyDataToStencil->SetOutputWholeExtent(floor(boundsIjk[0])-1, ceil(boundsIjk[1])+1,
-    floor(boundsIjk[2])-1, ceil(boundsIjk[3])+1, floor(boundsIjk[4])-1, ceil(boundsIjk[5])+1);
+  brushToLabelmapIjkTransform->Concatenate(worldToSegmentationTransformMatrix.GetPointer());
+
+  brushToLabelmapIjkTransform->Concatenate(brushToWorldOriginTransformMatrix.GetPointer());
+
+  this->BrushStrokeRasterizer->SetBrushToImageIjkMatrix(brushToLabelmapIjkTransform->GetMatrix());
+  return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -526,8 +535,6 @@ void qSlicerSegmentEditorPaintEffectPrivate::paintBrushes(
   Q_UNUSED(pixelPositions_World);
   Q_Q(qSlicerSegmentEditorPaintEffect);
 
-  this->updateBrushStencil(viewWidget);
-
   if (!modifierLabelmap)
   {
     return;
@@ -540,55 +547,28 @@ void qSlicerSegmentEditorPaintEffectPrivate::paintBrushes(
     return;
   }
 
-  this->BrushPolyDataToStencil->Update();
-  vtkImageStencilData* stencilData = this->BrushPolyDataToStencil->GetOutput();
-  int stencilExtent[6]={0,-1,0,-1,0,-1};
-  stencilData->GetExtent(stencilExtent);
+  if (!this->updateBrushStrokeRasterizer(modifierLabelmap, viewWidget))
+  {
+    return;
+  }
 
   vtkNew<vtkPoints> paintCoordinates_Ijk;
   this->transformPointsFromWorldToIJK(modifierLabelmap, segmentationNode, this->PaintCoordinates_World, paintCoordinates_Ijk);
 
-  vtkNew<vtkImageStencilToImage> stencilToImage;
-  stencilToImage->SetInputConnection(this->BrushPolyDataToStencil->GetOutputPort());
-  stencilToImage->SetInsideValue(q->m_FillValue);
-  stencilToImage->SetOutsideValue(q->m_EraseValue);
-  stencilToImage->SetOutputScalarType(modifierLabelmap->GetScalarType());
-
-  vtkNew<vtkImageChangeInformation> brushPositioner;
-  brushPositioner->SetInputConnection(stencilToImage->GetOutputPort());
-  brushPositioner->SetOutputSpacing(modifierLabelmap->GetSpacing());
-  brushPositioner->SetOutputOrigin(modifierLabelmap->GetOrigin());
-
-  vtkIdType numberOfPoints = this->PaintCoordinates_World->GetNumberOfPoints();
-  for (int pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+  // The brush is swept along the stroke and written directly into the labelmap
+  // (instead of stamping a rasterized brush image at each point).
+  int modifiedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (!this->BrushStrokeRasterizer->PaintStroke(modifierLabelmap, paintCoordinates_Ijk, this->PaintStrokeStartPointIds, modifiedExtent))
   {
-    double* shiftDouble = paintCoordinates_Ijk->GetPoint(pointIndex);
-    int shift[3] = {vtkMath::Round(shiftDouble[0]), vtkMath::Round(shiftDouble[1]), vtkMath::Round(shiftDouble[2])};
-    brushPositioner->SetExtentTranslation(shift);
-    brushPositioner->Update();
-    vtkNew<vtkOrientedImageData> orientedBrushPositionerOutput;
-    orientedBrushPositionerOutput->ShallowCopy(brushPositioner->GetOutput());
-    orientedBrushPositionerOutput->CopyDirections(modifierLabelmap);
-    if (pointIndex == 0)
-    {
-      orientedBrushPositionerOutput->GetExtent(updateExtent);
-    }
-    else
+    qCritical() << Q_FUNC_INFO << ": Failed to paint brush stroke";
+    return;
+  }
+  if (updateExtent && paintCoordinates_Ijk->GetNumberOfPoints() > 0)
+  {
+    for (int i = 0; i < 6; i++)
     {
-      int* brushExtent = orientedBrushPositionerOutput->GetExtent();
-      for (int i = 0; i < 3; i++)
-      {
-        if (brushExtent[i * 2] < updateExtent[i * 2])
-        {
-          updateExtent[i * 2] = brushExtent[i * 2];
-        }
-        if (brushExtent[i * 2 + 1] > updateExtent[i * 2 + 1])
-        {
-          updateExtent[i * 2 + 1] = brushExtent[i * 2 + 1];
-        }
-      }
+      updateExtent[i] = modifiedExtent[i];
     }
-    vtkOrientedImageDataResample::ModifyImage(modifierLabelmap, orientedBrushPositionerOutput.GetPointer(), vtkOrientedImageDataResample::OPERATION_MAXIMUM);
   }
   modifierLabelmap->Modified();
 }
@@ -1001,6 +981,7 @@ void qSlicerSegmentEditorPaintEffect::deactivate()
   d->IsPainting = false;
   d->clearBrushPipelines();
   d->PaintCoordinates_World->Reset();
+  d->PaintStrokeStartPointIds->Reset();
   d->ActiveViewWidget = nullptr;
 }
 
@@ -1744,6 +1725,7 @@ void qSlicerSegmentEditorPaintEffect::paintApply(qMRMLWidget* viewWidget)
   // "No input data"
   d->clearBrushPipelines();
   d->PaintCoordinates_World->Reset();
+  d->PaintStrokeStartPointIds->Reset();
 }
 
 //-----------------------------------------------------------------------------
@@ -1768,6 +1750,7 @@ void qSlicerSegmentEditorPaintEffect::clearBrushes()
   // "No input data"
   d->clearBrushPipelines();
   d->PaintCoordinates_World->Reset();
+  d->PaintStrokeStartPointIds->Reset();
 }
 
 //-----------------------------------------------------------------------------
@@ -62,10 +62,11 @@ class qMRMLSliceWidget;
 class qMRMLSliderWidget;
 class qMRMLSpinBox;
 class vtkActor2D;
+class vtkBrushStrokeRasterizer;
 class vtkGlyph3D;
+class vtkIdList;
 class vtkPoints;
 class vtkPolyDataNormals;
-class vtkPolyDataToImageStencil;
 
 /// \brief Private implementation of the segment editor paint effect
 class qSlicerSegmentEditorPaintEffectPrivate: public QObject
@@ -94,9 +95,9 @@ public:
   /// Update brush model (shape and position)
   void updateBrushModel(qMRMLWidget* viewWidget, double brushPosition_World[3]);
 
-  /// Updates the brush stencil that can be used to quickly paint the brush shape into
-  /// modifierLabelmap at many different positions.
-  void updateBrushStencil(qMRMLWidget* viewWidget);
+  /// Updates brush shape and brush to IJK transform of the stroke rasterizer
+  /// that paints the brush along the stroke into the labelmap.
+  bool updateBrushStrokeRasterizer(vtkOrientedImageData* labelmap, qMRMLWidget* viewWidget);
 
 protected:
   /// Get brush object for widget. Create if does not exist
@@ -142,13 +143,13 @@ public:
   vtkSmartPointer<vtkTransformPolyDataFilter> WorldOriginToWorldTransformer;
   vtkSmartPointer<vtkTransform> WorldOriginToWorldTransform;
   vtkSmartPointer<vtkPolyDataNormals> BrushPolyDataNormals;
-  vtkSmartPointer<vtkTransformPolyDataFilter> WorldOriginToModifierLabelmapIjkTransformer;
-  vtkSmartPointer<vtkTransform> WorldOriginToModifierLabelmapIjkTransform; // transforms from polydata source to modifierLabelmap's IJK coordinate system (brush origin in IJK origin)
-  vtkSmartPointer<vtkPolyDataToImageStencil> BrushPolyDataToStencil;
+  vtkSmartPointer<vtkBrushStrokeRasterizer> BrushStrokeRasterizer;
 
   vtkSmartPointer<vtkGlyph3D> FeedbackGlyphFilter;
 
   vtkSmartPointer<vtkPoints> PaintCoordinates_World;
+  /// Indices of points in PaintCoordinates_World that are not connected to the previous point
+  vtkSmartPointer<vtkIdList> PaintStrokeStartPointIds;
   vtkSmartPointer<vtkPolyData> FeedbackPointsPolyData;
 
   /// If a new point is added at less than this squared distance
@@ -39,6 +39,7 @@
 #include <vtkActor.h>
 #include <vtkAppendPolyData.h>
 #include <vtkCallbackCommand.h>
+#include <vtkCollection.h>
 #include <vtkDataObject.h>
 #include <vtkGeneralTransform.h>
 #include <vtkGeometryFilter.h>
@@ -333,6 +334,93 @@ vtkMRMLSegmentationNode* vtkSlicerSegmentationsModuleLogic::LoadSegmentationFrom
   return segmentationNode.GetPointer();
 }
 
+//-----------------------------------------------------------------------------
+bool vtkSlicerSegmentationsModuleLogic::PreloadSegmentationFromFile(const char* fileName,
+  vtkCollection* preloadedNodes, vtkMRMLMessageCollection* userMessages/*=nullptr*/)
+{
+  if (fileName == nullptr || preloadedNodes == nullptr)
+  {
+    return false;
+  }
+  vtkNew<vtkMRMLSegmentationStorageNode> storageNode;
+  storageNode->SetFileName(fileName);
+  if (!storageNode->SupportedFileType(fileName))
+  {
+    vtkErrorToMessageCollectionWithObjectMacro(storageNode, userMessages, "vtkSlicerSegmentationsModuleLogic::PreloadSegmentationFromFile",
+      "Segmentation storage node unable to load segmentation file. Unsupported file type.");
+    return false;
+  }
+
+  // Reading creates the display node, therefore the nodes are read in a private scene
+  // and moved to the scene of the logic in AddPreloadedSegmentation().
+  vtkNew<vtkMRMLScene> privateScene;
+  privateScene->AddNode(storageNode);
+  vtkNew<vtkMRMLSegmentationNode> segmentationNode;
+  privateScene->AddNode(segmentationNode);
+  segmentationNode->SetAndObserveStorageNodeID(storageNode->GetID());
+  int success = storageNode->ReadData(segmentationNode);
+  if (userMessages)
+  {
+    userMessages->AddMessages(storageNode->GetUserMessages());
+  }
+  vtkSmartPointer<vtkMRMLSegmentationDisplayNode> displayNode =
+    vtkMRMLSegmentationDisplayNode::SafeDownCast(segmentationNode->GetDisplayNode());
+  if (success != 1 || !displayNode)
+  {
+    vtkErrorToMessageCollectionWithObjectMacro(storageNode, userMessages, "vtkSlicerSegmentationsModuleLogic::PreloadSegmentationFromFile",
+      "Error reading " << fileName);
+    return false;
+  }
+  privateScene->RemoveNode(displayNode);
+  privateScene->RemoveNode(storageNode);
+  privateScene->RemoveNode(segmentationNode);
+  preloadedNodes->AddItem(segmentationNode);
+  preloadedNodes->AddItem(displayNode);
+  preloadedNodes->AddItem(storageNode);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+vtkMRMLSegmentationNode* vtkSlicerSegmentationsModuleLogic::AddPreloadedSegmentation(vtkMRMLSegmentationNode* segmentationNode,
+  vtkMRMLSegmentationDisplayNode* displayNode, vtkMRMLSegmentationStorageNode* storageNode,
+  bool autoOpacities/*=true*/, const char* nodeName/*=nullptr*/)
+{
+  if (this->GetMRMLScene() == nullptr || segmentationNode == nullptr
+    || displayNode == nullptr || storageNode == nullptr || storageNode->GetFileName() == nullptr)
+  {
+    vtkErrorMacro("AddPreloadedSegmentation: invalid scene, segmentation node, display node, or storage node");
+    return nullptr;
+  }
+  std::string uname;
+  if (nodeName && strlen(nodeName)>0)
+  {
+    uname = nodeName;
+  }
+  else
+  {
+    uname = this->GetMRMLScene()->GetUniqueNameByString(
+      storageNode->GetFileNameWithoutExtension(storageNode->GetFileName()).c_str());
+  }
+  segmentationNode->SetName(uname.c_str());
+  std::string storageUName = uname + "_Storage";
+  storageNode->SetName(storageUName.c_str());
+
+  this->GetMRMLScene()->AddNode(storageNode);
+  this->GetMRMLScene()->AddNode(displayNode);
+  this->GetMRMLScene()->AddNode(segmentationNode);
+  segmentationNode->SetAndObserveStorageNodeID(storageNode->GetID());
+  segmentationNode->SetAndObserveDisplayNodeID(displayNode->GetID());
+
+  // Same display setup as in LoadSegmentationFromFile()
+  if (autoOpacities && segmentationNode->GetSegmentation()->ContainsRepresentation(
+    vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName()))
+  {
+    displayNode->CalculateAutoOpacitiesForSegments();
+  }
+
+  return segmentationNode;
+}
+
 //-----------------------------------------------------------------------------
 bool vtkSlicerSegmentationsModuleLogic::CreateLabelmapVolumeFromOrientedImageData(
   vtkOrientedImageData* orientedImageData, vtkMRMLLabelMapVolumeNode* labelmapVolumeNode)
@@ -34,11 +34,13 @@
 #include "vtkMRMLSegmentationNode.h"
 
 class vtkCallbackCommand;
+class vtkCollection;
 class vtkOrientedImageData;
 class vtkPolyData;
 class vtkDataObject;
 class vtkGeneralTransform;
 
+class vtkMRMLSegmentationDisplayNode;
 class vtkMRMLSegmentationStorageNode;
 class vtkMRMLSegmentEditorNode;
 class vtkMRMLScalarVolumeNode;
@@ -79,6 +81,25 @@ public:
   vtkMRMLSegmentationNode* LoadSegmentationFromFile(const char* filename, bool autoOpacities = true, const char* nodeName=nullptr,
     vtkMRMLColorTableNode* colorTableNode=nullptr, vtkMRMLMessageCollection* userMessages=nullptr);
 
+  /// Read segmentation from file into nodes that are not added to the scene of the logic.
+  /// The method can be called from a worker thread. Segments are not named using a color table node.
+  /// \param filename Path and name of file containing segmentation (nrrd, vtm, etc.)
+  /// \param preloadedNodes The segmentation node, its display node and its storage node are added
+  ///   to this collection (in this order) on success.
+  /// \return Success flag
+  /// \sa AddPreloadedSegmentation()
+  static bool PreloadSegmentationFromFile(const char* filename, vtkCollection* preloadedNodes,
+    vtkMRMLMessageCollection* userMessages=nullptr);
+
+  /// Add nodes read by PreloadSegmentationFromFile() to the scene.
+  /// \param autoOpacities Optional flag determining whether segment opacities are calculated automatically based on containment.
+  /// \param nodeName Optional string to use for the segmentation node name.
+  /// \return Added segmentation node
+  /// \sa LoadSegmentationFromFile()
+  vtkMRMLSegmentationNode* AddPreloadedSegmentation(vtkMRMLSegmentationNode* segmentationNode,
+    vtkMRMLSegmentationDisplayNode* displayNode, vtkMRMLSegmentationStorageNode* storageNode,
+    bool autoOpacities = true, const char* nodeName=nullptr);
+
   /// Create labelmap volume MRML node from oriented image data.
   /// Creates a display node if a display node does not exist. Shifts image extent to start from zero.
   /// Image is shallow-copied (voxel array is not duplicated).
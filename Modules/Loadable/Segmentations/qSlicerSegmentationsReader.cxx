@@ -33,11 +33,13 @@
 #include <vtkMRMLScene.h>
 #include <vtkMRMLSegmentationNode.h>
 #include <vtkMRMLSegmentationDisplayNode.h>
+#include <vtkMRMLSegmentationStorageNode.h>
 #include <vtkMRMLStorageNode.h>
 #include <vtkMRMLModelNode.h>
 #include <vtkMRMLModelStorageNode.h>
 
 // VTK includes
+#include <vtkCollection.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
 #include <vtkPolyData.h>
@@ -239,3 +241,68 @@ bool qSlicerSegmentationsReader::load(const IOProperties& properties)
 
   return true;
 }
+
+//-----------------------------------------------------------------------------
+bool qSlicerSegmentationsReader::canPreload(const IOProperties& properties)const
+{
+  QString fileName = properties.value("fileName").toString();
+  // Remote files are downloaded by the cache manager of the scene
+  if (fileName.isEmpty() || fileName.contains("://"))
+  {
+    return false;
+  }
+  // Segment names and colors are set from the color node during reading
+  if (!properties.value("colorNodeID").toString().isEmpty())
+  {
+    return false;
+  }
+  std::string extension = vtkMRMLStorageNode::GetLowercaseExtensionFromFileName(fileName.toStdString());
+  return extension.compare(".stl") != 0 && extension.compare(".obj") != 0;
+}
+
+//-----------------------------------------------------------------------------
+vtkSmartPointer<vtkObject> qSlicerSegmentationsReader::preload(const IOProperties& properties,
+  vtkMRMLMessageCollection* userMessages)const
+{
+  QString fileName = properties.value("fileName").toString();
+  vtkSmartPointer<vtkCollection> preloadedNodes = vtkSmartPointer<vtkCollection>::New();
+  if (!vtkSlicerSegmentationsModuleLogic::PreloadSegmentationFromFile(
+    fileName.toUtf8().constData(), preloadedNodes, userMessages))
+  {
+    return nullptr;
+  }
+  return preloadedNodes;
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerSegmentationsReader::loadPreloaded(const IOProperties& properties, vtkObject* preloadedData)
+{
+  Q_D(qSlicerSegmentationsReader);
+  this->setLoadedNodes(QStringList());
+  vtkCollection* preloadedNodes = vtkCollection::SafeDownCast(preloadedData);
+  if (d->SegmentationsLogic.GetPointer() == nullptr || !preloadedNodes)
+  {
+    return this->load(properties);
+  }
+  bool autoOpacities = true;
+  if (properties.contains("autoOpacities"))
+  {
+    autoOpacities = properties["autoOpacities"].toBool();
+  }
+  QString name;
+  if (properties.contains("name"))
+  {
+    name = properties["name"].toString();
+  }
+  vtkMRMLSegmentationNode* node = d->SegmentationsLogic->AddPreloadedSegmentation(
+    vtkMRMLSegmentationNode::SafeDownCast(preloadedNodes->GetItemAsObject(0)),
+    vtkMRMLSegmentationDisplayNode::SafeDownCast(preloadedNodes->GetItemAsObject(1)),
+    vtkMRMLSegmentationStorageNode::SafeDownCast(preloadedNodes->GetItemAsObject(2)),
+    autoOpacities, name.toUtf8());
+  if (!node)
+  {
+    return false;
+  }
+  this->setLoadedNodes( QStringList(QString(node->GetID())) );
+  return true;
+}
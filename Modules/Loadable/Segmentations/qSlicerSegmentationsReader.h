@@ -54,6 +54,13 @@ public:
 
   bool load(const IOProperties& properties) override;
 
+  /// Local segmentation files that are not read using a color node (and not STL or OBJ)
+  /// are read in a worker thread using vtkSlicerSegmentationsModuleLogic::PreloadSegmentationFromFile().
+  bool canPreload(const IOProperties& properties)const override;
+  vtkSmartPointer<vtkObject> preload(const IOProperties& properties,
+    vtkMRMLMessageCollection* userMessages)const override;
+  bool loadPreloaded(const IOProperties& properties, vtkObject* preloadedData) override;
+
 protected:
   QScopedPointer<qSlicerSegmentationsReaderPrivate> d_ptr;
 
@@ -32,6 +32,7 @@
 #include "vtkMRMLCameraNode.h"
 #include "vtkMRMLI18N.h"
 #include "vtkMRMLLabelMapVolumeNode.h"
+#include "vtkMRMLLinearTransformNode.h"
 #include "vtkMRMLMarkupsFiducialNode.h"
 #include "vtkMRMLMessageCollection.h"
 #include "vtkMRMLModelNode.h"
@@ -148,6 +149,7 @@ vtkMRMLSequenceNode* vtkSlicerSequencesLogic::AddSequence(const char* filename,
   vtkNew<vtkMRMLSequenceNode> sequenceNode;
   vtkNew<vtkMRMLSequenceStorageNode> sequenceStorageNode;
   vtkNew<vtkMRMLVolumeSequenceStorageNode> volumeSequenceStorageNode;
+  vtkNew<vtkMRMLLinearTransformSequenceStorageNode> transformSequenceStorageNode;
 
   vtkMRMLStorageNode* storageNode = nullptr;
   if (sequenceStorageNode->SupportedFileType(filename))
@@ -158,6 +160,10 @@ vtkMRMLSequenceNode* vtkSlicerSequencesLogic::AddSequence(const char* filename,
   {
     storageNode = volumeSequenceStorageNode;
   }
+  else if (transformSequenceStorageNode->SupportedFileType(filename))
+  {
+    storageNode = transformSequenceStorageNode;
+  }
   else
   {
     vtkErrorToMessageCollectionMacro(userMessages, "vtkSlicerSequencesLogic::AddSequence",
@@ -349,6 +355,26 @@ void vtkSlicerSequencesLogic::UpdateProxyNodesFromSequences(vtkMRMLSequenceBrows
 
     vtkSmartPointer<vtkMRMLNode> sourceDataNode;
     int missingItemMode = browserNode->GetMissingItemMode(synchronizedSequenceNode);
+
+    if (!browserNode->GetSaveChanges(synchronizedSequenceNode))
+    {
+      // Linear transforms that are stored in the compact transform matrix array of the sequence
+      // are copied into the proxy node directly, without creating a transform node for the item.
+      vtkMRMLLinearTransformNode* proxyTransformNode =
+        vtkMRMLLinearTransformNode::SafeDownCast(browserNode->GetProxyNode(synchronizedSequenceNode));
+      int itemNumber = synchronizedSequenceNode->GetItemNumberFromIndexValue(indexValue,
+        /* exactMatchRequired= */ missingItemMode != vtkMRMLSequenceBrowserNode::MissingItemCreateFromPrevious);
+      if (proxyTransformNode && strcmp(proxyTransformNode->GetClassName(), "vtkMRMLLinearTransformNode") == 0
+        && synchronizedSequenceNode->IsNthDataNodeTransformMatrix(itemNumber))
+      {
+        nodeModifiedStates.push_back(std::make_pair(proxyTransformNode, proxyTransformNode->StartModify()));
+        vtkNew<vtkMatrix4x4> matrix;
+        synchronizedSequenceNode->GetNthTransformMatrix(itemNumber, matrix);
+        proxyTransformNode->SetMatrixTransformToParent(matrix);
+        this->UpdateProxyNodeName(browserNode, synchronizedSequenceNode, proxyTransformNode, indexValue, selectedItemNumber);
+        continue;
+      }
+    }
     if (browserNode->GetSaveChanges(synchronizedSequenceNode))
     {
       // we want to save changes, therefore we have to make sure there is at least one data node. If no data
@@ -487,35 +513,7 @@ void vtkSlicerSequencesLogic::UpdateProxyNodesFromSequences(vtkMRMLSequenceBrows
     bool shallowCopy = browserNode->GetSaveChanges(synchronizedSequenceNode);
     targetProxyNode->CopyContent(sourceDataNode, !shallowCopy);
 
-    // Singleton nodes must not be renamed, as they are often expected to exist by a specific name
-    if (browserNode->GetOverwriteProxyName(synchronizedSequenceNode) && !targetProxyNode->GetSingletonTag())
-    {
-      // Generation of target proxy node name: base node name [IndexName = IndexValue IndexUnit]
-      std::string indexName = synchronizedSequenceNode->GetIndexName();
-      std::string unit = synchronizedSequenceNode->GetIndexUnit();
-      // Save the base name (without the index name and value)
-      targetProxyNode->SetAttribute("Sequences.BaseName", synchronizedSequenceNode->GetName());
-      std::ostringstream targetProxyNodeNameStr;
-      targetProxyNodeNameStr << synchronizedSequenceNode->GetName() << " [";
-      if (browserNode->GetIndexDisplayMode() == vtkMRMLSequenceBrowserNode::IndexDisplayAsIndexValue)
-      {
-        if (!indexName.empty())
-        {
-          targetProxyNodeNameStr << indexName << "=";
-        }
-        targetProxyNodeNameStr << indexValue;
-        if (!unit.empty())
-        {
-          targetProxyNodeNameStr << unit;
-        }
-      }
-      else
-      {
-        targetProxyNodeNameStr << (selectedItemNumber + 1) << "/" << (synchronizedSequenceNode->GetNumberOfDataNodes());
-      }
-      targetProxyNodeNameStr << "]";
-      targetProxyNode->SetName(targetProxyNodeNameStr.str().c_str());
-    }
+    this->UpdateProxyNodeName(browserNode, synchronizedSequenceNode, targetProxyNode, indexValue, selectedItemNumber);
 
     if (newTargetProxyNodeWasCreated)
     {
@@ -548,6 +546,42 @@ void vtkSlicerSequencesLogic::UpdateProxyNodesFromSequences(vtkMRMLSequenceBrows
 #endif
 }
 
+//---------------------------------------------------------------------------
+void vtkSlicerSequencesLogic::UpdateProxyNodeName(vtkMRMLSequenceBrowserNode* browserNode, vtkMRMLSequenceNode* sequenceNode,
+  vtkMRMLNode* proxyNode, const std::string& indexValue, int selectedItemNumber)
+{
+  // Singleton nodes must not be renamed, as they are often expected to exist by a specific name
+  if (!browserNode->GetOverwriteProxyName(sequenceNode) || proxyNode->GetSingletonTag())
+  {
+    return;
+  }
+  // Generation of target proxy node name: base node name [IndexName = IndexValue IndexUnit]
+  std::string indexName = sequenceNode->GetIndexName();
+  std::string unit = sequenceNode->GetIndexUnit();
+  // Save the base name (without the index name and value)
+  proxyNode->SetAttribute("Sequences.BaseName", sequenceNode->GetName());
+  std::ostringstream proxyNodeNameStr;
+  proxyNodeNameStr << sequenceNode->GetName() << " [";
+  if (browserNode->GetIndexDisplayMode() == vtkMRMLSequenceBrowserNode::IndexDisplayAsIndexValue)
+  {
+    if (!indexName.empty())
+    {
+      proxyNodeNameStr << indexName << "=";
+    }
+    proxyNodeNameStr << indexValue;
+    if (!unit.empty())
+    {
+      proxyNodeNameStr << unit;
+    }
+  }
+  else
+  {
+    proxyNodeNameStr << (selectedItemNumber + 1) << "/" << (sequenceNode->GetNumberOfDataNodes());
+  }
+  proxyNodeNameStr << "]";
+  proxyNode->SetName(proxyNodeNameStr.str().c_str());
+}
+
 //---------------------------------------------------------------------------
 void vtkSlicerSequencesLogic::UpdateSequencesFromProxyNodes(vtkMRMLSequenceBrowserNode* browserNode, vtkMRMLNode* proxyNode)
 {
@@ -118,6 +118,10 @@ protected:
 
   bool IsDataConnectorNode(vtkMRMLNode*);
 
+  /// Set proxy node name from the sequence name and current index value (if enabled in the browser node)
+  void UpdateProxyNodeName(vtkMRMLSequenceBrowserNode* browserNode, vtkMRMLSequenceNode* sequenceNode,
+    vtkMRMLNode* proxyNode, const std::string& indexValue, int selectedItemNumber);
+
   // Time of the last update of each browser node (in universal time)
   std::map< vtkMRMLSequenceBrowserNode*, double > LastSequenceBrowserUpdateTimeSec;
 
@@ -41,6 +41,7 @@
 #include <vtkVariant.h>
 
 // STD includes
+#include <iomanip>
 #include <sstream>
 #include <algorithm> // for std::find
 #if defined(_WIN32) && !defined(__CYGWIN__)
@@ -160,6 +161,7 @@ void vtkMRMLSequenceBrowserNode::WriteXML(ostream& of, int nIndent)
   of << indent << " selectedItemNumber=\"" << this->SelectedItemNumber << "\"";
   of << indent << " recordingActive=\"" << (this->RecordingActive ? "true" : "false") << "\"";
   of << indent << " recordOnMasterModifiedOnly=\"" << (this->RecordMasterOnly ? "true" : "false") << "\"";
+  of << indent << " recordingShareData=\"" << (this->RecordingShareData ? "true" : "false") << "\"";
 
   std::string recordingSamplingModeString = this->GetRecordingSamplingModeAsString();
   if (!recordingSamplingModeString.empty())
@@ -282,6 +284,17 @@ void vtkMRMLSequenceBrowserNode::ReadXMLAttributes(const char** atts)
         this->SetRecordMasterOnly(0);
       }
     }
+    else if (!strcmp(attName, "recordingShareData"))
+    {
+      if (!strcmp(attValue, "true"))
+      {
+        this->SetRecordingShareData(true);
+      }
+      else
+      {
+        this->SetRecordingShareData(false);
+      }
+    }
     else if (!strcmp(attName, "recordingSamplingMode"))
     {
       int recordingSamplingMode = this->GetRecordingSamplingModeFromString(attValue);
@@ -381,6 +394,7 @@ void vtkMRMLSequenceBrowserNode::Copy(vtkMRMLNode *anode)
   this->SetPlaybackItemSkippingEnabled(node->GetPlaybackItemSkippingEnabled());
   this->SetPlaybackLooped(node->GetPlaybackLooped());
   this->SetRecordMasterOnly(node->GetRecordMasterOnly());
+  this->SetRecordingShareData(node->GetRecordingShareData());
   this->SetRecordingSamplingMode(node->GetRecordingSamplingMode());
   this->SetIndexDisplayMode(node->GetIndexDisplayMode());
   this->SetIndexDisplayFormat(node->GetIndexDisplayFormat());
@@ -402,7 +416,11 @@ void vtkMRMLSequenceBrowserNode::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << " Selected item number: " << this->SelectedItemNumber << '\n';
   os << indent << " Recording active: " << (this->RecordingActive ? "true" : "false") << '\n';
   os << indent << " Recording on master modified only: " << (this->RecordMasterOnly ? "true" : "false") << '\n';
+  os << indent << " Recording share data: " << (this->RecordingShareData ? "true" : "false") << '\n';
   os << indent << " Recording sampling mode: " << this->GetRecordingSamplingModeAsString() << "\n";
+  os << indent << " Number of recorded frames: " << this->NumberOfRecordedFrames << "\n";
+  os << indent << " Number of skipped frames: " << this->NumberOfSkippedFrames << "\n";
+  os << indent << " Number of dropped frames: " << this->NumberOfDroppedFrames << "\n";
   os << indent << " Index display mode: " << this->GetIndexDisplayModeAsString() << "\n";
   os << indent << " Index display format: " << this->GetIndexDisplayFormat() << "\n";
 
@@ -979,11 +997,23 @@ void vtkMRMLSequenceBrowserNode::SetRecordingActive(bool recording)
   }
   if (this->RecordingActive!=recording)
   {
+    if (recording)
+    {
+      this->ResetRecordingStatistics();
+    }
     this->RecordingActive = recording;
     this->Modified();
   }
 }
 
+//---------------------------------------------------------------------------
+void vtkMRMLSequenceBrowserNode::ResetRecordingStatistics()
+{
+  this->NumberOfRecordedFrames = 0;
+  this->NumberOfSkippedFrames = 0;
+  this->NumberOfDroppedFrames = 0;
+}
+
 //---------------------------------------------------------------------------
 int vtkMRMLSequenceBrowserNode::SelectFirstItem()
 {
@@ -1137,11 +1167,13 @@ void vtkMRMLSequenceBrowserNode::SaveProxyNodesState()
       if (this->GetPlaybackRateFps() > 0 && (timeElapsedSinceLastSave < 1.0 / this->GetPlaybackRateFps()))
       {
         // this state is too close in time to the previous saved state, don't record it
+        this->NumberOfSkippedFrames++;
         return;
       }
     }
     this->LastSaveProxyNodesStateTimeSec = currentTime;
-    currTime << (currentTime - this->RecordingTimeOffsetSec);
+    // Use enough digits to keep consecutive frames distinct in long recordings
+    currTime << std::setprecision(12) << (currentTime - this->RecordingTimeOffsetSec);
   }
   else
   {
@@ -1164,13 +1196,34 @@ void vtkMRMLSequenceBrowserNode::SaveProxyNodesState()
   std::vector< vtkMRMLSequenceNode* > sequenceNodes;
   this->GetSynchronizedSequenceNodes(sequenceNodes, true);
   bool snapshotAdded = false;
+  bool snapshotFailed = false;
+  bool shareData = continuousRecording && this->RecordingShareData;
   for (std::vector< vtkMRMLSequenceNode* >::iterator it = sequenceNodes.begin(); it != sequenceNodes.end(); it++)
   {
     vtkMRMLSequenceNode* currSequenceNode = (*it);
     if (this->GetRecording(currSequenceNode))
     {
-      currSequenceNode->SetDataNodeAtValue(this->GetProxyNode(currSequenceNode), currTime.str().c_str());
-      snapshotAdded = true;
+      vtkMRMLNode* proxyNode = this->GetProxyNode(currSequenceNode);
+      if (proxyNode && currSequenceNode->RecordDataNodeAtValue(proxyNode, currTime.str(), shareData))
+      {
+        snapshotAdded = true;
+      }
+      else
+      {
+        snapshotFailed = true;
+      }
+    }
+  }
+  if (continuousRecording)
+  {
+    if (snapshotFailed)
+    {
+      // At least one of the recorded sequences is missing this frame
+      this->NumberOfDroppedFrames++;
+    }
+    else if (snapshotAdded)
+    {
+      this->NumberOfRecordedFrames++;
     }
   }
   if (snapshotAdded)
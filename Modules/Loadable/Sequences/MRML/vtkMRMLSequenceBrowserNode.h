@@ -188,6 +188,31 @@ public:
   vtkBooleanMacro(RecordMasterOnly, bool);
   //@}
 
+  //@{
+  /// Get/set whether recorded items share data objects (image data, mesh, etc.) with the proxy nodes
+  /// instead of deep-copying them. It reduces recording time and memory usage significantly
+  /// but it is only safe if the data source sets a new data object in the proxy node for each frame
+  /// (instead of modifying the current data object in place). Disabled by default.
+  /// \sa vtkMRMLSequenceNode::RecordDataNodeAtValue
+  vtkGetMacro(RecordingShareData, bool);
+  vtkSetMacro(RecordingShareData, bool);
+  vtkBooleanMacro(RecordingShareData, bool);
+  //@}
+
+  //@{
+  /// Recording statistics since recording was last activated.
+  /// Number of recorded frames.
+  vtkGetMacro(NumberOfRecordedFrames, vtkTypeInt64);
+  /// Number of proxy node changes that were not recorded because they were too close in time
+  /// to the previous frame (in SamplingLimitedToPlaybackFrameRate mode).
+  vtkGetMacro(NumberOfSkippedFrames, vtkTypeInt64);
+  /// Number of frames that could not be recorded in all the recorded sequences
+  /// (missing proxy node or failed vtkMRMLSequenceNode::RecordDataNodeAtValue).
+  vtkGetMacro(NumberOfDroppedFrames, vtkTypeInt64);
+  /// Reset all recording statistics to zero.
+  void ResetRecordingStatistics();
+  //@}
+
   //@{
   /// Get/set the recording sampling mode
   vtkSetMacro(RecordingSamplingMode, int);
@@ -397,6 +422,10 @@ protected:
   double RecordingTimeOffsetSec; // difference between universal time and index value
   double LastSaveProxyNodesStateTimeSec;
   bool RecordMasterOnly{false};
+  bool RecordingShareData{false};
+  vtkTypeInt64 NumberOfRecordedFrames{0};
+  vtkTypeInt64 NumberOfSkippedFrames{0};
+  vtkTypeInt64 NumberOfDroppedFrames{0};
   int RecordingSamplingMode{vtkMRMLSequenceBrowserNode::SamplingLimitedToPlaybackFrameRate};
   int IndexDisplayMode{vtkMRMLSequenceBrowserNode::IndexDisplayAsIndexValue};
   std::string IndexDisplayFormat;
@@ -212,6 +212,79 @@ int TestRemoveItem()
   return EXIT_SUCCESS;
 }
 
+int TestRecordingStatistics()
+{
+  vtkNew<vtkMRMLScene> scene;
+
+  // Register vtkMRMLSequenceBrowserNode
+  vtkNew<vtkSlicerSequencesLogic> sequencesLogic;
+  sequencesLogic->SetMRMLScene(scene.GetPointer());
+
+  vtkMRMLSequenceNode* sequenceNode = vtkMRMLSequenceNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLSequenceNode"));
+  vtkMRMLSequenceBrowserNode* browserNode = vtkMRMLSequenceBrowserNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLSequenceBrowserNode"));
+  CHECK_NOT_NULL(browserNode);
+  browserNode->SetAndObserveMasterSequenceNodeID(sequenceNode->GetID());
+
+  vtkNew<vtkMRMLTransformNode> transform;
+  sequenceNode->SetDataNodeAtValue(transform, "0");
+  sequencesLogic->UpdateAllProxyNodes();
+  CHECK_NOT_NULL(browserNode->GetProxyNode(sequenceNode));
+
+  browserNode->SetRecording(sequenceNode, true);
+  browserNode->SetRecordingSamplingMode(vtkMRMLSequenceBrowserNode::SamplingAll);
+  browserNode->SetRecordingShareData(true);
+  browserNode->SetRecordingActive(true);
+  CHECK_INT(browserNode->GetNumberOfRecordedFrames(), 0);
+  for (int i = 0; i < 3; ++i)
+  {
+    browserNode->SaveProxyNodesState();
+  }
+  browserNode->SetRecordingActive(false);
+  CHECK_INT(browserNode->GetNumberOfRecordedFrames(), 3);
+  CHECK_INT(browserNode->GetNumberOfSkippedFrames(), 0);
+  CHECK_INT(browserNode->GetNumberOfDroppedFrames(), 0);
+
+  browserNode->ResetRecordingStatistics();
+  CHECK_INT(browserNode->GetNumberOfRecordedFrames(), 0);
+
+  // Gaps between frames longer than the playback frame interval are not counted as dropped frames
+  browserNode->SetRecordingSamplingMode(vtkMRMLSequenceBrowserNode::SamplingLimitedToPlaybackFrameRate);
+  browserNode->SetPlaybackRateFps(1.0e6);
+  browserNode->SetRecordingActive(true);
+  for (int i = 0; i < 3; ++i)
+  {
+    browserNode->SaveProxyNodesState();
+  }
+  browserNode->SetRecordingActive(false);
+  CHECK_INT(browserNode->GetNumberOfRecordedFrames() + browserNode->GetNumberOfSkippedFrames(), 3);
+  CHECK_INT(browserNode->GetNumberOfDroppedFrames(), 0);
+
+  // Frames that cannot be recorded (no proxy node, because there is no sequences logic
+  // in this scene to create it) are counted as dropped frames
+  vtkNew<vtkMRMLScene> sceneWithoutLogic;
+  sceneWithoutLogic->RegisterNodeClass(vtkNew<vtkMRMLSequenceBrowserNode>().GetPointer());
+  vtkMRMLSequenceNode* sequenceNodeWithoutProxy = vtkMRMLSequenceNode::SafeDownCast(
+    sceneWithoutLogic->AddNewNodeByClass("vtkMRMLSequenceNode"));
+  vtkMRMLSequenceBrowserNode* browserNodeWithoutProxy = vtkMRMLSequenceBrowserNode::SafeDownCast(
+    sceneWithoutLogic->AddNewNodeByClass("vtkMRMLSequenceBrowserNode"));
+  CHECK_NOT_NULL(browserNodeWithoutProxy);
+  browserNodeWithoutProxy->SetAndObserveMasterSequenceNodeID(sequenceNodeWithoutProxy->GetID());
+  CHECK_NULL(browserNodeWithoutProxy->GetProxyNode(sequenceNodeWithoutProxy));
+  browserNodeWithoutProxy->SetRecording(sequenceNodeWithoutProxy, true);
+  browserNodeWithoutProxy->SetRecordingSamplingMode(vtkMRMLSequenceBrowserNode::SamplingAll);
+  browserNodeWithoutProxy->SetRecordingActive(true);
+  for (int i = 0; i < 2; ++i)
+  {
+    browserNodeWithoutProxy->SaveProxyNodesState();
+  }
+  browserNodeWithoutProxy->SetRecordingActive(false);
+  CHECK_INT(browserNodeWithoutProxy->GetNumberOfRecordedFrames(), 0);
+  CHECK_INT(browserNodeWithoutProxy->GetNumberOfDroppedFrames(), 2);
+  CHECK_INT(sequenceNodeWithoutProxy->GetNumberOfDataNodes(), 0);
+
+  return EXIT_SUCCESS;
+}
+
 }  // end anonymous namespace
 
 int vtkMRMLSequenceBrowserNodeTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
@@ -219,5 +292,6 @@ int vtkMRMLSequenceBrowserNodeTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)
   CHECK_EXIT_SUCCESS(TestIndexFormatting());
   CHECK_EXIT_SUCCESS(TestSelectNextItem());
   CHECK_EXIT_SUCCESS(TestRemoveItem());
+  CHECK_EXIT_SUCCESS(TestRecordingStatistics());
   return EXIT_SUCCESS;
 }
@@ -32,6 +32,7 @@
 #include <vtkMRMLVolumeSequenceStorageNode.h>
 
 // VTK includes
+#include <vtkDoubleArray.h>
 #include <vtkImageData.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
@@ -123,6 +124,43 @@ int vtkMRMLSequenceStorageNodeTest1( int argc, char * argv[] )
     CHECK_EXIT_SUCCESS(TestWriteReadSequence(tempDir, transformSequenceNode, addedTransformStorageNode, "TestTransformSequence"));
   }
 
+  // Add transform sequence stored in compact binary format
+  {
+    vtkSmartPointer<vtkMRMLSequenceNode> transformSequenceNode = vtkMRMLSequenceNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLSequenceNode"));
+    const int numberOfItems = 100;
+    vtkNew<vtkDoubleArray> matrices;
+    matrices->SetNumberOfComponents(16);
+    std::vector<std::string> indexValues;
+    vtkNew<vtkMatrix4x4> matrix;
+    for (int i = 0; i < numberOfItems; ++i)
+    {
+      matrix->SetElement(0, 3, i * 2.0);
+      matrices->InsertNextTypedTuple(matrix->GetData());
+      std::ostringstream indexValueStr;
+      indexValueStr << i * 0.01;
+      indexValues.push_back(indexValueStr.str());
+    }
+    CHECK_BOOL(transformSequenceNode->SetTransformMatrices(matrices, indexValues, "ProbeToTracker"), true);
+    vtkNew<vtkMRMLLinearTransformSequenceStorageNode> storageNode;
+    scene->AddNode(storageNode);
+    std::string fullFilePath = tempDir + "/TestTransformMatrixSequence.seq.tfmb";
+    storageNode->SetFileName(fullFilePath.c_str());
+    CHECK_BOOL(storageNode->WriteData(transformSequenceNode), true);
+    // Writing does not create transform nodes
+    CHECK_INT(transformSequenceNode->GetSequenceScene()->GetNumberOfNodes(), 0);
+
+    vtkSmartPointer<vtkMRMLSequenceNode> readSequenceNode = vtkMRMLSequenceNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLSequenceNode"));
+    CHECK_BOOL(storageNode->ReadData(readSequenceNode), true);
+    CHECK_INT(readSequenceNode->GetNumberOfDataNodes(), numberOfItems);
+    CHECK_STD_STRING(readSequenceNode->GetNthIndexValue(50), indexValues[50]);
+    CHECK_BOOL(readSequenceNode->IsNthDataNodeTransformMatrix(50), true);
+    CHECK_BOOL(readSequenceNode->GetNthTransformMatrix(50, matrix), true);
+    CHECK_DOUBLE(matrix->GetElement(0, 3), 100.0);
+    vtkMRMLNode* dataNode = readSequenceNode->GetNthDataNode(50);
+    CHECK_NOT_NULL(dataNode);
+    CHECK_STD_STRING(dataNode->GetName(), "ProbeToTracker");
+  }
+
   // Create generic node sequence
   {
     vtkSmartPointer<vtkMRMLSequenceNode> genericSequenceNode = vtkMRMLSequenceNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLSequenceNode"));
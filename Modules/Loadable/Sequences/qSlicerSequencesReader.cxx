@@ -94,6 +94,7 @@ QStringList qSlicerSequencesReader::extensions()const
   return QStringList()
     << tr("Sequence") + " (*.seq.mrb *.mrb)"
     << tr("Volume Sequence") + " (*.seq.nrrd *.seq.nhdr)"
+    << tr("Transform Sequence") + " (*.seq.tfmb)"
     << tr("Volume Sequence") + " (*.nrrd *.nhdr)";
 }
 
@@ -0,0 +1,151 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+
+// CTK includes
+#include <ctkCoreTestingMacros.h>
+
+// qMRML includes
+#include "qMRMLSceneModel.h"
+#include "qMRMLWidget.h"
+
+// Subject Hierarchy includes
+#include "qMRMLSortFilterSubjectHierarchyProxyModel.h"
+#include "qMRMLSubjectHierarchyModel.h"
+#include "qSlicerSubjectHierarchyPluginHandler.h"
+
+// MRML includes
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSubjectHierarchyNode.h>
+
+// VTK includes
+#include <vtkNew.h>
+
+// STD includes
+#include <iostream>
+#include <vector>
+
+// Items added during batch processing are inserted into the subject hierarchy model
+// without rebuilding it. Large batches are inserted in blocks of rows under each parent.
+int qMRMLSubjectHierarchyModelTest1( int argc, char * argv [] )
+{
+  qMRMLWidget::preInitializeApplication();
+  QApplication app(argc, argv);
+  qMRMLWidget::postInitializeApplication();
+
+  vtkNew<vtkMRMLScene> scene;
+  // Plugin handler sets the default plugin as owner of the created folder items
+  qSlicerSubjectHierarchyPluginHandler::instance()->setMRMLScene(scene);
+  vtkMRMLSubjectHierarchyNode* shNode = scene->GetSubjectHierarchyNode();
+  CHECK_NOT_NULL(shNode);
+  const vtkIdType sceneItemID = shNode->GetSceneItemID();
+
+  qMRMLSubjectHierarchyModel model;
+  model.setMRMLScene(scene);
+  qMRMLSortFilterSubjectHierarchyProxyModel proxyModel;
+  proxyModel.setSourceModel(&model);
+  QModelIndex sceneIndex = model.subjectHierarchySceneIndex();
+  CHECK_BOOL(sceneIndex.isValid(), true);
+  CHECK_INT(model.rowCount(sceneIndex), 0);
+
+  QSignalSpy removeSpy(&model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+  QSignalSpy insertSpy(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+
+  // Add a few items in batch processing, they are inserted one by one
+  const int numberOfSmallBatchItems = 10;
+  CHECK_BOOL(numberOfSmallBatchItems + 1 <= qMRMLSceneModel::maximumNumberOfNodesToInsert(), true);
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+  std::vector<vtkIdType> smallBatchItemIDs;
+  for (int i = 0; i < numberOfSmallBatchItems; ++i)
+  {
+    smallBatchItemIDs.push_back(shNode->CreateFolderItem(sceneItemID, "Folder"));
+  }
+  vtkIdType childItemID = shNode->CreateFolderItem(smallBatchItemIDs[0], "Child");
+  shNode->SetItemName(smallBatchItemIDs[1], "Renamed");
+  CHECK_INT(model.rowCount(sceneIndex), 0);
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+  CHECK_INT(removeSpy.count(), 0);
+  CHECK_INT(insertSpy.count(), numberOfSmallBatchItems + 1);
+  CHECK_INT(model.rowCount(sceneIndex), numberOfSmallBatchItems);
+  CHECK_INT(model.indexFromSubjectHierarchyItem(smallBatchItemIDs.back()).row(), numberOfSmallBatchItems - 1);
+  CHECK_BOOL(model.indexFromSubjectHierarchyItem(childItemID).parent() == model.indexFromSubjectHierarchyItem(smallBatchItemIDs[0]), true);
+  CHECK_QSTRING(model.indexFromSubjectHierarchyItem(smallBatchItemIDs[1], model.nameColumn()).data().toString(), QString("Renamed"));
+
+  // Add 50k items in batch processing, they are inserted in one block per parent
+  const int numberOfFolders = 50;
+  const int numberOfChildrenPerFolder = 1000;
+  insertSpy.clear();
+  std::vector<vtkIdType> folderItemIDs;
+  std::vector<vtkIdType> lastChildItemIDs;
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+  for (int folderIndex = 0; folderIndex < numberOfFolders; ++folderIndex)
+  {
+    vtkIdType folderItemID = shNode->CreateFolderItem(sceneItemID, "Folder");
+    folderItemIDs.push_back(folderItemID);
+    vtkIdType lastChildID = 0;
+    for (int childIndex = 0; childIndex < numberOfChildrenPerFolder; ++childIndex)
+    {
+      lastChildID = shNode->CreateFolderItem(folderItemID, "Child");
+    }
+    lastChildItemIDs.push_back(lastChildID);
+  }
+  // Items are inserted into the model when batch processing ends
+  QElapsedTimer timer;
+  timer.start();
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+  const qint64 batchInsertTime = timer.elapsed();
+  const int numberOfItems = numberOfSmallBatchItems + 1 + numberOfFolders * (numberOfChildrenPerFolder + 1);
+  std::cout << "Insert " << numberOfFolders * (numberOfChildrenPerFolder + 1) << " items added in batch processing: "
+            << batchInsertTime << "ms" << std::endl;
+  CHECK_INT(removeSpy.count(), 0);
+  CHECK_INT(insertSpy.count(), 1 + numberOfFolders);
+  CHECK_INT(model.rowCount(sceneIndex), numberOfSmallBatchItems + numberOfFolders);
+  for (int folderIndex = 0; folderIndex < numberOfFolders; ++folderIndex)
+  {
+    QModelIndex folderIndexInModel = model.indexFromSubjectHierarchyItem(folderItemIDs[folderIndex]);
+    CHECK_INT(folderIndexInModel.row(), numberOfSmallBatchItems + folderIndex);
+    CHECK_INT(model.rowCount(folderIndexInModel), numberOfChildrenPerFolder);
+    QModelIndex lastChildIndex = model.indexFromSubjectHierarchyItem(lastChildItemIDs[folderIndex]);
+    CHECK_INT(lastChildIndex.row(), numberOfChildrenPerFolder - 1);
+    CHECK_BOOL(lastChildIndex.parent() == folderIndexInModel, true);
+    CHECK_BOOL(model.indexFromSubjectHierarchyItem(lastChildItemIDs[folderIndex], model.idColumn()).isValid(), true);
+  }
+  CHECK_INT(proxyModel.rowCount(proxyModel.mapFromSource(sceneIndex)), numberOfSmallBatchItems + numberOfFolders);
+
+  // Rebuild the whole model for comparison
+  timer.start();
+  qMRMLSubjectHierarchyModel rebuiltModel;
+  rebuiltModel.setMRMLScene(scene);
+  const qint64 rebuildTime = timer.elapsed();
+  std::cout << "Rebuild model with " << numberOfItems << " items: " << rebuildTime << "ms" << std::endl;
+  CHECK_INT(rebuiltModel.rowCount(rebuiltModel.subjectHierarchySceneIndex()), numberOfSmallBatchItems + numberOfFolders);
+  // Inserting the items one by one would be quadratic (item position lookup and proxy model update
+  // for each row), the block insertion must be comparable to building the model from scratch.
+  CHECK_BOOL(batchInsertTime <= 2 * rebuildTime + 1000, true);
+
+  // Remove items in batch processing, the model is rebuilt
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+  shNode->RemoveItem(folderItemIDs.back());
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+  CHECK_INT(model.rowCount(sceneIndex), numberOfSmallBatchItems + numberOfFolders - 1);
+  CHECK_BOOL(model.indexFromSubjectHierarchyItem(lastChildItemIDs.back()).isValid(), false);
+
+  qSlicerSubjectHierarchyPluginHandler::instance()->setMRMLScene(nullptr);
+  return EXIT_SUCCESS;
+}
@@ -25,6 +25,7 @@
 #include <QMimeData>
 #include <QApplication>
 #include <QMessageBox>
+#include <QPair>
 #include <QTimer>
 #include <QUrl>
 
@@ -32,6 +33,7 @@
 #include <ctkUtils.h>
 
 // qMRML includes
+#include "qMRMLSceneModel.h"
 #include "qMRMLSubjectHierarchyModel_p.h"
 
 // Slicer includes
@@ -73,6 +75,7 @@ qMRMLSubjectHierarchyModelPrivate::qMRMLSubjectHierarchyModelPrivate(qMRMLSubjec
   , SubjectHierarchyNode(nullptr)
   , MRMLScene(nullptr)
   , TerminologiesModuleLogic(nullptr)
+  , BatchRebuildRequired(false)
   , IsDroppedInside(false)
 {
   this->CallBack = vtkSmartPointer<vtkCallbackCommand>::New();
@@ -185,6 +188,11 @@ QStandardItem* qMRMLSubjectHierarchyModelPrivate::insertSubjectHierarchyItem(vtk
       return nullptr;
     }
   }
+  if (index < 0 || index > parentItem->rowCount())
+  {
+    // Append
+    index = parentItem->rowCount();
+  }
   item = q->insertSubjectHierarchyItem(itemID, parentItem, index);
   if (q->itemFromSubjectHierarchyItem(itemID) != item)
   {
@@ -194,6 +202,172 @@ QStandardItem* qMRMLSubjectHierarchyModelPrivate::insertSubjectHierarchyItem(vtk
   return item;
 }
 
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyModelPrivate::insertBatchAddedItems()
+{
+  Q_Q(qMRMLSubjectHierarchyModel);
+  QSet<vtkIdType> itemsToInsert;
+  foreach (vtkIdType itemID, this->BatchAddedItems)
+  {
+    // Items may have been inserted during batch processing (e.g. as parent of an inserted item)
+    if (!this->RowCache.contains(itemID))
+    {
+      itemsToInsert.insert(itemID);
+    }
+  }
+  this->BatchAddedItems.clear();
+  if (itemsToInsert.isEmpty() || !this->SubjectHierarchyNode)
+  {
+    return;
+  }
+  const bool insertBlocks = (itemsToInsert.count() > qMRMLSceneModel::maximumNumberOfNodesToInsert());
+  vtkIdType sceneItemID = this->SubjectHierarchyNode->GetSceneItemID();
+
+  // Items to insert in blocks, grouped by parent item. Parents are listed in the order of
+  // their first child in the traversal, therefore parents are inserted before their children.
+  QList<vtkIdType> parentItemIDs;
+  QHash<vtkIdType, QList<QPair<vtkIdType, int> > > itemsToInsertByParent;
+  QList<vtkIdType> insertedItemIDs;
+  // Same row as qMRMLSubjectHierarchyModel::subjectHierarchyItemIndex(): position of the item
+  // under its parent, the None item being the first row under the scene.
+  QHash<vtkIdType, int> lastRowOfParent;
+  std::vector<vtkIdType> allItemIDs;
+  this->SubjectHierarchyNode->GetItemChildren(sceneItemID, allItemIDs, true);
+  for (std::vector<vtkIdType>::iterator itemIt=allItemIDs.begin(); itemIt!=allItemIDs.end(); ++itemIt)
+  {
+    vtkIdType itemID = (*itemIt);
+    vtkIdType parentItemID = this->SubjectHierarchyNode->GetItemParent(itemID);
+    int firstRow = (this->NoneEnabled && parentItemID == sceneItemID) ? 1 : 0;
+    int row = lastRowOfParent.value(parentItemID, firstRow - 1) + 1;
+    lastRowOfParent[parentItemID] = row;
+    if (!itemsToInsert.remove(itemID))
+    {
+      continue;
+    }
+    insertedItemIDs << itemID;
+    if (insertBlocks)
+    {
+      if (!itemsToInsertByParent.contains(parentItemID))
+      {
+        parentItemIDs << parentItemID;
+      }
+      itemsToInsertByParent[parentItemID] << qMakePair(itemID, row);
+    }
+    else
+    {
+      this->insertSubjectHierarchyItem(itemID, row);
+    }
+    if (itemsToInsert.isEmpty())
+    {
+      break;
+    }
+  }
+  foreach (vtkIdType parentItemID, parentItemIDs)
+  {
+    // Split the items of the parent into blocks of consecutive rows
+    const QList<QPair<vtkIdType, int> >& parentItemsToInsert = itemsToInsertByParent[parentItemID];
+    QList<vtkIdType> blockItemIDs;
+    int blockFirstRow = -1;
+    for (int i = 0; i < parentItemsToInsert.count(); ++i)
+    {
+      if (!blockItemIDs.isEmpty() && parentItemsToInsert[i].second != blockFirstRow + blockItemIDs.count())
+      {
+        this->insertSubjectHierarchyItemBlock(parentItemID, blockItemIDs, blockFirstRow);
+        blockItemIDs.clear();
+      }
+      if (blockItemIDs.isEmpty())
+      {
+        blockFirstRow = parentItemsToInsert[i].second;
+      }
+      blockItemIDs << parentItemsToInsert[i].first;
+    }
+    this->insertSubjectHierarchyItemBlock(parentItemID, blockItemIDs, blockFirstRow);
+  }
+
+  // Update expanded states now that the inserted items have valid indices
+  // (same as in qMRMLSubjectHierarchyModel::rebuildFromSubjectHierarchy())
+  foreach (vtkIdType itemID, insertedItemIDs)
+  {
+    QStandardItem* item = q->itemFromSubjectHierarchyItem(itemID, q->nameColumn());
+    if (item)
+    {
+      q->updateItemDataFromSubjectHierarchyItem(item, itemID, q->nameColumn());
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyModelPrivate::insertSubjectHierarchyItemBlock(
+  vtkIdType parentItemID, const QList<vtkIdType>& itemIDs, int row)
+{
+  Q_Q(qMRMLSubjectHierarchyModel);
+  if (itemIDs.isEmpty())
+  {
+    return;
+  }
+  QStandardItem* parentItem = q->itemFromSubjectHierarchyItem(parentItemID);
+  bool insertBlock = (parentItem && row <= parentItem->rowCount());
+  foreach (vtkIdType itemID, itemIDs)
+  {
+    if (!insertBlock)
+    {
+      break;
+    }
+    insertBlock = !this->RowCache.contains(itemID);
+  }
+  if (!insertBlock)
+  {
+    foreach (vtkIdType itemID, itemIDs)
+    {
+      this->insertSubjectHierarchyItem(itemID, row++);
+    }
+    return;
+  }
+
+  const int columnCount = q->columnCount();
+  QList<QList<QStandardItem*> > rowsItems;
+  QList<QStandardItem*> firstColumnItems;
+  foreach (vtkIdType itemID, itemIDs)
+  {
+    QList<QStandardItem*> items;
+    for (int col=0; col<columnCount; ++col)
+    {
+      QStandardItem* newItem = new QStandardItem();
+      q->updateItemFromSubjectHierarchyItem(newItem, itemID, col);
+      items.append(newItem);
+    }
+    firstColumnItems << items[0];
+    rowsItems << items;
+    // See qMRMLSubjectHierarchyModel::insertSubjectHierarchyItem(vtkIdType, QStandardItem*, int)
+    this->RowCache[itemID] = QModelIndex();
+  }
+  if (parentItem->columnCount() < columnCount)
+  {
+    parentItem->setColumnCount(columnCount);
+  }
+  // All the rows are inserted at once: views and proxy models are notified only once.
+  parentItem->insertRows(row, firstColumnItems);
+  if (columnCount > 1)
+  {
+    // QStandardItem::setChild() notifies a layout change for each item, instead
+    // the other columns are set silently and a single data change is notified.
+    bool wasBlocking = q->blockSignals(true);
+    for (int i = 0; i < rowsItems.count(); ++i)
+    {
+      for (int col=1; col<columnCount; ++col)
+      {
+        parentItem->setChild(row + i, col, rowsItems[i][col]);
+      }
+    }
+    q->blockSignals(wasBlocking);
+    emit q->dataChanged(rowsItems.first()[1]->index(), rowsItems.last()[columnCount - 1]->index());
+  }
+  for (int i = 0; i < itemIDs.count(); ++i)
+  {
+    this->RowCache[itemIDs[i]] = firstColumnItems[i]->index();
+  }
+}
+
 //------------------------------------------------------------------------------
 vtkSlicerTerminologiesModuleLogic* qMRMLSubjectHierarchyModelPrivate::terminologiesModuleLogic()
 {
@@ -388,7 +562,7 @@ QModelIndex qMRMLSubjectHierarchyModel::indexFromSubjectHierarchyItem(vtkIdType
   }
 
   // Try to find the nodeIndex in the cache first
-  QMap<vtkIdType,QPersistentModelIndex>::iterator rowCacheIt = d->RowCache.find(itemID);
+  QHash<vtkIdType,QPersistentModelIndex>::iterator rowCacheIt = d->RowCache.find(itemID);
   if (rowCacheIt==d->RowCache.end())
   {
     // Not found in cache, therefore it cannot be in the model
@@ -443,13 +617,14 @@ QModelIndexList qMRMLSubjectHierarchyModel::indexes(vtkIdType itemID)const
   {
     return QModelIndexList();
   }
-  // QAbstractItemModel::match doesn't browse through columns, we need to do it manually
-  QModelIndexList shItemIndexes = this->match(
-    scene, qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole, QVariant(qlonglong(itemID)), 1, Qt::MatchExactly | Qt::MatchRecursive);
-  if (shItemIndexes.size() != 1)
+  // Use the row cache instead of browsing the whole tree
+  QModelIndex shItemIndex = this->indexFromSubjectHierarchyItem(itemID);
+  if (!shItemIndex.isValid())
   {
-    return QModelIndexList(); // If 0 it's empty, if >1 it's invalid (one item for each UID)
+    return QModelIndexList();
   }
+  QModelIndexList shItemIndexes;
+  shItemIndexes << shItemIndex;
   // Add the QModelIndexes from the other columns
   const int row = shItemIndexes[0].row();
   QModelIndex shItemParentIndex = shItemIndexes[0].parent();
@@ -721,6 +896,9 @@ void qMRMLSubjectHierarchyModel::rebuildFromSubjectHierarchy()
   Q_D(qMRMLSubjectHierarchyModel);
 
   d->RowCache.clear();
+  d->BatchAddedItems.clear();
+  d->BatchModifiedItems.clear();
+  d->BatchRebuildRequired = false;
 
   // Enabled so it can be interacted with
   this->invisibleRootItem()->setFlags(Qt::ItemIsEnabled);
@@ -799,11 +977,13 @@ void qMRMLSubjectHierarchyModel::rebuildFromSubjectHierarchy()
   // Populate subject hierarchy with the items
   std::vector<vtkIdType> allItemIDs;
   d->SubjectHierarchyNode->GetItemChildren(d->SubjectHierarchyNode->GetSceneItemID(), allItemIDs, true);
+  // Items are returned in depth-first order, with children in the order of their position under the parent,
+  // therefore each item can be appended to its parent. This avoids looking up the position of each item,
+  // which would be slow for large hierarchies.
   for (std::vector<vtkIdType>::iterator itemIt=allItemIDs.begin(); itemIt!=allItemIDs.end(); ++itemIt)
   {
     vtkIdType itemID = (*itemIt);
-    int index = this->subjectHierarchyItemIndex(itemID);
-    d->insertSubjectHierarchyItem(itemID, index);
+    d->insertSubjectHierarchyItem(itemID, -1);
   }
 
   // Update expanded states (during inserting the update calls did not find valid indices, so
@@ -1377,10 +1557,19 @@ void qMRMLSubjectHierarchyModel::updateSubjectHierarchyItemFromItemData(vtkIdTyp
 void qMRMLSubjectHierarchyModel::updateModelItems(vtkIdType itemID)
 {
   Q_D(qMRMLSubjectHierarchyModel);
-  if (d->MRMLScene->IsClosing() || d->MRMLScene->IsBatchProcessing())
+  if (d->MRMLScene->IsClosing())
   {
     return;
   }
+  if (d->MRMLScene->IsBatchProcessing())
+  {
+    // Items are updated when batch processing ends
+    if (!d->BatchRebuildRequired)
+    {
+      d->BatchModifiedItems.insert(itemID);
+    }
+    return;
+  }
 
   QModelIndexList itemIndexes = this->indexes(itemID);
   if (!itemIndexes.count())
@@ -1485,6 +1674,16 @@ void qMRMLSubjectHierarchyModel::onEvent(
 //------------------------------------------------------------------------------
 void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemAdded(vtkIdType itemID)
 {
+  Q_D(qMRMLSubjectHierarchyModel);
+  if (d->MRMLScene && d->MRMLScene->IsBatchProcessing())
+  {
+    // The item is inserted when batch processing ends
+    if (!d->BatchRebuildRequired)
+    {
+      d->BatchAddedItems << itemID;
+    }
+    return;
+  }
   this->insertSubjectHierarchyItem(itemID);
 }
 
@@ -1494,14 +1693,18 @@ void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemAboutToBeRemoved(vtkIdTyp
   Q_D(qMRMLSubjectHierarchyModel);
   if (d->MRMLScene->IsClosing() || d->MRMLScene->IsBatchProcessing())
   {
+    // The model is rebuilt when batch processing ends
+    d->BatchRebuildRequired = true;
+    d->BatchAddedItems.clear();
+    d->BatchModifiedItems.clear();
     return;
   }
 
-  QModelIndexList itemIndexes = this->match(
-    this->subjectHierarchySceneIndex(), SubjectHierarchyItemIDRole, itemID, 1, Qt::MatchExactly | Qt::MatchRecursive );
-  if (itemIndexes.count() > 0)
+  // Row cache is used for finding the item index, browsing the whole tree would be slow for large hierarchies
+  QModelIndex itemIndex = this->indexFromSubjectHierarchyItem(itemID);
+  if (itemIndex.isValid())
   {
-    QStandardItem* item = this->itemFromIndex(itemIndexes[0].sibling(itemIndexes[0].row(),0));
+    QStandardItem* item = this->itemFromIndex(itemIndex.sibling(itemIndex.row(),0));
     // The children may be lost if not reparented, we ensure they got reparented.
     while (item->rowCount())
     {
@@ -1516,8 +1719,9 @@ void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemAboutToBeRemoved(vtkIdTyp
         d->Orphans.removeAll(orphans);
       }
     }
-    this->removeRow(itemIndexes[0].row(), itemIndexes[0].parent());
+    this->removeRow(itemIndex.row(), itemIndex.parent());
   }
+  d->RowCache.remove(itemID);
 }
 
 //------------------------------------------------------------------------------
@@ -1589,8 +1793,28 @@ void qMRMLSubjectHierarchyModel::onMRMLSceneStartBatchProcess(vtkMRMLScene* scen
 //------------------------------------------------------------------------------
 void qMRMLSubjectHierarchyModel::onMRMLSceneEndBatchProcess(vtkMRMLScene* scene)
 {
+  Q_D(qMRMLSubjectHierarchyModel);
   Q_UNUSED(scene);
-  this->rebuildFromSubjectHierarchy();
+  if (d->BatchRebuildRequired)
+  {
+    this->rebuildFromSubjectHierarchy();
+    return;
+  }
+  // Items are not removed during the batch processing (otherwise the model
+  // would be rebuilt), therefore the items are inserted without rebuilding the model.
+  QSet<vtkIdType> modifiedItems = d->BatchModifiedItems;
+  d->BatchModifiedItems.clear();
+  foreach (vtkIdType itemID, d->BatchAddedItems)
+  {
+    // Items of added items are created from the current state of the subject hierarchy
+    modifiedItems.remove(itemID);
+  }
+  d->insertBatchAddedItems();
+  foreach (vtkIdType itemID, modifiedItems)
+  {
+    this->updateModelItems(itemID);
+  }
+  emit subjectHierarchyUpdated();
 }
 
 //------------------------------------------------------------------------------
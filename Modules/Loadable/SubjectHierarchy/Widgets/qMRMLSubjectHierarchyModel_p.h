@@ -36,7 +36,9 @@
 
 // Qt includes
 #include <QFlags>
+#include <QHash>
 #include <QMap>
+#include <QSet>
 
 // SubjectHierarchy includes
 #include "qSlicerSubjectHierarchyModuleWidgetsExport.h"
@@ -71,8 +73,19 @@ public:
   /// This method is called by qMRMLSubjectHierarchyModel::rebuildFromSubjectHierarchy() to speed up
   /// the loading. By explicitly specifying the \a index, it skips item lookup within their parents
   /// happening in qMRMLSubjectHierarchyModel::subjectHierarchyItemIndex(vtkIdType).
+  /// If \a index is negative then the item is appended to its parent.
   virtual QStandardItem* insertSubjectHierarchyItem(vtkIdType itemID, int index);
 
+  /// Insert the subject hierarchy items added during batch processing. Positions of the items are
+  /// found in a single traversal of the hierarchy instead of one lookup per item. Above
+  /// qMRMLSceneModel::maximumNumberOfNodesToInsert() items, the items are inserted in blocks of
+  /// consecutive rows under their parent.
+  void insertBatchAddedItems();
+
+  /// Insert a block of items under \a parentItemID at consecutive rows, starting at \a row.
+  /// Items are inserted one by one if the block cannot be inserted at once.
+  void insertSubjectHierarchyItemBlock(vtkIdType parentItemID, const QList<vtkIdType>& itemIDs, int row);
+
   /// Convenience function to get name for subject hierarchy item
   QString subjectHierarchyItemName(vtkIdType itemID);
 
@@ -115,6 +128,12 @@ public:
   /// Terminology module logic. Needed to generate the terminology tooltip in the color column
   vtkSlicerTerminologiesModuleLogic* TerminologiesModuleLogic;
 
+  /// Items added and modified during batch processing
+  QList<vtkIdType> BatchAddedItems;
+  QSet<vtkIdType> BatchModifiedItems;
+  /// The model must be rebuilt at the end of batch processing (items were removed)
+  bool BatchRebuildRequired;
+
   mutable QList<vtkIdType> DraggedSubjectHierarchyItems;
   bool DelayedItemChangedInvoked;
   /// Indicates that the last drag-and-drop operation was finished with dropping inside the widget.
@@ -130,7 +149,7 @@ public:
   // It just stores the result of the latest lookup by \sa indexFromSubjectHierarchyItem,
   // not guaranteed to contain up-to-date information, should be just used as a search hint.
   // If the item cannot be found at the given index then we need to browse through all model items.
-  mutable QMap<vtkIdType, QPersistentModelIndex> RowCache;
+  mutable QHash<vtkIdType, QPersistentModelIndex> RowCache;
 };
 
 #endif
@@ -56,6 +56,9 @@
 #include <QString>
 #include <QVariantMap>
 
+// VTK includes
+#include <vtkCollection.h>
+
 //-----------------------------------------------------------------------------
 class qSlicerSubjectHierarchyPluginLogicPrivate
 {
@@ -75,6 +78,8 @@ public:
   QList<QAction*> ViewContextMenuActions;
   /// Item ID for the currently displayed View menu
   vtkIdType CurrentItemID;
+  /// Nodes are being added by vtkMRMLScene::AddNodes()
+  bool AddingNodes;
   /// If this list is non-empty then only those actions
   /// will be displayable in the view context menu that are in this list.
   QStringList AllowedViewContextMenuActionNames;
@@ -87,6 +92,7 @@ public:
 qSlicerSubjectHierarchyPluginLogicPrivate::qSlicerSubjectHierarchyPluginLogicPrivate(qSlicerSubjectHierarchyPluginLogic& object)
   : q_ptr(&object)
   , CurrentItemID(0)
+  , AddingNodes(false)
 {
   // Register vtkIdType for use in python for subject hierarchy item IDs
   qRegisterMetaType<vtkIdType>("vtkIdType");
@@ -181,6 +187,9 @@ void qSlicerSubjectHierarchyPluginLogic::setMRMLScene(vtkMRMLScene* scene)
 
   // Connect scene node added event so that the new subject hierarchy items can be claimed by a plugin
   qvtkReconnect( scene, vtkMRMLScene::NodeAddedEvent, this, SLOT( onNodeAdded(vtkObject*,vtkObject*) ) );
+  // Connect scene nodes added events so that nodes added in bulk are added to subject hierarchy at once
+  qvtkReconnect( scene, vtkMRMLScene::NodesAboutToBeAddedEvent, this, SLOT( onNodesAboutToBeAdded(vtkObject*,vtkObject*) ) );
+  qvtkReconnect( scene, vtkMRMLScene::NodesAddedEvent, this, SLOT( onNodesAdded(vtkObject*,vtkObject*) ) );
   // Connect scene node about to be removed event so that the associated subject hierarchy node can be deleted too
   qvtkReconnect( scene, vtkMRMLScene::NodeAboutToBeRemovedEvent, this, SLOT( onNodeAboutToBeRemoved(vtkObject*,vtkObject*) ) );
   // Connect scene node removed event so if the subject hierarchy node is removed, it is re-created and the hierarchy rebuilt
@@ -227,11 +236,17 @@ void qSlicerSubjectHierarchyPluginLogic::observeNode(vtkMRMLNode* node)
 //-----------------------------------------------------------------------------
 void qSlicerSubjectHierarchyPluginLogic::onNodeAdded(vtkObject* sceneObject, vtkObject* nodeObject)
 {
+  Q_D(qSlicerSubjectHierarchyPluginLogic);
   vtkMRMLScene* scene = vtkMRMLScene::SafeDownCast(sceneObject);
   if (!scene)
   {
     return;
   }
+  if (d->AddingNodes)
+  {
+    // All the nodes are added to subject hierarchy in onNodesAdded
+    return;
+  }
 
   // If subject hierarchy node, then merge it with the already used subject hierarchy node (and remove the new one)
   vtkMRMLSubjectHierarchyNode* subjectHierarchyNode = vtkMRMLSubjectHierarchyNode::SafeDownCast(nodeObject);
@@ -298,6 +313,56 @@ void qSlicerSubjectHierarchyPluginLogic::onNodeAdded(vtkObject* sceneObject, vtk
   }
 }
 
+//-----------------------------------------------------------------------------
+void qSlicerSubjectHierarchyPluginLogic::onNodesAboutToBeAdded(vtkObject* sceneObject, vtkObject* nodesObject)
+{
+  Q_D(qSlicerSubjectHierarchyPluginLogic);
+  Q_UNUSED(sceneObject);
+  Q_UNUSED(nodesObject);
+  d->AddingNodes = true;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerSubjectHierarchyPluginLogic::onNodesAdded(vtkObject* sceneObject, vtkObject* nodesObject)
+{
+  Q_D(qSlicerSubjectHierarchyPluginLogic);
+  d->AddingNodes = false;
+  vtkMRMLScene* scene = vtkMRMLScene::SafeDownCast(sceneObject);
+  vtkCollection* nodes = vtkCollection::SafeDownCast(nodesObject);
+  if (!scene || !nodes)
+  {
+    return;
+  }
+
+  std::vector<vtkMRMLNode*> dataNodes;
+  bool subjectHierarchyNodeAdded = false;
+  vtkMRMLNode* node = nullptr;
+  vtkCollectionSimpleIterator it;
+  for (nodes->InitTraversal(it); (node = vtkMRMLNode::SafeDownCast(nodes->GetNextItemAsObject(it)));)
+  {
+    if (node->IsA("vtkMRMLSubjectHierarchyNode"))
+    {
+      subjectHierarchyNodeAdded = true;
+    }
+    else
+    {
+      dataNodes.push_back(node);
+    }
+  }
+  if (subjectHierarchyNodeAdded)
+  {
+    // Make sure that there is exactly one subject hierarchy node in the scene (performs the merge if more found)
+    vtkMRMLSubjectHierarchyNode::ResolveSubjectHierarchy(scene);
+  }
+  // Same as in onNodeAdded: nodes are not added one by one while importing a scene
+  if (scene->IsImporting())
+  {
+    return;
+  }
+  // Plugin selection dialog is not shown for each node, the first plugin is chosen in case of equal confidence
+  this->addSupportedDataNodesToSubjectHierarchy(dataNodes);
+}
+
 //-----------------------------------------------------------------------------
 void qSlicerSubjectHierarchyPluginLogic::onNodeAboutToBeRemoved(vtkObject* sceneObject, vtkObject* nodeObject)
 {
@@ -625,6 +690,21 @@ void qSlicerSubjectHierarchyPluginLogic::onDisplayMenuEvent(vtkObject* displayNo
 
 //-----------------------------------------------------------------------------
 void qSlicerSubjectHierarchyPluginLogic::addSupportedDataNodesToSubjectHierarchy()
+{
+  vtkMRMLScene* scene = this->mrmlScene();
+  if (!scene)
+  {
+    return;
+  }
+  // Traverse all nodes in the scene (those contain data that can be saved with the scene)
+  // and all hierarchy nodes (that specify hierarchy for certain types of data nodes and may be mirrored by the plugins of those data node types)
+  std::vector<vtkMRMLNode*> supportedNodes;
+  scene->GetNodesByClass("vtkMRMLNode", supportedNodes);
+  this->addSupportedDataNodesToSubjectHierarchy(supportedNodes);
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerSubjectHierarchyPluginLogic::addSupportedDataNodesToSubjectHierarchy(const std::vector<vtkMRMLNode*>& supportedNodes)
 {
   // Get subject hierarchy node
   vtkMRMLScene* scene = this->mrmlScene();
@@ -635,11 +715,7 @@ void qSlicerSubjectHierarchyPluginLogic::addSupportedDataNodesToSubjectHierarchy
     return;
   }
 
-  // Traverse all nodes in the scene (those contain data that can be saved with the scene)
-  // and all hierarchy nodes (that specify hierarchy for certain types of data nodes and may be mirrored by the plugins of those data node types)
-  std::vector<vtkMRMLNode*> supportedNodes;
-  scene->GetNodesByClass("vtkMRMLNode", supportedNodes);
-  for (std::vector<vtkMRMLNode*>::iterator nodeIt = supportedNodes.begin(); nodeIt != supportedNodes.end(); ++nodeIt)
+  for (std::vector<vtkMRMLNode*>::const_iterator nodeIt = supportedNodes.begin(); nodeIt != supportedNodes.end(); ++nodeIt)
   {
     vtkMRMLNode* node = (*nodeIt);
     // Do not add into subject hierarchy if hidden. The HideFromEditors flag is not considered to work dynamically, meaning that
@@ -123,6 +123,8 @@ protected:
   /// scene, or if the user answers yes to the question that pops up upon entering subject
   /// hierarchy module if supported nodes are found that are not in the hierarchy.
   void addSupportedDataNodesToSubjectHierarchy();
+  /// Add the supported nodes of the list to subject hierarchy.
+  void addSupportedDataNodesToSubjectHierarchy(const std::vector<vtkMRMLNode*>& nodes);
 
   /// Add view menu action. Called by plugin handler when registering a plugin
   void registerViewContextMenuAction(QAction* action);
@@ -130,6 +132,12 @@ protected:
 protected slots:
   /// Called when a node is added to the scene so that a plugin can create an item for it
   void onNodeAdded(vtkObject* scene, vtkObject* nodeObject);
+  /// Called when nodes are about to be added by vtkMRMLScene::AddNodes().
+  /// Node added events are ignored until all the nodes are added.
+  void onNodesAboutToBeAdded(vtkObject* scene, vtkObject* nodesObject);
+  /// Called when nodes are added by vtkMRMLScene::AddNodes() so that
+  /// subject hierarchy items are created for all of them at once
+  void onNodesAdded(vtkObject* scene, vtkObject* nodesObject);
   /// Called when a node is removed from the scene so that the associated
   /// subject hierarchy item can be deleted too
   void onNodeAboutToBeRemoved(vtkObject* scene, vtkObject* nodeObject);
@@ -28,6 +28,7 @@
 // MRML nodes includes
 #include "vtkCacheManager.h"
 #include "vtkDataIOManager.h"
+#include "vtkMRMLChunkedVolumeStorageNode.h"
 #include "vtkMRMLDiffusionTensorVolumeDisplayNode.h"
 #include "vtkMRMLDiffusionTensorVolumeNode.h"
 #include "vtkMRMLDiffusionTensorVolumeSliceDisplayNode.h"
@@ -35,6 +36,7 @@
 #include "vtkMRMLDiffusionWeightedVolumeNode.h"
 #include "vtkMRMLLabelMapVolumeDisplayNode.h"
 #include "vtkMRMLLabelMapVolumeNode.h"
+#include "vtkMRMLMessageCollection.h"
 #include "vtkMRMLNRRDStorageNode.h"
 #include "vtkMRMLScene.h"
 #include "vtkMRMLVectorVolumeDisplayNode.h"
@@ -44,6 +46,7 @@
 
 // VTK includes
 #include <vtkCallbackCommand.h>
+#include <vtkCollection.h>
 #include <vtkErrorSink.h>
 #include <vtkGeneralTransform.h>
 #include <vtkImageData.h>
@@ -405,6 +408,64 @@ ArchetypeVolumeNodeSet ScalarVolumeNodeSetFactory(std::string& volumeName, vtkMR
   return nodeSet;
 }
 
+//----------------------------------------------------------------------------
+ArchetypeVolumeNodeSet ChunkedLabelMapVolumeNodeSetFactory(std::string& volumeName, vtkMRMLScene* scene, int vtkNotUsed(options))
+{
+  ArchetypeVolumeNodeSet nodeSet(scene);
+
+  // set up the label map node's support nodes
+  vtkMRMLLabelMapVolumeDisplayNode* lmdisplayNode =
+      vtkMRMLLabelMapVolumeDisplayNode::SafeDownCast(
+        nodeSet.Scene->AddNewNodeByClass("vtkMRMLLabelMapVolumeDisplayNode"));
+
+  vtkMRMLLabelMapVolumeNode* scalarNode =
+      vtkMRMLLabelMapVolumeNode::SafeDownCast(
+        nodeSet.Scene->AddNewNodeByClass("vtkMRMLLabelMapVolumeNode", volumeName));
+  scalarNode->SetAndObserveDisplayNodeID(lmdisplayNode->GetID());
+
+  // chunked volumes (OME-Zarr directories) store the full geometry, loading options do not apply
+  vtkMRMLChunkedVolumeStorageNode* storageNode =
+      vtkMRMLChunkedVolumeStorageNode::SafeDownCast(
+        nodeSet.Scene->AddNewNodeByClass("vtkMRMLChunkedVolumeStorageNode"));
+  scalarNode->SetAndObserveStorageNodeID(storageNode->GetID());
+
+  nodeSet.StorageNode = storageNode;
+  nodeSet.DisplayNode = lmdisplayNode;
+  nodeSet.Node = scalarNode;
+
+  nodeSet.LabelMap = true;
+
+  return nodeSet;
+}
+
+//----------------------------------------------------------------------------
+ArchetypeVolumeNodeSet ChunkedScalarVolumeNodeSetFactory(std::string& volumeName, vtkMRMLScene* scene, int vtkNotUsed(options))
+{
+  ArchetypeVolumeNodeSet nodeSet(scene);
+
+  // set up the scalar node's support nodes
+  vtkMRMLScalarVolumeDisplayNode* sdisplayNode =
+      vtkMRMLScalarVolumeDisplayNode::SafeDownCast(
+        nodeSet.Scene->AddNewNodeByClass("vtkMRMLScalarVolumeDisplayNode"));
+
+  vtkMRMLScalarVolumeNode* scalarNode =
+      vtkMRMLScalarVolumeNode::SafeDownCast(
+        nodeSet.Scene->AddNewNodeByClass("vtkMRMLScalarVolumeNode", volumeName));
+  scalarNode->SetAndObserveDisplayNodeID(sdisplayNode->GetID());
+
+  // chunked volumes (OME-Zarr directories) store the full geometry, loading options do not apply
+  vtkMRMLChunkedVolumeStorageNode* storageNode =
+      vtkMRMLChunkedVolumeStorageNode::SafeDownCast(
+        nodeSet.Scene->AddNewNodeByClass("vtkMRMLChunkedVolumeStorageNode"));
+  scalarNode->SetAndObserveStorageNodeID(storageNode->GetID());
+
+  nodeSet.StorageNode = storageNode;
+  nodeSet.DisplayNode = sdisplayNode;
+  nodeSet.Node = scalarNode;
+
+  return nodeSet;
+}
+
 } // end of anonymous namespace
 
 //----------------------------------------------------------------------------
@@ -417,6 +478,8 @@ vtkSlicerVolumesLogic::vtkSlicerVolumesLogic()
   this->RegisterArchetypeVolumeNodeSetFactory( ArchetypeVectorVolumeNodeSetFactory );
   this->RegisterArchetypeVolumeNodeSetFactory( LabelMapVolumeNodeSetFactory );
   this->RegisterArchetypeVolumeNodeSetFactory( ScalarVolumeNodeSetFactory );
+  this->RegisterArchetypeVolumeNodeSetFactory( ChunkedLabelMapVolumeNodeSetFactory );
+  this->RegisterArchetypeVolumeNodeSetFactory( ChunkedScalarVolumeNodeSetFactory );
 
   this->CompareVolumeGeometryEpsilon = 0.000001;
   this->CompareVolumeGeometryPrecision = 6;
@@ -690,6 +753,99 @@ vtkMRMLVolumeNode* vtkSlicerVolumesLogic::AddArchetypeVolume (
   return volumeNode;
 }
 
+//----------------------------------------------------------------------------
+bool vtkSlicerVolumesLogic::PreloadArchetypeVolume(const char* filename, int loadingOptions,
+  vtkStringArray* fileList, vtkCollection* preloadedNodes, vtkMRMLMessageCollection* userMessages)
+{
+  if (filename == nullptr || preloadedNodes == nullptr)
+  {
+    vtkErrorMacro("PreloadArchetypeVolume: invalid filename or output collection");
+    return false;
+  }
+  bool labelMap = (loadingOptions & vtkSlicerVolumesLogic::LabelMap) != 0;
+
+  // Nodes are created in a private scene (not the scene of the logic) because
+  // factories need a scene to instantiate and reference nodes.
+  vtkNew<vtkMRMLScene> testScene;
+  std::string volumeName = vtksys::SystemTools::GetFilenameName(filename);
+  vtkNew<vtkErrorSink> errorSink;
+  vtkNew<vtkMRMLMessageCollection> readMessages;
+
+  for (NodeSetFactoryRegistry::const_iterator fit = this->VolumeRegistry.begin();
+       fit != this->VolumeRegistry.end(); ++fit)
+  {
+    ArchetypeVolumeNodeSet nodeSet( (*fit)(volumeName, testScene.GetPointer(), loadingOptions) );
+    if (labelMap == nodeSet.LabelMap)
+    {
+      nodeSet.StorageNode->SetFileName(filename);
+      if (fileList != nullptr)
+      {
+        nodeSet.StorageNode->ResetFileNameList();
+        for (int n = 0; n < fileList->GetNumberOfValues(); n++)
+        {
+          nodeSet.StorageNode->AddFileName(fileList->GetValue(n).c_str());
+        }
+      }
+      errorSink->SetObservedObject(nodeSet.StorageNode);
+      bool success = nodeSet.StorageNode->ReadData(nodeSet.Node);
+      errorSink->SetObservedObject(nullptr);
+      if (success)
+      {
+        // Detach the nodes from the private scene, references are restored in AddPreloadedVolume()
+        testScene->RemoveNode(nodeSet.DisplayNode);
+        testScene->RemoveNode(nodeSet.StorageNode);
+        testScene->RemoveNode(nodeSet.Node);
+        preloadedNodes->AddItem(nodeSet.Node);
+        preloadedNodes->AddItem(nodeSet.DisplayNode);
+        preloadedNodes->AddItem(nodeSet.StorageNode);
+        return true;
+      }
+      readMessages->AddMessages(nodeSet.StorageNode->GetUserMessages());
+    }
+
+    // Wasn't the right factory, so we need to clean up
+    nodeSet.Node->SetAndObserveDisplayNodeID(nullptr);
+    nodeSet.Node->SetAndObserveStorageNodeID(nullptr);
+    testScene->RemoveNode(nodeSet.DisplayNode);
+    testScene->RemoveNode(nodeSet.StorageNode);
+    testScene->RemoveNode(nodeSet.Node);
+  }
+
+  errorSink->DisplayMessages();
+  if (userMessages)
+  {
+    userMessages->AddMessages(readMessages);
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLVolumeNode* vtkSlicerVolumesLogic::AddPreloadedVolume(vtkMRMLVolumeNode* volumeNode,
+  vtkMRMLVolumeDisplayNode* displayNode, vtkMRMLStorageNode* storageNode, const char* volname)
+{
+  if (this->GetMRMLScene() == nullptr || volumeNode == nullptr
+    || displayNode == nullptr || storageNode == nullptr)
+  {
+    vtkErrorMacro("AddPreloadedVolume: invalid scene, volume node, display node, or storage node");
+    return nullptr;
+  }
+  const char* filename = storageNode->GetFileName();
+  std::string volumeName = volname != nullptr ? volname : vtksys::SystemTools::GetFilenameName(filename ? filename : "");
+  volumeNode->SetName(this->GetMRMLScene()->GetUniqueNameByString(volumeName.c_str()).c_str());
+
+  this->GetMRMLScene()->AddNode(displayNode);
+  this->GetMRMLScene()->AddNode(storageNode);
+  this->GetMRMLScene()->AddNode(volumeNode);
+  volumeNode->SetAndObserveDisplayNodeID(displayNode->GetID());
+  volumeNode->SetAndObserveStorageNodeID(storageNode->GetID());
+
+  this->SetAndObserveColorToDisplayNode(displayNode,
+    vtkMRMLLabelMapVolumeNode::SafeDownCast(volumeNode) != nullptr, filename);
+
+  this->Modified();
+  return volumeNode;
+}
+
 //----------------------------------------------------------------------------
 int vtkSlicerVolumesLogic::SaveArchetypeVolume (const char* filename, vtkMRMLVolumeNode *volumeNode)
 {
@@ -38,7 +38,9 @@
 
 #include "vtkSlicerVolumesModuleLogicExport.h"
 
+class vtkCollection;
 class vtkMRMLLabelMapVolumeNode;
+class vtkMRMLMessageCollection;
 class vtkMRMLScalarVolumeNode;
 class vtkMRMLScalarVolumeDisplayNode;
 class vtkMRMLVolumeHeaderlessStorageNode;
@@ -144,6 +146,22 @@ public:
   /// \sa AddArchetypeVolume(const NodeSetFactoryRegistry& volumeRegistry, const char* filename, const char* volname, int loadingOptions, vtkStringArray *fileList)
   vtkMRMLScalarVolumeNode* AddArchetypeScalarVolume(const char* filename, const char* volname, int loadingOptions, vtkStringArray *fileList);
 
+  /// Read a volume file into nodes that are not added to the scene, trying registered
+  /// factories the same way as AddArchetypeVolume().
+  /// The scene of the logic is not accessed, therefore the method can be called from a
+  /// worker thread. Remote files (URIs) are not supported.
+  /// On success, the volume node, its display node and its storage node are added to
+  /// \a preloadedNodes (in this order) and true is returned.
+  /// \sa AddPreloadedVolume()
+  bool PreloadArchetypeVolume(const char* filename, int loadingOptions, vtkStringArray* fileList,
+    vtkCollection* preloadedNodes, vtkMRMLMessageCollection* userMessages = nullptr);
+
+  /// Add nodes read by PreloadArchetypeVolume() to the scene.
+  /// The volume node is named after \a volname (made unique in the scene).
+  /// \sa PreloadArchetypeVolume()
+  vtkMRMLVolumeNode* AddPreloadedVolume(vtkMRMLVolumeNode* volumeNode, vtkMRMLVolumeDisplayNode* displayNode,
+    vtkMRMLStorageNode* storageNode, const char* volname);
+
   /// Write volume's image data to a specified file
   int SaveArchetypeVolume (const char* filename, vtkMRMLVolumeNode *volumeNode);
 
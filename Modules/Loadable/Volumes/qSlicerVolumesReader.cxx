@@ -37,10 +37,12 @@
 // MRML includes
 #include <vtkMRMLDisplayNode.h>
 #include <vtkMRMLLabelMapVolumeNode.h>
+#include <vtkMRMLMessageCollection.h>
 #include <vtkMRMLScalarVolumeNode.h>
 #include <vtkMRMLSelectionNode.h>
 
 // VTK includes
+#include <vtkCollection.h>
 #include <vtkSmartPointer.h>
 #include <vtkStringArray.h>
 
@@ -51,6 +53,11 @@
 class qSlicerVolumesReaderPrivate
 {
   public:
+  /// Loading options of vtkSlicerVolumesLogic::AddArchetypeVolume() from reader properties
+  static int loadingOptions(const qSlicerIO::IOProperties& properties);
+  static vtkSmartPointer<vtkStringArray> fileList(const qSlicerIO::IOProperties& properties);
+  static QString volumeName(const qSlicerIO::IOProperties& properties);
+
   vtkSmartPointer<vtkSlicerVolumesLogic> Logic;
 };
 
@@ -102,8 +109,9 @@ qSlicerIO::IOFileType qSlicerVolumesReader::fileType()const
 QStringList qSlicerVolumesReader::extensions()const
 {
   // pic files are bio-rad images (see itkBioRadImageIO)
+  // zarr directories are chunked multi-resolution volumes (see vtkMRMLChunkedVolumeStorageNode)
   return QStringList()
-    << tr("Volume") + " (*.hdr *.nhdr *.nrrd *.mhd *.mha *.mnc *.nii *.nii.gz *.mgh *.mgz *.mgh.gz *.img *.img.gz *.pic)"
+    << tr("Volume") + " (*.hdr *.nhdr *.nrrd *.mhd *.mha *.mnc *.nii *.nii.gz *.mgh *.mgz *.mgh.gz *.img *.img.gz *.pic *.zarr)"
     << tr("Dicom") + " (*.dcm *.ima)"
     << tr("Image") + " (*.png *.tif *.tiff *.jpg *.jpeg)"
     << tr("All Files") + " (*)";
@@ -119,17 +127,8 @@ qSlicerIOOptions* qSlicerVolumesReader::options()const
 }
 
 //-----------------------------------------------------------------------------
-bool qSlicerVolumesReader::load(const IOProperties& properties)
+int qSlicerVolumesReaderPrivate::loadingOptions(const qSlicerIO::IOProperties& properties)
 {
-  Q_D(qSlicerVolumesReader);
-  Q_ASSERT(properties.contains("fileName"));
-  QString fileName = properties["fileName"].toString();
-
-  QString name = QFileInfo(fileName).baseName();
-  if (properties.contains("name"))
-  {
-    name = properties["name"].toString();
-  }
   int options = 0;
   if (properties.contains("labelmap"))
   {
@@ -151,11 +150,12 @@ bool qSlicerVolumesReader::load(const IOProperties& properties)
   {
     options |= properties["discardOrientation"].toBool() ? 0x10 : 0x0;
   }
-  bool propagateVolumeSelection = true;
-  if (properties.contains("show"))
-  {
-    propagateVolumeSelection = properties["show"].toBool();
-  }
+  return options;
+}
+
+//-----------------------------------------------------------------------------
+vtkSmartPointer<vtkStringArray> qSlicerVolumesReaderPrivate::fileList(const qSlicerIO::IOProperties& properties)
+{
   vtkSmartPointer<vtkStringArray> fileList;
   if (properties.contains("fileNames"))
   {
@@ -165,54 +165,131 @@ bool qSlicerVolumesReader::load(const IOProperties& properties)
       fileList->InsertNextValue(file.toUtf8());
     }
   }
+  return fileList;
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerVolumesReaderPrivate::volumeName(const qSlicerIO::IOProperties& properties)
+{
+  if (properties.contains("name"))
+  {
+    return properties["name"].toString();
+  }
+  return QFileInfo(properties["fileName"].toString()).baseName();
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerVolumesReader::load(const IOProperties& properties)
+{
+  Q_D(qSlicerVolumesReader);
+  Q_ASSERT(properties.contains("fileName"));
+  QString fileName = properties["fileName"].toString();
+  QString name = d->volumeName(properties);
+  vtkSmartPointer<vtkStringArray> fileList = d->fileList(properties);
   Q_ASSERT(d->Logic);
   // Weak pointer is used because the node may be deleted if the scene is closed
   // right after reading.
   vtkWeakPointer<vtkMRMLVolumeNode> node = d->Logic->AddArchetypeVolume(
     fileName.toUtf8(),
     name.toUtf8(),
-    options,
+    d->loadingOptions(properties),
     fileList.GetPointer());
-  if (node)
+  this->finalizeLoad(node, properties);
+  return node != nullptr;
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerVolumesReader::canPreload(const IOProperties& properties)const
+{
+  QString fileName = properties.value("fileName").toString();
+  // Remote files are downloaded by the cache manager of the scene
+  return !fileName.isEmpty() && !fileName.contains("://");
+}
+
+//-----------------------------------------------------------------------------
+vtkSmartPointer<vtkObject> qSlicerVolumesReader::preload(const IOProperties& properties,
+  vtkMRMLMessageCollection* userMessages)const
+{
+  Q_D(const qSlicerVolumesReader);
+  if (!d->Logic)
   {
-    QString colorNodeID = properties.value("colorNodeID", QString()).toString();
-    if (!colorNodeID.isEmpty())
+    return nullptr;
+  }
+  QString fileName = properties.value("fileName").toString();
+  vtkSmartPointer<vtkStringArray> fileList = d->fileList(properties);
+  vtkSmartPointer<vtkCollection> preloadedNodes = vtkSmartPointer<vtkCollection>::New();
+  if (!d->Logic->PreloadArchetypeVolume(fileName.toUtf8(), d->loadingOptions(properties),
+    fileList.GetPointer(), preloadedNodes, userMessages))
+  {
+    return nullptr;
+  }
+  return preloadedNodes;
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerVolumesReader::loadPreloaded(const IOProperties& properties, vtkObject* preloadedData)
+{
+  Q_D(qSlicerVolumesReader);
+  vtkCollection* preloadedNodes = vtkCollection::SafeDownCast(preloadedData);
+  if (!d->Logic || !preloadedNodes)
+  {
+    return this->load(properties);
+  }
+  vtkWeakPointer<vtkMRMLVolumeNode> node = d->Logic->AddPreloadedVolume(
+    vtkMRMLVolumeNode::SafeDownCast(preloadedNodes->GetItemAsObject(0)),
+    vtkMRMLVolumeDisplayNode::SafeDownCast(preloadedNodes->GetItemAsObject(1)),
+    vtkMRMLStorageNode::SafeDownCast(preloadedNodes->GetItemAsObject(2)),
+    d->volumeName(properties).toUtf8());
+  this->finalizeLoad(node, properties);
+  return node != nullptr;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerVolumesReader::finalizeLoad(vtkMRMLVolumeNode* node, const IOProperties& properties)
+{
+  Q_D(qSlicerVolumesReader);
+  if (!node)
+  {
+    this->setLoadedNodes(QStringList());
+    return;
+  }
+  QString colorNodeID = properties.value("colorNodeID", QString()).toString();
+  if (!colorNodeID.isEmpty())
+  {
+    vtkMRMLVolumeDisplayNode* displayNode = node->GetVolumeDisplayNode();
+    if (displayNode)
     {
-      vtkMRMLVolumeDisplayNode* displayNode = node->GetVolumeDisplayNode();
-      if (displayNode)
-      {
-        displayNode->SetAndObserveColorNodeID(colorNodeID.toUtf8());
-      }
+      displayNode->SetAndObserveColorNodeID(colorNodeID.toUtf8());
     }
-    if (propagateVolumeSelection)
+  }
+  bool propagateVolumeSelection = true;
+  if (properties.contains("show"))
+  {
+    propagateVolumeSelection = properties["show"].toBool();
+  }
+  if (propagateVolumeSelection)
+  {
+    vtkSlicerApplicationLogic* appLogic =
+      d->Logic->GetApplicationLogic();
+    vtkMRMLSelectionNode* selectionNode =
+      appLogic ? appLogic->GetSelectionNode() : nullptr;
+    if (selectionNode)
     {
-      vtkSlicerApplicationLogic* appLogic =
-        d->Logic->GetApplicationLogic();
-      vtkMRMLSelectionNode* selectionNode =
-        appLogic ? appLogic->GetSelectionNode() : nullptr;
-      if (selectionNode)
+      if (vtkMRMLLabelMapVolumeNode::SafeDownCast(node))
       {
-        if (vtkMRMLLabelMapVolumeNode::SafeDownCast(node))
-        {
-          selectionNode->SetActiveLabelVolumeID(node->GetID());
-        }
-        else
-        {
-          selectionNode->SetActiveVolumeID(node->GetID());
-        }
-        if (appLogic)
-        {
-          appLogic->PropagateVolumeSelection(); // includes FitSliceToBackground by default
-        }
+        selectionNode->SetActiveLabelVolumeID(node->GetID());
+      }
+      else
+      {
+        selectionNode->SetActiveVolumeID(node->GetID());
+      }
+      if (appLogic)
+      {
+        appLogic->PropagateVolumeSelection(); // includes FitSliceToBackground by default
       }
     }
-    this->setLoadedNodes(QStringList(QString(node->GetID())));
   }
-  else
-  {
-    this->setLoadedNodes(QStringList());
-  }
-  return node != nullptr;
+  this->setLoadedNodes(QStringList(QString(node->GetID())));
 }
 
 //-----------------------------------------------------------------------------
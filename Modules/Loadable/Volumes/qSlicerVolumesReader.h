@@ -24,6 +24,7 @@
 // Slicer includes
 #include "qSlicerFileReader.h"
 class qSlicerVolumesReaderPrivate;
+class vtkMRMLVolumeNode;
 class vtkSlicerVolumesLogic;
 
 //-----------------------------------------------------------------------------
@@ -47,12 +48,21 @@ public:
 
   bool load(const IOProperties& properties) override;
 
+  /// Local files are read in a worker thread using vtkSlicerVolumesLogic::PreloadArchetypeVolume().
+  bool canPreload(const IOProperties& properties)const override;
+  vtkSmartPointer<vtkObject> preload(const IOProperties& properties,
+    vtkMRMLMessageCollection* userMessages)const override;
+  bool loadPreloaded(const IOProperties& properties, vtkObject* preloadedData) override;
+
   /// Implements the file list examination for the corresponding method in the core
   /// IO manager.
   /// \sa qSlicerCoreIOManager
   bool examineFileInfoList(QFileInfoList &fileInfoList, QFileInfo &archetypeFileInfo, qSlicerIO::IOProperties &ioProperties)const override;
 
 protected:
+  /// Apply display properties and set loaded nodes after the volume is added to the scene
+  void finalizeLoad(vtkMRMLVolumeNode* node, const IOProperties& properties);
+
   QScopedPointer<qSlicerVolumesReaderPrivate> d_ptr;
 
 private: